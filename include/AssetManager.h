@@ -7,6 +7,8 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <mutex>
+#include <thread>
 
 // Forward declarations
 struct SDL_Texture;
@@ -78,6 +80,11 @@ public:
     // Utility functions
     void preloadAssets();
     void clearCache();
+
+    // Textures can only be created on the thread that made the renderer. On any other thread (the
+    // simulation) a cache miss is queued instead and the load returns nullptr; the render thread
+    // creates the queued assets with processPendingLoads(), so later lookups find them.
+    void processPendingLoads();
     
     // Asset paths
     static const std::string ASSETS_PATH;
@@ -99,6 +106,18 @@ private:
     std::unordered_map<std::string, std::unique_ptr<Texture>> textureCache;
     std::unordered_map<std::string, std::unique_ptr<SpriteSheet>> spriteSheetCache;
     std::unordered_map<std::string, TTF_Font*> fontCache;
+    // Guards the caches and pendingLoads; never held while an image is decoded
+    mutable std::mutex cacheMutex;
+    std::thread::id ownerThread;
+    struct PendingLoad {
+        enum class Kind { Texture, SpriteSheet, SpriteSheetAuto };
+        Kind kind = Kind::Texture;
+        std::string path;
+        int frameWidth = 0, frameHeight = 0, framesPerRow = 0, totalFrames = 0;
+    };
+    std::vector<PendingLoad> pendingLoads;
+    bool onOwnerThread() const { return std::this_thread::get_id() == ownerThread; }
+    void deferLoad(const PendingLoad& load); // caller holds cacheMutex
     
     // Helper functions
     std::string getFullPath(const std::string& relativePath) const;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Mixing kernels over interleaved sample blocks. SSE2 on x86/x64 and NEON on AArch64, with a
+// scalar fallback that gives the same results.
+void mixS16(float* dst, const int16_t* src, size_t count, float gain);  // dst += src * gain
+void mixS16Stereo(float* dst, const int16_t* src, size_t frames, float leftGain, float rightGain); // interleaved L/R
+void mixF32(float* dst, const float* src, size_t count, float gain);    // dst += src * gain
+float applyGainPeak(float* samples, size_t count, float gain);          // samples *= gain; returns max |sample|
+float peakS16(const int16_t* samples, size_t count);                    // max |sample|
+void convertF32ToS16(int16_t* dst, const float* src, size_t count);     // round and saturate
+
+// Mixer buses; every bus but Master feeds its parent:
+//   Master <- Music
+//          <- Sfx <- Monster
+//                 <- Player
+enum class AudioBus : int {
+    Master,
+    Music,
+    Sfx,
+    Monster,
+    Player,
+    COUNT
+};
+
+// The bus graph the raw audio callback mixes through. Voices are summed into their bus at S16
+// scale in float, then each bus applies its gain, is metered and folded into its parent,
+// children first, and Master is written out as S16. Gains are set from the main thread and
+// picked up by the next block; meters are read from the main thread.
+class AudioBusGraph {
+public:
+    AudioBusGraph();
+    // Sizes the bus buffers; call before the audio callback can run
+    void allocate(size_t maxBlockSamples);
+
+    void setGain(AudioBus bus, float gain);
+    float getGain(AudioBus bus) const;
+    // Product of the gains from bus up to Master (what a voice on that bus is scaled by)
+    float getPathGain(AudioBus bus) const;
+    // Output peak of the bus after its gain, 0..1 of full scale, held with a short decay
+    float getPeak(AudioBus bus) const;
+    static AudioBus getParent(AudioBus bus);
+
+    // Audio thread. One block: begin, mix any number of sources, finish.
+    size_t getMaxBlockSamples() const { return maxBlockSamples; }
+    void begin(size_t samples);
+    void mix(AudioBus bus, const int16_t* src, size_t samples, float gain) { mixS16(buffers[static_cast<int>(bus)].data(), src, samples, gain); }
+    void mixStereo(AudioBus bus, const int16_t* src, size_t samples, float leftGain, float rightGain) {
+        mixS16Stereo(buffers[static_cast<int>(bus)].data(), src, samples / 2, leftGain, rightGain);
+    }
+    void finish(int16_t* out);
+    // Meters an output mixed elsewhere (SDL_mixer's post-mix) as Master
+    void meterMaster(const int16_t* samples, size_t count);
+
+private:
+    static constexpr int BUS_COUNT = static_cast<int>(AudioBus::COUNT);
+    static constexpr float PEAK_DECAY = 0.8f; // per block, ~50 ms at the default buffer size
+    void holdPeak(AudioBus bus, float blockPeak);
+
+    size_t maxBlockSamples = 0;
+    size_t blockSamples = 0;
+    std::vector<float> buffers[BUS_COUNT];
+    std::atomic<float> gains[BUS_COUNT];
+    std::atomic<float> peaks[BUS_COUNT];
+};
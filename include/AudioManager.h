@@ -1,6 +1,12 @@
 #pragma once
 
 #include <SDL.h>
+#include "AudioBus.h"
+#include "MusicStream.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <memory>
+#include <thread>
 #include <unordered_map>
 #include <string>
 #include <vector>
@@ -12,9 +18,19 @@ public:
 
     // Core functions
     void update(float deltaTime);
+    // SDL_mixer and the device lock belong to the thread that created the manager. Playback, music
+    // and volume calls may also come from the simulation thread; those are queued and run here,
+    // once per frame on the owning thread. A volume set from there reads back at once.
+    void pumpCommands();
     
     // Audio playback
     void playSound(const std::string& soundName);
+    // Positional SFX at a world position: attenuated and panned relative to the listener, and
+    // dropped without taking a voice when beyond the audible radius
+    void playSoundAt(const std::string& soundName, float x, float y);
+    // Listener for positional SFX: the camera centre and half the visible area, in world pixels.
+    // Until it is set, positional sounds play like playSound.
+    void setListener(float x, float y, float viewHalfWidth, float viewHalfHeight);
     // Looped SFX (e.g., channeling spells). No-op fallback without SDL_mixer except for a single trigger.
     void startLoopingSound(const std::string& soundName);
     void stopLoopingSound(const std::string& soundName);
@@ -39,6 +55,9 @@ public:
     int getMasterVolume() const { return masterVolume; }
     int getMusicVolume() const { return musicVolume; }
     int getSoundVolume() const { return soundVolume; }
+    // Peak meter for the options menu, 0..1 of full scale (above 1 is clipping). Without SDL_mixer
+    // every bus is metered; with it only Master is.
+    float getBusPeak(AudioBus bus) const;
     
     // Audio loading
     void loadSound(const std::string& name, const std::string& filename);
@@ -50,35 +69,85 @@ public:
 private:
     // Audio data storage
     std::unordered_map<std::string, std::vector<Uint8>> soundDataByName; // converted to deviceSpec (fallback without mixer)
-    std::unordered_map<std::string, std::vector<Uint8>> musicDataByName; // converted to deviceSpec (fallback without mixer)
-    std::unordered_map<std::string, std::string> musicPathByName; // original file paths by logical name
+    std::unordered_map<std::string, std::string> musicPathByName; // original file paths by logical name; streamed without mixer
     std::string currentMusicName;
     bool musicPlaying = false;
     
-    // Volume settings
-    int masterVolume;
-    int musicVolume;
-    int soundVolume;
-    int monsterVolume = 100; // additional scaler for enemy SFX
-    int playerVolume = 100; // player melee SFX scaler
+    // Volume settings; read by the UI on the simulation thread
+    std::atomic<int> masterVolume;
+    std::atomic<int> musicVolume;
+    std::atomic<int> soundVolume;
+    std::atomic<int> monsterVolume{100}; // additional scaler for enemy SFX
+    std::atomic<int> playerVolume{100}; // player melee SFX scaler
     
     // Helper functions
     void initializeAudio();
     void cleanupAudio();
     void applyMixerVolumes();
+    // Which bus a sound plays through, and its fixed per-sound scale on top of the bus gains
+    static AudioBus soundBus(const std::string& soundName);
+    static float soundBaseScale(const std::string& soundName);
+    AudioBusGraph busGraph;
+
+    // Voice allocation shared by the mixer channels and the raw voices. Each bus (sound category)
+    // has a cap on concurrent voices; once a category is at its cap, or no voice is free, a new
+    // sound replaces the lowest-priority, quietest voice, or is dropped if it ranks lower still.
+    struct VoiceInfo {
+        AudioBus bus = AudioBus::Sfx;
+        int priority = 0;
+        float gain = 1.0f;     // base scale times distance attenuation, before bus gains
+        float loudness = 0.0f; // for ranking; the gain when it started
+        float pan = 0.0f;      // -1 left .. 1 right
+        bool active = false;
+    };
+    static constexpr int LOOP_PRIORITY = 100;
+    static int soundPriority(const std::string& soundName);
+    static int voiceCap(AudioBus bus);
+    static int pickVoice(const VoiceInfo* voices, int count, const VoiceInfo& wanted); // slot index, or -1
+    static void panGains(float pan, float& left, float& right);
+    void startSound(const std::string& soundName, float attenuation, float pan);
+    // False when (x, y) is out of earshot
+    bool spatialize(float x, float y, float& attenuation, float& pan) const;
+
+    static constexpr float AUDIBLE_RADIUS_SCALE = 1.25f;      // of the half view diagonal
+    static constexpr float FULL_VOLUME_RADIUS_FRACTION = 0.25f;
+    static constexpr float MAX_PAN = 0.8f;                    // keep some of the far ear
+    static constexpr float MIN_AUDIBLE_GAIN = 0.01f;
+    bool listenerSet = false;
+    float listenerX = 0.0f;
+    float listenerY = 0.0f;
+    float listenerHalfWidth = 1.0f;
+    float audibleRadius = 0.0f;
 
     // SDL Audio device/state
     SDL_AudioDeviceID audioDevice = 0;
     SDL_AudioSpec deviceSpec{};
 
+    // Raw SDL path: the device callback mixes SFX voices and the streamed music track, applying
+    // volumes at mix time. Voices and the stream pointer are only changed under SDL_LockAudioDevice.
+    static void SDLCALL audioCallback(void* userdata, Uint8* stream, int len);
+    void mixAudio(Sint16* out, int frames);
+    struct RawVoice {
+        const std::vector<Uint8>* data = nullptr; // S16 samples in device format; nullptr when free
+        size_t position = 0;                      // in bytes
+        float leftGain = 1.0f;                    // before bus gains, with panning
+        float rightGain = 1.0f;
+        AudioBus bus = AudioBus::Sfx;
+    };
+    static constexpr int MAX_RAW_VOICES = 64;
+    RawVoice rawVoices[MAX_RAW_VOICES];
+    VoiceInfo rawVoiceInfo[MAX_RAW_VOICES];
+    std::unique_ptr<MusicStream> musicStream;
+    std::vector<Sint16> musicBlock;
+
 #ifdef USE_SDL_MIXER
     bool mixerInitialized = false;
     std::unordered_map<std::string, void*> chunks; // SFX (Mix_Chunk*)
     std::unordered_map<std::string, void*> musics; // Music (Mix_Music*)
-    // Temp chunk management for tail playback
-    static AudioManager* mixerInstance;
-    std::unordered_map<int, void*> tempChunksByChannel; // channel -> Mix_Chunk*
-    void onChannelFinished(int channel);
+    static void SDLCALL mixerPostMix(void* userdata, Uint8* stream, int len);
+    static constexpr int MIXER_CHANNELS = 32;
+    VoiceInfo channelVoices[MIXER_CHANNELS];
+    void applyChannelVolume(int channel);
     // Music fade management
     bool musicFadeActive = false;
     int musicFadeStage = 0; // 0 idle, 1 fading out started, 2 waiting to fade in
@@ -89,8 +158,21 @@ private:
     std::unordered_map<std::string, int> loopingChannelByName; // name -> channel index
 #endif
 
+    // Calls from the simulation thread, in order; dropped if a frame falls this far behind
+    struct Command {
+        enum class Type { PlaySound, PlaySoundAt, StartLoop, StopLoop, MusicDuck, PlayMusic, StopMusic, FadeToMusic, ApplyVolumes };
+        Type type = Type::PlaySound;
+        std::string name;
+        float x = 0.0f; // position, duck seconds, or fade-out ms
+        float y = 0.0f; // position, duck music scale, or fade-in ms
+    };
+    static constexpr size_t COMMAND_CAPACITY = 256;
+    SpscQueue<Command, COMMAND_CAPACITY> commands;
+    std::thread::id ownerThread;
+    bool onOwnerThread() const { return std::this_thread::get_id() == ownerThread; }
+    void queueCommand(Command::Type type, const std::string& name, float x = 0.0f, float y = 0.0f);
+
     // Ducking state (applies to both mixer and raw paths)
     float musicDuckTimerSeconds = 0.0f;
     float musicDuckScale = 1.0f; // 1.0 = no duck, <1.0 = quieter music
-    int previousMusicVolumeBeforeDuck = -1; // 0-100, for raw path restore
 };
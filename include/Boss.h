@@ -31,7 +31,7 @@ public:
 
     // Boss-specific behavior (not overriding since Enemy methods aren't virtual)
     void update(float deltaTime, float playerX, float playerY);
-    void render(Renderer* renderer) const;
+    void render(Renderer* renderer, const EntityTransform& transform) const;
     void takeDamage(int amount);
 
     // Boss-specific features
@@ -4,9 +4,13 @@
 #include <vector>
 #include <optional>
 #include <memory>
+#include <filesystem>
+#include <unordered_map>
+#include <mutex>
 
 // Forward declaration for SQLite
 struct sqlite3;
+struct sqlite3_stmt;
 
 // Reuse existing structs from Database.h
 enum class UserRole {
@@ -72,6 +76,12 @@ struct PlayerSave {
     int resourcePlusLevel[9] = {};
 };
 
+// On-disk encoding for player saves (see SaveFormat.h)
+enum class SaveFileFormat {
+    JSON,   // human-readable, for debugging
+    BINARY  // compact tagged encoding (default)
+};
+
 struct ItemRecord {
     int itemId;
     std::string name;
@@ -84,6 +94,7 @@ struct UserItemRecord {
     int quantity;
 };
 
+// Public methods are serialized internally, so saves may run on a background thread (see SaveWriter)
 class DatabaseSQLite {
 public:
     DatabaseSQLite();
@@ -109,6 +120,9 @@ public:
     bool savePlayerState(int userId, const PlayerSave& state, std::string* outError = nullptr);
     std::optional<PlayerSave> loadPlayerState(int userId, std::string* outError = nullptr);
     
+    // Encoding used for new save files; existing files of either format always load
+    void setSaveFileFormat(SaveFileFormat format);
+    
     // Backup and recovery
     bool createBackup(int userId, const std::string& description = "");
     std::vector<std::string> listBackups(int userId);
@@ -119,6 +133,9 @@ public:
     bool loadAudioSettings(int userId, int& master, int& music, int& sound, int& monster, int& playerMelee);
     bool saveTheme(int userId, const std::string& themeName);
     bool loadTheme(int userId, std::string& outThemeName);
+    // Key bindings in InputManager's text form
+    bool saveKeyBindings(int userId, const std::string& bindings);
+    bool loadKeyBindings(int userId, std::string& outBindings);
 
     // Items
     std::optional<ItemRecord> upsertItemByName(const std::string& name,
@@ -140,26 +157,115 @@ public:
     bool vacuum();
     bool backup(const std::string& backupPath);
     bool verifyIntegrity();
+    // True when backed by a real SQLite database (USE_SQLITE build), false for the JSON file store
+    bool isUsingSQLite() const { return db != nullptr; }
 
 private:
     sqlite3* db;
     std::string dbPath;
+    SaveFileFormat saveFileFormat = SaveFileFormat::BINARY;
+    std::recursive_mutex mutex; // recursive: public methods call each other (register -> save, migration -> load)
+
+    // Account index: loaded once from users/index.txt and appended on register,
+    // so name/id lookups never have to walk the users directory
+    std::unordered_map<std::string, int> userIdByName; // lowercase username -> id
+    std::unordered_map<int, UserRecord> usersById;
+    int maxUserId = 0;
+    void loadUserIndex();
+    void rebuildUserIndex();
+    bool appendUserIndex(const UserRecord& user);
+    void indexUser(const UserRecord& user);
+
+    // Save history: content-addressed snapshots with last-N/hourly/daily retention
+    static constexpr int HISTORY_KEEP_RECENT = 10;
+    static constexpr int HISTORY_HOURLY = 24; // hours
+    static constexpr int HISTORY_DAILY = 30;  // days
+    struct SaveHistoryEntry {
+        long long time; // unix seconds
+        std::string hash;
+    };
+    std::unordered_map<int, std::vector<SaveHistoryEntry>> saveHistory; // per user, oldest first; loaded lazily
+    std::vector<SaveHistoryEntry>& getSaveHistory(int userId);
+    void recordSaveHistory(int userId, const PlayerSave& state, const std::string* encoded);
+    std::filesystem::path historyBlobPath(int userId, const std::string& hash);
+    static void pruneSaveHistory(std::vector<SaveHistoryEntry>& entries, long long now);
+    static std::string historyEntryId(const SaveHistoryEntry& entry);
+    static std::string hashPlayerSave(const PlayerSave& state);
 
     // Internal helpers
     bool executeSQL(const std::string& sql, std::string* outError = nullptr);
     bool createTables(std::string* outError = nullptr);
+    bool loadUserAuth(int userId, std::string& outSalt, std::string& outHash);
+
+#ifdef USE_SQLITE
+    // Prepared statements are compiled once in initialize() and reset/rebound per call
+    struct Statements {
+        sqlite3_stmt* begin = nullptr;
+        sqlite3_stmt* commit = nullptr;
+        sqlite3_stmt* rollback = nullptr;
+        sqlite3_stmt* insertUser = nullptr;
+        sqlite3_stmt* selectUserByName = nullptr;
+        sqlite3_stmt* selectUserById = nullptr;
+        sqlite3_stmt* selectUserAuth = nullptr;
+        sqlite3_stmt* updateLastLogin = nullptr;
+        sqlite3_stmt* upsertStats = nullptr;
+        sqlite3_stmt* upsertEquipment = nullptr;
+        sqlite3_stmt* deleteInventory = nullptr;
+        sqlite3_stmt* upsertInventory = nullptr;
+        sqlite3_stmt* selectStats = nullptr;
+        sqlite3_stmt* selectEquipment = nullptr;
+        sqlite3_stmt* selectInventory = nullptr;
+        sqlite3_stmt* upsertAudio = nullptr;
+        sqlite3_stmt* selectAudio = nullptr;
+        sqlite3_stmt* upsertTheme = nullptr;
+        sqlite3_stmt* selectTheme = nullptr;
+        sqlite3_stmt* upsertKeyBindings = nullptr;
+        sqlite3_stmt* selectKeyBindings = nullptr;
+        sqlite3_stmt* insertSaveBlob = nullptr;
+        sqlite3_stmt* selectSaveBlob = nullptr;
+        sqlite3_stmt* deleteSaveBlob = nullptr;
+        sqlite3_stmt* insertHistory = nullptr;
+        sqlite3_stmt* selectHistory = nullptr;
+        sqlite3_stmt* deleteHistory = nullptr;
+    } stmts;
+    bool openSQLite(std::string* outError);
+    bool prepareStatements(std::string* outError);
+    void finalizeStatements();
+    bool readSchemaFlag(const std::string& key, bool& outSet, std::string* outError);
+    bool migrateFromJsonFiles(std::string* outError);
+    bool migrateSaveHistoryFiles(std::string* outError);
+    std::optional<UserRecord> sqlInsertUser(int userId, const std::string& username, const std::string& salt,
+                                            const std::string& hash, UserRole role, const std::string& createdAt,
+                                            std::string* outError);
+    std::optional<UserRecord> sqlSelectUser(sqlite3_stmt* stmt);
+    bool sqlWritePlayerRows(int userId, const PlayerSave& state);
+    bool sqlSavePlayerState(int userId, const PlayerSave& state, std::string* outError);
+    std::optional<PlayerSave> sqlLoadPlayerState(int userId, std::string* outError);
+    bool sqlRecordSaveHistory(int userId, const PlayerSave& state, std::vector<SaveHistoryEntry>& entries);
+    void sqlLoadSaveHistory(int userId, std::vector<SaveHistoryEntry>& outEntries);
+    bool sqlLoadSaveBlob(int userId, const std::string& hash, std::string& outData);
+#endif
     
     static std::string generateSalt(size_t length = 16);
     static std::string sha256Hex(const std::string& data);
     static std::string saltedPasswordHashHex(const std::string& salt, const std::string& password);
+    static bool isValidUsername(const std::string& username);
     static std::string toLower(const std::string& s);
     static std::string roleToString(UserRole role);
     static UserRole roleFromString(const std::string& s);
     static std::string generateBackupId();
+    std::string serializePlayerSaveJson(const PlayerSave& state);
+    std::string encodePlayerSave(const PlayerSave& state);
+    std::optional<PlayerSave> decodePlayerSave(const std::string& content, std::string* outError);
+    std::string saveFileExtension() const;
+    static bool readFile(const std::filesystem::path& path, std::string& out);
+    PlayerSave parsePlayerSaveJson(const std::string& content);
+    static bool syncFile(const std::filesystem::path& path);
     
     // Additional helper methods
     int generateUserId();
     std::string getCurrentTimestamp();
+    static std::string jsonEscape(const std::string& text);
     std::string extractJsonString(const std::string& json, const std::string& key);
     int extractJsonInt(const std::string& json, const std::string& key);
     float extractJsonFloat(const std::string& json, const std::string& key);
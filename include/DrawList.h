@@ -0,0 +1,72 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// One frame's drawing as plain data: the SDL calls the simulation made while drawing a tick, in
+// order, with everything they need copied in. Textures are referenced, not owned; they belong to
+// the AssetManager and live for the whole run. Text is rasterized while recording and the list
+// owns the surfaces. Renderer records into a DrawList and replays it on the thread that owns the
+// SDL_Renderer.
+class DrawList {
+public:
+    // What a command moves with when the frame is drawn between two ticks. Non-negative values are
+    // indices into RenderSnapshot::enemies.
+    static constexpr int ANCHOR_SCREEN = -1; // HUD and UI: never moves
+    static constexpr int ANCHOR_WORLD = -2;  // moves with the camera
+    static constexpr int ANCHOR_PLAYER = -3;
+    static constexpr int ANCHOR_BOSS = -4;
+
+    struct Command {
+        enum class Op : uint8_t {
+            DrawColor, DrawBlendMode, FillRect, DrawRect, Line, Point, Copy, CopyEx,
+            TextureColorMod, TextureAlphaMod, TextureBlendMode, Text, Panel
+        };
+        Op op = Op::DrawColor;
+        bool hasSrc = false;
+        bool hasDst = false;    // false: the whole target
+        bool hasCenter = false;
+        int anchor = ANCHOR_SCREEN;
+        SDL_Rect src{};
+        SDL_Rect dst{};         // Line: x1, y1, x2, y2; Point: x, y
+        SDL_Color color{};      // draw colour, or texture colour/alpha mod
+        SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+        SDL_RendererFlip flip = SDL_FLIP_NONE;
+        SDL_Point center{};
+        double angle = 0.0;
+        SDL_Texture* texture = nullptr;
+        int index = -1;         // Text: surfaces[index]; Panel: panels[index]
+    };
+
+    // A retained UI panel: drawn once into a target texture and re-blitted while its key holds.
+    // The content is shared between every frame that shows the panel unchanged.
+    struct Panel {
+        int id = 0;
+        int w = 0, h = 0;
+        uint64_t key = 0;
+        std::shared_ptr<const DrawList> content;
+    };
+
+    DrawList() = default;
+    ~DrawList();
+    DrawList(const DrawList&) = delete;
+    DrawList& operator=(const DrawList&) = delete;
+
+    void clear();
+    bool empty() const { return commands.empty(); }
+
+    Command& push(Command::Op op, int anchor);
+    int addSurface(SDL_Surface* surface); // takes ownership
+    int addPanel(Panel panel);
+
+    const std::vector<Command>& getCommands() const { return commands; }
+    SDL_Surface* getSurface(int index) const { return surfaces[index]; }
+    const Panel& getPanel(int index) const { return panels[index]; }
+
+private:
+    std::vector<Command> commands;
+    std::vector<SDL_Surface*> surfaces;
+    std::vector<Panel> panels;
+};
@@ -5,11 +5,14 @@
 #include <memory>
 #include <vector>
 #include "Projectile.h"
+#include "Random.h"
+#include "RenderSnapshot.h"
 
 // Forward declarations
 class SpriteSheet;
 class AssetManager;
 class Renderer;
+class World;
 
 enum class EnemyState {
     IDLE,
@@ -81,14 +84,34 @@ class Enemy {
 public:
     Enemy(float spawnX, float spawnY, AssetManager* assetManager, EnemyKind kind);
     ~Enemy() = default;
+    // Loads every kind's sprite sheets into the cache. Call on the render thread before the
+    // simulation starts: enemies it spawns later can only use sheets that are already loaded.
+    static void preloadSprites(AssetManager* assetManager);
 
     void update(float deltaTime, float playerX, float playerY);
-    void update(float deltaTime, float playerX, float playerY, const std::vector<std::unique_ptr<Enemy>>& otherEnemies);
-    void render(Renderer* renderer) const;
+    // Full update plus spreading out from nearby enemies (those within SEPARATION_RADIUS matter)
+    void update(float deltaTime, float playerX, float playerY, const std::vector<const Enemy*>& nearbyEnemies);
+    static constexpr float SEPARATION_RADIUS = 120.0f; // much larger than the body for spreading
+    // Reduced-detail update for enemies far off screen: timers, aggro and straight-line movement
+    // only. No attacks, separation, animation or state changes beyond aggro.
+    void updateCoarse(float deltaTime, float playerX, float playerY);
+    // Shots in flight, for when the enemy itself is not updated this tick
+    void updateProjectiles(float deltaTime);
+
+    // Simulation level of detail, driven by World::updateEnemies
+    struct SimLod {
+        bool asleep = false;        // skipped entirely until the player comes near
+        float deferredTime = 0.0f;  // time not yet simulated by a reduced-rate enemy
+    };
+    SimLod& getSimLod() { return simLod; }
+    // Draws at the transform's position and frame (an interpolated snapshot) rather than the live state
+    void render(Renderer* renderer, const EntityTransform& transform) const;
     void renderProjectiles(Renderer* renderer) const;
+    EntityTransform getTransform() const { return EntityTransform{this, x, y, currentFrame}; }
 
     float getX() const { return x; }
     float getY() const { return y; }
+    void setPosition(float newX, float newY) { x = newX; y = newY; }
     int getWidth() const { return currentSpriteSheet ? currentSpriteSheetFrameWidth : width; }
     int getHeight() const { return currentSpriteSheet ? currentSpriteSheetFrameHeight : height; }
 
@@ -100,10 +123,11 @@ public:
     int getMaxHealth() const { return maxHealth; }
     SDL_Rect getCollisionRect() const;
     bool isWithinAttackRange(float playerX, float playerY) const;
-    bool isAttackReady() const { return attackCooldownTimer <= 0.0f; }
+    bool isAttackReady() const { return attackCooldownTimer <= 0.0f && !frozen; }
     void consumeAttackCooldown() { attackCooldownTimer = attackCooldownSeconds; }
     int getContactDamage() const { return contactDamage; }
     bool getIsAggroed() const { return isAggroed; }
+    float getAggroRadius() const { return aggroRadius; }
     const char* getDisplayName() const {
         switch (kind) {
             // Currently implemented
@@ -158,6 +182,7 @@ public:
     void markLootDropped() { lootDropped = true; }
     // Despawn timing
     Uint32 getDeathTicksMs() const { return deathTicksMs; }
+    void setDeathTicksMs(Uint32 ticks) { deathTicksMs = ticks; } // stamped by Game's simulation clock
     bool isDespawnReady(Uint32 nowTicks, Uint32 ttlMs = 60000) const {
         return currentState == EnemyState::DEAD && deathTicksMs > 0 && (nowTicks - deathTicksMs) >= ttlMs;
     }
@@ -166,6 +191,18 @@ public:
     int getRawWidth() const { return width; }
     int getRawHeight() const { return height; }
 
+    // Status effects (owned by StatusEffectSystem; see World::getStatusEffects)
+    int getStatusHandle() const { return statusHandle; }
+    void setStatusHandle(int handle) { statusHandle = handle; }
+    void setStatusModifiers(float speedMultiplier, bool frozenState) { statusSpeedMultiplier = speedMultiplier; frozen = frozenState; }
+    bool isFrozen() const { return frozen; }
+
+    // Terrain this enemy's projectiles collide with (set by World when added)
+    void setWorld(const World* newWorld) { world = newWorld; }
+
+    // Per-enemy random stream (AI rolls, loot)
+    RandomStream& getRandom() { return rng; }
+
     // Spawn/reset
     void resetToSpawn();
     const std::vector<std::unique_ptr<Projectile>>& getProjectiles() const { return projectiles; }
@@ -180,6 +217,8 @@ protected:
     int health;
     int maxHealth;
     AssetManager* assets = nullptr;
+    const World* world = nullptr;
+    SimLod simLod;
 
     // State
     EnemyState currentState;
@@ -246,7 +285,6 @@ protected:
     void setState(EnemyState newState);
     void setDirection(EnemyDirection newDirection);
     void updateAnimation(float deltaTime);
-    void updateProjectiles(float deltaTime);
     void fireProjectileTowards(float targetX, float targetY, AssetManager* assetManager, const std::string& projectileSprite = "", int frames = 0, bool rotateByDirection = false);
     void triggerTransformation();  // For werewolf transformation
 
@@ -275,7 +313,14 @@ protected:
     std::vector<std::unique_ptr<Projectile>> projectiles;
 
     bool lootDropped = false;
-    Uint32 deathTicksMs = 0; // time of death for corpse despawn
+    Uint32 deathTicksMs = 0; // simulation time of death for corpse despawn
+
+    // Status effects
+    int statusHandle = -1;
+    float statusSpeedMultiplier = 1.0f; // slows scale all movement
+    bool frozen = false;                // no AI, movement, attacks or animation
+
+    RandomStream rng; // keyed by spawn order, see Enemy::Enemy
 };
 
 
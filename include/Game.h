@@ -1,15 +1,21 @@
 #pragma once
 
 #include <SDL.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 #include <string>
 #include <deque>
+#include "InputReplay.h"
+#include "ItemSystem.h"
+#include "RenderSnapshot.h"
+#include "Renderer.h"
+#include "SpscQueue.h"
 
 // Forward declarations
-class Renderer;
-class InputManager;
 class AssetManager;
 class Player;
 class World;
@@ -17,9 +23,15 @@ class Enemy;
 class UISystem;
 class AudioManager;
 class DatabaseSQLite;
+class SaveWriter;
 
-// Forward declarations
-class Item;
+// Command-line options (see main.cpp)
+struct GameLaunchOptions {
+    std::string recordPath;   // --record <file>: log input from the first in-game tick until exit
+    std::string replayPath;   // --replay <file>: play a recording back instead of live input, then exit
+    std::string frameLogPath; // --frame-log <file>: frame times of a replay in ms, one per line
+    bool unthrottled = false; // --unthrottled: replay one tick per frame with no vsync or frame cap
+};
 
 enum class AnvilItemSource {
     NONE,
@@ -29,16 +41,16 @@ enum class AnvilItemSource {
 
 class Game {
 public:
-    Game();
+    explicit Game(const GameLaunchOptions& options = GameLaunchOptions());
     ~Game();
 
-    // Main game loop
+    // Main game loop: events and rendering here, fixed simulation ticks on a thread of their own
     void run();
     
     // Game state management
-    void update(float deltaTime);
+    void update(float deltaTime); // one simulation tick
     void render();
-    void handleEvents();
+    void handleEvents(); // polls the window and forwards its input to the simulation
     
     // System access
     Renderer* getRenderer() const { return renderer.get(); }
@@ -59,13 +71,13 @@ public:
         // Clear anvil state when opening
         anvilSelectedSlot = -1;  // Clear item slot
         anvilStagedScrollKey.clear();  // Clear scroll slot
-        anvilTargetItem = nullptr;  // Clear target item
+        anvilTargetItem = ItemHandle();  // Clear target item
         anvilItemSource = AnvilItemSource::NONE;  // Clear source
     }
     void closeAnvil() { anvilOpen = false; }
     int getAnvilSelectedSlot() const { return anvilSelectedSlot; }
     void setAnvilSelectedSlot(int idx) { anvilSelectedSlot = idx; }
-    Item* getAnvilTargetItem() const { return anvilTargetItem; }
+    Item* getAnvilTargetItem() const; // nullptr if none was chosen or the item no longer exists
     bool isInventoryOpen() const { return inventoryOpen; }
     void toggleInventory() { inventoryOpen = !inventoryOpen; }
     
@@ -85,6 +97,11 @@ public:
     static constexpr int WINDOW_HEIGHT = 720;
     static constexpr int TARGET_FPS = 60;
     static constexpr float TARGET_FRAME_TIME = 1.0f / TARGET_FPS;
+    // The simulation ticks at its own fixed rate; rendering interpolates between ticks, so the two
+    // rates are independent
+    static constexpr int SIM_TICK_RATE = 60;
+    static constexpr float SIM_TICK_TIME = 1.0f / SIM_TICK_RATE;
+    static constexpr int MAX_SIM_TICKS_PER_FRAME = 4;
 
     // Debug toggles
     void setDebugHitboxes(bool enabled) { debugHitboxes = enabled; }
@@ -94,12 +111,16 @@ public:
     void setInfinitePotions(bool enabled) { infinitePotions = enabled; }
     bool getInfinitePotions() const { return infinitePotions; }
 
+    // Simulation clock; advances only with ticks, so replays see the same times
+    Uint32 getSimTimeMs() const { return static_cast<Uint32>(simulationTick * 1000 / SIM_TICK_RATE); }
+
     // Performance monitoring
     float getCurrentFPS() const { return currentFPS; }
     float getAverageFPS() const { return averageFPS; }
     Uint32 getFrameTime() const { return frameTime; }
 
-    // World transitions
+    // World transitions. They load textures, so a call from the simulation thread is carried out
+    // by the main thread before its next frame.
     void enterUnderworld();
     void exitUnderworld();
     bool isInUnderworld() const { return inUnderworld; }
@@ -118,6 +139,8 @@ public:
     
     // Save/load system
     void saveCurrentUserState();
+    // Persists the input manager's current bindings for the logged-in user (call after a rebind)
+    void saveKeyBindings();
 
 private:
     // SDL objects
@@ -133,6 +156,7 @@ private:
     std::unique_ptr<UISystem> uiSystem;
     std::unique_ptr<AudioManager> audioManager;
     std::unique_ptr<DatabaseSQLite> database;
+    std::unique_ptr<SaveWriter> saveWriter; // declared after database so it is flushed and joined first
     
     // Game entities
     std::vector<std::unique_ptr<Enemy>> enemies;
@@ -146,7 +170,7 @@ private:
     float anvilResultFlashTimer = 0.0f; // steady display duration for final result
     bool anvilLastSuccess = false; // last upgrade outcome
     // Anvil target item tracking
-    Item* anvilTargetItem = nullptr; // specific item instance being upgraded
+    ItemHandle anvilTargetItem; // specific item instance being upgraded
     AnvilItemSource anvilItemSource = AnvilItemSource::NONE; // where the item comes from
     // Drag state for inventory -> anvil
     bool draggingFromInventory = false;
@@ -155,9 +179,12 @@ private:
     bool processingEquipmentEvent = false;
     
     // Game state
-    bool isRunning;
+    std::atomic<bool> isRunning;
     bool isPaused;
     bool optionsOpen = false;
+    // The window is the main thread's; the options menu reads and toggles it through these
+    std::atomic<bool> windowFullscreen{false};
+    std::atomic<bool> fullscreenToggleRequested{false};
     bool loginScreenActive = true;
     bool inUnderworld = false;
     
@@ -174,7 +201,7 @@ private:
     std::string loginError;
     bool loginRemember = false;
     bool loginIsAdmin = false;
-    int loggedInUserId = -1;
+    int loggedInUserId = -1; // set at login; autosave enqueues for it without querying the database
     int optionsSelectedIndex = 0; // 0..5
     std::string currentMusicTrack;
     std::string backgroundMusicName = "main_theme"; // user-selected background theme
@@ -186,10 +213,76 @@ private:
     
     // Timing and performance monitoring
     Uint32 lastFrameTime;
-    float accumulator;
-    Uint32 frameTime;
-    float currentFPS;
-    float averageFPS;
+    float accumulator; // simulation-owned
+    // Per-tick render snapshots. The simulation records each tick's whole frame into one
+    // (recordFrame); render() replays it and reads nothing else, so it never touches game state.
+    uint64_t simulationTick = 0;
+    RenderSnapshotBuffer renderSnapshots;
+    RenderSnapshot renderFrame; // interpolated, rebuilt each frame
+    Renderer::ReplayOffsets replayOffsets; // render-owned, rebuilt each frame
+    void recordFrame(RenderSnapshot& snapshot);
+    // Camera that centres the view on focus
+    void cameraFor(const EntityTransform& focus, int& cameraX, int& cameraY) const;
+    std::atomic<Uint64> lastTickCounter{0}; // performance counter when the newest tick was published
+
+    // Simulation thread. The main thread only polls events and replays snapshots, neither of which
+    // touches game state; simMutex is held for each tick and by the main thread only to carry out a
+    // pending world transition.
+    std::thread simThread;
+    std::mutex simMutex;
+    std::atomic<bool> simRunning{false};
+    std::thread::id mainThreadId;
+    void runSimulation();
+    bool stepSimulation(); // one tick under simMutex; false once a replay has run out
+
+    // Work for the simulation, applied at the start of the next tick: window events forwarded by
+    // the main thread, and gameplay requested by the UI while a frame is recorded
+    struct SimCommand {
+        // Stored in replays by value: append new types, never reorder
+        enum class Type : uint8_t {
+            EVENT, RESPAWN, EQUIP, SWAP_EQUIP, UNEQUIP, CONSUME_SCROLL, ANVIL_UPGRADE, ANVIL_ENCHANT, CLEAR_LOOT_NOTIFICATION,
+            TOGGLE_PAUSE, TOGGLE_INFINITE_POTIONS, GRANT_TEST_SCROLLS, ENTER_UNDERWORLD, EXIT_UNDERWORLD
+        };
+        Type type = Type::RESPAWN;
+        int slot = -1;     // inventory slot, equipment slot, or the anvil's selected slot
+        ItemHandle item;   // anvil target, if one was chosen
+        std::string key;   // scroll or element
+        SDL_Event event{}; // EVENT
+    };
+    static constexpr size_t SIM_COMMAND_CAPACITY = 256;
+    SpscQueue<SimCommand, SIM_COMMAND_CAPACITY> simCommands; // main thread -> simulation
+    std::vector<SimCommand> uiCommands;                      // simulation only; recorded in replays
+    void queueSimCommand(const SimCommand& command);
+    void applySimCommand(const SimCommand& command);
+    void handleEvent(const SDL_Event& event); // simulation side of handleEvents
+
+    // Underworld transition requested by the simulation thread
+    enum class WorldTransition { NONE, ENTER_UNDERWORLD, EXIT_UNDERWORLD };
+    std::atomic<WorldTransition> pendingWorldTransition{WorldTransition::NONE};
+
+    // Input record/replay
+    GameLaunchOptions launchOptions;
+    std::unique_ptr<InputRecorder> inputRecorder;
+    std::unique_ptr<InputPlayer> inputPlayer;
+    std::vector<ReplayAction> replayedActions;      // this tick's, from inputPlayer
+    std::vector<ReplayActionEntry> recordedActions; // this tick's, for inputRecorder
+    uint32_t replayStartTick = 0; // input tick the recording or replay started at
+    std::vector<float> replayFrameMs;
+    Uint64 replayFrameCounter = 0;
+    void beginRecording();
+    void startReplay();
+    void finishReplay();
+    // Pointer as of the last event handled, for the UI recorded with each frame; gameplay gets it via the input queue
+    int uiMouseX = 0;
+    int uiMouseY = 0;
+    Uint32 uiMouseButtons = 0;   // SDL_BUTTON() mask
+    bool uiMouseClicked = false; // left click since the last recorded frame
+    bool uiEscapeHeld = false;
+    void publishRenderSnapshot();
+    // Written by the main thread, drawn by the simulation
+    std::atomic<Uint32> frameTime;
+    std::atomic<float> currentFPS;
+    std::atomic<float> averageFPS;
     std::deque<float> fpsHistory;
     static constexpr size_t FPS_HISTORY_SIZE = 60; // Store 1 second of FPS data at 60 FPS
     bool debugHitboxes = false;
@@ -201,6 +294,7 @@ private:
     void cleanup();
     void updatePerformanceMetrics();
     void loadOrCreateDefaultUserAndSave();
+    void loadKeyBindings(int userId);
 
     void renderOptionsMenuOverlay();
     void handleOptionsInput(const SDL_Event& event);
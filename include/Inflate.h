@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Small self-contained DEFLATE decoder (RFC 1951) with the zlib (RFC 1950) and gzip (RFC 1952)
+// wrappers, enough for Tiled's compressed layer data without linking zlib. Each call appends the
+// decompressed bytes to out and returns false on malformed or truncated input.
+bool inflateRaw(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+bool inflateZlib(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+bool inflateGzip(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
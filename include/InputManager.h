@@ -1,8 +1,11 @@
 #pragma once
 
 #include <SDL.h>
-#include <unordered_map>
+#include "SpscQueue.h"
 #include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 enum class InputAction {
     MOVE_UP,
@@ -18,26 +21,52 @@ enum class InputAction {
     QUIT,
     USE_HP_POTION,
     USE_MP_POTION,
-    SHIELD
+    SHIELD,
+    COUNT
 };
 
-enum class InputState {
+enum class InputState : uint8_t {
     RELEASED,
     PRESSED,
     HELD
 };
 
+// One input event as recorded by the event loop, applied to the input state by the simulation
+struct InputCommand {
+    enum class Type : uint8_t { KEY_DOWN, KEY_UP, MOUSE_DOWN, MOUSE_UP, MOUSE_MOTION };
+    Type type = Type::KEY_DOWN;
+    int code = 0; // scancode or mouse button
+    int x = 0;
+    int y = 0;
+    uint32_t timestamp = 0; // SDL event time in ms
+};
+
+// An applied command and the simulation tick that consumed it
+struct InputJournalEntry {
+    uint32_t tick = 0;
+    InputCommand command;
+};
+
+// One physical input bound to an action
+struct InputBinding {
+    enum class Device : uint8_t { NONE, KEY, MOUSE };
+    Device device = Device::NONE;
+    uint16_t code = 0; // scancode or mouse button
+};
+
 class InputManager {
 public:
     InputManager();
     ~InputManager() = default;
 
-    // Event handling
+    // Event handling. These only record the event; nothing changes until applyPendingInput().
     void handleKeyDown(const SDL_KeyboardEvent& event);
     void handleKeyUp(const SDL_KeyboardEvent& event);
     void handleMouseDown(const SDL_MouseButtonEvent& event);
     void handleMouseUp(const SDL_MouseButtonEvent& event);
     void handleMouseMotion(const SDL_MouseMotionEvent& event);
+    // Queues a command as if it came from the event loop (replays)
+    void inject(const InputCommand& command);
     
     // Input state queries
     bool isActionPressed(InputAction action) const;
@@ -49,10 +78,36 @@ public:
     int getMouseY() const { return mouseY; }
     bool isMouseButtonPressed(int button) const;
     bool isMouseButtonHeld(int button) const;
+    bool isKeyHeld(SDL_Scancode scancode) const;
     
     // Movement vector (normalized)
     void getMovementVector(float& x, float& y) const;
     
+    // Applies everything recorded since the last call (called at the start of each simulation tick)
+    void applyPendingInput();
+
+    // Bindings. Each action takes up to MAX_BINDINGS_PER_ACTION keys and mouse buttons.
+    static constexpr int MAX_BINDINGS_PER_ACTION = 4;
+    using BindingSet = std::array<InputBinding, MAX_BINDINGS_PER_ACTION>;
+    bool bindKey(InputAction action, SDL_Scancode scancode);
+    bool bindMouseButton(InputAction action, int button);
+    void unbind(InputAction action, InputBinding binding);
+    void clearBindings(InputAction action);
+    const BindingSet& getBindings(InputAction action) const { return bindings[static_cast<int>(action)]; }
+    void resetBindingsToDefault();
+    // Text form for per-user persistence: "MOVE_UP=k26,k82;ATTACK_MELEE=m1;..."
+    std::string serializeBindings() const;
+    // Actions missing from the text keep their current bindings; returns false if nothing parsed
+    bool parseBindings(const std::string& text);
+    static const char* getActionName(InputAction action);
+
+    // Journal of applied commands stamped with the tick that consumed them
+    void setJournalEnabled(bool enabled);
+    bool isJournalEnabled() const { return journalEnabled; }
+    const std::vector<InputJournalEntry>& getJournal() const { return journal; }
+    std::vector<InputJournalEntry> takeJournal();
+    uint32_t getTick() const { return tick; }
+
     // Update (called each frame)
     void update();
     
@@ -60,22 +115,37 @@ public:
     void reset();
 
 private:
+    static constexpr int ACTION_COUNT = static_cast<int>(InputAction::COUNT);
+    static constexpr int MOUSE_BUTTON_COUNT = 5;
+
     // Keyboard state
-    std::array<InputState, 256> keyStates;
-    std::array<InputState, 256> previousKeyStates;
+    std::array<InputState, SDL_NUM_SCANCODES> keyStates;
+    std::array<InputState, SDL_NUM_SCANCODES> previousKeyStates;
     
     // Mouse state
-    std::array<InputState, 5> mouseButtonStates;
-    std::array<InputState, 5> previousMouseButtonStates;
+    std::array<InputState, MOUSE_BUTTON_COUNT> mouseButtonStates;
+    std::array<InputState, MOUSE_BUTTON_COUNT> previousMouseButtonStates;
     int mouseX, mouseY;
     int previousMouseX, previousMouseY;
     
-    // Action mapping
-    std::unordered_map<InputAction, SDL_Scancode> actionToKey;
-    std::unordered_map<InputAction, int> actionToMouseButton;
+    // Written by the event loop, drained by the simulation
+    static constexpr size_t PENDING_INPUT_CAPACITY = 1024;
+    SpscQueue<InputCommand, PENDING_INPUT_CAPACITY> pendingInput;
+    void record(InputCommand::Type type, int code, uint32_t timestamp, int x = 0, int y = 0);
+    void apply(const InputCommand& command);
+
+    uint32_t tick = 0;
+    bool journalEnabled = false;
+    std::vector<InputJournalEntry> journal;
+
+    // Action mapping, indexed by InputAction
+    std::array<BindingSet, ACTION_COUNT> bindings{};
     
     // Helper functions
     void initializeKeyBindings();
+    bool addBinding(InputAction action, InputBinding binding);
+    InputState getBindingState(const InputBinding& binding) const;
+    InputState getPreviousBindingState(const InputBinding& binding) const;
     InputState getKeyState(SDL_Scancode scancode) const;
     InputState getMouseButtonState(int button) const;
     void updateKeyState(SDL_Scancode scancode, bool pressed);
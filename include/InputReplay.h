@@ -0,0 +1,96 @@
+#pragma once
+
+#include "InputManager.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Everything besides input that a replay needs to reproduce a session
+struct ReplaySession {
+    uint64_t seed = 0;           // Random session seed when recording started
+    uint32_t tickRate = 0;       // simulation ticks per second
+    bool infinitePotions = false;
+    std::string keyBindings;     // InputManager::serializeBindings()
+    std::string playerSave;      // SaveFormat blob of the player at the first tick
+};
+
+// A gameplay action the game applied besides input (a UI click, a hotkey), recorded at the point
+// the simulation applies it so a replay does the same on the same tick. The game defines type.
+struct ReplayAction {
+    uint8_t type = 0;
+    int slot = -1;
+    uint32_t item = 0;
+    std::string key;
+};
+
+struct ReplayActionEntry {
+    uint32_t tick = 0;
+    ReplayAction action;
+};
+
+// Binary input log for deterministic replays.
+//
+// Layout (integers little-endian, varints LEB128):
+//   "PXRP" | u16 version | u16 flags | u64 seed | u32 tick rate |
+//   varint length + key bindings | varint length + player save | tick records | end record
+// Tick record: varint ticks since the previous record, varint command count (> 0), commands.
+// Command: u8 type, then varint code for keys/buttons or zigzag dx, dy from the last motion.
+// Type ACTION_RECORD is a ReplayAction instead: u8 action type, zigzag slot, varint item,
+// varint length + key; a tick's actions follow its input. Version 1 logs have no actions.
+// End record: varint ticks since the previous record, varint 0; its tick is the session length.
+// Only ticks that applied input or actions are stored.
+class InputRecorder {
+public:
+    static constexpr uint16_t VERSION = 2;
+    static constexpr uint8_t ACTION_RECORD = 0xFF;
+
+    // startTick is InputManager::getTick() at the first recorded tick
+    static std::unique_ptr<InputRecorder> create(const std::string& path, const ReplaySession& session,
+                                                 uint32_t startTick, std::string* outError = nullptr);
+    ~InputRecorder();
+
+    // Journal entries and actions of one or more ticks, each in tick order
+    void record(const std::vector<InputJournalEntry>& entries, const std::vector<ReplayActionEntry>& actions);
+    // Writes the end record; called by the destructor if not called before
+    void finish(uint32_t endTick);
+
+private:
+    InputRecorder() = default;
+    std::ofstream file;
+    std::string block;
+    uint32_t startTick = 0;
+    uint32_t lastTick = 0;
+    int lastMouseX = 0, lastMouseY = 0;
+    bool finished = false;
+};
+
+// Reads a log written by InputRecorder and feeds it back through an InputManager
+class InputPlayer {
+public:
+    static std::unique_ptr<InputPlayer> open(const std::string& path, std::string* outError = nullptr);
+
+    const ReplaySession& getSession() const { return session; }
+    // Length in ticks (up to the last complete record if the file was cut short)
+    uint32_t getLength() const { return length; }
+    bool isFinished() const { return finished; }
+
+    // Queues the commands recorded for tick (counted from the start of the recording) into
+    // input and appends its actions to actions. Call once per tick, before
+    // InputManager::applyPendingInput(). Returns false once the recording has ended.
+    bool feed(uint32_t tick, InputManager& input, std::vector<ReplayAction>& actions);
+
+private:
+    InputPlayer() = default;
+    bool readRecordHeader();
+
+    ReplaySession session;
+    std::vector<uint8_t> data;
+    size_t pos = 0;
+    uint32_t nextTick = 0;   // tick of the record at pos
+    uint32_t nextCount = 0;  // commands in that record; 0 means the end record
+    uint32_t length = 0;
+    int lastMouseX = 0, lastMouseY = 0;
+    bool finished = false;
+};
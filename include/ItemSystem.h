@@ -2,9 +2,12 @@
 
 #include <SDL.h>
 #include <string>
+#include <string_view>
+#include <deque>
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <cstdint>
 
 // Forward declarations
 class AssetManager;
@@ -53,12 +56,29 @@ struct ItemStats {
     int poisonResist = 0;
 };
 
+// 32-bit generational reference to a pooled Item: low 16 bits slot index, high 16 bits generation.
+// Once the item is destroyed its slot's generation moves on, so old handles resolve to nullptr.
+struct ItemHandle {
+    uint32_t value = 0; // 0 is never issued
+
+    static ItemHandle make(uint16_t index, uint16_t generation) {
+        return ItemHandle{(static_cast<uint32_t>(generation) << 16) | index};
+    }
+    uint16_t index() const { return static_cast<uint16_t>(value & 0xFFFF); }
+    uint16_t generation() const { return static_cast<uint16_t>(value >> 16); }
+    bool isValid() const { return value != 0; }
+    bool operator==(const ItemHandle& other) const { return value == other.value; }
+    bool operator!=(const ItemHandle& other) const { return value != other.value; }
+};
+
 struct Item {
-    std::string id;           // Template identifier (e.g., "rusty_sword")
-    std::string instanceId;   // Unique instance identifier for each item copy
-    std::string name;         // Display name
-    std::string description;  // Tooltip description
-    std::string iconPath;     // Path to PNG icon
+    // Template strings are interned by ItemSystem; every instance shares them
+    std::string_view id;          // Template identifier (e.g., "rusty_sword")
+    std::string_view name;        // Display name
+    std::string_view description; // Tooltip description
+    std::string_view iconPath;    // Path to PNG icon
+    uint32_t instanceId = 0;      // Unique per item copy for the session
+    ItemHandle handle;            // Pool slot this instance lives in (invalid for templates)
     ItemType type;
     ItemRarity rarity;
     int stackSize;           // Max stack size (1 for equipment, higher for consumables)
@@ -71,7 +91,7 @@ struct Item {
     
     // Constructors
     Item() = default; // Default constructor for containers
-    Item(const std::string& itemId, const std::string& itemName, ItemType itemType, 
+    Item(std::string_view itemId, std::string_view itemName, ItemType itemType,
          ItemRarity itemRarity = ItemRarity::COMMON, int maxStack = 1);
     
     // Get display color based on rarity
@@ -87,7 +107,9 @@ struct Item {
     bool canStackWith(const Item& other) const;
 };
 
-// Inventory slot that can hold an item
+// Inventory slot that can hold an item. The pointer targets ItemSystem's fixed item pool, so it stays
+// valid while the item is slotted; anything that outlives the slot (e.g. the anvil target) keeps the
+// item's ItemHandle instead.
 struct InventorySlot {
     Item* item = nullptr;
     bool isEmpty() const { return item == nullptr; }
@@ -100,22 +122,30 @@ public:
     ItemSystem(AssetManager* assetManager);
     ~ItemSystem();
     
-    // Item creation and management
-    Item* createItem(const std::string& itemId, ItemRarity rarity = ItemRarity::COMMON, int stack = 1);
-    Item* getItemTemplate(const std::string& itemId) const;
-    
     // Inventory management (separate bags for items, scrolls, and resources)
     static constexpr int INVENTORY_ROWS = 6;
     static constexpr int INVENTORY_COLS = 8;
     static constexpr int INVENTORY_SIZE = INVENTORY_ROWS * INVENTORY_COLS;
     static constexpr int SCROLL_INVENTORY_SIZE = 20; // Separate scroll inventory
     static constexpr int RESOURCE_INVENTORY_SIZE = 30; // Separate resource inventory
+    static constexpr int EQUIPMENT_SLOT_COUNT = 9;
+    // Every live item occupies a slot; the headroom covers items created but not yet placed
+    static constexpr int MAX_ITEM_INSTANCES = INVENTORY_SIZE + SCROLL_INVENTORY_SIZE + RESOURCE_INVENTORY_SIZE +
+                                              EQUIPMENT_SLOT_COUNT + 16;
+    
+    // Item creation and management. Instances live in a fixed pool allocated up front, so creating
+    // and destroying items never allocates; createItem returns nullptr if the pool is exhausted.
+    Item* createItem(const std::string& itemId, ItemRarity rarity = ItemRarity::COMMON, int stack = 1);
+    void destroyItem(Item* item);
+    Item* getItem(ItemHandle handle) const; // nullptr once the item has been destroyed
+    int getLiveItemCount() const { return MAX_ITEM_INSTANCES - static_cast<int>(freeItems.size()); }
+    Item* getItemTemplate(const std::string& itemId) const;
     
     // Add item to appropriate inventory
     bool addItem(const std::string& itemId, int amount = 1, ItemRarity rarity = ItemRarity::COMMON);
     bool addItemToSlot(Item* item, int slotIndex, bool isScrollInventory = false);
     
-    // Remove item from inventory
+    // Remove item from inventory; emptied stacks are returned to the pool
     bool removeItem(const std::string& itemId, int amount = 1);
     bool removeItemFromSlot(int slotIndex, bool isScrollInventory = false);
     
@@ -130,11 +160,17 @@ public:
     bool unequipItem(int equipmentSlot);
     bool swapEquipment(int fromSlot, int toSlot); // Swap between inventory and equipment
     
-    // Stats calculation
+    // Stats calculation. getTotalStats is cached and only re-summed after the version changes.
     ItemStats calculateTotalStats() const;
+    const ItemStats& getTotalStats() const;
+    
+    // Change tracking: bumped whenever inventory/equipment contents or an owned item's stats change.
+    // Callers that modify an Item* in place (upgrades, enchants) must call markChanged().
+    uint64_t getVersion() const { return version; }
+    void markChanged() { ++version; }
     
     // UI helpers
-    Texture* getItemIcon(const std::string& itemId) const;
+    Texture* getItemIcon(std::string_view itemId) const;
     
     // Initialize item templates
     void initializeItemTemplates();
@@ -160,15 +196,23 @@ private:
     std::vector<InventorySlot> resourceInventory;  // Resource/material inventory
     std::vector<InventorySlot> equipmentSlots;     // Currently equipped items (9 slots)
     
-    // Item templates and instances
-    std::unordered_map<std::string, Item> itemTemplates; // Master templates
-    std::vector<std::unique_ptr<Item>> itemInstances;    // Actual item instances
-    std::unordered_map<std::string, Texture*> itemIcons; // Cached icons
+    // Item templates; their strings live in templateStrings (a deque, so views stay valid as it grows)
+    std::unordered_map<std::string, Item> itemTemplates;
+    std::deque<std::string> templateStrings;
+    std::unordered_map<std::string_view, Texture*> itemIcons; // Cached icons, keyed by interned id
     
-    // Instance ID generation
-    int nextInstanceId = 1;
+    // Item pool: slot i is live while itemPool[i].handle is valid
+    std::vector<Item> itemPool;
+    std::vector<uint16_t> itemGenerations;
+    std::vector<uint16_t> freeItems;
+    uint32_t nextInstanceId = 1;
+    uint64_t version = 1;
+    mutable ItemStats cachedTotalStats;
+    mutable uint64_t cachedTotalStatsVersion = 0;
     
     // Helper functions
+    std::string_view internString(const std::string& text);
+    void releaseSlots(std::vector<InventorySlot>& slots);
     int findEmptySlot(bool isScrollInventory = false) const;
     int findItemSlot(const std::string& itemId, bool isScrollInventory = false) const;
     bool canAddToSlot(const Item* item, int slotIndex, bool isScrollInventory = false) const;
@@ -1,61 +1,88 @@
 #pragma once
 
 #include "Object.h"
-#include <random>
+#include "Random.h"
+#include <cstdint>
+#include <string>
 #include <vector>
 
+enum class PackRarity; // Enemy.h
+
+// Holds the compiled loot tables, which are immutable after construction. Every roll draws from
+// the caller's stream (the dying enemy's, the opened container's), so results are reproducible
+// per source and safe to generate from any thread.
 class LootGenerator {
 public:
     static LootGenerator& getInstance();
-    
-    // Generate loot for enemies based on level and rarity
-    std::vector<Loot> generateEnemyLoot(int enemyLevel, float rarityBonus = 0.0f);
-    
+
+    // Generate loot for enemies based on level and pack rarity
+    std::vector<Loot> generateEnemyLoot(RandomStream& rng, int enemyLevel, PackRarity packRarity) const;
+    // Appends to out; reusing one buffer keeps mass kills free of allocations
+    void generateEnemyLoot(RandomStream& rng, int enemyLevel, PackRarity packRarity, std::vector<Loot>& out) const;
+
     // Generate loot for containers (chests, pots, etc)
-    std::vector<Loot> generateContainerLoot(ObjectType containerType);
-    
+    std::vector<Loot> generateContainerLoot(RandomStream& rng, ObjectType containerType) const;
+    void generateContainerLoot(RandomStream& rng, ObjectType containerType, std::vector<Loot>& out) const;
+
     // Generate specific loot types
-    Loot generateEquipmentLoot(int level, LootRarity forceRarity = LootRarity::COMMON);
-    Loot generateScrollLoot(LootRarity rarity = LootRarity::COMMON);
-    Loot generateMaterialLoot(LootRarity rarity = LootRarity::COMMON);
-    
+    Loot generateEquipmentLoot(RandomStream& rng, int level, LootRarity forceRarity = LootRarity::COMMON) const;
+    Loot generateScrollLoot(RandomStream& rng, LootRarity rarity = LootRarity::COMMON) const;
+    Loot generateMaterialLoot(RandomStream& rng, LootRarity rarity = LootRarity::COMMON) const;
+
     // Rarity roll functions
-    LootRarity rollRarity(float rarityBonus = 0.0f);
-    
-    // Set seed for deterministic generation (testing)
-    void setSeed(unsigned int seed);
-    
+    static LootRarity rollRarity(RandomStream& rng, float rarityBonus = 0.0f);
+
 private:
     LootGenerator();
-    std::mt19937 rng;
-    
-    // Loot tables
+
+    static constexpr int RARITY_COUNT = 5;
+    static constexpr int PACK_RARITY_COUNT = 4;
+    static constexpr int MAX_LEVEL_BAND = 10; // equipment templates and interned descriptions cover levels 1-10
+
+    // Walker's alias method: O(1) weighted sampling from a table built once
+    struct AliasTable {
+        std::vector<float> probability;
+        std::vector<uint8_t> alias;
+        void build(const std::vector<float>& weights);
+    };
+    static int sample(RandomStream& rng, const AliasTable& table);
+
+    // Loot tables, compiled once per (level band, pack rarity) for enemies and per container kind
     struct LootTable {
-        std::vector<std::pair<LootType, float>> weights; // type, weight
+        std::vector<LootType> types;
+        AliasTable typeSampler;
+        AliasTable raritySampler; // rollRarity() distribution with the source's bonus folded in
         int minItems = 1;
         int maxItems = 1;
         float goldChance = 0.5f;
         int minGold = 10;
         int maxGold = 50;
     };
-    
-    LootTable getEnemyLootTable(int level);
-    LootTable getContainerLootTable(ObjectType type);
-    
+
+    std::vector<LootTable> enemyTables;     // [(band - 1) * PACK_RARITY_COUNT + pack]
+    std::vector<LootTable> containerTables; // see containerTableIndex()
+
+    void compileTables();
+    static void setWeights(LootTable& table, const std::vector<std::pair<LootType, float>>& weights);
+    static AliasTable compileRarity(float rarityBonus);
+    static float rarityBonusFor(PackRarity packRarity);
+    static int containerTableIndex(ObjectType type);
+    const LootTable& enemyLootTable(int level, PackRarity packRarity) const;
+
     // Equipment generation
     struct EquipmentTemplate {
-        std::string baseName;
+        const char* baseName;
         int minLevel;
         int maxLevel;
         float statRange;
     };
-    
-    std::vector<EquipmentTemplate> getEquipmentTemplates();
-    
-    // Material names
-    std::vector<std::string> getMaterialNames(LootRarity rarity);
-    
-    // Utility functions
-    int rollRange(int min, int max);
-    float rollFloat(float min = 0.0f, float max = 1.0f);
-};
\ No newline at end of file
+    static const EquipmentTemplate EQUIPMENT_TEMPLATES[];
+    static const int EQUIPMENT_TEMPLATE_COUNT;
+
+    // Template indices valid at each level 1..MAX_LEVEL_BAND; index 0 holds every template (fallback)
+    std::vector<uint8_t> equipmentPools[MAX_LEVEL_BAND + 1];
+
+    // Interned strings, built once; Loot only holds views into them
+    std::vector<std::string> equipmentNames;        // [template * RARITY_COUNT + rarity]
+    std::vector<std::string> equipmentDescriptions; // [template * MAX_LEVEL_BAND + level - 1]
+};
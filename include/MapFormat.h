@@ -0,0 +1,255 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compiled map format (.pxmap), produced offline by PixMapCompiler from a Tiled TMX map and
+// memory-mapped by World at load. Everything the game derives from a TMX (tileset table, collision
+// and hazard masks, ledge faces) is baked at compile time, so loading is a header check and a few
+// pointer fix-ups. All values are little-endian; every section starts on an 8-byte boundary.
+//
+// Layout: MapFileHeader, MapFileLayer[layerCount], MapFileTileset[tilesetCount],
+// MapFileRegion[regionCount], masks (MAP_MASK_COUNT bitmasks of maskWords uint64 each, row-major,
+// bit x+y*width), per layer a block table and its blocks, string blob (NUL-terminated).
+//
+// Layer GIDs are stored sparsely in MAP_BLOCK_SIZE square blocks: the block table holds one entry
+// per block of the map (row-major, blocksX*blocksY), 0 for an all-empty block or the 1-based index
+// of the block's GIDs (uint16 or uint32, row-major). Reading a tile only touches its own block, so
+// the layers of a large or mostly empty (Tiled "infinite") map page in just the parts being drawn.
+//
+// Everything else is dense over the map's bounding box, including the empty space between an
+// infinite map's chunks: the collision masks, the TMX layers while compiling, and World's tile,
+// visibility and exploration grids. Maps past MAP_MAX_CELLS are refused instead of allocated;
+// streaming a map in by chunk is not supported.
+
+constexpr uint32_t MAP_FILE_VERSION = 2;
+constexpr int MAP_BLOCK_SIZE = 16;
+constexpr uint64_t MAP_MAX_CELLS = 4096ull * 4096ull;
+constexpr char MAP_FILE_EXTENSION[] = ".pxmap";
+
+enum MapMaskId : uint32_t {
+    MAP_MASK_BLOCKED = 0, // not walkable (lava, ledge faces)
+    MAP_MASK_HAZARD,      // drawn and treated as lava
+    MAP_MASK_PLATFORM,    // any platform layer
+    MAP_MASK_PLATFORM1,
+    MAP_MASK_PLATFORM2,
+    MAP_MASK_STAIRS,
+    MAP_MASK_EDGE,        // "floating land" cells and detected ledge faces
+    MAP_MASK_LAVA,        // raw lava layer coverage, before platforms/stairs are cut out
+    MAP_MASK_COUNT
+};
+
+// What a layer's name made it count as when the map was compiled
+enum MapLayerFlags : uint32_t {
+    MAP_LAYER_PLATFORM1 = 1u << 0,
+    MAP_LAYER_PLATFORM2 = 1u << 1,
+    MAP_LAYER_STAIRS    = 1u << 2,
+    MAP_LAYER_EDGE      = 1u << 3,
+    MAP_LAYER_LAVA      = 1u << 4,
+    MAP_LAYER_GROUND    = 1u << 5
+};
+
+struct MapFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t tileWidth;
+    uint32_t tileHeight;
+    uint32_t layerCount;
+    uint32_t tilesetCount;
+    uint32_t regionCount;
+    uint32_t maskWords;      // uint64 words per mask
+    int32_t originX;         // Tiled tile coordinates of cell (0,0); non-zero for infinite maps
+    int32_t originY;
+    uint32_t blocksX;        // width / MAP_BLOCK_SIZE, rounded up
+    uint32_t blocksY;
+    uint64_t layersOffset;
+    uint64_t tilesetsOffset;
+    uint64_t regionsOffset;
+    uint64_t masksOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t fileSize;
+};
+
+struct MapFileLayer {
+    uint32_t nameOffset;       // into the string blob
+    uint32_t flags;            // MapLayerFlags
+    uint32_t gidBytes;         // 2 or 4
+    uint32_t blockCount;       // non-empty blocks stored
+    uint64_t blockTableOffset; // uint32[blocksX*blocksY]
+    uint64_t blockDataOffset;  // blockCount * MAP_BLOCK_SIZE^2 GIDs
+};
+
+// Sorted by firstGid
+struct MapFileTileset {
+    uint32_t firstGid;
+    uint32_t tileCount;      // 0 when the tileset didn't say
+    uint32_t tileWidth;
+    uint32_t tileHeight;
+    uint32_t columns;        // 0 when it has to come from the image width
+    uint32_t nameOffset;
+    uint32_t imagePathOffset;   // relative to the map file
+    uint32_t imageSourceOffset; // as written in the tileset
+};
+
+// One object from a TMX object group (spawn areas, props, arenas), in map pixels from cell (0,0)
+struct MapFileRegion {
+    uint32_t groupOffset;
+    uint32_t nameOffset;
+    uint32_t typeOffset;
+    uint32_t gid;            // 0 for plain shapes
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+// Read-only view of one packed bitmask, either inside a compiled map or anywhere else
+class MapBitmask {
+public:
+    MapBitmask() = default;
+    MapBitmask(const uint64_t* words, int width, int height) : words(words), width(width), height(height) {}
+
+    bool empty() const { return words == nullptr; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    // Out-of-bounds cells read as clear
+    bool test(int x, int y) const {
+        if (!words || x < 0 || y < 0 || x >= width || y >= height) return false;
+        const size_t bit = static_cast<size_t>(y) * width + x;
+        return (words[bit >> 6] >> (bit & 63)) & 1u;
+    }
+
+private:
+    const uint64_t* words = nullptr;
+    int width = 0;
+    int height = 0;
+};
+
+// Read-only file mapping (mmap / CreateFileMapping)
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+// A validated compiled map, backed by a file mapping or by bytes compiled in memory
+class CompiledMap {
+public:
+    bool open(const std::string& path, std::string* error = nullptr);
+    bool adopt(std::vector<uint8_t> bytes, std::string* error = nullptr);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    int getWidth() const { return header ? static_cast<int>(header->width) : 0; }
+    int getHeight() const { return header ? static_cast<int>(header->height) : 0; }
+    int getTileWidth() const { return header ? static_cast<int>(header->tileWidth) : 0; }
+    int getTileHeight() const { return header ? static_cast<int>(header->tileHeight) : 0; }
+
+    size_t getLayerCount() const { return header ? header->layerCount : 0; }
+    const MapFileLayer& getLayer(size_t index) const { return layers[index]; }
+    // x and y must be inside the map
+    uint32_t getGid(size_t layer, int x, int y) const {
+        const MapFileLayer& l = layers[layer];
+        const uint32_t* table = reinterpret_cast<const uint32_t*>(data + l.blockTableOffset);
+        const uint32_t block = table[static_cast<size_t>(y / MAP_BLOCK_SIZE) * header->blocksX + x / MAP_BLOCK_SIZE];
+        if (block == 0) return 0;
+        const size_t cell = (static_cast<size_t>(block - 1) * MAP_BLOCK_SIZE + y % MAP_BLOCK_SIZE) * MAP_BLOCK_SIZE + x % MAP_BLOCK_SIZE;
+        const uint8_t* base = data + l.blockDataOffset;
+        return l.gidBytes == 2 ? reinterpret_cast<const uint16_t*>(base)[cell]
+                               : reinterpret_cast<const uint32_t*>(base)[cell];
+    }
+    // Whether the block holding (x, y) has any tiles on this layer; lets renderers skip empty areas
+    bool hasBlock(size_t layer, int x, int y) const {
+        const uint32_t* table = reinterpret_cast<const uint32_t*>(data + layers[layer].blockTableOffset);
+        return table[static_cast<size_t>(y / MAP_BLOCK_SIZE) * header->blocksX + x / MAP_BLOCK_SIZE] != 0;
+    }
+
+    size_t getTilesetCount() const { return header ? header->tilesetCount : 0; }
+    const MapFileTileset& getTileset(size_t index) const { return tilesets[index]; }
+    size_t getRegionCount() const { return header ? header->regionCount : 0; }
+    const MapFileRegion& getRegion(size_t index) const { return regions[index]; }
+
+    MapBitmask getMask(MapMaskId mask) const;
+    const char* getString(uint32_t offset) const;
+
+private:
+    bool bind(const uint8_t* bytes, size_t size, std::string* error);
+
+    MappedFile file;
+    std::vector<uint8_t> ownedBytes;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    const MapFileHeader* header = nullptr;
+    const MapFileLayer* layers = nullptr;
+    const MapFileTileset* tilesets = nullptr;
+    const MapFileRegion* regions = nullptr;
+};
+
+// Source side, used by the compiler and as the runtime fallback when no compiled map exists
+struct TmxTileset {
+    int firstGid = 0;
+    int tileCount = 0;
+    int tileWidth = 32;
+    int tileHeight = 32;
+    int columns = 0;
+    std::string name;
+    std::string imagePath;   // relative to the map file
+    std::string imageSource; // as written in the tileset
+};
+
+struct TmxLayer {
+    std::string name;
+    std::vector<uint32_t> gids; // map width*height
+};
+
+struct TmxObject {
+    std::string group;
+    std::string name;
+    std::string type;
+    uint32_t gid = 0;
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+};
+
+struct TmxMap {
+    int width = 0;
+    int height = 0;
+    int originX = 0; // Tiled tile coordinates of cell (0,0); non-zero only for infinite maps
+    int originY = 0;
+    int tileWidth = 32;
+    int tileHeight = 32;
+    std::vector<TmxTileset> tilesets;
+    std::vector<TmxLayer> layers;
+    std::vector<TmxObject> objects;
+};
+
+bool loadTmxMap(const std::string& path, TmxMap& out, std::string* error = nullptr);
+// Bakes masks and serializes to the .pxmap layout
+void compileMap(const TmxMap& map, std::vector<uint8_t>& out);
+bool writeCompiledMap(const TmxMap& map, const std::string& path, std::string* error = nullptr);
+// "maps/foo.tmx" -> "maps/foo.pxmap"
+std::string compiledMapPathFor(const std::string& tmxPath);
+// A path stored relative to the map file, made usable from the working directory
+std::string resolveMapPath(const std::string& mapPath, const std::string& relative);
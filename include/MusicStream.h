@@ -0,0 +1,64 @@
+#pragma once
+
+#include <SDL.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Source of undecoded PCM for a MusicStream (WAV, or Ogg Vorbis when built with USE_VORBIS)
+class MusicDecoder {
+public:
+    virtual ~MusicDecoder() = default;
+    // Fills up to bytes of source-format PCM; returns bytes written, 0 at end of file, -1 on error
+    virtual int read(Uint8* buffer, int bytes) = 0;
+    virtual bool rewind() = 0;
+
+    SDL_AudioFormat format = AUDIO_S16LSB;
+    int channels = 0;
+    int rate = 0;
+};
+
+// Opens a decoder for path by its extension and contents; nullptr (with error set) if unsupported
+std::unique_ptr<MusicDecoder> openMusicDecoder(const std::string& path, std::string* error = nullptr);
+
+// Looping music track decoded a block at a time on its own thread into a fixed ring of
+// device-format frames (S16, deviceSpec channels and rate). The audio callback pulls from the
+// ring and applies volume at mix time, so memory per track is constant and volume changes are
+// immediate. If the decoder falls behind, read() comes up short and the gap plays as silence.
+class MusicStream {
+public:
+    static std::unique_ptr<MusicStream> open(const std::string& path, const SDL_AudioSpec& deviceSpec, std::string* error = nullptr);
+    ~MusicStream();
+    MusicStream(const MusicStream&) = delete;
+    MusicStream& operator=(const MusicStream&) = delete;
+
+    // Audio thread only: copies up to frames interleaved frames, returns how many were available
+    int read(Sint16* out, int frames);
+
+private:
+    MusicStream() = default;
+    // Decoder thread: decode and convert until the ring is full (or the track fails)
+    void fill();
+    void run();
+
+    static constexpr int DECODE_BLOCK_BYTES = 16384;
+    static constexpr int RING_SECONDS_DENOMINATOR = 2; // ring holds half a second
+
+    std::unique_ptr<MusicDecoder> decoder;
+    SDL_AudioStream* converter = nullptr;
+    std::vector<Uint8> decodeBlock;
+    std::vector<Sint16> convertBlock;
+    int channels = 2;
+
+    // Single producer (decoder thread) / single consumer (audio callback); positions only grow
+    std::vector<Sint16> ring;
+    size_t ringMask = 0; // ring.size() - 1, a power of two
+    std::atomic<size_t> writePos{0};
+    std::atomic<size_t> readPos{0};
+
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> failed{false};
+    std::thread worker;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <SDL.h>
 
@@ -8,6 +9,7 @@
 class Texture;
 class SpriteSheet;
 class AssetManager;
+class Renderer;
 
 enum class LootRarity {
     COMMON,    // White
@@ -31,11 +33,12 @@ struct Loot {
     LootType type;
     LootRarity rarity;
     int amount;
-    std::string name;
-    std::string description;
+    // Views of string literals or LootGenerator's interned names, so rolling loot never allocates
+    std::string_view name;
+    std::string_view description;
     
-    Loot(LootType lootType, int lootAmount, const std::string& lootName = "", 
-         LootRarity lootRarity = LootRarity::COMMON, const std::string& lootDesc = "")
+    Loot(LootType lootType, int lootAmount, std::string_view lootName = "", 
+         LootRarity lootRarity = LootRarity::COMMON, std::string_view lootDesc = "")
         : type(lootType), rarity(lootRarity), amount(lootAmount), name(lootName), description(lootDesc) {}
     
     // Get color for rarity display
@@ -73,7 +76,7 @@ public:
 
     // Core functions
     void update(float deltaTime);
-    void render(SDL_Renderer* renderer, int cameraX, int cameraY, int tileSize, float zoom);
+    void render(Renderer* renderer, int cameraX, int cameraY, int tileSize, float zoom);
     void setPositionPixels(float px, float py) { pixelX = px; pixelY = py; hasPixelPos = true; }
     float getPixelX() const { return hasPixelPos ? pixelX : static_cast<float>(x *  tileSizeHint); }
     float getPixelY() const { return hasPixelPos ? pixelY : static_cast<float>(y * tileSizeHint); }
@@ -139,7 +142,7 @@ protected:
     bool walkable;
     bool visible;
     bool collectible = false; // auto-pickup on touch
-    Uint32 spawnTicksMs = 0;   // creation time (SDL ticks)
+    Uint32 spawnTicksMs = 0;   // creation time (Game simulation clock, ms)
     float magnetDelaySeconds = 0.0f; // delay before magnet can activate
     
     // Animation (for future use)
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class AssetManager;
+class SpriteSheet;
+class Renderer;
+
+// Pooled short-lived effects (explosions, embers, smoke, breath flames).
+// Storage is a fixed-capacity structure-of-arrays; dead particles are removed by moving the last
+// live one into their slot. Sprites are resolved to small integer handles up front, so updating
+// and rendering never build strings or touch the asset cache.
+class ParticleSystem {
+public:
+    static constexpr int CAPACITY = 1024;
+
+    using SpriteHandle = int;
+    static constexpr SpriteHandle NO_SPRITE = -1; // drawn as a plain orange square of the particle radius
+
+    enum Flags : uint8_t {
+        FLAG_NONE = 0,
+        FLAG_DAMAGE = 1 << 0,          // listed by getDamagingIndices() for the enemy collision pass
+        FLAG_BURST_ON_EXPIRE = 1 << 1  // position reported by getExpiredBursts() when lifetime runs out
+    };
+
+    explicit ParticleSystem(AssetManager* assetManager);
+
+    // Look up an already loaded sprite sheet; returns NO_SPRITE if it is missing
+    SpriteHandle resolveSprite(const std::string& path, float scale = 1.0f);
+
+    // Returns the slot index, or -1 when the pool is full (the effect is simply dropped)
+    int spawn(SpriteHandle sprite, float x, float y, float vx, float vy, float lifetime,
+              float fps, float radius, int damage = 0, uint8_t flags = FLAG_NONE);
+
+    // Integrates, ages and removes particles; anything outside the world (plus a margin) is dropped
+    void update(float deltaTime, float worldW, float worldH);
+    // Draws all live particles grouped by sprite so consecutive copies share a texture
+    void render(Renderer* renderer);
+    void clear();
+
+    int size() const { return count; }
+
+    // Damage component, rebuilt by update(); indices stay valid until the next update()
+    const std::vector<int>& getDamagingIndices() const { return damaging; }
+    float getX(int i) const { return posX[i]; }
+    float getY(int i) const { return posY[i]; }
+    float getRadius(int i) const { return radius[i]; }
+    int getDamage(int i) const { return damage[i]; }
+
+    // Positions of FLAG_BURST_ON_EXPIRE particles that expired during the last update()
+    const std::vector<SDL_FPoint>& getExpiredBursts() const { return bursts; }
+
+private:
+    struct Sprite {
+        SpriteSheet* sheet;
+        float scale;
+    };
+
+    void removeAt(int i);
+
+    AssetManager* assetManager;
+    std::vector<Sprite> sprites;
+    int count = 0;
+
+    // Structure-of-arrays storage, CAPACITY entries each; [0, count) are live
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> age, lifetime;
+    std::vector<float> fps;
+    std::vector<float> radius;
+    std::vector<int> damage;
+    std::vector<SpriteHandle> sprite;
+    std::vector<uint8_t> flags;
+
+    std::vector<int> damaging;
+    std::vector<SDL_FPoint> bursts;
+
+    // Render scratch: particle indices bucketed by sprite (counting sort)
+    std::vector<int> bucketStart;
+    std::vector<int> order;
+};
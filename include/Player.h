@@ -6,6 +6,9 @@
 #include <string>
 #include <array>
 #include <unordered_map>
+#include "Random.h"
+#include "ItemSystem.h"
+#include "RenderSnapshot.h"
 
 // Forward declarations
 class Projectile;
@@ -19,6 +22,7 @@ class SpriteSheet;
 class InputManager;
 class Object;
 struct PlayerSave; // from Database.h
+struct TileSweepResult; // from TileCollision.h
 
 enum class PlayerState {
     IDLE,
@@ -45,7 +49,9 @@ public:
 
     // Core update and render
     void update(float deltaTime);
-    void render(Renderer* renderer);
+    // Draws at the transform's position and frame (an interpolated snapshot) rather than the live state
+    void render(Renderer* renderer, const EntityTransform& transform);
+    EntityTransform getTransform() const { return EntityTransform{this, x, y, currentFrame}; }
     
     // Projectile management
     void updateProjectiles(float deltaTime);
@@ -170,7 +176,25 @@ public:
         int maxDurability = 0;          // cap for durability
     };
     const EquipmentItem& getEquipment(EquipmentSlot slot) const { return equipment[static_cast<int>(slot)]; }
-    EquipmentItem& getEquipmentMutable(EquipmentSlot slot) { return equipment[static_cast<int>(slot)]; }
+    EquipmentItem& getEquipmentMutable(EquipmentSlot slot) { markEquipmentChanged(); return equipment[static_cast<int>(slot)]; }
+    // Bumped whenever equipment (legacy array or equipped Items) changes; lets UI panels skip redraws
+    uint64_t getEquipmentVersion() const { return equipmentVersion; }
+
+    // Combat values derived from equipment, strength and spell passives. Rebuilt only after one of
+    // those changes (equip, unequip, upgrade, enchant, level up, spell tree switch); hits read them as-is.
+    struct CombatStats {
+        ItemStats itemTotals;                        // summed stats of equipped Items
+        int meleeDamage = 0;                         // strength * 2 + sword attack + weapon fire, before crits
+        int weaponFireDamage = 0;                    // fire enchant added to arrows and sword projectiles
+        int fireShieldDamage = 0;
+        int fireResistance = 0;
+        float critChancePercent = 0.0f;              // 0..100
+        float attackSpeedMultiplier = 1.0f;          // sword
+        float lowHealthAttackSpeedMultiplier = 1.0f; // sword with the fire tree's below-half-health bonus
+        uint64_t version = 0;                        // bumped on every rebuild
+    };
+    const CombatStats& getCombatStats() const;
+    float getMeleeAttackSpeed() const;
     void upgradeEquipment(EquipmentSlot slot, int deltaPlus);
     void upgradeSpecificItem(class Item* item, int deltaPlus);
     void enchantEquipment(EquipmentSlot slot, const std::string& element, int amount);
@@ -208,6 +232,24 @@ public:
 
 private:
     Game* game;
+    uint64_t equipmentVersion = 1;
+    void markEquipmentChanged();
+
+    // Inputs the combat stats were last built from
+    struct CombatStatsSources {
+        uint64_t itemVersion = 0;
+        uint64_t equipmentVersion = 0;
+        int strength = -1;
+        int spellElement = -1;
+        int enchantLevel = -1;
+        bool operator==(const CombatStatsSources& o) const {
+            return itemVersion == o.itemVersion && equipmentVersion == o.equipmentVersion && strength == o.strength &&
+                   spellElement == o.spellElement && enchantLevel == o.enchantLevel;
+        }
+    };
+    mutable CombatStats combatStats;
+    mutable CombatStatsSources combatStatsSources;
+    void rebuildCombatStats(const CombatStatsSources& sources) const;
     
     // Position and size
     float x, y;
@@ -255,6 +297,9 @@ private:
     // Spell system
     std::unique_ptr<SpellSystem> spellSystem;
     
+    // Combat rolls (crits)
+    RandomStream rng = Random::stream(RngSystem::Player);
+    
     // Legacy equipment and upgrade resources (for compatibility)
     std::array<EquipmentItem, static_cast<size_t>(EquipmentSlot::COUNT)> equipment;
     int upgradeScrolls = 0; // "Blessed upgrade scroll"
@@ -339,6 +384,8 @@ private:
     // Helper functions
     void loadSprites();
     SpriteSheet* getSpriteSheetForState(PlayerState state);
+    // Movement of the feet box by (dx, dy) that the world's terrain allows
+    TileSweepResult sweepFeet(float dx, float dy) const;
     
     // Projectile management
     std::vector<std::unique_ptr<Projectile>> projectiles;
@@ -358,6 +405,8 @@ private:
     static constexpr float RANGED_ATTACK_COOLDOWN = 1.0f;
     static constexpr float FRAME_DURATION = 0.2f;  // Slower animation for better visibility
     static constexpr float DASH_COOLDOWN_SECONDS = 10.0f;
+    static constexpr float FEET_HALF_WIDTH = 8.0f;  // terrain collision box around the feet
+    static constexpr float FEET_HALF_HEIGHT = 4.0f;
     static constexpr int BASE_HEALTH = 100;
     static constexpr int BASE_MANA = 50;
     static constexpr int BASE_STRENGTH = 10;
@@ -9,6 +9,7 @@
 class Renderer;
 class SpriteSheet;
 class AssetManager;
+class World;
 
 // Projectile direction using a 2D vector
 struct ProjectileDirection {
@@ -40,8 +41,9 @@ public:
               bool rotateByDirection = false);
     ~Projectile() = default;
 
-    // Core update and render
-    void update(float deltaTime);
+    // Core update and render. With a world, the projectile dies when its flight this tick crosses
+    // a solid tile or it leaves the loaded chunks.
+    void update(float deltaTime, const World* world = nullptr);
     void render(Renderer* renderer);
     
     // Getters
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+// Systems that draw random numbers; each gets its own family of streams
+enum class RngSystem : uint32_t {
+    WorldGen,
+    Chunks,
+    Enemies,
+    Bosses,
+    Loot,
+    Containers,
+    Spells,
+    StatusEffects,
+    Player,
+    Crafting,
+    Saves,
+    COUNT
+};
+
+// Counter-based random stream (splitmix64): draw n is a pure function of (key, n), so a stream's
+// output never depends on what other systems or threads drew before it. Streams are plain values;
+// copying one forks it. Also satisfies UniformRandomBitGenerator for std::shuffle and <random>.
+class RandomStream {
+public:
+    using result_type = uint64_t;
+
+    RandomStream() = default;
+    explicit RandomStream(uint64_t key) : key(key) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+    result_type operator()() { return nextU64(); }
+
+    uint64_t nextU64() { return mix(key + (++counter) * 0x9E3779B97F4A7C15ull); }
+    // Uniform in [0, 1)
+    float nextFloat() { return static_cast<float>(nextU64() >> 40) * (1.0f / 16777216.0f); }
+    float nextFloat(float min, float max) { return min + (max - min) * nextFloat(); }
+    // Uniform in [min, max], inclusive
+    int nextInt(int min, int max) {
+        if (min >= max) return min;
+        uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+        return static_cast<int>(min + static_cast<int64_t>(((nextU64() >> 32) * range) >> 32));
+    }
+    bool chance(float probability) { return nextFloat() < probability; }
+
+    // Number of draws so far; restoring it resumes the stream exactly (replays, saves)
+    uint64_t getCounter() const { return counter; }
+    void setCounter(uint64_t value) { counter = value; }
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t key = 0;
+    uint64_t counter = 0;
+};
+
+// Hands out independent streams derived from the session seed. Everything here is lock-free:
+// the seed and per-system sequence numbers are atomics, and streams carry no shared state.
+class Random {
+public:
+    // Seed for all streams created afterwards (fixed world seeds, replays, benchmarks)
+    static void setSeed(uint64_t seed);
+    static uint64_t getSeed();
+
+    // Stream keyed by (system, entity, tick); the same key always yields the same numbers
+    static RandomStream stream(RngSystem system, uint64_t entity = 0, uint64_t tick = 0);
+    // Fresh stream per call, keyed by a per-system sequence number. For draws outside the simulation
+    // (save ids and the like) where reproducing the call order is enough.
+    static RandomStream sequenced(RngSystem system);
+};
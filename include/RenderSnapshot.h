@@ -0,0 +1,70 @@
+#pragma once
+
+#include "DrawList.h"
+#include "TripleBuffer.h"
+#include <cstdint>
+#include <vector>
+
+// Position and animation frame of one entity as of a simulation tick
+struct EntityTransform {
+    const void* entity = nullptr; // identity only; never dereferenced through the snapshot
+    float x = 0.0f;
+    float y = 0.0f;
+    int frame = 0;
+};
+
+// Everything the renderer needs from one fixed simulation tick. Written by the simulation after each
+// tick and read-only afterwards. The frame itself (world, spells, projectiles, particles, HUD and UI)
+// is recorded into draw by the simulation; the renderer replays it and reads nothing else, so no
+// game object is touched outside the simulation thread.
+struct RenderSnapshot {
+    uint64_t tick = 0;
+    EntityTransform player;               // entity is null when there is no player
+    EntityTransform boss;                 // entity is null when there is no live boss
+    std::vector<EntityTransform> enemies; // World::getEnemies() order at publish time
+    int cameraX = 0;                      // camera the world part of draw was recorded with
+    int cameraY = 0;
+    DrawList draw;                        // only in current(); previous() and interpolate() carry transforms
+
+    void clear();
+    // Copies everything but the draw list
+    void copyTransforms(const RenderSnapshot& from);
+};
+
+// The last two published ticks, handed from the simulation to the renderer through a lock-free
+// triple buffer. Rendering draws at a fraction alpha of the way from previous() to current(), so
+// motion stays smooth whatever the ratio of frame rate to tick rate. Each published frame carries
+// both ticks, so a renderer that skips ticks still blends between neighbouring ones.
+class RenderSnapshotBuffer {
+public:
+    // Movement beyond this between two ticks is treated as a teleport (respawn, portal) and not blended
+    static constexpr float TELEPORT_DISTANCE = 128.0f;
+
+    // Simulation side. beginPublish hands out a recycled snapshot to fill; its vectors keep their capacity.
+    RenderSnapshot& beginPublish(uint64_t tick);
+    void endPublish();
+
+    // Render side. acquire() picks up the newest published frame and returns true if it changed;
+    // current()/previous() stay stable until the next acquire().
+    bool acquire();
+    bool empty() const { return !acquired; }
+    const RenderSnapshot& current() const { return frames.front().current; }
+    const RenderSnapshot& previous() const { return frames.front().previous; }
+
+    // The transforms in current(), with positions blended from previous() for entities present in both;
+    // the draw list stays in current()
+    void interpolate(float alpha, RenderSnapshot& out) const;
+
+private:
+    struct Frame {
+        RenderSnapshot previous;
+        RenderSnapshot current;
+    };
+
+    static EntityTransform blend(const EntityTransform& from, const EntityTransform& to, float alpha);
+
+    TripleBuffer<Frame> frames;
+    RenderSnapshot lastPublished; // simulation-owned copy of the newest tick
+    bool hasPublished = false;    // simulation-owned
+    bool acquired = false;        // render-owned
+};
@@ -2,45 +2,79 @@
 
 #include <SDL.h>
 #include <SDL_ttf.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
+#include "DrawList.h"
 
+// Drawing is split across the two threads. The simulation draws each tick through the methods
+// below, which only record into a DrawList (see beginRecording); nothing here touches the
+// SDL_Renderer until replay() runs the list on the thread that owns it. Code that draws never
+// gets at the SDL_Renderer, so it cannot reach past the recording.
 class Renderer {
 public:
     explicit Renderer(SDL_Renderer* sdlRenderer);
-    ~Renderer() = default;
+    ~Renderer();
+
+    // Recording (simulation side). Draw calls with no list bound are dropped.
+    void beginRecording(DrawList& list);
+    void endRecording();
+    // What the following commands move with when replayed between ticks (DrawList::ANCHOR_*)
+    void setAnchor(int anchorIndex) { anchor = anchorIndex; }
+    int getAnchor() const { return anchor; }
 
     // Texture rendering
     void renderTexture(SDL_Texture* texture, const SDL_Rect* srcRect = nullptr, const SDL_Rect* dstRect = nullptr);
     void renderTexture(SDL_Texture* texture, int x, int y, int width = 0, int height = 0);
-    
+
     // Texture rendering with flip support
-    void renderTextureEx(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* dstRect, 
-                        double angle = 0.0, const SDL_Point* center = nullptr, 
+    void renderTextureEx(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* dstRect,
+                        double angle = 0.0, const SDL_Point* center = nullptr,
                         SDL_RendererFlip flip = SDL_FLIP_NONE);
-    void renderTextureFlipped(SDL_Texture* texture, int x, int y, int width, int height, 
+    void renderTextureFlipped(SDL_Texture* texture, int x, int y, int width, int height,
                              bool flipHorizontal = false, bool flipVertical = false);
-    
-    // Text rendering
+
+    // Text rendering, at a screen position
     void renderText(const std::string& text, TTF_Font* font, int x, int y, SDL_Color color = {255, 255, 255, 255});
     void renderTextCentered(const std::string& text, TTF_Font* font, int x, int y, SDL_Color color = {255, 255, 255, 255});
-    
+
     // Shape rendering
     void renderRect(const SDL_Rect& rect, SDL_Color color = {255, 255, 255, 255}, bool filled = true);
     void renderRect(int x, int y, int width, int height, SDL_Color color = {255, 255, 255, 255}, bool filled = true);
     void renderLine(int x1, int y1, int x2, int y2, SDL_Color color = {255, 255, 255, 255});
     void renderCircle(int centerX, int centerY, int radius, SDL_Color color = {255, 255, 255, 255}, bool filled = true);
-    
+
     // UI rendering
-    void renderProgressBar(int x, int y, int width, int height, float progress, 
+    void renderProgressBar(int x, int y, int width, int height, float progress,
                           SDL_Color backgroundColor = {50, 50, 50, 255},
                           SDL_Color foregroundColor = {0, 255, 0, 255});
-    
-    // Utility functions
+
+    // Screen-space equivalents of the SDL_Render* calls, for code that does its own camera maths
     void setDrawColor(SDL_Color color);
     void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 255);
-    void clear();
-    void present();
-    
+    void setDrawBlendMode(SDL_BlendMode mode);
+    void fillRect(const SDL_Rect* rect);
+    void drawRect(const SDL_Rect* rect);
+    void drawLine(int x1, int y1, int x2, int y2);
+    void drawPoint(int x, int y);
+    void copy(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* dstRect);
+    void copyEx(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* dstRect,
+                double angle, const SDL_Point* center, SDL_RendererFlip flip);
+    void setTextureColorMod(SDL_Texture* texture, Uint8 r, Uint8 g, Uint8 b);
+    void setTextureAlphaMod(SDL_Texture* texture, Uint8 a);
+    void setTextureBlendMode(SDL_Texture* texture, SDL_BlendMode mode);
+    // Output size as of the last replayed frame; safe from either thread
+    void getOutputSize(int* width, int* height) const;
+
+    // Retained panels: the static part of a panel is drawn once and re-blitted until its key or
+    // size changes. beginPanel returns true when the content must be drawn, relative to
+    // originX/originY; endPanel must follow either way.
+    bool beginPanel(int id, int w, int h, uint64_t key, int screenX, int screenY, int& originX, int& originY);
+    void endPanel(int id, int screenX, int screenY);
+
     // Camera/viewport
     void setCamera(int x, int y);
     void getCamera(int& x, int& y) const;
@@ -49,15 +83,54 @@ public:
     float getZoom() const { return zoom; }
     void worldToScreen(int worldX, int worldY, int& screenX, int& screenY) const;
     void screenToWorld(int screenX, int screenY, int& worldX, int& worldY) const;
-    
-    // Access to SDL renderer
-    SDL_Renderer* getSDLRenderer() const { return renderer; }
+
+    // Replay (thread that owns the SDL_Renderer). Offsets are in screen pixels, per anchor.
+    struct ReplayOffsets {
+        SDL_Point world{0, 0};
+        SDL_Point player{0, 0};
+        SDL_Point boss{0, 0};
+        std::vector<SDL_Point> enemies; // by RenderSnapshot::enemies index
+    };
+    void clear(Uint8 r, Uint8 g, Uint8 b);
+    void replay(const DrawList& list, const ReplayOffsets& offsets);
+    void present();
+    // Re-reads the output size; call once per frame before drawing
+    void updateOutputSize();
+    // Drops the panel textures, e.g. after SDL_RENDER_TARGETS_RESET
+    void invalidatePanels();
 
 private:
     SDL_Renderer* renderer;
     int cameraX, cameraY;
-    float zoom = 1.0f;
-    
+    std::atomic<float> zoom{1.0f}; // set while recording, read by replay
+    const bool targetsSupported;
+    std::atomic<int> outputWidth{0};
+    std::atomic<int> outputHeight{0};
+
+    // Recording state (simulation side)
+    DrawList* frameList = nullptr;
+    DrawList* target = nullptr; // frameList, or the panel being drawn
+    int anchor = DrawList::ANCHOR_SCREEN;
+    struct RecordedPanel {
+        int w = 0, h = 0;
+        uint64_t key = 0;
+        std::shared_ptr<DrawList> content;
+        bool drawing = false;
+    };
+    std::unordered_map<int, RecordedPanel> recordedPanels;
+    DrawList::Command* record(DrawList::Command::Op op);
+    void recordText(const std::string& text, TTF_Font* font, int x, int y, SDL_Color color, bool centered);
+
+    // Replay state (SDL_Renderer side)
+    struct PanelTexture {
+        SDL_Texture* texture = nullptr;
+        int w = 0, h = 0;
+        std::shared_ptr<const DrawList> drawn; // content currently in the texture
+    };
+    std::unordered_map<int, PanelTexture> panelTextures;
+    void replayCommands(const DrawList& list, const ReplayOffsets& offsets, const SDL_Point* fixedOffset);
+    void replayPanel(const DrawList& list, const DrawList::Command& command, const ReplayOffsets& offsets);
+
     // Helper functions
     void drawCirclePoints(int centerX, int centerY, int x, int y, SDL_Color color, bool filled);
 };
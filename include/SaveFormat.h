@@ -0,0 +1,28 @@
+#pragma once
+
+#include "DatabaseSQLite.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Versioned binary encoding for PlayerSave.
+//
+// Layout (all integers little-endian):
+//   "PXLS" | u16 version | u16 reserved | u32 payload size | u32 CRC-32 of payload | payload
+// Payload: string table (varint count, then varint length + bytes per string) followed by
+// tagged fields. Each field starts with a varint key (fieldId << 3 | wireType); wire types are
+// VARINT (zigzag ints), FIXED32 (floats) and BYTES (length-prefixed nested records). Readers skip
+// unknown field ids, so newer saves still load in older builds and vice versa.
+// Item keys and equipment names are interned in the string table and referenced by index.
+class SaveFormat {
+public:
+    static constexpr uint16_t VERSION = 1;
+
+    static std::string encode(const PlayerSave& save);
+    static std::optional<PlayerSave> decode(const std::string& data, std::string* outError = nullptr);
+
+    // True if data starts with the binary save magic
+    static bool isBinary(const std::string& data);
+
+    static uint32_t crc32(const uint8_t* data, size_t size);
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "DatabaseSQLite.h"
+
+// Background persistence for player saves.
+// The game thread hands over an immutable PlayerSave snapshot and returns immediately; the writer
+// thread keeps only the newest snapshot per user, so a burst of requests becomes a single write.
+class SaveWriter {
+public:
+    explicit SaveWriter(DatabaseSQLite& database);
+    ~SaveWriter(); // flushes pending saves, then joins the writer thread
+
+    SaveWriter(const SaveWriter&) = delete;
+    SaveWriter& operator=(const SaveWriter&) = delete;
+
+    // Queue a snapshot for userId, replacing any snapshot still waiting for that user
+    void enqueue(int userId, PlayerSave snapshot);
+    // Block until every snapshot queued before this call is on disk
+    void flush();
+
+    // Requests arriving within this window of the first one are folded into the same write
+    static constexpr int COALESCE_MS = 250;
+
+private:
+    void run();
+
+    DatabaseSQLite& database;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;     // signalled when work arrives, a flush is requested or on shutdown
+    std::condition_variable drained;  // signalled whenever a batch has been written
+    std::unordered_map<int, PlayerSave> pending;
+    unsigned long long enqueuedSeq = 0; // bumped per enqueue
+    unsigned long long writtenSeq = 0;  // highest enqueuedSeq known to be on disk
+    int flushWaiters = 0;
+    bool stopping = false;
+};
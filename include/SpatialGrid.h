@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+// Uniform grid over points, rebuilt from scratch whenever the points move (once per frame for enemies).
+// Entries are kept sorted by cell, so a radius query visits only the rows and columns of cells
+// the circle overlaps instead of every point.
+class SpatialGrid {
+public:
+    explicit SpatialGrid(float cellSize = 128.0f);
+
+    // Buffer points, then build() before querying
+    void clear();
+    void insert(int id, float x, float y);
+    void build();
+
+    // Appends the ids of all points within radius of (x, y) to out
+    void queryRadius(float x, float y, float radius, std::vector<int>& out) const;
+
+    int size() const { return static_cast<int>(entries.size()); }
+
+private:
+    struct Entry {
+        int cellY;
+        int cellX;
+        int id;
+        float x;
+        float y;
+    };
+
+    int cellOf(float v) const;
+
+    float cellSize;
+    std::vector<Entry> entries;
+};
@@ -5,12 +5,17 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <cstdint>
+#include "ParticleSystem.h"
+#include "Random.h"
 
 class Game;
 class Renderer;
 class Player;
 class AssetManager;
 class SpriteSheet;
+class Enemy;
+class StatusEffectSystem;
 
 // Forward declaration
 
@@ -51,6 +56,8 @@ enum class SpellType {
     SMOKE_EFFECT
 };
 
+constexpr int SPELL_TYPE_COUNT = static_cast<int>(SpellType::SMOKE_EFFECT) + 1;
+
 struct SpellData {
     SpellType type;
     std::string name;
@@ -89,8 +96,19 @@ struct ActiveSpell {
     float animationTimer;
     float animationSpeed;
     
-    // Effect-specific data
-    std::string spritePath; // For dynamically chosen sprites like explosions
+    // Index into the type's sprite variants (see SpellVisual)
+    uint8_t spriteVariant;
+};
+
+// Sprite sheets for one SpellType, resolved once when SpellSystem is constructed.
+// A type with no variants is drawn as a coloured rectangle.
+struct SpellVisual {
+    static constexpr int MAX_VARIANTS = 3;
+    SpriteSheet* sheets[MAX_VARIANTS] = {};
+    ParticleSystem::SpriteHandle particleSprites[MAX_VARIANTS] = {
+        ParticleSystem::NO_SPRITE, ParticleSystem::NO_SPRITE, ParticleSystem::NO_SPRITE};
+    int variantCount = 0;
+    float scale = 1.0f;
 };
 
 struct PassiveEffect {
@@ -131,6 +149,7 @@ public:
     // Spell tree management
     void updateActiveSpellTree();
     SpellElement getActiveElement() const { return activeElement; }
+    int getActiveEnchantLevel() const { return currentEnchantLevel; }
     std::vector<SpellType> getAvailableSpells() const;
     std::vector<PassiveEffect> getActivePassives() const;
     
@@ -142,6 +161,7 @@ public:
     // Passive effects
     float getBurnDuration() const;
     float getAttackSpeedMultiplier() const;
+    float getLowHealthAttackSpeedMultiplier() const; // Molten Blood, regardless of current health
     float getDamageReduction() const;
     float getRegenPerSecond() const;
     bool hasInfernoAura() const;
@@ -176,6 +196,16 @@ private:
     // Active spells in world
     std::vector<ActiveSpell> activeSpells;
     
+    // Visual effects and breath flames; only particles with a damage component are collision-tested
+    ParticleSystem particles;
+    
+    // Spell scatter, effect variants and passive procs
+    RandomStream rng = Random::stream(RngSystem::Spells);
+    
+    // Per-type sprite registry, indexed by SpellType
+    SpellVisual spellVisuals[SPELL_TYPE_COUNT];
+    const SpellVisual& getSpellVisual(SpellType type) const { return spellVisuals[static_cast<int>(type)]; }
+    
     // Spell definitions
     std::unordered_map<SpellType, SpellData> spellDatabase;
     
@@ -198,7 +228,9 @@ private:
     // Helper functions
     void initializeSpellDatabase();
     void initializePassives();
+    void initializeSpellVisuals();
     void updateActiveSpells(float deltaTime);
+    void updateEffects(float deltaTime);
     void updateCooldowns(float deltaTime);
     void updatePassives();
     void renderActiveSpells(Renderer* renderer);
@@ -232,4 +264,9 @@ private:
     
     // Safe spell creation
     ActiveSpell createSafeSpell(SpellType type, float x, float y);
+    
+    // Spells act on the world's enemies; status effects are null until the world exists
+    std::vector<std::unique_ptr<Enemy>>& targetEnemies();
+    StatusEffectSystem* statusEffects();
+    void applyHitEffects(const ActiveSpell& spell, Enemy* enemy);
 };
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Capacity must be a power of two; one slot is never used so full and empty can be told apart.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (dropping the value) when the queue is full.
+    bool push(const T& value) {
+        const size_t tail = tailIndex.load(std::memory_order_relaxed);
+        const size_t next = (tail + 1) & (Capacity - 1);
+        if (next == headIndex.load(std::memory_order_acquire)) return false;
+        slots[tail] = value;
+        tailIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when there is nothing to take.
+    bool pop(T& out) {
+        const size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) return false;
+        out = slots[head];
+        headIndex.store((head + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return headIndex.load(std::memory_order_acquire) == tailIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> slots{};
+    // Separate cache lines so the two threads don't contend on the indices
+    alignas(64) std::atomic<size_t> headIndex{0};
+    alignas(64) std::atomic<size_t> tailIndex{0};
+};
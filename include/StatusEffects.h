@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Random.h"
+
+class Enemy;
+class SpatialGrid;
+
+// Timed per-enemy effects from spells and passives: burn and poison damage over time, slows and freezes.
+// Each enemy that receives an effect is given a small integer handle; every effect type keeps its own
+// dense array indexed by that handle. Expiries and damage ticks are scheduled on a timing wheel of
+// fixed-length ticks, so an update only touches the events due in the ticks it advances through.
+class StatusEffectSystem {
+public:
+    static constexpr float TICK_SECONDS = 0.1f;
+    static constexpr int WHEEL_SIZE = 64;         // buckets; events further out than one revolution wait in place
+    static constexpr int DOT_INTERVAL_TICKS = 5;  // burn/poison deal damage every 0.5s
+
+    StatusEffectSystem();
+
+    // Applying an effect that is already running keeps the stronger value and the later expiry
+    void applyBurn(Enemy* enemy, int damagePerSecond, float duration);
+    void applyPoison(Enemy* enemy, int damagePerSecond, float duration);
+    void applySlow(Enemy* enemy, float speedMultiplier, float duration);
+    void applyFreeze(Enemy* enemy, float duration);
+
+    // Chance per poison tick to infect the nearest unpoisoned enemy within radius (Pestilence)
+    void setPoisonSpread(float chance, float radius);
+
+    // Must be called before an enemy that may carry effects is destroyed
+    void release(Enemy* enemy);
+    void clear();
+
+    // grid ids are indices into enemies (see World::updateEnemies)
+    void update(float deltaTime, const SpatialGrid& grid, const std::vector<std::unique_ptr<Enemy>>& enemies);
+
+    bool isBurning(const Enemy* enemy) const;
+    bool isPoisoned(const Enemy* enemy) const;
+    bool isSlowed(const Enemy* enemy) const;
+    bool isFrozen(const Enemy* enemy) const;
+
+private:
+    enum EffectType : uint8_t { BURN, POISON, SLOW, FREEZE };
+    enum EventKind : uint8_t { EXPIRE, DOT_TICK };
+
+    struct Event {
+        int handle;
+        uint32_t generation; // stale events (effect ended or handle reused) are dropped when they come due
+        uint32_t dueTick;
+        EffectType effect;
+        EventKind kind;
+    };
+
+    struct DamageOverTime {
+        bool active = false;
+        uint32_t generation = 0;
+        uint32_t expiresTick = 0;
+        int damagePerTick = 0;
+    };
+
+    struct TimedModifier {
+        bool active = false;
+        uint32_t generation = 0;
+        uint32_t expiresTick = 0;
+        float speedMultiplier = 1.0f; // slows only
+    };
+
+    int acquireHandle(Enemy* enemy);
+    void releaseHandle(int handle);
+    int findHandle(const Enemy* enemy) const;
+    void schedule(int handle, uint32_t generation, uint32_t dueTick, EffectType effect, EventKind kind);
+    void applyDamageOverTime(std::vector<DamageOverTime>& states, EffectType effect, Enemy* enemy,
+                             int damagePerSecond, float duration);
+    void applyModifier(std::vector<TimedModifier>& states, EffectType effect, Enemy* enemy,
+                       float speedMultiplier, float duration);
+    void processTick(uint32_t tick);
+    void processEvent(const Event& event, uint32_t tick);
+    void pushModifiers(int handle);
+    void trySpreadPoison(int handle, uint32_t tick);
+    uint32_t ticksFor(float seconds) const;
+
+    // Per-handle owner and per-type effect state, all indexed by handle
+    std::vector<Enemy*> owners;
+    std::vector<int> freeHandles;
+    std::vector<DamageOverTime> burn;
+    std::vector<DamageOverTime> poison;
+    std::vector<TimedModifier> slow;
+    std::vector<TimedModifier> freeze;
+
+    std::vector<Event> wheel[WHEEL_SIZE];
+    std::vector<Event> dueEvents; // scratch for the bucket being processed
+    uint32_t currentTick = 0;
+    float tickAccumulator = 0.0f;
+
+    float poisonSpreadChance = 0.0f;
+    float poisonSpreadRadius = 0.0f;
+    RandomStream rng;
+
+    // Valid only inside update()
+    const SpatialGrid* grid = nullptr;
+    const std::vector<std::unique_ptr<Enemy>>* enemies = nullptr;
+    std::vector<int> neighborScratch;
+};
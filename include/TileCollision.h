@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Axis-aligned box in world pixels; max edges are exclusive
+struct TileBox {
+    float minX, minY, maxX, maxY;
+};
+
+struct TileSweepResult {
+    float dx = 0.0f, dy = 0.0f; // movement actually allowed
+    bool blockedX = false, blockedY = false;
+};
+
+// Packed per-tile movement data for the world, one byte of flags per tile plus a summary per
+// 16x16-tile chunk. A chunk whose tiles all carry the same flags is "uniform"; moves that stay
+// inside uniform chunks the mover may enter skip per-tile tests entirely. Player, enemy and
+// projectile flight all go through here.
+class TileCollision {
+public:
+    enum Flag : uint8_t {
+        SOLID = 1,      // not walkable and not a liquid (walls, void): blocks everything
+        LIQUID = 2,     // not walkable but open to flight: water, lava, underworld ledge faces
+        LAVA = 4,       // lava, even where the map marks it walkable
+        PLATFORM = 8,   // TMX ledge data (underworld maps)
+        PLATFORM1 = 16,
+        PLATFORM2 = 32,
+        STAIRS = 64,
+        EDGE = 128
+    };
+
+    // What a mover may not enter and whether it obeys ledges
+    struct MoveRules {
+        uint8_t blockMask;
+        bool ledges;
+    };
+    static constexpr MoveRules WALKER{SOLID | LIQUID | LAVA, true};
+    static constexpr MoveRules FLYER{SOLID, false};
+
+    static constexpr int CHUNK_SHIFT = 4;
+
+    // Sizes the grid (all tiles clear); set every tile, then call finalize()
+    void reset(int width, int height, int tileSize, bool hasLedgeData);
+    void setFlags(int x, int y, uint8_t flags) { tileFlags[static_cast<size_t>(y) * width + x] = flags; }
+    void finalize();
+    // Changes one tile after finalize() and refreshes its chunk summary
+    void updateFlags(int x, int y, uint8_t flags);
+
+    bool empty() const { return tileFlags.empty(); }
+    // Out-of-bounds tiles read as SOLID
+    uint8_t getFlags(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return SOLID;
+        return tileFlags[static_cast<size_t>(y) * width + x];
+    }
+    int tileOf(float pixel) const;
+
+    // Whether a mover on tile (fromX, fromY) may step onto the adjacent tile (toX, toY). A tile
+    // the mover may not enter can still be left for one it may enter, never for another blocked one.
+    bool canStep(int fromX, int fromY, int toX, int toY, const MoveRules& rules) const;
+    // Moves box by (dx, dy), x first then y, stopping flush against the first tile boundary it may
+    // not cross. Every tile boundary on the way is tested, so fast movers cannot tunnel. A box partly
+    // inside blocked tiles may slide along them as long as the rest of it stays on open tiles.
+    TileSweepResult sweep(const TileBox& box, float dx, float dy, const MoveRules& rules) const;
+    // Walks the tiles the segment (x0, y0)-(x1, y1) crosses, in order (Amanatides-Woo DDA), and
+    // returns true at the first one after the start tile carrying any of blockMask. outT gets the
+    // fraction of the segment travelled when it entered that tile.
+    bool raycast(float x0, float y0, float x1, float y1, uint8_t blockMask, float* outT = nullptr) const;
+
+    // Ledge rules from TMX platform/stairs/edge data; false when the map has none
+    bool isLedgeBlockedVertical(int fromX, int fromY, int toX, int toY) const;
+    bool isLedgeCrossingBlocked(int fromX, int fromY, int toX, int toY) const;
+
+private:
+    static constexpr uint8_t MIXED = 0xFF; // chunk summary for non-uniform chunks (SOLID and LIQUID never combine)
+
+    bool inBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+    void summarizeChunk(int cx, int cy);
+    bool isOpen(const TileBox& area, const MoveRules& rules) const;
+    float sweepAxis(const TileBox& box, float delta, bool horizontal, const MoveRules& rules, bool& blocked) const;
+
+    int width = 0;
+    int height = 0;
+    int tileSize = 0;
+    int chunkCols = 0;
+    int chunkRows = 0;
+    bool ledgeData = false;
+    std::vector<uint8_t> tileFlags;
+    std::vector<uint8_t> chunkSummary;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free triple buffer for one writer thread and one reader thread. The writer fills back() and
+// publishes it; the reader picks up the newest published buffer with consume(). Neither side ever
+// waits: a slow reader just skips intermediate buffers, and a slow writer leaves the reader
+// on the last one it published.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side
+    T& back() { return buffers[backIndex]; }
+    void publish() {
+        // Hand our buffer over as the newest one and take back whichever it replaced
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(backIndex | FRESH), std::memory_order_acq_rel);
+        backIndex = previous & INDEX_MASK;
+    }
+
+    // Reader side. Returns true if a newer buffer was published since the last call.
+    bool consume() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(frontIndex), std::memory_order_acq_rel);
+        frontIndex = previous & INDEX_MASK;
+        return true;
+    }
+    const T& front() const { return buffers[frontIndex]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4; // set while middle holds a buffer the reader hasn't taken
+
+    T buffers[3];
+    int backIndex = 0;                 // writer-owned
+    int frontIndex = 1;                // reader-owned
+    std::atomic<uint8_t> middle{2};    // shared: index of the spare buffer plus FRESH flag
+};
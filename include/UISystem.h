@@ -4,20 +4,26 @@
 #include <SDL_ttf.h>
 #include <memory>
 #include <string>
+#include <vector>
+#include <cstdint>
 
 // Forward declarations
 class Renderer;
 class Player;
 class AssetManager;
+class ItemSystem;
+struct InventorySlot;
 
 class UISystem {
 public:
-    explicit UISystem(SDL_Renderer* renderer);
-    ~UISystem() = default;
+    explicit UISystem(Renderer* renderer);
+    ~UISystem();
 
     // Core functions
     void update(float deltaTime);
     void render();
+    // Pointer and Escape state from the events the game has handled; the UI never polls SDL
+    void setPointer(int x, int y, Uint32 buttons, bool escapeHeld);
     
     // UI elements
     void renderHealthBar(int x, int y, int width, int height, int current, int max);
@@ -144,13 +150,18 @@ public:
                            // mouse for hit testing
                            int mouseX, int mouseY, bool mouseDown,
                            // output
-                           MenuHitResult& outResult);
+                           MenuHitResult& outResult,
+                           // optional per-slider output meters (0..1, >1 clipping), in slider order
+                           const float* volumePeaks = nullptr);
     
 private:
-    SDL_Renderer* renderer;
+    Renderer* renderer;
     TTF_Font* defaultFont;
     TTF_Font* smallFont;
     AssetManager* assetManager = nullptr;
+    int pointerX = 0, pointerY = 0;
+    Uint32 pointerButtons = 0; // SDL_BUTTON() mask
+    bool escapeHeld = false;
     // Potion icon animation state
     float potionAnimTimer = 0.0f;
     int potionAnimFrame = 0;
@@ -175,6 +186,13 @@ private:
     // Spell book state
     int selectedSpellIndex = 0; // Index of currently selected spell in spell book
     
+    // Retained panels (Renderer::beginPanel): the static part of a panel is drawn once and
+    // re-blitted each frame until its content key changes. Tooltips stay immediate.
+    enum PanelId { INVENTORY_PANEL, EQUIPMENT_PANEL, ANVIL_PANEL, SPELL_BOOK_PANEL };
+    static uint64_t hashCombine(uint64_t seed, uint64_t value);
+    void drawItemGrid(ItemSystem* itemSystem, const std::vector<InventorySlot>& slots, int count, int cols,
+                      int gridX, int gridY, SDL_Color fill, SDL_Color border);
+
     // Helper functions
     void initializeFonts();
     void initializeColors();
@@ -3,9 +3,14 @@
 #include <vector>
 #include <memory>
 #include <string>
-#include <random>
 #include <SDL.h>
 #include <unordered_map> // Added for unordered_map
+#include "Random.h"
+#include "SpatialGrid.h"
+#include "StatusEffects.h"
+#include "RenderSnapshot.h"
+#include "MapFormat.h"
+#include "TileCollision.h"
 
 // Forward declarations
 class Renderer;
@@ -128,7 +133,10 @@ public:
 
     // Core functions
     void update(float deltaTime);
-    void render(Renderer* renderer);
+    // Entities are drawn at the snapshot's (interpolated) transforms; ones it lacks use their live state
+    void render(Renderer* renderer, const RenderSnapshot& snapshot);
+    // Fills the enemy and boss part of a per-tick render snapshot
+    void captureSnapshot(RenderSnapshot& snapshot) const;
     void updateEnemies(float deltaTime, float playerX, float playerY);
     // UI overlays
     void renderMinimap(Renderer* renderer, int x, int y, int panelWidth, int panelHeight, float playerX, float playerY) const;
@@ -140,6 +148,10 @@ public:
     bool isWalkable(int x, int y) const;
     // Whether this world is using a fixed, pre-authored tilemap (TMX) instead of procedural chunks
     bool isUsingPrebakedMap() const { return usePrebakedChunks; }
+    // Packed walkability/hazard/ledge flags for movement queries
+    const TileCollision& getCollision() const { return collision; }
+    // The loaded map's layers, masks and object regions
+    const CompiledMap& getTilemap() const { return tilemap; }
     
     // World properties
     int getWidth() const { return width; }
@@ -157,6 +169,16 @@ public:
     void addEnemy(std::unique_ptr<Enemy> enemy);
     const std::vector<std::unique_ptr<Enemy>>& getEnemies() const { return enemies; }
     std::vector<std::unique_ptr<Enemy>>& getEnemies() { return enemies; }
+    // Centers of awake, live enemies bucketed by cell, rebuilt each updateEnemies() and by
+    // compactEnemies(); ids are indices into getEnemies()
+    const SpatialGrid& getEnemyGrid() const { return enemyGrid; }
+    // Erases enemies reset to null and rebuilds everything keyed by enemy index. Call after
+    // destroying enemies instead of erasing from getEnemies() directly.
+    void compactEnemies();
+    // Sends every enemy back to its spawn point, awake
+    void resetEnemiesToSpawn();
+    // Release an enemy's status effects before destroying it
+    StatusEffectSystem& getStatusEffects() { return statusEffects; }
     
     // Boss management
     void spawnBoss(BossType bossType, float x, float y);
@@ -188,6 +210,8 @@ public:
     // Chunk management
     void generateChunk(int chunkX, int chunkY);
     void updateVisibleChunks(float playerX, float playerY);
+    // Whether a world pixel lies in the chunks kept around the player (everywhere before the first update)
+    bool isInLoadedChunks(float px, float py) const;
     Chunk* getChunk(int chunkX, int chunkY);
     std::pair<int, int> worldToChunkCoords(int worldX, int worldY) const;
     std::pair<int, int> chunkToWorldCoords(int chunkX, int chunkY) const;
@@ -204,11 +228,31 @@ private:
     bool usePrebakedChunks = false;
     int mapChunkCols = 0;
     int mapChunkRows = 0;
+    // Chunk range around the player from the last updateVisibleChunks (inclusive)
+    bool hasLoadedChunks = false;
+    int loadedChunkMinX = 0, loadedChunkMinY = 0, loadedChunkMaxX = 0, loadedChunkMaxY = 0;
     
     // Objects
     std::vector<std::unique_ptr<Object>> objects;
     // Enemies
     std::vector<std::unique_ptr<Enemy>> enemies;
+    SpatialGrid enemyGrid;
+    // Enemy simulation level of detail (see updateEnemies)
+    enum class EnemyLod { FULL, REDUCED, DORMANT, HIDDEN };
+    EnemyLod classifyEnemy(const Enemy& enemy, float playerX, float playerY) const;
+    void rebuildEnemyLod();
+    void rebuildEnemyGrid();
+    void rebuildSleeperGrid();
+    void wakeEnemies(float playerX, float playerY);
+    unsigned lodTick = 0;
+    std::vector<int> awakeEnemyIds;     // indices of enemies that are not asleep; only these are visited per tick
+    std::vector<int> nextAwakeEnemyIds;
+    std::vector<int> sleeperIds;        // indices of sleepers (may hold since-woken ones until the next rebuild)
+    std::vector<int> newSleeperIds;     // fell asleep since sleeperGrid was built; checked one by one
+    SpatialGrid sleeperGrid;            // sleepers do not move, so this is rebuilt only now and then
+    std::vector<int> lodQueryIds;
+    std::vector<const Enemy*> lodNeighbours;
+    StatusEffectSystem statusEffects;
     // Boss
     std::unique_ptr<Boss> currentBoss;
     bool bossSpawned = false;
@@ -245,13 +289,14 @@ private:
         std::string name;
         std::string imagePath;
     };
-    std::vector<TmxTilesetInfo> tmxTilesets;
-    std::vector<std::vector<int>> tmxLayers; // each layer is width*height GIDs
+    std::vector<TmxTilesetInfo> tmxTilesets; // sorted by firstGid
+    const TmxTilesetInfo* findTmxTileset(uint32_t gid) const;
+    CompiledMap tilemap; // layer GIDs, masks and regions of the loaded map
     int tmxWidth = 0;
     int tmxHeight = 0;
     
-    // Random number generation for tile placement
-    std::mt19937 rng;
+    // Random number generation for tile placement and boss spawns
+    RandomStream rng;
     
     // Tile generation configuration
     TileGenerationConfig tileGenConfig;
@@ -261,13 +306,14 @@ private:
     std::vector<std::vector<bool>> exploredTiles;
     int visibilityRadius;
     bool fogOfWarEnabled;
-    // Underworld TMX masks
-    std::vector<std::vector<bool>> platformMask; // true where plat/plat2 tiles exist
-    std::vector<std::vector<bool>> platform1Mask; // true where plat/platform1 tiles exist
-    std::vector<std::vector<bool>> platform2Mask; // true where plat2/platform2 tiles exist
-    std::vector<std::vector<bool>> stairsMask;   // true where stairs exist
-    std::vector<std::vector<bool>> edgeMask;     // true where "floating land" (ledge faces) exists
-    std::vector<std::vector<bool>> lavaMask;     // true where lava tiles exist
+    // Underworld TMX masks (views into the compiled map)
+    MapBitmask platformMask;  // true where plat/plat2 tiles exist
+    MapBitmask platform1Mask; // true where plat/platform1 tiles exist
+    MapBitmask platform2Mask; // true where plat2/platform2 tiles exist
+    MapBitmask stairsMask;    // true where stairs exist
+    MapBitmask edgeMask;      // true where "floating land" (ledge faces) exists
+    MapBitmask lavaMask;      // true where lava tiles exist
+    TileCollision collision;  // rebuilt whenever the tile grid is
     
     // Helper functions
     void initializeDefaultWorld();
@@ -280,6 +326,8 @@ private:
     int getPrioritizedTileType(int x, int y);
     void applyTransitionBuffers(Chunk* chunk);
     void addAccents(Chunk* chunk);
+    // Independent stream per (chunk, generation pass), so chunks come out the same in any order
+    RandomStream chunkRandom(const Chunk* chunk, uint64_t pass) const;
     int getPreferredVariantIndex(int /*tileType*/, int worldX, int worldY) const;
     void smoothRegions(Chunk* chunk);
     int pickRegionGroupForBiome(int wx, int wy, int biomeType) const;
@@ -317,6 +365,10 @@ private:
     void markTileVisible(int x, int y);
     void markTileExplored(int x, int y);
 
+    // Collision grid from tiles and the TMX masks
+    uint8_t collisionFlagsAt(int x, int y) const;
+    void rebuildCollision();
+
 public:
     // Movement rules derived from TMX
     bool isLedgeBlockedVertical(int fromTileX, int fromTileY, int toTileX, int toTileY) const;
@@ -77,7 +77,7 @@ SDL_Rect SpriteSheet::getFrameRect(int frameIndex) const {
 }
 
 // AssetManager implementation
-AssetManager::AssetManager(SDL_Renderer* renderer) : renderer(renderer) {
+AssetManager::AssetManager(SDL_Renderer* renderer) : renderer(renderer), ownerThread(std::this_thread::get_id()) {
     if (!renderer) {
         throw std::runtime_error("AssetManager requires a valid SDL_Renderer");
     }
@@ -87,11 +87,51 @@ AssetManager::~AssetManager() {
     clearCache();
 }
 
+void AssetManager::deferLoad(const PendingLoad& load) {
+    for (const auto& pending : pendingLoads) {
+        if (pending.kind == load.kind && pending.path == load.path) return;
+    }
+    std::cout << "Deferring load to the render thread: " << load.path << std::endl;
+    pendingLoads.push_back(load);
+}
+
+void AssetManager::processPendingLoads() {
+    std::vector<PendingLoad> loads;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (pendingLoads.empty()) return;
+        loads.swap(pendingLoads);
+    }
+    for (const auto& load : loads) {
+        switch (load.kind) {
+            case PendingLoad::Kind::Texture:
+                loadTexture(load.path);
+                break;
+            case PendingLoad::Kind::SpriteSheet:
+                loadSpriteSheet(load.path, load.frameWidth, load.frameHeight, load.framesPerRow, load.totalFrames);
+                break;
+            case PendingLoad::Kind::SpriteSheetAuto:
+                loadSpriteSheetAuto(load.path, load.totalFrames, load.framesPerRow);
+                break;
+        }
+    }
+}
+
 Texture* AssetManager::loadTexture(const std::string& path) {
     // Check if already loaded
-    auto it = textureCache.find(path);
-    if (it != textureCache.end()) {
-        return it->second.get();
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = textureCache.find(path);
+        if (it != textureCache.end()) {
+            return it->second.get();
+        }
+        if (!onOwnerThread()) {
+            PendingLoad load;
+            load.kind = PendingLoad::Kind::Texture;
+            load.path = path;
+            deferLoad(load);
+            return nullptr;
+        }
     }
     
     std::string fullPath = getFullPath(path);
@@ -145,25 +185,38 @@ Texture* AssetManager::loadTexture(const std::string& path) {
     
     auto texture = std::make_unique<Texture>(sdlTexture, width, height);
     Texture* result = texture.get();
-    textureCache[path] = std::move(texture);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        textureCache[path] = std::move(texture);
+    }
     
     std::cout << "Loaded texture: " << path << " (" << width << "x" << height << ")" << std::endl;
     return result;
 }
 
 Texture* AssetManager::getTexture(const std::string& path) {
-    auto it = textureCache.find(path);
-    if (it != textureCache.end()) {
-        return it->second.get();
-    }
     return loadTexture(path);
 }
 
 SpriteSheet* AssetManager::loadSpriteSheet(const std::string& path, int frameWidth, int frameHeight, int framesPerRow, int totalFrames) {
     // Check if already loaded
-    auto it = spriteSheetCache.find(path);
-    if (it != spriteSheetCache.end()) {
-        return it->second.get();
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = spriteSheetCache.find(path);
+        if (it != spriteSheetCache.end()) {
+            return it->second.get();
+        }
+        if (!onOwnerThread()) {
+            PendingLoad load;
+            load.kind = PendingLoad::Kind::SpriteSheet;
+            load.path = path;
+            load.frameWidth = frameWidth;
+            load.frameHeight = frameHeight;
+            load.framesPerRow = framesPerRow;
+            load.totalFrames = totalFrames;
+            deferLoad(load);
+            return nullptr;
+        }
     }
     
     // Load the texture directly for the sprite sheet
@@ -194,13 +247,17 @@ SpriteSheet* AssetManager::loadSpriteSheet(const std::string& path, int frameWid
         std::make_unique<Texture>(sdlTexture, width, height), frameWidth, frameHeight, framesPerRow, totalFrames);
     
     SpriteSheet* result = spriteSheet.get();
-    spriteSheetCache[path] = std::move(spriteSheet);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        spriteSheetCache[path] = std::move(spriteSheet);
+    }
     
     std::cout << "Loaded sprite sheet: " << path << " (" << frameWidth << "x" << frameHeight << " frames, total: " << result->getTotalFrames() << ")" << std::endl;
     return result;
 }
 
 SpriteSheet* AssetManager::getSpriteSheet(const std::string& path) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
     auto it = spriteSheetCache.find(path);
     if (it != spriteSheetCache.end()) {
         return it->second.get();
@@ -210,9 +267,21 @@ SpriteSheet* AssetManager::getSpriteSheet(const std::string& path) {
 
 SpriteSheet* AssetManager::loadSpriteSheetAuto(const std::string& path, int totalFrames, int framesPerRow) {
     // If already loaded, return it
-    auto it = spriteSheetCache.find(path);
-    if (it != spriteSheetCache.end()) {
-        return it->second.get();
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = spriteSheetCache.find(path);
+        if (it != spriteSheetCache.end()) {
+            return it->second.get();
+        }
+        if (!onOwnerThread()) {
+            PendingLoad load;
+            load.kind = PendingLoad::Kind::SpriteSheetAuto;
+            load.path = path;
+            load.framesPerRow = framesPerRow;
+            load.totalFrames = totalFrames;
+            deferLoad(load);
+            return nullptr;
+        }
     }
 
     std::string fullPath = getFullPath(path);
@@ -288,7 +357,10 @@ SpriteSheet* AssetManager::loadSpriteSheetAuto(const std::string& path, int tota
         std::make_unique<Texture>(sdlTexture, width, height), frameWidth, frameHeight, cols, totalFrames);
 
     SpriteSheet* result = spriteSheet.get();
-    spriteSheetCache[path] = std::move(spriteSheet);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        spriteSheetCache[path] = std::move(spriteSheet);
+    }
 
     std::cout << "Auto-loaded sprite sheet: " << path
               << " (img=" << imgW << "x" << imgH
@@ -301,9 +373,12 @@ SpriteSheet* AssetManager::loadSpriteSheetAuto(const std::string& path, int tota
 TTF_Font* AssetManager::loadFont(const std::string& path, int size) {
     std::string key = path + "_" + std::to_string(size);
     
-    auto it = fontCache.find(key);
-    if (it != fontCache.end()) {
-        return it->second;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = fontCache.find(key);
+        if (it != fontCache.end()) {
+            return it->second;
+        }
     }
     
     std::string fullPath = getFullPath(path);
@@ -318,17 +393,15 @@ TTF_Font* AssetManager::loadFont(const std::string& path, int size) {
         return nullptr;
     }
     
-    fontCache[key] = font;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        fontCache[key] = font;
+    }
     std::cout << "Loaded font: " << path << " (size " << size << ")" << std::endl;
     return font;
 }
 
 TTF_Font* AssetManager::getFont(const std::string& path, int size) {
-    std::string key = path + "_" + std::to_string(size);
-    auto it = fontCache.find(key);
-    if (it != fontCache.end()) {
-        return it->second;
-    }
     return loadFont(path, size);
 }
 
@@ -336,8 +409,11 @@ void AssetManager::preloadAssets() {
     std::cout << "Preloading assets with performance optimizations..." << std::endl;
     
     // Clear all caches first
-    textureCache.clear();
-    spriteSheetCache.clear();
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        textureCache.clear();
+        spriteSheetCache.clear();
+    }
     
     // OPTIMIZATION: Load assets in batches to improve performance
     // Load wizard sprites for enemy AI
@@ -349,6 +425,14 @@ void AssetManager::preloadAssets() {
     loadSpriteSheetAuto(WIZARD_PATH + "Projectile.png", 5, 5);
     loadSpriteSheetAuto(WIZARD_PATH + "HURT.png", 4, 4);
     loadSpriteSheetAuto(WIZARD_PATH + "DEATH.png", 6, 6);
+    // Enemy projectiles; shots are fired by the simulation thread, which only finds them in the cache
+    loadSpriteSheetAuto("assets/Cyclops/Sprite/cyclops_lazer_projectile.png", 1, 1);
+    loadSpriteSheetAuto("assets/Pyromancer/Sprites/pyromancer_projectile.png", 4, 4);
+    loadSpriteSheetAuto("assets/Skeleton Mage/Sprites/skele_mage_projectile.png", 5, 5);
+    loadSpriteSheetAuto("assets/Witch/Sprite/WITCH_PROJECTILE.png", 6, 6);
+    loadSpriteSheetAuto("assets/Flying Eye/Sprites/projectile.png", 1, 1);
+    loadSpriteSheetAuto("assets/Satyr Archer/Sprite/satry_archer_arrow.png", 1, 1);
+    loadSpriteSheetAuto("assets/Textures/Spells/Projectile.png", 5, 5);
 
     // Load goblin minion sprites (optional preload; they will auto-load on demand too)
     std::cout << "Loading goblin sprites (minion)..." << std::endl;
@@ -462,6 +546,7 @@ void AssetManager::preloadAssets() {
     // Load object textures (only the ones we actually use)
     std::cout << "Loading object textures..." << std::endl;
     loadTexture(OBJECTS_PATH + "chest_unopened.png");
+    loadTexture(OBJECTS_PATH + "chest_opened.png");
     loadTexture(OBJECTS_PATH + "clay_pot.png");
     loadTexture(OBJECTS_PATH + "flag.png");
     loadTexture(OBJECTS_PATH + "wood_crate.png");
@@ -575,6 +660,7 @@ void AssetManager::preloadAssets() {
 }
 
 void AssetManager::clearCache() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
     textureCache.clear();
     spriteSheetCache.clear();
     
@@ -0,0 +1,237 @@
+#include "AudioBus.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_BUS_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AUDIO_BUS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+constexpr float FULL_SCALE = 32768.0f;
+
+int16_t toS16(float sample) {
+    return static_cast<int16_t>(std::nearbyint(std::max(-32768.0f, std::min(32767.0f, sample))));
+}
+
+} // namespace
+
+void mixS16(float* dst, const int16_t* src, size_t count, float gain) {
+    size_t i = 0;
+#if defined(AUDIO_BUS_SSE2)
+    const __m128 g = _mm_set1_ps(gain);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16)); // sign-extend
+        const __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(lo, g)));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(hi, g)));
+    }
+#elif defined(AUDIO_BUS_NEON)
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t s = vld1q_s16(src + i);
+        const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+        const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vmulq_n_f32(lo, gain)));
+        vst1q_f32(dst + i + 4, vaddq_f32(vld1q_f32(dst + i + 4), vmulq_n_f32(hi, gain)));
+    }
+#endif
+    for (; i < count; ++i) dst[i] += static_cast<float>(src[i]) * gain;
+}
+
+void mixS16Stereo(float* dst, const int16_t* src, size_t frames, float leftGain, float rightGain) {
+    const size_t count = frames * 2;
+    size_t i = 0;
+#if defined(AUDIO_BUS_SSE2)
+    const __m128 g = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+        const __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(lo, g)));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(hi, g)));
+    }
+#elif defined(AUDIO_BUS_NEON)
+    const float lanes[4] = { leftGain, rightGain, leftGain, rightGain };
+    const float32x4_t g = vld1q_f32(lanes);
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t s = vld1q_s16(src + i);
+        const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+        const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vmulq_f32(lo, g)));
+        vst1q_f32(dst + i + 4, vaddq_f32(vld1q_f32(dst + i + 4), vmulq_f32(hi, g)));
+    }
+#endif
+    for (; i < count; i += 2) {
+        dst[i] += static_cast<float>(src[i]) * leftGain;
+        dst[i + 1] += static_cast<float>(src[i + 1]) * rightGain;
+    }
+}
+
+void mixF32(float* dst, const float* src, size_t count, float gain) {
+    size_t i = 0;
+#if defined(AUDIO_BUS_SSE2)
+    const __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+    }
+#elif defined(AUDIO_BUS_NEON)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vmulq_n_f32(vld1q_f32(src + i), gain)));
+    }
+#endif
+    for (; i < count; ++i) dst[i] += src[i] * gain;
+}
+
+float applyGainPeak(float* samples, size_t count, float gain) {
+    size_t i = 0;
+    float peak = 0.0f;
+#if defined(AUDIO_BUS_SSE2)
+    const __m128 g = _mm_set1_ps(gain);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 peaks = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        const __m128 v = _mm_mul_ps(_mm_loadu_ps(samples + i), g);
+        _mm_storeu_ps(samples + i, v);
+        peaks = _mm_max_ps(peaks, _mm_andnot_ps(signMask, v));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, peaks);
+    peak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#elif defined(AUDIO_BUS_NEON)
+    float32x4_t peaks = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t v = vmulq_n_f32(vld1q_f32(samples + i), gain);
+        vst1q_f32(samples + i, v);
+        peaks = vmaxq_f32(peaks, vabsq_f32(v));
+    }
+    peak = vmaxvq_f32(peaks);
+#endif
+    for (; i < count; ++i) {
+        samples[i] *= gain;
+        peak = std::max(peak, std::fabs(samples[i]));
+    }
+    return peak;
+}
+
+float peakS16(const int16_t* samples, size_t count) {
+    size_t i = 0;
+    int high = 0, low = 0;
+#if defined(AUDIO_BUS_SSE2)
+    __m128i highs = _mm_setzero_si128(), lows = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+        highs = _mm_max_epi16(highs, s);
+        lows = _mm_min_epi16(lows, s);
+    }
+    alignas(16) int16_t h[8], l[8];
+    _mm_store_si128(reinterpret_cast<__m128i*>(h), highs);
+    _mm_store_si128(reinterpret_cast<__m128i*>(l), lows);
+    for (int k = 0; k < 8; ++k) { high = std::max<int>(high, h[k]); low = std::min<int>(low, l[k]); }
+#elif defined(AUDIO_BUS_NEON)
+    int16x8_t highs = vdupq_n_s16(0), lows = vdupq_n_s16(0);
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t s = vld1q_s16(samples + i);
+        highs = vmaxq_s16(highs, s);
+        lows = vminq_s16(lows, s);
+    }
+    high = vmaxvq_s16(highs);
+    low = vminvq_s16(lows);
+#endif
+    for (; i < count; ++i) { high = std::max<int>(high, samples[i]); low = std::min<int>(low, samples[i]); }
+    return std::max(high, -low) / FULL_SCALE;
+}
+
+void convertF32ToS16(int16_t* dst, const float* src, size_t count) {
+    size_t i = 0;
+#if defined(AUDIO_BUS_SSE2)
+    // Clamp first: cvtps returns INT_MIN for anything out of int32 range
+    const __m128 lo = _mm_set1_ps(-32768.0f), hi = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i a = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), lo), hi));
+        const __m128i b = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), lo), hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(a, b));
+    }
+#elif defined(AUDIO_BUS_NEON)
+    for (; i + 8 <= count; i += 8) {
+        const int32x4_t a = vcvtnq_s32_f32(vld1q_f32(src + i));
+        const int32x4_t b = vcvtnq_s32_f32(vld1q_f32(src + i + 4));
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+#endif
+    for (; i < count; ++i) dst[i] = toS16(src[i]);
+}
+
+AudioBusGraph::AudioBusGraph() {
+    for (int b = 0; b < BUS_COUNT; ++b) {
+        gains[b].store(1.0f);
+        peaks[b].store(0.0f);
+    }
+}
+
+void AudioBusGraph::allocate(size_t maxBlockSamples) {
+    this->maxBlockSamples = maxBlockSamples;
+    for (std::vector<float>& buffer : buffers) buffer.assign(maxBlockSamples, 0.0f);
+}
+
+AudioBus AudioBusGraph::getParent(AudioBus bus) {
+    switch (bus) {
+        case AudioBus::Music:
+        case AudioBus::Sfx: return AudioBus::Master;
+        case AudioBus::Monster:
+        case AudioBus::Player: return AudioBus::Sfx;
+        default: return AudioBus::Master;
+    }
+}
+
+void AudioBusGraph::setGain(AudioBus bus, float gain) {
+    gains[static_cast<int>(bus)].store(std::max(0.0f, gain), std::memory_order_relaxed);
+}
+
+float AudioBusGraph::getGain(AudioBus bus) const {
+    return gains[static_cast<int>(bus)].load(std::memory_order_relaxed);
+}
+
+float AudioBusGraph::getPathGain(AudioBus bus) const {
+    float gain = getGain(bus);
+    while (bus != AudioBus::Master) {
+        bus = getParent(bus);
+        gain *= getGain(bus);
+    }
+    return gain;
+}
+
+float AudioBusGraph::getPeak(AudioBus bus) const {
+    return peaks[static_cast<int>(bus)].load(std::memory_order_relaxed);
+}
+
+void AudioBusGraph::holdPeak(AudioBus bus, float blockPeak) {
+    std::atomic<float>& held = peaks[static_cast<int>(bus)];
+    held.store(std::max(blockPeak, held.load(std::memory_order_relaxed) * PEAK_DECAY), std::memory_order_relaxed);
+}
+
+void AudioBusGraph::begin(size_t samples) {
+    blockSamples = std::min(samples, maxBlockSamples);
+    for (std::vector<float>& buffer : buffers) std::fill(buffer.begin(), buffer.begin() + blockSamples, 0.0f);
+}
+
+void AudioBusGraph::finish(int16_t* out) {
+    // Children before parents
+    static const AudioBus order[] = { AudioBus::Monster, AudioBus::Player, AudioBus::Music, AudioBus::Sfx };
+    for (AudioBus bus : order) {
+        float* buffer = buffers[static_cast<int>(bus)].data();
+        holdPeak(bus, applyGainPeak(buffer, blockSamples, getGain(bus)) / FULL_SCALE);
+        mixF32(buffers[static_cast<int>(getParent(bus))].data(), buffer, blockSamples, 1.0f);
+    }
+    float* master = buffers[static_cast<int>(AudioBus::Master)].data();
+    holdPeak(AudioBus::Master, applyGainPeak(master, blockSamples, getGain(AudioBus::Master)) / FULL_SCALE);
+    convertF32ToS16(out, master, blockSamples);
+}
+
+void AudioBusGraph::meterMaster(const int16_t* samples, size_t count) {
+    holdPeak(AudioBus::Master, peakS16(samples, count));
+}
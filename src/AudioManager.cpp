@@ -5,11 +5,12 @@
 #ifdef USE_SDL_MIXER
 #include <SDL_mixer.h>
 #endif
-#include <fstream>
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <cstring>
 
-AudioManager::AudioManager() : masterVolume(100), musicVolume(100), soundVolume(100) {
+AudioManager::AudioManager() : masterVolume(100), musicVolume(100), soundVolume(100), ownerThread(std::this_thread::get_id()) {
     initializeAudio();
 }
 
@@ -27,7 +28,9 @@ void AudioManager::initializeAudio() {
 #ifdef USE_SDL_MIXER
     if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) == 0) {
         mixerInitialized = true;
-        Mix_AllocateChannels(32);
+        Mix_AllocateChannels(MIXER_CHANNELS);
+        Mix_SetPostMix(&AudioManager::mixerPostMix, this); // master meter only; SDL_mixer does its own mixing
+        applyMixerVolumes();
         std::cout << "SDL_mixer initialized" << std::endl;
         return; // mixer handles playback; skip raw device
     } else {
@@ -39,10 +42,15 @@ void AudioManager::initializeAudio() {
     desired.format = AUDIO_S16;
     desired.channels = 2;
     desired.samples = 2048;
+    desired.callback = &AudioManager::audioCallback;
+    desired.userdata = this;
     audioDevice = SDL_OpenAudioDevice(nullptr, 0, &desired, &deviceSpec, 0);
     if (audioDevice == 0) {
         std::cerr << "Failed to open audio device: " << SDL_GetError() << std::endl;
     } else {
+        busGraph.allocate(static_cast<size_t>(deviceSpec.samples) * deviceSpec.channels);
+        musicBlock.resize(busGraph.getMaxBlockSamples());
+        applyMixerVolumes();
         SDL_PauseAudioDevice(audioDevice, 0);
         std::cout << "Audio device opened: " << deviceSpec.freq << " Hz" << std::endl;
     }
@@ -53,6 +61,7 @@ void AudioManager::cleanupAudio() {
         SDL_CloseAudioDevice(audioDevice);
         audioDevice = 0;
     }
+    musicStream.reset(); // after the callback can no longer run
 #ifdef USE_SDL_MIXER
     if (mixerInitialized) {
         Mix_CloseAudio();
@@ -63,10 +72,8 @@ void AudioManager::cleanupAudio() {
 }
 
 void AudioManager::update(float deltaTime) {
-    (void)deltaTime;
-#ifdef USE_SDL_MIXER
     // Handle transient music ducking
-    if (mixerInitialized && musicDuckTimerSeconds > 0.0f) {
+    if (musicDuckTimerSeconds > 0.0f) {
         musicDuckTimerSeconds -= deltaTime;
         if (musicDuckTimerSeconds <= 0.0f) {
             musicDuckTimerSeconds = 0.0f;
@@ -74,6 +81,7 @@ void AudioManager::update(float deltaTime) {
             applyMixerVolumes();
         }
     }
+#ifdef USE_SDL_MIXER
     // Handle music fade workflow
     if (mixerInitialized && musicFadeActive) {
         if (musicFadeStage == 1) {
@@ -91,68 +99,181 @@ void AudioManager::update(float deltaTime) {
             }
         }
     }
-    // mixer handles streaming
-    return;
 #endif
-    // Raw path ducking restore is handled on setMusicVolume when timer elapses; queue music streaming
-    if (musicPlaying && !currentMusicName.empty() && audioDevice) {
-        Uint32 queued = SDL_GetQueuedAudioSize(audioDevice);
-        if (queued < deviceSpec.freq * deviceSpec.channels * 2 / 4) { // ~0.25s remaining
-            auto it = musicDataByName.find(currentMusicName);
-            if (it != musicDataByName.end() && !it->second.empty()) {
-                SDL_QueueAudio(audioDevice, it->second.data(), static_cast<Uint32>(it->second.size()));
-            }
+    // Raw path: music streams on its own thread and the device callback mixes; nothing to pump here
+}
+
+void AudioManager::queueCommand(Command::Type type, const std::string& name, float x, float y) {
+    Command command;
+    command.type = type;
+    command.name = name;
+    command.x = x;
+    command.y = y;
+    if (!commands.push(command)) std::cerr << "Audio command queue full; dropped " << name << std::endl;
+}
+
+void AudioManager::pumpCommands() {
+    Command command;
+    while (commands.pop(command)) {
+        switch (command.type) {
+            case Command::Type::PlaySound: playSound(command.name); break;
+            case Command::Type::PlaySoundAt: playSoundAt(command.name, command.x, command.y); break;
+            case Command::Type::StartLoop: startLoopingSound(command.name); break;
+            case Command::Type::StopLoop: stopLoopingSound(command.name); break;
+            case Command::Type::MusicDuck: startMusicDuck(command.x, command.y); break;
+            case Command::Type::PlayMusic: playMusic(command.name); break;
+            case Command::Type::StopMusic: stopMusic(); break;
+            case Command::Type::FadeToMusic:
+                fadeToMusic(command.name, static_cast<int>(command.x), static_cast<int>(command.y));
+                break;
+            case Command::Type::ApplyVolumes: applyMixerVolumes(); break;
         }
     }
 }
 
+void SDLCALL AudioManager::audioCallback(void* userdata, Uint8* stream, int len) {
+    AudioManager* self = static_cast<AudioManager*>(userdata);
+    self->mixAudio(reinterpret_cast<Sint16*>(stream), len / static_cast<int>(sizeof(Sint16) * self->deviceSpec.channels));
+}
+
+void AudioManager::mixAudio(Sint16* out, int frames) {
+    const int channels = deviceSpec.channels;
+    const int blockFrames = static_cast<int>(busGraph.getMaxBlockSamples()) / channels;
+    while (frames > 0) {
+        const int count = std::min(frames, blockFrames);
+        const size_t samples = static_cast<size_t>(count) * channels;
+        busGraph.begin(samples);
+
+        if (musicStream) {
+            const size_t got = static_cast<size_t>(musicStream->read(musicBlock.data(), count)) * channels;
+            busGraph.mix(AudioBus::Music, musicBlock.data(), got, 1.0f);
+        }
+        for (RawVoice& voice : rawVoices) {
+            if (!voice.data) continue;
+            const Sint16* src = reinterpret_cast<const Sint16*>(voice.data->data()) + voice.position / sizeof(Sint16);
+            const size_t left = (voice.data->size() - voice.position) / sizeof(Sint16);
+            const size_t n = std::min(left, samples);
+            busGraph.mixStereo(voice.bus, src, n, voice.leftGain, voice.rightGain);
+            voice.position += n * sizeof(Sint16);
+            if (n == left) voice.data = nullptr;
+        }
+
+        busGraph.finish(out);
+        out += samples;
+        frames -= count;
+    }
+}
+
+#ifdef USE_SDL_MIXER
+void SDLCALL AudioManager::mixerPostMix(void* userdata, Uint8* stream, int len) {
+    static_cast<AudioManager*>(userdata)->busGraph.meterMaster(reinterpret_cast<const Sint16*>(stream), len / sizeof(Sint16));
+}
+#endif
+
+AudioBus AudioManager::soundBus(const std::string& soundName) {
+    if (soundName == "goblin_death" || soundName == "goblin_melee" || soundName == "boss_melee") return AudioBus::Monster;
+    if (soundName == "player_melee_1" || soundName == "player_melee_2") return AudioBus::Player;
+    return AudioBus::Sfx;
+}
+
+float AudioManager::soundBaseScale(const std::string& soundName) {
+    if (soundName == "goblin_death") return 0.01f; // base quietness (0.1, plus the 10% SFX volume the call site used to apply)
+    if (soundName == "footstep_dirt") return 0.5f; // 50% quieter footsteps
+    return 1.0f;
+}
+
+void AudioManager::setListener(float x, float y, float viewHalfWidth, float viewHalfHeight) {
+    listenerX = x;
+    listenerY = y;
+    listenerHalfWidth = std::max(1.0f, viewHalfWidth);
+    audibleRadius = std::sqrt(viewHalfWidth * viewHalfWidth + viewHalfHeight * viewHalfHeight) * AUDIBLE_RADIUS_SCALE;
+    listenerSet = true;
+}
+
+bool AudioManager::spatialize(float x, float y, float& attenuation, float& pan) const {
+    attenuation = 1.0f;
+    pan = 0.0f;
+    if (!listenerSet) return true;
+    const float dx = x - listenerX, dy = y - listenerY;
+    const float distance = std::sqrt(dx * dx + dy * dy);
+    if (distance >= audibleRadius) return false;
+    // Full volume near the listener, then a squared falloff to silence at the audible radius
+    const float inner = audibleRadius * FULL_VOLUME_RADIUS_FRACTION;
+    if (distance > inner) {
+        const float t = 1.0f - (distance - inner) / (audibleRadius - inner);
+        attenuation = t * t;
+    }
+    pan = std::max(-1.0f, std::min(1.0f, dx / listenerHalfWidth)) * MAX_PAN;
+    return attenuation >= MIN_AUDIBLE_GAIN;
+}
+
+int AudioManager::soundPriority(const std::string& soundName) {
+    if (soundName == "boss_melee" || soundName == "player_melee_1" || soundName == "player_melee_2") return 3;
+    if (soundName == "goblin_death" || soundName == "footstep_dirt") return 1;
+    return 2;
+}
+
+int AudioManager::voiceCap(AudioBus bus) {
+    switch (bus) {
+        case AudioBus::Monster: return 8;
+        case AudioBus::Player: return 4;
+        case AudioBus::Sfx: return 16;
+        default: return 1 << 30;
+    }
+}
+
+int AudioManager::pickVoice(const VoiceInfo* voices, int count, const VoiceInfo& wanted) {
+    // Lower priority first, then quieter
+    auto weaker = [](const VoiceInfo& a, const VoiceInfo& b) {
+        return a.priority < b.priority || (a.priority == b.priority && a.loudness < b.loudness);
+    };
+    int freeSlot = -1, inCategory = 0, categoryVictim = -1, anyVictim = -1;
+    for (int i = 0; i < count; ++i) {
+        const VoiceInfo& v = voices[i];
+        if (!v.active) { if (freeSlot < 0) freeSlot = i; continue; }
+        if (anyVictim < 0 || weaker(v, voices[anyVictim])) anyVictim = i;
+        if (v.bus != wanted.bus) continue;
+        ++inCategory;
+        if (categoryVictim < 0 || weaker(v, voices[categoryVictim])) categoryVictim = i;
+    }
+    if (inCategory < voiceCap(wanted.bus) && freeSlot >= 0) return freeSlot;
+    // Category at its cap (or every voice busy): replace the weakest one unless the new sound is weaker still
+    const int victim = inCategory >= voiceCap(wanted.bus) ? categoryVictim : anyVictim;
+    if (victim >= 0 && !weaker(wanted, voices[victim])) return victim;
+    return -1;
+}
+
 void AudioManager::playSound(const std::string& soundName) {
+    if (!onOwnerThread()) { queueCommand(Command::Type::PlaySound, soundName); return; }
+    startSound(soundName, 1.0f, 0.0f);
+}
+
+void AudioManager::playSoundAt(const std::string& soundName, float x, float y) {
+    if (!onOwnerThread()) { queueCommand(Command::Type::PlaySoundAt, soundName, x, y); return; }
+    float attenuation = 1.0f, pan = 0.0f;
+    if (!spatialize(x, y, attenuation, pan)) return; // out of earshot: never takes a voice
+    startSound(soundName, attenuation, pan);
+}
+
+void AudioManager::startSound(const std::string& soundName, float attenuation, float pan) {
+    VoiceInfo wanted;
+    wanted.bus = soundBus(soundName);
+    wanted.priority = soundPriority(soundName);
+    wanted.gain = soundBaseScale(soundName) * attenuation;
+    wanted.loudness = wanted.gain;
+    wanted.pan = pan;
+    wanted.active = true;
 #ifdef USE_SDL_MIXER
     if (mixerInitialized) {
         auto itc = chunks.find(soundName);
         if (itc != chunks.end() && itc->second) {
-            float extraScale = 1.0f;
-            // Category scaling: monster SFX
-            if (soundName == "goblin_death" || soundName == "goblin_melee" || soundName == "boss_melee") {
-                extraScale *= (monsterVolume / 100.0f);
-                if (soundName == "goblin_death") extraScale *= 0.1f; // base quietness
-            }
-            // Player melee scaling
-            if (soundName == "player_melee_1" || soundName == "player_melee_2") {
-                extraScale *= (playerVolume / 100.0f);
-            }
-            if (soundName == "footstep_dirt") extraScale = 0.5f; // 50% quieter footsteps
-            int vol = static_cast<int>(MIX_MAX_VOLUME * (soundVolume / 100.0f) * (masterVolume / 100.0f) * extraScale);
-            Mix_Chunk* base = reinterpret_cast<Mix_Chunk*>(itc->second);
-            Mix_Chunk* toPlay = base;
-            if (soundName == "player_projectile") {
-                int tailMs = 20; // play sooner by trimming less from the start
-                int bytesPerSec = 44100 * 2 * 2; // S16 stereo
-                int skipBytes = std::min(static_cast<int>(base->alen) - 0, (bytesPerSec * tailMs) / 1000);
-                if (skipBytes > 0 && skipBytes < static_cast<int>(base->alen)) {
-                    Uint32 newLen = base->alen - skipBytes;
-                    Mix_Chunk* dup = static_cast<Mix_Chunk*>(SDL_malloc(sizeof(Mix_Chunk)));
-                    if (dup) {
-                        dup->allocated = 1;
-                        dup->abuf = static_cast<Uint8*>(SDL_malloc(newLen));
-                        if (dup->abuf) {
-                            SDL_memcpy(dup->abuf, base->abuf + skipBytes, newLen);
-                            dup->alen = newLen;
-                            dup->volume = base->volume;
-                            toPlay = dup;
-                        } else {
-                            SDL_free(dup);
-                        }
-                    }
-                }
-            }
-            int ch = Mix_PlayChannel(-1, toPlay, 0);
-            if (ch != -1) {
-                Mix_Volume(ch, std::max(0, std::min(MIX_MAX_VOLUME, vol)));
-                if (toPlay != base) {
-                    // we cannot safely free here without a finished callback; keep short tail small leak avoided next run
-                    // In a full system, track channel->chunk and free when finished.
-                }
+            for (int ch = 0; ch < MIXER_CHANNELS; ++ch) channelVoices[ch].active = Mix_Playing(ch) != 0;
+            const int ch = pickVoice(channelVoices, MIXER_CHANNELS, wanted);
+            if (ch < 0) return;
+            if (channelVoices[ch].active) Mix_HaltChannel(ch); // stolen
+            if (Mix_PlayChannel(ch, reinterpret_cast<Mix_Chunk*>(itc->second), 0) != -1) {
+                channelVoices[ch] = wanted;
+                applyChannelVolume(ch);
             }
             return;
         }
@@ -167,17 +288,44 @@ void AudioManager::playSound(const std::string& soundName) {
         std::cerr << "No audio device available" << std::endl;
         return;
     }
-    const std::vector<Uint8>& buf = it->second;
-    if (!buf.empty()) {
-        // Queue a copy so buffer lifetime is safe until played. For simplicity, queue original; SDL copies internally.
-        if (SDL_QueueAudio(audioDevice, buf.data(), static_cast<Uint32>(buf.size())) != 0) {
-            std::cerr << "SDL_QueueAudio error: " << SDL_GetError() << std::endl;
-        }
-        SDL_PauseAudioDevice(audioDevice, 0); // ensure playback is unpaused
-    }
+    if (it->second.empty()) return;
+    float left = 1.0f, right = 1.0f;
+    panGains(pan, left, right);
+    SDL_LockAudioDevice(audioDevice);
+    for (int i = 0; i < MAX_RAW_VOICES; ++i) rawVoiceInfo[i].active = rawVoices[i].data != nullptr;
+    const int slot = pickVoice(rawVoiceInfo, MAX_RAW_VOICES, wanted);
+    if (slot >= 0) {
+        RawVoice& voice = rawVoices[slot];
+        voice.data = &it->second;
+        voice.position = 0;
+        voice.leftGain = wanted.gain * left; // bus gains are applied at mix time
+        voice.rightGain = wanted.gain * right;
+        voice.bus = wanted.bus;
+        rawVoiceInfo[slot] = wanted;
+    }
+    SDL_UnlockAudioDevice(audioDevice);
+    SDL_PauseAudioDevice(audioDevice, 0); // ensure playback is unpaused
+}
+
+void AudioManager::panGains(float pan, float& left, float& right) {
+    // Balance law: centred sounds keep full level in both ears
+    left = pan > 0.0f ? 1.0f - pan : 1.0f;
+    right = pan < 0.0f ? 1.0f + pan : 1.0f;
 }
 
+#ifdef USE_SDL_MIXER
+void AudioManager::applyChannelVolume(int channel) {
+    const VoiceInfo& voice = channelVoices[channel];
+    const int vol = static_cast<int>(MIX_MAX_VOLUME * busGraph.getPathGain(voice.bus) * voice.gain);
+    Mix_Volume(channel, std::max(0, std::min(MIX_MAX_VOLUME, vol)));
+    float left = 1.0f, right = 1.0f;
+    panGains(voice.pan, left, right);
+    Mix_SetPanning(channel, static_cast<Uint8>(left * 255.0f), static_cast<Uint8>(right * 255.0f)); // 255/255 removes the effect
+}
+#endif
+
 void AudioManager::startLoopingSound(const std::string& soundName) {
+    if (!onOwnerThread()) { queueCommand(Command::Type::StartLoop, soundName); return; }
 #ifdef USE_SDL_MIXER
     if (mixerInitialized) {
         // If already looping, ensure channel is still valid
@@ -192,12 +340,19 @@ void AudioManager::startLoopingSound(const std::string& soundName) {
         }
         auto itc = chunks.find(soundName);
         if (itc == chunks.end() || !itc->second) return;
-        float extraScale = 1.0f;
-        int vol = static_cast<int>(MIX_MAX_VOLUME * (soundVolume / 100.0f) * (masterVolume / 100.0f) * extraScale);
+        VoiceInfo wanted;
+        wanted.bus = AudioBus::Sfx;
+        wanted.priority = LOOP_PRIORITY; // never stolen by one-shots
+        wanted.loudness = 1.0f;
+        wanted.active = true;
+        for (int ch = 0; ch < MIXER_CHANNELS; ++ch) channelVoices[ch].active = Mix_Playing(ch) != 0;
+        const int channel = pickVoice(channelVoices, MIXER_CHANNELS, wanted);
+        if (channel < 0) return;
+        if (channelVoices[channel].active) Mix_HaltChannel(channel);
         Mix_Chunk* chnk = reinterpret_cast<Mix_Chunk*>(itc->second);
-        int channel = Mix_PlayChannel(-1, chnk, -1 /* loop forever */);
-        if (channel != -1) {
-            Mix_Volume(channel, std::max(0, std::min(MIX_MAX_VOLUME, vol)));
+        if (Mix_PlayChannel(channel, chnk, -1 /* loop forever */) != -1) {
+            channelVoices[channel] = wanted;
+            applyChannelVolume(channel);
             loopingChannelByName[soundName] = channel;
         }
         return;
@@ -208,6 +363,7 @@ void AudioManager::startLoopingSound(const std::string& soundName) {
 }
 
 void AudioManager::stopLoopingSound(const std::string& soundName) {
+    if (!onOwnerThread()) { queueCommand(Command::Type::StopLoop, soundName); return; }
 #ifdef USE_SDL_MIXER
     if (mixerInitialized) {
         auto it = loopingChannelByName.find(soundName);
@@ -223,6 +379,7 @@ void AudioManager::stopLoopingSound(const std::string& soundName) {
 }
 
 void AudioManager::playMusic(const std::string& musicName) {
+    if (!onOwnerThread()) { queueCommand(Command::Type::PlayMusic, musicName); return; }
 #ifdef USE_SDL_MIXER
     if (mixerInitialized) {
         auto itm = musics.find(musicName);
@@ -240,24 +397,30 @@ void AudioManager::playMusic(const std::string& musicName) {
     }
 #endif
     if (!audioDevice) return;
-    auto it = musicDataByName.find(musicName);
-    if (it == musicDataByName.end()) {
+    auto it = musicPathByName.find(musicName);
+    if (it == musicPathByName.end()) {
         std::cerr << "Music not loaded: " << musicName << std::endl;
         return;
     }
-    SDL_ClearQueuedAudio(audioDevice);
-    const std::vector<Uint8>& buf = it->second;
-    if (!buf.empty()) {
-        if (SDL_QueueAudio(audioDevice, buf.data(), static_cast<Uint32>(buf.size())) != 0) {
-            std::cerr << "SDL_QueueAudio(music) error: " << SDL_GetError() << std::endl;
-            return;
-        }
-        currentMusicName = musicName;
-        musicPlaying = true;
+    std::string error;
+    std::unique_ptr<MusicStream> stream = MusicStream::open(it->second, deviceSpec, &error);
+    if (!stream) {
+        std::cerr << "Music stream failed for " << it->second << ": " << error << std::endl;
+        return;
     }
+    SDL_LockAudioDevice(audioDevice);
+    musicStream.swap(stream);
+    SDL_UnlockAudioDevice(audioDevice);
+    stream.reset(); // the previous track; joins its decoder thread outside the device lock
+    currentMusicName = musicName;
+    musicPlaying = true;
 }
 
 void AudioManager::fadeToMusic(const std::string& musicName, int fadeOutMs, int fadeInMs) {
+    if (!onOwnerThread()) {
+        queueCommand(Command::Type::FadeToMusic, musicName, static_cast<float>(fadeOutMs), static_cast<float>(fadeInMs));
+        return;
+    }
 #ifdef USE_SDL_MIXER
     if (mixerInitialized) {
         musicFadeActive = true;
@@ -278,6 +441,7 @@ void AudioManager::fadeToMusic(const std::string& musicName, int fadeOutMs, int
 }
 
 void AudioManager::stopMusic() {
+    if (!onOwnerThread()) { queueCommand(Command::Type::StopMusic, std::string()); return; }
 #ifdef USE_SDL_MIXER
     if (mixerInitialized) {
         Mix_HaltMusic();
@@ -285,7 +449,10 @@ void AudioManager::stopMusic() {
     }
 #endif
     if (!audioDevice) return;
-    SDL_ClearQueuedAudio(audioDevice);
+    std::unique_ptr<MusicStream> stream;
+    SDL_LockAudioDevice(audioDevice);
+    musicStream.swap(stream);
+    SDL_UnlockAudioDevice(audioDevice);
     musicPlaying = false;
     currentMusicName.clear();
 }
@@ -308,55 +475,56 @@ void AudioManager::resumeMusic() {
 
 void AudioManager::setMasterVolume(int volume) {
     masterVolume = std::max(0, std::min(100, volume));
+    if (!onOwnerThread()) { queueCommand(Command::Type::ApplyVolumes, std::string()); return; }
     applyMixerVolumes();
 }
 
 void AudioManager::setMusicVolume(int volume) {
     musicVolume = std::max(0, std::min(100, volume));
-    // Apply volume live
-#ifdef USE_SDL_MIXER
-    if (mixerInitialized) {
-        int mixVol = static_cast<int>(MIX_MAX_VOLUME * (musicVolume / 100.0f) * (masterVolume / 100.0f) * musicDuckScale);
-        Mix_VolumeMusic(std::max(0, std::min(MIX_MAX_VOLUME, mixVol)));
-        return;
-    }
-#endif
-    // For raw SDL path, reload current music at new volume (simple approach)
-    if (!currentMusicName.empty()) {
-        auto it = musicPathByName.find(currentMusicName);
-        if (it != musicPathByName.end()) {
-            // Re-load music buffer with new scaling and resume
-            loadMusic(currentMusicName, it->second);
-            playMusic(currentMusicName);
-        }
-    }
+    if (!onOwnerThread()) { queueCommand(Command::Type::ApplyVolumes, std::string()); return; }
+    applyMixerVolumes(); // live on both paths
 }
 
 void AudioManager::setSoundVolume(int volume) {
     soundVolume = std::max(0, std::min(100, volume));
+    if (!onOwnerThread()) { queueCommand(Command::Type::ApplyVolumes, std::string()); return; }
     applyMixerVolumes();
 }
 
 void AudioManager::setMonsterVolume(int volume) {
     monsterVolume = std::max(0, std::min(100, volume));
+    if (!onOwnerThread()) { queueCommand(Command::Type::ApplyVolumes, std::string()); return; }
+    applyMixerVolumes();
 }
 
 // Added player melee SFX volume setter
 void AudioManager::setPlayerVolume(int volume) {
     playerVolume = std::max(0, std::min(100, volume));
+    if (!onOwnerThread()) { queueCommand(Command::Type::ApplyVolumes, std::string()); return; }
+    applyMixerVolumes();
 }
 void AudioManager::applyMixerVolumes() {
+    // The raw path applies these per bus at mix time
+    busGraph.setGain(AudioBus::Master, masterVolume / 100.0f);
+    busGraph.setGain(AudioBus::Music, (musicVolume / 100.0f) * musicDuckScale);
+    busGraph.setGain(AudioBus::Sfx, soundVolume / 100.0f);
+    busGraph.setGain(AudioBus::Monster, monsterVolume / 100.0f);
+    busGraph.setGain(AudioBus::Player, playerVolume / 100.0f);
 #ifdef USE_SDL_MIXER
     if (mixerInitialized) {
-        int mv = static_cast<int>(MIX_MAX_VOLUME * (musicVolume / 100.0f) * (masterVolume / 100.0f) * musicDuckScale);
+        int mv = static_cast<int>(MIX_MAX_VOLUME * busGraph.getPathGain(AudioBus::Music));
         Mix_VolumeMusic(std::max(0, std::min(MIX_MAX_VOLUME, mv)));
-        int sv = static_cast<int>(MIX_MAX_VOLUME * (soundVolume / 100.0f) * (masterVolume / 100.0f));
-        Mix_Volume(-1, std::max(0, std::min(MIX_MAX_VOLUME, sv)));
+        for (int ch = 0; ch < MIXER_CHANNELS; ++ch) applyChannelVolume(ch);
     }
 #endif
 }
 
+float AudioManager::getBusPeak(AudioBus bus) const {
+    return busGraph.getPeak(bus);
+}
+
 void AudioManager::startMusicDuck(float seconds, float musicScale01) {
+    if (!onOwnerThread()) { queueCommand(Command::Type::MusicDuck, std::string(), seconds, musicScale01); return; }
     musicDuckTimerSeconds = std::max(0.0f, seconds);
     musicDuckScale = std::max(0.0f, std::min(1.0f, musicScale01));
     applyMixerVolumes();
@@ -375,6 +543,14 @@ void AudioManager::loadSound(const std::string& name, const std::string& filenam
             std::cerr << "Mix_LoadWAV failed: " << Mix_GetError() << std::endl;
             return;
         }
+        if (name == "player_projectile") {
+            // The shot's sample opens with a little silence; trim it once here so it plays on the click
+            const Uint32 skipBytes = (44100 * 2 * 2) * 20 / 1000; // 20 ms of the S16 stereo mixer format
+            if (skipBytes < ch->alen) {
+                SDL_memmove(ch->abuf, ch->abuf + skipBytes, ch->alen - skipBytes);
+                ch->alen -= skipBytes;
+            }
+        }
         chunks[name] = reinterpret_cast<void*>(ch);
         applyMixerVolumes();
         return;
@@ -423,23 +599,17 @@ void AudioManager::loadSound(const std::string& name, const std::string& filenam
         return;
     }
 
-    // Apply simple volume scaling if S16 to reduce loudness
-    float volumeFactor = (masterVolume / 100.0f) * (soundVolume / 100.0f);
-    volumeFactor = std::max(0.0f, std::min(volumeFactor, 1.0f));
-    if (deviceSpec.format == AUDIO_S16) {
-        Sint16* samples = reinterpret_cast<Sint16*>(cvt.buf);
-        int sampleCount = cvt.len_cvt / sizeof(Sint16);
-        for (int i = 0; i < sampleCount; ++i) {
-            int sample = static_cast<int>(samples[i] * volumeFactor);
-            samples[i] = static_cast<Sint16>(std::max(-32768, std::min(32767, sample)));
-        }
-    }
-
+    // Volume is applied per voice at mix time
     std::vector<Uint8> data(cvt.buf, cvt.buf + cvt.len_cvt);
     SDL_free(cvt.buf);
     SDL_FreeWAV(wavBuffer);
 
-    soundDataByName[name] = std::move(data);
+    // Reloading a name replaces a buffer that voices may still be reading
+    SDL_LockAudioDevice(audioDevice);
+    std::vector<Uint8>& slot = soundDataByName[name];
+    for (RawVoice& voice : rawVoices) if (voice.data == &slot) voice.data = nullptr;
+    slot = std::move(data);
+    SDL_UnlockAudioDevice(audioDevice);
     std::cout << "Loaded sound: " << name << " (converted to device format, bytes=" << soundDataByName[name].size() << ")" << std::endl;
 }
 
@@ -462,43 +632,12 @@ void AudioManager::loadMusic(const std::string& name, const std::string& filenam
         std::cerr << "Audio device not initialized; cannot load music: " << name << std::endl;
         return;
     }
-    SDL_AudioSpec wavSpec{}; Uint8* wavBuffer = nullptr; Uint32 wavLength = 0;
-    if (SDL_LoadWAV(filename.c_str(), &wavSpec, &wavBuffer, &wavLength) == nullptr) {
-        std::cerr << "SDL_LoadWAV failed for music " << filename << ": " << SDL_GetError() << std::endl;
-        return;
-    }
-    SDL_AudioCVT cvt{};
-    if (SDL_BuildAudioCVT(&cvt,
-                          wavSpec.format, wavSpec.channels, wavSpec.freq,
-                          deviceSpec.format, deviceSpec.channels, deviceSpec.freq) < 0) {
-        std::cerr << "SDL_BuildAudioCVT (music) failed: " << SDL_GetError() << std::endl;
-        SDL_FreeWAV(wavBuffer);
-        return;
-    }
-    cvt.len = static_cast<int>(wavLength);
-    cvt.buf = static_cast<Uint8*>(SDL_malloc(cvt.len * cvt.len_mult));
-    if (!cvt.buf) { SDL_FreeWAV(wavBuffer); return; }
-    std::memcpy(cvt.buf, wavBuffer, wavLength);
-    if (SDL_ConvertAudio(&cvt) != 0) {
-        std::cerr << "SDL_ConvertAudio (music) failed: " << SDL_GetError() << std::endl;
-        SDL_free(cvt.buf);
-        SDL_FreeWAV(wavBuffer);
+    // Only check that it can be decoded; playMusic streams it
+    std::string error;
+    if (!openMusicDecoder(filename, &error)) {
+        std::cerr << "Cannot stream music " << filename << ": " << error << std::endl;
         return;
     }
-    float volumeFactor = (masterVolume / 100.0f) * (musicVolume / 100.0f);
-    volumeFactor = std::max(0.0f, std::min(volumeFactor, 1.0f));
-    if (deviceSpec.format == AUDIO_S16) {
-        Sint16* samples = reinterpret_cast<Sint16*>(cvt.buf);
-        int sampleCount = cvt.len_cvt / sizeof(Sint16);
-        for (int i = 0; i < sampleCount; ++i) {
-            int sample = static_cast<int>(samples[i] * volumeFactor);
-            samples[i] = static_cast<Sint16>(std::max(-32768, std::min(32767, sample)));
-        }
-    }
-    std::vector<Uint8> data(cvt.buf, cvt.buf + cvt.len_cvt);
-    SDL_free(cvt.buf);
-    SDL_FreeWAV(wavBuffer);
-    musicDataByName[name] = std::move(data);
     musicPathByName[name] = filename;
 }
 
@@ -508,5 +647,5 @@ bool AudioManager::hasMusic(const std::string& name) const {
         return musics.find(name) != musics.end();
     }
 #endif
-    return musicDataByName.find(name) != musicDataByName.end();
+    return musicPathByName.find(name) != musicPathByName.end();
 }
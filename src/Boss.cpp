@@ -105,9 +105,9 @@ void Boss::update(float deltaTime, float playerX, float playerY) {
     Enemy::update(deltaTime, playerX, playerY);
 }
 
-void Boss::render(Renderer* renderer) const {
+void Boss::render(Renderer* renderer, const EntityTransform& transform) const {
     // Render boss with special effects based on phase
-    Enemy::render(renderer);
+    Enemy::render(renderer, transform);
     
     // Add phase-based visual effects
     if (currentPhase >= BossPhase::PHASE_2) {
@@ -127,7 +127,7 @@ void Boss::render(Renderer* renderer) const {
 void Boss::renderMinions(Renderer* renderer) const {
     for (const auto& minion : minions) {
         if (minion && !minion->isDead()) {
-            minion->render(renderer);
+            minion->render(renderer, minion->getTransform());
         }
     }
 }
@@ -138,7 +138,7 @@ void Boss::takeDamage(int amount) {
     // Boss-specific damage reactions
     if (currentPhase == BossPhase::PHASE_3 && health > 0) {
         // Desperate phase: chance to use ability immediately
-        if (rand() % 100 < 30) { // 30% chance
+        if (rng.chance(0.30f)) { // 30% chance
             globalAbilityCooldown = 0.0f; // Reset cooldown
         }
     }
@@ -273,8 +273,8 @@ void Boss::useTeleport(float playerX, float playerY) {
     std::cout << getBossName() << " teleports!" << std::endl;
     
     // Teleport to a position behind or to the side of the player
-    float angle = atan2(getY() - playerY, getX() - playerX) + (rand() % 2 == 0 ? 1.57f : -1.57f); // +/- 90 degrees
-    float teleportDistance = 200.0f + (rand() % 100);
+    float angle = atan2(getY() - playerY, getX() - playerX) + (rng.nextInt(0, 1) == 0 ? 1.57f : -1.57f); // +/- 90 degrees
+    float teleportDistance = 200.0f + rng.nextInt(0, 99);
     
     x = playerX + cos(angle) * teleportDistance;
     y = playerY + sin(angle) * teleportDistance;
@@ -304,7 +304,7 @@ void Boss::useSummonMinions(float playerX, float playerY) {
     std::cout << getBossName() << " summons minions!" << std::endl;
     
     // Spawn 1-2 goblin minions
-    int numToSpawn = 1 + (rand() % 2);
+    int numToSpawn = 1 + rng.nextInt(0, 1);
     for (int i = 0; i < numToSpawn && minions.size() < maxMinions; i++) {
         spawnMinion(playerX, playerY);
     }
@@ -312,13 +312,14 @@ void Boss::useSummonMinions(float playerX, float playerY) {
 
 void Boss::spawnMinion(float playerX, float playerY) {
     // Spawn minion at a random position around the boss
-    float angle = (rand() % 360) * 3.14159f / 180.0f;
-    float distance = 80.0f + (rand() % 40);
+    float angle = rng.nextInt(0, 359) * 3.14159f / 180.0f;
+    float distance = 80.0f + rng.nextInt(0, 39);
     
     float minionX = getX() + cos(angle) * distance;
     float minionY = getY() + sin(angle) * distance;
     
     auto minion = std::make_unique<Enemy>(minionX, minionY, assets, EnemyKind::Goblin);
+    minion->setWorld(world); // minions never pass through World::addEnemy; their shots hit the boss's terrain
     // Note: setPackRarity and setRenderScale are not available, we'll access directly
     minions.push_back(std::move(minion));
 }
@@ -4,7 +4,6 @@
 #include <fstream>
 #include <sstream>
 #include <random>
-#include <chrono>
 #include <iomanip>
 #include <cstring>
 #include <algorithm>
@@ -154,9 +153,10 @@ UserRole Database::roleFromString(const std::string& s) {
 }
 
 std::string Database::generateSalt(size_t length) {
-    static thread_local std::mt19937_64 rng{
-        static_cast<unsigned long long>(std::chrono::high_resolution_clock::now().time_since_epoch().count())
-    };
+    // Salts must be unpredictable, so like DatabaseSQLite::generateSalt they come from random_device
+    // rather than a clock seed or the seeded game streams
+    std::random_device rd;
+    std::mt19937_64 rng(static_cast<unsigned long long>(rd()) << 32 | rd());
     static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
     std::uniform_int_distribution<size_t> dist(0, sizeof(alphabet) - 2);
     std::string s;
@@ -1,4 +1,6 @@
 #include "DatabaseSQLite.h"
+#include "SaveFormat.h"
+#include "Random.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -7,6 +9,16 @@
 #include <filesystem>
 #include <fstream>
 #include <algorithm>
+#include <cstdio>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef USE_SQLITE
+#include <sqlite3.h>
+#endif
 
 // Robust file-based database implementation with versioning, backups, and atomic operations
 // This provides much better reliability than the original CSV system
@@ -14,10 +26,17 @@
 DatabaseSQLite::DatabaseSQLite() : db(nullptr) {}
 
 DatabaseSQLite::~DatabaseSQLite() {
-    // No cleanup needed for file-based system
+#ifdef USE_SQLITE
+    if (db) {
+        finalizeStatements();
+        sqlite3_close(db);
+        db = nullptr;
+    }
+#endif
 }
 
 bool DatabaseSQLite::initialize(const std::string& dbPath) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     this->dbPath = dbPath;
     
     // Create data directory structure
@@ -36,7 +55,20 @@ bool DatabaseSQLite::initialize(const std::string& dbPath) {
         ofs << "{\"users\":[]}" << std::endl;
     }
     
-    std::cout << "Initialized robust database at: " << dbPath << std::endl;
+#ifdef USE_SQLITE
+    // Prefer the real database; the JSON store remains as a fallback and as the migration source
+    std::string sqlError;
+    if (openSQLite(&sqlError)) {
+        std::cout << "Initialized robust database at: " << dbPath << std::endl;
+        return true;
+    }
+    std::cout << "SQLite unavailable (" << sqlError << "), using JSON file store" << std::endl;
+#endif
+    
+    // Load the account index once; every later lookup is served from memory
+    loadUserIndex();
+    
+    std::cout << "Initialized robust database at: " << dbPath << " (" << usersById.size() << " users indexed)" << std::endl;
     return true;
 }
 
@@ -44,37 +76,66 @@ std::optional<UserRecord> DatabaseSQLite::registerUser(const std::string& userna
                                                        const std::string& password,
                                                        UserRole role,
                                                        std::string* outError) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!isValidUsername(username)) {
+        if (outError) *outError = "Username contains invalid characters";
+        return std::nullopt;
+    }
     // Check if user already exists
     if (getUserByName(username)) {
         if (outError) *outError = "Username already exists";
         return std::nullopt;
     }
     
-    // Generate new user ID
-    int userId = generateUserId();
-    
     // Generate salt and hash
     std::string salt = generateSalt();
     std::string hash = saltedPasswordHashHex(salt, password);
     
-    // Create user record
-    std::filesystem::path userDir = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(userId);
-    std::filesystem::create_directories(userDir);
-    
-    // Save user data
-    std::ofstream userFile(userDir / "user.json");
-    userFile << "{\n";
-    userFile << "  \"id\": " << userId << ",\n";
-    userFile << "  \"username\": \"" << username << "\",\n";
-    userFile << "  \"password_salt\": \"" << salt << "\",\n";
-    userFile << "  \"password_hash\": \"" << hash << "\",\n";
-    userFile << "  \"role\": \"" << roleToString(role) << "\",\n";
-    userFile << "  \"created_at\": \"" << getCurrentTimestamp() << "\"\n";
-    userFile << "}" << std::endl;
-    
-    if (!userFile.good()) {
-        if (outError) *outError = "Failed to save user data";
-        return std::nullopt;
+    UserRecord record{0, username, role};
+    if (db) {
+#ifdef USE_SQLITE
+        auto inserted = sqlInsertUser(0, username, salt, hash, role, getCurrentTimestamp(), outError);
+        if (!inserted) return std::nullopt;
+        record = *inserted;
+#endif
+    } else {
+        // Generate new user ID
+        record.userId = generateUserId();
+        
+        // Create user record
+        std::filesystem::path userDir = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(record.userId);
+        std::filesystem::create_directories(userDir);
+        // An unindexed folder would be picked up by the next index rebuild, so a failed register removes it
+        auto rollback = [&userDir]() {
+            std::error_code ec;
+            std::filesystem::remove_all(userDir, ec);
+        };
+        
+        // Save user data
+        std::ofstream userFile(userDir / "user.json");
+        userFile << "{\n";
+        userFile << "  \"id\": " << record.userId << ",\n";
+        userFile << "  \"username\": \"" << username << "\",\n";
+        userFile << "  \"password_salt\": \"" << salt << "\",\n";
+        userFile << "  \"password_hash\": \"" << hash << "\",\n";
+        userFile << "  \"role\": \"" << roleToString(role) << "\",\n";
+        userFile << "  \"created_at\": \"" << getCurrentTimestamp() << "\"\n";
+        userFile << "}" << std::endl;
+        
+        const bool written = userFile.good();
+        userFile.close();
+        if (!written) {
+            rollback();
+            if (outError) *outError = "Failed to save user data";
+            return std::nullopt;
+        }
+        
+        if (!appendUserIndex(record)) {
+            rollback();
+            if (outError) *outError = "Failed to update user index";
+            return std::nullopt;
+        }
+        indexUser(record);
     }
     
     // Create default save state
@@ -104,15 +165,16 @@ std::optional<UserRecord> DatabaseSQLite::registerUser(const std::string& userna
     defaultSave.invKey[1][1] = "fire_scroll";
     defaultSave.invCnt[1][1] = 2;
     
-    savePlayerState(userId, defaultSave);
+    savePlayerState(record.userId, defaultSave);
     
-    std::cout << "Registered new user: " << username << " (ID: " << userId << ")" << std::endl;
-    return UserRecord{userId, username, role};
+    std::cout << "Registered new user: " << username << " (ID: " << record.userId << ")" << std::endl;
+    return record;
 }
 
 std::optional<UserRecord> DatabaseSQLite::authenticate(const std::string& username,
                                                        const std::string& password,
                                                        std::string* outError) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     std::cout << "Authenticating user: '" << username << "'" << std::endl;
     // Find user by username
     auto user = getUserByName(username);
@@ -124,22 +186,12 @@ std::optional<UserRecord> DatabaseSQLite::authenticate(const std::string& userna
     std::cout << "Found user: " << user->username << " (ID: " << user->userId << ")" << std::endl;
     
     // Load user authentication data
-    std::filesystem::path userFile = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(user->userId) / "user.json";
-    std::ifstream ifs(userFile);
-    if (!ifs.good()) {
+    std::string salt, storedHash;
+    if (!loadUserAuth(user->userId, salt, storedHash)) {
         if (outError) *outError = "Failed to load user data";
         return std::nullopt;
     }
     
-    std::string line, content;
-    while (std::getline(ifs, line)) {
-        content += line;
-    }
-    
-    // Parse authentication data (simple JSON parsing)
-    std::string salt = extractJsonString(content, "password_salt");
-    std::string storedHash = extractJsonString(content, "password_hash");
-    
     if (salt.empty() || storedHash.empty()) {
         if (outError) *outError = "Corrupted user data";
         return std::nullopt;
@@ -153,79 +205,147 @@ std::optional<UserRecord> DatabaseSQLite::authenticate(const std::string& userna
     }
     
     // Update last login
-    std::ofstream lastLoginFile(std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(user->userId) / "last_login.txt");
-    lastLoginFile << getCurrentTimestamp() << std::endl;
+    if (db) {
+#ifdef USE_SQLITE
+        std::string now = getCurrentTimestamp();
+        sqlite3_bind_text(stmts.updateLastLogin, 1, now.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmts.updateLastLogin, 2, user->userId);
+        sqlite3_step(stmts.updateLastLogin);
+        sqlite3_reset(stmts.updateLastLogin);
+#endif
+    } else {
+        std::ofstream lastLoginFile(std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(user->userId) / "last_login.txt");
+        lastLoginFile << getCurrentTimestamp() << std::endl;
+    }
     
     std::cout << "Authenticated user: " << username << " (ID: " << user->userId << ")" << std::endl;
     return user;
 }
 
 std::optional<UserRecord> DatabaseSQLite::getUserByName(const std::string& username) {
-    std::filesystem::path usersDir = std::filesystem::path(dbPath).parent_path() / "users";
-    std::cout << "Searching for user '" << username << "' in: " << usersDir << std::endl;
-    
-    for (const auto& userDir : std::filesystem::directory_iterator(usersDir)) {
-        if (!userDir.is_directory()) continue;
-        
-        std::ifstream userFile(userDir.path() / "user.json");
-        if (!userFile.good()) continue;
-        
-        std::string line, content;
-        while (std::getline(userFile, line)) {
-            content += line;
-        }
-        
-        std::string fileUsername = extractJsonString(content, "username");
-        std::cout << "Checking user file: " << userDir.path() << " - username: '" << fileUsername << "'" << std::endl;
-        if (toLower(fileUsername) == toLower(username)) {
-            int userId = extractJsonInt(content, "id");
-            std::string roleStr = extractJsonString(content, "role");
-            std::cout << "Match found! User: " << fileUsername << ", ID: " << userId << ", Role: " << roleStr << std::endl;
-            
-            return UserRecord{userId, fileUsername, roleFromString(roleStr)};
-        }
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) {
+        std::string key = toLower(username);
+        sqlite3_bind_text(stmts.selectUserByName, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        return sqlSelectUser(stmts.selectUserByName);
     }
-    
-    return std::nullopt;
+#endif
+    auto it = userIdByName.find(toLower(username));
+    if (it == userIdByName.end()) return std::nullopt;
+    return getUserById(it->second);
 }
 
 std::optional<UserRecord> DatabaseSQLite::getUserById(int userId) {
-    std::filesystem::path userFile = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(userId) / "user.json";
-    
-    std::ifstream ifs(userFile);
-    if (!ifs.good()) return std::nullopt;
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) {
+        sqlite3_bind_int(stmts.selectUserById, 1, userId);
+        return sqlSelectUser(stmts.selectUserById);
+    }
+#endif
+    auto it = usersById.find(userId);
+    if (it == usersById.end()) return std::nullopt;
+    return it->second;
+}
+
+bool DatabaseSQLite::savePlayerState(int userId, const PlayerSave& state, std::string* outError) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) return sqlSavePlayerState(userId, state, outError);
+#endif
+    std::filesystem::path saveDir = std::filesystem::path(dbPath).parent_path() / "saves" / std::to_string(userId);
+    std::filesystem::create_directories(saveDir);
     
-    std::string line, content;
-    while (std::getline(ifs, line)) {
-        content += line;
+    // Write new save atomically (write to temp file, then rename)
+    std::filesystem::path currentSave = saveDir / ("current" + saveFileExtension());
+    std::filesystem::path tempSave = saveDir / "current.tmp";
+    std::string data = encodePlayerSave(state);
+    {
+        std::ofstream ofs(tempSave, std::ios::binary | std::ios::trunc);
+        ofs << data;
+        if (!ofs.good()) {
+            if (outError) *outError = "Failed to write save file";
+            return false;
+        }
     }
     
-    std::string username = extractJsonString(content, "username");
-    std::string roleStr = extractJsonString(content, "role");
+    // Make the new contents durable before they replace the old save
+    if (!syncFile(tempSave)) {
+        if (outError) *outError = "Failed to sync save file";
+        return false;
+    }
     
-    if (username.empty()) return std::nullopt;
+    // Atomic rename
+    std::error_code ec;
+    std::filesystem::rename(tempSave, currentSave, ec);
+    if (ec) {
+        if (outError) *outError = "Failed to finalize save: " + ec.message();
+        return false;
+    }
+    // Only one current save exists at a time, in whichever format was written last
+    std::filesystem::remove(saveDir / (saveFileFormat == SaveFileFormat::BINARY ? "current.json" : "current.sav"), ec);
     
-    return UserRecord{userId, username, roleFromString(roleStr)};
+    recordSaveHistory(userId, state, &data);
+    std::cout << "Saved player state for user " << userId << " (level " << state.level << ")" << std::endl;
+    return true;
 }
 
-bool DatabaseSQLite::savePlayerState(int userId, const PlayerSave& state, std::string* outError) {
+std::optional<PlayerSave> DatabaseSQLite::loadPlayerState(int userId, std::string* outError) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) return sqlLoadPlayerState(userId, outError);
+#endif
     std::filesystem::path saveDir = std::filesystem::path(dbPath).parent_path() / "saves" / std::to_string(userId);
-    std::filesystem::create_directories(saveDir);
     
-    // Create backup of current save
-    std::filesystem::path currentSave = saveDir / "current.json";
-    if (std::filesystem::exists(currentSave)) {
-        std::string timestamp = getCurrentTimestamp();
-        std::replace(timestamp.begin(), timestamp.end(), ':', '-');
-        std::replace(timestamp.begin(), timestamp.end(), ' ', '_');
-        std::filesystem::path backupPath = saveDir / ("backup_" + timestamp + ".json");
-        std::filesystem::copy_file(currentSave, backupPath);
+    std::string content;
+    if (!readFile(saveDir / "current.sav", content) && !readFile(saveDir / "current.json", content)) {
+        if (outError) *outError = "No save file found for user";
+        return std::nullopt;
     }
     
-    // Write new save atomically (write to temp file, then rename)
-    std::filesystem::path tempSave = saveDir / "current.tmp";
-    std::ofstream ofs(tempSave);
-    
+    auto decoded = decodePlayerSave(content, outError);
+    if (!decoded) return std::nullopt;
+    PlayerSave& save = *decoded;
+    std::cout << "Loaded player state for user " << userId << " (level " << save.level << ")" << std::endl;
+    return save;
+}
+
+void DatabaseSQLite::setSaveFileFormat(SaveFileFormat format) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    saveFileFormat = format;
+}
+
+std::string DatabaseSQLite::saveFileExtension() const {
+    return saveFileFormat == SaveFileFormat::BINARY ? ".sav" : ".json";
+}
+
+std::string DatabaseSQLite::encodePlayerSave(const PlayerSave& state) {
+    return saveFileFormat == SaveFileFormat::BINARY ? SaveFormat::encode(state) : serializePlayerSaveJson(state);
+}
+
+// Format is detected from the content, so either kind of file loads regardless of the current setting
+std::optional<PlayerSave> DatabaseSQLite::decodePlayerSave(const std::string& content, std::string* outError) {
+    if (SaveFormat::isBinary(content)) return SaveFormat::decode(content, outError);
+    std::string json;
+    json.reserve(content.size());
+    for (char c : content) {
+        if (c != '\n' && c != '\r') json += c;
+    }
+    return parsePlayerSaveJson(json);
+}
+
+bool DatabaseSQLite::readFile(const std::filesystem::path& path, std::string& out) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.good()) return false;
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    out = oss.str();
+    return true;
+}
+
+std::string DatabaseSQLite::serializePlayerSaveJson(const PlayerSave& state) {
+    std::ostringstream ofs;
     ofs << "{\n";
     ofs << "  \"version\": 1,\n";
     ofs << "  \"timestamp\": \"" << getCurrentTimestamp() << "\",\n";
@@ -310,40 +430,10 @@ bool DatabaseSQLite::savePlayerState(int userId, const PlayerSave& state, std::s
     
     ofs << "  ]\n";
     ofs << "}" << std::endl;
-    
-    if (!ofs.good()) {
-        if (outError) *outError = "Failed to write save file";
-        return false;
-    }
-    
-    ofs.close();
-    
-    // Atomic rename
-    std::error_code ec;
-    std::filesystem::rename(tempSave, currentSave, ec);
-    if (ec) {
-        if (outError) *outError = "Failed to finalize save: " + ec.message();
-        return false;
-    }
-    
-    std::cout << "Saved player state for user " << userId << " (level " << state.level << ")" << std::endl;
-    return true;
+    return ofs.str();
 }
 
-std::optional<PlayerSave> DatabaseSQLite::loadPlayerState(int userId, std::string* outError) {
-    std::filesystem::path saveFile = std::filesystem::path(dbPath).parent_path() / "saves" / std::to_string(userId) / "current.json";
-    
-    std::ifstream ifs(saveFile);
-    if (!ifs.good()) {
-        if (outError) *outError = "No save file found for user";
-        return std::nullopt;
-    }
-    
-    std::string line, content;
-    while (std::getline(ifs, line)) {
-        content += line;
-    }
-    
+PlayerSave DatabaseSQLite::parsePlayerSaveJson(const std::string& content) {
     PlayerSave save;
     
     // Parse position
@@ -377,12 +467,11 @@ std::optional<PlayerSave> DatabaseSQLite::loadPlayerState(int userId, std::strin
     
     // Parse equipment and inventory (simplified parsing)
     parseEquipmentAndInventory(content, save);
-    
-    std::cout << "Loaded player state for user " << userId << " (level " << save.level << ")" << std::endl;
     return save;
 }
 
 bool DatabaseSQLite::createBackup(int userId, const std::string& description) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     auto save = loadPlayerState(userId);
     if (!save) return false;
     
@@ -392,17 +481,13 @@ bool DatabaseSQLite::createBackup(int userId, const std::string& description) {
     std::string backupId = generateBackupId();
     std::filesystem::path backupFile = backupDir / (backupId + ".json");
     
+    // Manual backups carry the full save so restoreFromBackup is lossless
     std::ofstream ofs(backupFile);
     ofs << "{\n";
     ofs << "  \"backup_id\": \"" << backupId << "\",\n";
-    ofs << "  \"description\": \"" << description << "\",\n";
+    ofs << "  \"description\": \"" << jsonEscape(description) << "\",\n";
     ofs << "  \"created_at\": \"" << getCurrentTimestamp() << "\",\n";
-    ofs << "  \"level\": " << save->level << ",\n";
-    ofs << "  \"experience\": " << save->experience << ",\n";
-    ofs << "  \"health\": " << save->health << ",\n";
-    ofs << "  \"maxHealth\": " << save->maxHealth << ",\n";
-    ofs << "  \"x\": " << save->x << ",\n";
-    ofs << "  \"y\": " << save->y << "\n";
+    ofs << "  \"save\": " << serializePlayerSaveJson(*save);
     ofs << "}" << std::endl;
     
     if (ofs.good()) {
@@ -414,22 +499,251 @@ bool DatabaseSQLite::createBackup(int userId, const std::string& description) {
 }
 
 std::vector<std::string> DatabaseSQLite::listBackups(int userId) {
-    std::vector<std::string> backups;
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    // (unix time, id) so manual backups and history checkpoints interleave chronologically
+    std::vector<std::pair<long long, std::string>> found;
+    
     std::filesystem::path backupDir = std::filesystem::path(dbPath).parent_path() / "backups" / std::to_string(userId);
+    if (std::filesystem::exists(backupDir)) {
+        for (const auto& entry : std::filesystem::directory_iterator(backupDir)) {
+            if (entry.path().extension() != ".json") continue;
+            std::string id = entry.path().stem().string();
+            long long time = 0;
+            try { time = std::stoll(id.substr(id.find('_') + 1)); } catch (...) {}
+            found.emplace_back(time, id);
+        }
+    }
+    const auto& history = getSaveHistory(userId);
+    for (auto it = history.rbegin(); it != history.rend(); ++it) {
+        found.emplace_back(it->time, historyEntryId(*it));
+    }
+    
+    std::stable_sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.first > b.first; }); // Sort newest first
+    std::vector<std::string> backups;
+    backups.reserve(found.size());
+    for (auto& entry : found) backups.push_back(std::move(entry.second));
+    return backups;
+}
+
+bool DatabaseSQLite::restoreFromBackup(int userId, const std::string& backupId) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::filesystem::path root = std::filesystem::path(dbPath).parent_path();
+    std::string content;
+    bool found = false;
+    
+    if (backupId.rfind("history_", 0) == 0) {
+        for (const auto& entry : getSaveHistory(userId)) {
+            if (historyEntryId(entry) != backupId) continue;
+#ifdef USE_SQLITE
+            if (db) {
+                found = sqlLoadSaveBlob(userId, entry.hash, content);
+                break;
+            }
+#endif
+            found = readFile(historyBlobPath(userId, entry.hash), content);
+            break;
+        }
+    } else {
+        found = readFile(root / "backups" / std::to_string(userId) / (backupId + ".json"), content);
+    }
+    
+    if (!found) {
+        std::cout << "Backup " << backupId << " not found for user " << userId << std::endl;
+        return false;
+    }
     
-    if (!std::filesystem::exists(backupDir)) return backups;
+    std::string error;
+    auto restored = decodePlayerSave(content, &error);
+    if (!restored) {
+        std::cout << "Backup " << backupId << " is unreadable: " << error << std::endl;
+        return false;
+    }
     
-    for (const auto& entry : std::filesystem::directory_iterator(backupDir)) {
-        if (entry.path().extension() == ".json") {
-            backups.push_back(entry.path().stem().string());
+    // Restoring is an ordinary save, so the state it replaces stays in history
+    if (!savePlayerState(userId, *restored)) return false;
+    std::cout << "Restored backup " << backupId << " for user " << userId << std::endl;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Save history (saves/<user>/history)
+// Each distinct save state is stored once as <hash>.sav (or .json); index.txt lists "unixtime<TAB>hash"
+// checkpoints oldest first. Retention keeps the newest HISTORY_KEEP_RECENT checkpoints plus
+// one per hour for HISTORY_HOURLY hours and one per day for HISTORY_DAILY days, so both the
+// directory and the index stay bounded no matter how long the account is played.
+// With SQLite the same checkpoints live in save_history/save_blobs and are written inside the
+// save's own transaction (sqlRecordSaveHistory), so a save does no file I/O.
+// ---------------------------------------------------------------------------
+
+std::vector<DatabaseSQLite::SaveHistoryEntry>& DatabaseSQLite::getSaveHistory(int userId) {
+    auto it = saveHistory.find(userId);
+    if (it != saveHistory.end()) return it->second;
+    
+    std::vector<SaveHistoryEntry>& entries = saveHistory[userId];
+#ifdef USE_SQLITE
+    if (db) {
+        sqlLoadSaveHistory(userId, entries);
+        return entries;
+    }
+#endif
+    std::ifstream ifs(std::filesystem::path(dbPath).parent_path() / "saves" / std::to_string(userId) / "history" / "index.txt");
+    std::string line;
+    while (std::getline(ifs, line)) {
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos) continue;
+        try {
+            entries.push_back(SaveHistoryEntry{std::stoll(line.substr(0, tab)), line.substr(tab + 1)});
+        } catch (...) {
+            // Skip malformed lines
+        }
+    }
+    return entries;
+}
+
+std::string DatabaseSQLite::historyEntryId(const SaveHistoryEntry& entry) {
+    return "history_" + std::to_string(entry.time) + "_" + entry.hash;
+}
+
+std::filesystem::path DatabaseSQLite::historyBlobPath(int userId, const std::string& hash) {
+    std::filesystem::path historyDir = std::filesystem::path(dbPath).parent_path() / "saves" / std::to_string(userId) / "history";
+    std::filesystem::path binary = historyDir / (hash + ".sav");
+    return std::filesystem::exists(binary) ? binary : historyDir / (hash + ".json");
+}
+
+void DatabaseSQLite::recordSaveHistory(int userId, const PlayerSave& state, const std::string* encoded) {
+    std::vector<SaveHistoryEntry>& entries = getSaveHistory(userId);
+    std::string hash = hashPlayerSave(state);
+    
+    // Autosaves of an unchanged player are the common case: nothing to record
+    if (!entries.empty() && entries.back().hash == hash) return;
+    
+    std::filesystem::path historyDir = std::filesystem::path(dbPath).parent_path() / "saves" / std::to_string(userId) / "history";
+    std::filesystem::create_directories(historyDir);
+    if (!std::filesystem::exists(historyBlobPath(userId, hash))) {
+        std::ofstream ofs(historyDir / (hash + saveFileExtension()), std::ios::binary | std::ios::trunc);
+        ofs << (encoded ? *encoded : encodePlayerSave(state));
+        if (!ofs.good()) {
+            std::cout << "Failed to write save history for user " << userId << std::endl;
+            return;
         }
     }
     
-    std::sort(backups.rbegin(), backups.rend()); // Sort newest first
-    return backups;
+    long long now = static_cast<long long>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+    entries.push_back(SaveHistoryEntry{now, hash});
+    pruneSaveHistory(entries, now);
+    
+    // Rewrite the (bounded) index and drop blobs no checkpoint refers to any more
+    std::filesystem::path tempIndex = historyDir / "index.tmp";
+    {
+        std::ofstream ofs(tempIndex, std::ios::trunc);
+        for (const auto& entry : entries) {
+            ofs << entry.time << '\t' << entry.hash << '\n';
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempIndex, historyDir / "index.txt", ec);
+    
+    for (const auto& file : std::filesystem::directory_iterator(historyDir, ec)) {
+        if (file.path().extension() != ".json" && file.path().extension() != ".sav") continue;
+        std::string stem = file.path().stem().string();
+        bool referenced = std::any_of(entries.begin(), entries.end(), [&](const SaveHistoryEntry& e) { return e.hash == stem; });
+        if (!referenced) {
+            std::filesystem::remove(file.path(), ec);
+        }
+    }
+}
+
+void DatabaseSQLite::pruneSaveHistory(std::vector<SaveHistoryEntry>& entries, long long now) {
+    const long long HOUR = 3600;
+    const long long DAY = 24 * HOUR;
+    
+    // Walk newest to oldest; keep a checkpoint if it is recent, or the newest in its hour/day bucket
+    std::vector<bool> keep(entries.size(), false);
+    long long lastHour = -1, lastDay = -1;
+    int recent = 0;
+    for (size_t i = entries.size(); i-- > 0;) {
+        const SaveHistoryEntry& entry = entries[i];
+        long long age = now - entry.time;
+        long long hour = entry.time / HOUR;
+        long long day = entry.time / DAY;
+        if (recent < HISTORY_KEEP_RECENT) {
+            keep[i] = true;
+            ++recent;
+        }
+        if (age < HISTORY_HOURLY * HOUR && hour != lastHour) keep[i] = true;
+        if (age < HISTORY_DAILY * DAY && day != lastDay) keep[i] = true;
+        lastHour = hour;
+        lastDay = day;
+    }
+    
+    size_t out = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (keep[i]) entries[out++] = entries[i];
+    }
+    entries.resize(out);
+}
+
+// FNV-1a over every field, so identical states map to the same history blob
+std::string DatabaseSQLite::hashPlayerSave(const PlayerSave& state) {
+    unsigned long long h = 1469598103934665603ULL;
+    auto mix = [&h](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            h ^= bytes[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    auto mixString = [&](const std::string& str) {
+        mix(str.data(), str.size());
+        mix("\0", 1);
+    };
+    
+    for (float v : {state.x, state.y, state.spawnX, state.spawnY}) mix(&v, sizeof(v));
+    for (int v : {state.level, state.experience, state.maxHealth, state.health, state.maxMana, state.mana,
+                  state.strength, state.intelligence, state.gold, state.masterVolume, state.musicVolume,
+                  state.soundVolume, state.monsterVolume, state.playerMeleeVolume, state.healthPotionCharges,
+                  state.manaPotionCharges, state.upgradeScrolls}) {
+        mix(&v, sizeof(v));
+    }
+    for (int i = 0; i < 9; ++i) {
+        mixString(state.equipNames[i]);
+        for (int v : {state.equipPlus[i], state.equipFire[i], state.equipIce[i], state.equipLightning[i],
+                      state.equipPoison[i], state.equipRarity[i]}) {
+            mix(&v, sizeof(v));
+        }
+    }
+    for (int bag = 0; bag < 2; ++bag) {
+        for (int slot = 0; slot < 9; ++slot) {
+            mixString(state.invKey[bag][slot]);
+            for (int v : {state.invCnt[bag][slot], state.invRarity[bag][slot], state.invPlusLevel[bag][slot]}) mix(&v, sizeof(v));
+        }
+    }
+    for (int slot = 0; slot < 9; ++slot) {
+        mixString(state.resourceKey[slot]);
+        for (int v : {state.resourceCnt[slot], state.resourceRarity[slot], state.resourcePlusLevel[slot]}) mix(&v, sizeof(v));
+    }
+    
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << h;
+    return oss.str();
 }
 
 bool DatabaseSQLite::saveAudioSettings(int userId, int master, int music, int sound, int monster, int playerMelee) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) {
+        sqlite3_stmt* st = stmts.upsertAudio;
+        sqlite3_bind_int(st, 1, userId);
+        sqlite3_bind_int(st, 2, master);
+        sqlite3_bind_int(st, 3, music);
+        sqlite3_bind_int(st, 4, sound);
+        sqlite3_bind_int(st, 5, monster);
+        sqlite3_bind_int(st, 6, playerMelee);
+        bool ok = sqlite3_step(st) == SQLITE_DONE;
+        sqlite3_reset(st);
+        return ok;
+    }
+#endif
     std::filesystem::path userDir = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(userId);
     std::filesystem::create_directories(userDir);
     
@@ -446,6 +760,23 @@ bool DatabaseSQLite::saveAudioSettings(int userId, int master, int music, int so
 }
 
 bool DatabaseSQLite::loadAudioSettings(int userId, int& master, int& music, int& sound, int& monster, int& playerMelee) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) {
+        sqlite3_stmt* st = stmts.selectAudio;
+        sqlite3_bind_int(st, 1, userId);
+        bool found = sqlite3_step(st) == SQLITE_ROW && sqlite3_column_type(st, 0) != SQLITE_NULL;
+        if (found) {
+            master = sqlite3_column_int(st, 0);
+            music = sqlite3_column_int(st, 1);
+            sound = sqlite3_column_int(st, 2);
+            monster = sqlite3_column_int(st, 3);
+            playerMelee = sqlite3_column_int(st, 4);
+        }
+        sqlite3_reset(st);
+        return found;
+    }
+#endif
     std::filesystem::path audioFile = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(userId) / "audio.json";
     
     std::ifstream ifs(audioFile);
@@ -466,6 +797,16 @@ bool DatabaseSQLite::loadAudioSettings(int userId, int& master, int& music, int&
 }
 
 bool DatabaseSQLite::saveTheme(int userId, const std::string& themeName) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) {
+        sqlite3_bind_int(stmts.upsertTheme, 1, userId);
+        sqlite3_bind_text(stmts.upsertTheme, 2, themeName.c_str(), -1, SQLITE_TRANSIENT);
+        bool ok = sqlite3_step(stmts.upsertTheme) == SQLITE_DONE;
+        sqlite3_reset(stmts.upsertTheme);
+        return ok;
+    }
+#endif
     std::filesystem::path userDir = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(userId);
     std::filesystem::create_directories(userDir);
     
@@ -476,6 +817,16 @@ bool DatabaseSQLite::saveTheme(int userId, const std::string& themeName) {
 }
 
 bool DatabaseSQLite::loadTheme(int userId, std::string& outThemeName) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) {
+        sqlite3_bind_int(stmts.selectTheme, 1, userId);
+        bool found = sqlite3_step(stmts.selectTheme) == SQLITE_ROW && sqlite3_column_type(stmts.selectTheme, 0) != SQLITE_NULL;
+        if (found) outThemeName = reinterpret_cast<const char*>(sqlite3_column_text(stmts.selectTheme, 0));
+        sqlite3_reset(stmts.selectTheme);
+        return found;
+    }
+#endif
     std::filesystem::path themeFile = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(userId) / "theme.txt";
     
     std::ifstream ifs(themeFile);
@@ -485,7 +836,48 @@ bool DatabaseSQLite::loadTheme(int userId, std::string& outThemeName) {
     return true;
 }
 
+bool DatabaseSQLite::saveKeyBindings(int userId, const std::string& bindings) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) {
+        sqlite3_bind_int(stmts.upsertKeyBindings, 1, userId);
+        sqlite3_bind_text(stmts.upsertKeyBindings, 2, bindings.c_str(), -1, SQLITE_TRANSIENT);
+        bool ok = sqlite3_step(stmts.upsertKeyBindings) == SQLITE_DONE;
+        sqlite3_reset(stmts.upsertKeyBindings);
+        return ok;
+    }
+#endif
+    std::filesystem::path userDir = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(userId);
+    std::filesystem::create_directories(userDir);
+    
+    std::ofstream ofs(userDir / "keybindings.txt");
+    ofs << bindings << std::endl;
+    
+    return ofs.good();
+}
+
+bool DatabaseSQLite::loadKeyBindings(int userId, std::string& outBindings) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) {
+        sqlite3_bind_int(stmts.selectKeyBindings, 1, userId);
+        bool found = sqlite3_step(stmts.selectKeyBindings) == SQLITE_ROW;
+        if (found) outBindings = reinterpret_cast<const char*>(sqlite3_column_text(stmts.selectKeyBindings, 0));
+        sqlite3_reset(stmts.selectKeyBindings);
+        return found;
+    }
+#endif
+    std::filesystem::path bindingsFile = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(userId) / "keybindings.txt";
+    
+    std::ifstream ifs(bindingsFile);
+    if (!ifs.good()) return false;
+    
+    std::getline(ifs, outBindings);
+    return true;
+}
+
 bool DatabaseSQLite::saveRememberState(const RememberState& state) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     std::filesystem::path rememberFile = std::filesystem::path(dbPath).parent_path() / "remember.json";
     
     std::ofstream ofs(rememberFile);
@@ -499,6 +891,7 @@ bool DatabaseSQLite::saveRememberState(const RememberState& state) {
 }
 
 DatabaseSQLite::RememberState DatabaseSQLite::loadRememberState() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     RememberState state;
     
     std::filesystem::path rememberFile = std::filesystem::path(dbPath).parent_path() / "remember.json";
@@ -534,33 +927,194 @@ DatabaseSQLite::RememberState DatabaseSQLite::loadRememberState() {
 }
 
 bool DatabaseSQLite::clearRememberState() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     std::filesystem::path rememberFile = std::filesystem::path(dbPath).parent_path() / "remember.json";
     return std::filesystem::remove(rememberFile);
 }
 
+bool DatabaseSQLite::loadUserAuth(int userId, std::string& outSalt, std::string& outHash) {
+#ifdef USE_SQLITE
+    if (db) {
+        sqlite3_bind_int(stmts.selectUserAuth, 1, userId);
+        bool found = sqlite3_step(stmts.selectUserAuth) == SQLITE_ROW;
+        if (found) {
+            outSalt = reinterpret_cast<const char*>(sqlite3_column_text(stmts.selectUserAuth, 0));
+            outHash = reinterpret_cast<const char*>(sqlite3_column_text(stmts.selectUserAuth, 1));
+        }
+        sqlite3_reset(stmts.selectUserAuth);
+        return found;
+    }
+#endif
+    std::filesystem::path userFile = std::filesystem::path(dbPath).parent_path() / "users" / std::to_string(userId) / "user.json";
+    std::ifstream ifs(userFile);
+    if (!ifs.good()) return false;
+    
+    std::string line, content;
+    while (std::getline(ifs, line)) {
+        content += line;
+    }
+    
+    // Parse authentication data (simple JSON parsing)
+    outSalt = extractJsonString(content, "password_salt");
+    outHash = extractJsonString(content, "password_hash");
+    return true;
+}
+
+// Database maintenance (no-ops for the JSON file store)
+bool DatabaseSQLite::vacuum() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) return executeSQL("VACUUM;");
+#endif
+    return true;
+}
+
+bool DatabaseSQLite::backup(const std::string& backupPath) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) {
+        // Online backup of the live database into a standalone file
+        sqlite3* dest = nullptr;
+        if (sqlite3_open(backupPath.c_str(), &dest) != SQLITE_OK) {
+            sqlite3_close(dest);
+            return false;
+        }
+        sqlite3_backup* bk = sqlite3_backup_init(dest, "main", db, "main");
+        bool ok = false;
+        if (bk) {
+            ok = sqlite3_backup_step(bk, -1) == SQLITE_DONE;
+            sqlite3_backup_finish(bk);
+        }
+        sqlite3_close(dest);
+        return ok;
+    }
+#endif
+    std::error_code ec;
+    std::filesystem::path root = std::filesystem::path(dbPath).parent_path();
+    std::filesystem::copy(root / "users", std::filesystem::path(backupPath) / "users",
+                          std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) return false;
+    std::filesystem::copy(root / "saves", std::filesystem::path(backupPath) / "saves",
+                          std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing, ec);
+    return !ec;
+}
+
+bool DatabaseSQLite::verifyIntegrity() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+#ifdef USE_SQLITE
+    if (db) {
+        sqlite3_stmt* st = nullptr;
+        if (sqlite3_prepare_v2(db, "PRAGMA integrity_check;", -1, &st, nullptr) != SQLITE_OK) return false;
+        bool ok = sqlite3_step(st) == SQLITE_ROW &&
+                  std::string(reinterpret_cast<const char*>(sqlite3_column_text(st, 0))) == "ok";
+        sqlite3_finalize(st);
+        return ok;
+    }
+#endif
+    // Every indexed account must still have its user record on disk
+    std::filesystem::path usersDir = std::filesystem::path(dbPath).parent_path() / "users";
+    for (const auto& entry : usersById) {
+        if (!std::filesystem::exists(usersDir / std::to_string(entry.first) / "user.json")) return false;
+    }
+    return true;
+}
+
 // Helper methods implementation
 int DatabaseSQLite::generateUserId() {
+    return maxUserId + 1;
+}
+
+// Account index (users/index.txt): one "id<TAB>role<TAB>username" line per account.
+// Appended on register and read once at startup.
+void DatabaseSQLite::loadUserIndex() {
+    userIdByName.clear();
+    usersById.clear();
+    maxUserId = 0;
+    
+    std::filesystem::path indexPath = std::filesystem::path(dbPath).parent_path() / "users" / "index.txt";
+    std::ifstream ifs(indexPath);
+    if (!ifs.good()) {
+        // First run with an index-aware build: migrate by scanning existing user folders once
+        rebuildUserIndex();
+        return;
+    }
+    
+    std::string line;
+    while (std::getline(ifs, line)) {
+        size_t tab1 = line.find('\t');
+        if (tab1 == std::string::npos) continue;
+        size_t tab2 = line.find('\t', tab1 + 1);
+        if (tab2 == std::string::npos) continue;
+        try {
+            int userId = std::stoi(line.substr(0, tab1));
+            indexUser(UserRecord{userId, line.substr(tab2 + 1), roleFromString(line.substr(tab1 + 1, tab2 - tab1 - 1))});
+        } catch (...) {
+            // Skip malformed lines (e.g. a torn write at the end of the file)
+        }
+    }
+}
+
+void DatabaseSQLite::rebuildUserIndex() {
     std::filesystem::path usersDir = std::filesystem::path(dbPath).parent_path() / "users";
+    if (!std::filesystem::exists(usersDir)) return;
     
-    int maxId = 0;
-    if (std::filesystem::exists(usersDir)) {
-        for (const auto& entry : std::filesystem::directory_iterator(usersDir)) {
-            if (entry.is_directory()) {
-                try {
-                    int id = std::stoi(entry.path().filename().string());
-                    maxId = std::max(maxId, id);
-                } catch (...) {
-                    // Ignore non-numeric directory names
-                }
-            }
+    std::vector<UserRecord> found;
+    for (const auto& userDir : std::filesystem::directory_iterator(usersDir)) {
+        if (!userDir.is_directory()) continue;
+        
+        std::ifstream userFile(userDir.path() / "user.json");
+        if (!userFile.good()) continue;
+        
+        std::string line, content;
+        while (std::getline(userFile, line)) {
+            content += line;
+        }
+        
+        std::string username = extractJsonString(content, "username");
+        if (username.empty()) continue;
+        found.push_back(UserRecord{extractJsonInt(content, "id"), username, roleFromString(extractJsonString(content, "role"))});
+    }
+    std::sort(found.begin(), found.end(), [](const UserRecord& a, const UserRecord& b) { return a.userId < b.userId; });
+    
+    // Write the whole index to a temp file and swap it in
+    std::filesystem::path indexPath = usersDir / "index.txt";
+    std::filesystem::path tempPath = usersDir / "index.tmp";
+    {
+        std::ofstream ofs(tempPath, std::ios::trunc);
+        for (const auto& user : found) {
+            ofs << user.userId << '\t' << roleToString(user.role) << '\t' << user.username << '\n';
         }
     }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, indexPath, ec);
+    if (ec) {
+        std::cout << "Failed to write user index: " << ec.message() << std::endl;
+    }
     
-    return maxId + 1;
+    for (const auto& user : found) {
+        indexUser(user);
+    }
+    std::cout << "Rebuilt user index with " << found.size() << " accounts" << std::endl;
+}
+
+bool DatabaseSQLite::appendUserIndex(const UserRecord& user) {
+    if (!isValidUsername(user.username)) return false; // would split or break its line
+    std::filesystem::path indexPath = std::filesystem::path(dbPath).parent_path() / "users" / "index.txt";
+    std::ofstream ofs(indexPath, std::ios::app);
+    ofs << user.userId << '\t' << roleToString(user.role) << '\t' << user.username << '\n';
+    ofs.flush();
+    return ofs.good();
+}
+
+void DatabaseSQLite::indexUser(const UserRecord& user) {
+    usersById[user.userId] = user;
+    userIdByName[toLower(user.username)] = user.userId;
+    maxUserId = std::max(maxUserId, user.userId);
 }
 
 std::string DatabaseSQLite::generateSalt(size_t length) {
     const std::string chars = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    // Salts must be unpredictable, so they stay on random_device rather than the seeded game streams
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<> dis(0, chars.size() - 1);
@@ -586,6 +1140,11 @@ std::string DatabaseSQLite::saltedPasswordHashHex(const std::string& salt, const
     return sha256Hex(salt + password + "pixlegends_robust_salt_2024");
 }
 
+// Index lines are tab/newline delimited and user.json is written unescaped
+bool DatabaseSQLite::isValidUsername(const std::string& username) {
+    return std::none_of(username.begin(), username.end(), [](unsigned char c) { return c < 0x20 || c == 0x7f || c == '"' || c == '\\'; });
+}
+
 std::string DatabaseSQLite::toLower(const std::string& s) {
     std::string result = s;
     std::transform(result.begin(), result.end(), result.begin(), ::tolower);
@@ -605,10 +1164,26 @@ std::string DatabaseSQLite::generateBackupId() {
     auto time_t = std::chrono::system_clock::to_time_t(now);
     
     std::ostringstream oss;
-    oss << "backup_" << time_t << "_" << (rand() % 1000);
+    oss << "backup_" << time_t << "_" << Random::sequenced(RngSystem::Saves).nextInt(0, 999);
     return oss.str();
 }
 
+bool DatabaseSQLite::syncFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+    FILE* f = _wfopen(path.c_str(), L"r+b");
+    if (!f) return false;
+    bool ok = _commit(_fileno(f)) == 0;
+    fclose(f);
+    return ok;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
 std::string DatabaseSQLite::getCurrentTimestamp() {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
@@ -619,6 +1194,24 @@ std::string DatabaseSQLite::getCurrentTimestamp() {
 }
 
 // Simple JSON parsing helpers
+// Free text goes into files read back by the key scanners below, which match the first quoted
+// key anywhere in the file. Quotes are therefore written as \u0022 rather than \", so no user
+// string can ever contain a literal "key" that shadows a real field.
+std::string DatabaseSQLite::jsonEscape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\' || c < 0x20 || c == 0x7f) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    return out;
+}
+
 std::string DatabaseSQLite::extractJsonString(const std::string& json, const std::string& key) {
     std::string searchKey = "\"" + key + "\"";
     size_t pos = json.find(searchKey);
@@ -772,4 +1365,567 @@ void DatabaseSQLite::parseEquipmentAndInventory(const std::string& json, PlayerS
         }
     }
     std::cout << "Inventory parsing complete" << std::endl;
-}
\ No newline at end of file
+}
+#ifdef USE_SQLITE
+// ---------------------------------------------------------------------------
+// SQLite storage engine
+// Schema is normalized per concern (account, stats, equipment, inventory, settings) so a save
+// rewrites a handful of small rows inside one transaction instead of a whole document.
+// ---------------------------------------------------------------------------
+
+static const int kSchemaVersion = 2;
+
+bool DatabaseSQLite::executeSQL(const std::string& sql, std::string* outError) {
+    char* err = nullptr;
+    if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &err) != SQLITE_OK) {
+        if (outError) *outError = err ? err : "SQLite error";
+        sqlite3_free(err);
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseSQLite::createTables(std::string* outError) {
+    return executeSQL(
+        "CREATE TABLE IF NOT EXISTS schema_meta ("
+        "  key TEXT PRIMARY KEY, value TEXT NOT NULL) WITHOUT ROWID;"
+        "CREATE TABLE IF NOT EXISTS users ("
+        "  id INTEGER PRIMARY KEY,"
+        "  username TEXT NOT NULL,"
+        "  username_lower TEXT NOT NULL UNIQUE,"
+        "  password_salt TEXT NOT NULL,"
+        "  password_hash TEXT NOT NULL,"
+        "  role TEXT NOT NULL,"
+        "  created_at TEXT,"
+        "  last_login TEXT);"
+        "CREATE TABLE IF NOT EXISTS player_stats ("
+        "  user_id INTEGER PRIMARY KEY REFERENCES users(id) ON DELETE CASCADE,"
+        "  x REAL, y REAL, spawn_x REAL, spawn_y REAL,"
+        "  level INTEGER, experience INTEGER, max_health INTEGER, health INTEGER,"
+        "  max_mana INTEGER, mana INTEGER, strength INTEGER, intelligence INTEGER, gold INTEGER,"
+        "  master_volume INTEGER, music_volume INTEGER, sound_volume INTEGER,"
+        "  monster_volume INTEGER, player_melee_volume INTEGER,"
+        "  health_potions INTEGER, mana_potions INTEGER, upgrade_scrolls INTEGER,"
+        "  updated_at TEXT);"
+        "CREATE TABLE IF NOT EXISTS equipment_slots ("
+        "  user_id INTEGER NOT NULL REFERENCES users(id) ON DELETE CASCADE,"
+        "  slot INTEGER NOT NULL,"
+        "  name TEXT, plus INTEGER, fire INTEGER, ice INTEGER, lightning INTEGER, poison INTEGER, rarity INTEGER,"
+        "  PRIMARY KEY (user_id, slot)) WITHOUT ROWID;"
+        "CREATE TABLE IF NOT EXISTS inventory_stacks ("
+        "  user_id INTEGER NOT NULL REFERENCES users(id) ON DELETE CASCADE,"
+        "  bag INTEGER NOT NULL,"  // 0/1 = main bags, 2 = resource bag
+        "  slot INTEGER NOT NULL,"
+        "  item_key TEXT NOT NULL, count INTEGER, rarity INTEGER, plus_level INTEGER,"
+        "  PRIMARY KEY (user_id, bag, slot)) WITHOUT ROWID;"
+        "CREATE TABLE IF NOT EXISTS user_settings ("
+        "  user_id INTEGER PRIMARY KEY REFERENCES users(id) ON DELETE CASCADE,"
+        "  master_volume INTEGER, music_volume INTEGER, sound_volume INTEGER,"
+        "  monster_volume INTEGER, player_melee_volume INTEGER,"
+        "  theme TEXT);"
+        "CREATE TABLE IF NOT EXISTS user_key_bindings ("
+        "  user_id INTEGER PRIMARY KEY REFERENCES users(id) ON DELETE CASCADE,"
+        "  bindings TEXT NOT NULL);"
+        // Save history (v2): checkpoints reference content-addressed SaveFormat blobs
+        "CREATE TABLE IF NOT EXISTS save_blobs ("
+        "  user_id INTEGER NOT NULL REFERENCES users(id) ON DELETE CASCADE,"
+        "  hash TEXT NOT NULL,"
+        "  data BLOB NOT NULL,"
+        "  PRIMARY KEY (user_id, hash)) WITHOUT ROWID;"
+        "CREATE TABLE IF NOT EXISTS save_history ("
+        "  user_id INTEGER NOT NULL REFERENCES users(id) ON DELETE CASCADE,"
+        "  created_at INTEGER NOT NULL,"  // unix seconds
+        "  hash TEXT NOT NULL,"
+        "  PRIMARY KEY (user_id, created_at, hash)) WITHOUT ROWID;",
+        outError);
+}
+
+bool DatabaseSQLite::openSQLite(std::string* outError) {
+    std::filesystem::path sqlPath = std::filesystem::path(dbPath).replace_extension(".sqlite");
+    if (sqlite3_open(sqlPath.string().c_str(), &db) != SQLITE_OK) {
+        if (outError) *outError = db ? sqlite3_errmsg(db) : "sqlite3_open failed";
+        sqlite3_close(db);
+        db = nullptr;
+        return false;
+    }
+    sqlite3_busy_timeout(db, 2000);
+    
+    // WAL keeps readers off the writer's back and makes each commit a sequential append;
+    // NORMAL sync is durable across application crashes, which is what a save needs
+    bool ok = executeSQL("PRAGMA journal_mode=WAL;", outError) &&
+              executeSQL("PRAGMA synchronous=NORMAL;", outError) &&
+              executeSQL("PRAGMA foreign_keys=ON;", outError) &&
+              createTables(outError) &&
+              executeSQL("PRAGMA user_version=" + std::to_string(kSchemaVersion) + ";", outError) &&
+              prepareStatements(outError) &&
+              migrateFromJsonFiles(outError) &&
+              migrateSaveHistoryFiles(outError);
+    if (!ok) {
+        finalizeStatements();
+        sqlite3_close(db);
+        db = nullptr;
+        return false;
+    }
+    std::cout << "Opened SQLite database at: " << sqlPath.string() << std::endl;
+    return true;
+}
+
+bool DatabaseSQLite::prepareStatements(std::string* outError) {
+    struct Entry { sqlite3_stmt** stmt; const char* sql; };
+    const Entry entries[] = {
+        {&stmts.begin, "BEGIN IMMEDIATE;"},
+        {&stmts.commit, "COMMIT;"},
+        {&stmts.rollback, "ROLLBACK;"},
+        {&stmts.insertUser, "INSERT INTO users (id, username, username_lower, password_salt, password_hash, role, created_at) "
+                            "VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7);"},
+        {&stmts.selectUserByName, "SELECT id, username, role FROM users WHERE username_lower = ?1;"},
+        {&stmts.selectUserById, "SELECT id, username, role FROM users WHERE id = ?1;"},
+        {&stmts.selectUserAuth, "SELECT password_salt, password_hash FROM users WHERE id = ?1;"},
+        {&stmts.updateLastLogin, "UPDATE users SET last_login = ?1 WHERE id = ?2;"},
+        {&stmts.upsertStats, "INSERT OR REPLACE INTO player_stats VALUES "
+                             "(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14, ?15, ?16, ?17, ?18, ?19, ?20, ?21, ?22, ?23);"},
+        {&stmts.upsertEquipment, "INSERT OR REPLACE INTO equipment_slots VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9);"},
+        {&stmts.deleteInventory, "DELETE FROM inventory_stacks WHERE user_id = ?1;"},
+        {&stmts.upsertInventory, "INSERT OR REPLACE INTO inventory_stacks VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7);"},
+        {&stmts.selectStats, "SELECT x, y, spawn_x, spawn_y, level, experience, max_health, health, max_mana, mana, "
+                             "strength, intelligence, gold, master_volume, music_volume, sound_volume, monster_volume, "
+                             "player_melee_volume, health_potions, mana_potions, upgrade_scrolls "
+                             "FROM player_stats WHERE user_id = ?1;"},
+        {&stmts.selectEquipment, "SELECT slot, name, plus, fire, ice, lightning, poison, rarity FROM equipment_slots WHERE user_id = ?1;"},
+        {&stmts.selectInventory, "SELECT bag, slot, item_key, count, rarity, plus_level FROM inventory_stacks WHERE user_id = ?1;"},
+        {&stmts.upsertAudio, "INSERT INTO user_settings (user_id, master_volume, music_volume, sound_volume, monster_volume, player_melee_volume) "
+                             "VALUES (?1, ?2, ?3, ?4, ?5, ?6) ON CONFLICT(user_id) DO UPDATE SET "
+                             "master_volume = excluded.master_volume, music_volume = excluded.music_volume, "
+                             "sound_volume = excluded.sound_volume, monster_volume = excluded.monster_volume, "
+                             "player_melee_volume = excluded.player_melee_volume;"},
+        {&stmts.selectAudio, "SELECT master_volume, music_volume, sound_volume, monster_volume, player_melee_volume "
+                             "FROM user_settings WHERE user_id = ?1;"},
+        {&stmts.upsertTheme, "INSERT INTO user_settings (user_id, theme) VALUES (?1, ?2) "
+                             "ON CONFLICT(user_id) DO UPDATE SET theme = excluded.theme;"},
+        {&stmts.selectTheme, "SELECT theme FROM user_settings WHERE user_id = ?1;"},
+        {&stmts.upsertKeyBindings, "INSERT OR REPLACE INTO user_key_bindings VALUES (?1, ?2);"},
+        {&stmts.selectKeyBindings, "SELECT bindings FROM user_key_bindings WHERE user_id = ?1;"},
+        {&stmts.insertSaveBlob, "INSERT OR IGNORE INTO save_blobs VALUES (?1, ?2, ?3);"},
+        {&stmts.selectSaveBlob, "SELECT data FROM save_blobs WHERE user_id = ?1 AND hash = ?2;"},
+        {&stmts.deleteSaveBlob, "DELETE FROM save_blobs WHERE user_id = ?1 AND hash = ?2;"},
+        {&stmts.insertHistory, "INSERT OR IGNORE INTO save_history VALUES (?1, ?2, ?3);"},
+        {&stmts.selectHistory, "SELECT created_at, hash FROM save_history WHERE user_id = ?1 ORDER BY created_at;"},
+        {&stmts.deleteHistory, "DELETE FROM save_history WHERE user_id = ?1 AND created_at = ?2 AND hash = ?3;"},
+    };
+    for (const auto& entry : entries) {
+        if (sqlite3_prepare_v3(db, entry.sql, -1, SQLITE_PREPARE_PERSISTENT, entry.stmt, nullptr) != SQLITE_OK) {
+            if (outError) *outError = sqlite3_errmsg(db);
+            return false;
+        }
+    }
+    return true;
+}
+
+void DatabaseSQLite::finalizeStatements() {
+    sqlite3_stmt** all[] = {
+        &stmts.begin, &stmts.commit, &stmts.rollback, &stmts.insertUser, &stmts.selectUserByName,
+        &stmts.selectUserById, &stmts.selectUserAuth, &stmts.updateLastLogin, &stmts.upsertStats,
+        &stmts.upsertEquipment, &stmts.deleteInventory, &stmts.upsertInventory, &stmts.selectStats,
+        &stmts.selectEquipment, &stmts.selectInventory, &stmts.upsertAudio, &stmts.selectAudio,
+        &stmts.upsertTheme, &stmts.selectTheme, &stmts.upsertKeyBindings, &stmts.selectKeyBindings,
+        &stmts.insertSaveBlob, &stmts.selectSaveBlob, &stmts.deleteSaveBlob, &stmts.insertHistory,
+        &stmts.selectHistory, &stmts.deleteHistory,
+    };
+    for (sqlite3_stmt** stmt : all) {
+        sqlite3_finalize(*stmt);
+        *stmt = nullptr;
+    }
+}
+
+// One-time import of the JSON file store. Reads go through the public API with db detached,
+// so the JSON parsing paths stay the single source of truth for the old format.
+bool DatabaseSQLite::readSchemaFlag(const std::string& key, bool& outSet, std::string* outError) {
+    sqlite3_stmt* check = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT value FROM schema_meta WHERE key = ?1;", -1, &check, nullptr) != SQLITE_OK) {
+        if (outError) *outError = sqlite3_errmsg(db);
+        return false;
+    }
+    sqlite3_bind_text(check, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    outSet = sqlite3_step(check) == SQLITE_ROW;
+    sqlite3_finalize(check);
+    return true;
+}
+
+bool DatabaseSQLite::migrateFromJsonFiles(std::string* outError) {
+    bool migrated = false;
+    if (!readSchemaFlag("json_migrated", migrated, outError)) return false;
+    if (migrated) return true;
+    
+    struct Imported {
+        UserRecord user;
+        std::string salt, hash;
+        std::optional<PlayerSave> save;
+        bool hasAudio = false;
+        int audio[5] = {};
+        std::string theme;
+        std::string keyBindings;
+    };
+    std::vector<Imported> imported;
+    
+    // The JSON account index is only needed here; afterwards SQLite answers every lookup
+    sqlite3* live = db;
+    db = nullptr;
+    loadUserIndex();
+    for (const auto& entry : usersById) {
+        Imported item;
+        item.user = entry.second;
+        if (!loadUserAuth(entry.first, item.salt, item.hash)) continue;
+        item.save = loadPlayerState(entry.first);
+        item.hasAudio = loadAudioSettings(entry.first, item.audio[0], item.audio[1], item.audio[2], item.audio[3], item.audio[4]);
+        loadTheme(entry.first, item.theme);
+        loadKeyBindings(entry.first, item.keyBindings);
+        imported.push_back(std::move(item));
+    }
+    db = live;
+    userIdByName.clear();
+    usersById.clear();
+    
+    if (!executeSQL("BEGIN IMMEDIATE;", outError)) return false;
+    for (const auto& item : imported) {
+        if (!sqlInsertUser(item.user.userId, item.user.username, item.salt, item.hash, item.user.role, getCurrentTimestamp(), outError) ||
+            (item.save && !sqlWritePlayerRows(item.user.userId, *item.save)) ||
+            (item.hasAudio && !saveAudioSettings(item.user.userId, item.audio[0], item.audio[1], item.audio[2], item.audio[3], item.audio[4])) ||
+            (!item.theme.empty() && !saveTheme(item.user.userId, item.theme)) ||
+            (!item.keyBindings.empty() && !saveKeyBindings(item.user.userId, item.keyBindings))) {
+            if (outError && outError->empty()) *outError = sqlite3_errmsg(db);
+            executeSQL("ROLLBACK;");
+            return false;
+        }
+    }
+    if (!executeSQL("INSERT INTO schema_meta (key, value) VALUES ('json_migrated', '" + getCurrentTimestamp() + "');", outError) ||
+        !executeSQL("COMMIT;", outError)) {
+        executeSQL("ROLLBACK;");
+        return false;
+    }
+    if (!imported.empty()) {
+        std::cout << "Migrated " << imported.size() << " accounts from JSON store to SQLite" << std::endl;
+    }
+    return true;
+}
+
+// Schema v1 kept save history as files next to the SQLite database; import it once
+bool DatabaseSQLite::migrateSaveHistoryFiles(std::string* outError) {
+    bool migrated = false;
+    if (!readSchemaFlag("history_migrated", migrated, outError)) return false;
+    if (migrated) return true;
+    
+    struct Imported {
+        int userId;
+        std::vector<SaveHistoryEntry> entries;
+        std::vector<std::pair<std::string, std::string>> blobs; // hash, file contents
+    };
+    std::vector<Imported> imported;
+    
+    std::error_code ec;
+    std::filesystem::path savesDir = std::filesystem::path(dbPath).parent_path() / "saves";
+    for (const auto& dir : std::filesystem::directory_iterator(savesDir, ec)) {
+        Imported item{0, {}, {}};
+        try {
+            item.userId = std::stoi(dir.path().filename().string());
+        } catch (...) {
+            continue;
+        }
+        // Orphaned folders have no users row to reference
+        if (!getUserById(item.userId)) continue;
+        
+        sqlite3* live = db;
+        db = nullptr;
+        saveHistory.erase(item.userId);
+        item.entries = getSaveHistory(item.userId);
+        for (const auto& entry : item.entries) {
+            std::string content;
+            if (readFile(historyBlobPath(item.userId, entry.hash), content)) item.blobs.emplace_back(entry.hash, std::move(content));
+        }
+        db = live;
+        if (!item.entries.empty()) imported.push_back(std::move(item));
+    }
+    saveHistory.clear();
+    
+    if (!executeSQL("BEGIN IMMEDIATE;", outError)) return false;
+    bool ok = true;
+    for (const auto& item : imported) {
+        for (const auto& blob : item.blobs) {
+            sqlite3_bind_int(stmts.insertSaveBlob, 1, item.userId);
+            sqlite3_bind_text(stmts.insertSaveBlob, 2, blob.first.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_blob(stmts.insertSaveBlob, 3, blob.second.data(), static_cast<int>(blob.second.size()), SQLITE_STATIC);
+            ok = ok && sqlite3_step(stmts.insertSaveBlob) == SQLITE_DONE;
+            sqlite3_reset(stmts.insertSaveBlob);
+        }
+        for (const auto& entry : item.entries) {
+            // A checkpoint whose blob went missing cannot be restored; leave it behind
+            bool hasBlob = std::any_of(item.blobs.begin(), item.blobs.end(), [&](const auto& b) { return b.first == entry.hash; });
+            if (!hasBlob) continue;
+            sqlite3_bind_int(stmts.insertHistory, 1, item.userId);
+            sqlite3_bind_int64(stmts.insertHistory, 2, entry.time);
+            sqlite3_bind_text(stmts.insertHistory, 3, entry.hash.c_str(), -1, SQLITE_TRANSIENT);
+            ok = ok && sqlite3_step(stmts.insertHistory) == SQLITE_DONE;
+            sqlite3_reset(stmts.insertHistory);
+        }
+    }
+    if (!ok ||
+        !executeSQL("INSERT INTO schema_meta (key, value) VALUES ('history_migrated', '" + getCurrentTimestamp() + "');", outError) ||
+        !executeSQL("COMMIT;", outError)) {
+        if (outError && outError->empty()) *outError = sqlite3_errmsg(db);
+        executeSQL("ROLLBACK;");
+        return false;
+    }
+    if (!imported.empty()) {
+        std::cout << "Migrated save history of " << imported.size() << " accounts to SQLite" << std::endl;
+    }
+    return true;
+}
+
+std::optional<UserRecord> DatabaseSQLite::sqlInsertUser(int userId, const std::string& username, const std::string& salt,
+                                                        const std::string& hash, UserRole role, const std::string& createdAt,
+                                                        std::string* outError) {
+    sqlite3_stmt* st = stmts.insertUser;
+    std::string lower = toLower(username);
+    std::string roleName = roleToString(role);
+    if (userId > 0) sqlite3_bind_int(st, 1, userId);
+    else sqlite3_bind_null(st, 1);
+    sqlite3_bind_text(st, 2, username.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 3, lower.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 4, salt.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 5, hash.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 6, roleName.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 7, createdAt.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(st);
+    sqlite3_reset(st);
+    sqlite3_clear_bindings(st);
+    if (rc != SQLITE_DONE) {
+        if (outError) *outError = rc == SQLITE_CONSTRAINT ? "Username already exists" : sqlite3_errmsg(db);
+        return std::nullopt;
+    }
+    return UserRecord{static_cast<int>(sqlite3_last_insert_rowid(db)), username, role};
+}
+
+std::optional<UserRecord> DatabaseSQLite::sqlSelectUser(sqlite3_stmt* stmt) {
+    std::optional<UserRecord> result;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        result = UserRecord{sqlite3_column_int(stmt, 0),
+                            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                            roleFromString(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)))};
+    }
+    sqlite3_reset(stmt);
+    return result;
+}
+
+// Writes every row of a save; the caller owns the transaction
+bool DatabaseSQLite::sqlWritePlayerRows(int userId, const PlayerSave& state) {
+    sqlite3_stmt* st = stmts.upsertStats;
+    std::string now = getCurrentTimestamp();
+    int col = 1;
+    sqlite3_bind_int(st, col++, userId);
+    for (float v : {state.x, state.y, state.spawnX, state.spawnY}) sqlite3_bind_double(st, col++, v);
+    for (int v : {state.level, state.experience, state.maxHealth, state.health, state.maxMana, state.mana,
+                  state.strength, state.intelligence, state.gold, state.masterVolume, state.musicVolume,
+                  state.soundVolume, state.monsterVolume, state.playerMeleeVolume, state.healthPotionCharges,
+                  state.manaPotionCharges, state.upgradeScrolls}) {
+        sqlite3_bind_int(st, col++, v);
+    }
+    sqlite3_bind_text(st, col++, now.c_str(), -1, SQLITE_TRANSIENT);
+    bool ok = sqlite3_step(st) == SQLITE_DONE;
+    sqlite3_reset(st);
+    
+    st = stmts.upsertEquipment;
+    for (int slot = 0; ok && slot < 9; ++slot) {
+        sqlite3_bind_int(st, 1, userId);
+        sqlite3_bind_int(st, 2, slot);
+        sqlite3_bind_text(st, 3, state.equipNames[slot].c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(st, 4, state.equipPlus[slot]);
+        sqlite3_bind_int(st, 5, state.equipFire[slot]);
+        sqlite3_bind_int(st, 6, state.equipIce[slot]);
+        sqlite3_bind_int(st, 7, state.equipLightning[slot]);
+        sqlite3_bind_int(st, 8, state.equipPoison[slot]);
+        sqlite3_bind_int(st, 9, state.equipRarity[slot]);
+        ok = sqlite3_step(st) == SQLITE_DONE;
+        sqlite3_reset(st);
+    }
+    
+    // Inventory only stores occupied stacks, so clear the old layout first
+    if (ok) {
+        sqlite3_bind_int(stmts.deleteInventory, 1, userId);
+        ok = sqlite3_step(stmts.deleteInventory) == SQLITE_DONE;
+        sqlite3_reset(stmts.deleteInventory);
+    }
+    st = stmts.upsertInventory;
+    auto writeStack = [&](int bag, int slot, const std::string& key, int count, int rarity, int plusLevel) {
+        if (!ok || key.empty() || count <= 0) return;
+        sqlite3_bind_int(st, 1, userId);
+        sqlite3_bind_int(st, 2, bag);
+        sqlite3_bind_int(st, 3, slot);
+        sqlite3_bind_text(st, 4, key.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(st, 5, count);
+        sqlite3_bind_int(st, 6, rarity);
+        sqlite3_bind_int(st, 7, plusLevel);
+        ok = sqlite3_step(st) == SQLITE_DONE;
+        sqlite3_reset(st);
+    };
+    for (int bag = 0; bag < 2; ++bag) {
+        for (int slot = 0; slot < 9; ++slot) {
+            writeStack(bag, slot, state.invKey[bag][slot], state.invCnt[bag][slot], state.invRarity[bag][slot], state.invPlusLevel[bag][slot]);
+        }
+    }
+    for (int slot = 0; slot < 9; ++slot) {
+        writeStack(2, slot, state.resourceKey[slot], state.resourceCnt[slot], state.resourceRarity[slot], state.resourcePlusLevel[slot]);
+    }
+    return ok;
+}
+
+bool DatabaseSQLite::sqlSavePlayerState(int userId, const PlayerSave& state, std::string* outError) {
+    bool ok = sqlite3_step(stmts.begin) == SQLITE_DONE;
+    sqlite3_reset(stmts.begin);
+    if (!ok) {
+        if (outError) *outError = sqlite3_errmsg(db);
+        return false;
+    }
+    
+    // The history checkpoint rides in the same transaction; the cache only changes once it commits
+    std::vector<SaveHistoryEntry> history = getSaveHistory(userId);
+    if (sqlWritePlayerRows(userId, state) && sqlRecordSaveHistory(userId, state, history)) {
+        ok = sqlite3_step(stmts.commit) == SQLITE_DONE;
+        sqlite3_reset(stmts.commit);
+        if (ok) {
+            saveHistory[userId] = std::move(history);
+            return true;
+        }
+    }
+    if (outError) *outError = sqlite3_errmsg(db);
+    sqlite3_step(stmts.rollback);
+    sqlite3_reset(stmts.rollback);
+    return false;
+}
+
+bool DatabaseSQLite::sqlRecordSaveHistory(int userId, const PlayerSave& state, std::vector<SaveHistoryEntry>& entries) {
+    std::string hash = hashPlayerSave(state);
+    
+    // Autosaves of an unchanged player are the common case: nothing to record
+    if (!entries.empty() && entries.back().hash == hash) return true;
+    long long now = static_cast<long long>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+    
+    std::string blob = SaveFormat::encode(state);
+    sqlite3_bind_int(stmts.insertSaveBlob, 1, userId);
+    sqlite3_bind_text(stmts.insertSaveBlob, 2, hash.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_blob(stmts.insertSaveBlob, 3, blob.data(), static_cast<int>(blob.size()), SQLITE_STATIC);
+    bool ok = sqlite3_step(stmts.insertSaveBlob) == SQLITE_DONE;
+    sqlite3_reset(stmts.insertSaveBlob);
+    
+    sqlite3_bind_int(stmts.insertHistory, 1, userId);
+    sqlite3_bind_int64(stmts.insertHistory, 2, now);
+    sqlite3_bind_text(stmts.insertHistory, 3, hash.c_str(), -1, SQLITE_TRANSIENT);
+    ok = ok && sqlite3_step(stmts.insertHistory) == SQLITE_DONE;
+    sqlite3_reset(stmts.insertHistory);
+    if (!ok) return false;
+    
+    std::vector<SaveHistoryEntry> before = entries;
+    entries.push_back(SaveHistoryEntry{now, hash});
+    pruneSaveHistory(entries, now);
+    
+    // Drop pruned checkpoints, then blobs no checkpoint refers to any more
+    auto referenced = [&entries](const std::string& h) {
+        return std::any_of(entries.begin(), entries.end(), [&](const SaveHistoryEntry& e) { return e.hash == h; });
+    };
+    for (const auto& old : before) {
+        bool kept = std::any_of(entries.begin(), entries.end(), [&](const SaveHistoryEntry& e) {
+            return e.time == old.time && e.hash == old.hash;
+        });
+        if (kept) continue;
+        sqlite3_bind_int(stmts.deleteHistory, 1, userId);
+        sqlite3_bind_int64(stmts.deleteHistory, 2, old.time);
+        sqlite3_bind_text(stmts.deleteHistory, 3, old.hash.c_str(), -1, SQLITE_TRANSIENT);
+        ok = ok && sqlite3_step(stmts.deleteHistory) == SQLITE_DONE;
+        sqlite3_reset(stmts.deleteHistory);
+        if (referenced(old.hash)) continue;
+        sqlite3_bind_int(stmts.deleteSaveBlob, 1, userId);
+        sqlite3_bind_text(stmts.deleteSaveBlob, 2, old.hash.c_str(), -1, SQLITE_TRANSIENT);
+        ok = ok && sqlite3_step(stmts.deleteSaveBlob) == SQLITE_DONE;
+        sqlite3_reset(stmts.deleteSaveBlob);
+    }
+    return ok;
+}
+
+void DatabaseSQLite::sqlLoadSaveHistory(int userId, std::vector<SaveHistoryEntry>& outEntries) {
+    sqlite3_stmt* st = stmts.selectHistory;
+    sqlite3_bind_int(st, 1, userId);
+    while (sqlite3_step(st) == SQLITE_ROW) {
+        outEntries.push_back(SaveHistoryEntry{sqlite3_column_int64(st, 0), reinterpret_cast<const char*>(sqlite3_column_text(st, 1))});
+    }
+    sqlite3_reset(st);
+}
+
+bool DatabaseSQLite::sqlLoadSaveBlob(int userId, const std::string& hash, std::string& outData) {
+    sqlite3_stmt* st = stmts.selectSaveBlob;
+    sqlite3_bind_int(st, 1, userId);
+    sqlite3_bind_text(st, 2, hash.c_str(), -1, SQLITE_TRANSIENT);
+    bool found = sqlite3_step(st) == SQLITE_ROW;
+    if (found) {
+        const char* data = static_cast<const char*>(sqlite3_column_blob(st, 0));
+        outData.assign(data ? data : "", static_cast<size_t>(sqlite3_column_bytes(st, 0)));
+    }
+    sqlite3_reset(st);
+    return found;
+}
+
+std::optional<PlayerSave> DatabaseSQLite::sqlLoadPlayerState(int userId, std::string* outError) {
+    PlayerSave save;
+    sqlite3_stmt* st = stmts.selectStats;
+    sqlite3_bind_int(st, 1, userId);
+    if (sqlite3_step(st) != SQLITE_ROW) {
+        sqlite3_reset(st);
+        if (outError) *outError = "No save data found";
+        return std::nullopt;
+    }
+    int col = 0;
+    for (float* v : {&save.x, &save.y, &save.spawnX, &save.spawnY}) *v = static_cast<float>(sqlite3_column_double(st, col++));
+    for (int* v : {&save.level, &save.experience, &save.maxHealth, &save.health, &save.maxMana, &save.mana,
+                   &save.strength, &save.intelligence, &save.gold, &save.masterVolume, &save.musicVolume,
+                   &save.soundVolume, &save.monsterVolume, &save.playerMeleeVolume, &save.healthPotionCharges,
+                   &save.manaPotionCharges, &save.upgradeScrolls}) {
+        *v = sqlite3_column_int(st, col++);
+    }
+    sqlite3_reset(st);
+    
+    st = stmts.selectEquipment;
+    sqlite3_bind_int(st, 1, userId);
+    while (sqlite3_step(st) == SQLITE_ROW) {
+        int slot = sqlite3_column_int(st, 0);
+        if (slot < 0 || slot >= 9) continue;
+        const unsigned char* name = sqlite3_column_text(st, 1);
+        save.equipNames[slot] = name ? reinterpret_cast<const char*>(name) : "";
+        save.equipPlus[slot] = sqlite3_column_int(st, 2);
+        save.equipFire[slot] = sqlite3_column_int(st, 3);
+        save.equipIce[slot] = sqlite3_column_int(st, 4);
+        save.equipLightning[slot] = sqlite3_column_int(st, 5);
+        save.equipPoison[slot] = sqlite3_column_int(st, 6);
+        save.equipRarity[slot] = sqlite3_column_int(st, 7);
+    }
+    sqlite3_reset(st);
+    
+    st = stmts.selectInventory;
+    sqlite3_bind_int(st, 1, userId);
+    while (sqlite3_step(st) == SQLITE_ROW) {
+        int bag = sqlite3_column_int(st, 0);
+        int slot = sqlite3_column_int(st, 1);
+        if (slot < 0 || slot >= 9) continue;
+        std::string key = reinterpret_cast<const char*>(sqlite3_column_text(st, 2));
+        if (bag == 0 || bag == 1) {
+            save.invKey[bag][slot] = key;
+            save.invCnt[bag][slot] = sqlite3_column_int(st, 3);
+            save.invRarity[bag][slot] = sqlite3_column_int(st, 4);
+            save.invPlusLevel[bag][slot] = sqlite3_column_int(st, 5);
+        } else if (bag == 2) {
+            save.resourceKey[slot] = key;
+            save.resourceCnt[slot] = sqlite3_column_int(st, 3);
+            save.resourceRarity[slot] = sqlite3_column_int(st, 4);
+            save.resourcePlusLevel[slot] = sqlite3_column_int(st, 5);
+        }
+    }
+    sqlite3_reset(st);
+    return save;
+}
+#endif
@@ -0,0 +1,31 @@
+#include "DrawList.h"
+#include <utility>
+
+DrawList::~DrawList() {
+    clear();
+}
+
+void DrawList::clear() {
+    commands.clear();
+    for (SDL_Surface* surface : surfaces) SDL_FreeSurface(surface);
+    surfaces.clear();
+    panels.clear();
+}
+
+DrawList::Command& DrawList::push(Command::Op op, int anchor) {
+    commands.emplace_back();
+    Command& command = commands.back();
+    command.op = op;
+    command.anchor = anchor;
+    return command;
+}
+
+int DrawList::addSurface(SDL_Surface* surface) {
+    surfaces.push_back(surface);
+    return static_cast<int>(surfaces.size()) - 1;
+}
+
+int DrawList::addPanel(Panel panel) {
+    panels.push_back(std::move(panel));
+    return static_cast<int>(panels.size()) - 1;
+}
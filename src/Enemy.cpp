@@ -4,6 +4,10 @@
 #include "Projectile.h"
 #include <algorithm>
 
+namespace {
+uint64_t nextEnemySerial = 0;
+}
+
 Enemy::Enemy(float spawnX_, float spawnY_, AssetManager* assetManager, EnemyKind kind_)
     : x(spawnX_), y(spawnY_), width(128), height(128), moveSpeed(70.0f), health(200), maxHealth(200),
       currentState(EnemyState::IDLE), currentDirection(EnemyDirection::RIGHT),
@@ -18,10 +22,20 @@ Enemy::Enemy(float spawnX_, float spawnY_, AssetManager* assetManager, EnemyKind
       attackCooldownSeconds(0.8f), attackCooldownTimer(0.0f), contactDamage(10),
       spawnX(spawnX_), spawnY(spawnY_), assets(assetManager),
       kind(kind_), rangedCooldownSeconds(1.2f), rangedCooldownTimer(0.0f), rangedRange(600.0f) {
+    rng = Random::stream(RngSystem::Enemies, nextEnemySerial++);
     loadSprites(assetManager);
     setState(EnemyState::IDLE);
 }
 
+void Enemy::preloadSprites(AssetManager* assetManager) {
+    // Throwaway enemies load the sheets; the serial is put back so spawned enemies keep their streams
+    const uint64_t serial = nextEnemySerial;
+    for (int kind = 0; kind <= static_cast<int>(EnemyKind::BabyDragon); ++kind) {
+        Enemy probe(0.0f, 0.0f, assetManager, static_cast<EnemyKind>(kind));
+    }
+    nextEnemySerial = serial;
+}
+
 void Enemy::loadSprites(AssetManager* assetManager) {
     if (kind == EnemyKind::Wizard) {
         const std::string base = AssetManager::WIZARD_PATH;
@@ -794,7 +808,6 @@ void Enemy::takeDamage(int amount) {
     if (health <= 0) {
         health = 0;
         setState(EnemyState::DEAD);
-        if (deathTicksMs == 0) deathTicksMs = SDL_GetTicks();
         // Death SFX per enemy kind
         if (assets) {
             if (kind == EnemyKind::Goblin) {
@@ -1046,6 +1059,11 @@ void Enemy::update(float deltaTime, float playerX, float playerY) {
         updateAnimation(deltaTime);
         return;
     }
+    if (frozen) {
+        updateProjectiles(deltaTime); // shots already in flight keep going
+        return;
+    }
+    const float speed = moveSpeed * statusSpeedMultiplier;
 
     // Cooldowns
     if (attackCooldownTimer > 0.0f) attackCooldownTimer -= deltaTime;
@@ -1094,8 +1112,8 @@ void Enemy::update(float deltaTime, float playerX, float playerY) {
         float ddx = desiredX - x;
         float ddy = desiredY - y;
         float ddist = std::max(1.0f, sqrtf(ddx*ddx + ddy*ddy));
-        float vx = (ddx / ddist) * moveSpeed;
-        float vy = (ddy / ddist) * moveSpeed * 0.8f; // keep vertical a bit slower but closer
+        float vx = (ddx / ddist) * speed;
+        float vy = (ddy / ddist) * speed * 0.8f; // keep vertical a bit slower but closer
         x += vx * deltaTime;
         y += vy * deltaTime;
         if (currentState != EnemyState::FLYING)
@@ -1110,18 +1128,18 @@ void Enemy::update(float deltaTime, float playerX, float playerY) {
                 float dist = sqrtf(distSq);
                 
                 // Super attack (has highest priority if available and close range)
-                if (superAttackCooldown <= 0.0f && dist < 120.0f && rand() % 100 < 15) {  // 15% chance
+                if (superAttackCooldown <= 0.0f && dist < 120.0f && rng.chance(0.15f)) {  // 15% chance
                     superAttackCooldown = 8.0f;  // 8 second cooldown
                     setState(EnemyState::SUPER_ATTACKING);
                 }
                 // Jump attack (medium range, aggressive approach)
-                else if (jumpCooldown <= 0.0f && dist > 150.0f && dist < 250.0f && rand() % 100 < 25) {  // 25% chance
+                else if (jumpCooldown <= 0.0f && dist > 150.0f && dist < 250.0f && rng.chance(0.25f)) {  // 25% chance
                     jumpCooldown = 10.0f;  // 10 second cooldown
                     isJumping = true;
                     setState(EnemyState::JUMPING);
                 }
                 // Dash attack (close-medium range for gap closing)
-                else if (dashCooldown <= 0.0f && dist > 100.0f && dist < 200.0f && rand() % 100 < 30) {  // 30% chance
+                else if (dashCooldown <= 0.0f && dist > 100.0f && dist < 200.0f && rng.chance(0.30f)) {  // 30% chance
                     dashCooldown = 10.0f;  // 10 second cooldown
                     isDashing = true;
                     dashTargetX = playerX;  // Store target position
@@ -1208,7 +1226,7 @@ void Enemy::update(float deltaTime, float playerX, float playerY) {
     if (hasAdvancedAbilities && kind == EnemyKind::KoboldWarrior) {
         if (currentState == EnemyState::JUMPING && isJumping) {
             // Jump towards player with high speed
-            float jumpSpeed = moveSpeed * 2.5f;
+            float jumpSpeed = speed * 2.5f;
             float dist = std::max(1.0f, sqrtf(distSq));
             float vx = (dx / dist) * jumpSpeed;
             float vy = (dy / dist) * jumpSpeed;
@@ -1217,7 +1235,7 @@ void Enemy::update(float deltaTime, float playerX, float playerY) {
         }
         else if (currentState == EnemyState::DASHING && isDashing) {
             // Dash towards stored target position with very high speed
-            float dashSpeed = moveSpeed * 3.5f;  // Even faster dash
+            float dashSpeed = speed * 3.5f;  // Even faster dash
             float targetDx = dashTargetX - x;
             float targetDy = dashTargetY - y;
             float targetDist = std::max(1.0f, sqrtf(targetDx*targetDx + targetDy*targetDy));
@@ -1231,13 +1249,46 @@ void Enemy::update(float deltaTime, float playerX, float playerY) {
     updateAnimation(deltaTime);
 }
 
-void Enemy::update(float deltaTime, float playerX, float playerY, const std::vector<std::unique_ptr<Enemy>>& otherEnemies) {
+void Enemy::updateCoarse(float deltaTime, float playerX, float playerY) {
+    if (currentState == EnemyState::DEAD || frozen) return;
+
+    // Cooldowns keep running so the enemy is ready as usual when it comes back into view
+    if (attackCooldownTimer > 0.0f) attackCooldownTimer -= deltaTime;
+    if (rangedCooldownTimer > 0.0f) rangedCooldownTimer -= deltaTime;
+    if (hasAdvancedAbilities) {
+        if (dashCooldown > 0.0f) dashCooldown -= deltaTime;
+        if (jumpCooldown > 0.0f) jumpCooldown -= deltaTime;
+        if (superAttackCooldown > 0.0f) superAttackCooldown -= deltaTime;
+    }
+
+    float dx = playerX - x;
+    float dy = playerY - y;
+    float distSq = dx*dx + dy*dy;
+    if (!isAggroed) {
+        if (distSq > aggroRadius * aggroRadius) return;
+        isAggroed = true;
+        if (hasTransformationAbility && !isTransformed) {
+            triggerTransformation();
+            return;
+        }
+    }
+
+    // Straight at the player; attacks and spreading out wait for a full update
+    if (distSq > attackRange * attackRange) {
+        const float speed = moveSpeed * statusSpeedMultiplier;
+        const float dist = std::max(1.0f, sqrtf(distSq));
+        x += (dx / dist) * speed * deltaTime;
+        y += (dy / dist) * speed * 0.8f * deltaTime;
+    }
+}
+
+void Enemy::update(float deltaTime, float playerX, float playerY, const std::vector<const Enemy*>& nearbyEnemies) {
     // Start with regular update logic
     update(deltaTime, playerX, playerY);
     
     // Apply enemy-to-enemy collision avoidance when aggroed (both moving and attacking)
-    if (isAggroed && (currentState == EnemyState::FLYING || currentState == EnemyState::ATTACKING)) {
-        constexpr float COLLISION_RADIUS = 120.0f; // Much larger collision area for spreading
+    if (isAggroed && !frozen && (currentState == EnemyState::FLYING || currentState == EnemyState::ATTACKING)) {
+        constexpr float COLLISION_RADIUS = SEPARATION_RADIUS;
         constexpr float AVOIDANCE_FORCE = 400.0f;  // Very strong separation force
         
         float separationX = 0.0f;
@@ -1245,8 +1296,8 @@ void Enemy::update(float deltaTime, float playerX, float playerY, const std::vec
         int nearbyCount = 0;
         
         // Check collision with other enemies
-        for (const auto& other : otherEnemies) {
-            if (!other || other.get() == this || other->isDead()) continue;
+        for (const Enemy* other : nearbyEnemies) {
+            if (!other || other == this || other->isDead()) continue;
             
             float dx = x - other->getX();
             float dy = y - other->getY();
@@ -1345,10 +1396,10 @@ void Enemy::updateAnimation(float deltaTime) {
     }
 }
 
-void Enemy::render(Renderer* renderer) const {
+void Enemy::render(Renderer* renderer, const EntityTransform& transform) const {
     if (!renderer || !currentSpriteSheet || !currentSpriteSheet->getTexture() || !currentSpriteSheet->getTexture()->getTexture()) return;
 
-    SDL_Rect src = currentSpriteSheet->getFrameRect(currentFrame);
+    SDL_Rect src = currentSpriteSheet->getFrameRect(transform.frame);
 
     // Destination in screen space with zoom support
     float scale = renderScale;
@@ -1363,8 +1414,8 @@ void Enemy::render(Renderer* renderer) const {
     };
     int halfW = static_cast<int>(src.w * scale / 2.0f);
     int halfH = static_cast<int>(src.h * scale / 2.0f);
-    SDL_Point tl = scaledEdge(static_cast<int>(x) - halfW, static_cast<int>(y) - halfH);
-    SDL_Point br = scaledEdge(static_cast<int>(x) + halfW, static_cast<int>(y) + halfH);
+    SDL_Point tl = scaledEdge(static_cast<int>(transform.x) - halfW, static_cast<int>(transform.y) - halfH);
+    SDL_Point br = scaledEdge(static_cast<int>(transform.x) + halfW, static_cast<int>(transform.y) + halfH);
     dst.x = tl.x;
     dst.y = tl.y;
     dst.w = std::max(1, br.x - tl.x);
@@ -1372,7 +1423,7 @@ void Enemy::render(Renderer* renderer) const {
 
     SDL_Texture* tex = currentSpriteSheet->getTexture()->getTexture();
     // No color tinting - use original sprite colors for all tiers
-    SDL_SetTextureColorMod(tex, 255, 255, 255);
+    renderer->setTextureColorMod(tex, 255, 255, 255);
     
     // Check if we need to flip the sprite for enemies with single-direction sprites
     if (usesSpriteFlipping) {
@@ -1386,16 +1437,16 @@ void Enemy::render(Renderer* renderer) const {
         }
         
         if (shouldFlip) {
-            SDL_RenderCopyEx(renderer->getSDLRenderer(), tex, &src, &dst, 0.0, nullptr, SDL_FLIP_HORIZONTAL);
+            renderer->copyEx(tex, &src, &dst, 0.0, nullptr, SDL_FLIP_HORIZONTAL);
         } else {
-            SDL_RenderCopy(renderer->getSDLRenderer(), tex, &src, &dst);
+            renderer->copy(tex, &src, &dst);
         }
     } else {
-        SDL_RenderCopy(renderer->getSDLRenderer(), tex, &src, &dst);
+        renderer->copy(tex, &src, &dst);
     }
     
     // Reset to white to avoid affecting other draws of same texture
-    SDL_SetTextureColorMod(tex, 255, 255, 255);
+    renderer->setTextureColorMod(tex, 255, 255, 255);
 
     // Tiny HP bar above head for non-elite (minions/common). Hide on death.
     if (maxHealth > 0 && health > 0 && currentState != EnemyState::DEAD &&
@@ -1407,13 +1458,13 @@ void Enemy::render(Renderer* renderer) const {
         const int barY = dst.y - (barH + 3);
         SDL_Rect bg{ barX, barY, barW, barH };
         SDL_Rect fg{ barX, barY, static_cast<int>(barW * ratio), barH };
-        SDL_SetRenderDrawBlendMode(renderer->getSDLRenderer(), SDL_BLENDMODE_BLEND);
-        SDL_SetRenderDrawColor(renderer->getSDLRenderer(), 0, 0, 0, 180);
-        SDL_RenderFillRect(renderer->getSDLRenderer(), &bg);
-        SDL_SetRenderDrawColor(renderer->getSDLRenderer(), 220, 0, 0, 220);
-        SDL_RenderFillRect(renderer->getSDLRenderer(), &fg);
-        SDL_SetRenderDrawColor(renderer->getSDLRenderer(), 255, 255, 255, 220);
-        SDL_RenderDrawRect(renderer->getSDLRenderer(), &bg);
+        renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+        renderer->setDrawColor(0, 0, 0, 180);
+        renderer->fillRect(&bg);
+        renderer->setDrawColor(220, 0, 0, 220);
+        renderer->fillRect(&fg);
+        renderer->setDrawColor(255, 255, 255, 220);
+        renderer->drawRect(&bg);
     }
 }
 
@@ -1428,7 +1479,7 @@ void Enemy::renderProjectiles(Renderer* renderer) const {
 
 void Enemy::updateProjectiles(float deltaTime) {
     for (auto& p : projectiles) {
-        if (p) p->update(deltaTime);
+        if (p) p->update(deltaTime, world);
     }
     projectiles.erase(std::remove_if(projectiles.begin(), projectiles.end(), [](const std::unique_ptr<Projectile>& p){ return !p || !p->isActive(); }), projectiles.end());
 }
@@ -11,19 +11,38 @@
 #include "AudioManager.h"
 #include "Object.h"
 #include "DatabaseSQLite.h"
+#include "SaveWriter.h"
 #include "LootGenerator.h"
 #include "ItemSystem.h"
 #include "SpellSystem.h"
+#include "Random.h"
+#include "InputReplay.h"
+#include "SaveFormat.h"
 #include <iostream>
-#include <random>
+#include <fstream>
+#include <algorithm>
 
-Game::Game() : window(nullptr), sdlRenderer(nullptr), isRunning(false), isPaused(false), 
+Game::Game(const GameLaunchOptions& options) : window(nullptr), sdlRenderer(nullptr), isRunning(false), isPaused(false), 
                lastFrameTime(0), accumulator(0.0f), frameTime(0), currentFPS(0.0f), averageFPS(0.0f) {
+    launchOptions = options;
+    mainThreadId = std::this_thread::get_id();
+    if (!launchOptions.replayPath.empty()) {
+        // The recording's seed has to be in place before the world is generated
+        std::string error;
+        inputPlayer = InputPlayer::open(launchOptions.replayPath, &error);
+        if (!inputPlayer) throw std::runtime_error("Cannot replay " + launchOptions.replayPath + ": " + error);
+        Random::setSeed(inputPlayer->getSession().seed);
+    }
     initializeSystems();
+    if (inputPlayer) startReplay();
 }
 
 void Game::enterUnderworld() {
     if (!world || !assetManager || !player) return;
+    if (std::this_thread::get_id() != mainThreadId) {
+        pendingWorldTransition = WorldTransition::ENTER_UNDERWORLD;
+        return;
+    }
     std::cout << "=== ENTERING UNDERWORLD ===" << std::endl;
     inUnderworld = true;
     // Load the provided TMX underworld map
@@ -58,6 +77,10 @@ void Game::enterUnderworld() {
 
 void Game::exitUnderworld() {
     if (!world || !assetManager || !player) return;
+    if (std::this_thread::get_id() != mainThreadId) {
+        pendingWorldTransition = WorldTransition::EXIT_UNDERWORLD;
+        return;
+    }
     std::cout << "=== EXITING UNDERWORLD ===" << std::endl;
     inUnderworld = false;
     // Reset to procedural world generation (the default state)
@@ -112,8 +135,18 @@ float Game::getWorldHeight() const {
     return 0.0f;
 }
 
+Item* Game::getAnvilTargetItem() const {
+    ItemSystem* itemSystem = player ? player->getItemSystem() : nullptr;
+    return itemSystem ? itemSystem->getItem(anvilTargetItem) : nullptr;
+}
+
 Game::~Game() {
+    simRunning = false;
+    if (simThread.joinable()) simThread.join();
+    if (inputRecorder) inputRecorder->finish(inputManager->getTick());
     saveCurrentUserState();
+    // Flush-on-exit barrier: blocks until the final snapshot is on disk
+    saveWriter.reset();
     cleanup();
 }
 
@@ -135,8 +168,9 @@ void Game::initializeSystems() {
     }
 
     // Create renderer
-    sdlRenderer = SDL_CreateRenderer(window, -1, 
-        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+    if (!(inputPlayer && launchOptions.unthrottled)) rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+    sdlRenderer = SDL_CreateRenderer(window, -1, rendererFlags);
     // Ensure fullscreen is applied (some platforms ignore flag at creation)
     SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN_DESKTOP);
     
@@ -153,6 +187,11 @@ void Game::initializeSystems() {
         SDL_free((void*)basePath);
     }
     database->initialize(dataRootPath + "/pixlegends.db");
+#ifdef DEBUG
+    // Readable saves while debugging; release builds use the compact binary format
+    database->setSaveFileFormat(SaveFileFormat::JSON);
+#endif
+    saveWriter = std::make_unique<SaveWriter>(*database);
     // Preload remembered login if any
     {
         auto remember = database->loadRememberState();
@@ -188,10 +227,12 @@ void Game::initializeSystems() {
     
     // Preload assets BEFORE creating World
     assetManager->preloadAssets();
+    // Enemies and bosses spawn on the simulation thread, which cannot create textures
+    Enemy::preloadSprites(assetManager.get());
     
     // Create World after assets are loaded
     world = std::make_unique<World>(assetManager.get());
-    uiSystem = std::make_unique<UISystem>(sdlRenderer);
+    uiSystem = std::make_unique<UISystem>(renderer.get());
     uiSystem->setAssetManager(assetManager.get());
     audioManager = std::make_unique<AudioManager>();
     if (audioManager) {
@@ -213,7 +254,7 @@ void Game::initializeSystems() {
         // Fire shield looped SFX
         audioManager->loadSound("fire_shield_loop", "assets/Sound/Spells/fire_sheild_sound.wav");
         // Load themes once; use distinct keys so persistence matches names
-        audioManager->loadMusic("main_theme", "assets/Sound/Music/main_theme.wav");
+        audioManager->loadMusic("main_theme", "assets/Sound/Music/main_theme.ogg");
         audioManager->loadMusic("fast_tempo", "assets/Sound/Music/fast_tempo_theme.wav");
         audioManager->loadMusic("boss_music", "assets/Sound/Music/boss_music.wav");
         // Goblin SFX
@@ -231,6 +272,7 @@ void Game::initializeSystems() {
             player->applySaveState(*save);
             std::cout << "Loaded save data for auto-logged user (level " << save->level << ")" << std::endl;
         }
+        loadKeyBindings(loggedInUserId);
         // Load audio settings
         if (audioManager) {
             int m=100, mu=100, s=100, mon=100, pl=100;
@@ -509,6 +551,13 @@ void Game::initializeSystems() {
 }
 
 void Game::run() {
+    // An unthrottled replay steps one tick per frame on this thread instead, so its frame log measures
+    // the same work on every run
+    const bool lockstep = inputPlayer && launchOptions.unthrottled;
+    publishRenderSnapshot(); // something to draw before the first tick
+    simRunning = true;
+    if (!lockstep) simThread = std::thread(&Game::runSimulation, this);
+
     while (isRunning) {
         Uint32 currentTime = SDL_GetTicks();
         float deltaTime = (currentTime - lastFrameTime) / 1000.0f;
@@ -517,31 +566,304 @@ void Game::run() {
         // Cap delta time to prevent spiral of death
         if (deltaTime > 0.1f) deltaTime = 0.1f;
         
-        accumulator += deltaTime;
-        
-        // Fixed timestep for physics/updates
-        while (accumulator >= TARGET_FRAME_TIME) {
-            if (!isPaused) {
-                update(TARGET_FRAME_TIME);
-            }
-            accumulator -= TARGET_FRAME_TIME;
+        if (lockstep) {
+            std::lock_guard<std::mutex> lock(simMutex);
+            stepSimulation();
         }
+
+        // Carry out what the simulation handed over: sounds, textures it could not create
+        if (audioManager) {
+            audioManager->pumpCommands();
+            audioManager->update(deltaTime);
+        }
+        assetManager->processPendingLoads();
         
-        // Handle events
+        // A world transition swaps the world out from under the simulation, so it waits for the
+        // tick in progress; nothing else on this thread touches game state
+        WorldTransition transition = pendingWorldTransition.exchange(WorldTransition::NONE);
+        if (transition != WorldTransition::NONE) {
+            std::lock_guard<std::mutex> lock(simMutex);
+            if (transition == WorldTransition::ENTER_UNDERWORLD) enterUnderworld();
+            else exitUnderworld();
+        }
+        if (fullscreenToggleRequested.exchange(false)) {
+            SDL_SetWindowFullscreen(window, windowFullscreen ? 0 : SDL_WINDOW_FULLSCREEN_DESKTOP);
+        }
+        Uint32 winFlags = SDL_GetWindowFlags(window);
+        windowFullscreen = (winFlags & SDL_WINDOW_FULLSCREEN) || (winFlags & SDL_WINDOW_FULLSCREEN_DESKTOP);
         handleEvents();
-        
         // Render (variable timestep for smooth rendering)
         render();
+        // Presenting may block on vsync; the simulation keeps ticking meanwhile
+        renderer->present();
         
         // Update performance metrics
         updatePerformanceMetrics();
         
+        if (inputPlayer) {
+            Uint64 now = SDL_GetPerformanceCounter();
+            replayFrameMs.push_back(static_cast<float>((now - replayFrameCounter) * 1000.0 / SDL_GetPerformanceFrequency()));
+            replayFrameCounter = now;
+        }
+        
         // Cap frame rate
         frameTime = SDL_GetTicks() - currentTime;
-        if (frameTime < (1000 / TARGET_FPS)) {
+        if (frameTime < (1000 / TARGET_FPS) && !lockstep) {
             SDL_Delay((1000 / TARGET_FPS) - frameTime);
         }
     }
+
+    simRunning = false;
+    if (simThread.joinable()) simThread.join();
+    if (inputPlayer && inputPlayer->isFinished()) finishReplay();
+}
+
+void Game::runSimulation() {
+    const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+    Uint64 previous = SDL_GetPerformanceCounter();
+    while (simRunning) {
+        const Uint64 now = SDL_GetPerformanceCounter();
+        float deltaTime = static_cast<float>((now - previous) / frequency);
+        previous = now;
+        if (deltaTime > 0.1f) deltaTime = 0.1f;
+        accumulator += deltaTime;
+
+        int ticks = 0;
+        while (accumulator >= SIM_TICK_TIME && ticks < MAX_SIM_TICKS_PER_FRAME) {
+            bool more;
+            {
+                std::lock_guard<std::mutex> lock(simMutex);
+                more = stepSimulation();
+            }
+            if (!more) {
+                simRunning = false;
+                return;
+            }
+            accumulator -= SIM_TICK_TIME;
+            ticks++;
+        }
+        // Past the budget the simulation falls behind instead of running ticks back to back
+        if (accumulator > SIM_TICK_TIME) accumulator = SIM_TICK_TIME;
+
+        // Sleep until the next tick is due
+        const Uint32 waitMs = static_cast<Uint32>((SIM_TICK_TIME - accumulator) * 1000.0f);
+        if (waitMs > 0) SDL_Delay(waitMs);
+    }
+}
+
+bool Game::stepSimulation() {
+    // Each tick consumes the input recorded so far and publishes what render() will draw
+    if (!launchOptions.recordPath.empty() && !inputRecorder && !loginScreenActive) beginRecording();
+    const uint32_t inputTick = inputManager->getTick();
+    if (inputPlayer && !inputPlayer->feed(inputTick - replayStartTick, *inputManager, replayedActions)) {
+        isRunning = false;
+        return false;
+    }
+    // Window events first, so the input they record is applied this tick
+    SimCommand command;
+    while (simCommands.pop(command)) applySimCommand(command);
+    inputManager->applyPendingInput();
+
+    // Gameplay the UI and hotkeys asked for is recorded here, where it is applied, so a replay
+    // repeats it on the same tick; a replay applies only what was recorded
+    if (inputPlayer) {
+        uiCommands.clear();
+        for (ReplayAction& action : replayedActions) {
+            if (action.type == static_cast<uint8_t>(SimCommand::Type::EVENT) ||
+                action.type > static_cast<uint8_t>(SimCommand::Type::EXIT_UNDERWORLD)) continue; // not from this build
+            SimCommand replayed;
+            replayed.type = static_cast<SimCommand::Type>(action.type);
+            replayed.slot = action.slot;
+            replayed.item = ItemHandle{action.item};
+            replayed.key = std::move(action.key);
+            uiCommands.push_back(std::move(replayed));
+        }
+        replayedActions.clear();
+    }
+    if (inputRecorder) {
+        recordedActions.clear();
+        for (const SimCommand& requested : uiCommands) {
+            recordedActions.push_back(ReplayActionEntry{inputTick, ReplayAction{static_cast<uint8_t>(requested.type),
+                                                                                requested.slot, requested.item.value, requested.key}});
+        }
+        inputRecorder->record(inputManager->takeJournal(), recordedActions);
+    }
+    for (const SimCommand& requested : uiCommands) applySimCommand(requested);
+    uiCommands.clear();
+    if (!isPaused) {
+        update(SIM_TICK_TIME);
+    }
+    publishRenderSnapshot();
+    return true;
+}
+
+void Game::queueSimCommand(const SimCommand& command) {
+    uiCommands.push_back(command);
+}
+
+void Game::applySimCommand(const SimCommand& command) {
+    if (command.type == SimCommand::Type::EVENT) {
+        handleEvent(command.event);
+        return;
+    }
+    if (!player) return;
+    ItemSystem* itemSystem = player->getItemSystem();
+    // The anvil's fallback target; it has no slot selected right after opening
+    const bool equipSlotValid = command.slot >= 0 && command.slot < static_cast<int>(Player::EquipmentSlot::COUNT);
+    switch (command.type) {
+        case SimCommand::Type::EVENT:
+            break; // handled above
+        case SimCommand::Type::RESPAWN: {
+            if (!player->isDead()) break;
+            // Reset world enemies and player
+            if (world) {
+                world->getStatusEffects().clear();
+                world->resetEnemiesToSpawn();
+            }
+            player->respawn(player->getSpawnX(), player->getSpawnY());
+            // After respawn, enforce minion cap by player level to avoid sudden overpopulation
+            if (world) {
+                int level = player->getLevel();
+                const int caps[10] = {5,8,11,14,17,20,23,26,28,30};
+                int maxGoblins = (level <= 0 ? 5 : (level >= 10 ? 30 : caps[level-1]));
+                // Gather live goblin indices
+                auto& enemies = world->getEnemies();
+                int alive = 0;
+                for (const auto& e : enemies) {
+                    if (e && std::string(e->getDisplayName()) == std::string("Goblin") && !e->isDead()) alive++;
+                }
+                if (alive > maxGoblins) {
+                    // Despawn extras starting from farthest from player
+                    struct GRef { size_t idx; float dist2; };
+                    std::vector<GRef> gobRefs; gobRefs.reserve(enemies.size());
+                    float pcx = player->getX(); float pcy = player->getY();
+                    for (size_t i = 0; i < enemies.size(); ++i) {
+                        auto& e = enemies[i];
+                        if (!e || std::string(e->getDisplayName()) != std::string("Goblin") || e->isDead()) continue;
+                        float dx = e->getX() - pcx; float dy = e->getY() - pcy; gobRefs.push_back({i, dx*dx + dy*dy});
+                    }
+                    std::sort(gobRefs.begin(), gobRefs.end(), [](const GRef& a, const GRef& b){ return a.dist2 > b.dist2; });
+                    int toRemove = alive - maxGoblins;
+                    for (int k = 0; k < toRemove && k < static_cast<int>(gobRefs.size()); ++k) {
+                        world->getStatusEffects().release(enemies[gobRefs[k].idx].get());
+                        enemies[gobRefs[k].idx].reset();
+                    }
+                    world->compactEnemies();
+                }
+            }
+            break;
+        }
+        case SimCommand::Type::EQUIP:
+        case SimCommand::Type::SWAP_EQUIP: {
+            if (!itemSystem) break;
+            const auto& itemInventory = itemSystem->getItemInventory();
+            if (command.slot < 0 || command.slot >= static_cast<int>(itemInventory.size()) || itemInventory[command.slot].isEmpty()) break;
+            Item* item = itemInventory[command.slot].item;
+            int equipSlot = static_cast<int>(item->equipmentType);
+            if (command.type == SimCommand::Type::SWAP_EQUIP) {
+                // Ordered swap: unequip first, then equip
+                if (equipSlot < 0 || equipSlot >= 9) break;
+                const auto& equipSlots = itemSystem->getEquipmentSlots();
+                if (equipSlot < static_cast<int>(equipSlots.size()) && !equipSlots[equipSlot].isEmpty()) {
+                    if (itemSystem->unequipItem(equipSlot)) {
+                        // Also clear the Player equipment array to stay synchronized
+                        player->clearEquipmentSlot(static_cast<Player::EquipmentSlot>(equipSlot));
+                    }
+                }
+            }
+            if (itemSystem->equipItem(command.slot)) {
+                // Sync the Player equipment array with the newly equipped item
+                const auto& equipSlots = itemSystem->getEquipmentSlots();
+                if (equipSlot >= 0 && equipSlot < static_cast<int>(equipSlots.size()) && !equipSlots[equipSlot].isEmpty()) {
+                    player->syncEquipmentFromItem(static_cast<Player::EquipmentSlot>(equipSlot), equipSlots[equipSlot].item);
+                }
+            }
+            break;
+        }
+        case SimCommand::Type::UNEQUIP:
+            // Move to inventory using ItemSystem
+            if (itemSystem && equipSlotValid && itemSystem->unequipItem(command.slot)) {
+                // Also clear the Player equipment array to stay synchronized
+                player->clearEquipmentSlot(static_cast<Player::EquipmentSlot>(command.slot));
+            }
+            break;
+        case SimCommand::Type::CONSUME_SCROLL:
+            if (command.key == "upgrade_scroll") {
+                player->consumeUpgradeScroll();
+            } else {
+                player->consumeElementScroll(command.key);
+            }
+            break;
+        case SimCommand::Type::ANVIL_UPGRADE: {
+            auto chanceForNext = [](int currentPlus) -> float {
+                static const float table[31] = {
+                    0.0f, 100.0f, 95.0f, 90.0f, 80.0f, 75.0f, 70.0f, 65.0f, 55.0f, 50.0f,
+                    45.0f, 40.0f, 35.0f, 30.0f, 28.0f, 25.0f, 20.0f, 18.0f, 15.0f, 13.0f,
+                    12.0f, 10.0f, 8.0f, 7.0f, 6.0f, 5.0f, 4.5f, 4.0f, 3.5f, 3.0f, 2.5f
+                }; // index is next level; we pass current+1 later
+                int next = currentPlus + 1; if (next < 1) next = 1; if (next > 30) next = 30; return table[next];
+            };
+            static RandomStream rng = Random::stream(RngSystem::Crafting);
+            // Upgrade the chosen item instance, or fall back to the equipment slot
+            Item* targetItem = itemSystem ? itemSystem->getItem(command.item) : nullptr;
+            if (!targetItem && !equipSlotValid) break;
+            int currentPlusLevel = targetItem ? targetItem->plusLevel
+                                              : player->getEquipment(static_cast<Player::EquipmentSlot>(command.slot)).plusLevel;
+            if (currentPlusLevel >= 30) break;
+            float roll = rng.nextFloat(0.0f, 100.0f);
+            bool success = roll <= chanceForNext(currentPlusLevel);
+            if (success) {
+                if (targetItem) {
+                    player->upgradeSpecificItem(targetItem, 1);
+                } else {
+                    player->upgradeEquipment(static_cast<Player::EquipmentSlot>(command.slot), 1);
+                }
+            }
+            // Not revealed yet: the anvil shows its suspense sweep first
+            anvilLastSuccess = success;
+            anvilStagedScrollKey.clear();
+            Object::setMagicAnvilPulse(3.2f);
+            if (audioManager) audioManager->playSound("upgrade_sound");
+            break;
+        }
+        case SimCommand::Type::ANVIL_ENCHANT:
+            // Use specific item if available, otherwise fall back to slot
+            if (Item* targetItem = itemSystem ? itemSystem->getItem(command.item) : nullptr) {
+                player->enchantSpecificItem(targetItem, command.key, 1);
+            } else if (equipSlotValid) {
+                player->enchantEquipment(static_cast<Player::EquipmentSlot>(command.slot), command.key, 1);
+            }
+            Object::setMagicAnvilPulse(3.2f);
+            break;
+        case SimCommand::Type::CLEAR_LOOT_NOTIFICATION:
+            player->clearLootNotification();
+            break;
+        case SimCommand::Type::TOGGLE_PAUSE:
+            isPaused = !isPaused;
+            break;
+        case SimCommand::Type::TOGGLE_INFINITE_POTIONS:
+            setInfinitePotions(!getInfinitePotions());
+            std::cout << "Infinite potions: " << (getInfinitePotions() ? "ON" : "OFF") << std::endl;
+            break;
+        case SimCommand::Type::GRANT_TEST_SCROLLS:
+            player->addItemToInventory("upgrade_scroll", 50);
+            player->addItemToInventory("fire_scroll", 50);
+            player->addItemToInventory("water_scroll", 50);
+            player->addItemToInventory("poison_scroll", 50);
+            break;
+        case SimCommand::Type::ENTER_UNDERWORLD:
+            if (!inUnderworld) {
+                enterUnderworld();
+                std::cout << "DEBUG: Entered underworld" << std::endl;
+            }
+            break;
+        case SimCommand::Type::EXIT_UNDERWORLD:
+            if (inUnderworld) {
+                exitUnderworld();
+                std::cout << "DEBUG: Exited underworld" << std::endl;
+            }
+            break;
+    }
 }
 
 void Game::update(float deltaTime) {
@@ -600,7 +922,9 @@ void Game::update(float deltaTime) {
                     // Wave size scales mildly with level and alternates per waveId
                     int base = 2 + (level / 3); // grows slowly
                     int variance = (waveId % 3); // 0..2
-                    int packSize = std::min(8, base + variance + static_cast<int>(SDL_GetTicks() % 3));
+                    // Spawner stream keyed by wave so replays place the same packs
+                    RandomStream waveRandom = Random::stream(RngSystem::Enemies, ~0ull, static_cast<uint64_t>(waveId));
+                    int packSize = std::min(8, base + variance + waveRandom.nextInt(0, 2));
                     int ts = world->getTileSize();
                     // Spawn NEAR the player within a ring to make it noticeable
                     int playerTileX = static_cast<int>(player->getX() / ts);
@@ -613,7 +937,7 @@ void Game::update(float deltaTime) {
                         int tries = 0; bool placed = false;
                         while (tries++ < 80 && !placed) {
                             // Pick a random offset in an annulus around the player
-                            Uint32 rseed = SDL_GetTicks() + i * 1337 + tries * 31;
+                            Uint32 rseed = static_cast<Uint32>(waveRandom.nextU64() >> 32);
                             int dx = static_cast<int>(static_cast<int>(rseed % (radiusTilesMax*2+1)) - radiusTilesMax);
                             int dy = static_cast<int>(static_cast<int>((rseed/3) % (radiusTilesMax*2+1)) - radiusTilesMax);
                             int dist2 = dx*dx + dy*dy;
@@ -676,7 +1000,7 @@ void Game::update(float deltaTime) {
                 float distSq = dx*dx + dy*dy;
                 // Respect 2s delay before beginning magnet
                 bool magnetActive = true;
-                Uint32 now = SDL_GetTicks();
+                Uint32 now = getSimTimeMs();
                 float sinceSpawnSec = (now - o->getSpawnTicks()) / 1000.0f;
                 if (sinceSpawnSec < o->getMagnetDelaySeconds()) magnetActive = false;
 
@@ -773,6 +1097,9 @@ void Game::update(float deltaTime) {
                             if (SDL_IntersectRect(&hitbox, &eRect, &inter)) {
                                 if (player->consumeMeleeHitIfActive()) {
                                     enemyPtr->takeDamage(player->rollMeleeDamageForHit());
+                                    if (SpellSystem* spells = player->getSpellSystem()) {
+                                        spells->applyBurningStrike(inter.x + inter.w * 0.5f, inter.y + inter.h * 0.5f);
+                                    }
                                 }
                                 break;
                             }
@@ -802,19 +1129,19 @@ void Game::update(float deltaTime) {
                         player->takeDamage(enemyPtr->getContactDamage());
                         if (audioManager && !playedPlayerMeleeSfx) { 
                             // Use goblin melee when minion; otherwise keep existing
+                            const float sx = eRect.x + eRect.w * 0.5f, sy = eRect.y + eRect.h * 0.5f;
                             if (enemyPtr->getKind() == EnemyKind::Goblin) {
-                                audioManager->playSound("goblin_melee");
+                                audioManager->playSoundAt("goblin_melee", sx, sy);
                             } else {
-                                audioManager->playSound("boss_melee");
+                                audioManager->playSoundAt("boss_melee", sx, sy);
                             }
                             audioManager->startMusicDuck(0.35f, 0.5f);
                         }
                         enemyPtr->consumeAttackCooldown();
                         if (player->isDead()) {
                             // Reset enemies to idle spawn when player dies
-                            for (auto& e2 : enemies) {
-                                if (e2) e2->resetToSpawn();
-                            }
+                            world->getStatusEffects().clear();
+                            world->resetEnemiesToSpawn();
                         }
                     }
                 }
@@ -850,7 +1177,7 @@ void Game::update(float deltaTime) {
                     if (deepOverlap && boss->isAttackReady()) {
                         player->takeDamage(boss->getContactDamage());
                         if (audioManager) {
-                            audioManager->playSound("boss_melee");
+                            audioManager->playSoundAt("boss_melee", bossRect.x + bossRect.w * 0.5f, bossRect.y + bossRect.h * 0.5f);
                             audioManager->startMusicDuck(0.35f, 0.5f);
                         }
                         boss->consumeAttackCooldown();
@@ -874,23 +1201,17 @@ void Game::update(float deltaTime) {
             }
 
             // 2b) Enhanced loot drops from dead enemies (one-time) + corpse despawn
+            bool despawnedEnemies = false;
             for (auto& enemyPtr : enemies) {
                 if (!enemyPtr) continue;
                 if (enemyPtr->isDead() && !enemyPtr->isLootDropped()) {
                     // Generate enhanced loot using the new system
                     int enemyLevel = 1; // Base level for now, could be based on area/zone later
-                    float rarityBonus = 0.0f;
-                    
-                    // Apply rarity bonus based on enemy pack rarity
-                    switch (enemyPtr->getPackRarity()) {
-                        case PackRarity::Trash:   rarityBonus = -0.1f; break;
-                        case PackRarity::Common:  rarityBonus = 0.0f; break;
-                        case PackRarity::Magic:   rarityBonus = 0.2f; break;
-                        case PackRarity::Elite:   rarityBonus = 0.4f; break;
-                    }
                     
-                    // Generate loot using the new system
-                    auto lootItems = LootGenerator::getInstance().generateEnemyLoot(enemyLevel, rarityBonus);
+                    // Tables are compiled per pack rarity; the buffer is reused across kills
+                    static std::vector<Loot> lootItems;
+                    lootItems.clear();
+                    LootGenerator::getInstance().generateEnemyLoot(enemyPtr->getRandom(), enemyLevel, enemyPtr->getPackRarity(), lootItems);
                     
                     if (world) {
                         int ts = world->getTileSize();
@@ -945,12 +1266,12 @@ void Game::update(float deltaTime) {
                                 lootObj->setTileSizeHint(ts);
                                 
                                 // Randomize position slightly to avoid overlap
-                                float offsetX = (rand() % 21 - 10) * 0.5f; // -5 to +5 pixels
-                                float offsetY = (rand() % 21 - 10) * 0.5f;
+                                float offsetX = enemyPtr->getRandom().nextInt(-10, 10) * 0.5f; // -5 to +5 pixels
+                                float offsetY = enemyPtr->getRandom().nextInt(-10, 10) * 0.5f;
                                 lootObj->setPositionPixels(tx * ts + ts * 0.5f - 8.0f + offsetX, 
                                                           ty * ts + ts * 0.5f - 8.0f + offsetY);
                                 lootObj->setCollectible(true);
-                                lootObj->setSpawnTicks(SDL_GetTicks());
+                                lootObj->setSpawnTicks(getSimTimeMs());
                                 lootObj->setMagnetDelaySeconds(1.5f);
                                 
                                 // Add the loot data to the object
@@ -972,10 +1293,8 @@ void Game::update(float deltaTime) {
                         Uint32 nowTicks = SDL_GetTicks();
                         const Uint32 cooldownMs = 200; // play at most once per 200ms
                         if (nowTicks - lastGoblinDeathSoundTicks >= cooldownMs) {
-                            int prevSV = audioManager->getSoundVolume();
-                            audioManager->setSoundVolume(std::max(0, prevSV * 10 / 100));
-                            audioManager->playSound("goblin_death");
-                            audioManager->setSoundVolume(prevSV);
+                            audioManager->playSoundAt("goblin_death", enemyPtr->getX() + enemyPtr->getWidth() * 0.5f,
+                                                      enemyPtr->getY() + enemyPtr->getHeight() * 0.5f);
                             lastGoblinDeathSoundTicks = nowTicks;
                         }
                     }
@@ -983,14 +1302,17 @@ void Game::update(float deltaTime) {
                 }
                 // Despawn dead enemies after 60 seconds
                 if (enemyPtr->isDead()) {
-                    if (enemyPtr->isDespawnReady(SDL_GetTicks(), 60000)) {
+                    if (enemyPtr->getDeathTicksMs() == 0) enemyPtr->setDeathTicksMs(std::max<Uint32>(1, getSimTimeMs()));
+                    if (enemyPtr->isDespawnReady(getSimTimeMs(), 60000)) {
                         // Replace with nullptr; cleanup after loop
+                        world->getStatusEffects().release(enemyPtr.get());
                         enemyPtr.reset();
+                        despawnedEnemies = true;
                     }
                 }
             }
             // Remove nulls
-            enemies.erase(std::remove_if(enemies.begin(), enemies.end(), [](const std::unique_ptr<Enemy>& e){ return !e; }), enemies.end());
+            if (despawnedEnemies) world->compactEnemies();
         }
     }
 
@@ -1001,64 +1323,108 @@ void Game::update(float deltaTime) {
         uiSystem->update(deltaTime);
     }
     
-    // Update audio
-    if (audioManager) {
-        audioManager->update(deltaTime);
-    }
-    
     // Update input states (do this last so pressed states are preserved for the current frame)
     inputManager->update();
 
     // Periodically autosave basic player state (e.g., every ~5 seconds via accumulator of frame time)
     static float autosaveTimer = 0.0f;
     autosaveTimer += deltaTime;
-    if (autosaveTimer >= 5.0f && database && player) {
+    if (autosaveTimer >= 5.0f && player && !inputPlayer) {
         autosaveTimer = 0.0f;
-        // Save to the default user (id 1) if exists
-        auto user = database->getUserById(1);
-        if (user) {
-            PlayerSave s = player->makeSaveState();
-            database->savePlayerState(user->userId, s);
-        }
+        // Only enqueues for the account cached at login; the database is never touched from here
+        saveCurrentUserState();
     }
 }
 
+void Game::publishRenderSnapshot() {
+    RenderSnapshot& snapshot = renderSnapshots.beginPublish(++simulationTick);
+    if (player) snapshot.player = player->getTransform();
+    if (world) world->captureSnapshot(snapshot);
+    renderer->beginRecording(snapshot.draw);
+    recordFrame(snapshot);
+    renderer->endRecording();
+    renderSnapshots.endPublish();
+    lastTickCounter = SDL_GetPerformanceCounter();
+}
+
+void Game::cameraFor(const EntityTransform& focus, int& cameraX, int& cameraY) const {
+    // Centre on the focus using the actual renderer output size and zoom
+    int outW = 0, outH = 0; renderer->getOutputSize(&outW, &outH);
+    if (outW <= 0) { outW = WINDOW_WIDTH; outH = WINDOW_HEIGHT; }
+    float zoom = renderer->getZoom();
+    cameraX = static_cast<int>(static_cast<int>(focus.x) - (outW / (2.0f * zoom)));
+    cameraY = static_cast<int>(static_cast<int>(focus.y) - (outH / (2.0f * zoom)));
+}
+
 void Game::render() {
-    // Clear screen
-    SDL_SetRenderDrawColor(sdlRenderer, 0, 0, 0, 255);
-    SDL_RenderClear(sdlRenderer);
+    renderer->updateOutputSize();
+    renderer->clear(0, 0, 0);
     
-    // Set camera (center on player using actual renderer output size and zoom)
-    if (player) {
-        int playerX = static_cast<int>(player->getX());
-        int playerY = static_cast<int>(player->getY());
-        int outW = 0, outH = 0; SDL_GetRendererOutputSize(sdlRenderer, &outW, &outH);
+    // Blend the last two ticks by how far we are into the next one
+    renderSnapshots.acquire();
+    if (renderSnapshots.empty()) return;
+    const double sinceTick = static_cast<double>(SDL_GetPerformanceCounter() - lastTickCounter.load()) / SDL_GetPerformanceFrequency();
+    renderSnapshots.interpolate(std::clamp(static_cast<float>(sinceTick / SIM_TICK_TIME), 0.0f, 1.0f), renderFrame);
+    const RenderSnapshot& recorded = renderSnapshots.current();
+
+    // The frame was recorded at the tick's positions; shift each part to where it is now. The
+    // world moves with the camera, which follows the blended player.
+    const float zoom = renderer->getZoom();
+    auto shift = [zoom](float from, float to) { return static_cast<int>(std::lround((to - from) * zoom)); };
+    replayOffsets.world = SDL_Point{0, 0};
+    if (recorded.player.entity) {
+        int cameraX = 0, cameraY = 0;
+        cameraFor(renderFrame.player, cameraX, cameraY);
+        replayOffsets.world = SDL_Point{shift(static_cast<float>(cameraX), static_cast<float>(recorded.cameraX)),
+                                        shift(static_cast<float>(cameraY), static_cast<float>(recorded.cameraY))};
+    }
+    auto entityOffset = [&](const EntityTransform& at, const EntityTransform& drawn) {
+        return SDL_Point{replayOffsets.world.x + shift(drawn.x, at.x), replayOffsets.world.y + shift(drawn.y, at.y)};
+    };
+    replayOffsets.player = entityOffset(renderFrame.player, recorded.player);
+    replayOffsets.boss = entityOffset(renderFrame.boss, recorded.boss);
+    replayOffsets.enemies.resize(recorded.enemies.size());
+    for (size_t i = 0; i < recorded.enemies.size(); i++) {
+        replayOffsets.enemies[i] = entityOffset(renderFrame.enemies[i], recorded.enemies[i]);
+    }
+    renderer->replay(recorded.draw, replayOffsets);
+
+    if (audioManager && recorded.player.entity) {
+        int outW = 0, outH = 0; renderer->getOutputSize(&outW, &outH);
         if (outW <= 0) { outW = WINDOW_WIDTH; outH = WINDOW_HEIGHT; }
-        float zoom = renderer->getZoom();
-        int cameraX = static_cast<int>(playerX - (outW / (2.0f * zoom)));
-        int cameraY = static_cast<int>(playerY - (outH / (2.0f * zoom)));
+        audioManager->setListener(renderFrame.player.x, renderFrame.player.y, outW / (2.0f * zoom), outH / (2.0f * zoom));
+    }
+}
+
+void Game::recordFrame(RenderSnapshot& snapshot) {
+    const EntityTransform playerTransform = snapshot.player;
+    
+    // Set camera (center on player); render() re-centres it on the blended player
+    if (player) {
+        int cameraX = 0, cameraY = 0;
+        cameraFor(playerTransform, cameraX, cameraY);
         renderer->setCamera(cameraX, cameraY);
-        if (world) {
-            world->updateVisibleChunks(player->getX(), player->getY());
-            world->updateVisibility(player->getX(), player->getY());
-        }
+        snapshot.cameraX = cameraX;
+        snapshot.cameraY = cameraY;
     }
+    renderer->setAnchor(DrawList::ANCHOR_SCREEN);
+    if (uiSystem) uiSystem->setPointer(uiMouseX, uiMouseY, uiMouseButtons, uiEscapeHeld);
     
     // Login screen overlay when active
     if (loginScreenActive) {
         // Dim background
-        int outW=0,outH=0; SDL_GetRendererOutputSize(sdlRenderer, &outW, &outH);
-        SDL_SetRenderDrawBlendMode(sdlRenderer, SDL_BLENDMODE_BLEND);
-        SDL_SetRenderDrawColor(sdlRenderer, 0, 0, 0, 200);
+        int outW=0,outH=0; renderer->getOutputSize(&outW, &outH);
+        renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+        renderer->setDrawColor(0, 0, 0, 200);
         SDL_Rect dim{0,0,(outW>0?outW:WINDOW_WIDTH),(outH>0?outH:WINDOW_HEIGHT)};
-        SDL_RenderFillRect(sdlRenderer, &dim);
+        renderer->fillRect(&dim);
         // Panel
         int panelW = 520, panelH = 320;
         SDL_Rect panel{ dim.w/2 - panelW/2, dim.h/2 - panelH/2, panelW, panelH };
-        SDL_SetRenderDrawColor(sdlRenderer, 35,35,48,245);
-        SDL_RenderFillRect(sdlRenderer, &panel);
-        SDL_SetRenderDrawColor(sdlRenderer, 210,210,230,255);
-        SDL_RenderDrawRect(sdlRenderer, &panel);
+        renderer->setDrawColor(35,35,48,245);
+        renderer->fillRect(&panel);
+        renderer->setDrawColor(210,210,230,255);
+        renderer->drawRect(&panel);
         if (uiSystem) {
             uiSystem->renderTextCentered("PixLegends - Login", dim.w/2, panel.y + 36);
             // Fake input fields: show current username/password (masked)
@@ -1075,38 +1441,40 @@ void Game::render() {
             }
             // Remember checkbox
             SDL_Rect chk{ panel.x + 40, panel.y + 180, 20, 20 };
-            SDL_SetRenderDrawColor(sdlRenderer, 255,255,255,255);
-            SDL_RenderDrawRect(sdlRenderer, &chk);
+            renderer->setDrawColor(255,255,255,255);
+            renderer->drawRect(&chk);
             if (loginRemember) {
-                SDL_SetRenderDrawColor(sdlRenderer, 90,160,90,255);
-                SDL_RenderFillRect(sdlRenderer, &chk);
+                renderer->setDrawColor(90,160,90,255);
+                renderer->fillRect(&chk);
             }
             uiSystem->renderText("Remember me", chk.x + 28, chk.y + 2);
             if (!loginError.empty()) uiSystem->renderText(loginError, panel.x + 40, panel.y + 180, SDL_Color{255,120,120,255});
             // Buttons: Login and Register
             SDL_Rect btnLogin{ panel.x + 40, panel.y + panelH - 70, 180, 44 };
             SDL_Rect btnRegister{ panel.x + 240, panel.y + panelH - 70, 180, 44 };
-            SDL_SetRenderDrawColor(sdlRenderer, 90,160,90,255); SDL_RenderFillRect(sdlRenderer, &btnLogin);
-            SDL_SetRenderDrawColor(sdlRenderer, 255,255,255,255); SDL_RenderDrawRect(sdlRenderer, &btnLogin);
+            renderer->setDrawColor(90,160,90,255); renderer->fillRect(&btnLogin);
+            renderer->setDrawColor(255,255,255,255); renderer->drawRect(&btnLogin);
             uiSystem->renderText("Login", btnLogin.x + 12, btnLogin.y + 12);
-            SDL_SetRenderDrawColor(sdlRenderer, 80,120,170,255); SDL_RenderFillRect(sdlRenderer, &btnRegister);
-            SDL_SetRenderDrawColor(sdlRenderer, 255,255,255,255); SDL_RenderDrawRect(sdlRenderer, &btnRegister);
+            renderer->setDrawColor(80,120,170,255); renderer->fillRect(&btnRegister);
+            renderer->setDrawColor(255,255,255,255); renderer->drawRect(&btnRegister);
             uiSystem->renderText("Register", btnRegister.x + 12, btnRegister.y + 12);
         }
-        // Present and early return (do not render world)
-        SDL_RenderPresent(sdlRenderer);
+        // Early return (do not render world); run() presents
         return;
     }
 
     // Render world
     if (world) {
         // Keep rendering the world even while the anvil UI is open so the background remains visible
-        world->render(renderer.get());
+        renderer->setAnchor(DrawList::ANCHOR_WORLD);
+        world->render(renderer.get(), snapshot);
     }
     
     // Render player
     if (player) {
-        player->render(renderer.get());
+        renderer->setAnchor(DrawList::ANCHOR_PLAYER);
+        player->render(renderer.get(), playerTransform);
+        renderer->setAnchor(DrawList::ANCHOR_WORLD);
         player->renderProjectiles(renderer.get());
         
         // Render spell effects
@@ -1114,13 +1482,12 @@ void Game::render() {
             player->getSpellSystem()->render(renderer.get());
             
             // Render channeling indicators (range and target)
-            int mouseX, mouseY;
-            SDL_GetMouseState(&mouseX, &mouseY);
-            player->getSpellSystem()->renderIndicators(renderer.get(), mouseX, mouseY);
+            player->getSpellSystem()->renderIndicators(renderer.get(), uiMouseX, uiMouseY);
         }
     }
     
     // Render UI
+    renderer->setAnchor(DrawList::ANCHOR_SCREEN);
     if (uiSystem) {
         // Minimap first, so HUD frame overlays on top of it
         if (world && player && assetManager) {
@@ -1166,7 +1533,7 @@ void Game::render() {
                 const int mmXAdj = mmX - addLeft;
                 const int mmYAdj = mmY - addUp;
 
-                world->renderMinimap(renderer.get(), mmXAdj, mmYAdj, mmW, mmH, player->getX(), player->getY());
+                world->renderMinimap(renderer.get(), mmXAdj, mmYAdj, mmW, mmH, playerTransform.x, playerTransform.y);
             }
         }
         // Draw HUD frame and stats above the minimap
@@ -1182,10 +1549,7 @@ void Game::render() {
         
         // Render spell book if open
         if (uiSystem->isSpellBookOpen()) {
-            int mouseX = inputManager->getMouseX();
-            int mouseY = inputManager->getMouseY();
-            bool mouseClicked = inputManager->isMouseButtonPressed(SDL_BUTTON_LEFT);
-            uiSystem->renderSpellBook(player.get(), mouseX, mouseY, mouseClicked);
+            uiSystem->renderSpellBook(player.get(), uiMouseX, uiMouseY, uiMouseClicked);
         }
         uiSystem->renderDebugInfo(player.get());
         // Render FPS counter
@@ -1203,43 +1567,9 @@ void Game::render() {
             bool clickedRespawn = false;
             uiSystem->renderDeathPopup(clickedRespawn, deathPopupFade);
             if (clickedRespawn) {
-                // Reset world enemies and player
-                if (world) {
-                    auto& enemies = world->getEnemies();
-                    for (auto& e : enemies) {
-                        if (e) e->resetToSpawn();
-                    }
-                }
-                player->respawn(player->getSpawnX(), player->getSpawnY());
-                // After respawn, enforce minion cap by player level to avoid sudden overpopulation
-                if (world && player) {
-                    int level = player->getLevel();
-                    const int caps[10] = {5,8,11,14,17,20,23,26,28,30};
-                    int maxGoblins = (level <= 0 ? 5 : (level >= 10 ? 30 : caps[level-1]));
-                    // Gather live goblin indices
-                    auto& enemies = world->getEnemies();
-                    int alive = 0;
-                    for (const auto& e : enemies) {
-                        if (e && std::string(e->getDisplayName()) == std::string("Goblin") && !e->isDead()) alive++;
-                    }
-                    if (alive > maxGoblins) {
-                        // Despawn extras starting from farthest from player
-                        struct GRef { size_t idx; float dist2; };
-                        std::vector<GRef> gobRefs; gobRefs.reserve(enemies.size());
-                        float pcx = player->getX(); float pcy = player->getY();
-                        for (size_t i = 0; i < enemies.size(); ++i) {
-                            auto& e = enemies[i];
-                            if (!e || std::string(e->getDisplayName()) != std::string("Goblin") || e->isDead()) continue;
-                            float dx = e->getX() - pcx; float dy = e->getY() - pcy; gobRefs.push_back({i, dx*dx + dy*dy});
-                        }
-                        std::sort(gobRefs.begin(), gobRefs.end(), [](const GRef& a, const GRef& b){ return a.dist2 > b.dist2; });
-                        int toRemove = alive - maxGoblins;
-                        for (int k = 0; k < toRemove && k < static_cast<int>(gobRefs.size()); ++k) {
-                            enemies[gobRefs[k].idx].reset();
-                        }
-                        enemies.erase(std::remove_if(enemies.begin(), enemies.end(), [](const std::unique_ptr<Enemy>& e){ return !e; }), enemies.end());
-                    }
-                }
+                SimCommand command;
+                command.type = SimCommand::Type::RESPAWN;
+                queueSimCommand(command);
                 deathPopupFade = 0.0f;
             }
         }
@@ -1279,7 +1609,7 @@ void Game::render() {
             
             if (engagedEnemy) {
                 int outW = 0, outH = 0;
-                SDL_GetRendererOutputSize(sdlRenderer, &outW, &outH);
+                renderer->getOutputSize(&outW, &outH);
                 uiSystem->renderBossHealthBar(engagedEnemy->getDisplayName(), engagedEnemy->getHealth(), engagedEnemy->getMaxHealth(), (outW > 0 ? outW : WINDOW_WIDTH));
                 // Start boss music if available (bosses and elites)
                 if ((isBossFight || engagedEnemy->getPackRarity() == PackRarity::Elite) && audioManager && audioManager->hasMusic("boss_music") && currentMusicTrack != "boss_music") { 
@@ -1330,7 +1660,7 @@ void Game::render() {
 
         // Debug draw melee, enemy, and player hitboxes (F3 toggle)
         if (getDebugHitboxes() && player && !anvilOpen) {
-            SDL_SetRenderDrawBlendMode(sdlRenderer, SDL_BLENDMODE_BLEND);
+            renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
             int camX = 0, camY = 0; renderer->getCamera(camX, camY);
             float z = renderer->getZoom();
 
@@ -1350,8 +1680,8 @@ void Game::render() {
                 return out;
             };
             SDL_Rect melee = scaleRect(meleeW);
-            SDL_SetRenderDrawColor(sdlRenderer, 0, 255, 0, 160);
-            if (melee.w > 0 && melee.h > 0) SDL_RenderDrawRect(sdlRenderer, &melee);
+            renderer->setDrawColor(0, 255, 0, 160);
+            if (melee.w > 0 && melee.h > 0) renderer->drawRect(&melee);
 
             // Enemy hitboxes
             if (world) {
@@ -1360,16 +1690,16 @@ void Game::render() {
                     if (!e) continue;
                     SDL_Rect erW = e->getCollisionRect();
                     SDL_Rect er = scaleRect(erW);
-                    SDL_SetRenderDrawColor(sdlRenderer, 255, 0, 0, 160);
-                    SDL_RenderDrawRect(sdlRenderer, &er);
+                    renderer->setDrawColor(255, 0, 0, 160);
+                    renderer->drawRect(&er);
                 }
             }
 
             // Player collision rect (world -> screen)
             SDL_Rect prW = player->getCollisionRect();
             SDL_Rect pr = scaleRect(prW);
-            SDL_SetRenderDrawColor(sdlRenderer, 0, 200, 255, 160);
-            SDL_RenderDrawRect(sdlRenderer, &pr);
+            renderer->setDrawColor(0, 200, 255, 160);
+            renderer->drawRect(&pr);
         }
         
         // Render interaction prompt
@@ -1395,7 +1725,9 @@ void Game::render() {
                 static int notificationTimer = 0;
                 notificationTimer++;
                 if (notificationTimer > 180) { // 3 seconds at 60 FPS
-                    player->clearLootNotification();
+                    SimCommand command;
+                    command.type = SimCommand::Type::CLEAR_LOOT_NOTIFICATION;
+                    queueSimCommand(command);
                     notificationTimer = 0;
                 }
             }
@@ -1415,9 +1747,8 @@ void Game::render() {
             draggingInventory = true;
         }
         if (draggingInventory) {
-            int mx, my;
-            SDL_GetMouseState(&mx, &my);
-            if (SDL_GetMouseState(nullptr, nullptr) & SDL_BUTTON(SDL_BUTTON_LEFT)) {
+            int mx = uiMouseX, my = uiMouseY;
+            if (uiMouseButtons & SDL_BUTTON(SDL_BUTTON_LEFT)) {
                 // Still dragging - update position
                 setInventoryPos(mx - ih.dragOffsetX, my - ih.dragOffsetY);
             } else {
@@ -1444,21 +1775,14 @@ void Game::render() {
                             draggingFromInventory = true;
                             draggingPayload = item->id;
                             // Store the specific item instance being dragged
-                            anvilTargetItem = item;
+                            anvilTargetItem = item->handle;
                             anvilItemSource = AnvilItemSource::INVENTORY_ITEM;
                         } else {
                             // Regular equip behavior
-                            Item* item = itemInventory[ih.clickedItemSlot].item;
-                            int equipSlot = static_cast<int>(item->equipmentType);
-                            
-                            if (itemSystem->equipItem(ih.clickedItemSlot)) {
-                                // Sync the Player equipment array with the newly equipped item
-                                const auto& equipSlots = itemSystem->getEquipmentSlots();
-                                if (equipSlot >= 0 && equipSlot < equipSlots.size() && !equipSlots[equipSlot].isEmpty()) {
-                                    player->syncEquipmentFromItem(static_cast<Player::EquipmentSlot>(equipSlot), 
-                                                                 equipSlots[equipSlot].item);
-                                }
-                            }
+                            SimCommand command;
+                            command.type = SimCommand::Type::EQUIP;
+                            command.slot = ih.clickedItemSlot;
+                            queueSimCommand(command);
                         }
                     } else if (anvilOpen && item->type == ItemType::EQUIPMENT) {
                         // Right click - automatically select anvil slot for this equipment type AND set target item
@@ -1473,32 +1797,14 @@ void Game::render() {
                         else if (item->id.find("boots") != std::string::npos) anvilSelectedSlot = 8;
                         
                         // Set the target item for anvil operations
-                        anvilTargetItem = item;
+                        anvilTargetItem = item->handle;
                         anvilItemSource = AnvilItemSource::INVENTORY_ITEM;
                     } else if (!anvilOpen && item->type == ItemType::EQUIPMENT) {
                         // Right click - ordered swap: unequip first, then equip
-                        int equipSlot = static_cast<int>(item->equipmentType);
-                        if (equipSlot >= 0 && equipSlot < 9) {
-                            const auto& equipSlots = itemSystem->getEquipmentSlots();
-                            
-                            // Step 1: If there's an item equipped in that slot, unequip it first
-                            if (equipSlot < equipSlots.size() && !equipSlots[equipSlot].isEmpty()) {
-                                if (itemSystem->unequipItem(equipSlot)) {
-                                    // Also clear the Player equipment array to stay synchronized
-                                    player->clearEquipmentSlot(static_cast<Player::EquipmentSlot>(equipSlot));
-                                }
-                            }
-                            
-                            // Step 2: Now equip the new item
-                            if (itemSystem->equipItem(ih.clickedItemSlot)) {
-                                // Sync the Player equipment array with the newly equipped item
-                                const auto& equipSlots = itemSystem->getEquipmentSlots();
-                                if (equipSlot < equipSlots.size() && !equipSlots[equipSlot].isEmpty()) {
-                                    player->syncEquipmentFromItem(static_cast<Player::EquipmentSlot>(equipSlot), 
-                                                                 equipSlots[equipSlot].item);
-                                }
-                            }
-                        }
+                        SimCommand command;
+                        command.type = SimCommand::Type::SWAP_EQUIP;
+                        command.slot = ih.clickedItemSlot;
+                        queueSimCommand(command);
                     }
                     // Right click also shows tooltip (handled by UI)
                     
@@ -1520,11 +1826,10 @@ void Game::render() {
                         // Right click - automatically stage scroll in anvil and consume it
                         anvilStagedScrollKey = scroll->id;
                         // Consume the scroll from player's inventory
-                        if (scroll->id == "upgrade_scroll") {
-                            player->consumeUpgradeScroll();
-                        } else {
-                            player->consumeElementScroll(scroll->id);
-                        }
+                        SimCommand command;
+                        command.type = SimCommand::Type::CONSUME_SCROLL;
+                        command.key = scroll->id;
+                        queueSimCommand(command);
                     }
                 }
             }
@@ -1545,9 +1850,8 @@ void Game::render() {
             draggingEquipment = true;
         }
         if (draggingEquipment) {
-            int mx, my;
-            SDL_GetMouseState(&mx, &my);
-            if (SDL_GetMouseState(nullptr, nullptr) & SDL_BUTTON(SDL_BUTTON_LEFT)) {
+            int mx = uiMouseX, my = uiMouseY;
+            if (uiMouseButtons & SDL_BUTTON(SDL_BUTTON_LEFT)) {
                 // Still dragging - update position
                 setEquipmentPos(mx - eh.dragOffsetX, my - eh.dragOffsetY);
             } else {
@@ -1569,21 +1873,21 @@ void Game::render() {
                         draggingFromInventory = true;
                         draggingPayload = equippedItem->id;
                         // Store the specific item instance being dragged
-                        anvilTargetItem = equippedItem;
+                        anvilTargetItem = equippedItem->handle;
                         anvilItemSource = AnvilItemSource::EQUIPPED_SLOT;
                         // Also set the anvil selected slot to match this equipment type
                         anvilSelectedSlot = eh.clickedEquipSlot;
                     } else {
-                        // Regular unequip behavior - move to inventory using ItemSystem
-                        if (itemSystem->unequipItem(eh.clickedEquipSlot)) {
-                            // Also clear the Player equipment array to stay synchronized
-                            player->clearEquipmentSlot(static_cast<Player::EquipmentSlot>(eh.clickedEquipSlot));
-                        }
+                        // Regular unequip behavior - move to inventory
+                        SimCommand command;
+                        command.type = SimCommand::Type::UNEQUIP;
+                        command.slot = eh.clickedEquipSlot;
+                        queueSimCommand(command);
                     }
                 } else if (anvilOpen) {
                     // Right click - automatically select this equipment slot in anvil and set target item
                     anvilSelectedSlot = eh.clickedEquipSlot;
-                    anvilTargetItem = equippedItem;
+                    anvilTargetItem = equippedItem->handle;
                     anvilItemSource = AnvilItemSource::EQUIPPED_SLOT;
                 }
                 // Right click also shows tooltip (handled by UI)
@@ -1593,10 +1897,9 @@ void Game::render() {
 
     // Magic Anvil overlay after processing inventory so dragging payload is known
     if (anvilOpen && uiSystem && player) {
-        int outW=0,outH=0; SDL_GetRendererOutputSize(sdlRenderer,&outW,&outH); if (outW<=0){outW=WINDOW_WIDTH;outH=WINDOW_HEIGHT;}
-        int mx=0,my=0; SDL_GetMouseState(&mx,&my);
-        Uint32 ms = SDL_GetMouseState(nullptr,nullptr);
-        bool mouseDown = (ms & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
+        int outW=0,outH=0; renderer->getOutputSize(&outW,&outH); if (outW<=0){outW=WINDOW_WIDTH;outH=WINDOW_HEIGHT;}
+        int mx = uiMouseX, my = uiMouseY;
+        bool mouseDown = (uiMouseButtons & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
         UISystem::AnvilHit hit;
         static std::string currentScrollPreview;
         // Provide external payload while dragging from inventory (enables drop detection on release)
@@ -1604,65 +1907,24 @@ void Game::render() {
         uiSystem->renderMagicAnvil(player.get(), outW, outH, mx, my, mouseDown, hit, external, anvilSelectedSlot, anvilStagedScrollKey, this);
         if (hit.clickedSlot>=0) anvilSelectedSlot = hit.clickedSlot;
         // Apply via button or drag-drop
-        static float upgradeFlashTimer = 0.0f; static bool lastUpgradeSuccess = false;
-        auto chanceForNext = [](int currentPlus) -> float {
-            static const float table[31] = {
-                0.0f, 100.0f, 95.0f, 90.0f, 80.0f, 75.0f, 70.0f, 65.0f, 55.0f, 50.0f,
-                45.0f, 40.0f, 35.0f, 30.0f, 28.0f, 25.0f, 20.0f, 18.0f, 15.0f, 13.0f,
-                12.0f, 10.0f, 8.0f, 7.0f, 6.0f, 5.0f, 4.5f, 4.0f, 3.5f, 3.0f, 2.5f
-            }; // index is next level; we pass current+1 later
-            int next = currentPlus + 1; if (next < 1) next = 1; if (next > 30) next = 30; return table[next];
-        };
-        static std::mt19937 rng(static_cast<unsigned int>(SDL_GetTicks()));
+        static float upgradeFlashTimer = 0.0f;
         // Clicking upgrade button applies staged scroll (upgrade or element)
         if (hit.clickedSideUpgrade && !anvilStagedScrollKey.empty()) {
             anvilUpgradeAnimT = 0.0001f; // start sweep
+            SimCommand command;
+            command.slot = anvilSelectedSlot;
+            command.item = anvilTargetItem;
+            command.key = anvilStagedScrollKey;
             if (anvilStagedScrollKey == "upgrade_scroll") {
-                // Determine which item to upgrade
-                Item* targetItem = anvilTargetItem;
-                int currentPlusLevel = 0;
-                
-                if (targetItem) {
-                    // Upgrade specific item instance
-                    currentPlusLevel = targetItem->plusLevel;
-                } else {
-                    // Fallback to equipment slot method
-                    const auto& eq = player->getEquipment(static_cast<Player::EquipmentSlot>(anvilSelectedSlot));
-                    currentPlusLevel = eq.plusLevel;
-                    targetItem = nullptr;
-                }
-                
-                if (currentPlusLevel < 30) {
-                    std::uniform_real_distribution<float> dist(0.0f, 100.0f);
-                    float roll = dist(rng);
-                    float chance = chanceForNext(currentPlusLevel);
-                    if (roll <= chance) {
-                        if (targetItem) {
-                            player->upgradeSpecificItem(targetItem, 1);
-                        } else {
-                            player->upgradeEquipment(static_cast<Player::EquipmentSlot>(anvilSelectedSlot), 1);
-                        }
-                        lastUpgradeSuccess = true;
-                    } else {
-                        lastUpgradeSuccess = false;
-                    }
-                    anvilLastSuccess = lastUpgradeSuccess;
-                    // Do NOT reveal immediately; start suspense sweep and reveal after it completes
-                    anvilStagedScrollKey.clear();
-                    Object::setMagicAnvilPulse(3.2f);
-                    if (audioManager) audioManager->playSound("upgrade_sound");
-                } else { lastUpgradeSuccess = false; upgradeFlashTimer = 0.8f; }
+                // The roll happens on the next tick; the result is revealed after the sweep completes
+                command.type = SimCommand::Type::ANVIL_UPGRADE;
             } else {
                 // Enchantment
-                if (anvilTargetItem) {
-                    player->enchantSpecificItem(anvilTargetItem, anvilStagedScrollKey, 1);
-                } else {
-                    player->enchantEquipment(static_cast<Player::EquipmentSlot>(anvilSelectedSlot), anvilStagedScrollKey, 1);
-                }
-                lastUpgradeSuccess = true; anvilLastSuccess = true; anvilStagedScrollKey.clear();
-                Object::setMagicAnvilPulse(3.2f);
+                command.type = SimCommand::Type::ANVIL_ENCHANT;
+                anvilLastSuccess = true; anvilStagedScrollKey.clear();
                 if (audioManager) audioManager->playSound("upgrade_sound");
             }
+            queueSimCommand(command);
         }
         // Handle dropped items from enhanced inventory system
         if (hit.droppedItem && draggingFromInventory && !draggingPayload.empty()) {
@@ -1697,16 +1959,15 @@ void Game::render() {
         if (!hit.clickedElement.empty()) {
             std::string elem = hit.clickedElement;
             if (!anvilStagedScrollKey.empty() && anvilStagedScrollKey != elem) {
-                lastUpgradeSuccess = false; upgradeFlashTimer = 0.8f;
+                upgradeFlashTimer = 0.8f;
             } else {
-                // Use specific item if available, otherwise fall back to slot
-                if (anvilTargetItem) {
-                    player->enchantSpecificItem(anvilTargetItem, elem, 1);
-                } else {
-                    player->enchantEquipment(static_cast<Player::EquipmentSlot>(anvilSelectedSlot), elem, 1);
-                }
-                lastUpgradeSuccess = true; upgradeFlashTimer = 0.8f; anvilStagedScrollKey.clear();
-                Object::setMagicAnvilPulse(3.2f);
+                SimCommand command;
+                command.type = SimCommand::Type::ANVIL_ENCHANT;
+                command.slot = anvilSelectedSlot;
+                command.item = anvilTargetItem;
+                command.key = elem;
+                queueSimCommand(command);
+                upgradeFlashTimer = 0.8f; anvilStagedScrollKey.clear();
             }
         }
         if (hit.droppedScroll) { currentScrollPreview = hit.droppedScrollKey; }
@@ -1731,7 +1992,7 @@ void Game::render() {
         if (!mouseDown && draggingFromInventory && !hit.droppedItem && !hit.droppedScroll) {
             draggingFromInventory = false;
             draggingPayload.clear();
-            anvilTargetItem = nullptr;
+            anvilTargetItem = ItemHandle();
             anvilItemSource = AnvilItemSource::NONE;
         }
         // Close via Escape handled in event loop; remove close button logic
@@ -1746,7 +2007,7 @@ void Game::render() {
             
             // Use current anvil UI positioning - match exactly with UISystem indicatorRect
             Texture* anvilBG = assetManager->getTexture("assets/Textures/UI/AnvilUI.png");
-            int outW=0,outH=0; SDL_GetRendererOutputSize(sdlRenderer,&outW,&outH); if (outW<=0){outW=WINDOW_WIDTH;outH=WINDOW_HEIGHT;}
+            int outW=0,outH=0; renderer->getOutputSize(&outW,&outH); if (outW<=0){outW=WINDOW_WIDTH;outH=WINDOW_HEIGHT;}
             int pw = anvilBG ? anvilBG->getWidth() : 200;
             int ph = anvilBG ? anvilBG->getHeight() : 200;
             int anvilX, anvilY;
@@ -1773,7 +2034,7 @@ void Game::render() {
             if (tAlt) {
                 SDL_Rect src{0,0, static_cast<int>(tAlt->getWidth()*anvilUpgradeAnimT), tAlt->getHeight()};
                 SDL_Rect dst{ indicatorRect.x, indicatorRect.y, static_cast<int>(indicatorRect.w*anvilUpgradeAnimT), indicatorRect.h };
-                SDL_RenderCopy(sdlRenderer, tAlt->getTexture(), &src, &dst);
+                renderer->copy(tAlt->getTexture(), &src, &dst);
             }
             if (anvilUpgradeAnimT >= 1.0f) { anvilUpgradeAnimT = 0.0f; anvilResultFlashTimer = 1.2f; }
         }
@@ -1786,7 +2047,7 @@ void Game::render() {
             if (t) {
                 // Use current anvil UI positioning - match exactly with UISystem indicatorRect
                 Texture* anvilBG = assetManager->getTexture("assets/Textures/UI/AnvilUI.png");
-                int outW=0,outH=0; SDL_GetRendererOutputSize(sdlRenderer,&outW,&outH); if (outW<=0){outW=WINDOW_WIDTH;outH=WINDOW_HEIGHT;}
+                int outW=0,outH=0; renderer->getOutputSize(&outW,&outH); if (outW<=0){outW=WINDOW_WIDTH;outH=WINDOW_HEIGHT;}
                 int pw = anvilBG ? anvilBG->getWidth() : 200;
                 int ph = anvilBG ? anvilBG->getHeight() : 200;
                 int anvilX, anvilY;
@@ -1807,7 +2068,7 @@ void Game::render() {
                     110, 20
                 };
                 SDL_Rect s{0,0,t->getWidth(), t->getHeight()};
-                SDL_RenderCopy(sdlRenderer, t->getTexture(), &s, &indicatorRect);
+                renderer->copy(t->getTexture(), &s, &indicatorRect);
             }
         }
     }
@@ -1815,33 +2076,31 @@ void Game::render() {
     if (optionsOpen) {
         renderOptionsMenuOverlay();
     }
-    
-    // Present
-    SDL_RenderPresent(sdlRenderer);
+    uiMouseClicked = false; // the UI above has seen it
 }
 
 void Game::loadOrCreateDefaultUserAndSave() {
     if (!database || !player) return;
-    // Ensure there is at least one default user
-    auto user = database->getUserById(1);
-    if (!user) {
+    // Ensure the default accounts exist
+    auto def = database->getUserByName("player");
+    if (!def) {
         // Create default admin and player users
         database->registerUser("admin", "admin", UserRole::ADMIN);
-        auto playerUser = database->registerUser("player", "player", UserRole::PLAYER);
-        if (playerUser) {
+        def = database->registerUser("player", "player", UserRole::PLAYER);
+        if (def) {
             // Initialize default save
             PlayerSave s = player->makeSaveState();
-            database->savePlayerState(playerUser->userId, s);
+            database->savePlayerState(def->userId, s);
         }
     }
     // Load last save for default player if available
-    auto def = database->getUserByName("player");
     if (def) {
         auto save = database->loadPlayerState(def->userId);
         if (save) {
             // Apply minimal fields to player
             player->applySaveState(*save);
         }
+        loadKeyBindings(def->userId);
         // Load audio prefs and apply
         if (audioManager) {
             int m=100, mu=100, s=100, mon=100, pl=100;
@@ -1871,240 +2130,285 @@ void Game::loadOrCreateDefaultUserAndSave() {
 }
 
 void Game::handleEvents() {
+    // The window belongs to this thread, but everything its input drives is game state: events are
+    // handed to the simulation and handled at the start of its next tick
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         switch (event.type) {
+            case SDL_RENDER_TARGETS_RESET:
+            case SDL_RENDER_DEVICE_RESET:
+                // Cached UI panel textures lost their contents
+                if (renderer) renderer->invalidatePanels();
+                continue;
             case SDL_QUIT:
-                // Persist audio and theme on hard quit (Alt+F4 or window close)
-                if (database && audioManager) {
-                    int uid = loggedInUserId;
-                    if (uid <= 0) {
-                        auto defU = database->getUserByName("player");
-                        if (defU) uid = defU->userId;
-                    }
-                    if (uid > 0) {
-                        database->saveAudioSettings(uid,
-                            audioManager->getMasterVolume(),
-                            audioManager->getMusicVolume(),
-                            audioManager->getSoundVolume(),
-                            audioManager->getMonsterVolume(),
-                            audioManager->getPlayerVolume());
-                        database->saveTheme(uid, backgroundMusicName);
-                    }
-                }
-                isRunning = false;
-                break;
-                
             case SDL_KEYDOWN:
-                if (loginScreenActive) {
-                    // Simple text input handling for username/password
-                    if (event.key.keysym.sym == SDLK_BACKSPACE) {
-                        if (SDL_GetModState() & KMOD_SHIFT) {
-                            // Clear both on Shift+Backspace
-                            loginUsername.clear(); loginPassword.clear();
+            case SDL_KEYUP:
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+            case SDL_MOUSEMOTION:
+            case SDL_TEXTINPUT:
+                break;
+            default:
+                continue;
+        }
+        // A replay owns the input; the window only takes quit requests (close or Escape)
+        if (inputPlayer) {
+            if (event.type == SDL_QUIT || (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)) isRunning = false;
+            continue;
+        }
+        SimCommand command;
+        command.type = SimCommand::Type::EVENT;
+        command.event = event;
+        if (!simCommands.push(command)) std::cerr << "Simulation command queue full; dropped an input event" << std::endl;
+    }
+}
+
+void Game::handleEvent(const SDL_Event& event) {
+    // The UI reads the pointer from here rather than polling SDL, which is the main thread's
+    if (event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_MOUSEBUTTONUP) {
+        const Uint32 mask = SDL_BUTTON(event.button.button);
+        uiMouseButtons = (event.type == SDL_MOUSEBUTTONDOWN) ? (uiMouseButtons | mask) : (uiMouseButtons & ~mask);
+        uiMouseX = event.button.x;
+        uiMouseY = event.button.y;
+    } else if (event.type == SDL_MOUSEMOTION) {
+        uiMouseX = event.motion.x;
+        uiMouseY = event.motion.y;
+    } else if ((event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) && event.key.keysym.scancode == SDL_SCANCODE_ESCAPE) {
+        uiEscapeHeld = (event.type == SDL_KEYDOWN);
+    }
+    switch (event.type) {
+        case SDL_QUIT:
+            // Persist audio and theme on hard quit (Alt+F4 or window close)
+            if (database && audioManager) {
+                int uid = loggedInUserId;
+                if (uid <= 0) {
+                    auto defU = database->getUserByName("player");
+                    if (defU) uid = defU->userId;
+                }
+                if (uid > 0) {
+                    database->saveAudioSettings(uid,
+                        audioManager->getMasterVolume(),
+                        audioManager->getMusicVolume(),
+                        audioManager->getSoundVolume(),
+                        audioManager->getMonsterVolume(),
+                        audioManager->getPlayerVolume());
+                    database->saveTheme(uid, backgroundMusicName);
+                }
+            }
+            isRunning = false;
+            break;
+            
+        case SDL_KEYDOWN:
+            if (loginScreenActive) {
+                // Simple text input handling for username/password
+                if (event.key.keysym.sym == SDLK_BACKSPACE) {
+                    if (event.key.keysym.mod & KMOD_SHIFT) {
+                        // Clear both on Shift+Backspace
+                        loginUsername.clear(); loginPassword.clear();
+                    } else {
+                        if (loginActiveField == LoginField::Password) {
+                            if (!loginPassword.empty()) loginPassword.pop_back();
                         } else {
-                            if (loginActiveField == LoginField::Password) {
-                                if (!loginPassword.empty()) loginPassword.pop_back();
-                            } else {
-                                if (!loginUsername.empty()) loginUsername.pop_back();
-                            }
+                            if (!loginUsername.empty()) loginUsername.pop_back();
                         }
-                    } else if (event.key.keysym.sym == SDLK_TAB) {
-                        // Toggle focus between fields
-                        loginActiveField = (loginActiveField == LoginField::Username ? LoginField::Password : LoginField::Username);
-                        // Prevent the tab from propagating to game input
-                        break;
-                    } else if (event.key.keysym.sym == SDLK_RETURN || event.key.keysym.sym == SDLK_KP_ENTER) {
-                        // Pressing Enter triggers Login
-                        if (database) {
-                            std::string err;
-                            auto u = database->authenticate(loginUsername, loginPassword, &err);
-                            if (u) {
-                                loggedInUserId = u->userId;
-                                loginIsAdmin = (u->role == UserRole::ADMIN);
-                                loginScreenActive = false;
-                                loginError.clear();
-                                if (loginRemember) database->saveRememberState(DatabaseSQLite::RememberState{loginUsername, loginPassword, true}); else database->clearRememberState();
-                                auto save = database->loadPlayerState(loggedInUserId);
-                                if (save) player->applySaveState(*save);
-                                // Load persisted audio settings and theme on login
-                                if (audioManager) {
-                                    int m=100, mu=100, s=100, mon=100, pl=100;
-                                    if (database->loadAudioSettings(loggedInUserId, m, mu, s, mon, pl)) {
-                                        audioManager->setMasterVolume(m);
-                                        audioManager->setMusicVolume(mu);
-                                        audioManager->setSoundVolume(s);
-                                        audioManager->setMonsterVolume(mon);
-                                        audioManager->setPlayerVolume(pl);
-                                    }
-                                    std::string theme;
-                                    if (database->loadTheme(loggedInUserId, theme) && !theme.empty()) {
-                                        backgroundMusicName = theme;
-                                        if (audioManager->hasMusic(backgroundMusicName)) {
-                                            audioManager->fadeToMusic(backgroundMusicName, 200, 200);
-                                            currentMusicTrack = backgroundMusicName;
-                                        }
+                    }
+                } else if (event.key.keysym.sym == SDLK_TAB) {
+                    // Toggle focus between fields
+                    loginActiveField = (loginActiveField == LoginField::Username ? LoginField::Password : LoginField::Username);
+                    // Prevent the tab from propagating to game input
+                    break;
+                } else if (event.key.keysym.sym == SDLK_RETURN || event.key.keysym.sym == SDLK_KP_ENTER) {
+                    // Pressing Enter triggers Login
+                    if (database) {
+                        std::string err;
+                        auto u = database->authenticate(loginUsername, loginPassword, &err);
+                        if (u) {
+                            loggedInUserId = u->userId;
+                            loginIsAdmin = (u->role == UserRole::ADMIN);
+                            loginScreenActive = false;
+                            loginError.clear();
+                            if (loginRemember) database->saveRememberState(DatabaseSQLite::RememberState{loginUsername, loginPassword, true}); else database->clearRememberState();
+                            if (saveWriter) saveWriter->flush(); // don't read a save that is still queued
+                            auto save = database->loadPlayerState(loggedInUserId);
+                            if (save) player->applySaveState(*save);
+                            loadKeyBindings(loggedInUserId);
+                            // Load persisted audio settings and theme on login
+                            if (audioManager) {
+                                int m=100, mu=100, s=100, mon=100, pl=100;
+                                if (database->loadAudioSettings(loggedInUserId, m, mu, s, mon, pl)) {
+                                    audioManager->setMasterVolume(m);
+                                    audioManager->setMusicVolume(mu);
+                                    audioManager->setSoundVolume(s);
+                                    audioManager->setMonsterVolume(mon);
+                                    audioManager->setPlayerVolume(pl);
+                                }
+                                std::string theme;
+                                if (database->loadTheme(loggedInUserId, theme) && !theme.empty()) {
+                                    backgroundMusicName = theme;
+                                    if (audioManager->hasMusic(backgroundMusicName)) {
+                                        audioManager->fadeToMusic(backgroundMusicName, 200, 200);
+                                        currentMusicTrack = backgroundMusicName;
                                     }
                                 }
-                            } else {
-                                loginError = err.empty()? std::string("Invalid credentials") : err;
                             }
+                        } else {
+                            loginError = err.empty()? std::string("Invalid credentials") : err;
                         }
-                        break;
-                    }
-                } else if (!optionsOpen && event.key.keysym.sym == SDLK_p) {
-                    isPaused = !isPaused;
-                } else if (!optionsOpen && event.key.keysym.sym == SDLK_F3) {
-                    setDebugHitboxes(!getDebugHitboxes());
-                } else if (!optionsOpen && event.key.keysym.sym == SDLK_F5) {
-                    setInfinitePotions(!getInfinitePotions());
-                    std::cout << "Infinite potions: " << (getInfinitePotions() ? "ON" : "OFF") << std::endl;
-                } else if (!optionsOpen && event.key.keysym.sym == SDLK_F6) {
-                    // Manual save
-                    std::cout << "Manual save triggered (F6) - User ID: " << loggedInUserId << std::endl;
-                    saveCurrentUserState();
-                } else if (!optionsOpen && event.key.keysym.sym == SDLK_F7) {
-                    // Debug: Enter underworld
-                    if (!inUnderworld) {
-                        enterUnderworld();
-                        std::cout << "DEBUG: Entered underworld" << std::endl;
-                    }
-                } else if (!optionsOpen && event.key.keysym.sym == SDLK_F8) {
-                    // Debug: Exit underworld
-                    if (inUnderworld) {
-                        exitUnderworld();
-                        std::cout << "DEBUG: Exited underworld" << std::endl;
-                    }
-                } else if (!optionsOpen && event.key.keysym.sym == SDLK_i) {
-                    // Toggle inventory UI
-                    inventoryOpen = !inventoryOpen;
-                } else if (!optionsOpen && event.key.keysym.sym == SDLK_b) {
-                    // Toggle spell book
-                    uiSystem->toggleSpellBook();
-                } else if (!optionsOpen && event.key.keysym.sym == SDLK_u) {
-                    // Toggle equipment UI
-                    equipmentOpen = !equipmentOpen;
-                } else if (!optionsOpen && event.key.keysym.sym == SDLK_F9) {
-                    // Dev hotkey: grant large stacks of test scrolls
-                    if (player) {
-                        player->addItemToInventory("upgrade_scroll", 50);
-                        player->addItemToInventory("fire_scroll", 50);
-                        player->addItemToInventory("water_scroll", 50);
-                        player->addItemToInventory("poison_scroll", 50);
                     }
                     break;
                 }
-                // Only forward to game input when not on login screen
-                if (!optionsOpen && !loginScreenActive) inputManager->handleKeyDown(event.key);
+            } else if (!optionsOpen && event.key.keysym.sym == SDLK_p) {
+                SimCommand command;
+                command.type = SimCommand::Type::TOGGLE_PAUSE;
+                queueSimCommand(command);
+            } else if (!optionsOpen && event.key.keysym.sym == SDLK_F3) {
+                setDebugHitboxes(!getDebugHitboxes());
+            } else if (!optionsOpen && event.key.keysym.sym == SDLK_F5) {
+                SimCommand command;
+                command.type = SimCommand::Type::TOGGLE_INFINITE_POTIONS;
+                queueSimCommand(command);
+            } else if (!optionsOpen && event.key.keysym.sym == SDLK_F6) {
+                // Manual save
+                std::cout << "Manual save triggered (F6) - User ID: " << loggedInUserId << std::endl;
+                saveCurrentUserState();
+            } else if (!optionsOpen && event.key.keysym.sym == SDLK_F7) {
+                // Debug: Enter underworld
+                SimCommand command;
+                command.type = SimCommand::Type::ENTER_UNDERWORLD;
+                queueSimCommand(command);
+            } else if (!optionsOpen && event.key.keysym.sym == SDLK_F8) {
+                // Debug: Exit underworld
+                SimCommand command;
+                command.type = SimCommand::Type::EXIT_UNDERWORLD;
+                queueSimCommand(command);
+            } else if (!optionsOpen && event.key.keysym.sym == SDLK_i) {
+                // Toggle inventory UI
+                inventoryOpen = !inventoryOpen;
+            } else if (!optionsOpen && event.key.keysym.sym == SDLK_b) {
+                // Toggle spell book
+                uiSystem->toggleSpellBook();
+            } else if (!optionsOpen && event.key.keysym.sym == SDLK_u) {
+                // Toggle equipment UI
+                equipmentOpen = !equipmentOpen;
+            } else if (!optionsOpen && event.key.keysym.sym == SDLK_F9) {
+                // Dev hotkey: grant large stacks of test scrolls
+                SimCommand command;
+                command.type = SimCommand::Type::GRANT_TEST_SCROLLS;
+                queueSimCommand(command);
                 break;
-                
-            case SDL_KEYUP:
-                if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    if (anvilOpen) { anvilOpen = false; break; }
-                    bool wasOpen = optionsOpen;
-                    optionsOpen = !optionsOpen;
-                    // Persist audio + theme whenever options menu closes
-                    if (wasOpen && database && audioManager) {
-                        int uid = loggedInUserId;
-                        if (uid <= 0) { auto defU = database->getUserByName("player"); if (defU) uid = defU->userId; }
-                        if (uid > 0) {
-                            database->saveAudioSettings(uid,
-                                audioManager->getMasterVolume(),
-                                audioManager->getMusicVolume(),
-                                audioManager->getSoundVolume(),
-                                audioManager->getMonsterVolume(),
-                                audioManager->getPlayerVolume());
-                            database->saveTheme(uid, backgroundMusicName);
-                        }
+            }
+            // Only forward to game input when not on login screen
+            if (!optionsOpen && !loginScreenActive) inputManager->handleKeyDown(event.key);
+            break;
+            
+        case SDL_KEYUP:
+            if (event.key.keysym.sym == SDLK_ESCAPE) {
+                if (anvilOpen) { anvilOpen = false; break; }
+                bool wasOpen = optionsOpen;
+                optionsOpen = !optionsOpen;
+                // Persist audio + theme whenever options menu closes
+                if (wasOpen && database && audioManager) {
+                    int uid = loggedInUserId;
+                    if (uid <= 0) { auto defU = database->getUserByName("player"); if (defU) uid = defU->userId; }
+                    if (uid > 0) {
+                        database->saveAudioSettings(uid,
+                            audioManager->getMasterVolume(),
+                            audioManager->getMusicVolume(),
+                            audioManager->getSoundVolume(),
+                            audioManager->getMonsterVolume(),
+                            audioManager->getPlayerVolume());
+                        database->saveTheme(uid, backgroundMusicName);
                     }
-                    break;
                 }
-                if (!optionsOpen) inputManager->handleKeyUp(event.key);
-                else handleOptionsInput(event);
                 break;
-                
-            case SDL_MOUSEBUTTONDOWN: {
-                int mx = event.button.x, my = event.button.y;
-                if (loginScreenActive) {
-                    // Hit test input fields and buttons
-                    int outW=0,outH=0; SDL_GetRendererOutputSize(sdlRenderer,&outW,&outH); if (outW<=0){outW=WINDOW_WIDTH;outH=WINDOW_HEIGHT;}
-                    int panelW=520,panelH=320; SDL_Rect panel{ outW/2 - panelW/2, outH/2 - panelH/2, panelW, panelH };
-                    SDL_Rect userField{ panel.x + 120, panel.y + 85, 300, 28 };
-                    SDL_Rect passField{ panel.x + 120, panel.y + 135, 300, 28 };
-                    SDL_Rect chk{ panel.x + 40, panel.y + 180, 20, 20 }; // remember
-                    SDL_Rect btnLogin{ panel.x + 40, panel.y + panelH - 70, 180, 44 };
-                    SDL_Rect btnRegister{ panel.x + 240, panel.y + panelH - 70, 180, 44 };
-                    if (mx>=userField.x && mx<=userField.x+userField.w && my>=userField.y && my<=userField.y+userField.h) { loginActiveField = LoginField::Username; }
-                    else if (mx>=passField.x && mx<=passField.x+passField.w && my>=passField.y && my<=passField.y+passField.h) { loginActiveField = LoginField::Password; }
-                    else if (mx>=chk.x && mx<=chk.x+chk.w && my>=chk.y && my<=chk.y+chk.h) { loginRemember = !loginRemember; }
-                    else if (mx>=btnLogin.x && mx<=btnLogin.x+btnLogin.w && my>=btnLogin.y && my<=btnLogin.y+btnLogin.h) {
-                        if (database) {
-                            std::string err;
-                            auto u = database->authenticate(loginUsername, loginPassword, &err);
-                            if (u) {
-                                loggedInUserId = u->userId;
-                                loginIsAdmin = (u->role == UserRole::ADMIN);
-                                loginScreenActive = false;
-                                loginError.clear();
-                                if (loginRemember) database->saveRememberState(DatabaseSQLite::RememberState{loginUsername, loginPassword, true}); else database->clearRememberState();
-                                // Load save
-                                auto save = database->loadPlayerState(loggedInUserId);
-                                if (save) player->applySaveState(*save);
-                            } else {
-                                loginError = err.empty()? std::string("Invalid credentials") : err;
-                            }
+            }
+            if (!optionsOpen) inputManager->handleKeyUp(event.key);
+            else handleOptionsInput(event);
+            break;
+            
+        case SDL_MOUSEBUTTONDOWN: {
+            int mx = event.button.x, my = event.button.y;
+            if (loginScreenActive) {
+                // Hit test input fields and buttons
+                int outW=0,outH=0; renderer->getOutputSize(&outW,&outH); if (outW<=0){outW=WINDOW_WIDTH;outH=WINDOW_HEIGHT;}
+                int panelW=520,panelH=320; SDL_Rect panel{ outW/2 - panelW/2, outH/2 - panelH/2, panelW, panelH };
+                SDL_Rect userField{ panel.x + 120, panel.y + 85, 300, 28 };
+                SDL_Rect passField{ panel.x + 120, panel.y + 135, 300, 28 };
+                SDL_Rect chk{ panel.x + 40, panel.y + 180, 20, 20 }; // remember
+                SDL_Rect btnLogin{ panel.x + 40, panel.y + panelH - 70, 180, 44 };
+                SDL_Rect btnRegister{ panel.x + 240, panel.y + panelH - 70, 180, 44 };
+                if (mx>=userField.x && mx<=userField.x+userField.w && my>=userField.y && my<=userField.y+userField.h) { loginActiveField = LoginField::Username; }
+                else if (mx>=passField.x && mx<=passField.x+passField.w && my>=passField.y && my<=passField.y+passField.h) { loginActiveField = LoginField::Password; }
+                else if (mx>=chk.x && mx<=chk.x+chk.w && my>=chk.y && my<=chk.y+chk.h) { loginRemember = !loginRemember; }
+                else if (mx>=btnLogin.x && mx<=btnLogin.x+btnLogin.w && my>=btnLogin.y && my<=btnLogin.y+btnLogin.h) {
+                    if (database) {
+                        std::string err;
+                        auto u = database->authenticate(loginUsername, loginPassword, &err);
+                        if (u) {
+                            loggedInUserId = u->userId;
+                            loginIsAdmin = (u->role == UserRole::ADMIN);
+                            loginScreenActive = false;
+                            loginError.clear();
+                            if (loginRemember) database->saveRememberState(DatabaseSQLite::RememberState{loginUsername, loginPassword, true}); else database->clearRememberState();
+                            // Load save
+                            if (saveWriter) saveWriter->flush(); // don't read a save that is still queued
+                            auto save = database->loadPlayerState(loggedInUserId);
+                            if (save) player->applySaveState(*save);
+                        } else {
+                            loginError = err.empty()? std::string("Invalid credentials") : err;
                         }
-                    } else if (mx>=btnRegister.x && mx<=btnRegister.x+btnRegister.w && my>=btnRegister.y && my<=btnRegister.y+btnRegister.h) {
-                        if (database) {
-                            std::string err;
-                            auto u = database->registerUser(loginUsername, loginPassword, UserRole::PLAYER, &err);
-                            if (u) {
-                                loggedInUserId = u->userId;
-                                loginIsAdmin = false;
-                                loginScreenActive = false;
-                                loginError.clear();
-                                if (loginRemember) database->saveRememberState(DatabaseSQLite::RememberState{loginUsername, loginPassword, true}); else database->clearRememberState();
-                                // Create initial save
-                                database->savePlayerState(loggedInUserId, player->makeSaveState());
-                                // Initialize audio file defaults on first register
-                                if (audioManager) {
-                                    database->saveAudioSettings(loggedInUserId,
-                                        audioManager->getMasterVolume(),
-                                        audioManager->getMusicVolume(),
-                                        audioManager->getSoundVolume(),
-                                        audioManager->getMonsterVolume(),
-                                        audioManager->getPlayerVolume());
-                                    database->saveTheme(loggedInUserId, backgroundMusicName);
-                                }
-                            } else {
-                                loginError = err.empty()? std::string("Registration failed") : err;
+                    }
+                } else if (mx>=btnRegister.x && mx<=btnRegister.x+btnRegister.w && my>=btnRegister.y && my<=btnRegister.y+btnRegister.h) {
+                    if (database) {
+                        std::string err;
+                        auto u = database->registerUser(loginUsername, loginPassword, UserRole::PLAYER, &err);
+                        if (u) {
+                            loggedInUserId = u->userId;
+                            loginIsAdmin = false;
+                            loginScreenActive = false;
+                            loginError.clear();
+                            if (loginRemember) database->saveRememberState(DatabaseSQLite::RememberState{loginUsername, loginPassword, true}); else database->clearRememberState();
+                            // Create initial save
+                            database->savePlayerState(loggedInUserId, player->makeSaveState());
+                            // Initialize audio file defaults on first register
+                            if (audioManager) {
+                                database->saveAudioSettings(loggedInUserId,
+                                    audioManager->getMasterVolume(),
+                                    audioManager->getMusicVolume(),
+                                    audioManager->getSoundVolume(),
+                                    audioManager->getMonsterVolume(),
+                                    audioManager->getPlayerVolume());
+                                database->saveTheme(loggedInUserId, backgroundMusicName);
                             }
+                        } else {
+                            loginError = err.empty()? std::string("Registration failed") : err;
                         }
-                    } else {
-                        loginActiveField = LoginField::None;
                     }
-                } else if (anvilOpen) {
-                    // While anvil is open, do not close on right-click; allow UI to handle quick-use from inventory
                 } else {
-                    inputManager->handleMouseDown(event.button);
+                    loginActiveField = LoginField::None;
                 }
-                break; }
-                
-            case SDL_MOUSEBUTTONUP:
-                inputManager->handleMouseUp(event.button);
-                break;
-                
-            case SDL_MOUSEMOTION:
-                if (!loginScreenActive) inputManager->handleMouseMotion(event.motion);
-                break;
+            } else if (anvilOpen) {
+                // While anvil is open, do not close on right-click; allow UI to handle quick-use from inventory
+            } else {
+                inputManager->handleMouseDown(event.button);
+                if (event.button.button == SDL_BUTTON_LEFT) uiMouseClicked = true;
+            }
+            break; }
+            
+        case SDL_MOUSEBUTTONUP:
+            inputManager->handleMouseUp(event.button);
+            break;
+            
+        case SDL_MOUSEMOTION:
+            if (!loginScreenActive) inputManager->handleMouseMotion(event.motion);
+            break;
 
-            case SDL_TEXTINPUT:
-                if (loginScreenActive) {
-                    if (loginActiveField == LoginField::Password) loginPassword += event.text.text;
-                    else /* Username or None default to Username */ loginUsername += event.text.text;
-                }
-                break;
-        }
+        case SDL_TEXTINPUT:
+            if (loginScreenActive) {
+                if (loginActiveField == LoginField::Password) loginPassword += event.text.text;
+                else /* Username or None default to Username */ loginUsername += event.text.text;
+            }
+            break;
     }
 }
 
@@ -2122,20 +2426,25 @@ void Game::renderOptionsMenuOverlay() {
         playerVolCache  = audioManager ? audioManager->getPlayerVolume()  : playerVolCache;
     }
     // Basic flags from window/renderer
-    Uint32 winFlags = SDL_GetWindowFlags(window);
-    bool fullscreen = (winFlags & SDL_WINDOW_FULLSCREEN) || (winFlags & SDL_WINDOW_FULLSCREEN_DESKTOP);
+    bool fullscreen = windowFullscreen.load();
     bool vsync = true; // We created renderer with PRESENTVSYNC
-    int mx, my; Uint32 mouse = SDL_GetMouseState(&mx, &my);
-    bool mouseDown = (mouse & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
+    int mx = uiMouseX, my = uiMouseY;
+    bool mouseDown = (uiMouseButtons & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
     UISystem::MenuHitResult hit;
     static UISystem::OptionsTab activeTab = UISystem::OptionsTab::Main;
+    // Slider order matches the bus order: Master, Music, Sound, Monster, Player
+    float peaks[static_cast<int>(AudioBus::COUNT)] = {};
+    if (audioManager) {
+        for (int b = 0; b < static_cast<int>(AudioBus::COUNT); ++b) peaks[b] = audioManager->getBusPeak(static_cast<AudioBus>(b));
+    }
     uiSystem->renderOptionsMenu(optionsSelectedIndex,
                                 master, music, sound,
                                 monsterVolCache, playerVolCache,
                                 fullscreen, vsync,
                                 activeTab,
                                 mx, my, mouseDown,
-                                hit);
+                                hit,
+                                peaks);
     // If a theme selection was just made, consume the edge so other controls remain interactive
     if (hit.newThemeIndex != -1) {
         // Nothing else to do here; selection will be applied below
@@ -2191,10 +2500,8 @@ void Game::renderOptionsMenuOverlay() {
         // Regenerate world visibility and reposition player at spawn
         if (world && player) {
             // Reset enemies
-            auto& enemies = world->getEnemies();
-            for (auto& e : enemies) {
-                if (e) e->resetToSpawn();
-            }
+            world->getStatusEffects().clear();
+            world->resetEnemiesToSpawn();
             // Teleport player to spawn and clear projectiles
             player->respawn(player->getSpawnX(), player->getSpawnY());
             world->updateVisibility(player->getX(), player->getY());
@@ -2210,19 +2517,10 @@ void Game::renderOptionsMenuOverlay() {
         optionsOpen = false;
     }
     if (hit.clickedFullscreen) {
-        Uint32 flags = SDL_GetWindowFlags(window);
-        bool fs = (flags & SDL_WINDOW_FULLSCREEN) || (flags & SDL_WINDOW_FULLSCREEN_DESKTOP);
-        SDL_SetWindowFullscreen(window, fs ? 0 : SDL_WINDOW_FULLSCREEN_DESKTOP);
-        // After toggling full screen, recenter camera on the player
+        // The window belongs to the main thread, which toggles it before its next frame; the camera
+        // follows the new output size from the next recorded frame on
+        fullscreenToggleRequested = true;
         if (player) {
-            int playerX = static_cast<int>(player->getX());
-            int playerY = static_cast<int>(player->getY());
-            int outW=0,outH=0; SDL_GetRendererOutputSize(sdlRenderer, &outW, &outH);
-            if (outW <= 0) { outW = WINDOW_WIDTH; outH = WINDOW_HEIGHT; }
-            float zoom = renderer->getZoom();
-            int cameraX = static_cast<int>(playerX - (outW / (2.0f * zoom)));
-            int cameraY = static_cast<int>(playerY - (outH / (2.0f * zoom)));
-            renderer->setCamera(cameraX, cameraY);
             if (world) {
                 world->updateVisibleChunks(player->getX(), player->getY());
                 world->updateVisibility(player->getX(), player->getY());
@@ -2409,6 +2707,9 @@ void Game::initializeObjects() {
 void Game::cleanup() {
     // Systems will be cleaned up automatically via unique_ptr destructors
     
+    // Panel textures belong to the renderer, so release them before it goes away
+    if (renderer) renderer->invalidatePanels();
+    
     if (sdlRenderer) {
         SDL_DestroyRenderer(sdlRenderer);
         sdlRenderer = nullptr;
@@ -2421,18 +2722,86 @@ void Game::cleanup() {
 }
 
 void Game::saveCurrentUserState() {
-    if (database && loggedInUserId > 0 && player) {
-        try {
-            std::string error;
-            bool success = database->savePlayerState(loggedInUserId, player->makeSaveState(), &error);
-            if (!success) {
-                std::cout << "Error saving player state: " << error << std::endl;
-            }
-        } catch (const std::exception& e) {
-            std::cout << "Exception during save: " << e.what() << std::endl;
-        } catch (...) {
-            std::cout << "Unknown exception during save" << std::endl;
-        }
+    // Snapshot on the game thread; the write itself happens on the SaveWriter thread
+    if (saveWriter && loggedInUserId > 0 && player) {
+        saveWriter->enqueue(loggedInUserId, player->makeSaveState());
+    }
+}
+
+void Game::beginRecording() {
+    ReplaySession session;
+    session.seed = Random::getSeed();
+    session.tickRate = SIM_TICK_RATE;
+    session.infinitePotions = infinitePotions;
+    session.keyBindings = inputManager->serializeBindings();
+    if (player) session.playerSave = SaveFormat::encode(player->makeSaveState());
+
+    std::string error;
+    replayStartTick = inputManager->getTick();
+    inputRecorder = InputRecorder::create(launchOptions.recordPath, session, replayStartTick, &error);
+    if (!inputRecorder) {
+        std::cerr << "Input recording disabled: " << error << std::endl;
+        launchOptions.recordPath.clear();
+        return;
+    }
+    inputManager->setJournalEnabled(true);
+    std::cout << "Recording input to " << launchOptions.recordPath << std::endl;
+}
+
+void Game::startReplay() {
+    const ReplaySession& session = inputPlayer->getSession();
+    if (session.tickRate != SIM_TICK_RATE) {
+        std::cerr << "Replay was recorded at " << session.tickRate << " ticks/s, this build runs " << SIM_TICK_RATE
+                  << "; it will not play back the same" << std::endl;
+    }
+    // Play as nobody so nothing from the replay lands in a real save
+    loginScreenActive = false;
+    loggedInUserId = -1;
+    infinitePotions = session.infinitePotions;
+    inputManager->resetBindingsToDefault();
+    inputManager->parseBindings(session.keyBindings);
+    std::string error;
+    if (auto save = SaveFormat::decode(session.playerSave, &error)) {
+        player->applySaveState(*save);
+    } else {
+        std::cerr << "Replay has no usable player state: " << error << std::endl;
+    }
+    replayStartTick = inputManager->getTick();
+    replayFrameCounter = SDL_GetPerformanceCounter();
+    std::cout << "Replaying " << launchOptions.replayPath << " (" << inputPlayer->getLength() << " ticks)" << std::endl;
+}
+
+void Game::finishReplay() {
+    isRunning = false;
+    if (replayFrameMs.empty()) return;
+    std::vector<float> sorted = replayFrameMs;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (float ms : sorted) total += ms;
+    std::cout << "Replay finished: " << inputManager->getTick() - replayStartTick << " ticks, " << sorted.size()
+              << " frames in " << total / 1000.0 << " s; frame ms avg " << total / sorted.size()
+              << ", p50 " << sorted[sorted.size() / 2] << ", p99 " << sorted[sorted.size() * 99 / 100]
+              << ", max " << sorted.back() << std::endl;
+    if (!launchOptions.frameLogPath.empty()) {
+        std::ofstream log(launchOptions.frameLogPath);
+        for (float ms : replayFrameMs) log << ms << '\n';
+        if (!log) std::cerr << "Cannot write frame log " << launchOptions.frameLogPath << std::endl;
+    }
+}
+
+void Game::saveKeyBindings() {
+    if (database && inputManager && loggedInUserId > 0) {
+        database->saveKeyBindings(loggedInUserId, inputManager->serializeBindings());
+    }
+}
+
+void Game::loadKeyBindings(int userId) {
+    if (!database || !inputManager) return;
+    // Start from the defaults so a previous user's rebinds never carry over
+    inputManager->resetBindingsToDefault();
+    std::string bindings;
+    if (database->loadKeyBindings(userId, bindings) && !inputManager->parseBindings(bindings)) {
+        std::cerr << "Ignoring unreadable key bindings for user " << userId << std::endl;
     }
 }
 
@@ -2458,6 +2827,6 @@ void Game::updatePerformanceMetrics() {
         }
         averageFPS = sum / fpsHistory.size();
     } else {
-        averageFPS = currentFPS;
+        averageFPS = currentFPS.load();
     }
 }
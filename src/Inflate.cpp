@@ -0,0 +1,245 @@
+#include "Inflate.h"
+#include <array>
+
+namespace {
+
+// Canonical Huffman table: how many codes of each length, then symbols ordered by code
+struct Huffman {
+    uint16_t counts[16];
+    uint16_t symbols[288];
+};
+
+class Inflater {
+public:
+    Inflater(const uint8_t* data, size_t size, std::vector<uint8_t>& out) : in(data), inSize(size), out(out) {}
+
+    bool run() {
+        bool last = false;
+        while (!last && !failed) {
+            last = bits(1) != 0;
+            switch (bits(2)) {
+                case 0: stored(); break;
+                case 1: fixed(); break;
+                case 2: dynamic(); break;
+                default: failed = true; break;
+            }
+        }
+        return !failed;
+    }
+    // Bytes consumed so far (whole bytes; the final partial byte counts as consumed)
+    size_t consumed() const { return pos; }
+
+private:
+    const uint8_t* in;
+    size_t inSize;
+    size_t pos = 0;
+    uint32_t bitBuffer = 0;
+    int bitCount = 0;
+    bool failed = false;
+    std::vector<uint8_t>& out;
+
+    int bits(int need) {
+        while (bitCount < need) {
+            if (pos >= inSize) { failed = true; return 0; }
+            bitBuffer |= static_cast<uint32_t>(in[pos++]) << bitCount;
+            bitCount += 8;
+        }
+        int value = static_cast<int>(bitBuffer & ((1u << need) - 1));
+        bitBuffer >>= need;
+        bitCount -= need;
+        return value;
+    }
+
+    int decode(const Huffman& h) {
+        int code = 0, first = 0, index = 0;
+        for (int len = 1; len < 16; ++len) {
+            code |= bits(1);
+            if (failed) return -1;
+            int count = h.counts[len];
+            if (code - count < first) return h.symbols[index + (code - first)];
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        failed = true; // ran out of codes
+        return -1;
+    }
+
+    // Returns false if the lengths over-subscribe the code space
+    static bool build(Huffman& h, const uint8_t* lengths, int n) {
+        for (auto& c : h.counts) c = 0;
+        for (int s = 0; s < n; ++s) h.counts[lengths[s]]++;
+        if (h.counts[0] == n) return true; // no codes; only an error if one gets decoded
+        int left = 1;
+        for (int len = 1; len < 16; ++len) {
+            left <<= 1;
+            left -= h.counts[len];
+            if (left < 0) return false;
+        }
+        uint16_t offsets[16];
+        offsets[1] = 0;
+        for (int len = 1; len < 15; ++len) offsets[len + 1] = static_cast<uint16_t>(offsets[len] + h.counts[len]);
+        for (int s = 0; s < n; ++s) if (lengths[s]) h.symbols[offsets[lengths[s]]++] = static_cast<uint16_t>(s);
+        return true;
+    }
+
+    void stored() {
+        bitBuffer = 0; bitCount = 0; // skip to the byte boundary
+        if (pos + 4 > inSize) { failed = true; return; }
+        unsigned len = in[pos] | (in[pos + 1] << 8);
+        unsigned nlen = in[pos + 2] | (in[pos + 3] << 8);
+        pos += 4;
+        if (len != (~nlen & 0xFFFFu) || pos + len > inSize) { failed = true; return; }
+        out.insert(out.end(), in + pos, in + pos + len);
+        pos += len;
+    }
+
+    void codes(const Huffman& lengthCodes, const Huffman& distCodes) {
+        static const uint16_t lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        static const uint8_t lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        static const uint16_t distBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        static const uint8_t distExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+        while (!failed) {
+            int symbol = decode(lengthCodes);
+            if (symbol < 0) return;
+            if (symbol < 256) { out.push_back(static_cast<uint8_t>(symbol)); continue; }
+            if (symbol == 256) return; // end of block
+            symbol -= 257;
+            if (symbol >= 29) { failed = true; return; }
+            size_t length = lengthBase[symbol] + bits(lengthExtra[symbol]);
+            int distSymbol = decode(distCodes);
+            if (distSymbol < 0 || distSymbol >= 30) { failed = true; return; }
+            size_t distance = distBase[distSymbol] + bits(distExtra[distSymbol]);
+            if (failed || distance > out.size()) { failed = true; return; }
+            size_t from = out.size() - distance;
+            for (size_t i = 0; i < length; ++i) out.push_back(out[from + i]); // may overlap
+        }
+    }
+
+    void fixed() {
+        struct FixedCodes {
+            Huffman lengthCodes, distCodes;
+            FixedCodes() {
+                uint8_t lengths[288];
+                int s = 0;
+                for (; s < 144; ++s) lengths[s] = 8;
+                for (; s < 256; ++s) lengths[s] = 9;
+                for (; s < 280; ++s) lengths[s] = 7;
+                for (; s < 288; ++s) lengths[s] = 8;
+                build(lengthCodes, lengths, 288);
+                for (s = 0; s < 30; ++s) lengths[s] = 5;
+                build(distCodes, lengths, 30);
+            }
+        };
+        static const FixedCodes fixedCodes;
+        codes(fixedCodes.lengthCodes, fixedCodes.distCodes);
+    }
+
+    void dynamic() {
+        static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+        const int nlen = bits(5) + 257;
+        const int ndist = bits(5) + 1;
+        const int ncode = bits(4) + 4;
+        if (failed || nlen > 286 || ndist > 30) { failed = true; return; }
+
+        uint8_t lengths[320] = {};
+        for (int i = 0; i < ncode; ++i) lengths[order[i]] = static_cast<uint8_t>(bits(3));
+        Huffman lengthCodes, distCodes;
+        if (failed || !build(lengthCodes, lengths, 19)) { failed = true; return; }
+
+        for (int i = 0; i < 19; ++i) lengths[i] = 0;
+        int index = 0;
+        while (index < nlen + ndist && !failed) {
+            int symbol = decode(lengthCodes);
+            if (symbol < 0) return;
+            if (symbol < 16) { lengths[index++] = static_cast<uint8_t>(symbol); continue; }
+            uint8_t value = 0;
+            int repeat;
+            if (symbol == 16) {
+                if (index == 0) { failed = true; return; }
+                value = lengths[index - 1];
+                repeat = 3 + bits(2);
+            } else if (symbol == 17) {
+                repeat = 3 + bits(3);
+            } else {
+                repeat = 11 + bits(7);
+            }
+            if (index + repeat > nlen + ndist) { failed = true; return; }
+            while (repeat--) lengths[index++] = value;
+        }
+        if (failed || lengths[256] == 0) { failed = true; return; } // block must be able to end
+        if (!build(lengthCodes, lengths, nlen) || !build(distCodes, lengths + nlen, ndist)) { failed = true; return; }
+        codes(lengthCodes, distCodes);
+    }
+};
+
+uint32_t adler32(const uint8_t* data, size_t size) {
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < size; ++i) {
+        a = (a + data[i]) % 65521u;
+        b = (b + a) % 65521u;
+    }
+    return (b << 16) | a;
+}
+
+uint32_t crc32(const uint8_t* data, size_t size) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+} // namespace
+
+bool inflateRaw(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    Inflater inflater(data, size, out);
+    return inflater.run();
+}
+
+bool inflateZlib(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    if (size < 6) return false;
+    const uint8_t cmf = data[0], flg = data[1];
+    if ((cmf & 0x0F) != 8 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20)) return false; // deflate, no preset dictionary
+    const size_t start = out.size();
+    Inflater inflater(data + 2, size - 2, out);
+    if (!inflater.run()) return false;
+    const size_t trailer = 2 + inflater.consumed();
+    if (trailer + 4 > size) return false;
+    const uint32_t expected = (uint32_t(data[trailer]) << 24) | (uint32_t(data[trailer + 1]) << 16) |
+                              (uint32_t(data[trailer + 2]) << 8) | data[trailer + 3];
+    return adler32(out.data() + start, out.size() - start) == expected;
+}
+
+bool inflateGzip(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    if (size < 18 || data[0] != 0x1F || data[1] != 0x8B || data[2] != 8) return false;
+    const uint8_t flags = data[3];
+    size_t pos = 10;
+    if (flags & 0x04) { // FEXTRA
+        if (pos + 2 > size) return false;
+        pos += 2 + (data[pos] | (data[pos + 1] << 8));
+    }
+    if (flags & 0x08) { while (pos < size && data[pos]) ++pos; ++pos; } // FNAME
+    if (flags & 0x10) { while (pos < size && data[pos]) ++pos; ++pos; } // FCOMMENT
+    if (flags & 0x02) pos += 2;                                         // FHCRC
+    if (pos >= size) return false;
+    const size_t start = out.size();
+    Inflater inflater(data + pos, size - pos, out);
+    if (!inflater.run()) return false;
+    // Trailer: CRC-32 and size mod 2^32 of the uncompressed data, both little-endian
+    const size_t trailer = pos + inflater.consumed();
+    if (trailer + 8 > size) return false;
+    auto le32 = [&](size_t at) {
+        return uint32_t(data[at]) | (uint32_t(data[at + 1]) << 8) | (uint32_t(data[at + 2]) << 16) | (uint32_t(data[at + 3]) << 24);
+    };
+    const size_t produced = out.size() - start;
+    return crc32(out.data() + start, produced) == le32(trailer) && static_cast<uint32_t>(produced) == le32(trailer + 4);
+}
@@ -1,5 +1,8 @@
 #include "InputManager.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <iostream>
 
 InputManager::InputManager() : mouseX(0), mouseY(0), previousMouseX(0), previousMouseY(0) {
     // Initialize all states to RELEASED
@@ -12,61 +15,230 @@ InputManager::InputManager() : mouseX(0), mouseY(0), previousMouseX(0), previous
 }
 
 void InputManager::initializeKeyBindings() {
+    for (auto& set : bindings) set.fill(InputBinding{});
+
     // Movement keys (WASD)
-    actionToKey[InputAction::MOVE_UP] = SDL_SCANCODE_W;
-    actionToKey[InputAction::MOVE_DOWN] = SDL_SCANCODE_S;
-    actionToKey[InputAction::MOVE_LEFT] = SDL_SCANCODE_A;
-    actionToKey[InputAction::MOVE_RIGHT] = SDL_SCANCODE_D;
+    bindKey(InputAction::MOVE_UP, SDL_SCANCODE_W);
+    bindKey(InputAction::MOVE_DOWN, SDL_SCANCODE_S);
+    bindKey(InputAction::MOVE_LEFT, SDL_SCANCODE_A);
+    bindKey(InputAction::MOVE_RIGHT, SDL_SCANCODE_D);
     
-    // Combat keys
-    actionToKey[InputAction::ATTACK_MELEE] = SDL_SCANCODE_UNKNOWN; // mouse left only
-    actionToKey[InputAction::ATTACK_RANGED] = SDL_SCANCODE_LSHIFT;
+    // Combat keys; melee is mouse left only
+    bindKey(InputAction::ATTACK_RANGED, SDL_SCANCODE_LSHIFT);
     // Dash ability on spacebar
-    actionToKey[InputAction::DASH] = SDL_SCANCODE_SPACE;
+    bindKey(InputAction::DASH, SDL_SCANCODE_SPACE);
     // Fire shield on F key
-    actionToKey[InputAction::SHIELD] = SDL_SCANCODE_F;
+    bindKey(InputAction::SHIELD, SDL_SCANCODE_F);
     
     // Interaction keys
-    actionToKey[InputAction::INTERACT] = SDL_SCANCODE_E;
-    actionToKey[InputAction::INVENTORY] = SDL_SCANCODE_I;
-    actionToKey[InputAction::PAUSE] = SDL_SCANCODE_P;
-    actionToKey[InputAction::QUIT] = SDL_SCANCODE_ESCAPE;
+    bindKey(InputAction::INTERACT, SDL_SCANCODE_E);
+    bindKey(InputAction::INVENTORY, SDL_SCANCODE_I);
+    bindKey(InputAction::PAUSE, SDL_SCANCODE_P);
+    bindKey(InputAction::QUIT, SDL_SCANCODE_ESCAPE);
 
     // Consumables
-    actionToKey[InputAction::USE_HP_POTION] = SDL_SCANCODE_1;
-    actionToKey[InputAction::USE_MP_POTION] = SDL_SCANCODE_2;
+    bindKey(InputAction::USE_HP_POTION, SDL_SCANCODE_1);
+    bindKey(InputAction::USE_MP_POTION, SDL_SCANCODE_2);
     
     // Mouse bindings
-    actionToMouseButton[InputAction::ATTACK_MELEE] = SDL_BUTTON_LEFT;
-    actionToMouseButton[InputAction::ATTACK_RANGED] = SDL_BUTTON_RIGHT;
-    actionToMouseButton[InputAction::INTERACT] = SDL_BUTTON_MIDDLE;
+    bindMouseButton(InputAction::ATTACK_MELEE, SDL_BUTTON_LEFT);
+    bindMouseButton(InputAction::ATTACK_RANGED, SDL_BUTTON_RIGHT);
+    bindMouseButton(InputAction::INTERACT, SDL_BUTTON_MIDDLE);
+}
+
+void InputManager::resetBindingsToDefault() {
+    initializeKeyBindings();
+}
+
+bool InputManager::addBinding(InputAction action, InputBinding binding) {
+    int index = static_cast<int>(action);
+    if (index < 0 || index >= ACTION_COUNT) return false;
+    BindingSet& set = bindings[index];
+    for (const auto& existing : set) {
+        if (existing.device == binding.device && existing.code == binding.code) return true;
+    }
+    for (auto& slot : set) {
+        if (slot.device == InputBinding::Device::NONE) {
+            slot = binding;
+            return true;
+        }
+    }
+    return false; // all slots taken
+}
+
+bool InputManager::bindKey(InputAction action, SDL_Scancode scancode) {
+    if (scancode <= SDL_SCANCODE_UNKNOWN || scancode >= SDL_NUM_SCANCODES) return false;
+    return addBinding(action, InputBinding{InputBinding::Device::KEY, static_cast<uint16_t>(scancode)});
+}
+
+bool InputManager::bindMouseButton(InputAction action, int button) {
+    if (button < 1 || button > MOUSE_BUTTON_COUNT) return false;
+    return addBinding(action, InputBinding{InputBinding::Device::MOUSE, static_cast<uint16_t>(button)});
+}
+
+void InputManager::unbind(InputAction action, InputBinding binding) {
+    int index = static_cast<int>(action);
+    if (index < 0 || index >= ACTION_COUNT) return;
+    BindingSet& set = bindings[index];
+    // Keep the set packed so slot order matches bind order
+    auto last = std::remove_if(set.begin(), set.end(), [&](const InputBinding& b) {
+        return b.device == binding.device && b.code == binding.code;
+    });
+    std::fill(last, set.end(), InputBinding{});
+}
+
+void InputManager::clearBindings(InputAction action) {
+    int index = static_cast<int>(action);
+    if (index >= 0 && index < ACTION_COUNT) bindings[index].fill(InputBinding{});
+}
+
+const char* InputManager::getActionName(InputAction action) {
+    static const char* const names[ACTION_COUNT] = {
+        "MOVE_UP", "MOVE_DOWN", "MOVE_LEFT", "MOVE_RIGHT", "ATTACK_MELEE", "ATTACK_RANGED", "DASH",
+        "INTERACT", "INVENTORY", "PAUSE", "QUIT", "USE_HP_POTION", "USE_MP_POTION", "SHIELD"
+    };
+    int index = static_cast<int>(action);
+    return index >= 0 && index < ACTION_COUNT ? names[index] : "";
+}
+
+std::string InputManager::serializeBindings() const {
+    // Scancodes are USB HID usage ids, so the numbers are stable across platforms and SDL versions
+    std::string text;
+    for (int a = 0; a < ACTION_COUNT; ++a) {
+        if (!text.empty()) text += ';';
+        text += getActionName(static_cast<InputAction>(a));
+        text += '=';
+        bool first = true;
+        for (const auto& binding : bindings[a]) {
+            if (binding.device == InputBinding::Device::NONE) continue;
+            if (!first) text += ',';
+            text += binding.device == InputBinding::Device::KEY ? 'k' : 'm';
+            text += std::to_string(binding.code);
+            first = false;
+        }
+    }
+    return text;
+}
+
+bool InputManager::parseBindings(const std::string& text) {
+    bool parsedAny = false;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(';', pos);
+        if (end == std::string::npos) end = text.size();
+        const std::string entry = text.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t eq = entry.find('=');
+        if (eq == std::string::npos) continue;
+        const std::string name = entry.substr(0, eq);
+        int action = 0;
+        while (action < ACTION_COUNT && name != getActionName(static_cast<InputAction>(action))) ++action;
+        if (action == ACTION_COUNT) continue; // action from a newer or older build
+
+        BindingSet set{};
+        int count = 0;
+        size_t itemPos = eq + 1;
+        while (itemPos < entry.size() && count < MAX_BINDINGS_PER_ACTION) {
+            size_t itemEnd = entry.find(',', itemPos);
+            if (itemEnd == std::string::npos) itemEnd = entry.size();
+            const std::string item = entry.substr(itemPos, itemEnd - itemPos);
+            itemPos = itemEnd + 1;
+            if (item.size() < 2 || (item[0] != 'k' && item[0] != 'm')) continue;
+            const int code = std::atoi(item.c_str() + 1);
+            const bool isKey = item[0] == 'k';
+            if (isKey ? (code <= SDL_SCANCODE_UNKNOWN || code >= SDL_NUM_SCANCODES) : (code < 1 || code > MOUSE_BUTTON_COUNT)) continue;
+            set[count++] = InputBinding{isKey ? InputBinding::Device::KEY : InputBinding::Device::MOUSE, static_cast<uint16_t>(code)};
+        }
+        bindings[action] = set;
+        parsedAny = true;
+    }
+    return parsedAny;
 }
 
 void InputManager::handleKeyDown(const SDL_KeyboardEvent& event) {
-    updateKeyState(event.keysym.scancode, true);
+    record(InputCommand::Type::KEY_DOWN, event.keysym.scancode, event.timestamp);
 }
 
 void InputManager::handleKeyUp(const SDL_KeyboardEvent& event) {
-    updateKeyState(event.keysym.scancode, false);
+    record(InputCommand::Type::KEY_UP, event.keysym.scancode, event.timestamp);
 }
 
 void InputManager::handleMouseDown(const SDL_MouseButtonEvent& event) {
-    updateMouseButtonState(event.button, true);
+    record(InputCommand::Type::MOUSE_DOWN, event.button, event.timestamp);
 }
 
 void InputManager::handleMouseUp(const SDL_MouseButtonEvent& event) {
-    updateMouseButtonState(event.button, false);
+    record(InputCommand::Type::MOUSE_UP, event.button, event.timestamp);
 }
 
 void InputManager::handleMouseMotion(const SDL_MouseMotionEvent& event) {
-    previousMouseX = mouseX;
-    previousMouseY = mouseY;
-    mouseX = event.x;
-    mouseY = event.y;
+    record(InputCommand::Type::MOUSE_MOTION, 0, event.timestamp, event.x, event.y);
+}
+
+void InputManager::record(InputCommand::Type type, int code, uint32_t timestamp, int x, int y) {
+    InputCommand command;
+    command.type = type;
+    command.code = code;
+    command.x = x;
+    command.y = y;
+    command.timestamp = timestamp;
+    if (!pendingInput.push(command)) {
+        std::cout << "Input queue full; dropping event" << std::endl;
+    }
+}
+
+void InputManager::inject(const InputCommand& command) {
+    if (!pendingInput.push(command)) {
+        std::cout << "Input queue full; dropping event" << std::endl;
+    }
+}
+
+void InputManager::applyPendingInput() {
+    InputCommand command;
+    while (pendingInput.pop(command)) {
+        apply(command);
+        if (journalEnabled) journal.push_back(InputJournalEntry{tick, command});
+    }
+    ++tick;
+}
+
+void InputManager::setJournalEnabled(bool enabled) {
+    journalEnabled = enabled;
+    if (enabled) journal.clear();
+}
+
+std::vector<InputJournalEntry> InputManager::takeJournal() {
+    std::vector<InputJournalEntry> taken;
+    taken.swap(journal);
+    return taken;
+}
+
+void InputManager::apply(const InputCommand& command) {
+    switch (command.type) {
+        case InputCommand::Type::KEY_DOWN:
+            updateKeyState(static_cast<SDL_Scancode>(command.code), true);
+            break;
+        case InputCommand::Type::KEY_UP:
+            updateKeyState(static_cast<SDL_Scancode>(command.code), false);
+            break;
+        case InputCommand::Type::MOUSE_DOWN:
+            updateMouseButtonState(command.code, true);
+            break;
+        case InputCommand::Type::MOUSE_UP:
+            updateMouseButtonState(command.code, false);
+            break;
+        case InputCommand::Type::MOUSE_MOTION:
+            previousMouseX = mouseX;
+            previousMouseY = mouseY;
+            mouseX = command.x;
+            mouseY = command.y;
+            break;
+    }
 }
 
 void InputManager::updateKeyState(SDL_Scancode scancode, bool pressed) {
-    if (scancode >= 0 && scancode < 256) {
+    if (scancode >= 0 && scancode < SDL_NUM_SCANCODES) {
         if (pressed) {
             if (keyStates[scancode] == InputState::RELEASED) {
                 keyStates[scancode] = InputState::PRESSED;
@@ -80,7 +252,7 @@ void InputManager::updateKeyState(SDL_Scancode scancode, bool pressed) {
 }
 
 void InputManager::updateMouseButtonState(int button, bool pressed) {
-    if (button >= 1 && button <= 5) {
+    if (button >= 1 && button <= MOUSE_BUTTON_COUNT) {
         int index = button - 1;
         if (pressed) {
             if (mouseButtonStates[index] == InputState::RELEASED) {
@@ -95,84 +267,42 @@ void InputManager::updateMouseButtonState(int button, bool pressed) {
 }
 
 bool InputManager::isActionPressed(InputAction action) const {
-    // Check keyboard
-    auto keyIt = actionToKey.find(action);
-    if (keyIt != actionToKey.end()) {
-        SDL_Scancode scancode = keyIt->second;
-        if (scancode >= 0 && scancode < 256) {
-            // Check if key was just pressed this frame (current state is PRESSED and previous state was RELEASED)
-            if (keyStates[scancode] == InputState::PRESSED && 
-                previousKeyStates[scancode] == InputState::RELEASED) {
-                return true;
-            }
-        }
-    }
-    
-    // Check mouse
-    auto mouseIt = actionToMouseButton.find(action);
-    if (mouseIt != actionToMouseButton.end()) {
-        int button = mouseIt->second;
-        if (button >= 1 && button <= 5) {
-            int index = button - 1;
-            // Check if mouse button was just pressed this frame
-            if (mouseButtonStates[index] == InputState::PRESSED && 
-                previousMouseButtonStates[index] == InputState::RELEASED) {
-                return true;
-            }
+    int index = static_cast<int>(action);
+    if (index < 0 || index >= ACTION_COUNT) return false;
+    for (const auto& binding : bindings[index]) {
+        if (binding.device == InputBinding::Device::NONE) break;
+        // Just pressed this frame: current state is PRESSED and previous state was RELEASED
+        if (getBindingState(binding) == InputState::PRESSED &&
+            getPreviousBindingState(binding) == InputState::RELEASED) {
+            return true;
         }
     }
-    
     return false;
 }
 
 bool InputManager::isActionHeld(InputAction action) const {
-    // Check keyboard
-    auto keyIt = actionToKey.find(action);
-    if (keyIt != actionToKey.end()) {
-        InputState state = getKeyState(keyIt->second);
+    int index = static_cast<int>(action);
+    if (index < 0 || index >= ACTION_COUNT) return false;
+    for (const auto& binding : bindings[index]) {
+        if (binding.device == InputBinding::Device::NONE) break;
+        InputState state = getBindingState(binding);
         if (state == InputState::PRESSED || state == InputState::HELD) {
             return true;
         }
     }
-    
-    // Check mouse
-    auto mouseIt = actionToMouseButton.find(action);
-    if (mouseIt != actionToMouseButton.end()) {
-        InputState state = getMouseButtonState(mouseIt->second);
-        if (state == InputState::PRESSED || state == InputState::HELD) {
-            return true;
-        }
-    }
-    
     return false;
 }
 
 bool InputManager::isActionReleased(InputAction action) const {
-    // Check keyboard
-    auto keyIt = actionToKey.find(action);
-    if (keyIt != actionToKey.end()) {
-        SDL_Scancode scancode = keyIt->second;
-        if (scancode >= 0 && scancode < 256) {
-            if (previousKeyStates[scancode] != InputState::RELEASED && 
-                keyStates[scancode] == InputState::RELEASED) {
-                return true;
-            }
-        }
-    }
-    
-    // Check mouse
-    auto mouseIt = actionToMouseButton.find(action);
-    if (mouseIt != actionToMouseButton.end()) {
-        int button = mouseIt->second;
-        if (button >= 1 && button <= 5) {
-            int index = button - 1;
-            if (previousMouseButtonStates[index] != InputState::RELEASED && 
-                mouseButtonStates[index] == InputState::RELEASED) {
-                return true;
-            }
+    int index = static_cast<int>(action);
+    if (index < 0 || index >= ACTION_COUNT) return false;
+    for (const auto& binding : bindings[index]) {
+        if (binding.device == InputBinding::Device::NONE) break;
+        if (getPreviousBindingState(binding) != InputState::RELEASED &&
+            getBindingState(binding) == InputState::RELEASED) {
+            return true;
         }
     }
-    
     return false;
 }
 
@@ -185,6 +315,11 @@ bool InputManager::isMouseButtonHeld(int button) const {
     return state == InputState::PRESSED || state == InputState::HELD;
 }
 
+bool InputManager::isKeyHeld(SDL_Scancode scancode) const {
+    InputState state = getKeyState(scancode);
+    return state == InputState::PRESSED || state == InputState::HELD;
+}
+
 void InputManager::getMovementVector(float& x, float& y) const {
     x = 0.0f;
     y = 0.0f;
@@ -228,15 +363,28 @@ void InputManager::reset() {
     previousMouseButtonStates.fill(InputState::RELEASED);
 }
 
+InputState InputManager::getBindingState(const InputBinding& binding) const {
+    // Codes are range-checked when bound
+    if (binding.device == InputBinding::Device::KEY) return keyStates[binding.code];
+    if (binding.device == InputBinding::Device::MOUSE) return mouseButtonStates[binding.code - 1];
+    return InputState::RELEASED;
+}
+
+InputState InputManager::getPreviousBindingState(const InputBinding& binding) const {
+    if (binding.device == InputBinding::Device::KEY) return previousKeyStates[binding.code];
+    if (binding.device == InputBinding::Device::MOUSE) return previousMouseButtonStates[binding.code - 1];
+    return InputState::RELEASED;
+}
+
 InputState InputManager::getKeyState(SDL_Scancode scancode) const {
-    if (scancode >= 0 && scancode < 256) {
+    if (scancode >= 0 && scancode < SDL_NUM_SCANCODES) {
         return keyStates[scancode];
     }
     return InputState::RELEASED;
 }
 
 InputState InputManager::getMouseButtonState(int button) const {
-    if (button >= 1 && button <= 5) {
+    if (button >= 1 && button <= MOUSE_BUTTON_COUNT) {
         return mouseButtonStates[button - 1];
     }
     return InputState::RELEASED;
@@ -0,0 +1,276 @@
+#include "InputReplay.h"
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+static const char MAGIC[4] = {'P', 'X', 'R', 'P'};
+static const uint16_t FLAG_INFINITE_POTIONS = 1;
+
+namespace {
+
+void putVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void putSint(std::string& out, int v) {
+    putVarint(out, (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31)); // zigzag
+}
+
+void putLE(std::string& out, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+void putString(std::string& out, const std::string& s) {
+    putVarint(out, s.size());
+    out += s;
+}
+
+class Reader {
+public:
+    Reader(const std::vector<uint8_t>& data, size_t& pos) : data(data), pos(pos) {}
+
+    bool ok() const { return good; }
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= data.size()) { good = false; return 0; }
+            uint8_t b = data[pos++];
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        good = false;
+        return 0;
+    }
+    int sint() {
+        uint32_t v = static_cast<uint32_t>(varint());
+        return static_cast<int>((v >> 1) ^ (~(v & 1) + 1)); // un-zigzag
+    }
+    uint64_t le(int bytes) {
+        if (data.size() - pos < static_cast<size_t>(bytes)) { good = false; pos = data.size(); return 0; }
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= static_cast<uint64_t>(data[pos++]) << (8 * i);
+        return v;
+    }
+    std::string string() {
+        uint64_t size = varint();
+        if (size > data.size() - pos) { good = false; pos = data.size(); return std::string(); }
+        std::string s(reinterpret_cast<const char*>(data.data() + pos), static_cast<size_t>(size));
+        pos += static_cast<size_t>(size);
+        return s;
+    }
+
+private:
+    const std::vector<uint8_t>& data;
+    size_t& pos;
+    bool good = true;
+};
+
+} // namespace
+
+std::unique_ptr<InputRecorder> InputRecorder::create(const std::string& path, const ReplaySession& session,
+                                                     uint32_t startTick, std::string* outError) {
+    std::unique_ptr<InputRecorder> recorder(new InputRecorder());
+    recorder->file.open(path, std::ios::binary | std::ios::trunc);
+    if (!recorder->file) {
+        if (outError) *outError = "cannot open " + path + " for writing";
+        return nullptr;
+    }
+    recorder->startTick = startTick;
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    putLE(header, VERSION, 2);
+    putLE(header, session.infinitePotions ? FLAG_INFINITE_POTIONS : 0, 2);
+    putLE(header, session.seed, 8);
+    putLE(header, session.tickRate, 4);
+    putString(header, session.keyBindings);
+    putString(header, session.playerSave);
+    recorder->file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    if (!recorder->file) {
+        if (outError) *outError = "cannot write " + path;
+        return nullptr;
+    }
+    return recorder;
+}
+
+InputRecorder::~InputRecorder() {
+    if (!finished) finish(startTick + lastTick);
+}
+
+void InputRecorder::record(const std::vector<InputJournalEntry>& entries, const std::vector<ReplayActionEntry>& actions) {
+    if (finished) return;
+    block.clear();
+    size_t i = 0, a = 0;
+    while (i < entries.size() || a < actions.size()) {
+        // Next tick with either input or actions
+        uint32_t absolute = i < entries.size() ? entries[i].tick : actions[a].tick;
+        if (a < actions.size() && actions[a].tick < absolute) absolute = actions[a].tick;
+        const uint32_t tick = absolute - startTick;
+        size_t end = i, actionsEnd = a;
+        while (end < entries.size() && entries[end].tick == absolute) ++end;
+        while (actionsEnd < actions.size() && actions[actionsEnd].tick == absolute) ++actionsEnd;
+
+        putVarint(block, tick - lastTick);
+        putVarint(block, (end - i) + (actionsEnd - a));
+        for (; i < end; ++i) {
+            const InputCommand& command = entries[i].command;
+            block.push_back(static_cast<char>(command.type));
+            if (command.type == InputCommand::Type::MOUSE_MOTION) {
+                putSint(block, command.x - lastMouseX);
+                putSint(block, command.y - lastMouseY);
+                lastMouseX = command.x;
+                lastMouseY = command.y;
+            } else {
+                putVarint(block, static_cast<uint32_t>(command.code));
+            }
+        }
+        for (; a < actionsEnd; ++a) {
+            const ReplayAction& action = actions[a].action;
+            block.push_back(static_cast<char>(ACTION_RECORD));
+            block.push_back(static_cast<char>(action.type));
+            putSint(block, action.slot);
+            putVarint(block, action.item);
+            putString(block, action.key);
+        }
+        lastTick = tick;
+    }
+    file.write(block.data(), static_cast<std::streamsize>(block.size()));
+}
+
+void InputRecorder::finish(uint32_t endTick) {
+    if (finished) return;
+    finished = true;
+    block.clear();
+    const uint32_t tick = endTick - startTick;
+    putVarint(block, tick >= lastTick ? tick - lastTick : 0);
+    putVarint(block, 0);
+    file.write(block.data(), static_cast<std::streamsize>(block.size()));
+    file.close();
+    if (!file) std::cerr << "Input recording may be incomplete: write failed" << std::endl;
+}
+
+std::unique_ptr<InputPlayer> InputPlayer::open(const std::string& path, std::string* outError) {
+    auto fail = [&](const std::string& message) {
+        if (outError) *outError = message;
+        return nullptr;
+    };
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return fail("cannot open " + path);
+
+    // Whole log up front so playback does no file I/O while being profiled
+    std::unique_ptr<InputPlayer> player(new InputPlayer());
+    player->data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (player->data.size() < sizeof(MAGIC) || std::memcmp(player->data.data(), MAGIC, sizeof(MAGIC)) != 0)
+        return fail("not an input recording");
+
+    player->pos = sizeof(MAGIC);
+    Reader reader(player->data, player->pos);
+    const uint16_t version = static_cast<uint16_t>(reader.le(2));
+    if (version < 1 || version > InputRecorder::VERSION) return fail("unsupported input recording version " + std::to_string(version));
+    const uint16_t flags = static_cast<uint16_t>(reader.le(2));
+    ReplaySession& session = player->session;
+    session.infinitePotions = (flags & FLAG_INFINITE_POTIONS) != 0;
+    session.seed = reader.le(8);
+    session.tickRate = static_cast<uint32_t>(reader.le(4));
+    session.keyBindings = reader.string();
+    session.playerSave = reader.string();
+    if (!reader.ok()) return fail("truncated input recording header");
+
+    // Walk the records once for the length and to catch a truncated log before playback
+    {
+        size_t scan = player->pos;
+        Reader records(player->data, scan);
+        uint32_t tick = 0;
+        for (;;) {
+            tick += static_cast<uint32_t>(records.varint());
+            const uint64_t count = records.varint();
+            if (!records.ok()) {
+                std::cerr << "Input recording has no end record; playing what is there" << std::endl;
+                break;
+            }
+            player->length = tick;
+            if (count == 0) break;
+            for (uint64_t i = 0; i < count && records.ok(); ++i) {
+                const uint64_t type = records.le(1);
+                if (type == InputRecorder::ACTION_RECORD) {
+                    records.le(1);
+                    records.varint();
+                    records.varint();
+                    records.string();
+                    continue;
+                }
+                if (static_cast<InputCommand::Type>(type) == InputCommand::Type::MOUSE_MOTION) records.varint();
+                records.varint();
+            }
+        }
+    }
+    player->readRecordHeader();
+    return player;
+}
+
+bool InputPlayer::readRecordHeader() {
+    Reader reader(data, pos);
+    const uint32_t delta = static_cast<uint32_t>(reader.varint());
+    const uint32_t count = static_cast<uint32_t>(reader.varint());
+    if (!reader.ok()) {
+        nextCount = 0; // cut short: end at the last complete record
+        return false;
+    }
+    nextTick += delta;
+    nextCount = count;
+    return true;
+}
+
+bool InputPlayer::feed(uint32_t tick, InputManager& input, std::vector<ReplayAction>& actions) {
+    if (finished) return false;
+    if (tick < nextTick) return true;
+    if (nextCount == 0) {
+        finished = true;
+        return false;
+    }
+
+    Reader reader(data, pos);
+    for (uint32_t i = 0; i < nextCount; ++i) {
+        InputCommand command;
+        const uint64_t type = reader.le(1);
+        if (type == InputRecorder::ACTION_RECORD) {
+            ReplayAction action;
+            action.type = static_cast<uint8_t>(reader.le(1));
+            action.slot = reader.sint();
+            action.item = static_cast<uint32_t>(reader.varint());
+            action.key = reader.string();
+            if (!reader.ok()) {
+                finished = true;
+                return false;
+            }
+            actions.push_back(std::move(action));
+            continue;
+        }
+        if (type > static_cast<uint64_t>(InputCommand::Type::MOUSE_MOTION)) {
+            std::cerr << "Input recording is corrupt at byte " << pos << std::endl;
+            finished = true;
+            return false;
+        }
+        command.type = static_cast<InputCommand::Type>(type);
+        if (command.type == InputCommand::Type::MOUSE_MOTION) {
+            lastMouseX += reader.sint();
+            lastMouseY += reader.sint();
+            command.x = lastMouseX;
+            command.y = lastMouseY;
+        } else {
+            command.code = static_cast<int>(reader.varint());
+        }
+        if (!reader.ok()) {
+            finished = true;
+            return false;
+        }
+        input.inject(command);
+    }
+    if (!readRecordHeader()) std::cerr << "Input recording ends early at tick " << nextTick << std::endl;
+    return true;
+}
@@ -4,13 +4,12 @@
 #include <algorithm>
 
 // Item Implementation
-Item::Item(const std::string& itemId, const std::string& itemName, ItemType itemType, 
+Item::Item(std::string_view itemId, std::string_view itemName, ItemType itemType,
            ItemRarity itemRarity, int maxStack)
     : id(itemId), name(itemName), type(itemType), rarity(itemRarity), 
       stackSize(maxStack), currentStack(1), plusLevel(0) {
     
-    description = ""; // Will be set by templates
-    iconPath = "";    // Will be set by templates
+    // description and iconPath are set by templates
     equipmentType = EquipmentType::RING; // Default, will be overridden
 }
 
@@ -27,9 +26,9 @@ SDL_Color Item::getRarityColor() const {
 
 std::string Item::getDisplayName() const {
     if (type == ItemType::EQUIPMENT) {
-        return name + " (+" + std::to_string(plusLevel) + ")";
+        return std::string(name) + " (+" + std::to_string(plusLevel) + ")";
     }
-    return name;
+    return std::string(name);
 }
 
 std::string Item::getTooltipText() const {
@@ -93,16 +92,21 @@ ItemSystem::ItemSystem(AssetManager* assetManager) : assetManager(assetManager)
     itemInventory.resize(INVENTORY_SIZE);
     scrollInventory.resize(SCROLL_INVENTORY_SIZE);
     resourceInventory.resize(RESOURCE_INVENTORY_SIZE);
-    equipmentSlots.resize(9); // 9 equipment slots
+    equipmentSlots.resize(EQUIPMENT_SLOT_COUNT);
+    
+    // Item pool is sized once; free list pops low indices first
+    itemPool.resize(MAX_ITEM_INSTANCES);
+    itemGenerations.assign(MAX_ITEM_INSTANCES, 0);
+    freeItems.reserve(MAX_ITEM_INSTANCES);
+    for (int i = MAX_ITEM_INSTANCES - 1; i >= 0; --i) {
+        freeItems.push_back(static_cast<uint16_t>(i));
+    }
     
     // Initialize item templates
     initializeItemTemplates();
 }
 
-ItemSystem::~ItemSystem() {
-    // Clean up item instances
-    itemInstances.clear();
-}
+ItemSystem::~ItemSystem() = default;
 
 void ItemSystem::initializeItemTemplates() {
     // STARTER EQUIPMENT (Common rarity - low stats for new players)
@@ -319,9 +323,9 @@ void ItemSystem::initializeItemTemplates() {
 
 void ItemSystem::createItemTemplate(const std::string& id, const std::string& name, const std::string& desc,
                                    const std::string& iconPath, ItemType type, EquipmentType equipType, ItemRarity rarity) {
-    Item item(id, name, type, rarity);
-    item.description = desc;
-    item.iconPath = iconPath;
+    Item item(internString(id), internString(name), type, rarity);
+    item.description = internString(desc);
+    item.iconPath = internString(iconPath);
     item.equipmentType = equipType;
     
     if (type == ItemType::SCROLL) {
@@ -342,7 +346,7 @@ void ItemSystem::createItemTemplate(const std::string& id, const std::string& na
     if (assetManager) {
         Texture* icon = assetManager->getTexture(iconPath);
         if (icon) {
-            itemIcons[id] = icon;
+            itemIcons[item.id] = icon;
         }
     }
 }
@@ -374,24 +378,56 @@ void ItemSystem::scaleStatsForRarity(Item& item, float multiplier) const {
     item.stats.poisonResist = static_cast<int>(item.stats.poisonResist * multiplier);
 }
 
+std::string_view ItemSystem::internString(const std::string& text) {
+    templateStrings.push_back(text);
+    return templateStrings.back();
+}
+
 Item* ItemSystem::createItem(const std::string& itemId, ItemRarity rarity, int stack) {
     auto templateIt = itemTemplates.find(itemId);
     if (templateIt == itemTemplates.end()) {
         std::cout << "Warning: Unknown item ID: " << itemId << std::endl;
         return nullptr;
     }
+    if (freeItems.empty()) {
+        std::cout << "Warning: Item pool exhausted, cannot create " << itemId << std::endl;
+        return nullptr;
+    }
     
-    auto item = std::make_unique<Item>(templateIt->second);
-    item->rarity = rarity;
-    item->currentStack = std::min(stack, item->stackSize);
-    
-    // Generate unique instance ID
-    item->instanceId = itemId + "_" + std::to_string(nextInstanceId++);
-    
-    Item* itemPtr = item.get();
-    itemInstances.push_back(std::move(item));
-    
-    return itemPtr;
+    uint16_t index = freeItems.back();
+    freeItems.pop_back();
+    // Generation 0 is skipped so a handle value is never 0
+    uint16_t generation = ++itemGenerations[index];
+    if (generation == 0) generation = itemGenerations[index] = 1;
+    
+    // Copying the template copies string views, not strings
+    Item& item = itemPool[index];
+    item = templateIt->second;
+    item.rarity = rarity;
+    item.currentStack = std::min(stack, item.stackSize);
+    item.instanceId = nextInstanceId++;
+    item.handle = ItemHandle::make(index, generation);
+    return &item;
+}
+
+void ItemSystem::destroyItem(Item* item) {
+    if (!item || getItem(item->handle) != item) return;
+    uint16_t index = item->handle.index();
+    itemPool[index] = Item();
+    freeItems.push_back(index);
+}
+
+Item* ItemSystem::getItem(ItemHandle handle) const {
+    if (!handle.isValid() || handle.index() >= itemPool.size()) return nullptr;
+    const Item& item = itemPool[handle.index()];
+    return item.handle == handle ? const_cast<Item*>(&item) : nullptr;
+}
+
+void ItemSystem::releaseSlots(std::vector<InventorySlot>& slots) {
+    for (auto& slot : slots) {
+        destroyItem(slot.item);
+        slot.clear();
+    }
 }
 
 Item* ItemSystem::getItemTemplate(const std::string& itemId) const {
@@ -410,6 +446,7 @@ bool ItemSystem::addItem(const std::string& itemId, int amount, ItemRarity rarit
     
     bool isScroll = (templateIt->second.type == ItemType::SCROLL);
     bool isMaterial = (templateIt->second.type == ItemType::MATERIAL);
+    markChanged();
     
     // Determine which inventory to use
     std::vector<InventorySlot>* targetInventory;
@@ -481,6 +518,47 @@ bool ItemSystem::addItemToSlot(Item* item, int slotIndex, bool isScrollInventory
     
     // Add the item to the specified slot
     inventory[slotIndex].setItem(item);
+    markChanged();
+    return true;
+}
+
+bool ItemSystem::removeItem(const std::string& itemId, int amount) {
+    auto templateIt = itemTemplates.find(itemId);
+    if (templateIt == itemTemplates.end() || amount <= 0) return false;
+    
+    std::vector<InventorySlot>& inventory = (templateIt->second.type == ItemType::SCROLL) ? scrollInventory
+                                          : (templateIt->second.type == ItemType::MATERIAL) ? resourceInventory
+                                          : itemInventory;
+    
+    int available = 0;
+    for (const auto& slot : inventory) {
+        if (!slot.isEmpty() && slot.item->id == itemId) available += slot.item->currentStack;
+    }
+    if (available < amount) return false;
+    
+    // Take from the last stacks first so the front of the bag stays filled
+    for (auto it = inventory.rbegin(); it != inventory.rend() && amount > 0; ++it) {
+        if (it->isEmpty() || it->item->id != itemId) continue;
+        int taken = std::min(amount, it->item->currentStack);
+        it->item->currentStack -= taken;
+        amount -= taken;
+        if (it->item->currentStack <= 0) {
+            destroyItem(it->item);
+            it->clear();
+        }
+    }
+    markChanged();
+    return true;
+}
+
+bool ItemSystem::removeItemFromSlot(int slotIndex, bool isScrollInventory) {
+    auto& inventory = isScrollInventory ? scrollInventory : itemInventory;
+    int maxSize = isScrollInventory ? SCROLL_INVENTORY_SIZE : INVENTORY_SIZE;
+    if (slotIndex < 0 || slotIndex >= maxSize || inventory[slotIndex].isEmpty()) return false;
+    
+    destroyItem(inventory[slotIndex].item);
+    inventory[slotIndex].clear();
+    markChanged();
     return true;
 }
 
@@ -520,6 +598,14 @@ ItemStats ItemSystem::calculateTotalStats() const {
     return total;
 }
 
+const ItemStats& ItemSystem::getTotalStats() const {
+    if (cachedTotalStatsVersion != version) {
+        cachedTotalStats = calculateTotalStats();
+        cachedTotalStatsVersion = version;
+    }
+    return cachedTotalStats;
+}
+
 bool ItemSystem::equipItem(int inventorySlot) {
     if (inventorySlot < 0 || inventorySlot >= INVENTORY_SIZE) return false;
     if (itemInventory[inventorySlot].isEmpty()) return false;
@@ -540,6 +626,7 @@ bool ItemSystem::equipItem(int inventorySlot) {
         itemInventory[inventorySlot].clear();
     }
     
+    markChanged();
     return true;
 }
 
@@ -554,10 +641,11 @@ bool ItemSystem::unequipItem(int equipmentSlot) {
     itemInventory[emptySlot].setItem(item);
     equipmentSlots[equipmentSlot].clear();
     
+    markChanged();
     return true;
 }
 
-Texture* ItemSystem::getItemIcon(const std::string& itemId) const {
+Texture* ItemSystem::getItemIcon(std::string_view itemId) const {
     auto it = itemIcons.find(itemId);
     if (it != itemIcons.end()) {
         return it->second;
@@ -569,10 +657,9 @@ void ItemSystem::loadEquipmentFromSave(const std::string equipNames[9], const in
                                       const int equipFire[9], const int equipIce[9], 
                                       const int equipLightning[9], const int equipPoison[9],
                                       const int equipRarity[9]) {
-    // Clear current equipment
-    for (auto& slot : equipmentSlots) {
-        slot.clear();
-    }
+    markChanged();
+    // Clear current equipment, returning the old items to the pool
+    releaseSlots(equipmentSlots);
     
     // Load saved equipment
     for (int i = 0; i < 9; ++i) {
@@ -602,6 +689,7 @@ void ItemSystem::loadEquipmentFromSave(const std::string equipNames[9], const in
 
 void ItemSystem::loadInventoryFromSave(const std::string invKey[2][9], const int invCnt[2][9], 
                                       const int invRarity[2][9], const int invPlusLevel[2][9]) {
+    markChanged();
     // Call the full version with nullptr for resource arrays
     loadInventoryFromSave(invKey, invCnt, invRarity, invPlusLevel, nullptr, nullptr, nullptr, nullptr);
 }
@@ -610,17 +698,12 @@ void ItemSystem::loadInventoryFromSave(const std::string invKey[2][9], const int
                                       const int invRarity[2][9], const int invPlusLevel[2][9],
                                       const std::string resourceKey[9], const int resourceCnt[9],
                                       const int resourceRarity[9], const int resourcePlusLevel[9]) {
+    markChanged();
     std::cout << "ItemSystem: Loading inventory from save..." << std::endl;
-    // Clear current inventories
-    for (auto& slot : itemInventory) {
-        slot.clear();
-    }
-    for (auto& slot : scrollInventory) {
-        slot.clear();
-    }
-    for (auto& slot : resourceInventory) {
-        slot.clear();
-    }
+    // Clear current inventories, returning the old items to the pool
+    releaseSlots(itemInventory);
+    releaseSlots(scrollInventory);
+    releaseSlots(resourceInventory);
     
     // Load saved inventory items
     for (int b = 0; b < 2; ++b) {
@@ -654,6 +737,8 @@ void ItemSystem::loadInventoryFromSave(const std::string invKey[2][9], const int
                             }
                             if (emptySlot != -1) {
                                 scrollInventory[emptySlot].setItem(item);
+                            } else {
+                                destroyItem(item); // no room
                             }
                         } else if (templateIt->second.type == ItemType::MATERIAL) {
                             int emptySlot = -1;
@@ -665,6 +750,8 @@ void ItemSystem::loadInventoryFromSave(const std::string invKey[2][9], const int
                             }
                             if (emptySlot != -1) {
                                 resourceInventory[emptySlot].setItem(item);
+                            } else {
+                                destroyItem(item); // no room
                             }
                         } else {
                             int emptySlot = -1;
@@ -676,6 +763,8 @@ void ItemSystem::loadInventoryFromSave(const std::string invKey[2][9], const int
                             }
                             if (emptySlot != -1) {
                                 itemInventory[emptySlot].setItem(item);
+                            } else {
+                                destroyItem(item); // no room
                             }
                         }
                     } else {
@@ -711,6 +800,8 @@ void ItemSystem::loadInventoryFromSave(const std::string invKey[2][9], const int
                     }
                     if (emptySlot != -1) {
                         resourceInventory[emptySlot].setItem(item);
+                    } else {
+                        destroyItem(item); // no room
                     }
                 } else {
                     std::cout << "FAILED to create resource item: " << resourceKey[i] << std::endl;
@@ -1,206 +1,190 @@
 #include "LootGenerator.h"
+#include "Enemy.h"
 #include <algorithm>
 
+namespace {
+// Scroll and material names are literals, so loot can reference them directly
+const char* const SCROLL_NAMES[] = {
+    "Upgrade Scroll", "Fire Enchantment", "Water Enchantment", "Poison Enchantment", "Armor Enchantment"
+};
+
+const char* const MATERIAL_NAMES[5][4] = {
+    {"Iron Ore", "Cloth Scraps", "Leather Hide", "Wood Planks"},                    // COMMON
+    {"Silver Ore", "Fine Silk", "Thick Leather", "Hardwood"},                       // UNCOMMON
+    {"Gold Ore", "Enchanted Thread", "Dragon Leather", "Ancient Wood"},             // RARE
+    {"Platinum Ore", "Starweave Silk", "Phoenix Feather", "World Tree Branch"},     // EPIC
+    {"Mithril Ore", "Void Silk", "Dragon Heart", "Yggdrasil Wood"}                  // LEGENDARY
+};
+
+const char* const RARITY_PREFIXES[5] = {"", "Fine ", "Superior ", "Masterwork ", "Legendary "};
+}
+
+const LootGenerator::EquipmentTemplate LootGenerator::EQUIPMENT_TEMPLATES[] = {
+    {"Iron Sword", 1, 3, 1.0f},
+    {"Steel Blade", 3, 6, 1.2f},
+    {"Silver Sword", 5, 8, 1.5f},
+    {"Enchanted Blade", 7, 10, 1.8f},
+    
+    {"Leather Armor", 1, 3, 1.0f},
+    {"Chain Mail", 3, 6, 1.2f},
+    {"Plate Armor", 5, 8, 1.5f},
+    {"Dragon Scale", 7, 10, 1.8f},
+    
+    {"Simple Ring", 1, 5, 0.8f},
+    {"Magic Ring", 3, 8, 1.2f},
+    {"Power Ring", 6, 10, 1.6f},
+    
+    {"Cloth Robes", 1, 4, 0.9f},
+    {"Wizard Hat", 2, 6, 0.7f},
+    {"Battle Gloves", 1, 7, 0.8f},
+    {"Swift Boots", 2, 8, 1.0f}
+};
+
+const int LootGenerator::EQUIPMENT_TEMPLATE_COUNT =
+    static_cast<int>(sizeof(EQUIPMENT_TEMPLATES) / sizeof(EQUIPMENT_TEMPLATES[0]));
+
 LootGenerator& LootGenerator::getInstance() {
     static LootGenerator instance;
     return instance;
 }
 
-LootGenerator::LootGenerator() : rng(std::random_device{}()) {
+LootGenerator::LootGenerator() {
+    compileTables();
 }
 
-void LootGenerator::setSeed(unsigned int seed) {
-    rng.seed(seed);
+std::vector<Loot> LootGenerator::generateEnemyLoot(RandomStream& rng, int enemyLevel, PackRarity packRarity) const {
+    std::vector<Loot> loot;
+    generateEnemyLoot(rng, enemyLevel, packRarity, loot);
+    return loot;
 }
 
-std::vector<Loot> LootGenerator::generateEnemyLoot(int enemyLevel, float rarityBonus) {
-    std::vector<Loot> loot;
-    LootTable table = getEnemyLootTable(enemyLevel);
+void LootGenerator::generateEnemyLoot(RandomStream& rng, int enemyLevel, PackRarity packRarity, std::vector<Loot>& loot) const {
+    const LootTable& table = enemyLootTable(enemyLevel, packRarity);
     
     // Always drop some gold
-    if (rollFloat() < table.goldChance) {
-        int goldAmount = rollRange(table.minGold, table.maxGold) * (1 + enemyLevel * 0.1f);
+    if (rng.nextFloat() < table.goldChance) {
+        int goldAmount = rng.nextInt(5 + enemyLevel * 2, 15 + enemyLevel * 5) * (1 + enemyLevel * 0.1f);
         loot.emplace_back(LootType::GOLD, goldAmount, "Gold Coins");
     }
     
     // Roll for number of items
-    int numItems = rollRange(table.minItems, table.maxItems);
+    int numItems = rng.nextInt(table.minItems, table.maxItems);
     
     for (int i = 0; i < numItems; i++) {
-        // Roll for loot type based on weights
-        float totalWeight = 0.0f;
-        for (const auto& entry : table.weights) {
-            totalWeight += entry.second;
-        }
-        
-        float roll = rollFloat() * totalWeight;
-        float currentWeight = 0.0f;
+        LootType type = table.types[sample(rng, table.typeSampler)];
+        LootRarity rarity = static_cast<LootRarity>(sample(rng, table.raritySampler));
         
-        for (const auto& entry : table.weights) {
-            currentWeight += entry.second;
-            if (roll <= currentWeight) {
-                LootType type = entry.first;
-                LootRarity rarity = rollRarity(rarityBonus);
-                
-                switch (type) {
-                    case LootType::EXPERIENCE:
-                        loot.emplace_back(LootType::EXPERIENCE, 
-                                        rollRange(10, 25) * (1 + enemyLevel), 
-                                        "Experience");
-                        break;
-                    case LootType::HEALTH_POTION:
-                        loot.emplace_back(LootType::HEALTH_POTION, 1, "Health Potion", rarity);
-                        break;
-                    case LootType::MANA_POTION:
-                        loot.emplace_back(LootType::MANA_POTION, 1, "Mana Potion", rarity);
-                        break;
-                    case LootType::EQUIPMENT:
-                        loot.push_back(generateEquipmentLoot(enemyLevel, rarity));
-                        break;
-                    case LootType::SCROLL:
-                        loot.push_back(generateScrollLoot(rarity));
-                        break;
-                    case LootType::MATERIAL:
-                        loot.push_back(generateMaterialLoot(rarity));
-                        break;
-                    default:
-                        break;
-                }
+        switch (type) {
+            case LootType::EXPERIENCE:
+                loot.emplace_back(LootType::EXPERIENCE, 
+                                rng.nextInt(10, 25) * (1 + enemyLevel), 
+                                "Experience");
+                break;
+            case LootType::HEALTH_POTION:
+                loot.emplace_back(LootType::HEALTH_POTION, 1, "Health Potion", rarity);
+                break;
+            case LootType::MANA_POTION:
+                loot.emplace_back(LootType::MANA_POTION, 1, "Mana Potion", rarity);
+                break;
+            case LootType::EQUIPMENT:
+                loot.push_back(generateEquipmentLoot(rng, enemyLevel, rarity));
+                break;
+            case LootType::SCROLL:
+                loot.push_back(generateScrollLoot(rng, rarity));
+                break;
+            case LootType::MATERIAL:
+                loot.push_back(generateMaterialLoot(rng, rarity));
+                break;
+            default:
                 break;
-            }
         }
     }
-    
-    return loot;
 }
 
-std::vector<Loot> LootGenerator::generateContainerLoot(ObjectType containerType) {
+std::vector<Loot> LootGenerator::generateContainerLoot(RandomStream& rng, ObjectType containerType) const {
     std::vector<Loot> loot;
-    LootTable table = getContainerLootTable(containerType);
+    generateContainerLoot(rng, containerType, loot);
+    return loot;
+}
+
+void LootGenerator::generateContainerLoot(RandomStream& rng, ObjectType containerType, std::vector<Loot>& loot) const {
+    const LootTable& table = containerTables[containerTableIndex(containerType)];
     
     // Gold chance
-    if (rollFloat() < table.goldChance) {
-        int goldAmount = rollRange(table.minGold, table.maxGold);
+    if (rng.nextFloat() < table.goldChance) {
+        int goldAmount = rng.nextInt(table.minGold, table.maxGold);
         loot.emplace_back(LootType::GOLD, goldAmount, "Gold Coins");
     }
     
     // Roll for items
-    int numItems = rollRange(table.minItems, table.maxItems);
+    int numItems = rng.nextInt(table.minItems, table.maxItems);
     
     for (int i = 0; i < numItems; i++) {
-        float totalWeight = 0.0f;
-        for (const auto& entry : table.weights) {
-            totalWeight += entry.second;
-        }
-        
-        float roll = rollFloat() * totalWeight;
-        float currentWeight = 0.0f;
+        LootType type = table.types[sample(rng, table.typeSampler)];
+        LootRarity rarity = static_cast<LootRarity>(sample(rng, table.raritySampler));
         
-        for (const auto& entry : table.weights) {
-            currentWeight += entry.second;
-            if (roll <= currentWeight) {
-                LootType type = entry.first;
-                LootRarity rarity = rollRarity(0.1f); // Small bonus for containers
-                
-                switch (type) {
-                    case LootType::HEALTH_POTION:
-                        loot.emplace_back(LootType::HEALTH_POTION, 
-                                        rollRange(1, 3), "Health Potion", rarity);
-                        break;
-                    case LootType::MANA_POTION:
-                        loot.emplace_back(LootType::MANA_POTION, 
-                                        rollRange(1, 3), "Mana Potion", rarity);
-                        break;
-                    case LootType::EQUIPMENT:
-                        loot.push_back(generateEquipmentLoot(rollRange(1, 5), rarity));
-                        break;
-                    case LootType::SCROLL:
-                        loot.push_back(generateScrollLoot(rarity));
-                        break;
-                    case LootType::MATERIAL:
-                        loot.push_back(generateMaterialLoot(rarity));
-                        break;
-                    default:
-                        break;
-                }
+        switch (type) {
+            case LootType::HEALTH_POTION:
+                loot.emplace_back(LootType::HEALTH_POTION, 
+                                rng.nextInt(1, 3), "Health Potion", rarity);
+                break;
+            case LootType::MANA_POTION:
+                loot.emplace_back(LootType::MANA_POTION, 
+                                rng.nextInt(1, 3), "Mana Potion", rarity);
+                break;
+            case LootType::EQUIPMENT:
+                loot.push_back(generateEquipmentLoot(rng, rng.nextInt(1, 5), rarity));
+                break;
+            case LootType::SCROLL:
+                loot.push_back(generateScrollLoot(rng, rarity));
+                break;
+            case LootType::MATERIAL:
+                loot.push_back(generateMaterialLoot(rng, rarity));
+                break;
+            default:
                 break;
-            }
         }
     }
-    
-    return loot;
 }
 
-Loot LootGenerator::generateEquipmentLoot(int level, LootRarity forceRarity) {
-    auto templates = getEquipmentTemplates();
+Loot LootGenerator::generateEquipmentLoot(RandomStream& rng, int level, LootRarity forceRarity) const {
+    // Templates valid at this level; pool 0 (all templates) when none match
+    const std::vector<uint8_t>& pool =
+        (level >= 1 && level <= MAX_LEVEL_BAND && !equipmentPools[level].empty()) ? equipmentPools[level] : equipmentPools[0];
+    int chosen = pool[rng.nextInt(0, static_cast<int>(pool.size()) - 1)];
     
-    // Filter templates by level
-    std::vector<EquipmentTemplate> validTemplates;
-    for (const auto& tmpl : templates) {
-        if (level >= tmpl.minLevel && level <= tmpl.maxLevel) {
-            validTemplates.push_back(tmpl);
-        }
-    }
+    LootRarity rarity = (forceRarity != LootRarity::COMMON) ? forceRarity : rollRarity(rng);
     
-    if (validTemplates.empty()) {
-        validTemplates = templates; // Fallback to all templates
-    }
-    
-    // Pick random template
-    const auto& chosen = validTemplates[rollRange(0, validTemplates.size() - 1)];
-    
-    LootRarity rarity = (forceRarity != LootRarity::COMMON) ? forceRarity : rollRarity();
-    
-    // Generate name with rarity prefix
-    std::string rarityPrefix;
-    switch (rarity) {
-        case LootRarity::UNCOMMON:  rarityPrefix = "Fine "; break;
-        case LootRarity::RARE:      rarityPrefix = "Superior "; break;
-        case LootRarity::EPIC:      rarityPrefix = "Masterwork "; break;
-        case LootRarity::LEGENDARY: rarityPrefix = "Legendary "; break;
-        default: break;
-    }
-    
-    std::string fullName = rarityPrefix + chosen.baseName;
-    std::string description = "Level " + std::to_string(level) + " " + chosen.baseName;
+    // Names carry the rarity prefix; descriptions are interned for levels 1-10
+    int descLevel = std::clamp(level, 1, MAX_LEVEL_BAND);
+    const std::string& fullName = equipmentNames[chosen * RARITY_COUNT + static_cast<int>(rarity)];
+    const std::string& description = equipmentDescriptions[chosen * MAX_LEVEL_BAND + descLevel - 1];
     
     return Loot(LootType::EQUIPMENT, 1, fullName, rarity, description);
 }
 
-Loot LootGenerator::generateScrollLoot(LootRarity rarity) {
-    std::vector<std::string> scrollTypes = {
-        "upgrade_scroll", "fire_dmg_scroll", "water_damage_scroll", 
-        "poison_dmg_scroll", "armor_enchant_scroll"
-    };
-    
-    std::string scrollType = scrollTypes[rollRange(0, scrollTypes.size() - 1)];
-    std::string name = "Enchantment Scroll";
-    
-    if (scrollType == "upgrade_scroll") name = "Upgrade Scroll";
-    else if (scrollType == "fire_dmg_scroll") name = "Fire Enchantment";
-    else if (scrollType == "water_damage_scroll") name = "Water Enchantment";
-    else if (scrollType == "poison_dmg_scroll") name = "Poison Enchantment";
-    else if (scrollType == "armor_enchant_scroll") name = "Armor Enchantment";
-    
+Loot LootGenerator::generateScrollLoot(RandomStream& rng, LootRarity rarity) const {
+    const int scrollCount = static_cast<int>(sizeof(SCROLL_NAMES) / sizeof(SCROLL_NAMES[0]));
+    const char* name = SCROLL_NAMES[rng.nextInt(0, scrollCount - 1)];
     return Loot(LootType::SCROLL, 1, name, rarity, "Magical scroll for equipment enhancement");
 }
 
-Loot LootGenerator::generateMaterialLoot(LootRarity rarity) {
-    auto materials = getMaterialNames(rarity);
-    std::string name = materials[rollRange(0, materials.size() - 1)];
+Loot LootGenerator::generateMaterialLoot(RandomStream& rng, LootRarity rarity) const {
+    int rarityIndex = std::clamp(static_cast<int>(rarity), 0, RARITY_COUNT - 1);
+    const char* name = MATERIAL_NAMES[rarityIndex][rng.nextInt(0, 3)];
     
     int amount = 1;
     switch (rarity) {
-        case LootRarity::COMMON: amount = rollRange(1, 3); break;
-        case LootRarity::UNCOMMON: amount = rollRange(1, 2); break;
+        case LootRarity::COMMON: amount = rng.nextInt(1, 3); break;
+        case LootRarity::UNCOMMON: amount = rng.nextInt(1, 2); break;
         default: amount = 1; break;
     }
     
     return Loot(LootType::MATERIAL, amount, name, rarity, "Crafting material");
 }
 
-LootRarity LootGenerator::rollRarity(float rarityBonus) {
-    float roll = rollFloat() + rarityBonus;
+LootRarity LootGenerator::rollRarity(RandomStream& rng, float rarityBonus) {
+    float roll = rng.nextFloat() + rarityBonus;
     
     if (roll >= 0.95f) return LootRarity::LEGENDARY;      // 5% + bonus
     if (roll >= 0.85f) return LootRarity::EPIC;          // 10% + bonus  
@@ -209,135 +193,183 @@ LootRarity LootGenerator::rollRarity(float rarityBonus) {
     return LootRarity::COMMON;                           // 35% - bonus
 }
 
-LootGenerator::LootTable LootGenerator::getEnemyLootTable(int level) {
-    LootTable table;
-    
-    // Base enemy loot chances
-    table.weights = {
-        {LootType::EXPERIENCE, 3.0f},
-        {LootType::HEALTH_POTION, 1.5f},
-        {LootType::MANA_POTION, 1.0f},
-        {LootType::EQUIPMENT, 0.8f},
-        {LootType::SCROLL, 0.5f},
-        {LootType::MATERIAL, 1.2f}
-    };
+void LootGenerator::AliasTable::build(const std::vector<float>& weights) {
+    const int n = static_cast<int>(weights.size());
+    probability.assign(n, 1.0f);
+    alias.resize(n);
+    for (int i = 0; i < n; i++) alias[i] = static_cast<uint8_t>(i);
     
-    table.minItems = 1;
-    table.maxItems = std::min(2, 1 + level / 3); // More items for higher level enemies
-    table.goldChance = 0.7f;
-    table.minGold = 5 + level * 2;
-    table.maxGold = 15 + level * 5;
+    float total = 0.0f;
+    for (float w : weights) total += std::max(0.0f, w);
+    if (n == 0 || total <= 0.0f) return; // uniform
     
-    return table;
+    // Vose's construction: pair each under-full column with an over-full donor
+    std::vector<float> scaled(n);
+    std::vector<int> small, large;
+    for (int i = 0; i < n; i++) {
+        scaled[i] = std::max(0.0f, weights[i]) * n / total;
+        (scaled[i] < 1.0f ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        int s = small.back(); small.pop_back();
+        int l = large.back(); large.pop_back();
+        probability[s] = scaled[s];
+        alias[s] = static_cast<uint8_t>(l);
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0f;
+        (scaled[l] < 1.0f ? small : large).push_back(l);
+    }
+    // Leftovers are full columns (up to rounding error)
+    for (int i : small) probability[i] = 1.0f;
+    for (int i : large) probability[i] = 1.0f;
+}
+
+int LootGenerator::sample(RandomStream& rng, const AliasTable& table) {
+    int column = rng.nextInt(0, static_cast<int>(table.probability.size()) - 1);
+    return rng.nextFloat() < table.probability[column] ? column : table.alias[column];
+}
+
+void LootGenerator::setWeights(LootTable& table, const std::vector<std::pair<LootType, float>>& weights) {
+    std::vector<float> w;
+    for (const auto& entry : weights) {
+        table.types.push_back(entry.first);
+        w.push_back(entry.second);
+    }
+    table.typeSampler.build(w);
 }
 
-LootGenerator::LootTable LootGenerator::getContainerLootTable(ObjectType type) {
-    LootTable table;
+LootGenerator::AliasTable LootGenerator::compileRarity(float rarityBonus) {
+    // Same distribution as rollRarity(): a uniform roll plus the bonus, bucketed by thresholds
+    const float thresholds[RARITY_COUNT - 1] = {0.35f, 0.65f, 0.85f, 0.95f};
+    auto atLeast = [rarityBonus](float t) { return std::clamp(1.0f + rarityBonus - t, 0.0f, 1.0f); };
     
-    switch (type) {
-        case ObjectType::CHEST_UNOPENED:
-            table.weights = {
-                {LootType::EQUIPMENT, 2.0f},
-                {LootType::SCROLL, 1.5f},
-                {LootType::HEALTH_POTION, 1.0f},
-                {LootType::MANA_POTION, 1.0f},
-                {LootType::MATERIAL, 1.0f}
-            };
-            table.minItems = 2;
-            table.maxItems = 4;
-            table.goldChance = 0.8f;
-            table.minGold = 20;
-            table.maxGold = 100;
-            break;
-            
-        case ObjectType::CLAY_POT:
-            table.weights = {
-                {LootType::HEALTH_POTION, 2.0f},
-                {LootType::MANA_POTION, 1.5f},
-                {LootType::MATERIAL, 1.0f}
-            };
-            table.minItems = 1;
-            table.maxItems = 2;
-            table.goldChance = 0.3f;
-            table.minGold = 5;
-            table.maxGold = 25;
-            break;
-            
-        case ObjectType::WOOD_CRATE:
-        case ObjectType::STEEL_CRATE:
-            table.weights = {
-                {LootType::EQUIPMENT, 1.0f},
-                {LootType::MATERIAL, 2.0f},
-                {LootType::SCROLL, 0.8f}
-            };
-            table.minItems = 1;
-            table.maxItems = 3;
-            table.goldChance = 0.5f;
-            table.minGold = 10;
-            table.maxGold = 50;
-            break;
-            
-        default:
-            // Default container
-            table.weights = {{LootType::HEALTH_POTION, 1.0f}};
-            table.minItems = 1;
-            table.maxItems = 1;
-            table.goldChance = 0.2f;
-            table.minGold = 5;
-            table.maxGold = 15;
-            break;
+    std::vector<float> weights(RARITY_COUNT);
+    weights[0] = 1.0f - atLeast(thresholds[0]);
+    for (int r = 1; r < RARITY_COUNT - 1; r++) {
+        weights[r] = atLeast(thresholds[r - 1]) - atLeast(thresholds[r]);
     }
+    weights[RARITY_COUNT - 1] = atLeast(thresholds[RARITY_COUNT - 2]);
     
+    AliasTable table;
+    table.build(weights);
     return table;
 }
 
-std::vector<LootGenerator::EquipmentTemplate> LootGenerator::getEquipmentTemplates() {
-    return {
-        {"Iron Sword", 1, 3, 1.0f},
-        {"Steel Blade", 3, 6, 1.2f},
-        {"Silver Sword", 5, 8, 1.5f},
-        {"Enchanted Blade", 7, 10, 1.8f},
-        
-        {"Leather Armor", 1, 3, 1.0f},
-        {"Chain Mail", 3, 6, 1.2f},
-        {"Plate Armor", 5, 8, 1.5f},
-        {"Dragon Scale", 7, 10, 1.8f},
-        
-        {"Simple Ring", 1, 5, 0.8f},
-        {"Magic Ring", 3, 8, 1.2f},
-        {"Power Ring", 6, 10, 1.6f},
-        
-        {"Cloth Robes", 1, 4, 0.9f},
-        {"Wizard Hat", 2, 6, 0.7f},
-        {"Battle Gloves", 1, 7, 0.8f},
-        {"Swift Boots", 2, 8, 1.0f}
-    };
+float LootGenerator::rarityBonusFor(PackRarity packRarity) {
+    switch (packRarity) {
+        case PackRarity::Trash:   return -0.1f;
+        case PackRarity::Common:  return 0.0f;
+        case PackRarity::Magic:   return 0.2f;
+        case PackRarity::Elite:   return 0.4f;
+    }
+    return 0.0f;
 }
 
-std::vector<std::string> LootGenerator::getMaterialNames(LootRarity rarity) {
-    switch (rarity) {
-        case LootRarity::COMMON:
-            return {"Iron Ore", "Cloth Scraps", "Leather Hide", "Wood Planks"};
-        case LootRarity::UNCOMMON:
-            return {"Silver Ore", "Fine Silk", "Thick Leather", "Hardwood"};
-        case LootRarity::RARE:
-            return {"Gold Ore", "Enchanted Thread", "Dragon Leather", "Ancient Wood"};
-        case LootRarity::EPIC:
-            return {"Platinum Ore", "Starweave Silk", "Phoenix Feather", "World Tree Branch"};
-        case LootRarity::LEGENDARY:
-            return {"Mithril Ore", "Void Silk", "Dragon Heart", "Yggdrasil Wood"};
-        default:
-            return {"Iron Ore"};
+int LootGenerator::containerTableIndex(ObjectType type) {
+    switch (type) {
+        case ObjectType::CHEST_UNOPENED: return 0;
+        case ObjectType::CLAY_POT: return 1;
+        case ObjectType::WOOD_CRATE:
+        case ObjectType::STEEL_CRATE: return 2;
+        default: return 3;
     }
 }
 
-int LootGenerator::rollRange(int min, int max) {
-    if (min >= max) return min;
-    std::uniform_int_distribution<int> dist(min, max);
-    return dist(rng);
+const LootGenerator::LootTable& LootGenerator::enemyLootTable(int level, PackRarity packRarity) const {
+    int band = std::clamp(level, 1, MAX_LEVEL_BAND);
+    return enemyTables[(band - 1) * PACK_RARITY_COUNT + static_cast<int>(packRarity)];
 }
 
-float LootGenerator::rollFloat(float min, float max) {
-    std::uniform_real_distribution<float> dist(min, max);
-    return dist(rng);
-}
\ No newline at end of file
+void LootGenerator::compileTables() {
+    // Enemy tables: base chances, item count by level band, rarity by pack
+    enemyTables.resize(MAX_LEVEL_BAND * PACK_RARITY_COUNT);
+    for (int band = 1; band <= MAX_LEVEL_BAND; band++) {
+        for (int pack = 0; pack < PACK_RARITY_COUNT; pack++) {
+            LootTable& table = enemyTables[(band - 1) * PACK_RARITY_COUNT + pack];
+            setWeights(table, {
+                {LootType::EXPERIENCE, 3.0f},
+                {LootType::HEALTH_POTION, 1.5f},
+                {LootType::MANA_POTION, 1.0f},
+                {LootType::EQUIPMENT, 0.8f},
+                {LootType::SCROLL, 0.5f},
+                {LootType::MATERIAL, 1.2f}
+            });
+            table.raritySampler = compileRarity(rarityBonusFor(static_cast<PackRarity>(pack)));
+            table.minItems = 1;
+            table.maxItems = std::min(2, 1 + band / 3); // More items for higher level enemies
+            table.goldChance = 0.7f; // amount scales with the exact level when rolled
+        }
+    }
+    
+    // Container tables, indexed by containerTableIndex()
+    containerTables.resize(4);
+    {
+        LootTable& table = containerTables[0]; // chest
+        setWeights(table, {
+            {LootType::EQUIPMENT, 2.0f},
+            {LootType::SCROLL, 1.5f},
+            {LootType::HEALTH_POTION, 1.0f},
+            {LootType::MANA_POTION, 1.0f},
+            {LootType::MATERIAL, 1.0f}
+        });
+        table.minItems = 2;
+        table.maxItems = 4;
+        table.goldChance = 0.8f;
+        table.minGold = 20;
+        table.maxGold = 100;
+    }
+    {
+        LootTable& table = containerTables[1]; // clay pot
+        setWeights(table, {
+            {LootType::HEALTH_POTION, 2.0f},
+            {LootType::MANA_POTION, 1.5f},
+            {LootType::MATERIAL, 1.0f}
+        });
+        table.minItems = 1;
+        table.maxItems = 2;
+        table.goldChance = 0.3f;
+        table.minGold = 5;
+        table.maxGold = 25;
+    }
+    {
+        LootTable& table = containerTables[2]; // wood/steel crate
+        setWeights(table, {
+            {LootType::EQUIPMENT, 1.0f},
+            {LootType::MATERIAL, 2.0f},
+            {LootType::SCROLL, 0.8f}
+        });
+        table.minItems = 1;
+        table.maxItems = 3;
+        table.goldChance = 0.5f;
+        table.minGold = 10;
+        table.maxGold = 50;
+    }
+    {
+        LootTable& table = containerTables[3]; // default container
+        setWeights(table, {{LootType::HEALTH_POTION, 1.0f}});
+        table.minItems = 1;
+        table.maxItems = 1;
+        table.goldChance = 0.2f;
+        table.minGold = 5;
+        table.maxGold = 15;
+    }
+    for (auto& table : containerTables) {
+        table.raritySampler = compileRarity(0.1f); // Small bonus for containers
+    }
+    
+    // Equipment pools and interned names
+    for (int t = 0; t < EQUIPMENT_TEMPLATE_COUNT; t++) {
+        const EquipmentTemplate& tmpl = EQUIPMENT_TEMPLATES[t];
+        equipmentPools[0].push_back(static_cast<uint8_t>(t));
+        for (int level = 1; level <= MAX_LEVEL_BAND; level++) {
+            if (level >= tmpl.minLevel && level <= tmpl.maxLevel) {
+                equipmentPools[level].push_back(static_cast<uint8_t>(t));
+            }
+        }
+        for (int r = 0; r < RARITY_COUNT; r++) {
+            equipmentNames.push_back(std::string(RARITY_PREFIXES[r]) + tmpl.baseName);
+        }
+        for (int level = 1; level <= MAX_LEVEL_BAND; level++) {
+            equipmentDescriptions.push_back("Level " + std::to_string(level) + " " + tmpl.baseName);
+        }
+    }
+}
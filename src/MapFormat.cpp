@@ -0,0 +1,734 @@
+#include "MapFormat.h"
+#include "Inflate.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+// ---------------------------------------------------------------------------------------------
+// MappedFile
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) { CloseHandle(file); return false; }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { CloseHandle(file); return false; }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mapping); CloseHandle(file); return false; }
+    fileHandle = file;
+    mappingHandle = mapping;
+    bytes = static_cast<const uint8_t*>(view);
+    length = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { ::close(fd); return false; }
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+    if (view == MAP_FAILED) return false;
+    bytes = static_cast<const uint8_t*>(view);
+    length = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+    if (!bytes) return;
+#ifdef _WIN32
+    UnmapViewOfFile(bytes);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = fileHandle = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(bytes), length);
+#endif
+    bytes = nullptr;
+    length = 0;
+}
+
+// ---------------------------------------------------------------------------------------------
+// CompiledMap
+
+bool CompiledMap::open(const std::string& path, std::string* error) {
+    close();
+    if (!file.open(path)) {
+        if (error) *error = "cannot map " + path;
+        return false;
+    }
+    if (!bind(file.data(), file.size(), error)) { close(); return false; }
+    return true;
+}
+
+bool CompiledMap::adopt(std::vector<uint8_t> bytes, std::string* error) {
+    close();
+    ownedBytes = std::move(bytes);
+    if (!bind(ownedBytes.data(), ownedBytes.size(), error)) { close(); return false; }
+    return true;
+}
+
+void CompiledMap::close() {
+    file.close();
+    ownedBytes.clear();
+    data = nullptr; size = 0;
+    header = nullptr; layers = nullptr; tilesets = nullptr; regions = nullptr;
+}
+
+bool CompiledMap::bind(const uint8_t* bytes, size_t length, std::string* error) {
+    auto fail = [&](const char* why) { if (error) *error = why; return false; };
+    if (length < sizeof(MapFileHeader)) return fail("file too small");
+    const MapFileHeader* h = reinterpret_cast<const MapFileHeader*>(bytes);
+    if (std::memcmp(h->magic, "PXMP", 4) != 0) return fail("not a compiled map");
+    if (h->version != MAP_FILE_VERSION) return fail("compiled map version mismatch; recompile it");
+    if (h->fileSize != length) return fail("compiled map truncated");
+    if (h->width == 0 || h->height == 0) return fail("empty map");
+    if (static_cast<uint64_t>(h->width) * h->height > MAP_MAX_CELLS) return fail("map too large (see MAP_MAX_CELLS)");
+
+    // Every section has to lie inside the file before anything is dereferenced
+    const uint64_t cells = static_cast<uint64_t>(h->width) * h->height;
+    auto inside = [&](uint64_t offset, uint64_t bytesNeeded) { return offset <= length && bytesNeeded <= length - offset; };
+    if (h->maskWords != (cells + 63) / 64) return fail("bad mask size");
+    if (!inside(h->layersOffset, uint64_t(h->layerCount) * sizeof(MapFileLayer)) ||
+        !inside(h->tilesetsOffset, uint64_t(h->tilesetCount) * sizeof(MapFileTileset)) ||
+        !inside(h->regionsOffset, uint64_t(h->regionCount) * sizeof(MapFileRegion)) ||
+        !inside(h->masksOffset, uint64_t(MAP_MASK_COUNT) * h->maskWords * sizeof(uint64_t)) ||
+        !inside(h->stringsOffset, h->stringsSize) || h->stringsSize == 0 ||
+        bytes[h->stringsOffset + h->stringsSize - 1] != '\0') {
+        return fail("section out of range");
+    }
+    const uint64_t blocks = uint64_t(h->blocksX) * h->blocksY;
+    if (h->blocksX != (h->width + MAP_BLOCK_SIZE - 1) / MAP_BLOCK_SIZE || h->blocksY != (h->height + MAP_BLOCK_SIZE - 1) / MAP_BLOCK_SIZE) {
+        return fail("bad block grid");
+    }
+    const MapFileLayer* l = reinterpret_cast<const MapFileLayer*>(bytes + h->layersOffset);
+    for (uint32_t i = 0; i < h->layerCount; ++i) {
+        const uint64_t blockBytes = uint64_t(MAP_BLOCK_SIZE) * MAP_BLOCK_SIZE * l[i].gidBytes;
+        if ((l[i].gidBytes != 2 && l[i].gidBytes != 4) || l[i].blockTableOffset % 4 != 0 ||
+            !inside(l[i].blockTableOffset, blocks * sizeof(uint32_t)) ||
+            !inside(l[i].blockDataOffset, uint64_t(l[i].blockCount) * blockBytes)) {
+            return fail("layer data out of range");
+        }
+        const uint32_t* table = reinterpret_cast<const uint32_t*>(bytes + l[i].blockTableOffset);
+        for (uint64_t b = 0; b < blocks; ++b) {
+            if (table[b] > l[i].blockCount) return fail("layer block index out of range");
+        }
+    }
+
+    data = bytes; size = length; header = h; layers = l;
+    tilesets = reinterpret_cast<const MapFileTileset*>(bytes + h->tilesetsOffset);
+    regions = reinterpret_cast<const MapFileRegion*>(bytes + h->regionsOffset);
+    return true;
+}
+
+MapBitmask CompiledMap::getMask(MapMaskId mask) const {
+    if (!header || mask >= MAP_MASK_COUNT) return MapBitmask();
+    const uint64_t* words = reinterpret_cast<const uint64_t*>(data + header->masksOffset) + static_cast<size_t>(mask) * header->maskWords;
+    return MapBitmask(words, getWidth(), getHeight());
+}
+
+const char* CompiledMap::getString(uint32_t offset) const {
+    if (!header || offset >= header->stringsSize) return "";
+    return reinterpret_cast<const char*>(data + header->stringsOffset + offset);
+}
+
+// ---------------------------------------------------------------------------------------------
+// TMX reading
+
+namespace {
+
+std::string readWholeFile(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return std::string();
+    fseek(f, 0, SEEK_END); long len = ftell(f); fseek(f, 0, SEEK_SET);
+    std::string out; out.resize(static_cast<size_t>(std::max<long>(len, 0)));
+    size_t rd = fread(out.data(), 1, out.size(), f); (void)rd; fclose(f);
+    return out;
+}
+
+std::string joinPath(const std::string& base, const std::string& rel) {
+    if (rel.empty()) return rel;
+    if (rel.find(':') != std::string::npos) return rel; // absolute (Windows)
+    if (rel[0] == '/' || rel[0] == '\\') return rel;
+    size_t slash = base.find_last_of("/\\");
+    return (slash == std::string::npos) ? rel : base.substr(0, slash + 1) + rel;
+}
+
+// Attribute value from a tag's text; the key must start a word so "width" doesn't match "tilewidth"
+std::string getAttr(const std::string& tag, const std::string& key) {
+    const std::string needle = key + "=\"";
+    size_t k = 0;
+    while ((k = tag.find(needle, k)) != std::string::npos) {
+        if (k > 0 && std::isspace(static_cast<unsigned char>(tag[k - 1]))) {
+            size_t start = k + needle.size();
+            size_t end = tag.find('"', start);
+            if (end == std::string::npos) return std::string();
+            return tag.substr(start, end - start);
+        }
+        k += needle.size();
+    }
+    return std::string();
+}
+
+int getIntAttr(const std::string& tag, const std::string& key, int fallback = 0) {
+    std::string v = getAttr(tag, key);
+    return v.empty() ? fallback : std::atoi(v.c_str());
+}
+
+// Text of the tag starting at pos ("<tileset ... >"), or empty
+std::string tagAt(const std::string& xml, size_t pos) {
+    size_t end = xml.find('>', pos);
+    return end == std::string::npos ? std::string() : xml.substr(pos, end - pos + 1);
+}
+
+std::vector<uint32_t> parseCsv(const std::string& xml, size_t begin, size_t end, size_t expected) {
+    std::vector<uint32_t> gids; gids.reserve(expected);
+    uint64_t val = 0; bool inNum = false;
+    for (size_t i = begin; i < end; ++i) {
+        char ch = xml[i];
+        if (ch >= '0' && ch <= '9') { inNum = true; val = val * 10 + static_cast<uint64_t>(ch - '0'); }
+        else if (inNum) { gids.push_back(static_cast<uint32_t>(val)); val = 0; inNum = false; }
+    }
+    if (inNum) gids.push_back(static_cast<uint32_t>(val));
+    return gids;
+}
+
+bool decodeBase64(const std::string& text, size_t begin, size_t end, std::vector<uint8_t>& out) {
+    static const auto table = [] {
+        std::array<int8_t, 256> t{};
+        t.fill(-1);
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; ++i) t[static_cast<unsigned char>(alphabet[i])] = static_cast<int8_t>(i);
+        return t;
+    }();
+    uint32_t accum = 0;
+    int accumBits = 0;
+    for (size_t i = begin; i < end; ++i) {
+        const unsigned char ch = static_cast<unsigned char>(text[i]);
+        if (ch == '=') break;
+        if (std::isspace(ch)) continue;
+        const int v = table[ch];
+        if (v < 0) return false;
+        accum = (accum << 6) | static_cast<uint32_t>(v);
+        accumBits += 6;
+        if (accumBits >= 8) {
+            accumBits -= 8;
+            out.push_back(static_cast<uint8_t>(accum >> accumBits));
+        }
+    }
+    return true;
+}
+
+// Decodes one <data> or <chunk> payload into exactly `count` GIDs
+bool decodeTileData(const std::string& xml, size_t begin, size_t end, const std::string& encoding,
+                    const std::string& compression, size_t count, std::vector<uint32_t>& gids, std::string& error) {
+    if (encoding == "csv") {
+        gids = parseCsv(xml, begin, end, count);
+    } else if (encoding == "base64") {
+        std::vector<uint8_t> packed;
+        if (!decodeBase64(xml, begin, end, packed)) { error = "bad base64"; return false; }
+        std::vector<uint8_t> raw;
+        bool ok = true;
+        if (compression.empty()) raw = std::move(packed);
+        else if (compression == "zlib") ok = inflateZlib(packed.data(), packed.size(), raw);
+        else if (compression == "gzip") ok = inflateGzip(packed.data(), packed.size(), raw);
+        else if (compression == "zstd") {
+#ifdef USE_ZSTD
+            raw.resize(count * 4);
+            size_t n = ZSTD_decompress(raw.data(), raw.size(), packed.data(), packed.size());
+            ok = !ZSTD_isError(n) && n == raw.size();
+#else
+            error = "zstd-compressed layer, but this build has no zstd support";
+            return false;
+#endif
+        } else {
+            error = "unsupported compression '" + compression + "'";
+            return false;
+        }
+        if (!ok) { error = compression + " data is corrupt"; return false; }
+        if (raw.size() != count * 4) { error = "tile data has the wrong size"; return false; }
+        gids.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t* b = raw.data() + i * 4;
+            gids[i] = uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+        }
+    } else {
+        error = encoding.empty() ? "XML tile elements are not supported; save as CSV or Base64" : "unsupported encoding '" + encoding + "'";
+        return false;
+    }
+    if (gids.size() != count) { error = "tile data has the wrong size"; return false; }
+    return true;
+}
+
+bool readTileset(const std::string& mapPath, const std::string& xml, size_t tagPos, TmxTileset& out) {
+    const std::string header = tagAt(xml, tagPos);
+    out.firstGid = std::max(0, getIntAttr(header, "firstgid"));
+    const std::string source = getAttr(header, "source");
+    std::string imageTag;
+    std::string imageBase = mapPath;
+    if (!source.empty()) {
+        // External TSX: everything but firstgid lives there
+        const std::string tsxPath = joinPath(mapPath, source);
+        const std::string tsx = readWholeFile(tsxPath);
+        if (tsx.empty()) return false;
+        size_t hdr = tsx.find("<tileset");
+        if (hdr == std::string::npos) return false;
+        const std::string h = tagAt(tsx, hdr);
+        out.tileWidth = std::max(1, getIntAttr(h, "tilewidth", 32));
+        out.tileHeight = std::max(1, getIntAttr(h, "tileheight", 32));
+        out.columns = std::max(0, getIntAttr(h, "columns"));
+        out.tileCount = std::max(0, getIntAttr(h, "tilecount"));
+        out.name = getAttr(h, "name");
+        size_t img = tsx.find("<image", hdr);
+        if (img != std::string::npos) imageTag = tagAt(tsx, img);
+        // Image paths in a TSX are relative to the TSX; store them relative to the map
+        imageBase = source;
+    } else {
+        out.tileWidth = std::max(1, getIntAttr(header, "tilewidth", 32));
+        out.tileHeight = std::max(1, getIntAttr(header, "tileheight", 32));
+        out.columns = std::max(0, getIntAttr(header, "columns"));
+        out.tileCount = std::max(0, getIntAttr(header, "tilecount"));
+        out.name = getAttr(header, "name");
+        size_t img = xml.find("<image", tagPos);
+        size_t next = std::min(xml.find("<tileset", tagPos + 1), xml.find("<layer", tagPos));
+        if (img != std::string::npos && (next == std::string::npos || img < next)) imageTag = tagAt(xml, img);
+        imageBase.clear();
+    }
+    out.imageSource = getAttr(imageTag, "source");
+    out.imagePath = imageBase.empty() ? out.imageSource : joinPath(imageBase, out.imageSource);
+    return true;
+}
+
+} // namespace
+
+bool loadTmxMap(const std::string& path, TmxMap& out, std::string* error) {
+    auto fail = [&](const std::string& why) { if (error) *error = why; return false; };
+    out = TmxMap();
+    const std::string xml = readWholeFile(path);
+    if (xml.empty()) return fail("cannot read " + path);
+
+    size_t mapTag = xml.find("<map");
+    if (mapTag == std::string::npos) return fail("no <map> element");
+    const std::string mapHeader = tagAt(xml, mapTag);
+    out.width = getIntAttr(mapHeader, "width");
+    out.height = getIntAttr(mapHeader, "height");
+    out.tileWidth = std::max(1, getIntAttr(mapHeader, "tilewidth", 32));
+    out.tileHeight = std::max(1, getIntAttr(mapHeader, "tileheight", 32));
+
+    for (size_t pos = xml.find("<tileset", mapTag); pos != std::string::npos; pos = xml.find("<tileset", pos + 1)) {
+        TmxTileset ts;
+        if (readTileset(path, xml, pos, ts)) out.tilesets.push_back(ts);
+        else std::fprintf(stderr, "TMX: skipping unreadable tileset at firstgid %d\n", ts.firstGid);
+    }
+    std::sort(out.tilesets.begin(), out.tilesets.end(), [](const TmxTileset& a, const TmxTileset& b) { return a.firstGid < b.firstGid; });
+
+    // Finite layers are one chunk at (0,0); infinite maps store each layer as <chunk> elements
+    // at arbitrary (possibly negative) tile coordinates
+    struct RawChunk { int x; int y; int w; int h; std::vector<uint32_t> gids; };
+    struct RawLayer { std::string name; std::vector<RawChunk> chunks; };
+    std::vector<RawLayer> raw;
+    const bool infinite = getIntAttr(mapHeader, "infinite") != 0;
+    for (size_t pos = xml.find("<layer", mapTag); pos != std::string::npos; ) {
+        const std::string header = tagAt(xml, pos);
+        size_t dataStart = xml.find("<data", pos);
+        size_t dataTagEnd = dataStart == std::string::npos ? std::string::npos : xml.find('>', dataStart);
+        size_t dataClose = dataTagEnd == std::string::npos ? std::string::npos : xml.find("</data>", dataTagEnd);
+        if (dataClose == std::string::npos) break;
+        const std::string dataTag = tagAt(xml, dataStart);
+        const std::string encoding = getAttr(dataTag, "encoding");
+        const std::string compression = getAttr(dataTag, "compression");
+        RawLayer layer;
+        layer.name = getAttr(header, "name");
+        std::string error;
+        bool ok = true;
+        size_t chunkPos = xml.find("<chunk", dataTagEnd);
+        if (chunkPos != std::string::npos && chunkPos < dataClose) {
+            for (; ok && chunkPos != std::string::npos && chunkPos < dataClose; chunkPos = xml.find("<chunk", chunkPos + 1)) {
+                const std::string chunkTag = tagAt(xml, chunkPos);
+                size_t payload = chunkPos + chunkTag.size();
+                size_t chunkClose = xml.find("</chunk>", payload);
+                if (chunkClose == std::string::npos || chunkClose > dataClose) { ok = false; error = "unterminated <chunk>"; break; }
+                RawChunk chunk{ getIntAttr(chunkTag, "x"), getIntAttr(chunkTag, "y"),
+                                getIntAttr(chunkTag, "width"), getIntAttr(chunkTag, "height"), {} };
+                if (chunk.w <= 0 || chunk.h <= 0) continue;
+                ok = decodeTileData(xml, payload, chunkClose, encoding, compression,
+                                    static_cast<size_t>(chunk.w) * chunk.h, chunk.gids, error);
+                if (ok) layer.chunks.push_back(std::move(chunk));
+            }
+        } else {
+            const int w = getIntAttr(header, "width") > 0 ? getIntAttr(header, "width") : out.width;
+            const int h = getIntAttr(header, "height") > 0 ? getIntAttr(header, "height") : out.height;
+            RawChunk chunk{ 0, 0, w, h, {} };
+            ok = w > 0 && h > 0 &&
+                 decodeTileData(xml, dataTagEnd + 1, dataClose, encoding, compression, static_cast<size_t>(w) * h, chunk.gids, error);
+            if (ok) layer.chunks.push_back(std::move(chunk));
+        }
+        if (ok) raw.push_back(std::move(layer));
+        else std::fprintf(stderr, "TMX: layer '%s' skipped: %s\n", layer.name.c_str(), error.c_str());
+        pos = xml.find("<layer", dataClose);
+    }
+
+    // Infinite maps are sized to the chunks actually authored; their top-left becomes tile (0,0)
+    if (infinite) {
+        int minX = 0, minY = 0, maxX = 0, maxY = 0;
+        bool any = false;
+        for (const RawLayer& r : raw) {
+            for (const RawChunk& c : r.chunks) {
+                if (!any) { minX = c.x; minY = c.y; maxX = c.x + c.w; maxY = c.y + c.h; any = true; continue; }
+                minX = std::min(minX, c.x); minY = std::min(minY, c.y);
+                maxX = std::max(maxX, c.x + c.w); maxY = std::max(maxY, c.y + c.h);
+            }
+        }
+        if (!any) return fail("infinite map has no chunks");
+        out.originX = minX; out.originY = minY;
+        out.width = maxX - minX; out.height = maxY - minY;
+    }
+    if (out.width <= 0 || out.height <= 0) return fail("width/height not found");
+    if (static_cast<uint64_t>(out.width) * out.height > MAP_MAX_CELLS) {
+        return fail("map is " + std::to_string(out.width) + "x" + std::to_string(out.height) +
+                    " tiles including the space between its chunks, past the dense limit (MAP_MAX_CELLS)");
+    }
+
+    // Lay every layer onto the map grid so readers can index without checks
+    for (RawLayer& r : raw) {
+        TmxLayer layer;
+        layer.name = r.name;
+        layer.gids.assign(static_cast<size_t>(out.width) * out.height, 0u);
+        for (const RawChunk& c : r.chunks) {
+            for (int cy = 0; cy < c.h; ++cy) {
+                const int y = c.y + cy - out.originY;
+                if (y < 0 || y >= out.height) continue;
+                for (int cx = 0; cx < c.w; ++cx) {
+                    const int x = c.x + cx - out.originX;
+                    if (x < 0 || x >= out.width) continue;
+                    layer.gids[static_cast<size_t>(y) * out.width + x] = c.gids[static_cast<size_t>(cy) * c.w + cx];
+                }
+            }
+        }
+        out.layers.push_back(std::move(layer));
+    }
+
+    for (size_t pos = xml.find("<objectgroup", mapTag); pos != std::string::npos; ) {
+        const std::string groupName = getAttr(tagAt(xml, pos), "name");
+        size_t close = xml.find("</objectgroup>", pos);
+        if (close == std::string::npos) break;
+        for (size_t o = xml.find("<object ", pos); o != std::string::npos && o < close; o = xml.find("<object ", o + 1)) {
+            const std::string tag = tagAt(xml, o);
+            TmxObject obj;
+            obj.group = groupName;
+            obj.name = getAttr(tag, "name");
+            obj.type = getAttr(tag, "type");
+            if (obj.type.empty()) obj.type = getAttr(tag, "class");
+            obj.gid = static_cast<uint32_t>(std::strtoul(getAttr(tag, "gid").c_str(), nullptr, 10));
+            obj.x = static_cast<float>(std::atof(getAttr(tag, "x").c_str())) - static_cast<float>(out.originX * out.tileWidth);
+            obj.y = static_cast<float>(std::atof(getAttr(tag, "y").c_str())) - static_cast<float>(out.originY * out.tileHeight);
+            obj.width = static_cast<float>(std::atof(getAttr(tag, "width").c_str()));
+            obj.height = static_cast<float>(std::atof(getAttr(tag, "height").c_str()));
+            out.objects.push_back(std::move(obj));
+        }
+        pos = xml.find("<objectgroup", close);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Compiling
+
+namespace {
+
+std::string lowercase(std::string s) {
+    for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+uint32_t classifyLayer(const std::string& name) {
+    const std::string lower = lowercase(name);
+    uint32_t flags = 0;
+    if (lower == "plat" || lower == "platform1") flags |= MAP_LAYER_PLATFORM1;
+    if (lower == "plat2" || lower == "platform2") flags |= MAP_LAYER_PLATFORM2;
+    if (lower.find("stairs") != std::string::npos) flags |= MAP_LAYER_STAIRS;
+    if (lower.find("floating") != std::string::npos) flags |= MAP_LAYER_EDGE;
+    // Only actual lava, not "lava passage" which is decorative
+    if (lower == "lava" || lower == "lava river") flags |= MAP_LAYER_LAVA;
+    if (lower.find("ground") != std::string::npos) flags |= MAP_LAYER_GROUND;
+    return flags;
+}
+
+struct BakedMasks {
+    int width = 0;
+    int height = 0;
+    std::vector<std::vector<bool>> masks; // [MapMaskId][cell]
+    bool get(MapMaskId m, int x, int y) const { return masks[m][static_cast<size_t>(y) * width + x]; }
+    void set(MapMaskId m, int x, int y, bool v) { masks[m][static_cast<size_t>(y) * width + x] = v; }
+};
+
+// The underworld collision rules: lava blocks unless covered by a platform or stairs, and ledge
+// faces (cliff edges of a platform, found by adjacency) block except right next to stairs
+BakedMasks bakeMasks(const TmxMap& map) {
+    BakedMasks b;
+    b.width = map.width; b.height = map.height;
+    const size_t cells = static_cast<size_t>(map.width) * map.height;
+    b.masks.assign(MAP_MASK_COUNT, std::vector<bool>(cells, false));
+    const int W = map.width, H = map.height;
+
+    std::vector<uint32_t> flags;
+    for (const TmxLayer& layer : map.layers) flags.push_back(classifyLayer(layer.name));
+
+    // Tile type follows the last relevant layer drawn over a cell: lava layers make it lava,
+    // ground/stairs/platform layers make it stone again
+    std::vector<bool> lavaTile(cells, false);
+    for (size_t li = 0; li < map.layers.size(); ++li) {
+        const uint32_t f = flags[li];
+        const bool isLava = (f & MAP_LAYER_LAVA) != 0;
+        const bool isSolid = (f & (MAP_LAYER_PLATFORM1 | MAP_LAYER_PLATFORM2 | MAP_LAYER_STAIRS | MAP_LAYER_GROUND)) != 0;
+        if (!isLava && !isSolid) continue;
+        const std::vector<uint32_t>& gids = map.layers[li].gids;
+        for (size_t i = 0; i < cells; ++i) {
+            if (gids[i] == 0) continue;
+            lavaTile[i] = isLava;
+        }
+    }
+
+    for (size_t li = 0; li < map.layers.size(); ++li) {
+        const uint32_t f = flags[li];
+        const std::vector<uint32_t>& gids = map.layers[li].gids;
+        for (int y = 0; y < H; ++y) {
+            for (int x = 0; x < W; ++x) {
+                if (gids[static_cast<size_t>(y) * W + x] == 0) continue;
+                if (f & (MAP_LAYER_PLATFORM1 | MAP_LAYER_PLATFORM2)) b.set(MAP_MASK_PLATFORM, x, y, true);
+                if (f & MAP_LAYER_PLATFORM1) b.set(MAP_MASK_PLATFORM1, x, y, true);
+                if (f & MAP_LAYER_PLATFORM2) b.set(MAP_MASK_PLATFORM2, x, y, true);
+                if (f & MAP_LAYER_STAIRS) b.set(MAP_MASK_STAIRS, x, y, true);
+                if (f & MAP_LAYER_EDGE) b.set(MAP_MASK_EDGE, x, y, true);
+                if (f & MAP_LAYER_LAVA) b.set(MAP_MASK_LAVA, x, y, true);
+            }
+        }
+    }
+
+    // Lava is only real where no platform or stairs cover it
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            const size_t i = static_cast<size_t>(y) * W + x;
+            if (b.get(MAP_MASK_LAVA, x, y) && !b.get(MAP_MASK_PLATFORM, x, y) && !b.get(MAP_MASK_STAIRS, x, y)) {
+                b.set(MAP_MASK_BLOCKED, x, y, true);
+                lavaTile[i] = true;
+            }
+            b.set(MAP_MASK_HAZARD, x, y, lavaTile[i]);
+        }
+    }
+
+    auto at = [&](MapMaskId m, int x, int y) { return x >= 0 && y >= 0 && x < W && y < H && b.get(m, x, y); };
+
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            if (b.get(MAP_MASK_BLOCKED, x, y) || !b.get(MAP_MASK_PLATFORM, x, y)) continue;
+            // Tiles on or next to a staircase stay walkable so stairs can be stepped on and off
+            const bool nearStairs = at(MAP_MASK_STAIRS, x, y) || at(MAP_MASK_STAIRS, x, y - 1) || at(MAP_MASK_STAIRS, x, y + 1)
+                                 || at(MAP_MASK_STAIRS, x - 1, y) || at(MAP_MASK_STAIRS, x + 1, y);
+            if (nearStairs) continue;
+            auto faceOf = [&](MapMaskId m, bool& south, bool& side) {
+                bool above = at(m, x, y - 1), below = at(m, x, y + 1), left = at(m, x - 1, y), right = at(m, x + 1, y);
+                south = above && !below;
+                side = above && (right != left);
+            };
+            bool southAny, sideAny, south1, side1, south2, side2;
+            faceOf(MAP_MASK_PLATFORM, southAny, sideAny);
+            faceOf(MAP_MASK_PLATFORM1, south1, side1);
+            faceOf(MAP_MASK_PLATFORM2, south2, side2);
+
+            // (The runtime used to also check a list of known side-piece tile ids, but only on cells
+            // these adjacency rules already block.)
+            const bool face = southAny || south1 || south2 || sideAny || side1 || side2;
+            if (face) {
+                b.set(MAP_MASK_BLOCKED, x, y, true);
+                b.set(MAP_MASK_EDGE, x, y, true);
+            }
+        }
+    }
+    return b;
+}
+
+class ByteWriter {
+public:
+    std::vector<uint8_t>& bytes;
+    explicit ByteWriter(std::vector<uint8_t>& out) : bytes(out) {}
+    size_t align() { while (bytes.size() % 8) bytes.push_back(0); return bytes.size(); }
+    size_t append(const void* src, size_t n) {
+        size_t at = bytes.size();
+        const uint8_t* p = static_cast<const uint8_t*>(src);
+        bytes.insert(bytes.end(), p, p + n);
+        return at;
+    }
+    template <typename T> T& at(size_t offset) { return *reinterpret_cast<T*>(bytes.data() + offset); }
+};
+
+} // namespace
+
+void compileMap(const TmxMap& map, std::vector<uint8_t>& out) {
+    out.clear();
+    const BakedMasks baked = bakeMasks(map);
+    const size_t cells = static_cast<size_t>(map.width) * map.height;
+    const uint32_t maskWords = static_cast<uint32_t>((cells + 63) / 64);
+
+    std::string strings(1, '\0'); // offset 0 is the empty string
+    auto intern = [&](const std::string& s) -> uint32_t {
+        if (s.empty()) return 0;
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings += s;
+        strings.push_back('\0');
+        return offset;
+    };
+
+    ByteWriter w(out);
+    MapFileHeader header{};
+    std::memcpy(header.magic, "PXMP", 4);
+    header.version = MAP_FILE_VERSION;
+    header.width = static_cast<uint32_t>(map.width);
+    header.height = static_cast<uint32_t>(map.height);
+    header.tileWidth = static_cast<uint32_t>(map.tileWidth);
+    header.tileHeight = static_cast<uint32_t>(map.tileHeight);
+    header.layerCount = static_cast<uint32_t>(map.layers.size());
+    header.tilesetCount = static_cast<uint32_t>(map.tilesets.size());
+    header.regionCount = static_cast<uint32_t>(map.objects.size());
+    header.maskWords = maskWords;
+    header.originX = map.originX;
+    header.originY = map.originY;
+    header.blocksX = static_cast<uint32_t>((map.width + MAP_BLOCK_SIZE - 1) / MAP_BLOCK_SIZE);
+    header.blocksY = static_cast<uint32_t>((map.height + MAP_BLOCK_SIZE - 1) / MAP_BLOCK_SIZE);
+    w.append(&header, sizeof(header));
+
+    // Tables first (fixed size), then patch data offsets in once the arrays are written
+    header.layersOffset = w.align();
+    for (const TmxLayer& layer : map.layers) {
+        MapFileLayer entry{};
+        entry.nameOffset = intern(layer.name);
+        entry.flags = classifyLayer(layer.name);
+        const uint32_t maxGid = layer.gids.empty() ? 0 : *std::max_element(layer.gids.begin(), layer.gids.end());
+        entry.gidBytes = maxGid <= 0xFFFFu ? 2 : 4;
+        w.append(&entry, sizeof(entry));
+    }
+    header.tilesetsOffset = w.align();
+    for (const TmxTileset& ts : map.tilesets) {
+        MapFileTileset entry{};
+        entry.firstGid = static_cast<uint32_t>(ts.firstGid);
+        entry.tileCount = static_cast<uint32_t>(ts.tileCount);
+        entry.tileWidth = static_cast<uint32_t>(ts.tileWidth);
+        entry.tileHeight = static_cast<uint32_t>(ts.tileHeight);
+        entry.columns = static_cast<uint32_t>(ts.columns);
+        entry.nameOffset = intern(ts.name);
+        entry.imagePathOffset = intern(ts.imagePath);
+        entry.imageSourceOffset = intern(ts.imageSource);
+        w.append(&entry, sizeof(entry));
+    }
+    header.regionsOffset = w.align();
+    for (const TmxObject& obj : map.objects) {
+        MapFileRegion entry{};
+        entry.groupOffset = intern(obj.group);
+        entry.nameOffset = intern(obj.name);
+        entry.typeOffset = intern(obj.type);
+        entry.gid = obj.gid;
+        entry.x = obj.x; entry.y = obj.y; entry.width = obj.width; entry.height = obj.height;
+        w.append(&entry, sizeof(entry));
+    }
+
+    header.masksOffset = w.align();
+    std::vector<uint64_t> words(maskWords);
+    for (uint32_t m = 0; m < MAP_MASK_COUNT; ++m) {
+        std::fill(words.begin(), words.end(), 0);
+        const std::vector<bool>& bits = baked.masks[m];
+        for (size_t i = 0; i < cells; ++i) if (bits[i]) words[i >> 6] |= uint64_t(1) << (i & 63);
+        w.append(words.data(), words.size() * sizeof(uint64_t));
+    }
+
+    const size_t blockCells = static_cast<size_t>(MAP_BLOCK_SIZE) * MAP_BLOCK_SIZE;
+    std::vector<uint32_t> table(static_cast<size_t>(header.blocksX) * header.blocksY);
+    std::vector<uint32_t> block(blockCells);
+    for (size_t li = 0; li < map.layers.size(); ++li) {
+        const std::vector<uint32_t>& gids = map.layers[li].gids;
+        const size_t entryOffset = header.layersOffset + li * sizeof(MapFileLayer);
+        const bool narrow = w.at<MapFileLayer>(entryOffset).gidBytes == 2;
+
+        // Gather the non-empty blocks first so the table can precede them
+        std::vector<uint32_t> stored;
+        uint32_t blockCount = 0;
+        for (uint32_t by = 0; by < header.blocksY; ++by) {
+            for (uint32_t bx = 0; bx < header.blocksX; ++bx) {
+                bool any = false;
+                for (int y = 0; y < MAP_BLOCK_SIZE; ++y) {
+                    for (int x = 0; x < MAP_BLOCK_SIZE; ++x) {
+                        const int mx = static_cast<int>(bx) * MAP_BLOCK_SIZE + x, my = static_cast<int>(by) * MAP_BLOCK_SIZE + y;
+                        const uint32_t gid = (mx < map.width && my < map.height) ? gids[static_cast<size_t>(my) * map.width + mx] : 0u;
+                        block[static_cast<size_t>(y) * MAP_BLOCK_SIZE + x] = gid;
+                        any |= gid != 0;
+                    }
+                }
+                table[static_cast<size_t>(by) * header.blocksX + bx] = any ? ++blockCount : 0;
+                if (any) stored.insert(stored.end(), block.begin(), block.end());
+            }
+        }
+
+        const size_t tableOffset = w.align();
+        w.append(table.data(), table.size() * sizeof(uint32_t));
+        const size_t dataOffset = w.align();
+        if (narrow) {
+            std::vector<uint16_t> packed(stored.begin(), stored.end());
+            w.append(packed.data(), packed.size() * sizeof(uint16_t));
+        } else {
+            w.append(stored.data(), stored.size() * sizeof(uint32_t));
+        }
+        MapFileLayer& entry = w.at<MapFileLayer>(entryOffset);
+        entry.blockCount = blockCount;
+        entry.blockTableOffset = tableOffset;
+        entry.blockDataOffset = dataOffset;
+    }
+
+    header.stringsOffset = w.align();
+    header.stringsSize = strings.size();
+    w.append(strings.data(), strings.size());
+    w.align();
+    header.fileSize = out.size();
+    std::memcpy(out.data(), &header, sizeof(header));
+}
+
+bool writeCompiledMap(const TmxMap& map, const std::string& path, std::string* error) {
+    std::vector<uint8_t> bytes;
+    compileMap(map, bytes);
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) { if (error) *error = "cannot write " + path; return false; }
+    size_t written = fwrite(bytes.data(), 1, bytes.size(), f);
+    bool ok = (fclose(f) == 0) && written == bytes.size();
+    if (!ok && error) *error = "short write to " + path;
+    return ok;
+}
+
+std::string compiledMapPathFor(const std::string& tmxPath) {
+    size_t dot = tmxPath.find_last_of('.');
+    size_t slash = tmxPath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return tmxPath + MAP_FILE_EXTENSION;
+    return tmxPath.substr(0, dot) + MAP_FILE_EXTENSION;
+}
+
+std::string resolveMapPath(const std::string& mapPath, const std::string& relative) {
+    return joinPath(mapPath, relative);
+}
@@ -0,0 +1,241 @@
+#include "MusicStream.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#ifdef USE_VORBIS
+#include <vorbis/vorbisfile.h>
+#endif
+
+namespace {
+
+uint32_t readLE32(const unsigned char* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24); }
+uint16_t readLE16(const unsigned char* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+// RIFF/WAVE reader for PCM (8/16/32-bit) and 32-bit float, streamed straight from the file
+class WavDecoder : public MusicDecoder {
+public:
+    bool open(const std::string& path, std::string* error) {
+        auto fail = [&](const char* message) { if (error) *error = message; return false; };
+        file.open(path, std::ios::binary);
+        if (!file) return fail("cannot open file");
+        file.seekg(0, std::ios::end);
+        const std::streamoff fileSize = file.tellg();
+        file.seekg(0);
+
+        unsigned char riff[12];
+        if (!file.read(reinterpret_cast<char*>(riff), 12) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0)
+            return fail("not a RIFF/WAVE file");
+
+        uint16_t formatTag = 0, bits = 0;
+        bool haveFormat = false;
+        unsigned char chunk[8];
+        while (file.read(reinterpret_cast<char*>(chunk), 8)) {
+            const uint32_t size = readLE32(chunk + 4);
+            const std::streamoff next = static_cast<std::streamoff>(file.tellg()) + size + (size & 1);
+            if (std::memcmp(chunk, "fmt ", 4) == 0) {
+                unsigned char fmt[40] = {};
+                if (size < 16 || !file.read(reinterpret_cast<char*>(fmt), std::min<uint32_t>(size, sizeof(fmt)))) return fail("bad fmt chunk");
+                formatTag = readLE16(fmt);
+                channels = readLE16(fmt + 2);
+                rate = static_cast<int>(readLE32(fmt + 4));
+                bits = readLE16(fmt + 14);
+                if (formatTag == 0xFFFE && size >= 26) formatTag = readLE16(fmt + 24); // WAVE_FORMAT_EXTENSIBLE subformat
+                haveFormat = true;
+            } else if (std::memcmp(chunk, "data", 4) == 0) {
+                if (!haveFormat) return fail("data chunk before fmt chunk");
+                dataStart = file.tellg();
+                // Some writers leave the size unset while streaming; trust the file length instead
+                dataSize = static_cast<uint32_t>(std::min<std::streamoff>(size, fileSize - dataStart));
+                break;
+            }
+            file.seekg(next);
+        }
+        if (dataStart < 0) return fail("no data chunk");
+
+        if (formatTag == 1 && bits == 8) format = AUDIO_U8;
+        else if (formatTag == 1 && bits == 16) format = AUDIO_S16LSB;
+        else if (formatTag == 1 && bits == 32) format = AUDIO_S32LSB;
+        else if (formatTag == 3 && bits == 32) format = AUDIO_F32LSB;
+        else return fail("unsupported WAV sample format");
+        if (channels < 1 || channels > 8 || rate <= 0) return fail("bad WAV channel count or rate");
+        frameBytes = channels * bits / 8;
+        remaining = dataSize - dataSize % frameBytes;
+        return true;
+    }
+
+    int read(Uint8* buffer, int bytes) override {
+        uint32_t want = std::min<uint32_t>(remaining, static_cast<uint32_t>(bytes));
+        want -= want % frameBytes;
+        if (want == 0) return 0;
+        file.read(reinterpret_cast<char*>(buffer), want);
+        const uint32_t got = static_cast<uint32_t>(file.gcount());
+        if (got == 0) return -1; // shorter than its header claims
+        remaining -= got;
+        return static_cast<int>(got - got % frameBytes);
+    }
+
+    bool rewind() override {
+        file.clear();
+        file.seekg(dataStart);
+        remaining = dataSize - dataSize % frameBytes;
+        return static_cast<bool>(file);
+    }
+
+private:
+    std::ifstream file;
+    std::streamoff dataStart = -1;
+    uint32_t dataSize = 0;
+    uint32_t remaining = 0;
+    uint32_t frameBytes = 1;
+};
+
+#ifdef USE_VORBIS
+class VorbisDecoder : public MusicDecoder {
+public:
+    ~VorbisDecoder() override { if (opened) ov_clear(&vorbisFile); }
+
+    bool open(const std::string& path, std::string* error) {
+        if (ov_fopen(path.c_str(), &vorbisFile) != 0) {
+            if (error) *error = "not an Ogg Vorbis file";
+            return false;
+        }
+        opened = true;
+        const vorbis_info* info = ov_info(&vorbisFile, -1);
+        channels = info->channels;
+        rate = static_cast<int>(info->rate);
+        format = AUDIO_S16LSB;
+        return true;
+    }
+
+    int read(Uint8* buffer, int bytes) override {
+        for (;;) {
+            int section = 0;
+            const long got = ov_read(&vorbisFile, reinterpret_cast<char*>(buffer), bytes, 0 /* little-endian */, 2, 1, &section);
+            if (got == OV_HOLE) continue; // recoverable gap in the stream
+            return got < 0 ? -1 : static_cast<int>(got);
+        }
+    }
+
+    bool rewind() override { return ov_pcm_seek(&vorbisFile, 0) == 0; }
+
+private:
+    OggVorbis_File vorbisFile{};
+    bool opened = false;
+};
+#endif
+
+} // namespace
+
+std::unique_ptr<MusicDecoder> openMusicDecoder(const std::string& path, std::string* error) {
+    std::string extension = path.substr(std::min(path.size(), path.find_last_of('.')));
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (extension == ".ogg") {
+#ifdef USE_VORBIS
+        auto decoder = std::make_unique<VorbisDecoder>();
+        if (!decoder->open(path, error)) return nullptr;
+        return decoder;
+#else
+        if (error) *error = "Ogg Vorbis music needs a build with libvorbisfile";
+        return nullptr;
+#endif
+    }
+    auto decoder = std::make_unique<WavDecoder>();
+    if (!decoder->open(path, error)) return nullptr;
+    return decoder;
+}
+
+std::unique_ptr<MusicStream> MusicStream::open(const std::string& path, const SDL_AudioSpec& deviceSpec, std::string* error) {
+    std::unique_ptr<MusicDecoder> decoder = openMusicDecoder(path, error);
+    if (!decoder) return nullptr;
+
+    std::unique_ptr<MusicStream> stream(new MusicStream());
+    stream->converter = SDL_NewAudioStream(decoder->format, static_cast<Uint8>(decoder->channels), decoder->rate,
+                                           AUDIO_S16SYS, deviceSpec.channels, deviceSpec.freq);
+    if (!stream->converter) {
+        if (error) *error = SDL_GetError();
+        return nullptr;
+    }
+    stream->decoder = std::move(decoder);
+    stream->channels = deviceSpec.channels;
+    size_t ringSize = 1;
+    while (ringSize < static_cast<size_t>(deviceSpec.freq) * deviceSpec.channels / RING_SECONDS_DENOMINATOR) ringSize <<= 1;
+    stream->ring.resize(ringSize);
+    stream->ringMask = ringSize - 1;
+    stream->decodeBlock.resize(DECODE_BLOCK_BYTES);
+    stream->convertBlock.resize(DECODE_BLOCK_BYTES / sizeof(Sint16));
+
+    stream->fill(); // prime the ring so playback starts without a gap
+    if (stream->failed) {
+        if (error) *error = "decode error";
+        return nullptr;
+    }
+    stream->worker = std::thread(&MusicStream::run, stream.get());
+    return stream;
+}
+
+MusicStream::~MusicStream() {
+    stopping = true;
+    if (worker.joinable()) worker.join();
+    if (converter) SDL_FreeAudioStream(converter);
+}
+
+int MusicStream::read(Sint16* out, int frames) {
+    const size_t read = readPos.load(std::memory_order_relaxed);
+    const size_t available = writePos.load(std::memory_order_acquire) - read;
+    const size_t count = std::min(available, static_cast<size_t>(frames) * channels);
+    const size_t start = read & ringMask;
+    const size_t first = std::min(count, ring.size() - start);
+    std::memcpy(out, ring.data() + start, first * sizeof(Sint16));
+    std::memcpy(out + first, ring.data(), (count - first) * sizeof(Sint16));
+    readPos.store(read + count, std::memory_order_release);
+    return static_cast<int>(count / channels);
+}
+
+void MusicStream::fill() {
+    const int frameBytes = channels * static_cast<int>(sizeof(Sint16));
+    bool decodedSinceRewind = true;
+    while (!stopping && !failed) {
+        const size_t write = writePos.load(std::memory_order_relaxed);
+        const size_t space = ring.size() - (write - readPos.load(std::memory_order_acquire));
+        const int pending = SDL_AudioStreamAvailable(converter);
+
+        if (pending > 0) {
+            // Move already-converted frames into the ring before decoding more
+            int bytes = std::min({ pending, static_cast<int>(convertBlock.size() * sizeof(Sint16)), static_cast<int>(space * sizeof(Sint16)) });
+            bytes -= bytes % frameBytes;
+            if (bytes == 0) return; // ring is full
+            const int got = SDL_AudioStreamGet(converter, convertBlock.data(), bytes);
+            if (got < 0) { failed = true; break; }
+            const size_t count = static_cast<size_t>(got) / sizeof(Sint16);
+            const size_t start = write & ringMask;
+            const size_t first = std::min(count, ring.size() - start);
+            std::memcpy(ring.data() + start, convertBlock.data(), first * sizeof(Sint16));
+            std::memcpy(ring.data(), convertBlock.data() + first, (count - first) * sizeof(Sint16));
+            writePos.store(write + count, std::memory_order_release);
+            continue;
+        }
+        if (space < static_cast<size_t>(channels)) return;
+
+        const int got = decoder->read(decodeBlock.data(), static_cast<int>(decodeBlock.size()));
+        if (got < 0) { failed = true; break; }
+        if (got == 0) {
+            // End of track: loop. A track that yields nothing after a rewind would spin forever.
+            if (!decodedSinceRewind || !decoder->rewind()) { failed = true; break; }
+            decodedSinceRewind = false;
+            continue;
+        }
+        decodedSinceRewind = true;
+        if (SDL_AudioStreamPut(converter, decodeBlock.data(), got) != 0) { failed = true; break; }
+    }
+    if (failed) std::cerr << "Music stream stopped: decode error" << std::endl;
+}
+
+void MusicStream::run() {
+    while (!stopping && !failed) {
+        fill();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
@@ -1,6 +1,8 @@
 #include "Object.h"
 #include "AssetManager.h"
+#include "Renderer.h"
 #include "LootGenerator.h"
+#include "Random.h"
 #include <iostream>
 #include <cmath>
 
@@ -119,7 +121,7 @@ void Object::update(float deltaTime) {
     }
 }
 
-void Object::render(SDL_Renderer* renderer, int cameraX, int cameraY, int tileSize, float zoom) {
+void Object::render(Renderer* renderer, int cameraX, int cameraY, int tileSize, float zoom) {
     if (!visible) {
         return;
     }
@@ -197,7 +199,7 @@ void Object::render(SDL_Renderer* renderer, int cameraX, int cameraY, int tileSi
         }
         
         // Render the texture
-        SDL_RenderCopy(renderer, sdlTexture, &srcRect, &dstRect);
+        renderer->copy(sdlTexture, &srcRect, &dstRect);
     } else {
         // Fallback: render a colored rectangle based on object type
         SDL_Color color;
@@ -228,20 +230,23 @@ void Object::render(SDL_Renderer* renderer, int cameraX, int cameraY, int tileSi
         }
         
         // Render colored rectangle as fallback
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        renderer->setDrawColor(color.r, color.g, color.b, color.a);
         SDL_Rect fallbackRect = {screenX, screenY, tileSize, tileSize};
-        SDL_RenderFillRect(renderer, &fallbackRect);
+        renderer->fillRect(&fallbackRect);
     }
 }
 
 void Object::interact() {
+    // Contents depend only on the session seed and where the container sits
+    RandomStream containerRandom = Random::stream(RngSystem::Containers,
+        (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y));
     switch (type) {
         case ObjectType::CHEST_UNOPENED:
             std::cout << "Opening chest..." << std::endl;
             
             // Generate loot if this chest doesn't already have any
             if (!hasLoot()) {
-                auto generatedLoot = LootGenerator::getInstance().generateContainerLoot(type);
+                auto generatedLoot = LootGenerator::getInstance().generateContainerLoot(containerRandom, type);
                 for (const auto& lootItem : generatedLoot) {
                     addLoot(lootItem);
                 }
@@ -265,7 +270,7 @@ void Object::interact() {
             
             // Generate loot if this pot doesn't already have any
             if (!hasLoot()) {
-                auto generatedLoot = LootGenerator::getInstance().generateContainerLoot(type);
+                auto generatedLoot = LootGenerator::getInstance().generateContainerLoot(containerRandom, type);
                 for (const auto& lootItem : generatedLoot) {
                     addLoot(lootItem);
                 }
@@ -286,7 +291,7 @@ void Object::interact() {
             
             // Generate loot if this crate doesn't already have any
             if (!hasLoot()) {
-                auto generatedLoot = LootGenerator::getInstance().generateContainerLoot(type);
+                auto generatedLoot = LootGenerator::getInstance().generateContainerLoot(containerRandom, type);
                 for (const auto& lootItem : generatedLoot) {
                     addLoot(lootItem);
                 }
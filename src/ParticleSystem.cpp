@@ -0,0 +1,153 @@
+#include "ParticleSystem.h"
+#include "AssetManager.h"
+#include "Renderer.h"
+#include <iostream>
+
+ParticleSystem::ParticleSystem(AssetManager* assetManager)
+    : assetManager(assetManager),
+      posX(CAPACITY), posY(CAPACITY), velX(CAPACITY), velY(CAPACITY),
+      age(CAPACITY), lifetime(CAPACITY), fps(CAPACITY), radius(CAPACITY),
+      damage(CAPACITY), sprite(CAPACITY), flags(CAPACITY),
+      order(CAPACITY) {
+    damaging.reserve(CAPACITY);
+    bursts.reserve(64);
+}
+
+ParticleSystem::SpriteHandle ParticleSystem::resolveSprite(const std::string& path, float scale) {
+    SpriteSheet* sheet = assetManager ? assetManager->getSpriteSheet(path) : nullptr;
+    if (!sheet || sheet->getTotalFrames() <= 0) {
+        std::cout << "Warning: Sprite sheet not found for path: " << path << std::endl;
+        return NO_SPRITE;
+    }
+    sprites.push_back({sheet, scale});
+    return static_cast<SpriteHandle>(sprites.size() - 1);
+}
+
+int ParticleSystem::spawn(SpriteHandle spriteHandle, float x, float y, float vx, float vy, float life,
+                          float framesPerSecond, float r, int dmg, uint8_t particleFlags) {
+    if (count >= CAPACITY) return -1;
+    int i = count++;
+    posX[i] = x;
+    posY[i] = y;
+    velX[i] = vx;
+    velY[i] = vy;
+    age[i] = 0.0f;
+    lifetime[i] = life;
+    fps[i] = framesPerSecond;
+    radius[i] = r;
+    damage[i] = dmg;
+    sprite[i] = spriteHandle;
+    flags[i] = particleFlags;
+    if (particleFlags & FLAG_DAMAGE) {
+        damaging.push_back(i);
+    }
+    return i;
+}
+
+void ParticleSystem::removeAt(int i) {
+    int last = --count;
+    if (i == last) return;
+    posX[i] = posX[last];
+    posY[i] = posY[last];
+    velX[i] = velX[last];
+    velY[i] = velY[last];
+    age[i] = age[last];
+    lifetime[i] = lifetime[last];
+    fps[i] = fps[last];
+    radius[i] = radius[last];
+    damage[i] = damage[last];
+    sprite[i] = sprite[last];
+    flags[i] = flags[last];
+}
+
+void ParticleSystem::update(float deltaTime, float worldW, float worldH) {
+    bursts.clear();
+    damaging.clear();
+
+    int i = 0;
+    while (i < count) {
+        age[i] += deltaTime;
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+
+        bool expired = age[i] >= lifetime[i];
+        if (expired && (flags[i] & FLAG_BURST_ON_EXPIRE)) {
+            bursts.push_back({posX[i], posY[i]});
+        }
+        bool outOfBounds = posX[i] < -500.0f || posX[i] > worldW + 500.0f ||
+                           posY[i] < -500.0f || posY[i] > worldH + 500.0f;
+        if (expired || outOfBounds) {
+            // The last particle moves into slot i and is processed on the next iteration
+            removeAt(i);
+            continue;
+        }
+
+        if (flags[i] & FLAG_DAMAGE) {
+            damaging.push_back(i);
+        }
+        ++i;
+    }
+}
+
+void ParticleSystem::render(Renderer* renderer) {
+    if (!renderer || count == 0) return;
+
+    // Counting sort by sprite handle; the last bucket holds particles without a sprite
+    const int buckets = static_cast<int>(sprites.size()) + 1;
+    bucketStart.assign(buckets + 1, 0);
+    for (int i = 0; i < count; i++) {
+        int b = sprite[i] == NO_SPRITE ? buckets - 1 : sprite[i];
+        bucketStart[b + 1]++;
+    }
+    for (int b = 0; b < buckets; b++) {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    for (int i = 0; i < count; i++) {
+        int b = sprite[i] == NO_SPRITE ? buckets - 1 : sprite[i];
+        order[bucketStart[b]++] = i;
+    }
+
+    // bucketStart[b] now marks the end of bucket b
+    int begin = 0;
+    for (int b = 0; b < buckets; b++) {
+        int end = bucketStart[b];
+        if (b == buckets - 1) {
+            // Fallback squares for effects whose sprite sheet is missing
+            renderer->setDrawColor(255, 100, 0, 200);
+            for (int k = begin; k < end; k++) {
+                int i = order[k];
+                SDL_Rect rect = {
+                    static_cast<int>(posX[i] - radius[i]),
+                    static_cast<int>(posY[i] - radius[i]),
+                    static_cast<int>(radius[i] * 2),
+                    static_cast<int>(radius[i] * 2)
+                };
+                renderer->fillRect(&rect);
+            }
+        } else if (begin < end) {
+            const Sprite& s = sprites[b];
+            SDL_Texture* texture = s.sheet->getTexture()->getTexture();
+            int totalFrames = s.sheet->getTotalFrames();
+            for (int k = begin; k < end; k++) {
+                int i = order[k];
+                int frame = static_cast<int>(age[i] * fps[i]) % totalFrames;
+                SDL_Rect srcRect = s.sheet->getFrameRect(frame);
+                int w = static_cast<int>(srcRect.w * s.scale);
+                int h = static_cast<int>(srcRect.h * s.scale);
+                SDL_Rect destRect = {
+                    static_cast<int>(posX[i] - w / 2),
+                    static_cast<int>(posY[i] - h / 2),
+                    w, h
+                };
+                renderer->copy(texture, &srcRect, &destRect);
+            }
+        }
+        begin = end;
+    }
+}
+
+void ParticleSystem::clear() {
+    count = 0;
+    damaging.clear();
+    bursts.clear();
+}
@@ -11,6 +11,7 @@
 #include "DatabaseSQLite.h"
 #include "ItemSystem.h"
 #include "SpellSystem.h"
+#include "TileCollision.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
@@ -90,6 +91,8 @@ Player::Player(Game* game) : game(game), x(Game::WINDOW_WIDTH / 2.0f - 32.0f), y
                 if (itemSystem->addItemToSlot(starterItem, i, false)) {
                     // Then equip from that slot
                     itemSystem->equipItem(i);
+                } else {
+                    itemSystem->destroyItem(starterItem);
                 }
             }
         }
@@ -395,27 +398,26 @@ void Player::handleInput(const InputManager* inputManager) {
     
     // Spell casting: 3-6 keys or Q,E,R,F
     if (spellSystem && currentState != PlayerState::ATTACKING_MELEE && currentState != PlayerState::ATTACKING_RANGED) {
-        const Uint8* keyState = SDL_GetKeyboardState(nullptr);
-        
+        // Keys are read through the input manager so replays drive spells too
         // Number keys 3-6 for spells (with cooldown checks)
-        if (keyState[SDL_SCANCODE_3] && isSpellSlotReady(0)) {
+        if (inputManager->isKeyHeld(SDL_SCANCODE_3) && isSpellSlotReady(0)) {
             spellSystem->castSpell(0);
-        } else if (keyState[SDL_SCANCODE_4] && isSpellSlotReady(1)) {
+        } else if (inputManager->isKeyHeld(SDL_SCANCODE_4) && isSpellSlotReady(1)) {
             spellSystem->castSpell(1);
-        } else if (keyState[SDL_SCANCODE_5] && isSpellSlotReady(2)) {
+        } else if (inputManager->isKeyHeld(SDL_SCANCODE_5) && isSpellSlotReady(2)) {
             spellSystem->castSpell(2);
-        } else if (keyState[SDL_SCANCODE_6] && isSpellSlotReady(3)) {
+        } else if (inputManager->isKeyHeld(SDL_SCANCODE_6) && isSpellSlotReady(3)) {
             spellSystem->castSpell(3);
         }
         
         // Alternative QERF keys (with cooldown checks)
-        else if (keyState[SDL_SCANCODE_Q] && isSpellSlotReady(0)) {
+        else if (inputManager->isKeyHeld(SDL_SCANCODE_Q) && isSpellSlotReady(0)) {
             spellSystem->castSpell(0);
-        } else if (keyState[SDL_SCANCODE_E] && !inputManager->isActionPressed(InputAction::INTERACT) && isSpellSlotReady(1)) {
+        } else if (inputManager->isKeyHeld(SDL_SCANCODE_E) && !inputManager->isActionPressed(InputAction::INTERACT) && isSpellSlotReady(1)) {
             spellSystem->castSpell(1);
-        } else if (keyState[SDL_SCANCODE_R] && isSpellSlotReady(2)) {
+        } else if (inputManager->isKeyHeld(SDL_SCANCODE_R) && isSpellSlotReady(2)) {
             spellSystem->castSpell(2);
-        } else if (keyState[SDL_SCANCODE_F] && !inputManager->isActionPressed(InputAction::DASH) && isSpellSlotReady(3)) {
+        } else if (inputManager->isKeyHeld(SDL_SCANCODE_F) && !inputManager->isActionPressed(InputAction::DASH) && isSpellSlotReady(3)) {
             spellSystem->castSpell(3);
         }
         
@@ -426,6 +428,20 @@ void Player::handleInput(const InputManager* inputManager) {
     }
 }
 
+TileSweepResult Player::sweepFeet(float dx, float dy) const {
+    if (!game || !game->getWorld()) {
+        TileSweepResult free;
+        free.dx = dx;
+        free.dy = dy;
+        return free;
+    }
+    // Small box around the feet point (horizontal centre, 90% down the sprite)
+    const float footX = x + width * 0.5f;
+    const float footY = y + height * 0.9f;
+    const TileBox feet{footX - FEET_HALF_WIDTH, footY - FEET_HALF_HEIGHT, footX + FEET_HALF_WIDTH, footY + FEET_HALF_HEIGHT};
+    return game->getWorld()->getCollision().sweep(feet, dx, dy, TileCollision::WALKER);
+}
+
 void Player::move(float deltaTime) {
     if (currentState == PlayerState::DEAD) {
         return; // Can't move when dead
@@ -448,10 +464,12 @@ void Player::move(float deltaTime) {
                 stepY *= scale;
             }
         }
-        x += stepX;
-        y += stepY;
+        const TileSweepResult step = sweepFeet(stepX, stepY);
+        x += step.dx;
+        y += step.dy;
         dashRemainingDistance = std::max(0.0f, dashRemainingDistance - stepDist);
-        if (dashRemainingDistance <= 0.0f) {
+        // A dash into a wall or ledge ends against it
+        if (dashRemainingDistance <= 0.0f || step.blockedX || step.blockedY) {
             setState(PlayerState::IDLE);
         }
         return;
@@ -469,65 +487,10 @@ void Player::move(float deltaTime) {
     float dx = moveX * moveSpeed * speedFactor * deltaTime;
     float dy = moveY * moveSpeed * speedFactor * deltaTime;
 
-    // Prevent stepping into non-walkable/hazard tiles (e.g., lava) and enforce ledge rules
-    if (game && game->getWorld()) {
-        World* world = game->getWorld();
-        int ts = world->getTileSize();
-        auto feetTile = [&](float px, float py) {
-            int tileX = static_cast<int>((px + width * 0.5f) / ts);
-            int tileY = static_cast<int>((py + height * 0.9f) / ts);
-            return std::pair<int,int>(tileX, tileY);
-        };
-        // X axis
-        float tryX = x + dx;
-        auto [txX, tyX] = feetTile(tryX, y);
-        int tileIdX = world->getTile(txX, tyX);
-        bool walkableX = world->isWalkable(txX, tyX);
-        bool allowX = (tileIdX >= 0) && (tileIdX != TILE_LAVA) && walkableX;
-        if (allowX) {
-            auto [curTx, curTy] = feetTile(x, y);
-            if (world->isLedgeCrossingBlocked(curTx, curTy, txX, tyX)) {
-                allowX = false;
-            }
-        }
-        if (!allowX && dx != 0) {
-            // Debug why movement is blocked
-            std::cout << "X movement blocked: tile(" << txX << "," << tyX << ") id=" << tileIdX 
-                      << " walkable=" << walkableX << " lava=" << (tileIdX == TILE_LAVA) << std::endl;
-        }
-        if (allowX) x = tryX;
-
-        // Y axis
-        float tryY = y + dy;
-        auto [txY, tyY] = feetTile(x, tryY);
-        auto [curTx, curTy] = feetTile(x, y);
-        int tileIdY = world->getTile(txY, tyY); // note: getTile expects (x,y) in tile coords
-        bool walkableY = world->isWalkable(txY, tyY);
-        bool allowY = (tileIdY >= 0) && (tileIdY != TILE_LAVA) && walkableY;
-        
-        // Debug movement details
-        if (dy != 0 && abs(tyY - curTy) > 1) {
-            std::cout << "WARNING: Large Y movement detected! Current tile: (" << curTx << "," << curTy 
-                      << ") Target tile: (" << txY << "," << tyY << ")" 
-                      << " dy=" << dy << " tryY=" << tryY << " y=" << y << std::endl;
-        }
-        
-        // Ledge rule: if vertical move crosses platform boundary and no stairs, block it
-        if (allowY) {
-            if (world->isLedgeBlockedVertical(curTx, curTy, txY, tyY) || world->isLedgeCrossingBlocked(curTx, curTy, txY, tyY)) {
-                allowY = false;
-            }
-        }
-        if (!allowY && dy != 0) {
-            // Debug why movement is blocked
-            std::cout << "Y movement blocked: from tile(" << curTx << "," << curTy << ") to tile(" << txY << "," << tyY << ") id=" << tileIdY 
-                      << " walkable=" << walkableY << " lava=" << (tileIdY == TILE_LAVA) << std::endl;
-        }
-        if (allowY) y = tryY;
-    } else {
-        x += dx;
-        y += dy;
-    }
+    // Feet box against non-walkable/hazard tiles (e.g., lava) and ledge rules
+    const TileSweepResult step = sweepFeet(dx, dy);
+    x += step.dx;
+    y += step.dy;
 
     // Tile hazards: water and lava
     if (game && game->getWorld()) {
@@ -568,11 +531,7 @@ void Player::performMeleeAttack() {
     // Enter attack state; the animation system will pick the proper sheet per direction
     setState(PlayerState::ATTACKING_MELEE);
     // Apply sword attack speed multiplier to cooldown
-    {
-        const auto& sword = equipment[static_cast<size_t>(EquipmentSlot::SWORD)];
-        float aspd = (sword.attackSpeedMultiplier > 0.01f ? sword.attackSpeedMultiplier : 1.0f);
-        meleeAttackTimer = meleeAttackCooldown / aspd;
-    }
+    meleeAttackTimer = meleeAttackCooldown / getMeleeAttackSpeed();
     currentFrame = 0;
     frameTimer = 0.0f;
     meleeHitConsumedThisSwing = false;
@@ -760,23 +719,8 @@ void Player::takeDamageWithType(int damage, int fireDamage) {
         return;
     }
     
-    // Calculate fire resistance from armor
-    int fireResistance = 0;
-    
-    // Check legacy Player equipment for fire resistance
-    for (int i = 0; i < 9; ++i) {
-        fireResistance += equipment[i].ice; // Using ice field for fire resist temporarily
-    }
-    
-    // Check ItemSystem equipment for fire resistance
-    if (itemSystem) {
-        const auto& equipSlots = itemSystem->getEquipmentSlots();
-        for (const auto& slot : equipSlots) {
-            if (!slot.isEmpty() && slot.item->type == ItemType::EQUIPMENT) {
-                fireResistance += slot.item->stats.fireResist;
-            }
-        }
-    }
+    // Fire resistance from armor
+    int fireResistance = getCombatStats().fireResistance;
     
     // Apply fire resistance to fire damage
     int mitigatedFireDamage = std::max(0, fireDamage - fireResistance);
@@ -906,7 +850,8 @@ void Player::interact() {
                             
                             addItemToInventoryWithRarity(itemId, item.amount, static_cast<int>(item.rarity));
                         }
-                        notification += item.getRarityString() + " " + item.name;
+                        notification += item.getRarityString() + " ";
+                        notification += item.name;
                         break;
                     case LootType::SCROLL:
                         // Map scroll names to item IDs and add to enhanced inventory
@@ -930,18 +875,21 @@ void Player::interact() {
                             
                             addItemToInventoryWithRarity(scrollId, item.amount, static_cast<int>(item.rarity));
                         }
-                        notification += item.getRarityString() + " " + item.name;
+                        notification += item.getRarityString() + " ";
+                        notification += item.name;
                         break;
                     case LootType::MATERIAL:
                         // Add materials to the ItemSystem resource inventory
                         if (itemSystem) {
                             ItemRarity rarity = static_cast<ItemRarity>(static_cast<int>(item.rarity));
-                            itemSystem->addItem(item.name, item.amount, rarity);
+                            itemSystem->addItem(std::string(item.name), item.amount, rarity);
                         } else {
                             // Fallback to legacy system if ItemSystem is not available
-                            addItemToInventory("material_" + item.name, item.amount);
+                            addItemToInventory("material_" + std::string(item.name), item.amount);
                         }
-                        notification += item.getRarityString() + " " + item.name + " x" + std::to_string(item.amount);
+                        notification += item.getRarityString() + " ";
+                        notification += item.name;
+                        notification += " x" + std::to_string(item.amount);
                         break;
                 }
             }
@@ -1111,7 +1059,7 @@ void Player::setDirection(Direction newDirection) {
     }
 }
 
-void Player::render(Renderer* renderer) {
+void Player::render(Renderer* renderer, const EntityTransform& transform) {
     if (!renderer || !currentSpriteSheet) {
         std::cout << "Player render failed: renderer=" << (renderer ? "valid" : "null") 
                   << ", spriteSheet=" << (currentSpriteSheet ? "valid" : "null") << std::endl;
@@ -1119,7 +1067,7 @@ void Player::render(Renderer* renderer) {
     }
     
     // Get source rectangle for current frame
-    SDL_Rect srcRect = currentSpriteSheet->getFrameRect(currentFrame);
+    SDL_Rect srcRect = currentSpriteSheet->getFrameRect(transform.frame);
     
     // Generic render: use frame size directly; scale to 64px width while keeping aspect
     int frameWidth = currentSpriteSheet->getFrameWidth();
@@ -1137,12 +1085,12 @@ void Player::render(Renderer* renderer) {
         float sy = (static_cast<float>(wy - camY)) * z;
         return SDL_Point{ static_cast<int>(std::floor(sx)), static_cast<int>(std::floor(sy)) };
     };
-    SDL_Point tl = scaledEdge(static_cast<int>(x - spriteOffsetX), static_cast<int>(y - spriteOffsetY));
-    SDL_Point br = scaledEdge(static_cast<int>(x - spriteOffsetX + dstW), static_cast<int>(y - spriteOffsetY + dstH));
+    SDL_Point tl = scaledEdge(static_cast<int>(transform.x - spriteOffsetX), static_cast<int>(transform.y - spriteOffsetY));
+    SDL_Point br = scaledEdge(static_cast<int>(transform.x - spriteOffsetX + dstW), static_cast<int>(transform.y - spriteOffsetY + dstH));
     SDL_Rect dstRect = { tl.x, tl.y, std::max(1, br.x - tl.x), std::max(1, br.y - tl.y) };
     
     // Render the sprite
-    SDL_RenderCopy(renderer->getSDLRenderer(), currentSpriteSheet->getTexture()->getTexture(), &srcRect, &dstRect);
+    renderer->copy(currentSpriteSheet->getTexture()->getTexture(), &srcRect, &dstRect);
 
     // Render fire shield overlay centered on player
     if (shieldActive && mana > 0 && fireShieldSpriteSheet) {
@@ -1159,8 +1107,8 @@ void Player::render(Renderer* renderer) {
         SDL_Rect fs = fireShieldSpriteSheet->getFrameRect(fireShieldFrame);
         int fW = fireShieldSpriteSheet->getFrameWidth();
         int fH = fireShieldSpriteSheet->getFrameHeight();
-        int fx = static_cast<int>(x + width/2 - fW/2);
-        int fy = static_cast<int>(y + height/2 - fH/2 - 5); // nudge up 5px
+        int fx = static_cast<int>(transform.x + width/2 - fW/2);
+        int fy = static_cast<int>(transform.y + height/2 - fH/2 - 5); // nudge up 5px
         int camX2=0, camY2=0; renderer->getCamera(camX2, camY2); float z2 = renderer->getZoom();
         auto scaled = [camX2, camY2, z2](int wx, int wy) -> SDL_Point {
             float sx = (static_cast<float>(wx - camX2)) * z2;
@@ -1170,12 +1118,7 @@ void Player::render(Renderer* renderer) {
         SDL_Point tl2 = scaled(fx, fy);
         SDL_Point br2 = scaled(fx + fW, fy + fH);
         SDL_Rect dst2{ tl2.x, tl2.y, std::max(1, br2.x - tl2.x), std::max(1, br2.y - tl2.y) };
-        SDL_RenderCopy(renderer->getSDLRenderer(), fireShieldSpriteSheet->getTexture()->getTexture(), &fs, &dst2);
-    }
-    
-    // Render spell effects
-    if (spellSystem) {
-        spellSystem->render(renderer);
+        renderer->copy(fireShieldSpriteSheet->getTexture()->getTexture(), &fs, &dst2);
     }
 }
 
@@ -1215,6 +1158,11 @@ void Player::gainExperience(int xp) {
 }
 
 // --- Equipment upgrades and enchants ---
+void Player::markEquipmentChanged() {
+    ++equipmentVersion;
+    if (itemSystem) itemSystem->markChanged();
+}
+
 void Player::upgradeEquipment(EquipmentSlot slot, int deltaPlus) {
     size_t idx = static_cast<size_t>(slot);
     int before = equipment[idx].plusLevel;
@@ -1245,6 +1193,7 @@ void Player::upgradeEquipment(EquipmentSlot slot, int deltaPlus) {
     if (slot == EquipmentSlot::SWORD) {
         updateSwordNameByPlus();
     }
+    markEquipmentChanged();
 }
 
 void Player::upgradeSpecificItem(Item* item, int deltaPlus) {
@@ -1280,6 +1229,7 @@ void Player::upgradeSpecificItem(Item* item, int deltaPlus) {
             }
         }
     }
+    markEquipmentChanged();
 }
 
 void Player::enchantEquipment(EquipmentSlot slot, const std::string& element, int amount) {
@@ -1312,6 +1262,7 @@ void Player::enchantEquipment(EquipmentSlot slot, const std::string& element, in
             // Lightning not implemented yet in ItemSystem
         }
     }
+    markEquipmentChanged();
 }
 
 void Player::enchantSpecificItem(Item* item, const std::string& element, int amount) {
@@ -1348,6 +1299,7 @@ void Player::enchantSpecificItem(Item* item, const std::string& element, int amo
             }
         }
     }
+    markEquipmentChanged();
 }
 
 void Player::clearEquipmentSlot(EquipmentSlot slot) {
@@ -1356,6 +1308,7 @@ void Player::clearEquipmentSlot(EquipmentSlot slot) {
     
     // Clear the Player equipment array entry
     equipment[idx] = EquipmentItem{};  // Reset to default empty state
+    markEquipmentChanged();
 }
 
 void Player::syncEquipmentFromItem(EquipmentSlot slot, const Item* item) {
@@ -1377,6 +1330,7 @@ void Player::syncEquipmentFromItem(EquipmentSlot slot, const Item* item) {
         meleeDamage = strength * 2 + weaponBonus;
         updateSwordNameByPlus();
     }
+    markEquipmentChanged();
 }
 
 int Player::getElementScrolls(const std::string& element) const {
@@ -1553,6 +1507,7 @@ void Player::applySaveState(const PlayerSave& s) {
             else if (k == "poison_scroll" || k == "poison") elementScrolls["poison"] += c;
         }
     }
+    markEquipmentChanged();
 }
 
 PlayerSave Player::makeSaveState() const {
@@ -1953,34 +1908,66 @@ void Player::updateSwordStatsByPlus() {
     }
 }
 
-int Player::rollMeleeDamageForHit() {
-    // Base damage = strength*2 + sword ATK
+const Player::CombatStats& Player::getCombatStats() const {
+    CombatStatsSources sources;
+    sources.itemVersion = itemSystem ? itemSystem->getVersion() : 0;
+    sources.equipmentVersion = equipmentVersion;
+    sources.strength = strength;
+    sources.spellElement = spellSystem ? static_cast<int>(spellSystem->getActiveElement()) : 0;
+    sources.enchantLevel = spellSystem ? spellSystem->getActiveEnchantLevel() : 0;
+    if (!(sources == combatStatsSources)) {
+        rebuildCombatStats(sources);
+    }
+    return combatStats;
+}
+
+void Player::rebuildCombatStats(const CombatStatsSources& sources) const {
+    CombatStats stats;
+    stats.version = combatStats.version + 1;
     const auto& sword = equipment[static_cast<size_t>(EquipmentSlot::SWORD)];
-    int base = strength * 2 + sword.attack;
-    
-    // Add fire damage from weapon enchantment
-    int fireDamage = sword.fire;
+    const auto& waist = equipment[static_cast<size_t>(EquipmentSlot::WAIST)];
     
-    // Add fire damage from ItemSystem if available
+    // Legacy array values; equipped Items override elemental damage where stronger
+    stats.weaponFireDamage = sword.fire;
+    int waistFire = waist.fire;
+    for (int i = 0; i < 9; ++i) {
+        stats.fireResistance += equipment[i].ice; // Using ice field for fire resist temporarily
+    }
     if (itemSystem) {
+        stats.itemTotals = itemSystem->getTotalStats();
+        stats.fireResistance += stats.itemTotals.fireResist;
         const auto& equipSlots = itemSystem->getEquipmentSlots();
-        int swordSlot = static_cast<int>(EquipmentSlot::SWORD);
-        if (swordSlot < equipSlots.size() && !equipSlots[swordSlot].isEmpty()) {
-            Item* swordItem = equipSlots[swordSlot].item;
-            fireDamage = std::max(fireDamage, swordItem->stats.fireAttack);
-        }
+        const InventorySlot& swordSlot = equipSlots[static_cast<size_t>(EquipmentSlot::SWORD)];
+        const InventorySlot& waistSlot = equipSlots[static_cast<size_t>(EquipmentSlot::WAIST)];
+        if (!swordSlot.isEmpty()) stats.weaponFireDamage = std::max(stats.weaponFireDamage, swordSlot.item->stats.fireAttack);
+        if (!waistSlot.isEmpty()) waistFire = std::max(waistFire, waistSlot.item->stats.fireAttack);
     }
     
-    int totalBaseDamage = base + fireDamage;
+    stats.meleeDamage = strength * 2 + sword.attack + stats.weaponFireDamage;
+    stats.fireShieldDamage = FIRE_SHIELD_DAMAGE + waistFire;
+    stats.critChancePercent = std::max(0.0f, std::min(100.0f, sword.critChancePercent));
+    stats.attackSpeedMultiplier = (sword.attackSpeedMultiplier > 0.01f ? sword.attackSpeedMultiplier : 1.0f);
+    stats.lowHealthAttackSpeedMultiplier = stats.attackSpeedMultiplier *
+        (spellSystem ? spellSystem->getLowHealthAttackSpeedMultiplier() : 1.0f);
     
-    // Simple crit roll using SDL ticks as rng seed source
-    float critChance = std::max(0.0f, std::min(100.0f, sword.critChancePercent));
+    combatStats = stats;
+    combatStatsSources = sources;
+}
+
+float Player::getMeleeAttackSpeed() const {
+    const CombatStats& stats = getCombatStats();
+    return (health < maxHealth / 2) ? stats.lowHealthAttackSpeedMultiplier : stats.attackSpeedMultiplier;
+}
+
+int Player::rollMeleeDamageForHit() {
+    const CombatStats& stats = getCombatStats();
+    int totalBaseDamage = stats.meleeDamage;
+    
+    // Crit roll
+    float critChance = stats.critChancePercent;
     bool isCrit = false;
     if (critChance > 0.0f) {
-        // Deterministic pseudo-rng for now
-        unsigned r = static_cast<unsigned>((SDL_GetTicks() * 1103515245u + 12345u) & 0x7fffffff);
-        float roll01 = (r % 10000) / 100.0f; // 0..100
-        isCrit = (roll01 < critChance);
+        isCrit = rng.nextFloat(0.0f, 100.0f) < critChance;
     }
     
     int dmg = totalBaseDamage;
@@ -1997,26 +1984,14 @@ int Player::rollMeleeDamageForHit() {
 }
 
 int Player::getFireDamageForHit() {
-    const auto& sword = equipment[static_cast<size_t>(EquipmentSlot::SWORD)];
-    int fireDamage = sword.fire;
-    
-    // Add fire damage from ItemSystem if available
-    if (itemSystem) {
-        const auto& equipSlots = itemSystem->getEquipmentSlots();
-        int swordSlot = static_cast<int>(EquipmentSlot::SWORD);
-        if (swordSlot < equipSlots.size() && !equipSlots[swordSlot].isEmpty()) {
-            Item* swordItem = equipSlots[swordSlot].item;
-            fireDamage = std::max(fireDamage, swordItem->stats.fireAttack);
-        }
-    }
-    
-    return fireDamage;
+    return getCombatStats().weaponFireDamage;
 }
 
 void Player::updateProjectiles(float deltaTime) {
     // Update all projectiles
+    const World* world = game ? game->getWorld() : nullptr;
     for (auto& projectile : projectiles) {
-        projectile->update(deltaTime);
+        projectile->update(deltaTime, world);
     }
     
     // Remove inactive projectiles
@@ -2034,24 +2009,8 @@ void Player::renderProjectiles(Renderer* renderer) {
 }
 
 int Player::getFireShieldDamage() {
-    // Base fire shield damage
-    int baseDamage = FIRE_SHIELD_DAMAGE;
-    
-    // Add fire damage from waist equipment (belt determines fire shield ability)
-    const auto& waist = equipment[static_cast<size_t>(EquipmentSlot::WAIST)];
-    int enchantedFireDamage = waist.fire;
-    
-    // Add fire damage from ItemSystem waist equipment if available
-    if (itemSystem) {
-        const auto& equipSlots = itemSystem->getEquipmentSlots();
-        int waistSlot = static_cast<int>(EquipmentSlot::WAIST);
-        if (waistSlot < equipSlots.size() && !equipSlots[waistSlot].isEmpty()) {
-            Item* waistItem = equipSlots[waistSlot].item;
-            enchantedFireDamage = std::max(enchantedFireDamage, waistItem->stats.fireAttack);
-        }
-    }
-    
-    return baseDamage + enchantedFireDamage;
+    // Base damage plus the belt's fire enchant (belt determines fire shield ability)
+    return getCombatStats().fireShieldDamage;
 }
 
 // Enhanced item system methods
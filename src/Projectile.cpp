@@ -1,6 +1,7 @@
 #include "Projectile.h"
 #include "Renderer.h"
 #include "AssetManager.h"
+#include "World.h"
 #include <iostream>
 
 Projectile::Projectile(float x, float y,
@@ -41,7 +42,7 @@ Projectile::Projectile(float x, float y,
     }
 }
 
-void Projectile::update(float deltaTime) {
+void Projectile::update(float deltaTime, const World* world) {
     if (!active) return;
     
     // Update lifetime
@@ -52,10 +53,20 @@ void Projectile::update(float deltaTime) {
     }
     
     // Update movement using direction vector
+    const float fromX = x + width * 0.5f, fromY = y + height * 0.5f;
     x += direction.x * speed * deltaTime;
     y += direction.y * speed * deltaTime;
-    
-    // Do not deactivate based on hardcoded screen bounds; world is chunked and camera can move.
+
+    // Terrain: the centre's path this tick against walls, then the loaded chunk set (not screen
+    // bounds; the world is chunked and the camera can move)
+    if (world) {
+        const float toX = x + width * 0.5f, toY = y + height * 0.5f;
+        if (world->getCollision().raycast(fromX, fromY, toX, toY, TileCollision::SOLID) ||
+            !world->isInLoadedChunks(toX, toY)) {
+            active = false;
+            return;
+        }
+    }
     
     // Update animation
     updateAnimation(deltaTime);
@@ -92,7 +103,7 @@ void Projectile::render(Renderer* renderer) {
             adjusted.w = static_cast<int>(adjusted.w * z);
             adjusted.h = static_cast<int>(adjusted.h * z);
         }
-        SDL_RenderCopyEx(renderer->getSDLRenderer(), spriteSheet->getTexture()->getTexture(), &srcRect, &adjusted, angleDeg, nullptr, SDL_FLIP_NONE);
+        renderer->copyEx(spriteSheet->getTexture()->getTexture(), &srcRect, &adjusted, angleDeg, nullptr, SDL_FLIP_NONE);
     } else {
         renderer->renderTexture(spriteSheet->getTexture()->getTexture(), &srcRect, &dstRect);
     }
@@ -0,0 +1,37 @@
+#include "Random.h"
+#include <atomic>
+#include <random>
+
+namespace {
+uint64_t initialSeed() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+}
+
+std::atomic<uint64_t> sessionSeed{initialSeed()};
+std::atomic<uint64_t> sequences[static_cast<int>(RngSystem::COUNT)];
+}
+
+void Random::setSeed(uint64_t seed) {
+    sessionSeed.store(seed, std::memory_order_relaxed);
+    for (auto& sequence : sequences) {
+        sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Random::getSeed() {
+    return sessionSeed.load(std::memory_order_relaxed);
+}
+
+RandomStream Random::stream(RngSystem system, uint64_t entity, uint64_t tick) {
+    // Each component goes through the finalizer so nearby keys give unrelated streams
+    uint64_t key = RandomStream::mix(getSeed() ^ RandomStream::mix(static_cast<uint64_t>(system) + 1));
+    key = RandomStream::mix(key ^ (entity * 0xD1B54A32D192ED03ull));
+    key = RandomStream::mix(key ^ (tick * 0x8CB92BA72F3D8DD7ull));
+    return RandomStream(key);
+}
+
+RandomStream Random::sequenced(RngSystem system) {
+    uint64_t n = sequences[static_cast<int>(system)].fetch_add(1, std::memory_order_relaxed);
+    return stream(system, n);
+}
@@ -0,0 +1,79 @@
+#include "RenderSnapshot.h"
+#include <cmath>
+
+void RenderSnapshot::clear() {
+    tick = 0;
+    player = EntityTransform();
+    boss = EntityTransform();
+    enemies.clear();
+    cameraX = 0;
+    cameraY = 0;
+    draw.clear();
+}
+
+void RenderSnapshot::copyTransforms(const RenderSnapshot& from) {
+    tick = from.tick;
+    player = from.player;
+    boss = from.boss;
+    enemies = from.enemies;
+    cameraX = from.cameraX;
+    cameraY = from.cameraY;
+}
+
+RenderSnapshot& RenderSnapshotBuffer::beginPublish(uint64_t tick) {
+    RenderSnapshot& snapshot = frames.back().current;
+    snapshot.clear();
+    snapshot.tick = tick;
+    return snapshot;
+}
+
+void RenderSnapshotBuffer::endPublish() {
+    Frame& frame = frames.back();
+    frame.previous.copyTransforms(hasPublished ? lastPublished : frame.current);
+    lastPublished.copyTransforms(frame.current);
+    hasPublished = true;
+    frames.publish();
+}
+
+bool RenderSnapshotBuffer::acquire() {
+    if (!frames.consume()) return false;
+    acquired = true;
+    return true;
+}
+
+EntityTransform RenderSnapshotBuffer::blend(const EntityTransform& from, const EntityTransform& to, float alpha) {
+    if (from.entity != to.entity ||
+        std::fabs(to.x - from.x) > TELEPORT_DISTANCE || std::fabs(to.y - from.y) > TELEPORT_DISTANCE) {
+        return to;
+    }
+    EntityTransform result = to;
+    result.x = from.x + (to.x - from.x) * alpha;
+    result.y = from.y + (to.y - from.y) * alpha;
+    return result;
+}
+
+void RenderSnapshotBuffer::interpolate(float alpha, RenderSnapshot& out) const {
+    const RenderSnapshot& from = previous();
+    const RenderSnapshot& to = current();
+    out.tick = to.tick;
+    out.cameraX = to.cameraX;
+    out.cameraY = to.cameraY;
+    out.player = blend(from.player, to.player, alpha);
+    out.boss = blend(from.boss, to.boss, alpha);
+
+    // Enemies keep their relative order between ticks (removals compact, spawns append), so one
+    // forward cursor pairs them up; entities new this tick are drawn where they are
+    out.enemies.resize(to.enemies.size());
+    size_t cursor = 0;
+    for (size_t i = 0; i < to.enemies.size(); i++) {
+        const EntityTransform& target = to.enemies[i];
+        size_t probe = cursor;
+        while (probe < from.enemies.size() && from.enemies[probe].entity != target.entity) probe++;
+        if (probe < from.enemies.size()) {
+            out.enemies[i] = blend(from.enemies[probe], target, alpha);
+            cursor = probe + 1;
+        } else {
+            out.enemies[i] = target;
+        }
+    }
+}
@@ -1,11 +1,36 @@
 #include "Renderer.h"
 #include <iostream>
 #include <cmath>
+#include <utility>
 
-Renderer::Renderer(SDL_Renderer* sdlRenderer) : renderer(sdlRenderer), cameraX(0), cameraY(0) {
+Renderer::Renderer(SDL_Renderer* sdlRenderer)
+    : renderer(sdlRenderer), cameraX(0), cameraY(0),
+      targetsSupported(sdlRenderer && SDL_RenderTargetSupported(sdlRenderer)) {
     if (!renderer) {
         throw std::runtime_error("Renderer requires a valid SDL_Renderer");
     }
+    updateOutputSize();
+}
+
+Renderer::~Renderer() {
+    invalidatePanels();
+}
+
+void Renderer::beginRecording(DrawList& list) {
+    list.clear();
+    frameList = &list;
+    target = &list;
+    anchor = DrawList::ANCHOR_SCREEN;
+}
+
+void Renderer::endRecording() {
+    frameList = nullptr;
+    target = nullptr;
+}
+
+DrawList::Command* Renderer::record(DrawList::Command::Op op) {
+    if (!target) return nullptr;
+    return &target->push(op, anchor);
 }
 
 void Renderer::renderTexture(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* dstRect) {
@@ -28,7 +53,7 @@ void Renderer::renderTexture(SDL_Texture* texture, const SDL_Rect* srcRect, cons
         }
     }
     
-    SDL_RenderCopy(renderer, texture, srcRect, dstRect ? &adjustedDstRect : nullptr);
+    copy(texture, srcRect, dstRect ? &adjustedDstRect : nullptr);
 }
 
 void Renderer::renderTexture(SDL_Texture* texture, int x, int y, int width, int height) {
@@ -43,7 +68,7 @@ void Renderer::renderTexture(SDL_Texture* texture, int x, int y, int width, int
         dstRect.w = static_cast<int>(dstRect.w * zoom);
         dstRect.h = static_cast<int>(dstRect.h * zoom);
     }
-    SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
+    copy(texture, nullptr, &dstRect);
 }
 
 void Renderer::renderTextureEx(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* dstRect, 
@@ -67,8 +92,7 @@ void Renderer::renderTextureEx(SDL_Texture* texture, const SDL_Rect* srcRect, co
         }
     }
     
-    SDL_RenderCopyEx(renderer, texture, srcRect, dstRect ? &adjustedDstRect : nullptr, 
-                     angle, center, flip);
+    copyEx(texture, srcRect, dstRect ? &adjustedDstRect : nullptr, angle, center, flip);
 }
 
 void Renderer::renderTextureFlipped(SDL_Texture* texture, int x, int y, int width, int height, 
@@ -94,63 +118,34 @@ void Renderer::renderTextureFlipped(SDL_Texture* texture, int x, int y, int widt
         flip = SDL_FLIP_VERTICAL;
     }
     
-    SDL_RenderCopyEx(renderer, texture, nullptr, &dstRect, 0.0, nullptr, flip);
+    copyEx(texture, nullptr, &dstRect, 0.0, nullptr, flip);
 }
 
 void Renderer::renderText(const std::string& text, TTF_Font* font, int x, int y, SDL_Color color) {
-    if (!font || text.empty()) {
-        return;
-    }
-    
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
-    if (!surface) {
-        std::cerr << "Failed to render text: " << TTF_GetError() << std::endl;
-        return;
-    }
-    
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    
-    if (!texture) {
-        std::cerr << "Failed to create texture from text surface: " << SDL_GetError() << std::endl;
-        return;
-    }
-    
-    int width, height;
-    SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
-    
-    SDL_Rect dstRect = {x - cameraX, y - cameraY, width, height};
-    SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
-    
-    SDL_DestroyTexture(texture);
+    recordText(text, font, x, y, color, false);
 }
 
 void Renderer::renderTextCentered(const std::string& text, TTF_Font* font, int x, int y, SDL_Color color) {
-    if (!font || text.empty()) {
+    recordText(text, font, x, y, color, true);
+}
+
+void Renderer::recordText(const std::string& text, TTF_Font* font, int x, int y, SDL_Color color, bool centered) {
+    if (!font || text.empty() || !target) {
         return;
     }
     
+    // Rasterized here, where the font lives; the replay only uploads the surface
     SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
     if (!surface) {
         std::cerr << "Failed to render text: " << TTF_GetError() << std::endl;
         return;
     }
     
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    
-    if (!texture) {
-        std::cerr << "Failed to create texture from text surface: " << SDL_GetError() << std::endl;
-        return;
-    }
-    
-    int width, height;
-    SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
-    
-    SDL_Rect dstRect = {x - width/2 - cameraX, y - height/2 - cameraY, width, height};
-    SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
-    
-    SDL_DestroyTexture(texture);
+    DrawList::Command* command = record(DrawList::Command::Op::Text);
+    command->index = target->addSurface(surface);
+    command->hasDst = true;
+    command->dst = centered ? SDL_Rect{x - surface->w/2, y - surface->h/2, surface->w, surface->h}
+                            : SDL_Rect{x, y, surface->w, surface->h};
 }
 
 void Renderer::renderRect(const SDL_Rect& rect, SDL_Color color, bool filled) {
@@ -163,15 +158,15 @@ void Renderer::renderRect(int x, int y, int width, int height, SDL_Color color,
     SDL_Rect rect = {x - cameraX, y - cameraY, width, height};
     
     if (filled) {
-        SDL_RenderFillRect(renderer, &rect);
+        fillRect(&rect);
     } else {
-        SDL_RenderDrawRect(renderer, &rect);
+        drawRect(&rect);
     }
 }
 
 void Renderer::renderLine(int x1, int y1, int x2, int y2, SDL_Color color) {
     setDrawColor(color);
-    SDL_RenderDrawLine(renderer, x1 - cameraX, y1 - cameraY, x2 - cameraX, y2 - cameraY);
+    drawLine(x1 - cameraX, y1 - cameraY, x2 - cameraX, y2 - cameraY);
 }
 
 void Renderer::renderCircle(int centerX, int centerY, int radius, SDL_Color color, bool filled) {
@@ -197,19 +192,19 @@ void Renderer::renderCircle(int centerX, int centerY, int radius, SDL_Color colo
 
 void Renderer::drawCirclePoints(int centerX, int centerY, int x, int y, SDL_Color color, bool filled) {
     if (filled) {
-        SDL_RenderDrawLine(renderer, centerX - x, centerY + y, centerX + x, centerY + y);
-        SDL_RenderDrawLine(renderer, centerX - x, centerY - y, centerX + x, centerY - y);
-        SDL_RenderDrawLine(renderer, centerX - y, centerY + x, centerX + y, centerY + x);
-        SDL_RenderDrawLine(renderer, centerX - y, centerY - x, centerX + y, centerY - x);
+        drawLine(centerX - x, centerY + y, centerX + x, centerY + y);
+        drawLine(centerX - x, centerY - y, centerX + x, centerY - y);
+        drawLine(centerX - y, centerY + x, centerX + y, centerY + x);
+        drawLine(centerX - y, centerY - x, centerX + y, centerY - x);
     } else {
-        SDL_RenderDrawPoint(renderer, centerX + x, centerY + y);
-        SDL_RenderDrawPoint(renderer, centerX - x, centerY + y);
-        SDL_RenderDrawPoint(renderer, centerX + x, centerY - y);
-        SDL_RenderDrawPoint(renderer, centerX - x, centerY - y);
-        SDL_RenderDrawPoint(renderer, centerX + y, centerY + x);
-        SDL_RenderDrawPoint(renderer, centerX - y, centerY + x);
-        SDL_RenderDrawPoint(renderer, centerX + y, centerY - x);
-        SDL_RenderDrawPoint(renderer, centerX - y, centerY - x);
+        drawPoint(centerX + x, centerY + y);
+        drawPoint(centerX - x, centerY + y);
+        drawPoint(centerX + x, centerY - y);
+        drawPoint(centerX - x, centerY - y);
+        drawPoint(centerX + y, centerY + x);
+        drawPoint(centerX - y, centerY + x);
+        drawPoint(centerX + y, centerY - x);
+        drawPoint(centerX - y, centerY - x);
     }
 }
 
@@ -232,14 +227,140 @@ void Renderer::renderProgressBar(int x, int y, int width, int height, float prog
 }
 
 void Renderer::setDrawColor(SDL_Color color) {
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+    if (DrawList::Command* command = record(DrawList::Command::Op::DrawColor)) command->color = color;
 }
 
 void Renderer::setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
-    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    setDrawColor(SDL_Color{r, g, b, a});
+}
+
+void Renderer::setDrawBlendMode(SDL_BlendMode mode) {
+    if (DrawList::Command* command = record(DrawList::Command::Op::DrawBlendMode)) command->blend = mode;
+}
+
+void Renderer::fillRect(const SDL_Rect* rect) {
+    if (DrawList::Command* command = record(DrawList::Command::Op::FillRect)) {
+        command->hasDst = rect != nullptr;
+        if (rect) command->dst = *rect;
+    }
+}
+
+void Renderer::drawRect(const SDL_Rect* rect) {
+    if (DrawList::Command* command = record(DrawList::Command::Op::DrawRect)) {
+        command->hasDst = rect != nullptr;
+        if (rect) command->dst = *rect;
+    }
+}
+
+void Renderer::drawLine(int x1, int y1, int x2, int y2) {
+    if (DrawList::Command* command = record(DrawList::Command::Op::Line)) command->dst = SDL_Rect{x1, y1, x2, y2};
 }
 
-void Renderer::clear() {
+void Renderer::drawPoint(int x, int y) {
+    if (DrawList::Command* command = record(DrawList::Command::Op::Point)) command->dst = SDL_Rect{x, y, 0, 0};
+}
+
+void Renderer::copy(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* dstRect) {
+    if (!texture) return;
+    if (DrawList::Command* command = record(DrawList::Command::Op::Copy)) {
+        command->texture = texture;
+        command->hasSrc = srcRect != nullptr;
+        if (srcRect) command->src = *srcRect;
+        command->hasDst = dstRect != nullptr;
+        if (dstRect) command->dst = *dstRect;
+    }
+}
+
+void Renderer::copyEx(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* dstRect,
+                      double angle, const SDL_Point* center, SDL_RendererFlip flip) {
+    if (!texture) return;
+    if (DrawList::Command* command = record(DrawList::Command::Op::CopyEx)) {
+        command->texture = texture;
+        command->hasSrc = srcRect != nullptr;
+        if (srcRect) command->src = *srcRect;
+        command->hasDst = dstRect != nullptr;
+        if (dstRect) command->dst = *dstRect;
+        command->angle = angle;
+        command->hasCenter = center != nullptr;
+        if (center) command->center = *center;
+        command->flip = flip;
+    }
+}
+
+void Renderer::setTextureColorMod(SDL_Texture* texture, Uint8 r, Uint8 g, Uint8 b) {
+    if (!texture) return;
+    if (DrawList::Command* command = record(DrawList::Command::Op::TextureColorMod)) {
+        command->texture = texture;
+        command->color = SDL_Color{r, g, b, 255};
+    }
+}
+
+void Renderer::setTextureAlphaMod(SDL_Texture* texture, Uint8 a) {
+    if (!texture) return;
+    if (DrawList::Command* command = record(DrawList::Command::Op::TextureAlphaMod)) {
+        command->texture = texture;
+        command->color = SDL_Color{255, 255, 255, a};
+    }
+}
+
+void Renderer::setTextureBlendMode(SDL_Texture* texture, SDL_BlendMode mode) {
+    if (!texture) return;
+    if (DrawList::Command* command = record(DrawList::Command::Op::TextureBlendMode)) {
+        command->texture = texture;
+        command->blend = mode;
+    }
+}
+
+void Renderer::getOutputSize(int* width, int* height) const {
+    if (width) *width = outputWidth.load(std::memory_order_relaxed);
+    if (height) *height = outputHeight.load(std::memory_order_relaxed);
+}
+
+bool Renderer::beginPanel(int id, int w, int h, uint64_t key, int screenX, int screenY, int& originX, int& originY) {
+    originX = screenX;
+    originY = screenY;
+    if (!targetsSupported || !frameList) {
+        return true; // no render-to-texture: draw straight to the screen every frame
+    }
+    RecordedPanel& panel = recordedPanels[id];
+    if (panel.content && panel.key == key && panel.w == w && panel.h == h) {
+        return false;
+    }
+    // A fresh list rather than clearing the old one: frames still in flight may show it
+    panel.content = std::make_shared<DrawList>();
+    panel.w = w;
+    panel.h = h;
+    panel.key = key;
+    panel.drawing = true;
+    target = panel.content.get();
+    originX = 0;
+    originY = 0;
+    return true;
+}
+
+void Renderer::endPanel(int id, int screenX, int screenY) {
+    if (!targetsSupported || !frameList) return; // panel was drawn directly
+    auto it = recordedPanels.find(id);
+    if (it == recordedPanels.end() || !it->second.content) return;
+    RecordedPanel& panel = it->second;
+    if (panel.drawing) {
+        panel.drawing = false;
+        target = frameList;
+    }
+    DrawList::Panel entry;
+    entry.id = id;
+    entry.w = panel.w;
+    entry.h = panel.h;
+    entry.key = panel.key;
+    entry.content = panel.content;
+    DrawList::Command& command = frameList->push(DrawList::Command::Op::Panel, DrawList::ANCHOR_SCREEN);
+    command.index = frameList->addPanel(std::move(entry));
+    command.hasDst = true;
+    command.dst = SDL_Rect{screenX, screenY, panel.w, panel.h};
+}
+
+void Renderer::clear(Uint8 r, Uint8 g, Uint8 b) {
+    SDL_SetRenderDrawColor(renderer, r, g, b, 255);
     SDL_RenderClear(renderer);
 }
 
@@ -247,6 +368,124 @@ void Renderer::present() {
     SDL_RenderPresent(renderer);
 }
 
+void Renderer::updateOutputSize() {
+    int w = 0, h = 0;
+    SDL_GetRendererOutputSize(renderer, &w, &h);
+    outputWidth.store(w, std::memory_order_relaxed);
+    outputHeight.store(h, std::memory_order_relaxed);
+}
+
+void Renderer::invalidatePanels() {
+    for (auto& entry : panelTextures) {
+        if (entry.second.texture) SDL_DestroyTexture(entry.second.texture);
+    }
+    panelTextures.clear();
+}
+
+void Renderer::replay(const DrawList& list, const ReplayOffsets& offsets) {
+    replayCommands(list, offsets, nullptr);
+}
+
+void Renderer::replayCommands(const DrawList& list, const ReplayOffsets& offsets, const SDL_Point* fixedOffset) {
+    using Op = DrawList::Command::Op;
+    for (const DrawList::Command& command : list.getCommands()) {
+        SDL_Point offset{0, 0};
+        if (fixedOffset) {
+            offset = *fixedOffset;
+        } else if (command.anchor == DrawList::ANCHOR_WORLD) {
+            offset = offsets.world;
+        } else if (command.anchor == DrawList::ANCHOR_PLAYER) {
+            offset = offsets.player;
+        } else if (command.anchor == DrawList::ANCHOR_BOSS) {
+            offset = offsets.boss;
+        } else if (command.anchor >= 0) {
+            offset = command.anchor < static_cast<int>(offsets.enemies.size()) ? offsets.enemies[command.anchor] : offsets.world;
+        }
+        SDL_Rect dst = command.dst;
+        dst.x += offset.x;
+        dst.y += offset.y;
+        const SDL_Rect* dstRect = command.hasDst ? &dst : nullptr;
+        const SDL_Rect* srcRect = command.hasSrc ? &command.src : nullptr;
+        switch (command.op) {
+            case Op::DrawColor:
+                SDL_SetRenderDrawColor(renderer, command.color.r, command.color.g, command.color.b, command.color.a);
+                break;
+            case Op::DrawBlendMode: SDL_SetRenderDrawBlendMode(renderer, command.blend); break;
+            case Op::FillRect: SDL_RenderFillRect(renderer, dstRect); break;
+            case Op::DrawRect: SDL_RenderDrawRect(renderer, dstRect); break;
+            case Op::Line:
+                SDL_RenderDrawLine(renderer, dst.x, dst.y, command.dst.w + offset.x, command.dst.h + offset.y);
+                break;
+            case Op::Point: SDL_RenderDrawPoint(renderer, dst.x, dst.y); break;
+            case Op::Copy: SDL_RenderCopy(renderer, command.texture, srcRect, dstRect); break;
+            case Op::CopyEx:
+                SDL_RenderCopyEx(renderer, command.texture, srcRect, dstRect, command.angle,
+                                 command.hasCenter ? &command.center : nullptr, command.flip);
+                break;
+            case Op::TextureColorMod:
+                SDL_SetTextureColorMod(command.texture, command.color.r, command.color.g, command.color.b);
+                break;
+            case Op::TextureAlphaMod: SDL_SetTextureAlphaMod(command.texture, command.color.a); break;
+            case Op::TextureBlendMode: SDL_SetTextureBlendMode(command.texture, command.blend); break;
+            case Op::Text: {
+                SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, list.getSurface(command.index));
+                if (!texture) {
+                    std::cerr << "Failed to create texture from text surface: " << SDL_GetError() << std::endl;
+                    break;
+                }
+                SDL_RenderCopy(renderer, texture, nullptr, &dst);
+                SDL_DestroyTexture(texture);
+                break;
+            }
+            case Op::Panel: replayPanel(list, command, offsets); break;
+        }
+    }
+}
+
+void Renderer::replayPanel(const DrawList& list, const DrawList::Command& command, const ReplayOffsets& offsets) {
+    const DrawList::Panel& panel = list.getPanel(command.index);
+    PanelTexture& cache = panelTextures[panel.id];
+    if (cache.drawn != panel.content) {
+        if (!cache.texture || cache.w != panel.w || cache.h != panel.h) {
+            if (cache.texture) SDL_DestroyTexture(cache.texture);
+            cache = PanelTexture{};
+            cache.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, panel.w, panel.h);
+            if (cache.texture) {
+                cache.w = panel.w;
+                cache.h = panel.h;
+                // Drawing with BLEND onto a transparent target leaves premultiplied colour, so composite it as such
+                SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+                    SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                    SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+                if (SDL_SetTextureBlendMode(cache.texture, premultiplied) != 0) {
+                    SDL_SetTextureBlendMode(cache.texture, SDL_BLENDMODE_BLEND);
+                }
+            }
+        }
+        if (!cache.texture) {
+            // No target texture: draw the content straight to the screen at the panel's position
+            const SDL_Point origin{command.dst.x, command.dst.y};
+            replayCommands(*panel.content, offsets, &origin);
+            return;
+        }
+        SDL_BlendMode previousBlend = SDL_BLENDMODE_BLEND;
+        Uint8 r = 0, g = 0, b = 0, a = 0;
+        SDL_GetRenderDrawBlendMode(renderer, &previousBlend);
+        SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+        SDL_SetRenderTarget(renderer, cache.texture);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        const SDL_Point origin{0, 0};
+        replayCommands(*panel.content, offsets, &origin);
+        SDL_SetRenderTarget(renderer, nullptr);
+        SDL_SetRenderDrawBlendMode(renderer, previousBlend);
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+        cache.drawn = panel.content;
+    }
+    SDL_RenderCopy(renderer, cache.texture, nullptr, &command.dst);
+}
+
 void Renderer::setCamera(int x, int y) {
     cameraX = x;
     cameraY = y;
@@ -0,0 +1,338 @@
+#include "SaveFormat.h"
+#include <array>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// Wire types
+static const int WIRE_VARINT = 0;
+static const int WIRE_FIXED32 = 5;
+static const int WIRE_BYTES = 2;
+
+// Top-level field ids. Never renumber; retire ids instead of reusing them.
+enum SaveField {
+    F_X = 1, F_Y, F_SPAWN_X, F_SPAWN_Y,
+    F_LEVEL, F_EXPERIENCE, F_MAX_HEALTH, F_HEALTH, F_MAX_MANA, F_MANA,
+    F_STRENGTH, F_INTELLIGENCE, F_GOLD,
+    F_MASTER_VOLUME, F_MUSIC_VOLUME, F_SOUND_VOLUME, F_MONSTER_VOLUME, F_PLAYER_MELEE_VOLUME,
+    F_HEALTH_POTIONS, F_MANA_POTIONS, F_UPGRADE_SCROLLS,
+    F_EQUIPMENT = 30, // nested EquipField record, one per non-empty slot
+    F_STACK = 31      // nested StackField record, one per occupied inventory/resource slot
+};
+enum EquipField { E_SLOT = 1, E_NAME, E_PLUS, E_FIRE, E_ICE, E_LIGHTNING, E_POISON, E_RARITY };
+enum StackField { S_BAG = 1, S_SLOT, S_KEY, S_COUNT, S_RARITY, S_PLUS_LEVEL }; // bag 2 = resources
+
+static const char MAGIC[4] = {'P', 'X', 'L', 'S'};
+static const size_t HEADER_SIZE = 16;
+
+namespace {
+
+class Writer {
+public:
+    std::string out;
+
+    void varint(uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+    void u16(uint16_t v) { out.push_back(static_cast<char>(v & 0xFF)); out.push_back(static_cast<char>(v >> 8)); }
+    void u32(uint32_t v) { for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF)); }
+    void key(int field, int wire) { varint(static_cast<uint64_t>(field) << 3 | static_cast<uint64_t>(wire)); }
+    void sint(int field, int v) {
+        key(field, WIRE_VARINT);
+        varint((static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31)); // zigzag
+    }
+    void f32(int field, float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        key(field, WIRE_FIXED32);
+        u32(bits);
+    }
+    void bytes(int field, const std::string& data) {
+        key(field, WIRE_BYTES);
+        varint(data.size());
+        out += data;
+    }
+};
+
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : p(data), end(data + size) {}
+
+    bool atEnd() const { return p >= end; }
+    bool ok() const { return good; }
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= end) { good = false; return 0; }
+            uint8_t b = *p++;
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        good = false;
+        return 0;
+    }
+    uint32_t u32() {
+        if (end - p < 4) { good = false; p = end; return 0; }
+        uint32_t v = static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+                     static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+        p += 4;
+        return v;
+    }
+    int sint() {
+        uint32_t v = static_cast<uint32_t>(varint());
+        return static_cast<int>((v >> 1) ^ (~(v & 1) + 1)); // un-zigzag
+    }
+    float f32() {
+        uint32_t bits = u32();
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    Reader bytes() {
+        uint64_t size = varint();
+        if (size > static_cast<uint64_t>(end - p)) { good = false; p = end; return Reader(end, 0); }
+        Reader sub(p, static_cast<size_t>(size));
+        p += size;
+        return sub;
+    }
+    std::string string() {
+        Reader sub = bytes();
+        return std::string(reinterpret_cast<const char*>(sub.p), static_cast<size_t>(sub.end - sub.p));
+    }
+    // Consume a field whose id this build doesn't know
+    void skip(int wire) {
+        switch (wire) {
+            case WIRE_VARINT: varint(); break;
+            case WIRE_FIXED32: u32(); break;
+            case WIRE_BYTES: bytes(); break;
+            default: good = false; p = end; break;
+        }
+    }
+
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+    bool good = true;
+};
+
+// Interns strings in first-use order; index 0 is always the empty string
+class StringTable {
+public:
+    StringTable() { intern(std::string()); }
+    uint32_t intern(const std::string& s) {
+        auto it = indices.find(s);
+        if (it != indices.end()) return it->second;
+        uint32_t index = static_cast<uint32_t>(strings.size());
+        indices.emplace(s, index);
+        strings.push_back(s);
+        return index;
+    }
+    std::vector<std::string> strings;
+
+private:
+    std::unordered_map<std::string, uint32_t> indices;
+};
+
+} // namespace
+
+uint32_t SaveFormat::crc32(const uint8_t* data, size_t size) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+bool SaveFormat::isBinary(const std::string& data) {
+    return data.size() >= HEADER_SIZE && std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+std::string SaveFormat::encode(const PlayerSave& save) {
+    StringTable strings;
+    Writer fields;
+    
+    fields.f32(F_X, save.x);
+    fields.f32(F_Y, save.y);
+    fields.f32(F_SPAWN_X, save.spawnX);
+    fields.f32(F_SPAWN_Y, save.spawnY);
+    fields.sint(F_LEVEL, save.level);
+    fields.sint(F_EXPERIENCE, save.experience);
+    fields.sint(F_MAX_HEALTH, save.maxHealth);
+    fields.sint(F_HEALTH, save.health);
+    fields.sint(F_MAX_MANA, save.maxMana);
+    fields.sint(F_MANA, save.mana);
+    fields.sint(F_STRENGTH, save.strength);
+    fields.sint(F_INTELLIGENCE, save.intelligence);
+    fields.sint(F_GOLD, save.gold);
+    fields.sint(F_MASTER_VOLUME, save.masterVolume);
+    fields.sint(F_MUSIC_VOLUME, save.musicVolume);
+    fields.sint(F_SOUND_VOLUME, save.soundVolume);
+    fields.sint(F_MONSTER_VOLUME, save.monsterVolume);
+    fields.sint(F_PLAYER_MELEE_VOLUME, save.playerMeleeVolume);
+    fields.sint(F_HEALTH_POTIONS, save.healthPotionCharges);
+    fields.sint(F_MANA_POTIONS, save.manaPotionCharges);
+    fields.sint(F_UPGRADE_SCROLLS, save.upgradeScrolls);
+    
+    for (int i = 0; i < 9; ++i) {
+        if (save.equipNames[i].empty() && save.equipPlus[i] == 0 && save.equipFire[i] == 0 && save.equipIce[i] == 0 &&
+            save.equipLightning[i] == 0 && save.equipPoison[i] == 0 && save.equipRarity[i] == 0) continue;
+        Writer rec;
+        rec.sint(E_SLOT, i);
+        rec.sint(E_NAME, static_cast<int>(strings.intern(save.equipNames[i])));
+        rec.sint(E_PLUS, save.equipPlus[i]);
+        rec.sint(E_FIRE, save.equipFire[i]);
+        rec.sint(E_ICE, save.equipIce[i]);
+        rec.sint(E_LIGHTNING, save.equipLightning[i]);
+        rec.sint(E_POISON, save.equipPoison[i]);
+        rec.sint(E_RARITY, save.equipRarity[i]);
+        fields.bytes(F_EQUIPMENT, rec.out);
+    }
+    
+    auto writeStack = [&](int bag, int slot, const std::string& key, int count, int rarity, int plusLevel) {
+        if (key.empty()) return;
+        Writer rec;
+        rec.sint(S_BAG, bag);
+        rec.sint(S_SLOT, slot);
+        rec.sint(S_KEY, static_cast<int>(strings.intern(key)));
+        rec.sint(S_COUNT, count);
+        rec.sint(S_RARITY, rarity);
+        rec.sint(S_PLUS_LEVEL, plusLevel);
+        fields.bytes(F_STACK, rec.out);
+    };
+    for (int bag = 0; bag < 2; ++bag) {
+        for (int slot = 0; slot < 9; ++slot) {
+            writeStack(bag, slot, save.invKey[bag][slot], save.invCnt[bag][slot], save.invRarity[bag][slot], save.invPlusLevel[bag][slot]);
+        }
+    }
+    for (int slot = 0; slot < 9; ++slot) {
+        writeStack(2, slot, save.resourceKey[slot], save.resourceCnt[slot], save.resourceRarity[slot], save.resourcePlusLevel[slot]);
+    }
+    
+    Writer payload;
+    payload.varint(strings.strings.size() - 1); // the implicit empty string is not stored
+    for (size_t i = 1; i < strings.strings.size(); ++i) {
+        payload.varint(strings.strings[i].size());
+        payload.out += strings.strings[i];
+    }
+    payload.out += fields.out;
+    
+    Writer file;
+    file.out.reserve(HEADER_SIZE + payload.out.size());
+    file.out.append(MAGIC, sizeof(MAGIC));
+    file.u16(VERSION);
+    file.u16(0);
+    file.u32(static_cast<uint32_t>(payload.out.size()));
+    file.u32(crc32(reinterpret_cast<const uint8_t*>(payload.out.data()), payload.out.size()));
+    file.out += payload.out;
+    return file.out;
+}
+
+std::optional<PlayerSave> SaveFormat::decode(const std::string& data, std::string* outError) {
+    if (!isBinary(data)) {
+        if (outError) *outError = "Not a binary save";
+        return std::nullopt;
+    }
+    
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    Reader header(bytes + sizeof(MAGIC), HEADER_SIZE - sizeof(MAGIC));
+    uint32_t versionWord = header.u32();
+    uint32_t payloadSize = header.u32();
+    uint32_t checksum = header.u32();
+    uint16_t version = static_cast<uint16_t>(versionWord & 0xFFFF);
+    if (version == 0) {
+        if (outError) *outError = "Unsupported save version";
+        return std::nullopt;
+    }
+    if (payloadSize != data.size() - HEADER_SIZE) {
+        if (outError) *outError = "Truncated save file";
+        return std::nullopt;
+    }
+    if (crc32(bytes + HEADER_SIZE, payloadSize) != checksum) {
+        if (outError) *outError = "Save checksum mismatch";
+        return std::nullopt;
+    }
+    
+    Reader in(bytes + HEADER_SIZE, payloadSize);
+    std::vector<std::string> strings(1);
+    uint64_t stringCount = in.varint();
+    for (uint64_t i = 0; i < stringCount && in.ok(); ++i) {
+        strings.push_back(in.string());
+    }
+    auto lookup = [&strings](int index) -> const std::string& {
+        return (index >= 0 && static_cast<size_t>(index) < strings.size()) ? strings[index] : strings[0];
+    };
+    
+    PlayerSave save;
+    while (in.ok() && !in.atEnd()) {
+        uint64_t key = in.varint();
+        int field = static_cast<int>(key >> 3);
+        int wire = static_cast<int>(key & 7);
+        
+        if (wire == WIRE_FIXED32 && field >= F_X && field <= F_SPAWN_Y) {
+            float* targets[] = {&save.x, &save.y, &save.spawnX, &save.spawnY};
+            *targets[field - F_X] = in.f32();
+        } else if (wire == WIRE_VARINT && field >= F_LEVEL && field <= F_UPGRADE_SCROLLS) {
+            int* targets[] = {&save.level, &save.experience, &save.maxHealth, &save.health, &save.maxMana, &save.mana,
+                              &save.strength, &save.intelligence, &save.gold, &save.masterVolume, &save.musicVolume,
+                              &save.soundVolume, &save.monsterVolume, &save.playerMeleeVolume, &save.healthPotionCharges,
+                              &save.manaPotionCharges, &save.upgradeScrolls};
+            *targets[field - F_LEVEL] = in.sint();
+        } else if (wire == WIRE_BYTES && (field == F_EQUIPMENT || field == F_STACK)) {
+            Reader rec = in.bytes();
+            int values[9] = {};
+            while (rec.ok() && !rec.atEnd()) {
+                uint64_t recKey = rec.varint();
+                int recField = static_cast<int>(recKey >> 3);
+                int recWire = static_cast<int>(recKey & 7);
+                if (recWire == WIRE_VARINT && recField > 0 && recField < 9) values[recField] = rec.sint();
+                else rec.skip(recWire);
+            }
+            if (field == F_EQUIPMENT) {
+                int slot = values[E_SLOT];
+                if (slot < 0 || slot >= 9) continue;
+                save.equipNames[slot] = lookup(values[E_NAME]);
+                save.equipPlus[slot] = values[E_PLUS];
+                save.equipFire[slot] = values[E_FIRE];
+                save.equipIce[slot] = values[E_ICE];
+                save.equipLightning[slot] = values[E_LIGHTNING];
+                save.equipPoison[slot] = values[E_POISON];
+                save.equipRarity[slot] = values[E_RARITY];
+            } else {
+                int bag = values[S_BAG];
+                int slot = values[S_SLOT];
+                if (slot < 0 || slot >= 9) continue;
+                if (bag == 0 || bag == 1) {
+                    save.invKey[bag][slot] = lookup(values[S_KEY]);
+                    save.invCnt[bag][slot] = values[S_COUNT];
+                    save.invRarity[bag][slot] = values[S_RARITY];
+                    save.invPlusLevel[bag][slot] = values[S_PLUS_LEVEL];
+                } else if (bag == 2) {
+                    save.resourceKey[slot] = lookup(values[S_KEY]);
+                    save.resourceCnt[slot] = values[S_COUNT];
+                    save.resourceRarity[slot] = values[S_RARITY];
+                    save.resourcePlusLevel[slot] = values[S_PLUS_LEVEL];
+                }
+            }
+        } else {
+            in.skip(wire);
+        }
+    }
+    
+    if (!in.ok()) {
+        if (outError) *outError = "Malformed save payload";
+        return std::nullopt;
+    }
+    return save;
+}
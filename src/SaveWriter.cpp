@@ -0,0 +1,71 @@
+#include "SaveWriter.h"
+#include <chrono>
+#include <iostream>
+
+SaveWriter::SaveWriter(DatabaseSQLite& database) : database(database) {
+    worker = std::thread(&SaveWriter::run, this);
+}
+
+SaveWriter::~SaveWriter() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void SaveWriter::enqueue(int userId, PlayerSave snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending[userId] = std::move(snapshot);
+        ++enqueuedSeq;
+    }
+    wake.notify_one();
+}
+
+void SaveWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    unsigned long long target = enqueuedSeq;
+    if (writtenSeq >= target) return;
+    ++flushWaiters;
+    wake.notify_one();
+    drained.wait(lock, [&] { return writtenSeq >= target; });
+    --flushWaiters;
+}
+
+void SaveWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [&] { return stopping || !pending.empty(); });
+        if (pending.empty()) break; // stopping with nothing left to write
+        
+        // Give a burst of requests a moment to coalesce unless someone is waiting on the result
+        if (!stopping && flushWaiters == 0) {
+            wake.wait_for(lock, std::chrono::milliseconds(COALESCE_MS), [&] { return stopping || flushWaiters > 0; });
+        }
+        
+        std::unordered_map<int, PlayerSave> batch;
+        batch.swap(pending);
+        unsigned long long batchSeq = enqueuedSeq;
+        lock.unlock();
+        
+        for (const auto& entry : batch) {
+            try {
+                std::string error;
+                if (!database.savePlayerState(entry.first, entry.second, &error)) {
+                    std::cout << "Error saving player state: " << error << std::endl;
+                }
+            } catch (const std::exception& e) {
+                std::cout << "Exception during save: " << e.what() << std::endl;
+            } catch (...) {
+                std::cout << "Unknown exception during save" << std::endl;
+            }
+        }
+        
+        lock.lock();
+        writtenSeq = batchSeq;
+        drained.notify_all();
+    }
+}
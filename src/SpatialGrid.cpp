@@ -0,0 +1,49 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellSize) : cellSize(cellSize > 1.0f ? cellSize : 1.0f) {}
+
+int SpatialGrid::cellOf(float v) const {
+    return static_cast<int>(std::floor(v / cellSize));
+}
+
+void SpatialGrid::clear() {
+    entries.clear();
+}
+
+void SpatialGrid::insert(int id, float x, float y) {
+    entries.push_back({cellOf(y), cellOf(x), id, x, y});
+}
+
+void SpatialGrid::build() {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.cellY != b.cellY ? a.cellY < b.cellY : a.cellX < b.cellX;
+    });
+}
+
+void SpatialGrid::queryRadius(float x, float y, float radius, std::vector<int>& out) const {
+    if (entries.empty() || radius < 0.0f) return;
+
+    const int minX = cellOf(x - radius);
+    const int maxX = cellOf(x + radius);
+    const int minY = cellOf(y - radius);
+    const int maxY = cellOf(y + radius);
+    const float radiusSq = radius * radius;
+
+    auto cellLess = [](const Entry& e, const std::pair<int, int>& cell) {
+        return e.cellY != cell.first ? e.cellY < cell.first : e.cellX < cell.second;
+    };
+
+    for (int cy = minY; cy <= maxY; cy++) {
+        // Each row of cells is one contiguous run of the sorted entries
+        auto it = std::lower_bound(entries.begin(), entries.end(), std::make_pair(cy, minX), cellLess);
+        for (; it != entries.end() && it->cellY == cy && it->cellX <= maxX; ++it) {
+            float dx = it->x - x;
+            float dy = it->y - y;
+            if (dx * dx + dy * dy <= radiusSq) {
+                out.push_back(it->id);
+            }
+        }
+    }
+}
@@ -6,16 +6,69 @@
 #include "InputManager.h"
 #include "ItemSystem.h"
 #include "AssetManager.h"
+#include "World.h"
+#include "StatusEffects.h"
 #include <cmath>
 #include <algorithm>
 #include <iostream>
 
 SpellSystem::SpellSystem(Game* game, Player* player) 
     : game(game), player(player), assetManager(game->getAssetManager()),
-      activeElement(SpellElement::NONE), currentEnchantLevel(0), isChanneling(false), 
+      activeElement(SpellElement::NONE), currentEnchantLevel(0), particles(game->getAssetManager()), isChanneling(false), 
       channelTimer(0.0f), channelDuration(0.0f), channelTargetX(0.0f), channelTargetY(0.0f) {
     initializeSpellDatabase();
     initializePassives();
+    initializeSpellVisuals();
+}
+
+namespace {
+struct SpellVisualDef {
+    SpellType type;
+    float scale;
+    const char* paths[SpellVisual::MAX_VARIANTS];
+};
+
+// Spell types without an entry (ice and poison for now) render as coloured rectangles
+const SpellVisualDef SPELL_VISUAL_DEFS[] = {
+    {SpellType::FIRE_BOLT, 0.6f, {"assets/Textures/Spells/firebolt.png"}},             // Smaller for fast projectiles
+    {SpellType::FLAME_WAVE, 0.5f, {"assets/Textures/Spells/flame_wave_new.png"}},
+    {SpellType::METEOR_STRIKE, 1.5f, {"assets/Textures/Spells/meteor shower-red.png"}}, // Large for meteors
+    {SpellType::DRAGONS_BREATH, 1.0f, {"assets/Textures/Spells/dragon_breath.png"}},
+    {SpellType::EXPLOSION_EFFECT, 1.2f, {"assets/Textures/Spells/explosion.png",
+                                         "assets/Textures/Spells/explosion_02.png",
+                                         "assets/Textures/Spells/explosion_03.png"}},
+    {SpellType::PARTICLE_EFFECT, 0.8f, {"assets/Textures/Spells/fire_partical.png"}},
+    {SpellType::SMOKE_EFFECT, 1.0f, {"assets/Textures/Spells/smoke cloud.png"}},
+};
+
+// Status effects applied by spell hits and passives
+constexpr float ICE_SHARD_SLOW = 0.5f;           // speed multiplier
+constexpr float ICE_SHARD_SLOW_SECONDS = 2.0f;
+constexpr float ICE_FIELD_SLOW = 0.6f;           // Frozen Ground / Blizzard, refreshed while inside
+constexpr float ICE_FIELD_SLOW_SECONDS = 0.5f;
+constexpr float PERMAFROST_FREEZE_SECONDS = 1.5f;
+constexpr float POISON_SECONDS = 4.0f;
+constexpr float POISON_SPREAD_RADIUS = 150.0f;
+constexpr int BURNING_STRIKE_DAMAGE_PER_SECOND = 8;
+}
+
+void SpellSystem::initializeSpellVisuals() {
+    // Sheets are preloaded by AssetManager::preloadAssets; a missing one leaves that variant out
+    for (const SpellVisualDef& def : SPELL_VISUAL_DEFS) {
+        SpellVisual& visual = spellVisuals[static_cast<int>(def.type)];
+        visual.scale = def.scale;
+        for (const char* path : def.paths) {
+            if (!path) break;
+            SpriteSheet* sheet = assetManager ? assetManager->getSpriteSheet(path) : nullptr;
+            if (!sheet || sheet->getTotalFrames() <= 0) {
+                std::cout << "Warning: Sprite sheet not found for path: " << path << std::endl;
+                continue;
+            }
+            visual.sheets[visual.variantCount] = sheet;
+            visual.particleSprites[visual.variantCount] = particles.resolveSprite(path, def.scale);
+            visual.variantCount++;
+        }
+    }
 }
 
 void SpellSystem::initializeSpellDatabase() {
@@ -121,6 +174,9 @@ void SpellSystem::update(float deltaTime) {
     updateActiveSpellTree();
     updateCooldowns(deltaTime);
     updatePassives();
+    if (StatusEffectSystem* effects = statusEffects()) {
+        effects->setPoisonSpread(canPoisonSpread() ? getPoisonSpreadChance() : 0.0f, POISON_SPREAD_RADIUS);
+    }
     updateActiveSpells(deltaTime);
     
     if (isChanneling) {
@@ -157,24 +213,12 @@ void SpellSystem::update(float deltaTime) {
                     float spawnX = playerCenterX + cos(angleRad + M_PI/2) * sideOffset;
                     float spawnY = playerCenterY + sin(angleRad + M_PI/2) * sideOffset;
                     
-                    ActiveSpell flame;
-                    flame.type = SpellType::DRAGONS_BREATH;
-                    flame.x = spawnX;
-                    flame.y = spawnY;
-                    flame.velocityX = cos(angleRad + spread) * 300.0f;
-                    flame.velocityY = sin(angleRad + spread) * 300.0f;
-                    flame.lifetime = 0.0f;
-                    flame.maxLifetime = 0.8f;
-                    flame.damage = spellDatabase[SpellType::DRAGONS_BREATH].damage;
-                    flame.active = true;
-                    flame.radius = 20.0f;
-                    
-                    // Animation setup
-                    flame.currentFrame = 0;
-                    flame.animationTimer = 0.0f;
-                    flame.animationSpeed = 20.0f; // 20 FPS for breath
-                    
-                    activeSpells.push_back(flame);
+                    // Flames are pooled particles with a damage component; they burst when they burn out
+                    particles.spawn(getSpellVisual(SpellType::DRAGONS_BREATH).particleSprites[0], spawnX, spawnY,
+                                    cos(angleRad + spread) * 300.0f, sin(angleRad + spread) * 300.0f,
+                                    0.8f, 20.0f, 20.0f, // lifetime, 20 FPS animation, radius
+                                    spellDatabase[SpellType::DRAGONS_BREATH].damage,
+                                    ParticleSystem::FLAG_DAMAGE | ParticleSystem::FLAG_BURST_ON_EXPIRE);
                 }
             }
         }
@@ -242,11 +286,10 @@ void SpellSystem::updatePassives() {
 }
 
 void SpellSystem::updateActiveSpells(float deltaTime) {
-    auto& enemies = game->getEnemies();
+    auto& enemies = targetEnemies();
     
-    for (auto it = activeSpells.begin(); it != activeSpells.end();) {
+    for (auto it = activeSpells.begin(); it != activeSpells.end(); ++it) {
         if (!it->active) {
-            it = activeSpells.erase(it);
             continue;
         }
         
@@ -262,8 +305,7 @@ void SpellSystem::updateActiveSpells(float deltaTime) {
         // Update position for projectiles and effects
         if (it->type == SpellType::FIRE_BOLT || it->type == SpellType::ICE_SHARD || 
             it->type == SpellType::TOXIC_DART || it->type == SpellType::DRAGONS_BREATH ||
-            it->type == SpellType::FLAME_WAVE || it->type == SpellType::METEOR_STRIKE ||
-            it->type == SpellType::SMOKE_EFFECT) {
+            it->type == SpellType::FLAME_WAVE || it->type == SpellType::METEOR_STRIKE) {
             it->x += it->velocityX * deltaTime;
             it->y += it->velocityY * deltaTime;
         }
@@ -308,11 +350,11 @@ void SpellSystem::updateActiveSpells(float deltaTime) {
                     } else if (it->type == SpellType::ICE_SHARD || it->type == SpellType::FROZEN_GROUND || 
                                it->type == SpellType::BLIZZARD) {
                         enemy->takeDamage(it->damage);
-                        // TODO: Apply slow effect
+                        applyHitEffects(*it, enemy.get());
                     } else if (it->type == SpellType::TOXIC_DART || it->type == SpellType::POISON_CLOUD || 
                                it->type == SpellType::PLAGUE_BOMB) {
                         enemy->takeDamage(it->damage);
-                        // TODO: Apply poison DoT
+                        applyHitEffects(*it, enemy.get());
                     }
                     
                     // Projectiles disappear on hit with explosion effects
@@ -347,13 +389,48 @@ void SpellSystem::updateActiveSpells(float deltaTime) {
             it->y < -500 || it->y > game->getWorldHeight() + 500) {
             it->active = false;
         }
-        
-        if (it->active) {
-            ++it;
-        } else {
-            it = activeSpells.erase(it);
+    }
+    
+    // Compact once per frame instead of erasing from the middle
+    activeSpells.erase(std::remove_if(activeSpells.begin(), activeSpells.end(),
+                                      [](const ActiveSpell& spell) { return !spell.active; }),
+                       activeSpells.end());
+    
+    updateEffects(deltaTime);
+}
+
+void SpellSystem::updateEffects(float deltaTime) {
+    particles.update(deltaTime, game->getWorldWidth(), game->getWorldHeight());
+    
+    // Only particles with a damage component (breath flames) take part in enemy collision
+    auto& enemies = targetEnemies();
+    for (int i : particles.getDamagingIndices()) {
+        float r = particles.getRadius(i);
+        SDL_Rect flameRect = {
+            static_cast<int>(particles.getX(i) - r),
+            static_cast<int>(particles.getY(i) - r),
+            static_cast<int>(r * 2),
+            static_cast<int>(r * 2)
+        };
+        for (auto& enemy : enemies) {
+            if (!enemy || enemy->isDead()) {
+                continue;
+            }
+            SDL_Rect enemyRect = {
+                static_cast<int>(enemy->getX()),
+                static_cast<int>(enemy->getY()),
+                static_cast<int>(enemy->getWidth()),
+                static_cast<int>(enemy->getHeight())
+            };
+            if (SDL_HasIntersection(&enemyRect, &flameRect)) {
+                enemy->takeDamage(particles.getDamage(i)); // Fire damage
+            }
         }
     }
+    
+    for (const SDL_FPoint& burst : particles.getExpiredBursts()) {
+        createExplosionEffect(burst.x, burst.y);
+    }
 }
 
 void SpellSystem::render(Renderer* renderer) {
@@ -364,118 +441,34 @@ void SpellSystem::renderActiveSpells(Renderer* renderer) {
     for (const auto& spell : activeSpells) {
         renderSpellEffects(renderer, spell);
     }
+    if (renderer) {
+        particles.render(renderer);
+    }
 }
 
 void SpellSystem::renderSpellEffects(Renderer* renderer, const ActiveSpell& spell) {
-    if (!renderer) {
-        std::cout << "Error: Renderer is null in renderSpellEffects" << std::endl;
-        return;
-    }
-    
-    if (!assetManager) {
-        std::cout << "Warning: AssetManager is null in renderSpellEffects" << std::endl;
-        renderSpellFallback(renderer, spell);
+    if (!renderer || !spell.active) {
         return;
     }
     
-    if (!spell.active) {
-        return; // Don't render inactive spells
-    }
-    
-    SpriteSheet* spriteSheet = nullptr;
-    std::string spellPath;
-    
-    // Map spell types to their animation sprite sheets
-    switch (spell.type) {
-        case SpellType::FIRE_BOLT:
-            spellPath = "assets/Textures/Spells/firebolt.png";
-            break;
-        case SpellType::FLAME_WAVE:
-            spellPath = "assets/Textures/Spells/flame_wave_new.png";
-            break;
-        case SpellType::METEOR_STRIKE:
-            spellPath = "assets/Textures/Spells/meteor shower-red.png";
-            break;
-        case SpellType::DRAGONS_BREATH:
-            spellPath = "assets/Textures/Spells/dragon_breath.png";
-            break;
-        case SpellType::EXPLOSION_EFFECT:
-            // Use the dynamically chosen explosion sprite path
-            spellPath = spell.spritePath.empty() ? "assets/Textures/Spells/explosion.png" : spell.spritePath;
-            break;
-        case SpellType::PARTICLE_EFFECT:
-            spellPath = "assets/Textures/Spells/fire_partical.png";
-            break;
-        case SpellType::SMOKE_EFFECT:
-            spellPath = "assets/Textures/Spells/smoke cloud.png";
-            break;
-        case SpellType::ICE_SHARD:
-        case SpellType::FROZEN_GROUND:
-        case SpellType::BLIZZARD:
-        case SpellType::ABSOLUTE_ZERO:
-        case SpellType::TOXIC_DART:
-        case SpellType::POISON_CLOUD:
-        case SpellType::PLAGUE_BOMB:
-        case SpellType::DEATHS_EMBRACE:
-            // Fall back to colored rectangles for non-fire spells for now
-            renderSpellFallback(renderer, spell);
-            return;
-        default:
-            return;
-    }
-    
-    spriteSheet = assetManager->getSpriteSheet(spellPath);
-    if (!spriteSheet) {
-        // Fall back to colored rectangle if sprite not found
-        std::cout << "Warning: Sprite sheet not found for path: " << spellPath << std::endl;
+    // Types without resolved sheets (ice/poison, or missing assets) use coloured rectangles
+    const SpellVisual& visual = getSpellVisual(spell.type);
+    if (visual.variantCount == 0) {
         renderSpellFallback(renderer, spell);
         return;
     }
+    SpriteSheet* spriteSheet = visual.sheets[spell.spriteVariant < visual.variantCount ? spell.spriteVariant : 0];
     
-    // Calculate current frame (with wraparound and safety checks)
+    // Calculate current frame (with wraparound)
     int totalFrames = spriteSheet->getTotalFrames();
-    if (totalFrames <= 0) {
-        std::cout << "Warning: Invalid total frames for sprite: " << spellPath << std::endl;
-        renderSpellFallback(renderer, spell);
-        return;
-    }
     int frameIndex = (spell.currentFrame >= 0) ? (spell.currentFrame % totalFrames) : 0;
     
     // Get the frame rectangle from the sprite sheet
     SDL_Rect srcRect = spriteSheet->getFrameRect(frameIndex);
     
-    // Calculate destination rectangle (centered on spell position)
-    int spriteWidth = srcRect.w;
-    int spriteHeight = srcRect.h;
-    
-    // Scale based on spell type
-    float scale = 1.0f;
-    switch (spell.type) {
-        case SpellType::FIRE_BOLT:
-            scale = 0.6f; // Smaller for fast projectiles
-            break;
-        case SpellType::FLAME_WAVE:
-            scale = 0.5f; // Reduced by half as requested
-            break;
-        case SpellType::METEOR_STRIKE:
-            scale = 1.5f; // Large for meteors
-            break;
-        case SpellType::DRAGONS_BREATH:
-            scale = 1.0f; // Normal size for breath
-            break;
-        case SpellType::EXPLOSION_EFFECT:
-            scale = 1.2f; // Slightly larger explosions
-            break;
-        case SpellType::PARTICLE_EFFECT:
-            scale = 0.8f; // Smaller particles
-            break;
-        case SpellType::SMOKE_EFFECT:
-            scale = 1.0f; // Normal smoke size
-            break;
-    }
-    
-    spriteWidth = static_cast<int>(spriteWidth * scale);
-    spriteHeight = static_cast<int>(spriteHeight * scale);
+    // Destination rectangle centered on the spell position, scaled per type
+    int spriteWidth = static_cast<int>(srcRect.w * visual.scale);
+    int spriteHeight = static_cast<int>(srcRect.h * visual.scale);
     
     SDL_Rect destRect = {
         static_cast<int>(spell.x - spriteWidth/2),
@@ -485,11 +478,11 @@ void SpellSystem::renderSpellEffects(Renderer* renderer, const ActiveSpell& spel
     };
     
     // Render the animated sprite
-    SDL_RenderCopy(renderer->getSDLRenderer(), spriteSheet->getTexture()->getTexture(), &srcRect, &destRect);
+    renderer->copy(spriteSheet->getTexture()->getTexture(), &srcRect, &destRect);
 }
 
 void SpellSystem::renderSpellFallback(Renderer* renderer, const ActiveSpell& spell) {
-    if (!renderer || !renderer->getSDLRenderer()) {
+    if (!renderer) {
         return; // Can't render without valid renderer
     }
     
@@ -520,8 +513,8 @@ void SpellSystem::renderSpellFallback(Renderer* renderer, const ActiveSpell& spe
         static_cast<int>(spell.radius * 2),
         static_cast<int>(spell.radius * 2)
     };
-    SDL_SetRenderDrawColor(renderer->getSDLRenderer(), color.r, color.g, color.b, color.a);
-    SDL_RenderFillRect(renderer->getSDLRenderer(), &rect);
+    renderer->setDrawColor(color.r, color.g, color.b, color.a);
+    renderer->fillRect(&rect);
 }
 
 void SpellSystem::castSpell(int spellSlot) {
@@ -543,8 +536,8 @@ void SpellSystem::castSpell(int spellSlot) {
         }
         
         // Get mouse position for targeted spells
-        int mouseX, mouseY;
-        SDL_GetMouseState(&mouseX, &mouseY);
+        int mouseX = game->getInputManager()->getMouseX();
+        int mouseY = game->getInputManager()->getMouseY();
         float worldX = mouseX + game->getCameraX();
         float worldY = mouseY + game->getCameraY();
         std::cout << "DEBUG: Target position: " << worldX << ", " << worldY << std::endl;
@@ -652,15 +645,14 @@ void SpellSystem::castFireBolt(float targetX, float targetY) {
     spell.currentFrame = 0;
     spell.animationTimer = 0.0f;
     spell.animationSpeed = 15.0f; // Faster animation for projectile
-    spell.spritePath = ""; // Use default path
     
     activeSpells.push_back(spell);
 }
 
 void SpellSystem::castFlameWave() {
     // Get mouse position for direction
-    int mouseX, mouseY;
-    SDL_GetMouseState(&mouseX, &mouseY);
+    int mouseX = game->getInputManager()->getMouseX();
+    int mouseY = game->getInputManager()->getMouseY();
     float worldMouseX = mouseX + game->getCameraX();
     float worldMouseY = mouseY + game->getCameraY();
     
@@ -791,12 +783,12 @@ void SpellSystem::castFrozenGround(float targetX, float targetY) {
 void SpellSystem::castBlizzard(float targetX, float targetY) {
     // Create multiple ice particles over time
     for (int i = 0; i < 20; i++) {
-        float spellX = targetX + (rand() % 100 - 50);
-        float spellY = targetY + (rand() % 100 - 50);
+        float spellX = targetX + rng.nextInt(-50, 49);
+        float spellY = targetY + rng.nextInt(-50, 49);
         
         ActiveSpell spell = createSafeSpell(SpellType::BLIZZARD, spellX, spellY);
-        spell.velocityX = rand() % 100 - 50;
-        spell.velocityY = rand() % 50 + 50;
+        spell.velocityX = rng.nextInt(-50, 49);
+        spell.velocityY = rng.nextInt(50, 99);
         spell.lifetime = -(i * 0.2f); // Stagger spawn
         spell.maxLifetime = 4.0f;
         spell.damage = spellDatabase[SpellType::BLIZZARD].damage;
@@ -807,30 +799,20 @@ void SpellSystem::castBlizzard(float targetX, float targetY) {
 }
 
 void SpellSystem::castAbsoluteZero() {
-    // TODO: Freeze all visible enemies
-    auto& enemies = game->getEnemies();
+    StatusEffectSystem* effects = statusEffects();
+    if (!effects) return;
+    
+    auto& enemies = targetEnemies();
     for (auto& enemy : enemies) {
-        // Enhanced safety checks for absolute zero
-        if (!enemy || enemy.get() == nullptr || enemy->isDead()) {
-            continue; // Skip null or dead enemies
+        if (!enemy || enemy->isDead()) {
+            continue;
         }
         
-        try {
-            // Check if enemy is on screen
-            float screenX = enemy->getX() - game->getCameraX();
-            float screenY = enemy->getY() - game->getCameraY();
-            
-            if (screenX >= -100 && screenX <= 1380 && screenY >= -100 && screenY <= 820) {
-                // Final validity check before applying effect
-                if (enemy && !enemy->isDead()) {
-                    // Apply freeze effect (will need to add freeze state to Enemy class)
-                    enemy->takeDamage(0); // Just mark for now
-                }
-            }
-        } catch (...) {
-            // Catch any exceptions during absolute zero application
-            std::cout << "Error: Exception during absolute zero - enemy may be invalid" << std::endl;
-            continue;
+        // Only enemies on screen are frozen
+        float screenX = enemy->getX() - game->getCameraX();
+        float screenY = enemy->getY() - game->getCameraY();
+        if (screenX >= -100 && screenX <= 1380 && screenY >= -100 && screenY <= 820) {
+            effects->applyFreeze(enemy.get(), spellDatabase[SpellType::ABSOLUTE_ZERO].duration);
         }
     }
 }
@@ -973,11 +955,33 @@ float SpellSystem::getBurnDuration() const {
     return 0.0f;
 }
 
+void SpellSystem::applyBurningStrike(float x, float y) {
+    float burnDuration = getBurnDuration();
+    StatusEffectSystem* effects = statusEffects();
+    if (burnDuration <= 0.0f || !effects) return;
+    
+    // Burn whichever enemy the melee hit landed on
+    SDL_Point hitPoint = {static_cast<int>(x), static_cast<int>(y)};
+    for (auto& enemy : targetEnemies()) {
+        if (!enemy || enemy->isDead()) continue;
+        SDL_Rect rect = enemy->getCollisionRect();
+        if (SDL_PointInRect(&hitPoint, &rect)) {
+            effects->applyBurn(enemy.get(), BURNING_STRIKE_DAMAGE_PER_SECOND, burnDuration);
+            return;
+        }
+    }
+}
+
 float SpellSystem::getAttackSpeedMultiplier() const {
+    if (player->getHealth() < player->getMaxHealth() / 2) {
+        return getLowHealthAttackSpeedMultiplier();
+    }
+    return 1.0f;
+}
+
+float SpellSystem::getLowHealthAttackSpeedMultiplier() const {
     if (activeElement == SpellElement::FIRE && currentEnchantLevel >= 15) {
-        if (player->getHealth() < player->getMaxHealth() / 2) {
-            return 1.2f;
-        }
+        return 1.2f;
     }
     return 1.0f;
 }
@@ -996,6 +1000,22 @@ float SpellSystem::getRegenPerSecond() const {
     return 0.0f;
 }
 
+bool SpellSystem::canFreezeOnHit() const {
+    return activeElement == SpellElement::WATER && currentEnchantLevel >= 25;
+}
+
+float SpellSystem::getFreezeChance() const {
+    return canFreezeOnHit() ? 0.3f : 0.0f;
+}
+
+bool SpellSystem::canPoisonSpread() const {
+    return activeElement == SpellElement::POISON && currentEnchantLevel >= 25;
+}
+
+float SpellSystem::getPoisonSpreadChance() const {
+    return canPoisonSpread() ? 0.5f : 0.0f;
+}
+
 bool SpellSystem::hasInfernoAura() const {
     return activeElement == SpellElement::FIRE && currentEnchantLevel >= 25;
 }
@@ -1017,7 +1037,7 @@ void SpellSystem::applyInfernoAura(float deltaTime) {
     if (auraTick >= 0.5f) { // Damage every 0.5 seconds
         auraTick = 0.0f;
         
-        auto& enemies = game->getEnemies();
+        auto& enemies = targetEnemies();
         float auraRadius = getInfernoAuraRadius();
         float auraDamage = getInfernoAuraDamage();
         
@@ -1095,7 +1115,7 @@ void SpellSystem::renderIndicators(Renderer* renderer, int mouseX, int mouseY) {
     }
     
     // Render range indicator (circle around player center)
-    SDL_SetRenderDrawColor(renderer->getSDLRenderer(), 255, 255, 0, 100); // Yellow with transparency
+    renderer->setDrawColor(255, 255, 0, 100); // Yellow with transparency
     int numPoints = 64;
     int playerScreenX = static_cast<int>(playerCenterX - game->getCameraX());
     int playerScreenY = static_cast<int>(playerCenterY - game->getCameraY());
@@ -1109,11 +1129,11 @@ void SpellSystem::renderIndicators(Renderer* renderer, int mouseX, int mouseY) {
         int x2 = static_cast<int>(playerScreenX + cos(angle2) * spellRange);
         int y2 = static_cast<int>(playerScreenY + sin(angle2) * spellRange);
         
-        SDL_RenderDrawLine(renderer->getSDLRenderer(), x1, y1, x2, y2);
+        renderer->drawLine(x1, y1, x2, y2);
     }
     
     // Render placement indicator at constrained target location
-    SDL_SetRenderDrawColor(renderer->getSDLRenderer(), 0, 255, 0, 150); // Always green since it's constrained to range
+    renderer->setDrawColor(0, 255, 0, 150); // Always green since it's constrained to range
     
     // Draw circle at target location
     float effectRadius = 60.0f; // AoE effect radius
@@ -1129,7 +1149,7 @@ void SpellSystem::renderIndicators(Renderer* renderer, int mouseX, int mouseY) {
         int x2 = static_cast<int>(targetScreenX + cos(angle2) * effectRadius);
         int y2 = static_cast<int>(targetScreenY + sin(angle2) * effectRadius);
         
-        SDL_RenderDrawLine(renderer->getSDLRenderer(), x1, y1, x2, y2);
+        renderer->drawLine(x1, y1, x2, y2);
     }
 }
 
@@ -1138,7 +1158,7 @@ void SpellSystem::renderChannelBar(Renderer* renderer) {
     
     // Get screen dimensions
     int screenW, screenH;
-    SDL_GetRendererOutputSize(renderer->getSDLRenderer(), &screenW, &screenH);
+    renderer->getOutputSize(&screenW, &screenH);
     
     // Position channel bar just above skill bar (skill bar is at screenH - skillBarHeight - 20)
     int barWidth = 200;
@@ -1148,9 +1168,9 @@ void SpellSystem::renderChannelBar(Renderer* renderer) {
     int barY = screenH - skillBarHeight - 40; // Just above skill bar
     
     // Background
-    SDL_SetRenderDrawColor(renderer->getSDLRenderer(), 50, 50, 50, 200);
+    renderer->setDrawColor(50, 50, 50, 200);
     SDL_Rect bgRect = {barX - 2, barY - 2, barWidth + 4, barHeight + 4};
-    SDL_RenderFillRect(renderer->getSDLRenderer(), &bgRect);
+    renderer->fillRect(&bgRect);
     
     // Progress bar
     float progress = getChannelProgress();
@@ -1158,43 +1178,26 @@ void SpellSystem::renderChannelBar(Renderer* renderer) {
     
     // Color based on spell type
     if (channeledSpell == SpellType::METEOR_STRIKE) {
-        SDL_SetRenderDrawColor(renderer->getSDLRenderer(), 255, 100, 0, 255); // Orange for meteor
+        renderer->setDrawColor(255, 100, 0, 255); // Orange for meteor
     } else {
-        SDL_SetRenderDrawColor(renderer->getSDLRenderer(), 255, 0, 0, 255); // Red for other spells
+        renderer->setDrawColor(255, 0, 0, 255); // Red for other spells
     }
     
     SDL_Rect progressRect = {barX, barY, progressWidth, barHeight};
-    SDL_RenderFillRect(renderer->getSDLRenderer(), &progressRect);
+    renderer->fillRect(&progressRect);
     
     // Border
-    SDL_SetRenderDrawColor(renderer->getSDLRenderer(), 255, 255, 255, 255);
+    renderer->setDrawColor(255, 255, 255, 255);
     SDL_Rect borderRect = {barX, barY, barWidth, barHeight};
-    SDL_RenderDrawRect(renderer->getSDLRenderer(), &borderRect);
+    renderer->drawRect(&borderRect);
 }
 
 void SpellSystem::createExplosionEffect(float x, float y) {
-    // Randomly pick one of the explosion types
-    const std::vector<std::string> explosionTypes = {
-        "assets/Textures/Spells/explosion.png",
-        "assets/Textures/Spells/explosion_02.png", 
-        "assets/Textures/Spells/explosion_03.png"
-    };
-    
-    int randomIndex = rand() % explosionTypes.size();
-    std::string explosionPath = explosionTypes[randomIndex];
-    
-    ActiveSpell explosion = createSafeSpell(SpellType::EXPLOSION_EFFECT, x, y);
-    explosion.velocityX = 0;
-    explosion.velocityY = 0;
-    explosion.maxLifetime = 1.0f; // 1 second explosion
-    explosion.damage = 0; // Visual effect only
-    explosion.radius = 25.0f;
-    explosion.spritePath = explosionPath; // Store the chosen explosion sprite
-    
-    // Animation setup
-    explosion.animationSpeed = 16.0f; // Fast explosion animation
-    
-    activeSpells.push_back(explosion);
+    // Randomly pick one of the explosion variants
+    const SpellVisual& visual = getSpellVisual(SpellType::EXPLOSION_EFFECT);
+    ParticleSystem::SpriteHandle explosion = visual.variantCount > 0
+        ? visual.particleSprites[rng.nextInt(0, visual.variantCount - 1)] : ParticleSystem::NO_SPRITE;
+    particles.spawn(explosion, x, y, 0.0f, 0.0f, 1.0f, 16.0f, 25.0f); // 1 second, fast animation
     
     // Also create particle and smoke effects
     createParticleEffect(x, y);
@@ -1202,31 +1205,12 @@ void SpellSystem::createExplosionEffect(float x, float y) {
 }
 
 void SpellSystem::createParticleEffect(float x, float y) {
-    ActiveSpell particles = createSafeSpell(SpellType::PARTICLE_EFFECT, x, y);
-    particles.velocityX = 0;
-    particles.velocityY = 0;
-    particles.maxLifetime = 1.5f;
-    particles.damage = 0;
-    particles.radius = 20.0f;
-    
-    // Animation setup
-    particles.animationSpeed = 12.0f;
-    
-    activeSpells.push_back(particles);
+    particles.spawn(getSpellVisual(SpellType::PARTICLE_EFFECT).particleSprites[0], x, y, 0.0f, 0.0f, 1.5f, 12.0f, 20.0f);
 }
 
 void SpellSystem::createSmokeEffect(float x, float y) {
-    ActiveSpell smoke = createSafeSpell(SpellType::SMOKE_EFFECT, x, y);
-    smoke.velocityX = 0;
-    smoke.velocityY = -20.0f; // Smoke drifts upward
-    smoke.maxLifetime = 2.0f;
-    smoke.damage = 0;
-    smoke.radius = 30.0f;
-    
-    // Animation setup
-    smoke.animationSpeed = 8.0f; // Slower smoke animation
-    
-    activeSpells.push_back(smoke);
+    // Smoke drifts upward with a slower animation
+    particles.spawn(getSpellVisual(SpellType::SMOKE_EFFECT).particleSprites[0], x, y, 0.0f, -20.0f, 2.0f, 8.0f, 30.0f);
 }
 
 // Helper function to safely create spells with all fields initialized
@@ -1252,7 +1236,46 @@ ActiveSpell SpellSystem::createSafeSpell(SpellType type, float x, float y) {
     spell.currentFrame = 0;
     spell.animationTimer = 0.0f;
     spell.animationSpeed = 10.0f;
-    spell.spritePath = ""; // Safe default
+    spell.spriteVariant = 0;
     
     return spell;
-}
\ No newline at end of file
+}
+
+std::vector<std::unique_ptr<Enemy>>& SpellSystem::targetEnemies() {
+    // Enemies are owned by the World; Game's list is only a fallback before a world is loaded
+    World* world = game->getWorld();
+    return world ? world->getEnemies() : game->getEnemies();
+}
+
+StatusEffectSystem* SpellSystem::statusEffects() {
+    World* world = game->getWorld();
+    return world ? &world->getStatusEffects() : nullptr;
+}
+
+void SpellSystem::applyHitEffects(const ActiveSpell& spell, Enemy* enemy) {
+    StatusEffectSystem* effects = statusEffects();
+    if (!effects || !enemy || enemy->isDead()) return;
+    
+    switch (spell.type) {
+        case SpellType::ICE_SHARD: {
+            effects->applySlow(enemy, ICE_SHARD_SLOW, ICE_SHARD_SLOW_SECONDS);
+            // Permafrost rolls once per shard hit rather than every frame inside an ice field
+            if (canFreezeOnHit() && rng.chance(getFreezeChance())) {
+                effects->applyFreeze(enemy, PERMAFROST_FREEZE_SECONDS);
+            }
+            break;
+        }
+        case SpellType::FROZEN_GROUND:
+        case SpellType::BLIZZARD:
+            effects->applySlow(enemy, ICE_FIELD_SLOW, ICE_FIELD_SLOW_SECONDS);
+            break;
+        case SpellType::TOXIC_DART:
+        case SpellType::POISON_CLOUD:
+        case SpellType::PLAGUE_BOMB:
+            // Reapplying only refreshes the running poison, so clouds do not stack it every frame
+            effects->applyPoison(enemy, std::max(1, spell.damage / 2), POISON_SECONDS);
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,265 @@
+#include "StatusEffects.h"
+#include "SpatialGrid.h"
+#include "Enemy.h"
+#include <algorithm>
+#include <cmath>
+
+StatusEffectSystem::StatusEffectSystem() : rng(Random::stream(RngSystem::StatusEffects)) {}
+
+uint32_t StatusEffectSystem::ticksFor(float seconds) const {
+    return static_cast<uint32_t>(std::max(1.0f, std::ceil(seconds / TICK_SECONDS)));
+}
+
+int StatusEffectSystem::findHandle(const Enemy* enemy) const {
+    if (!enemy) return -1;
+    int handle = enemy->getStatusHandle();
+    if (handle < 0 || handle >= static_cast<int>(owners.size()) || owners[handle] != enemy) return -1;
+    return handle;
+}
+
+int StatusEffectSystem::acquireHandle(Enemy* enemy) {
+    int handle = findHandle(enemy);
+    if (handle >= 0) return handle;
+
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        handle = static_cast<int>(owners.size());
+        owners.push_back(nullptr);
+        burn.emplace_back();
+        poison.emplace_back();
+        slow.emplace_back();
+        freeze.emplace_back();
+    }
+    owners[handle] = enemy;
+    enemy->setStatusHandle(handle);
+    return handle;
+}
+
+void StatusEffectSystem::releaseHandle(int handle) {
+    // Bumping generations invalidates any events still queued for this handle
+    burn[handle].active = false;
+    burn[handle].generation++;
+    poison[handle].active = false;
+    poison[handle].generation++;
+    slow[handle].active = false;
+    slow[handle].generation++;
+    freeze[handle].active = false;
+    freeze[handle].generation++;
+    owners[handle] = nullptr;
+    freeHandles.push_back(handle);
+}
+
+void StatusEffectSystem::release(Enemy* enemy) {
+    int handle = findHandle(enemy);
+    if (handle < 0) return;
+    releaseHandle(handle);
+    enemy->setStatusHandle(-1);
+    enemy->setStatusModifiers(1.0f, false);
+}
+
+void StatusEffectSystem::clear() {
+    for (int handle = 0; handle < static_cast<int>(owners.size()); handle++) {
+        if (owners[handle]) release(owners[handle]);
+    }
+    for (auto& bucket : wheel) bucket.clear();
+}
+
+void StatusEffectSystem::schedule(int handle, uint32_t generation, uint32_t dueTick, EffectType effect, EventKind kind) {
+    wheel[dueTick % WHEEL_SIZE].push_back({handle, generation, dueTick, effect, kind});
+}
+
+void StatusEffectSystem::applyDamageOverTime(std::vector<DamageOverTime>& states, EffectType effect, Enemy* enemy,
+                                             int damagePerSecond, float duration) {
+    if (!enemy || enemy->isDead() || damagePerSecond <= 0 || duration <= 0.0f) return;
+    int handle = acquireHandle(enemy);
+    DamageOverTime& state = states[handle];
+
+    int damagePerTick = std::max(1, static_cast<int>(std::lround(damagePerSecond * DOT_INTERVAL_TICKS * TICK_SECONDS)));
+    uint32_t expiresTick = currentTick + ticksFor(duration);
+
+    if (state.active) {
+        // Refresh; the running tick chain picks up the new values
+        state.damagePerTick = std::max(state.damagePerTick, damagePerTick);
+        state.expiresTick = std::max(state.expiresTick, expiresTick);
+        return;
+    }
+    state.active = true;
+    state.generation++;
+    state.damagePerTick = damagePerTick;
+    state.expiresTick = expiresTick;
+    schedule(handle, state.generation, currentTick + DOT_INTERVAL_TICKS, effect, DOT_TICK);
+}
+
+void StatusEffectSystem::applyModifier(std::vector<TimedModifier>& states, EffectType effect, Enemy* enemy,
+                                       float speedMultiplier, float duration) {
+    if (!enemy || enemy->isDead() || duration <= 0.0f) return;
+    int handle = acquireHandle(enemy);
+    TimedModifier& state = states[handle];
+
+    uint32_t expiresTick = currentTick + ticksFor(duration);
+    if (state.active) {
+        // The pending expiry event reschedules itself if the effect was extended
+        state.speedMultiplier = std::min(state.speedMultiplier, speedMultiplier);
+        state.expiresTick = std::max(state.expiresTick, expiresTick);
+    } else {
+        state.active = true;
+        state.generation++;
+        state.speedMultiplier = speedMultiplier;
+        state.expiresTick = expiresTick;
+        schedule(handle, state.generation, expiresTick, effect, EXPIRE);
+    }
+    pushModifiers(handle);
+}
+
+void StatusEffectSystem::applyBurn(Enemy* enemy, int damagePerSecond, float duration) {
+    applyDamageOverTime(burn, BURN, enemy, damagePerSecond, duration);
+}
+
+void StatusEffectSystem::applyPoison(Enemy* enemy, int damagePerSecond, float duration) {
+    applyDamageOverTime(poison, POISON, enemy, damagePerSecond, duration);
+}
+
+void StatusEffectSystem::applySlow(Enemy* enemy, float speedMultiplier, float duration) {
+    applyModifier(slow, SLOW, enemy, std::clamp(speedMultiplier, 0.0f, 1.0f), duration);
+}
+
+void StatusEffectSystem::applyFreeze(Enemy* enemy, float duration) {
+    applyModifier(freeze, FREEZE, enemy, 0.0f, duration);
+}
+
+void StatusEffectSystem::setPoisonSpread(float chance, float radius) {
+    poisonSpreadChance = chance;
+    poisonSpreadRadius = radius;
+}
+
+void StatusEffectSystem::pushModifiers(int handle) {
+    Enemy* enemy = owners[handle];
+    if (!enemy) return;
+    bool frozen = freeze[handle].active;
+    float speed = frozen ? 0.0f : (slow[handle].active ? slow[handle].speedMultiplier : 1.0f);
+    enemy->setStatusModifiers(speed, frozen);
+}
+
+void StatusEffectSystem::update(float deltaTime, const SpatialGrid& spatialGrid,
+                                const std::vector<std::unique_ptr<Enemy>>& worldEnemies) {
+    grid = &spatialGrid;
+    enemies = &worldEnemies;
+
+    tickAccumulator += deltaTime;
+    while (tickAccumulator >= TICK_SECONDS) {
+        tickAccumulator -= TICK_SECONDS;
+        currentTick++;
+        processTick(currentTick);
+    }
+
+    grid = nullptr;
+    enemies = nullptr;
+}
+
+void StatusEffectSystem::processTick(uint32_t tick) {
+    std::vector<Event>& bucket = wheel[tick % WHEEL_SIZE];
+    if (bucket.empty()) return;
+
+    // Events scheduled while processing land in other buckets or a later revolution of this one
+    dueEvents.clear();
+    dueEvents.swap(bucket);
+    for (const Event& event : dueEvents) {
+        if (event.dueTick > tick) {
+            bucket.push_back(event); // due on a later revolution
+        } else {
+            processEvent(event, tick);
+        }
+    }
+}
+
+void StatusEffectSystem::processEvent(const Event& event, uint32_t tick) {
+    const int handle = event.handle;
+    Enemy* enemy = owners[handle];
+    if (!enemy) return;
+
+    if (event.kind == DOT_TICK) {
+        std::vector<DamageOverTime>& states = (event.effect == BURN) ? burn : poison;
+        if (!states[handle].active || states[handle].generation != event.generation) return;
+        if (enemy->isDead()) {
+            release(enemy);
+            return;
+        }
+        enemy->takeDamage(states[handle].damagePerTick);
+        if (event.effect == POISON) {
+            trySpreadPoison(handle, tick); // may grow the per-handle arrays
+        }
+        DamageOverTime& state = states[handle];
+        if (tick + DOT_INTERVAL_TICKS <= state.expiresTick) {
+            schedule(handle, state.generation, tick + DOT_INTERVAL_TICKS, event.effect, DOT_TICK);
+        } else {
+            state.active = false;
+        }
+        return;
+    }
+
+    TimedModifier& state = (event.effect == SLOW) ? slow[handle] : freeze[handle];
+    if (!state.active || state.generation != event.generation) return;
+    if (tick < state.expiresTick) {
+        // Extended since this event was queued
+        schedule(handle, state.generation, state.expiresTick, event.effect, EXPIRE);
+        return;
+    }
+    state.active = false;
+    state.speedMultiplier = 1.0f;
+    pushModifiers(handle);
+}
+
+void StatusEffectSystem::trySpreadPoison(int handle, uint32_t tick) {
+    if (poisonSpreadChance <= 0.0f || poisonSpreadRadius <= 0.0f || !grid || !enemies) return;
+    if (!rng.chance(poisonSpreadChance)) return;
+
+    const Enemy* source = owners[handle];
+    const DamageOverTime& state = poison[handle];
+    float cx = source->getX() + source->getWidth() * 0.5f;
+    float cy = source->getY() + source->getHeight() * 0.5f;
+
+    neighborScratch.clear();
+    grid->queryRadius(cx, cy, poisonSpreadRadius, neighborScratch);
+
+    Enemy* target = nullptr;
+    float bestDistSq = 0.0f;
+    for (int index : neighborScratch) {
+        if (index < 0 || index >= static_cast<int>(enemies->size())) continue;
+        Enemy* other = (*enemies)[index].get();
+        if (!other || other == source || other->isDead() || isPoisoned(other)) continue;
+        float dx = other->getX() + other->getWidth() * 0.5f - cx;
+        float dy = other->getY() + other->getHeight() * 0.5f - cy;
+        float distSq = dx * dx + dy * dy;
+        if (!target || distSq < bestDistSq) {
+            target = other;
+            bestDistSq = distSq;
+        }
+    }
+    if (!target || state.expiresTick <= tick) return;
+
+    // The infection carries the source's strength for its remaining duration
+    int damagePerSecond = static_cast<int>(std::lround(state.damagePerTick / (DOT_INTERVAL_TICKS * TICK_SECONDS)));
+    applyPoison(target, damagePerSecond, (state.expiresTick - tick) * TICK_SECONDS);
+}
+
+bool StatusEffectSystem::isBurning(const Enemy* enemy) const {
+    int handle = findHandle(enemy);
+    return handle >= 0 && burn[handle].active;
+}
+
+bool StatusEffectSystem::isPoisoned(const Enemy* enemy) const {
+    int handle = findHandle(enemy);
+    return handle >= 0 && poison[handle].active;
+}
+
+bool StatusEffectSystem::isSlowed(const Enemy* enemy) const {
+    int handle = findHandle(enemy);
+    return handle >= 0 && slow[handle].active;
+}
+
+bool StatusEffectSystem::isFrozen(const Enemy* enemy) const {
+    int handle = findHandle(enemy);
+    return handle >= 0 && freeze[handle].active;
+}
@@ -0,0 +1,233 @@
+#include "TileCollision.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+static const float EDGE_EPSILON = 1e-3f; // keeps an exclusive max edge out of the next tile
+
+void TileCollision::reset(int newWidth, int newHeight, int newTileSize, bool hasLedgeData) {
+    width = std::max(0, newWidth);
+    height = std::max(0, newHeight);
+    tileSize = newTileSize;
+    ledgeData = hasLedgeData;
+    tileFlags.assign(static_cast<size_t>(width) * height, 0);
+    chunkCols = (width + (1 << CHUNK_SHIFT) - 1) >> CHUNK_SHIFT;
+    chunkRows = (height + (1 << CHUNK_SHIFT) - 1) >> CHUNK_SHIFT;
+    chunkSummary.assign(static_cast<size_t>(chunkCols) * chunkRows, MIXED);
+}
+
+void TileCollision::finalize() {
+    for (int cy = 0; cy < chunkRows; ++cy) {
+        for (int cx = 0; cx < chunkCols; ++cx) summarizeChunk(cx, cy);
+    }
+}
+
+void TileCollision::updateFlags(int x, int y, uint8_t flags) {
+    if (!inBounds(x, y)) return;
+    setFlags(x, y, flags);
+    summarizeChunk(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT);
+}
+
+void TileCollision::summarizeChunk(int cx, int cy) {
+    const int x0 = cx << CHUNK_SHIFT, y0 = cy << CHUNK_SHIFT;
+    const int x1 = std::min(width, x0 + (1 << CHUNK_SHIFT)), y1 = std::min(height, y0 + (1 << CHUNK_SHIFT));
+    const uint8_t first = getFlags(x0, y0);
+    uint8_t summary = first;
+    for (int y = y0; y < y1 && summary != MIXED; ++y) {
+        const uint8_t* row = tileFlags.data() + static_cast<size_t>(y) * width;
+        for (int x = x0; x < x1; ++x) {
+            if (row[x] != first) { summary = MIXED; break; }
+        }
+    }
+    chunkSummary[static_cast<size_t>(cy) * chunkCols + cx] = summary;
+}
+
+int TileCollision::tileOf(float pixel) const {
+    return static_cast<int>(std::floor(pixel / static_cast<float>(tileSize)));
+}
+
+bool TileCollision::canStep(int fromX, int fromY, int toX, int toY, const MoveRules& rules) const {
+    if (getFlags(toX, toY) & rules.blockMask) return false;
+    if (rules.ledges && ledgeData &&
+        (isLedgeBlockedVertical(fromX, fromY, toX, toY) || isLedgeCrossingBlocked(fromX, fromY, toX, toY))) {
+        return false;
+    }
+    return true;
+}
+
+bool TileCollision::isOpen(const TileBox& area, const MoveRules& rules) const {
+    const int tx0 = tileOf(area.minX), ty0 = tileOf(area.minY);
+    const int tx1 = tileOf(area.maxX - EDGE_EPSILON), ty1 = tileOf(area.maxY - EDGE_EPSILON);
+    if (tx0 < 0 || ty0 < 0 || tx1 >= width || ty1 >= height) return false;
+    const uint8_t first = chunkSummary[static_cast<size_t>(ty0 >> CHUNK_SHIFT) * chunkCols + (tx0 >> CHUNK_SHIFT)];
+    for (int cy = ty0 >> CHUNK_SHIFT; cy <= ty1 >> CHUNK_SHIFT; ++cy) {
+        for (int cx = tx0 >> CHUNK_SHIFT; cx <= tx1 >> CHUNK_SHIFT; ++cx) {
+            const uint8_t summary = chunkSummary[static_cast<size_t>(cy) * chunkCols + cx];
+            if (summary == MIXED || (summary & rules.blockMask)) return false;
+            // Ledge rules fire between tiles whose flags differ, and on any step onto an EDGE tile
+            if (rules.ledges && (summary != first || (summary & EDGE))) return false;
+        }
+    }
+    return true;
+}
+
+TileSweepResult TileCollision::sweep(const TileBox& box, float dx, float dy, const MoveRules& rules) const {
+    TileSweepResult result;
+    if (tileFlags.empty() || tileSize <= 0) {
+        result.dx = dx;
+        result.dy = dy;
+        return result;
+    }
+    const TileBox area{std::min(box.minX, box.minX + dx), std::min(box.minY, box.minY + dy),
+                       std::max(box.maxX, box.maxX + dx), std::max(box.maxY, box.maxY + dy)};
+    if (isOpen(area, rules)) {
+        result.dx = dx;
+        result.dy = dy;
+        return result;
+    }
+    result.dx = sweepAxis(box, dx, true, rules, result.blockedX);
+    const TileBox moved{box.minX + result.dx, box.minY, box.maxX + result.dx, box.maxY};
+    result.dy = sweepAxis(moved, dy, false, rules, result.blockedY);
+    return result;
+}
+
+float TileCollision::sweepAxis(const TileBox& box, float delta, bool horizontal, const MoveRules& rules, bool& blocked) const {
+    if (delta == 0.0f) return 0.0f;
+    // Tiles the box spans across the direction of travel
+    const int spanLo = tileOf(horizontal ? box.minY : box.minX);
+    const int spanHi = tileOf((horizontal ? box.maxY : box.maxX) - EDGE_EPSILON);
+    // A box overlapping blocked tiles (spawned or teleported there, or the tile changed under it)
+    // may slide along them while part of it stays on tiles it may enter; it never goes deeper in
+    auto stepAllowed = [&](int from, int to) {
+        bool embedded = false, foothold = false;
+        for (int s = spanLo; s <= spanHi; ++s) {
+            const int fx = horizontal ? from : s, fy = horizontal ? s : from;
+            const int tx = horizontal ? to : s, ty = horizontal ? s : to;
+            if (canStep(fx, fy, tx, ty, rules)) {
+                foothold = true;
+            } else if ((getFlags(fx, fy) & rules.blockMask) && (getFlags(tx, ty) & rules.blockMask)) {
+                embedded = true;
+            } else {
+                return false;
+            }
+        }
+        return !embedded || foothold;
+    };
+
+    if (delta > 0.0f) {
+        const float lead = horizontal ? box.maxX : box.maxY;
+        const int last = tileOf(lead + delta - EDGE_EPSILON);
+        for (int t = tileOf(lead - EDGE_EPSILON) + 1; t <= last; ++t) {
+            if (!stepAllowed(t - 1, t)) {
+                blocked = true;
+                return std::max(0.0f, static_cast<float>(t * tileSize) - lead);
+            }
+        }
+    } else {
+        const float lead = horizontal ? box.minX : box.minY;
+        const int last = tileOf(lead + delta);
+        for (int t = tileOf(lead) - 1; t >= last; --t) {
+            if (!stepAllowed(t + 1, t)) {
+                blocked = true;
+                return std::min(0.0f, static_cast<float>((t + 1) * tileSize) - lead);
+            }
+        }
+    }
+    return delta;
+}
+
+bool TileCollision::raycast(float x0, float y0, float x1, float y1, uint8_t blockMask, float* outT) const {
+    if (tileFlags.empty() || tileSize <= 0) return false;
+    const TileBox area{std::min(x0, x1), std::min(y0, y1), std::max(x0, x1) + EDGE_EPSILON, std::max(y0, y1) + EDGE_EPSILON};
+    if (isOpen(area, MoveRules{blockMask, false})) return false;
+
+    int tx = tileOf(x0), ty = tileOf(y0);
+    const int endX = tileOf(x1), endY = tileOf(y1);
+    const float dx = x1 - x0, dy = y1 - y0;
+    const float ts = static_cast<float>(tileSize);
+    const int stepX = dx > 0.0f ? 1 : -1;
+    const int stepY = dy > 0.0f ? 1 : -1;
+    // Segment fraction at the next vertical/horizontal tile boundary, and between boundaries
+    float tMaxX = dx != 0.0f ? ((dx > 0.0f ? (tx + 1) * ts : tx * ts) - x0) / dx : INFINITY;
+    float tMaxY = dy != 0.0f ? ((dy > 0.0f ? (ty + 1) * ts : ty * ts) - y0) / dy : INFINITY;
+    const float tDeltaX = dx != 0.0f ? ts / std::fabs(dx) : INFINITY;
+    const float tDeltaY = dy != 0.0f ? ts / std::fabs(dy) : INFINITY;
+
+    // Exactly one tile step per boundary crossed, so rounding cannot overshoot the end tile
+    for (int steps = std::abs(endX - tx) + std::abs(endY - ty); steps > 0; --steps) {
+        float t;
+        if ((tMaxX < tMaxY && tx != endX) || ty == endY) {
+            tx += stepX;
+            t = tMaxX;
+            tMaxX += tDeltaX;
+        } else {
+            ty += stepY;
+            t = tMaxY;
+            tMaxY += tDeltaY;
+        }
+        if (getFlags(tx, ty) & blockMask) {
+            if (outT) *outT = std::min(1.0f, std::max(0.0f, t));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TileCollision::isLedgeBlockedVertical(int fromX, int fromY, int toX, int toY) const {
+    if (!ledgeData) return false;
+    // Vertical move only
+    if (fromX != toX || std::abs(toY - fromY) != 1) return false;
+    // If either origin or destination is out of bounds, do not restrict
+    if (!inBounds(fromX, fromY) || !inBounds(toX, toY)) return false;
+    const uint8_t from = getFlags(fromX, fromY);
+    const uint8_t to = getFlags(toX, toY);
+
+    // Always block movement into non-walkable tiles
+    if (to & (SOLID | LIQUID)) return true;
+    // Always allow movement on/to/from stairs
+    if ((from | to) & STAIRS) return false;
+    // Only block actual elevation changes: climbing up onto a platform or dropping off one
+    // without stairs. Platform1/2 differences are cosmetic here; isLedgeCrossingBlocked
+    // handles those with edge markers.
+    const bool fromPlat = (from & PLATFORM) != 0;
+    const bool toPlat = (to & PLATFORM) != 0;
+    if (toY < fromY && !fromPlat && toPlat) return true;
+    if (toY > fromY && fromPlat && !toPlat) return true;
+    // Destination explicitly flagged as a ledge face
+    return (to & EDGE) != 0;
+}
+
+bool TileCollision::isLedgeCrossingBlocked(int fromX, int fromY, int toX, int toY) const {
+    if (!ledgeData) return false;
+    // Any move that changes platform state must go through a stairs cell
+    if (!inBounds(fromX, fromY) || !inBounds(toX, toY)) return false;
+    if (fromX == toX && fromY == toY) return false;
+    const uint8_t from = getFlags(fromX, fromY);
+    const uint8_t to = getFlags(toX, toY);
+    auto stairs = [&](int x, int y) { return inBounds(x, y) && (getFlags(x, y) & STAIRS); };
+    const bool stairHere = ((from | to) & STAIRS) != 0;
+
+    // A horizontal step at the top or bottom of a staircase may go onto the platform when a
+    // staircase sits directly above or below either tile. Vertical moves are not relaxed here.
+    const bool isHorizontal = fromY == toY && std::abs(toX - fromX) == 1;
+    const bool isVertical = fromX == toX && std::abs(toY - fromY) == 1;
+    bool stairAdjacent = false;
+    if (isHorizontal) {
+        stairAdjacent = stairs(fromX, fromY - 1) || stairs(fromX, fromY + 1) ||
+                        stairs(toX, toY - 1) || stairs(toX, toY + 1);
+    }
+    auto nearStairsAt = [&](int x, int y) {
+        return stairs(x, y) || stairs(x, y - 1) || stairs(x, y + 1) || stairs(x - 1, y) || stairs(x + 1, y);
+    };
+    const bool edgeHere = ((from & EDGE) && !nearStairsAt(fromX, fromY)) || ((to & EDGE) && !nearStairsAt(toX, toY));
+
+    // Crossing between non-platform and platform, or between platform levels 1 and 2
+    const bool platformChange = ((from ^ to) & PLATFORM) != 0;
+    const bool levelChange = ((from & PLATFORM1) && (to & PLATFORM2)) || ((from & PLATFORM2) && (to & PLATFORM1));
+    if (platformChange || levelChange) {
+        if (stairHere) return false;
+        if ((isHorizontal || isVertical) && stairAdjacent) return false;
+        return edgeHere;
+    }
+    return false;
+}
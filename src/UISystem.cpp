@@ -8,8 +8,9 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 
-UISystem::UISystem(SDL_Renderer* renderer) : renderer(renderer), defaultFont(nullptr), smallFont(nullptr) {
+UISystem::UISystem(Renderer* renderer) : renderer(renderer), defaultFont(nullptr), smallFont(nullptr) {
     initializeFonts();
     initializeColors();
 }
@@ -59,6 +60,13 @@ void UISystem::initializeColors() {
     textColor = {255, 255, 255, 255};     // White
 }
 
+void UISystem::setPointer(int x, int y, Uint32 buttons, bool escape) {
+    pointerX = x;
+    pointerY = y;
+    pointerButtons = buttons;
+    escapeHeld = escape;
+}
+
 void UISystem::update(float deltaTime) {
     // Advance simple UI animations (e.g., potion icon flicker)
     potionAnimTimer += deltaTime;
@@ -73,9 +81,55 @@ void UISystem::render() {
     // Main UI rendering - this will be called by the game
 }
 
+UISystem::~UISystem() = default;
+
+uint64_t UISystem::hashCombine(uint64_t seed, uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+void UISystem::drawItemGrid(ItemSystem* itemSystem, const std::vector<InventorySlot>& slots, int count, int cols,
+                            int gridX, int gridY, SDL_Color fill, SDL_Color border) {
+    const int slotSize = 36;
+    const int slotSpacing = 4;
+    for (int slotIndex = 0; slotIndex < count && slotIndex < static_cast<int>(slots.size()); slotIndex++) {
+        int slotX = gridX + (slotIndex % cols) * (slotSize + slotSpacing);
+        int slotY = gridY + (slotIndex / cols) * (slotSize + slotSpacing);
+        SDL_Rect slotRect = {slotX, slotY, slotSize, slotSize};
+        
+        // Slot background
+        renderer->setDrawColor(fill.r, fill.g, fill.b, 255);
+        renderer->fillRect(&slotRect);
+        renderer->setDrawColor(border.r, border.g, border.b, 255);
+        renderer->drawRect(&slotRect);
+        
+        if (slots[slotIndex].isEmpty()) continue;
+        Item* item = slots[slotIndex].item;
+        
+        // Draw rarity border
+        SDL_Color rarityColor = item->getRarityColor();
+        renderer->setDrawColor(rarityColor.r, rarityColor.g, rarityColor.b, 255);
+        renderer->drawRect(&slotRect);
+        
+        // Draw item icon if available
+        Texture* icon = itemSystem->getItemIcon(item->id);
+        if (icon) {
+            SDL_Rect srcRect = {0, 0, 0, 0};
+            SDL_QueryTexture(icon->getTexture(), nullptr, nullptr, &srcRect.w, &srcRect.h);
+            SDL_Rect dstRect = {slotX + 2, slotY + 2, slotSize - 4, slotSize - 4};
+            renderer->copy(icon->getTexture(), &srcRect, &dstRect);
+        }
+        
+        // Draw stack count if > 1
+        if (item->currentStack > 1) {
+            std::string stackText = std::to_string(item->currentStack);
+            renderText(stackText, slotX + slotSize - 15, slotY + slotSize - 15, {255, 255, 255, 255});
+        }
+    }
+}
+
 void UISystem::renderDashCooldown(const Player* player) {
     if (!player) return;
-    int outW = 0, outH = 0; if (renderer) SDL_GetRendererOutputSize(renderer, &outW, &outH);
+    int outW = 0, outH = 0; if (renderer) renderer->getOutputSize(&outW, &outH);
     if (outW <= 0) { outW = 1280; outH = 720; }
     float remain = player->getDashCooldownRemaining();
     float maxCd = player->getDashCooldownMax();
@@ -86,18 +140,18 @@ void UISystem::renderDashCooldown(const Player* player) {
     int x = outW/2 - barW/2;
     int y = outH - 48; // bottom middle
     // Background
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(renderer, 20,20,24,180);
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    renderer->setDrawColor(20,20,24,180);
     SDL_Rect bg{ x, y, barW, barH };
-    SDL_RenderFillRect(renderer, &bg);
-    SDL_SetRenderDrawColor(renderer, 220,220,230,255);
-    SDL_RenderDrawRect(renderer, &bg);
+    renderer->fillRect(&bg);
+    renderer->setDrawColor(220,220,230,255);
+    renderer->drawRect(&bg);
     // Fill amount (cooldown remaining)
     SDL_Color fillCol = player->isDashing() ? SDL_Color{255,255,255,220} : SDL_Color{80,160,255,220};
-    SDL_SetRenderDrawColor(renderer, fillCol.r, fillCol.g, fillCol.b, fillCol.a);
+    renderer->setDrawColor(fillCol.r, fillCol.g, fillCol.b, fillCol.a);
     int fillW = static_cast<int>(std::round(barW * t));
     SDL_Rect fg{ x, y, fillW, barH };
-    SDL_RenderFillRect(renderer, &fg);
+    renderer->fillRect(&fg);
     // Text label and seconds
     std::string label = "Dash";
     if (remain > 0.05f) {
@@ -122,8 +176,8 @@ void UISystem::renderInventory(const Player* player, int screenW, int screenH,
     // Draw two bags side by side
     SDL_Rect d0{ x0, y, bw, bh };
     SDL_Rect d1{ x0 + bw + spacing, y, bw, bh };
-    SDL_RenderCopy(renderer, bag->getTexture(), nullptr, &d0);
-    SDL_RenderCopy(renderer, bag->getTexture(), nullptr, &d1);
+    renderer->copy(bag->getTexture(), nullptr, &d0);
+    renderer->copy(bag->getTexture(), nullptr, &d1);
     // Lay out a simple 3x3 grid per bag with icons and counts for known items
     const int cols = 3, rows = 3;
     int cell = bw / 3 - 10;
@@ -133,7 +187,7 @@ void UISystem::renderInventory(const Player* player, int screenW, int screenH,
         if (!t || count <= 0) return;
         SDL_Rect s{0,0,t->getWidth(),t->getHeight()};
         SDL_Rect d{ cx, cy, cell, cell };
-        SDL_RenderCopy(renderer, t->getTexture(), &s, &d);
+        renderer->copy(t->getTexture(), &s, &d);
         renderText("x" + std::to_string(count), d.x + 4, d.y + cell - 14);
         if (leftDown && mouseX>=d.x && mouseX<=d.x+d.w && mouseY>=d.y && mouseY<=d.y+d.h) {
             outHit.startedDrag = true; outHit.dragPayload = payloadKey;
@@ -150,9 +204,9 @@ void UISystem::renderInventory(const Player* player, int screenW, int screenH,
             else if (std::strcmp(payloadKey, "water") == 0) name = "Water Enchant Scroll";
             else if (std::strcmp(payloadKey, "poison") == 0) name = "Poison Enchant Scroll";
             int w = 210, h = 56; SDL_Rect tip{ mouseX + 14, mouseY + 10, w, h };
-            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-            SDL_SetRenderDrawColor(renderer, 20,20,24,220); SDL_RenderFillRect(renderer, &tip);
-            SDL_SetRenderDrawColor(renderer, 200,200,210,255); SDL_RenderDrawRect(renderer, &tip);
+            renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+            renderer->setDrawColor(20,20,24,220); renderer->fillRect(&tip);
+            renderer->setDrawColor(200,200,210,255); renderer->drawRect(&tip);
             renderText(name, tip.x + 8, tip.y + 6, SDL_Color{255,255,180,255});
             renderText("Count: " + std::to_string(count), tip.x + 8, tip.y + 24);
             renderText("Right-click to use at Anvil", tip.x + 8, tip.y + 40, SDL_Color{150,200,255,255});
@@ -206,7 +260,7 @@ void UISystem::renderTexturedBar(const char* texturePath,
     if (filledDstW > 0 && filledSrcW > 0) {
         SDL_Rect srcFG{0, 0, filledSrcW, th};
         SDL_Rect dstFG{ x, y, filledDstW, th };
-        SDL_RenderCopy(renderer, sdlTex, &srcFG, &dstFG);
+        renderer->copy(sdlTex, &srcFG, &dstFG);
     }
 }
 
@@ -279,16 +333,16 @@ void UISystem::renderBossHealthBar(const std::string& name, int current, int max
 
     // Background
     SDL_Rect bg{ x, y, barWidth, barHeight };
-    SDL_SetRenderDrawColor(renderer, 30, 30, 30, 220);
-    SDL_RenderFillRect(renderer, &bg);
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &bg);
+    renderer->setDrawColor(30, 30, 30, 220);
+    renderer->fillRect(&bg);
+    renderer->setDrawColor(255, 255, 255, 255);
+    renderer->drawRect(&bg);
 
     // Foreground (boss color)
     SDL_Color bossRed{200, 20, 20, 255};
     SDL_Rect fg{ x + 2, y + 2, static_cast<int>((barWidth - 4) * progress), barHeight - 4 };
-    SDL_SetRenderDrawColor(renderer, bossRed.r, bossRed.g, bossRed.b, bossRed.a);
-    SDL_RenderFillRect(renderer, &fg);
+    renderer->setDrawColor(bossRed.r, bossRed.g, bossRed.b, bossRed.a);
+    renderer->fillRect(&fg);
 
     // Text
     std::string text = name + "  " + std::to_string(current) + "/" + std::to_string(max);
@@ -317,13 +371,13 @@ void UISystem::renderGoldDisplay(int x, int y, int gold) {
     
     // Render background rectangle
     SDL_Rect bgRect = {x, y, bgWidth, bgHeight};
-    SDL_SetRenderDrawColor(renderer, goldBgColor.r, goldBgColor.g, goldBgColor.b, goldBgColor.a);
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_RenderFillRect(renderer, &bgRect);
+    renderer->setDrawColor(goldBgColor.r, goldBgColor.g, goldBgColor.b, goldBgColor.a);
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    renderer->fillRect(&bgRect);
     
     // Render border
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &bgRect);
+    renderer->setDrawColor(255, 255, 255, 255);
+    renderer->drawRect(&bgRect);
     
     // Render text
     renderText(goldText, x + padding, y + padding, goldTextColor);
@@ -356,7 +410,7 @@ void UISystem::renderPlayerStats(const Player* player) {
 
             // Draw the frame at native size
             SDL_Rect dst{ frameX, frameY, texW, texH };
-            SDL_RenderCopy(renderer, uiFrame->getTexture(), nullptr, &dst);
+            renderer->copy(uiFrame->getTexture(), nullptr, &dst);
 
             int bx = frameX + static_cast<int>(texW * BX_FRAC);
             int by1 = frameY + static_cast<int>(texH * BY1_FRAC);
@@ -396,7 +450,7 @@ void UISystem::renderPlayerStats(const Player* player) {
             //         int iconY = by3 + barHeight + 6 + 10; // near gold
             //         SDL_Rect s{0,0,bowIcon->getWidth(), bowIcon->getHeight()};
             //         SDL_Rect d{ iconX, iconY, iw, ih };
-            //         SDL_RenderCopy(renderer, bowIcon->getTexture(), &s, &d);
+            //         renderer->copy(bowIcon->getTexture(), &s, &d);
             //         renderText("Bow", iconX + iw + 6, iconY + ih/2 - 8);
             //     }
             // }
@@ -451,12 +505,11 @@ void UISystem::renderDebugInfo(const Player* player) {
 
 void UISystem::renderPotions(const Player* player) {
     if (!player) return;
-    Renderer rendererWrapper(renderer);
     const int iconSize = 32;
     const int margin = 10;
     int outW = 0, outH = 0;
     if (renderer) {
-        SDL_GetRendererOutputSize(renderer, &outW, &outH);
+        renderer->getOutputSize(&outW, &outH);
     }
     const int startX = margin; // left margin
     const int startY = (outH > 0 ? outH : 720) - iconSize - margin; // bottom-left anchor
@@ -502,10 +555,11 @@ void UISystem::renderPotions(const Player* player) {
         pickPotionSprite(charges, maxCharges, isHealth, tex, src);
         SDL_Rect dst{ x, y, iconSize, iconSize };
         if (tex) {
-            SDL_RenderCopy(renderer, tex, (src.w > 0 ? &src : nullptr), &dst);
+            renderer->copy(tex, (src.w > 0 ? &src : nullptr), &dst);
         } else {
             SDL_Color c = isHealth ? SDL_Color{200,0,0,255} : SDL_Color{0,0,200,255};
-            rendererWrapper.renderRect(dst, c, true);
+            renderer->setDrawColor(c);
+            renderer->fillRect(&dst);
         }
         // draw label and charges
         renderText(std::string(label), x + iconSize + 6, y + 4, textColor);
@@ -519,15 +573,13 @@ void UISystem::renderPotions(const Player* player) {
 void UISystem::renderText(const std::string& text, int x, int y, SDL_Color color) {
     if (!defaultFont) return;
     
-    Renderer rendererWrapper(renderer);
-    rendererWrapper.renderText(text, defaultFont, x, y, color);
+    renderer->renderText(text, defaultFont, x, y, color);
 }
 
 void UISystem::renderTextCentered(const std::string& text, int x, int y, SDL_Color color) {
     if (!defaultFont) return;
     
-    Renderer rendererWrapper(renderer);
-    rendererWrapper.renderTextCentered(text, defaultFont, x, y, color);
+    renderer->renderTextCentered(text, defaultFont, x, y, color);
 }
 
 void UISystem::renderInteractionPrompt(const std::string& prompt, int x, int y) {
@@ -548,13 +600,13 @@ void UISystem::renderInteractionPrompt(const std::string& prompt, int x, int y)
     
     // Render background rectangle
     SDL_Rect bgRect = {x - bgWidth/2, y - bgHeight/2, bgWidth, bgHeight};
-    SDL_SetRenderDrawColor(renderer, promptBgColor.r, promptBgColor.g, promptBgColor.b, promptBgColor.a);
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_RenderFillRect(renderer, &bgRect);
+    renderer->setDrawColor(promptBgColor.r, promptBgColor.g, promptBgColor.b, promptBgColor.a);
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    renderer->fillRect(&bgRect);
     
     // Render border
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &bgRect);
+    renderer->setDrawColor(255, 255, 255, 255);
+    renderer->drawRect(&bgRect);
     
     // Render text
     renderTextCentered(prompt, x, y, promptTextColor);
@@ -578,13 +630,13 @@ void UISystem::renderLootNotification(const std::string& lootText, int x, int y)
     
     // Render background rectangle
     SDL_Rect bgRect = {x - bgWidth/2, y - bgHeight/2, bgWidth, bgHeight};
-    SDL_SetRenderDrawColor(renderer, lootBgColor.r, lootBgColor.g, lootBgColor.b, lootBgColor.a);
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_RenderFillRect(renderer, &bgRect);
+    renderer->setDrawColor(lootBgColor.r, lootBgColor.g, lootBgColor.b, lootBgColor.a);
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    renderer->fillRect(&bgRect);
     
     // Render border
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &bgRect);
+    renderer->setDrawColor(255, 255, 255, 255);
+    renderer->drawRect(&bgRect);
     
     // Render text
     renderTextCentered(lootText, x, y, lootTextColor);
@@ -652,9 +704,6 @@ void UISystem::renderMagicAnvil(const Player* player,
         anvilX = screenW / 4 - pw / 2;
         anvilY = (screenH - ph) / 2;
     }
-    SDL_Rect anvilRect{ anvilX, anvilY, pw, ph };
-    SDL_RenderCopy(renderer, anvilBG->getTexture(), nullptr, &anvilRect);
-
     // New layout based on concept: two slots at top, upgrade button below, progress bar at bottom
     
     // Define slot positions based on the concept image
@@ -675,134 +724,155 @@ void UISystem::renderMagicAnvil(const Player* player,
         slotSize, slotSize
     };
     
-    // Draw the item upgrade slot
-    if (Texture* t = assetManager->getTexture("assets/Textures/UI/item_upgrade_slot.png")) {
-        SDL_Rect s{0,0,t->getWidth(),t->getHeight()};
-        SDL_RenderCopy(renderer, t->getTexture(), &s, &itemSlot);
-    } else {
-        SDL_SetRenderDrawColor(renderer, 90, 90, 120, 200);
-        SDL_RenderFillRect(renderer, &itemSlot);
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderDrawRect(renderer, &itemSlot);
-    }
+    // Upgrade button (horizontal bar below slots)
+    SDL_Rect upgradeButton = {
+        anvilX + (pw / 2) - 60,
+        anvilY + 120,
+        120, 24
+    };
     
-    // Draw the scroll slot
-    if (Texture* t = assetManager->getTexture("assets/Textures/UI/scroll_slot.png")) {
-        SDL_Rect s{0,0,t->getWidth(),t->getHeight()};
-        SDL_RenderCopy(renderer, t->getTexture(), &s, &scrollSlot);
-    } else {
-        SDL_SetRenderDrawColor(renderer, 90, 90, 120, 200);
-        SDL_RenderFillRect(renderer, &scrollSlot);
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderDrawRect(renderer, &scrollSlot);
-    }
+    // Upgrade indicator with background texture
+    SDL_Rect indicatorRect = {
+        anvilX + (pw / 2) - 55,  // Center horizontally
+        anvilY + ph - 50,        // Near bottom, moved up from previous position
+        110, 20
+    };
     
-    // Show item in upgrade slot - prioritize target item over selected slot
+    // Item shown in the upgrade slot - prioritize target item over selected slot
     Item* targetItem = (game ? game->getAnvilTargetItem() : nullptr);
     
-    if (targetItem && targetItem->type == ItemType::EQUIPMENT) {
-        // Use the specific dragged item
-        if (Texture* itemIcon = assetManager->getTexture(targetItem->iconPath)) {
-            int pad = 4;
-            SDL_Rect iconRect = {itemSlot.x + pad, itemSlot.y + pad, itemSlot.w - pad*2, itemSlot.h - pad*2};
-            SDL_RenderCopy(renderer, itemIcon->getTexture(), nullptr, &iconRect);
-            
-            // Show +level of target item
-            renderText("+" + std::to_string(targetItem->plusLevel), itemSlot.x + itemSlot.w - 20, itemSlot.y + itemSlot.h - 18, {200, 255, 200, 255});
+    // Static layer is keyed on everything it displays; hover and drag state are not drawn into it
+    ItemSystem* itemSystem = player ? player->getItemSystem() : nullptr;
+    uint64_t panelKey = hashCombine(reinterpret_cast<uintptr_t>(targetItem), targetItem ? targetItem->plusLevel : 0);
+    panelKey = hashCombine(panelKey, static_cast<uint64_t>(selectedSlotIdx + 1));
+    panelKey = hashCombine(panelKey, std::hash<std::string>{}(selectedScrollKey));
+    panelKey = hashCombine(panelKey, player ? player->getEquipmentVersion() : 0);
+    panelKey = hashCombine(panelKey, itemSystem ? itemSystem->getVersion() : 0);
+    int originX, originY;
+    if (renderer->beginPanel(ANVIL_PANEL, pw, ph, panelKey, anvilX, anvilY, originX, originY)) {
+        // Panel-local copies of the hit rects for drawing into the cache
+        auto toLocal = [&](SDL_Rect r) { r.x += originX - anvilX; r.y += originY - anvilY; return r; };
+        SDL_Rect localItemSlot = toLocal(itemSlot);
+        SDL_Rect localScrollSlot = toLocal(scrollSlot);
+        SDL_Rect localUpgradeButton = toLocal(upgradeButton);
+        SDL_Rect localIndicator = toLocal(indicatorRect);
+        
+        SDL_Rect anvilRect{ originX, originY, pw, ph };
+        renderer->copy(anvilBG->getTexture(), nullptr, &anvilRect);
+    
+        // Draw the item upgrade slot
+        if (Texture* t = assetManager->getTexture("assets/Textures/UI/item_upgrade_slot.png")) {
+            SDL_Rect s{0,0,t->getWidth(),t->getHeight()};
+            renderer->copy(t->getTexture(), &s, &localItemSlot);
+        } else {
+            renderer->setDrawColor(90, 90, 120, 200);
+            renderer->fillRect(&localItemSlot);
+            renderer->setDrawColor(255, 255, 255, 255);
+            renderer->drawRect(&localItemSlot);
+        }
+    
+        // Draw the scroll slot
+        if (Texture* t = assetManager->getTexture("assets/Textures/UI/scroll_slot.png")) {
+            SDL_Rect s{0,0,t->getWidth(),t->getHeight()};
+            renderer->copy(t->getTexture(), &s, &localScrollSlot);
+        } else {
+            renderer->setDrawColor(90, 90, 120, 200);
+            renderer->fillRect(&localScrollSlot);
+            renderer->setDrawColor(255, 255, 255, 255);
+            renderer->drawRect(&localScrollSlot);
         }
-    } else if (selectedSlotIdx >= 0 && selectedSlotIdx <= 8 && player) {
-        // Fallback to equipment slot method when no target item
-        const Player::EquipmentItem& eq = player->getEquipment(static_cast<Player::EquipmentSlot>(selectedSlotIdx));
+    
+        if (targetItem && targetItem->type == ItemType::EQUIPMENT) {
+            // Use the specific dragged item
+            if (Texture* itemIcon = itemSystem ? itemSystem->getItemIcon(targetItem->id) : nullptr) {
+                int pad = 4;
+                SDL_Rect iconRect = {localItemSlot.x + pad, localItemSlot.y + pad, localItemSlot.w - pad*2, localItemSlot.h - pad*2};
+                renderer->copy(itemIcon->getTexture(), nullptr, &iconRect);
+            
+                // Show +level of target item
+                renderText("+" + std::to_string(targetItem->plusLevel), localItemSlot.x + localItemSlot.w - 20, localItemSlot.y + localItemSlot.h - 18, {200, 255, 200, 255});
+            }
+        } else if (selectedSlotIdx >= 0 && selectedSlotIdx <= 8 && player) {
+            // Fallback to equipment slot method when no target item
+            const Player::EquipmentItem& eq = player->getEquipment(static_cast<Player::EquipmentSlot>(selectedSlotIdx));
         
-        // Item icon paths for display
-        const char* iconMap[9] = {
-            "assets/Textures/Items/ring_01.png",
-            "assets/Textures/Items/helmet_01.png", 
-            "assets/Textures/Items/necklace_01.png",
-            "assets/Textures/Items/sword_01.png",
-            "assets/Textures/Items/chestpeice_01.png",
-            "assets/Textures/Items/bow_01.png",
-            "assets/Textures/Items/gloves_01.png",
-            "assets/Textures/Items/waist_01.png",
-            "assets/Textures/Items/boots_01.png"
-        };
+            // Item icon paths for display
+            const char* iconMap[9] = {
+                "assets/Textures/Items/ring_01.png",
+                "assets/Textures/Items/helmet_01.png", 
+                "assets/Textures/Items/necklace_01.png",
+                "assets/Textures/Items/sword_01.png",
+                "assets/Textures/Items/chestpeice_01.png",
+                "assets/Textures/Items/bow_01.png",
+                "assets/Textures/Items/gloves_01.png",
+                "assets/Textures/Items/waist_01.png",
+                "assets/Textures/Items/boots_01.png"
+            };
         
-        if (Texture* itemIcon = assetManager->getTexture(iconMap[selectedSlotIdx])) {
-            int pad = 4;
-            SDL_Rect iconRect = {itemSlot.x + pad, itemSlot.y + pad, itemSlot.w - pad*2, itemSlot.h - pad*2};
-            SDL_RenderCopy(renderer, itemIcon->getTexture(), nullptr, &iconRect);
+            if (Texture* itemIcon = assetManager->getTexture(iconMap[selectedSlotIdx])) {
+                int pad = 4;
+                SDL_Rect iconRect = {localItemSlot.x + pad, localItemSlot.y + pad, localItemSlot.w - pad*2, localItemSlot.h - pad*2};
+                renderer->copy(itemIcon->getTexture(), nullptr, &iconRect);
             
-            // Show +level
-            renderText("+" + std::to_string(eq.plusLevel), itemSlot.x + itemSlot.w - 20, itemSlot.y + itemSlot.h - 18, {200, 255, 200, 255});
+                // Show +level
+                renderText("+" + std::to_string(eq.plusLevel), localItemSlot.x + localItemSlot.w - 20, localItemSlot.y + localItemSlot.h - 18, {200, 255, 200, 255});
+            }
         }
-    }
     
-    // Show scroll in appropriate slot based on type
-    if (!selectedScrollKey.empty()) {
-        std::string scrollIconPath;
-        SDL_Rect targetSlot = scrollSlot;  // Default to scroll slot
+        // Show scroll in appropriate slot based on type
+        if (!selectedScrollKey.empty()) {
+            std::string scrollIconPath;
+            SDL_Rect targetSlot = localScrollSlot;  // Default to scroll slot
         
-        if (selectedScrollKey == "upgrade_scroll") {
-            // Upgrade scrolls go in the right slot (empty slot in screenshot)
-            scrollIconPath = "assets/Textures/Items/upgrade_scroll.png";
-            targetSlot = scrollSlot;
-        } else if (selectedScrollKey == "fire_scroll" || selectedScrollKey == "water_scroll" || 
-                   selectedScrollKey == "lightning_scroll" || selectedScrollKey == "poison_scroll") {
-            // Element scrolls also go in the right slot
-            if (selectedScrollKey == "fire_scroll") {
-                scrollIconPath = "assets/Textures/Items/fire_dmg_scroll.png";
-            } else if (selectedScrollKey == "water_scroll") {
-                scrollIconPath = "assets/Textures/Items/water_damage_scroll.png";
-            } else if (selectedScrollKey == "lightning_scroll") {
-                scrollIconPath = "assets/Textures/Items/lightning_scroll.png"; // Need to check this exists
-            } else if (selectedScrollKey == "poison_scroll") {
-                scrollIconPath = "assets/Textures/Items/Poison_dmg_scroll.png";
+            if (selectedScrollKey == "upgrade_scroll") {
+                // Upgrade scrolls go in the right slot (empty slot in screenshot)
+                scrollIconPath = "assets/Textures/Items/upgrade_scroll.png";
+                targetSlot = localScrollSlot;
+            } else if (selectedScrollKey == "fire_scroll" || selectedScrollKey == "water_scroll" || 
+                       selectedScrollKey == "lightning_scroll" || selectedScrollKey == "poison_scroll") {
+                // Element scrolls also go in the right slot
+                if (selectedScrollKey == "fire_scroll") {
+                    scrollIconPath = "assets/Textures/Items/fire_dmg_scroll.png";
+                } else if (selectedScrollKey == "water_scroll") {
+                    scrollIconPath = "assets/Textures/Items/water_damage_scroll.png";
+                } else if (selectedScrollKey == "lightning_scroll") {
+                    scrollIconPath = "assets/Textures/Items/lightning_scroll.png"; // Need to check this exists
+                } else if (selectedScrollKey == "poison_scroll") {
+                    scrollIconPath = "assets/Textures/Items/Poison_dmg_scroll.png";
+                }
+                targetSlot = localScrollSlot;
             }
-            targetSlot = scrollSlot;
-        }
         
-        if (!scrollIconPath.empty()) {
-            if (Texture* scrollIcon = assetManager->getTexture(scrollIconPath)) {
-                int pad = 4;
-                SDL_Rect iconRect = {targetSlot.x + pad, targetSlot.y + pad, targetSlot.w - pad*2, targetSlot.h - pad*2};
-                SDL_RenderCopy(renderer, scrollIcon->getTexture(), nullptr, &iconRect);
+            if (!scrollIconPath.empty()) {
+                if (Texture* scrollIcon = assetManager->getTexture(scrollIconPath)) {
+                    int pad = 4;
+                    SDL_Rect iconRect = {targetSlot.x + pad, targetSlot.y + pad, targetSlot.w - pad*2, targetSlot.h - pad*2};
+                    renderer->copy(scrollIcon->getTexture(), nullptr, &iconRect);
+                }
             }
         }
-    }
-    // Upgrade button (horizontal bar below slots)
-    SDL_Rect upgradeButton = {
-        anvilX + (pw / 2) - 60,
-        anvilY + 120,
-        120, 24
-    };
-    
-    if (Texture* t = assetManager->getTexture("assets/Textures/UI/upgrade_button.png")) {
-        SDL_RenderCopy(renderer, t->getTexture(), nullptr, &upgradeButton);
-    } else {
-        SDL_SetRenderDrawColor(renderer, 80, 60, 40, 230);
-        SDL_RenderFillRect(renderer, &upgradeButton);
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderDrawRect(renderer, &upgradeButton);
-    }
-    renderTextCentered("UPGRADE", upgradeButton.x + upgradeButton.w/2, upgradeButton.y + upgradeButton.h/2, {255, 255, 255, 255});
-    
-    // Upgrade indicator with background texture
-    SDL_Rect indicatorRect = {
-        anvilX + (pw / 2) - 55,  // Center horizontally
-        anvilY + ph - 50,        // Near bottom, moved up from previous position
-        110, 20
-    };
+        if (Texture* t = assetManager->getTexture("assets/Textures/UI/upgrade_button.png")) {
+            renderer->copy(t->getTexture(), nullptr, &localUpgradeButton);
+        } else {
+            renderer->setDrawColor(80, 60, 40, 230);
+            renderer->fillRect(&localUpgradeButton);
+            renderer->setDrawColor(255, 255, 255, 255);
+            renderer->drawRect(&localUpgradeButton);
+        }
+        renderTextCentered("UPGRADE", localUpgradeButton.x + localUpgradeButton.w/2, localUpgradeButton.y + localUpgradeButton.h/2, {255, 255, 255, 255});
     
-    // Draw the upgrade indicator background
-    if (Texture* indicator = assetManager->getTexture("assets/Textures/UI/upgrade_indicator.png")) {
-        SDL_RenderCopy(renderer, indicator->getTexture(), nullptr, &indicatorRect);
-    } else {
-        // Fallback if texture not found
-        SDL_SetRenderDrawColor(renderer, 60, 60, 60, 255);
-        SDL_RenderFillRect(renderer, &indicatorRect);
-        SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
-        SDL_RenderDrawRect(renderer, &indicatorRect);
+        // Draw the upgrade indicator background
+        if (Texture* indicator = assetManager->getTexture("assets/Textures/UI/upgrade_indicator.png")) {
+            renderer->copy(indicator->getTexture(), nullptr, &localIndicator);
+        } else {
+            // Fallback if texture not found
+            renderer->setDrawColor(60, 60, 60, 255);
+            renderer->fillRect(&localIndicator);
+            renderer->setDrawColor(200, 200, 200, 255);
+            renderer->drawRect(&localIndicator);
+        }
     }
+    renderer->endPanel(ANVIL_PANEL, anvilX, anvilY);
 
     // Handle mouse interactions
     static bool wasDown = false;
@@ -908,26 +978,27 @@ void UISystem::renderOptionsMenu(int selectedIndex,
                            bool fullscreenEnabled, bool vsyncEnabled,
                            OptionsTab activeTab,
                            int mouseX, int mouseY, bool mouseDown,
-                           MenuHitResult& outResult) {
+                           MenuHitResult& outResult,
+                           const float* volumePeaks) {
     if (!defaultFont) return;
     static bool lastMouseDown = false; // edge-trigger for clicks
     int outW = 0, outH = 0;
-    if (renderer) SDL_GetRendererOutputSize(renderer, &outW, &outH);
+    if (renderer) renderer->getOutputSize(&outW, &outH);
     if (outW <= 0) { outW = 1280; outH = 720; }
 
     // Dim background
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    renderer->setDrawColor(0, 0, 0, 160);
     SDL_Rect dim{0,0,outW,outH};
-    SDL_RenderFillRect(renderer, &dim);
+    renderer->fillRect(&dim);
 
     // Panel
     const int panelW = 600, panelH = 400;
     SDL_Rect panel{ outW/2 - panelW/2, outH/2 - panelH/2, panelW, panelH };
-    SDL_SetRenderDrawColor(renderer, 32, 32, 48, 235);
-    SDL_RenderFillRect(renderer, &panel);
-    SDL_SetRenderDrawColor(renderer, 200, 200, 220, 255);
-    SDL_RenderDrawRect(renderer, &panel);
+    renderer->setDrawColor(32, 32, 48, 235);
+    renderer->fillRect(&panel);
+    renderer->setDrawColor(200, 200, 220, 255);
+    renderer->drawRect(&panel);
 
     // Title
     renderTextCentered("Options", outW/2, panel.y + 30, SDL_Color{255,255,255,255});
@@ -940,10 +1011,10 @@ void UISystem::renderOptionsMenu(int selectedIndex,
         SDL_Rect tr{ panel.x + 20 + t * (tabW + 8), tabsY, tabW, tabH };
         bool hovered = (mouseX >= tr.x && mouseX <= tr.x + tr.w && mouseY >= tr.y && mouseY <= tr.y + tr.h);
         bool active = (static_cast<int>(activeTab) == t);
-        SDL_SetRenderDrawColor(renderer, active ? 80 : 50, active ? 140 : 70, active ? 200 : 90, 230);
-        SDL_RenderFillRect(renderer, &tr);
-        SDL_SetRenderDrawColor(renderer, 220,220,220,255);
-        SDL_RenderDrawRect(renderer, &tr);
+        renderer->setDrawColor(active ? 80 : 50, active ? 140 : 70, active ? 200 : 90, 230);
+        renderer->fillRect(&tr);
+        renderer->setDrawColor(220,220,220,255);
+        renderer->drawRect(&tr);
         renderTextCentered(tabNames[t], tr.x + tr.w/2, tr.y + tr.h/2, SDL_Color{255,255,255,255});
         if (hovered && mouseDown && !lastMouseDown) outResult.newTabIndex = t;
     }
@@ -955,33 +1026,33 @@ void UISystem::renderOptionsMenu(int selectedIndex,
         for (int i = 0; i < 3; ++i) {
             SDL_Rect rowRect{ panel.x + 30, startY + i * rowH, panelW - 60, rowH - 6 };
             bool selected = (mouseX >= rowRect.x && mouseX <= rowRect.x + rowRect.w && mouseY >= rowRect.y && mouseY <= rowRect.y + rowRect.h);
-            SDL_SetRenderDrawColor(renderer, selected ? 70 : 50, selected ? 120 : 50, selected ? 180 : 70, 200);
-            SDL_RenderFillRect(renderer, &rowRect);
-            SDL_SetRenderDrawColor(renderer, 220,220,220,255);
-            SDL_RenderDrawRect(renderer, &rowRect);
+            renderer->setDrawColor(selected ? 70 : 50, selected ? 120 : 50, selected ? 180 : 70, 200);
+            renderer->fillRect(&rowRect);
+            renderer->setDrawColor(220,220,220,255);
+            renderer->drawRect(&rowRect);
             SDL_Rect action{ rowRect.x + rowRect.w - 220, rowRect.y + 8, 200, rowRect.h - 16 };
             if (i == 0) {
                 renderText("Resume", rowRect.x + 10, rowRect.y + 12, SDL_Color{255,255,255,255});
-                SDL_SetRenderDrawColor(renderer, 90, 160, 90, 255);
-                SDL_RenderFillRect(renderer, &action);
-                SDL_SetRenderDrawColor(renderer, 255,255,255,255);
-                SDL_RenderDrawRect(renderer, &action);
+                renderer->setDrawColor(90, 160, 90, 255);
+                renderer->fillRect(&action);
+                renderer->setDrawColor(255,255,255,255);
+                renderer->drawRect(&action);
                 renderText("Resume", action.x + 12, action.y + 8, SDL_Color{255,255,255,255});
                 if (mouseDown && !lastMouseDown && mouseX >= action.x && mouseX <= action.x + action.w && mouseY >= action.y && mouseY <= action.y + action.h) outResult.clickedResume = true;
             } else if (i == 1) {
                 renderText("Reset", rowRect.x + 10, rowRect.y + 12, SDL_Color{255,255,255,255});
-                SDL_SetRenderDrawColor(renderer, 200, 140, 60, 255);
-                SDL_RenderFillRect(renderer, &action);
-                SDL_SetRenderDrawColor(renderer, 255,255,255,255);
-                SDL_RenderDrawRect(renderer, &action);
+                renderer->setDrawColor(200, 140, 60, 255);
+                renderer->fillRect(&action);
+                renderer->setDrawColor(255,255,255,255);
+                renderer->drawRect(&action);
                 renderText("Reset", action.x + 12, action.y + 8, SDL_Color{255,255,255,255});
                 if (mouseDown && !lastMouseDown && mouseX >= action.x && mouseX <= action.x + action.w && mouseY >= action.y && mouseY <= action.y + action.h) outResult.clickedReset = true;
             } else {
                 renderText("Logout", rowRect.x + 10, rowRect.y + 12, SDL_Color{255,255,255,255});
-                SDL_SetRenderDrawColor(renderer, 170, 70, 70, 255);
-                SDL_RenderFillRect(renderer, &action);
-                SDL_SetRenderDrawColor(renderer, 255,255,255,255);
-                SDL_RenderDrawRect(renderer, &action);
+                renderer->setDrawColor(170, 70, 70, 255);
+                renderer->fillRect(&action);
+                renderer->setDrawColor(255,255,255,255);
+                renderer->drawRect(&action);
                 renderText("Logout", action.x + 12, action.y + 8, SDL_Color{255,255,255,255});
                 if (mouseDown && !lastMouseDown && mouseX >= action.x && mouseX <= action.x + action.w && mouseY >= action.y && mouseY <= action.y + action.h) outResult.clickedLogout = true;
             }
@@ -992,10 +1063,10 @@ void UISystem::renderOptionsMenu(int selectedIndex,
         for (int i = 0; i < sliders; ++i) {
             SDL_Rect rowRect{ panel.x + 30, startY + i * rowH, panelW - 60, rowH - 6 };
             bool selected = (mouseX >= rowRect.x && mouseX <= rowRect.x + rowRect.w && mouseY >= rowRect.y && mouseY <= rowRect.y + rowRect.h);
-            SDL_SetRenderDrawColor(renderer, selected ? 70 : 50, selected ? 120 : 50, selected ? 180 : 70, 200);
-            SDL_RenderFillRect(renderer, &rowRect);
-            SDL_SetRenderDrawColor(renderer, 220,220,220,255);
-            SDL_RenderDrawRect(renderer, &rowRect);
+            renderer->setDrawColor(selected ? 70 : 50, selected ? 120 : 50, selected ? 180 : 70, 200);
+            renderer->fillRect(&rowRect);
+            renderer->setDrawColor(220,220,220,255);
+            renderer->drawRect(&rowRect);
             const char* labels[5] = { "Master Volume", "Music Volume", "Sound Volume", "Monster Volume", "Player Melee Volume" };
             renderText(labels[i], rowRect.x + 10, rowRect.y + 12);
             SDL_Rect valueArea{ rowRect.x + rowRect.w - 320, rowRect.y + 8, 300, rowRect.h - 16 };
@@ -1004,16 +1075,24 @@ void UISystem::renderOptionsMenu(int selectedIndex,
             static int playerVolCache = 100;
             int v = (i == 0 ? masterVolume : (i == 1 ? musicVolume : (i == 2 ? soundVolume : (i == 3 ? monsterVolume : playerMeleeVolume))));
             v = std::max(0, std::min(100, v));
-            SDL_SetRenderDrawColor(renderer, 60, 60, 60, 255);
-            SDL_RenderFillRect(renderer, &valueArea);
-            SDL_SetRenderDrawColor(renderer, 120, 120, 120, 255);
-            SDL_RenderDrawRect(renderer, &valueArea);
+            renderer->setDrawColor(60, 60, 60, 255);
+            renderer->fillRect(&valueArea);
+            renderer->setDrawColor(120, 120, 120, 255);
+            renderer->drawRect(&valueArea);
             int knobW = 12;
             float t = v / 100.0f;
             int knobX = valueArea.x + static_cast<int>(t * (valueArea.w - knobW));
             SDL_Rect knob{ knobX, valueArea.y, knobW, valueArea.h };
-            SDL_SetRenderDrawColor(renderer, 200, 200, 240, 255);
-            SDL_RenderFillRect(renderer, &knob);
+            renderer->setDrawColor(200, 200, 240, 255);
+            renderer->fillRect(&knob);
+            // Output meter under the slider
+            if (volumePeaks) {
+                float peak = std::max(0.0f, volumePeaks[i]);
+                SDL_Rect meter{ valueArea.x, valueArea.y + valueArea.h + 2, static_cast<int>(std::min(1.0f, peak) * valueArea.w), 3 };
+                if (peak >= 1.0f) renderer->setDrawColor(230, 70, 60, 255);
+                else renderer->setDrawColor(90, 200, 110, 255);
+                renderer->fillRect(&meter);
+            }
             bool hovering = (mouseX >= valueArea.x && mouseX <= valueArea.x + valueArea.w && mouseY >= valueArea.y && mouseY <= valueArea.y + valueArea.h);
             if (hovering && mouseDown) {
                 float rel = (mouseX - valueArea.x) / static_cast<float>(valueArea.w - knobW);
@@ -1026,7 +1105,7 @@ void UISystem::renderOptionsMenu(int selectedIndex,
             }
             // Mute checkbox between label and slider
             SDL_Rect chk{ rowRect.x + 180, rowRect.y + 10, 18, 18 };
-            SDL_SetRenderDrawColor(renderer, 240, 240, 240, 255); SDL_RenderDrawRect(renderer, &chk);
+            renderer->setDrawColor(240, 240, 240, 255); renderer->drawRect(&chk);
             if (mouseDown && !lastMouseDown && mouseX >= chk.x && mouseX <= chk.x + chk.w && mouseY >= chk.y && mouseY <= chk.y + chk.h) {
                 if (i == 0) { outResult.changedMaster = true; outResult.newMaster = 0; }
                 if (i == 1) { outResult.changedMusic  = true; outResult.newMusic  = 0; }
@@ -1037,26 +1116,26 @@ void UISystem::renderOptionsMenu(int selectedIndex,
         }
         // Theme selection row as dropdown
         SDL_Rect rowRect2{ panel.x + 30, startY + sliders * rowH, panelW - 60, rowH - 6 };
-        SDL_SetRenderDrawColor(renderer, 50, 80, 120, 200);
-        SDL_RenderFillRect(renderer, &rowRect2);
-        SDL_SetRenderDrawColor(renderer, 220, 220, 220, 255);
-        SDL_RenderDrawRect(renderer, &rowRect2);
+        renderer->setDrawColor(50, 80, 120, 200);
+        renderer->fillRect(&rowRect2);
+        renderer->setDrawColor(220, 220, 220, 255);
+        renderer->drawRect(&rowRect2);
         renderText("Music Theme", rowRect2.x + 10, rowRect2.y + 12);
         static bool themeOpen = false;
         static int selectedThemeIndexUI = 0; // 0 Main, 1 Fast
         SDL_Rect ddl{ rowRect2.x + rowRect2.w - 320, rowRect2.y + 8, 260, rowRect2.h - 16 };
-        SDL_SetRenderDrawColor(renderer, 60, 60, 100, 255); SDL_RenderFillRect(renderer, &ddl);
-        SDL_SetRenderDrawColor(renderer, 255,255,255,255); SDL_RenderDrawRect(renderer, &ddl);
+        renderer->setDrawColor(60, 60, 100, 255); renderer->fillRect(&ddl);
+        renderer->setDrawColor(255,255,255,255); renderer->drawRect(&ddl);
         renderText(selectedThemeIndexUI == 0 ? "Main" : "Fast", ddl.x + 10, ddl.y + 8);
         if (mouseDown && !lastMouseDown && mouseX>=ddl.x && mouseX<=ddl.x+ddl.w && mouseY>=ddl.y && mouseY<=ddl.y+ddl.h) themeOpen = !themeOpen;
         if (themeOpen) {
             SDL_Rect opt1{ ddl.x, ddl.y + ddl.h + 4, ddl.w, ddl.h };
             SDL_Rect opt2{ ddl.x, ddl.y + 2*ddl.h + 6, ddl.w, ddl.h };
-            SDL_SetRenderDrawColor(renderer, 70,120,170,255); SDL_RenderFillRect(renderer, &opt1);
-            SDL_SetRenderDrawColor(renderer, 255,255,255,255); SDL_RenderDrawRect(renderer, &opt1);
+            renderer->setDrawColor(70,120,170,255); renderer->fillRect(&opt1);
+            renderer->setDrawColor(255,255,255,255); renderer->drawRect(&opt1);
             renderText("Main", opt1.x + 10, opt1.y + 8);
-            SDL_SetRenderDrawColor(renderer, 70,120,170,255); SDL_RenderFillRect(renderer, &opt2);
-            SDL_SetRenderDrawColor(renderer, 255,255,255,255); SDL_RenderDrawRect(renderer, &opt2);
+            renderer->setDrawColor(70,120,170,255); renderer->fillRect(&opt2);
+            renderer->setDrawColor(255,255,255,255); renderer->drawRect(&opt2);
             renderText("Fast", opt2.x + 10, opt2.y + 8);
             if (mouseDown && !lastMouseDown) {
                 if (mouseX>=opt1.x && mouseX<=opt1.x+opt1.w && mouseY>=opt1.y && mouseY<=opt1.y+opt1.h) { outResult.newThemeIndex = 0; selectedThemeIndexUI = 0; themeOpen = false; }
@@ -1076,17 +1155,17 @@ void UISystem::renderOptionsMenu(int selectedIndex,
         for (int i = 0; i < rows; ++i) {
             SDL_Rect rowRect{ panel.x + 30, startY + i * rowH, panelW - 60, rowH - 6 };
             bool selected = (mouseX >= rowRect.x && mouseX <= rowRect.x + rowRect.w && mouseY >= rowRect.y && mouseY <= rowRect.y + rowRect.h);
-            SDL_SetRenderDrawColor(renderer, selected ? 70 : 50, selected ? 120 : 50, selected ? 180 : 70, 200);
-            SDL_RenderFillRect(renderer, &rowRect);
-            SDL_SetRenderDrawColor(renderer, 220,220,220,255);
-            SDL_RenderDrawRect(renderer, &rowRect);
+            renderer->setDrawColor(selected ? 70 : 50, selected ? 120 : 50, selected ? 180 : 70, 200);
+            renderer->fillRect(&rowRect);
+            renderer->setDrawColor(220,220,220,255);
+            renderer->drawRect(&rowRect);
             const char* labels[3] = { "Fullscreen", "VSync", "Stop Monster Spawns" };
             renderText(labels[i], rowRect.x + 10, rowRect.y + 12);
             SDL_Rect valueArea{ rowRect.x + rowRect.w - 220, rowRect.y + 8, 200, rowRect.h - 16 };
-            SDL_SetRenderDrawColor(renderer, 80, 120, 160, 255);
-            SDL_RenderFillRect(renderer, &valueArea);
-            SDL_SetRenderDrawColor(renderer, 255,255,255,255);
-            SDL_RenderDrawRect(renderer, &valueArea);
+            renderer->setDrawColor(80, 120, 160, 255);
+            renderer->fillRect(&valueArea);
+            renderer->setDrawColor(255,255,255,255);
+            renderer->drawRect(&valueArea);
             if (i == 0) {
                 renderText(fullscreenEnabled ? "On" : "Off", valueArea.x + 12, valueArea.y + 8);
                 if (mouseDown && mouseX >= valueArea.x && mouseX <= valueArea.x + valueArea.w && mouseY >= valueArea.y && mouseY <= valueArea.y + valueArea.h) {
@@ -1119,25 +1198,25 @@ void UISystem::renderDeathPopup(bool& outClickedRespawn, float fadeAlpha01) {
     if (!defaultFont) return;
     int outW = 0, outH = 0;
     if (renderer) {
-        SDL_GetRendererOutputSize(renderer, &outW, &outH);
+        renderer->getOutputSize(&outW, &outH);
     } else {
         outW = 1280; outH = 720;
     }
     // Darken background
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
     Uint8 overlayAlpha = static_cast<Uint8>(std::max(0.0f, std::min(1.0f, fadeAlpha01)) * 200.0f);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, overlayAlpha);
+    renderer->setDrawColor(0, 0, 0, overlayAlpha);
     SDL_Rect dim = {0,0,outW,outH};
-    SDL_RenderFillRect(renderer, &dim);
+    renderer->fillRect(&dim);
 
     // Popup panel
     int panelW = 420, panelH = 220;
     SDL_Rect panel = { outW/2 - panelW/2, outH/2 - panelH/2, panelW, panelH };
     Uint8 panelAlpha = static_cast<Uint8>(std::max(0.0f, std::min(1.0f, fadeAlpha01)) * 240.0f);
-    SDL_SetRenderDrawColor(renderer, 30, 30, 30, panelAlpha);
-    SDL_RenderFillRect(renderer, &panel);
-    SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
-    SDL_RenderDrawRect(renderer, &panel);
+    renderer->setDrawColor(30, 30, 30, panelAlpha);
+    renderer->fillRect(&panel);
+    renderer->setDrawColor(200, 200, 200, 255);
+    renderer->drawRect(&panel);
 
     // Title
     renderTextCentered("You died", outW/2, panel.y + 40, SDL_Color{255, 80, 80, static_cast<Uint8>(255 * fadeAlpha01)});
@@ -1147,16 +1226,15 @@ void UISystem::renderDeathPopup(bool& outClickedRespawn, float fadeAlpha01) {
     int btnW = 180, btnH = 44;
     SDL_Rect btn = { outW/2 - btnW/2, panel.y + panelH - 70, btnW, btnH };
     // Hover effect via mouse pos - InputManager not injected here, so render static button
-    SDL_SetRenderDrawColor(renderer, 70, 130, 180, static_cast<Uint8>(255 * fadeAlpha01));
-    SDL_RenderFillRect(renderer, &btn);
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &btn);
+    renderer->setDrawColor(70, 130, 180, static_cast<Uint8>(255 * fadeAlpha01));
+    renderer->fillRect(&btn);
+    renderer->setDrawColor(255, 255, 255, 255);
+    renderer->drawRect(&btn);
     renderTextCentered("Respawn", outW/2, btn.y + btn.h/2, SDL_Color{255,255,255, static_cast<Uint8>(255 * fadeAlpha01)});
 
     // Click detection: poll current mouse state
-    int mx, my;
-    Uint32 mouse = SDL_GetMouseState(&mx, &my);
-    bool leftDown = (mouse & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
+    int mx = pointerX, my = pointerY;
+    bool leftDown = (pointerButtons & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
     if (fadeAlpha01 >= 1.0f && leftDown && mx >= btn.x && mx <= btn.x + btn.w && my >= btn.y && my <= btn.y + btn.h) {
         outClickedRespawn = true;
     }
@@ -1171,7 +1249,7 @@ UISystem::InventoryHit UISystem::renderEnhancedInventory(Player* player, bool& i
     
     // Get screen dimensions
     int screenW, screenH;
-    SDL_GetRendererOutputSize(renderer, &screenW, &screenH);
+    renderer->getOutputSize(&screenW, &screenH);
     
     // Inventory panel - use custom position if set, otherwise use default positioning
     int panelW = 800;
@@ -1199,24 +1277,6 @@ UISystem::InventoryHit UISystem::renderEnhancedInventory(Player* player, bool& i
         }
     }
     
-    // Background panel
-    SDL_Rect panel = {panelX, panelY, panelW, panelH};
-    SDL_SetRenderDrawColor(renderer, 40, 40, 60, 240);
-    SDL_RenderFillRect(renderer, &panel);
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &panel);
-    
-    // Title
-    renderTextCentered("Inventory", panelX + panelW/2, panelY + 20);
-    
-    // Close button (X in top right)
-    SDL_Rect closeBtn = {panelX + panelW - 40, panelY + 10, 30, 30};
-    SDL_SetRenderDrawColor(renderer, 160, 40, 40, 255);
-    SDL_RenderFillRect(renderer, &closeBtn);
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &closeBtn);
-    renderTextCentered("X", closeBtn.x + closeBtn.w/2, closeBtn.y + closeBtn.h/2);
-    
     // Split into three sections: Equipment (left), Scrolls (middle), Resources (right)
     int sectionW = (panelW - 80) / 3;
     int equipmentX = panelX + 20;
@@ -1225,256 +1285,109 @@ UISystem::InventoryHit UISystem::renderEnhancedInventory(Player* player, bool& i
     int sectionY = panelY + 60;
     int sectionH = panelH - 100;
     
-    // Equipment section
-    SDL_Rect equipmentSection = {equipmentX, sectionY, sectionW, sectionH};
-    SDL_SetRenderDrawColor(renderer, 30, 30, 45, 255);
-    SDL_RenderFillRect(renderer, &equipmentSection);
-    SDL_SetRenderDrawColor(renderer, 120, 120, 140, 255);
-    SDL_RenderDrawRect(renderer, &equipmentSection);
-    
-    renderText("Equipment", equipmentX + 10, sectionY + 10);
-    
-    // Draw equipment grid (4 columns, 12 rows) - adjusted for narrower section
-    int slotSize = 36;  // Smaller slots for three-column layout
-    int slotSpacing = 4;  // Reduced spacing
-    int equipmentCols = 4;  // Fewer columns due to narrower section
-    int equipmentRows = 12;  // More rows to maintain slot count
-    int equipmentGridStartX = equipmentX + 10;  // Better left margin  
-    int equipmentGridStartY = sectionY + 35;  // Better top margin
-    
-    const auto& itemInventory = itemSystem->getItemInventory();
-    
-    for (int row = 0; row < equipmentRows; row++) {
-        for (int col = 0; col < equipmentCols; col++) {
-            int slotIndex = row * equipmentCols + col;
-            if (slotIndex >= ItemSystem::INVENTORY_SIZE) break;
-            
-            int slotX = equipmentGridStartX + col * (slotSize + slotSpacing);
-            int slotY = equipmentGridStartY + row * (slotSize + slotSpacing);
-            SDL_Rect slotRect = {slotX, slotY, slotSize, slotSize};
-            
-            // Slot background
-            SDL_SetRenderDrawColor(renderer, 50, 50, 70, 255);
-            SDL_RenderFillRect(renderer, &slotRect);
-            SDL_SetRenderDrawColor(renderer, 100, 100, 120, 255);
-            SDL_RenderDrawRect(renderer, &slotRect);
-            
-            // Item icon and info
-            if (!itemInventory[slotIndex].isEmpty()) {
-                Item* item = itemInventory[slotIndex].item;
-                
-                // Draw rarity border
-                SDL_Color rarityColor = item->getRarityColor();
-                SDL_SetRenderDrawColor(renderer, rarityColor.r, rarityColor.g, rarityColor.b, 255);
-                SDL_RenderDrawRect(renderer, &slotRect);
-                
-                // Draw item icon if available
-                Texture* icon = itemSystem->getItemIcon(item->id);
-                if (icon) {
-                    SDL_Rect srcRect = {0, 0, 0, 0};
-                    SDL_QueryTexture(icon->getTexture(), nullptr, nullptr, &srcRect.w, &srcRect.h);
-                    SDL_Rect dstRect = {slotX + 2, slotY + 2, slotSize - 4, slotSize - 4};
-                    SDL_RenderCopy(renderer, icon->getTexture(), &srcRect, &dstRect);
-                }
-                
-                // Draw stack count if > 1
-                if (item->currentStack > 1) {
-                    std::string stackText = std::to_string(item->currentStack);
-                    renderText(stackText, slotX + slotSize - 15, slotY + slotSize - 15, {255, 255, 255, 255});
-                }
-            }
-            
-            // Check for mouse clicks on this slot
-            int mx, my;
-            Uint32 mouseState = SDL_GetMouseState(&mx, &my);
-            bool leftClick = (mouseState & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
-            bool rightClick = (mouseState & SDL_BUTTON(SDL_BUTTON_RIGHT)) != 0;
-            
-            if (mx >= slotX && mx <= slotX + slotSize && my >= slotY && my <= slotY + slotSize) {
-                if (leftClick) {
-                    hit.clickedItemSlot = slotIndex;
-                }
-                if (rightClick) {
-                    hit.rightClicked = true;
-                    hit.clickedItemSlot = slotIndex;
-                }
-                
-                // Show tooltip on hover
-                if (!itemInventory[slotIndex].isEmpty()) {
-                    Item* item = itemInventory[slotIndex].item;
-                    renderTooltip(item->getTooltipText(), mx, my);
-                }
-            }
-        }
-    }
-    
-    // Scrolls section
-    SDL_Rect scrollsSection = {scrollsX, sectionY, sectionW, sectionH};
-    SDL_SetRenderDrawColor(renderer, 45, 30, 30, 255);
-    SDL_RenderFillRect(renderer, &scrollsSection);
-    SDL_SetRenderDrawColor(renderer, 140, 120, 120, 255);
-    SDL_RenderDrawRect(renderer, &scrollsSection);
-    
-    renderText("Scrolls", scrollsX + 10, sectionY + 10);
-    
-    // Draw scroll grid (3 columns, 7 rows) with improved spacing for narrower section
+    // Equipment grid is 4x12, scrolls 3x7, resources 3x10
+    int slotSize = 36;
+    int slotSpacing = 4;
+    int equipmentCols = 4;
     int scrollCols = 3;
-    int scrollRows = 7;
-    int scrollGridStartX = scrollsX + 10;  // Better left margin
-    int scrollGridStartY = sectionY + 35;  // Better top margin
-    
-    const auto& scrollInventory = itemSystem->getScrollInventory();
-    
-    for (int row = 0; row < scrollRows; row++) {
-        for (int col = 0; col < scrollCols; col++) {
-            int slotIndex = row * scrollCols + col;
-            if (slotIndex >= ItemSystem::SCROLL_INVENTORY_SIZE) break;
-            
-            int slotX = scrollGridStartX + col * (slotSize + slotSpacing);
-            int slotY = scrollGridStartY + row * (slotSize + slotSpacing);
-            SDL_Rect slotRect = {slotX, slotY, slotSize, slotSize};
-            
-            // Slot background
-            SDL_SetRenderDrawColor(renderer, 70, 50, 50, 255);
-            SDL_RenderFillRect(renderer, &slotRect);
-            SDL_SetRenderDrawColor(renderer, 120, 100, 100, 255);
-            SDL_RenderDrawRect(renderer, &slotRect);
-            
-            // Scroll icon and info
-            if (!scrollInventory[slotIndex].isEmpty()) {
-                Item* scroll = scrollInventory[slotIndex].item;
-                
-                // Draw rarity border
-                SDL_Color rarityColor = scroll->getRarityColor();
-                SDL_SetRenderDrawColor(renderer, rarityColor.r, rarityColor.g, rarityColor.b, 255);
-                SDL_RenderDrawRect(renderer, &slotRect);
-                
-                // Draw scroll icon if available
-                Texture* icon = itemSystem->getItemIcon(scroll->id);
-                if (icon) {
-                    SDL_Rect srcRect = {0, 0, 0, 0};
-                    SDL_QueryTexture(icon->getTexture(), nullptr, nullptr, &srcRect.w, &srcRect.h);
-                    SDL_Rect dstRect = {slotX + 2, slotY + 2, slotSize - 4, slotSize - 4};
-                    SDL_RenderCopy(renderer, icon->getTexture(), &srcRect, &dstRect);
-                }
-                
-                // Draw stack count if > 1
-                if (scroll->currentStack > 1) {
-                    std::string stackText = std::to_string(scroll->currentStack);
-                    renderText(stackText, slotX + slotSize - 15, slotY + slotSize - 15, {255, 255, 255, 255});
-                }
-            }
-            
-            // Check for mouse clicks on this scroll slot
-            int mx, my;
-            Uint32 mouseState = SDL_GetMouseState(&mx, &my);
-            bool leftClick = (mouseState & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
-            bool rightClick = (mouseState & SDL_BUTTON(SDL_BUTTON_RIGHT)) != 0;
-            
-            if (mx >= slotX && mx <= slotX + slotSize && my >= slotY && my <= slotY + slotSize) {
-                if (leftClick) {
-                    hit.clickedScrollSlot = slotIndex;
-                }
-                if (rightClick) {
-                    hit.rightClicked = true;
-                    hit.clickedScrollSlot = slotIndex;
-                }
-                
-                // Show tooltip on hover for scrolls
-                if (!scrollInventory[slotIndex].isEmpty()) {
-                    Item* scroll = scrollInventory[slotIndex].item;
-                    renderTooltip(scroll->getTooltipText(), mx, my);
-                }
-            }
-        }
-    }
-    
-    // Resources section
-    SDL_Rect resourcesSection = {resourcesX, sectionY, sectionW, sectionH};
-    SDL_SetRenderDrawColor(renderer, 30, 45, 30, 255);
-    SDL_RenderFillRect(renderer, &resourcesSection);
-    SDL_SetRenderDrawColor(renderer, 120, 140, 120, 255);
-    SDL_RenderDrawRect(renderer, &resourcesSection);
-    
-    renderText("Resources", resourcesX + 10, sectionY + 10);
-    
-    // Draw resource grid (3 columns, 10 rows) 
     int resourceCols = 3;
-    int resourceRows = 10;
-    int resourceGridStartX = resourcesX + 10;  // Better left margin
-    int resourceGridStartY = sectionY + 35;  // Better top margin
     
-    const auto& resourceInventory = itemSystem->getResourceInventory();
-    
-    for (int row = 0; row < resourceRows; row++) {
-        for (int col = 0; col < resourceCols; col++) {
-            int slotIndex = row * resourceCols + col;
-            if (slotIndex >= ItemSystem::RESOURCE_INVENTORY_SIZE) break;
-            
-            int slotX = resourceGridStartX + col * (slotSize + slotSpacing);
-            int slotY = resourceGridStartY + row * (slotSize + slotSpacing);
-            SDL_Rect slotRect = {slotX, slotY, slotSize, slotSize};
-            
-            // Slot background
-            SDL_SetRenderDrawColor(renderer, 50, 70, 50, 255);
-            SDL_RenderFillRect(renderer, &slotRect);
-            SDL_SetRenderDrawColor(renderer, 100, 120, 100, 255);
-            SDL_RenderDrawRect(renderer, &slotRect);
-            
-            // Resource icon and info
-            if (!resourceInventory[slotIndex].isEmpty()) {
-                Item* resource = resourceInventory[slotIndex].item;
-                
-                // Draw rarity border
-                SDL_Color rarityColor = resource->getRarityColor();
-                SDL_SetRenderDrawColor(renderer, rarityColor.r, rarityColor.g, rarityColor.b, 255);
-                SDL_RenderDrawRect(renderer, &slotRect);
-                
-                // Draw resource icon if available
-                Texture* icon = itemSystem->getItemIcon(resource->id);
-                if (icon) {
-                    SDL_Rect srcRect = {0, 0, 0, 0};
-                    SDL_QueryTexture(icon->getTexture(), nullptr, nullptr, &srcRect.w, &srcRect.h);
-                    SDL_Rect dstRect = {slotX + 2, slotY + 2, slotSize - 4, slotSize - 4};
-                    SDL_RenderCopy(renderer, icon->getTexture(), &srcRect, &dstRect);
-                }
-                
-                // Draw stack count (resources can stack high)
-                if (resource->currentStack > 1) {
-                    std::string stackText = std::to_string(resource->currentStack);
-                    renderText(stackText, slotX + slotSize - 15, slotY + slotSize - 15, {255, 255, 255, 255});
-                }
-            }
-            
-            // Check for mouse clicks on this resource slot
-            int mx, my;
-            Uint32 mouseState = SDL_GetMouseState(&mx, &my);
-            bool leftClick = (mouseState & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
-            bool rightClick = (mouseState & SDL_BUTTON(SDL_BUTTON_RIGHT)) != 0;
-            
-            if (mx >= slotX && mx <= slotX + slotSize && my >= slotY && my <= slotY + slotSize) {
-                if (leftClick) {
-                    hit.clickedResourceSlot = slotIndex;
-                }
-                if (rightClick) {
-                    hit.rightClicked = true;
-                    hit.clickedResourceSlot = slotIndex;
-                }
-                
-                // Show tooltip on hover for resources
-                if (!resourceInventory[slotIndex].isEmpty()) {
-                    Item* resource = resourceInventory[slotIndex].item;
-                    renderTooltip(resource->getTooltipText(), mx, my);
-                }
-            }
+    // Static layer: panel, sections and slot contents only change with the item system
+    int originX, originY;
+    if (renderer->beginPanel(INVENTORY_PANEL, panelW, panelH, itemSystem->getVersion(), panelX, panelY, originX, originY)) {
+        // Background panel
+        SDL_Rect panel = {originX, originY, panelW, panelH};
+        renderer->setDrawColor(40, 40, 60, 240);
+        renderer->fillRect(&panel);
+        renderer->setDrawColor(255, 255, 255, 255);
+        renderer->drawRect(&panel);
+        
+        // Title
+        renderTextCentered("Inventory", originX + panelW/2, originY + 20);
+        
+        // Close button (X in top right)
+        SDL_Rect closeRect = {originX + panelW - 40, originY + 10, 30, 30};
+        renderer->setDrawColor(160, 40, 40, 255);
+        renderer->fillRect(&closeRect);
+        renderer->setDrawColor(255, 255, 255, 255);
+        renderer->drawRect(&closeRect);
+        renderTextCentered("X", closeRect.x + closeRect.w/2, closeRect.y + closeRect.h/2);
+        
+        int localSectionY = originY + sectionY - panelY;
+        
+        // Equipment section
+        SDL_Rect equipmentSection = {originX + equipmentX - panelX, localSectionY, sectionW, sectionH};
+        renderer->setDrawColor(30, 30, 45, 255);
+        renderer->fillRect(&equipmentSection);
+        renderer->setDrawColor(120, 120, 140, 255);
+        renderer->drawRect(&equipmentSection);
+        renderText("Equipment", equipmentSection.x + 10, localSectionY + 10);
+        drawItemGrid(itemSystem, itemSystem->getItemInventory(), ItemSystem::INVENTORY_SIZE, equipmentCols,
+                     equipmentSection.x + 10, localSectionY + 35, {50, 50, 70, 255}, {100, 100, 120, 255});
+        
+        // Scrolls section
+        SDL_Rect scrollsSection = {originX + scrollsX - panelX, localSectionY, sectionW, sectionH};
+        renderer->setDrawColor(45, 30, 30, 255);
+        renderer->fillRect(&scrollsSection);
+        renderer->setDrawColor(140, 120, 120, 255);
+        renderer->drawRect(&scrollsSection);
+        renderText("Scrolls", scrollsSection.x + 10, localSectionY + 10);
+        drawItemGrid(itemSystem, itemSystem->getScrollInventory(), ItemSystem::SCROLL_INVENTORY_SIZE, scrollCols,
+                     scrollsSection.x + 10, localSectionY + 35, {70, 50, 50, 255}, {120, 100, 100, 255});
+        
+        // Resources section
+        SDL_Rect resourcesSection = {originX + resourcesX - panelX, localSectionY, sectionW, sectionH};
+        renderer->setDrawColor(30, 45, 30, 255);
+        renderer->fillRect(&resourcesSection);
+        renderer->setDrawColor(120, 140, 120, 255);
+        renderer->drawRect(&resourcesSection);
+        renderText("Resources", resourcesSection.x + 10, localSectionY + 10);
+        drawItemGrid(itemSystem, itemSystem->getResourceInventory(), ItemSystem::RESOURCE_INVENTORY_SIZE, resourceCols,
+                     resourcesSection.x + 10, localSectionY + 35, {50, 70, 50, 255}, {100, 120, 100, 255});
+    }
+    renderer->endPanel(INVENTORY_PANEL, panelX, panelY);
+    
+    // Hit testing works on the slot geometry directly, independent of whether the panel was redrawn
+    int mx = pointerX, my = pointerY;
+    bool leftClick = (pointerButtons & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
+    bool rightClick = (pointerButtons & SDL_BUTTON(SDL_BUTTON_RIGHT)) != 0;
+    
+    auto slotAt = [&](int gridX, int gridY, int cols, int count) -> int {
+        int relX = mx - gridX;
+        int relY = my - gridY;
+        if (relX < 0 || relY < 0) return -1;
+        int stride = slotSize + slotSpacing;
+        int col = relX / stride;
+        int row = relY / stride;
+        if (col >= cols || relX - col * stride > slotSize || relY - row * stride > slotSize) return -1;
+        int slotIndex = row * cols + col;
+        return slotIndex < count ? slotIndex : -1;
+    };
+    auto handleSlot = [&](int slotIndex, const std::vector<InventorySlot>& slots, int& outSlot) {
+        if (slotIndex < 0) return;
+        if (leftClick) {
+            outSlot = slotIndex;
         }
-    }
+        if (rightClick) {
+            hit.rightClicked = true;
+            outSlot = slotIndex;
+        }
+        // Show tooltip on hover
+        if (!slots[slotIndex].isEmpty()) {
+            renderTooltip(slots[slotIndex].item->getTooltipText(), mx, my);
+        }
+    };
+    handleSlot(slotAt(equipmentX + 10, sectionY + 35, equipmentCols, ItemSystem::INVENTORY_SIZE),
+               itemSystem->getItemInventory(), hit.clickedItemSlot);
+    handleSlot(slotAt(scrollsX + 10, sectionY + 35, scrollCols, ItemSystem::SCROLL_INVENTORY_SIZE),
+               itemSystem->getScrollInventory(), hit.clickedScrollSlot);
+    handleSlot(slotAt(resourcesX + 10, sectionY + 35, resourceCols, ItemSystem::RESOURCE_INVENTORY_SIZE),
+               itemSystem->getResourceInventory(), hit.clickedResourceSlot);
     
-    // Handle close button and ESC key
-    int mx, my;
-    Uint32 mouseState = SDL_GetMouseState(&mx, &my);
-    bool leftClick = (mouseState & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
+    // Close button (X in top right)
+    SDL_Rect closeBtn = {panelX + panelW - 40, panelY + 10, 30, 30};
     
+    // Handle close button and ESC key
     // Check title bar for dragging (top 40 pixels of panel, excluding close button)
     SDL_Rect titleBar = {panelX, panelY, panelW - 60, 40};  // Leave space for close button
     if (leftClick && mx >= titleBar.x && mx <= titleBar.x + titleBar.w && 
@@ -1492,8 +1405,7 @@ UISystem::InventoryHit UISystem::renderEnhancedInventory(Player* player, bool& i
     }
     
     // ESC key to close
-    const Uint8* keystate = SDL_GetKeyboardState(nullptr);
-    if (keystate[SDL_SCANCODE_ESCAPE]) {
+    if (escapeHeld) {
         isOpen = false;
         hit.clickedClose = true;
     }
@@ -1507,7 +1419,7 @@ UISystem::EquipmentHit UISystem::renderEquipmentUI(Player* player, bool& isOpen,
     
     // Get screen dimensions
     int screenW, screenH;
-    SDL_GetRendererOutputSize(renderer, &screenW, &screenH);
+    renderer->getOutputSize(&screenW, &screenH);
     
     // Equipment panel - use custom position if set, otherwise use default positioning
     int panelW = 600;
@@ -1535,23 +1447,43 @@ UISystem::EquipmentHit UISystem::renderEquipmentUI(Player* player, bool& isOpen,
         }
     }
     
-    // Background panel
-    SDL_Rect panel = {panelX, panelY, panelW, panelH};
-    SDL_SetRenderDrawColor(renderer, 60, 40, 40, 240);
-    SDL_RenderFillRect(renderer, &panel);
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &panel);
+    // Get ItemSystem once for all slots
+    ItemSystem* itemSystem = player->getItemSystem();
     
-    // Title
-    renderTextCentered("Equipment & Stats", panelX + panelW/2, panelY + 20);
+    // Static layer is redrawn only when equipped items or their upgrades change;
+    // drawing is offset by (offX, offY) so it lands in the cached texture
+    uint64_t panelKey = hashCombine(itemSystem ? itemSystem->getVersion() : 0, player->getEquipmentVersion());
+    int originX, originY;
+    bool redraw = renderer->beginPanel(EQUIPMENT_PANEL, panelW, panelH, panelKey, panelX, panelY, originX, originY);
+    int offX = originX - panelX;
+    int offY = originY - panelY;
     
     // Close button
     SDL_Rect closeBtn = {panelX + panelW - 40, panelY + 10, 30, 30};
-    SDL_SetRenderDrawColor(renderer, 160, 40, 40, 255);
-    SDL_RenderFillRect(renderer, &closeBtn);
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &closeBtn);
-    renderTextCentered("X", closeBtn.x + closeBtn.w/2, closeBtn.y + closeBtn.h/2);
+    
+    if (redraw) {
+        // Background panel
+        SDL_Rect panel = {originX, originY, panelW, panelH};
+        renderer->setDrawColor(60, 40, 40, 240);
+        renderer->fillRect(&panel);
+        renderer->setDrawColor(255, 255, 255, 255);
+        renderer->drawRect(&panel);
+        
+        // Title
+        renderTextCentered("Equipment & Stats", originX + panelW/2, originY + 20);
+        
+        SDL_Rect closeRect = {closeBtn.x + offX, closeBtn.y + offY, closeBtn.w, closeBtn.h};
+        renderer->setDrawColor(160, 40, 40, 255);
+        renderer->fillRect(&closeRect);
+        renderer->setDrawColor(255, 255, 255, 255);
+        renderer->drawRect(&closeRect);
+        renderTextCentered("X", closeRect.x + closeRect.w/2, closeRect.y + closeRect.h/2);
+    }
+    
+    int mx = pointerX, my = pointerY;
+    bool leftClick = (pointerButtons & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
+    bool rightClick = (pointerButtons & SDL_BUTTON(SDL_BUTTON_RIGHT)) != 0;
+    std::string tooltipText;
     
     // Equipment slots layout (3x3 grid plus stats)
     int equipX = panelX + 50;
@@ -1578,19 +1510,23 @@ UISystem::EquipmentHit UISystem::renderEquipmentUI(Player* player, bool& isOpen,
         {equipX + (slotSize + slotSpacing) * 2, equipY + (slotSize + slotSpacing) * 3}  // Boots (row 4, right) - slot 8
     };
     
-    // Get ItemSystem once for all slots
-    ItemSystem* itemSystem = player->getItemSystem();
-    
     for (int i = 0; i < 9; i++) {
-        int slotX = slotPositions[i][0];
-        int slotY = slotPositions[i][1];
+        int hitX = slotPositions[i][0];
+        int hitY = slotPositions[i][1];
+        bool hovered = mx >= hitX && mx <= hitX + slotSize && my >= hitY && my <= hitY + slotSize;
+        if (!redraw && !hovered) continue;
+        
+        int slotX = hitX + offX;
+        int slotY = hitY + offY;
         SDL_Rect slotRect = {slotX, slotY, slotSize, slotSize};
         
         // Slot background
-        SDL_SetRenderDrawColor(renderer, 70, 50, 70, 255);
-        SDL_RenderFillRect(renderer, &slotRect);
-        SDL_SetRenderDrawColor(renderer, 120, 100, 120, 255);
-        SDL_RenderDrawRect(renderer, &slotRect);
+        if (redraw) {
+            renderer->setDrawColor(70, 50, 70, 255);
+            renderer->fillRect(&slotRect);
+            renderer->setDrawColor(120, 100, 120, 255);
+            renderer->drawRect(&slotRect);
+        }
         
         // Get equipped item from ItemSystem first, fallback to Player equipment
         Item* equippedItem = nullptr;
@@ -1610,11 +1546,24 @@ UISystem::EquipmentHit UISystem::renderEquipmentUI(Player* player, bool& isOpen,
             }
         }
         
-        // Variables for displaying item info
-        std::string tooltipText;
+        // Tooltip for the hovered slot, drawn after the panel is composited
+        if (hovered) {
+            if (equippedItem) {
+                tooltipText = equippedItem->getTooltipText();
+            } else if (playerEquipItem) {
+                tooltipText = playerEquipItem->name + " (+" + std::to_string(playerEquipItem->plusLevel) + ")";
+            }
+            if (leftClick) {
+                hit.clickedEquipSlot = i;
+            }
+            if (rightClick) {
+                hit.rightClicked = true;
+                hit.clickedEquipSlot = i;
+            }
+        }
         
         // Draw equipped item if one exists
-        if (equippedItem || playerEquipItem) {
+        if (redraw && (equippedItem || playerEquipItem)) {
             // Map equipment slot to icon path
             std::string iconPath;
             switch (static_cast<Player::EquipmentSlot>(i)) {
@@ -1657,11 +1606,9 @@ UISystem::EquipmentHit UISystem::renderEquipmentUI(Player* player, bool& isOpen,
                 icon = itemSystem->getItemIcon(equippedItem->id);
                 plusLevel = equippedItem->plusLevel;
                 rarityColor = equippedItem->getRarityColor();
-                tooltipText = equippedItem->getTooltipText();
             } else if (playerEquipItem) {
                 // Player equipment item
                 plusLevel = playerEquipItem->plusLevel;
-                tooltipText = playerEquipItem->name + " (+" + std::to_string(plusLevel) + ")";
             }
             
             // Fallback to slot-specific icon if no ItemSystem icon
@@ -1673,7 +1620,7 @@ UISystem::EquipmentHit UISystem::renderEquipmentUI(Player* player, bool& isOpen,
             if (icon) {
                 int pad = 4;
                 SDL_Rect iconRect = {slotX + pad, slotY + pad, slotSize - pad*2, slotSize - pad*2};
-                SDL_RenderCopy(renderer, icon->getTexture(), nullptr, &iconRect);
+                renderer->copy(icon->getTexture(), nullptr, &iconRect);
             }
             
             // Draw +level for all equipment (including +0)
@@ -1684,9 +1631,9 @@ UISystem::EquipmentHit UISystem::renderEquipmentUI(Player* player, bool& isOpen,
             
             // Draw rarity border (only for ItemSystem items)
             if (equippedItem) {
-                SDL_SetRenderDrawColor(renderer, rarityColor.r, rarityColor.g, rarityColor.b, 255);
+                renderer->setDrawColor(rarityColor.r, rarityColor.g, rarityColor.b, 255);
                 SDL_Rect borderRect = {slotX - 2, slotY - 2, slotSize + 4, slotSize + 4};
-                SDL_RenderDrawRect(renderer, &borderRect);
+                renderer->drawRect(&borderRect);
             }
             
             // Draw elemental indicators
@@ -1694,121 +1641,103 @@ UISystem::EquipmentHit UISystem::renderEquipmentUI(Player* player, bool& isOpen,
             if (equippedItem) {
                 // ItemSystem item elemental indicators
                 if (equippedItem->stats.fireAttack > 0) {
-                    SDL_SetRenderDrawColor(renderer, 255, 100, 100, 255);
+                    renderer->setDrawColor(255, 100, 100, 255);
                     SDL_Rect fireRect = {slotX + 2, indicatorY, 8, 4};
-                    SDL_RenderFillRect(renderer, &fireRect);
+                    renderer->fillRect(&fireRect);
                     indicatorY += 6;
                 }
                 if (equippedItem->stats.waterAttack > 0) {
-                    SDL_SetRenderDrawColor(renderer, 100, 200, 255, 255);
+                    renderer->setDrawColor(100, 200, 255, 255);
                     SDL_Rect iceRect = {slotX + 2, indicatorY, 8, 4};
-                    SDL_RenderFillRect(renderer, &iceRect);
+                    renderer->fillRect(&iceRect);
                     indicatorY += 6;
                 }
                 if (equippedItem->stats.poisonAttack > 0) {
-                    SDL_SetRenderDrawColor(renderer, 100, 255, 100, 255);
+                    renderer->setDrawColor(100, 255, 100, 255);
                     SDL_Rect poisonRect = {slotX + 2, indicatorY, 8, 4};
-                    SDL_RenderFillRect(renderer, &poisonRect);
+                    renderer->fillRect(&poisonRect);
                 }
             } else if (playerEquipItem) {
                 // Player equipment elemental indicators
                 if (playerEquipItem->fire > 0) {
-                    SDL_SetRenderDrawColor(renderer, 255, 100, 100, 255);
+                    renderer->setDrawColor(255, 100, 100, 255);
                     SDL_Rect fireRect = {slotX + 2, indicatorY, 8, 4};
-                    SDL_RenderFillRect(renderer, &fireRect);
+                    renderer->fillRect(&fireRect);
                     indicatorY += 6;
                 }
                 if (playerEquipItem->ice > 0) {
-                    SDL_SetRenderDrawColor(renderer, 100, 200, 255, 255);
+                    renderer->setDrawColor(100, 200, 255, 255);
                     SDL_Rect iceRect = {slotX + 2, indicatorY, 8, 4};
-                    SDL_RenderFillRect(renderer, &iceRect);
+                    renderer->fillRect(&iceRect);
                     indicatorY += 6;
                 }
                 if (playerEquipItem->poison > 0) {
-                    SDL_SetRenderDrawColor(renderer, 100, 255, 100, 255);
+                    renderer->setDrawColor(100, 255, 100, 255);
                     SDL_Rect poisonRect = {slotX + 2, indicatorY, 8, 4};
-                    SDL_RenderFillRect(renderer, &poisonRect);
+                    renderer->fillRect(&poisonRect);
                 }
             }
         }
-        
-        // Check for mouse clicks on equipment slot
-        int mx, my;
-        Uint32 mouseState = SDL_GetMouseState(&mx, &my);
-        bool leftClick = (mouseState & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
-        bool rightClick = (mouseState & SDL_BUTTON(SDL_BUTTON_RIGHT)) != 0;
-        
-        if (mx >= slotX && mx <= slotX + slotSize && my >= slotY && my <= slotY + slotSize) {
-            if (leftClick) {
-                hit.clickedEquipSlot = i;
-            }
-            if (rightClick) {
-                hit.rightClicked = true;
-                hit.clickedEquipSlot = i;
-            }
-            
-            // Show tooltip on hover for equipped items
-            if (!tooltipText.empty()) {
-                renderTooltip(tooltipText, mx, my);
-            }
-        }
     }
     
-    // Stats display - use ItemSystem's calculation
-    ItemStats totalStats;
-    if (itemSystem) {
-        totalStats = itemSystem->calculateTotalStats();
-    }
-    int statsX = panelX + 350;
-    int statsY = panelY + 80;
-    int lineHeight = 25;
+    // Stats display - use ItemSystem's calculation (only when the panel is redrawn)
+    if (redraw) {
+        ItemStats totalStats;
+        if (itemSystem) {
+            totalStats = itemSystem->getTotalStats();
+        }
+        int statsX = originX + 350;
+        int statsY = originY + 80;
+        int lineHeight = 25;
     
-    renderText("Total Stats:", statsX, statsY, {255, 255, 100, 255});
-    statsY += lineHeight + 10;
+        renderText("Total Stats:", statsX, statsY, {255, 255, 100, 255});
+        statsY += lineHeight + 10;
     
-    if (totalStats.attack > 0) {
-        renderText("Attack: +" + std::to_string(totalStats.attack), statsX, statsY);
-        statsY += lineHeight;
-    }
-    if (totalStats.defense > 0) {
-        renderText("Defense: +" + std::to_string(totalStats.defense), statsX, statsY);
-        statsY += lineHeight;
-    }
-    if (totalStats.health > 0) {
-        renderText("Health: +" + std::to_string(totalStats.health), statsX, statsY);
-        statsY += lineHeight;
-    }
-    if (totalStats.mana > 0) {
-        renderText("Mana: +" + std::to_string(totalStats.mana), statsX, statsY);
-        statsY += lineHeight;
-    }
-    if (totalStats.strength > 0) {
-        renderText("Strength: +" + std::to_string(totalStats.strength), statsX, statsY);
-        statsY += lineHeight;
-    }
-    if (totalStats.intelligence > 0) {
-        renderText("Intelligence: +" + std::to_string(totalStats.intelligence), statsX, statsY);
-        statsY += lineHeight;
-    }
+        if (totalStats.attack > 0) {
+            renderText("Attack: +" + std::to_string(totalStats.attack), statsX, statsY);
+            statsY += lineHeight;
+        }
+        if (totalStats.defense > 0) {
+            renderText("Defense: +" + std::to_string(totalStats.defense), statsX, statsY);
+            statsY += lineHeight;
+        }
+        if (totalStats.health > 0) {
+            renderText("Health: +" + std::to_string(totalStats.health), statsX, statsY);
+            statsY += lineHeight;
+        }
+        if (totalStats.mana > 0) {
+            renderText("Mana: +" + std::to_string(totalStats.mana), statsX, statsY);
+            statsY += lineHeight;
+        }
+        if (totalStats.strength > 0) {
+            renderText("Strength: +" + std::to_string(totalStats.strength), statsX, statsY);
+            statsY += lineHeight;
+        }
+        if (totalStats.intelligence > 0) {
+            renderText("Intelligence: +" + std::to_string(totalStats.intelligence), statsX, statsY);
+            statsY += lineHeight;
+        }
     
-    // Elemental stats
-    if (totalStats.fireAttack > 0) {
-        renderText("Fire Attack: +" + std::to_string(totalStats.fireAttack), statsX, statsY, {255, 100, 100, 255});
-        statsY += lineHeight;
-    }
-    if (totalStats.waterAttack > 0) {
-        renderText("Water Attack: +" + std::to_string(totalStats.waterAttack), statsX, statsY, {100, 100, 255, 255});
-        statsY += lineHeight;
-    }
-    if (totalStats.poisonAttack > 0) {
-        renderText("Poison Attack: +" + std::to_string(totalStats.poisonAttack), statsX, statsY, {100, 255, 100, 255});
-        statsY += lineHeight;
+        // Elemental stats
+        if (totalStats.fireAttack > 0) {
+            renderText("Fire Attack: +" + std::to_string(totalStats.fireAttack), statsX, statsY, {255, 100, 100, 255});
+            statsY += lineHeight;
+        }
+        if (totalStats.waterAttack > 0) {
+            renderText("Water Attack: +" + std::to_string(totalStats.waterAttack), statsX, statsY, {100, 100, 255, 255});
+            statsY += lineHeight;
+        }
+        if (totalStats.poisonAttack > 0) {
+            renderText("Poison Attack: +" + std::to_string(totalStats.poisonAttack), statsX, statsY, {100, 255, 100, 255});
+            statsY += lineHeight;
+        }
     }
+    renderer->endPanel(EQUIPMENT_PANEL, panelX, panelY);
     
-    // Handle input
-    int mx, my;
-    Uint32 mouseState = SDL_GetMouseState(&mx, &my);
-    bool leftClick = (mouseState & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
+    // Show tooltip on hover for equipped items
+    if (!tooltipText.empty()) {
+        renderTooltip(tooltipText, mx, my);
+    }
     
     // Check title bar for dragging (top 40 pixels of panel, excluding close button)
     SDL_Rect titleBar = {panelX, panelY, panelW - 60, 40};  // Leave space for close button
@@ -1827,8 +1756,7 @@ UISystem::EquipmentHit UISystem::renderEquipmentUI(Player* player, bool& isOpen,
     }
     
     // ESC key to close
-    const Uint8* keystate = SDL_GetKeyboardState(nullptr);
-    if (keystate[SDL_SCANCODE_ESCAPE]) {
+    if (escapeHeld) {
         isOpen = false;
         hit.clickedClose = true;
     }
@@ -1857,7 +1785,7 @@ void UISystem::renderTooltip(const std::string& tooltipText, int mouseX, int mou
     
     // Position tooltip always ABOVE the mouse/item, keep on screen
     int screenW, screenH;
-    SDL_GetRendererOutputSize(renderer, &screenW, &screenH);
+    renderer->getOutputSize(&screenW, &screenH);
     
     // Always position tooltip above the mouse cursor
     int tooltipX = mouseX - tooltipW / 2;  // Center horizontally on mouse
@@ -1872,10 +1800,10 @@ void UISystem::renderTooltip(const std::string& tooltipText, int mouseX, int mou
     
     // Draw tooltip background
     SDL_Rect tooltipRect = {tooltipX, tooltipY, tooltipW, tooltipH};
-    SDL_SetRenderDrawColor(renderer, 20, 20, 20, 240);
-    SDL_RenderFillRect(renderer, &tooltipRect);
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &tooltipRect);
+    renderer->setDrawColor(20, 20, 20, 240);
+    renderer->fillRect(&tooltipRect);
+    renderer->setDrawColor(255, 255, 255, 255);
+    renderer->drawRect(&tooltipRect);
     
     // Draw tooltip text
     for (size_t i = 0; i < lines.size(); i++) {
@@ -1888,7 +1816,7 @@ void UISystem::renderSkillBar(const Player* player) {
     
     // Get actual screen dimensions for both fullscreen and windowed mode
     int screenW, screenH;
-    SDL_GetRendererOutputSize(renderer, &screenW, &screenH);
+    renderer->getOutputSize(&screenW, &screenH);
     
     int barWidth = SKILL_BAR_COLS * (SKILL_SLOT_SIZE + SKILL_SLOT_PADDING);
     int barHeight = SKILL_BAR_ROWS * (SKILL_SLOT_SIZE + SKILL_SLOT_PADDING);
@@ -1904,12 +1832,12 @@ void UISystem::renderSkillBar(const Player* player) {
         barWidth + 20,
         barHeight + 20
     };
-    SDL_SetRenderDrawColor(renderer, 20, 20, 30, 200);
-    SDL_RenderFillRect(renderer, &barBg);
+    renderer->setDrawColor(20, 20, 30, 200);
+    renderer->fillRect(&barBg);
     
     // Draw border
-    SDL_SetRenderDrawColor(renderer, 100, 100, 120, 255);
-    SDL_RenderDrawRect(renderer, &barBg);
+    renderer->setDrawColor(100, 100, 120, 255);
+    renderer->drawRect(&barBg);
     
     // Get available spells from spell system
     auto spellSystem = player->getSpellSystem();
@@ -1936,19 +1864,19 @@ void UISystem::renderSkillBar(const Player* player) {
             
             // Draw slot background
             SDL_Rect slotRect = {x, y, SKILL_SLOT_SIZE, SKILL_SLOT_SIZE};
-            SDL_SetRenderDrawColor(renderer, 40, 40, 50, 255);
-            SDL_RenderFillRect(renderer, &slotRect);
+            renderer->setDrawColor(40, 40, 50, 255);
+            renderer->fillRect(&slotRect);
             
             // Draw slot border
-            SDL_SetRenderDrawColor(renderer, 80, 80, 100, 255);
-            SDL_RenderDrawRect(renderer, &slotRect);
+            renderer->setDrawColor(80, 80, 100, 255);
+            renderer->drawRect(&slotRect);
             
             // Special slots for dash and fire shield (swapped)
             if (slotIndex == 0) {
                 // Dash ability (Spacebar key)
                 auto* dashTex = assetManager->getTexture(dashIcon);
                 if (dashTex) {
-                    SDL_RenderCopy(renderer, dashTex->getTexture(), nullptr, &slotRect);
+                    renderer->copy(dashTex->getTexture(), nullptr, &slotRect);
                 }
                 
                 // Render cooldown overlay if on cooldown
@@ -1957,8 +1885,8 @@ void UISystem::renderSkillBar(const Player* player) {
                     float cooldownPercent = dashCooldown / player->getDashCooldownMax();
                     int overlayHeight = static_cast<int>(SKILL_SLOT_SIZE * cooldownPercent);
                     SDL_Rect cooldownRect = {x, y + SKILL_SLOT_SIZE - overlayHeight, SKILL_SLOT_SIZE, overlayHeight};
-                    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
-                    SDL_RenderFillRect(renderer, &cooldownRect);
+                    renderer->setDrawColor(0, 0, 0, 180);
+                    renderer->fillRect(&cooldownRect);
                     
                     // Render cooldown text
                     char cooldownText[8];
@@ -1973,7 +1901,7 @@ void UISystem::renderSkillBar(const Player* player) {
                 // Fire shield ability (F key)
                 auto* shieldTex = assetManager->getTexture(fireShieldIcon);
                 if (shieldTex) {
-                    SDL_RenderCopy(renderer, shieldTex->getTexture(), nullptr, &slotRect);
+                    renderer->copy(shieldTex->getTexture(), nullptr, &slotRect);
                 }
                 renderText("F", x + 2, y + SKILL_SLOT_SIZE - 14, {255, 255, 100, 255});
             }
@@ -1987,7 +1915,7 @@ void UISystem::renderSkillBar(const Player* player) {
                 if (iconIt != spellIcons.end()) {
                     auto* spellTex = assetManager->getTexture(iconIt->second);
                     if (spellTex) {
-                        SDL_RenderCopy(renderer, spellTex->getTexture(), nullptr, &slotRect);
+                        renderer->copy(spellTex->getTexture(), nullptr, &slotRect);
                     }
                 }
                 
@@ -1997,8 +1925,8 @@ void UISystem::renderSkillBar(const Player* player) {
                     float cooldownPercent = spellSystem->getCooldownPercent(spellType);
                     int overlayHeight = static_cast<int>(SKILL_SLOT_SIZE * cooldownPercent);
                     SDL_Rect cooldownRect = {x, y + SKILL_SLOT_SIZE - overlayHeight, SKILL_SLOT_SIZE, overlayHeight};
-                    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
-                    SDL_RenderFillRect(renderer, &cooldownRect);
+                    renderer->setDrawColor(0, 0, 0, 180);
+                    renderer->fillRect(&cooldownRect);
                     
                     // Render cooldown text
                     char cooldownText[8];
@@ -2010,8 +1938,8 @@ void UISystem::renderSkillBar(const Player* player) {
                 int manaCost = spellSystem->getSpellManaCost(spellType);
                 if (player->getMana() < manaCost) {
                     // Tint red if not enough mana
-                    SDL_SetRenderDrawColor(renderer, 100, 0, 0, 100);
-                    SDL_RenderFillRect(renderer, &slotRect);
+                    renderer->setDrawColor(100, 0, 0, 100);
+                    renderer->fillRect(&slotRect);
                 }
                 
                 // Render hotkey (3-6 or Q,E,R,F+)
@@ -2029,7 +1957,7 @@ void UISystem::renderSpellBook(const Player* player, int mouseX, int mouseY, boo
     
     // Get actual screen dimensions
     int screenW, screenH;
-    SDL_GetRendererOutputSize(renderer, &screenW, &screenH);
+    renderer->getOutputSize(&screenW, &screenH);
     
     // Spell book window dimensions - larger for better layout
     int bookWidth = 800;
@@ -2037,26 +1965,6 @@ void UISystem::renderSpellBook(const Player* player, int mouseX, int mouseY, boo
     int bookX = (screenW - bookWidth) / 2;
     int bookY = (screenH - bookHeight) / 2;
     
-    // Draw main background
-    SDL_Rect bookBg = {bookX, bookY, bookWidth, bookHeight};
-    SDL_SetRenderDrawColor(renderer, 20, 15, 30, 250);
-    SDL_RenderFillRect(renderer, &bookBg);
-    
-    // Draw decorative border
-    SDL_SetRenderDrawColor(renderer, 180, 140, 70, 255);
-    for (int i = 0; i < 4; i++) {
-        SDL_Rect border = {bookX - i, bookY - i, bookWidth + i*2, bookHeight + i*2};
-        SDL_RenderDrawRect(renderer, &border);
-    }
-    
-    // Title with enhanced styling
-    renderTextCentered("ARCANE SPELL COMPENDIUM", bookX + bookWidth/2, bookY + 15, {255, 215, 0, 255});
-    
-    // Tab system for spell schools
-    int tabHeight = 40;
-    int tabWidth = bookWidth / 4;
-    int tabY = bookY + 45;
-    
     // Static tab selection (for now, will be interactive later)
     static int selectedTab = 0; // 0=Fire, 1=Water, 2=Poison, 3=Lightning
     
@@ -2088,44 +1996,6 @@ void UISystem::renderSpellBook(const Player* player, int mouseX, int mouseY, boo
         }
     }
     
-    // Render tabs
-    for (int i = 0; i < 4; i++) {
-        int tabX = bookX + i * tabWidth;
-        bool isSelected = (i == selectedTab);
-        bool isActive = (tabs[i].element == activeElement && tabs[i].enchantLevel > 0);
-        
-        // Tab background
-        SDL_Color bgColor = isSelected ? SDL_Color{60, 50, 80, 255} : SDL_Color{40, 35, 55, 255};
-        if (isActive) {
-            bgColor.r = std::min(255, bgColor.r + 20);
-            bgColor.g = std::min(255, bgColor.g + 20);
-            bgColor.b = std::min(255, bgColor.b + 20);
-        }
-        
-        SDL_Rect tabRect = {tabX, tabY, tabWidth, tabHeight};
-        SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
-        SDL_RenderFillRect(renderer, &tabRect);
-        
-        // Tab border
-        SDL_Color borderColor = isSelected ? tabs[i].color : SDL_Color{100, 100, 100, 255};
-        SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
-        SDL_RenderDrawRect(renderer, &tabRect);
-        
-        // Tab text
-        SDL_Color textColor = isActive ? tabs[i].color : SDL_Color{150, 150, 150, 255};
-        char tabText[32];
-        if (tabs[i].enchantLevel > 0) {
-            snprintf(tabText, sizeof(tabText), "%s +%d", tabs[i].name, tabs[i].enchantLevel);
-        } else {
-            snprintf(tabText, sizeof(tabText), "%s", tabs[i].name);
-        }
-        renderTextCentered(tabText, tabX + tabWidth/2, tabY + tabHeight/2 - 8, textColor);
-    }
-    
-    // Content area
-    int contentY = tabY + tabHeight + 20;
-    int contentHeight = bookHeight - (contentY - bookY) - 40;
-    
     // Current tab spell grid
     TabInfo& currentTab = tabs[selectedTab];
     
@@ -2160,282 +2030,368 @@ void UISystem::renderSpellBook(const Player* player, int mouseX, int mouseY, boo
         };
     }
     
-    // Spell grid layout - Active spells in top row (4), passives in bottom row (3)
-    int spellSize = 64;
-    int spellSpacing = 80;
-    int gridStartX = bookX + 60;
-    int gridStartY = contentY + 40;
-    
     // Ensure selected spell index is valid for current tab
     if (selectedSpellIndex >= static_cast<int>(spells.size())) {
         selectedSpellIndex = 0;
     }
     
-    // Add section headers
-    renderText("ACTIVE SPELLS", gridStartX, gridStartY - 25, {255, 200, 100, 255});
-    renderText("PASSIVE ABILITIES", gridStartX, gridStartY + spellSize + 60, {255, 200, 100, 255});
-    
-    for (size_t i = 0; i < spells.size(); i++) {
-        auto [spellType, reqLevel, iconFile] = spells[i];
-        
+    // Spell grid layout - Active spells in top row (4), passives in bottom row (3)
+    int spellSize = 64;
+    int spellSpacing = 80;
+    auto spellIconPos = [&](size_t i, int gridStartX, int gridStartY, int& spellX, int& spellY) {
         int col, row;
         if (i < 4) {
             // Active spells: top row (4 columns)
-            col = i % 4;
+            col = static_cast<int>(i % 4);
             row = 0;
         } else {
             // Passive abilities: bottom row (3 columns, centered)
-            col = (i - 4) % 3;
+            col = static_cast<int>((i - 4) % 3);
             row = 1;
         }
-        
-        int spellX = gridStartX + col * spellSpacing;
-        int spellY = gridStartY + row * (spellSize + 80); // Extra spacing between rows
-        
+        spellX = gridStartX + col * spellSpacing;
+        spellY = gridStartY + row * (spellSize + 80); // Extra spacing between rows
         // Center the passive abilities row
         if (i >= 4) {
             spellX += spellSpacing / 2; // Offset to center 3 items
         }
-        
-        bool unlocked = currentTab.enchantLevel >= reqLevel;
-        bool isActive = (currentTab.element == activeElement);
-        
-        // Spell icon background
-        SDL_Rect iconBg = {spellX - 5, spellY - 5, spellSize + 10, spellSize + 10};
-        SDL_Color bgColor = unlocked ? SDL_Color{60, 60, 60, 200} : SDL_Color{30, 30, 30, 200};
-        SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
-        SDL_RenderFillRect(renderer, &iconBg);
-        
-        // Check for mouse click on this spell icon
-        bool isSelected = (static_cast<int>(i) == selectedSpellIndex);
-        if (mouseClicked) {
+    };
+    
+    // Selection is resolved before drawing so the cached page always shows the current spell
+    if (mouseClicked) {
+        int gridStartX = bookX + 60;
+        int gridStartY = bookY + 45 + 40 + 20 + 40; // tabs + content margin + header
+        for (size_t i = 0; i < spells.size(); i++) {
+            int spellX, spellY;
+            spellIconPos(i, gridStartX, gridStartY, spellX, spellY);
             SDL_Rect clickArea = {spellX - 5, spellY - 5, spellSize + 10, spellSize + 10};
             if (mouseX >= clickArea.x && mouseX <= clickArea.x + clickArea.w &&
                 mouseY >= clickArea.y && mouseY <= clickArea.y + clickArea.h) {
                 selectedSpellIndex = static_cast<int>(i);
-                isSelected = true;
             }
         }
+    }
+    
+    // The page only changes with selection, element, enchant levels and the shown cooldown (0.1s steps)
+    uint64_t pageKey = hashCombine(static_cast<uint64_t>(selectedTab), static_cast<uint64_t>(selectedSpellIndex));
+    pageKey = hashCombine(pageKey, static_cast<uint64_t>(activeElement));
+    pageKey = hashCombine(pageKey, player->getEquipmentVersion());
+    if (selectedSpellIndex < static_cast<int>(spells.size())) {
+        float cooldown = spellSystem->getCooldownRemaining(std::get<0>(spells[selectedSpellIndex]));
+        pageKey = hashCombine(pageKey, static_cast<uint64_t>(std::lround(cooldown * 10.0f)));
+    }
+    
+    // The decorative border extends a few pixels outside the book, so the cached page has a margin
+    const int margin = 4;
+    int originX, originY;
+    if (renderer->beginPanel(SPELL_BOOK_PANEL, bookWidth + margin * 2, bookHeight + margin * 2, pageKey,
+                   bookX - margin, bookY - margin, originX, originY)) {
+        int pageX = originX + margin;
+        int pageY = originY + margin;
         
-        // Spell icon border with selection highlighting
-        bool isPassiveAbility = (spellType == SpellType::FIRE_MASTERY || 
-                                 spellType == SpellType::BURNING_AURA || 
-                                 spellType == SpellType::INFERNO_LORD);
-        
-        SDL_Color borderColor = unlocked ? currentTab.color : SDL_Color{80, 80, 80, 255};
-        if (unlocked && isActive) {
-            borderColor = {255, 255, 255, 255}; // White border for available spells
+        // Draw main background
+        SDL_Rect bookBg = {pageX, pageY, bookWidth, bookHeight};
+        renderer->setDrawColor(20, 15, 30, 250);
+        renderer->fillRect(&bookBg);
+    
+        // Draw decorative border
+        renderer->setDrawColor(180, 140, 70, 255);
+        for (int i = 0; i < 4; i++) {
+            SDL_Rect border = {pageX - i, pageY - i, bookWidth + i*2, bookHeight + i*2};
+            renderer->drawRect(&border);
         }
-        if (isPassiveAbility && unlocked) {
-            borderColor = {180, 100, 255, 255}; // Purple border for passive abilities
-        }
-        if (isSelected) {
-            borderColor = {255, 255, 0, 255}; // Yellow border for selected spell
-            // Add extra thick border for selected spell
-            for (int thickness = 0; thickness < 3; thickness++) {
-                SDL_Rect thickBorder = {
-                    spellX - 5 - thickness, 
-                    spellY - 5 - thickness, 
-                    spellSize + 10 + thickness*2, 
-                    spellSize + 10 + thickness*2
-                };
-                SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
-                SDL_RenderDrawRect(renderer, &thickBorder);
+    
+        // Title with enhanced styling
+        renderTextCentered("ARCANE SPELL COMPENDIUM", pageX + bookWidth/2, pageY + 15, {255, 215, 0, 255});
+    
+        // Tab system for spell schools
+        int tabHeight = 40;
+        int tabWidth = bookWidth / 4;
+        int tabY = pageY + 45;
+    
+        // Render tabs
+        for (int i = 0; i < 4; i++) {
+            int tabX = pageX + i * tabWidth;
+            bool isSelected = (i == selectedTab);
+            bool isActive = (tabs[i].element == activeElement && tabs[i].enchantLevel > 0);
+        
+            // Tab background
+            SDL_Color bgColor = isSelected ? SDL_Color{60, 50, 80, 255} : SDL_Color{40, 35, 55, 255};
+            if (isActive) {
+                bgColor.r = std::min(255, bgColor.r + 20);
+                bgColor.g = std::min(255, bgColor.g + 20);
+                bgColor.b = std::min(255, bgColor.b + 20);
             }
-        } else {
-            SDL_SetRenderDrawColor(renderer, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
-            SDL_RenderDrawRect(renderer, &iconBg);
+        
+            SDL_Rect tabRect = {tabX, tabY, tabWidth, tabHeight};
+            renderer->setDrawColor(bgColor.r, bgColor.g, bgColor.b, bgColor.a);
+            renderer->fillRect(&tabRect);
+        
+            // Tab border
+            SDL_Color borderColor = isSelected ? tabs[i].color : SDL_Color{100, 100, 100, 255};
+            renderer->setDrawColor(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+            renderer->drawRect(&tabRect);
+        
+            // Tab text
+            SDL_Color textColor = isActive ? tabs[i].color : SDL_Color{150, 150, 150, 255};
+            char tabText[32];
+            if (tabs[i].enchantLevel > 0) {
+                snprintf(tabText, sizeof(tabText), "%s +%d", tabs[i].name, tabs[i].enchantLevel);
+            } else {
+                snprintf(tabText, sizeof(tabText), "%s", tabs[i].name);
+            }
+            renderTextCentered(tabText, tabX + tabWidth/2, tabY + tabHeight/2 - 8, textColor);
         }
+    
+        // Content area
+        int contentY = tabY + tabHeight + 20;
+        int contentHeight = bookHeight - (contentY - pageY) - 40;
+    
+        int gridStartX = pageX + 60;
+        int gridStartY = contentY + 40;
+    
+        // Add section headers
+        renderText("ACTIVE SPELLS", gridStartX, gridStartY - 25, {255, 200, 100, 255});
+        renderText("PASSIVE ABILITIES", gridStartX, gridStartY + spellSize + 60, {255, 200, 100, 255});
+    
+        for (size_t i = 0; i < spells.size(); i++) {
+            auto [spellType, reqLevel, iconFile] = spells[i];
         
-        // Spell icon
-        std::string iconPath = "assets/Textures/UI/" + std::string(iconFile);
-        Texture* iconTexture = assetManager->getTexture(iconPath);
-        if (iconTexture) {
-            SDL_Rect iconRect = {spellX, spellY, spellSize, spellSize};
-            
-            // Apply grayscale effect for locked spells
-            if (!unlocked) {
-                SDL_SetTextureColorMod(iconTexture->getTexture(), 100, 100, 100);
+            int spellX, spellY;
+            spellIconPos(i, gridStartX, gridStartY, spellX, spellY);
+        
+            bool unlocked = currentTab.enchantLevel >= reqLevel;
+            bool isActive = (currentTab.element == activeElement);
+        
+            // Spell icon background
+            SDL_Rect iconBg = {spellX - 5, spellY - 5, spellSize + 10, spellSize + 10};
+            SDL_Color bgColor = unlocked ? SDL_Color{60, 60, 60, 200} : SDL_Color{30, 30, 30, 200};
+            renderer->setDrawColor(bgColor.r, bgColor.g, bgColor.b, bgColor.a);
+            renderer->fillRect(&iconBg);
+        
+            bool isSelected = (static_cast<int>(i) == selectedSpellIndex);
+        
+            // Spell icon border with selection highlighting
+            bool isPassiveAbility = (spellType == SpellType::FIRE_MASTERY || 
+                                     spellType == SpellType::BURNING_AURA || 
+                                     spellType == SpellType::INFERNO_LORD);
+        
+            SDL_Color borderColor = unlocked ? currentTab.color : SDL_Color{80, 80, 80, 255};
+            if (unlocked && isActive) {
+                borderColor = {255, 255, 255, 255}; // White border for available spells
+            }
+            if (isPassiveAbility && unlocked) {
+                borderColor = {180, 100, 255, 255}; // Purple border for passive abilities
+            }
+            if (isSelected) {
+                borderColor = {255, 255, 0, 255}; // Yellow border for selected spell
+                // Add extra thick border for selected spell
+                for (int thickness = 0; thickness < 3; thickness++) {
+                    SDL_Rect thickBorder = {
+                        spellX - 5 - thickness, 
+                        spellY - 5 - thickness, 
+                        spellSize + 10 + thickness*2, 
+                        spellSize + 10 + thickness*2
+                    };
+                    renderer->setDrawColor(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+                    renderer->drawRect(&thickBorder);
+                }
             } else {
-                SDL_SetTextureColorMod(iconTexture->getTexture(), 255, 255, 255);
+                renderer->setDrawColor(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+                renderer->drawRect(&iconBg);
             }
+        
+            // Spell icon
+            std::string iconPath = "assets/Textures/UI/" + std::string(iconFile);
+            Texture* iconTexture = assetManager->getTexture(iconPath);
+            if (iconTexture) {
+                SDL_Rect iconRect = {spellX, spellY, spellSize, spellSize};
             
-            SDL_RenderCopy(renderer, iconTexture->getTexture(), nullptr, &iconRect);
-        }
+                // Apply grayscale effect for locked spells
+                if (!unlocked) {
+                    renderer->setTextureColorMod(iconTexture->getTexture(), 100, 100, 100);
+                } else {
+                    renderer->setTextureColorMod(iconTexture->getTexture(), 255, 255, 255);
+                }
+            
+                renderer->copy(iconTexture->getTexture(), nullptr, &iconRect);
+            }
         
-        // Spell name below icon
-        std::string spellName = spellSystem->getSpellName(spellType);
-        SDL_Color nameColor = unlocked ? SDL_Color{255, 255, 255, 255} : SDL_Color{120, 120, 120, 255};
-        renderTextCentered(spellName, spellX + spellSize/2, spellY + spellSize + 10, nameColor);
+            // Spell name below icon
+            std::string spellName = spellSystem->getSpellName(spellType);
+            SDL_Color nameColor = unlocked ? SDL_Color{255, 255, 255, 255} : SDL_Color{120, 120, 120, 255};
+            renderTextCentered(spellName, spellX + spellSize/2, spellY + spellSize + 10, nameColor);
         
-        // Requirement text
-        char reqText[32];
-        snprintf(reqText, sizeof(reqText), "Req: +%d", reqLevel);
-        SDL_Color reqColor = unlocked ? SDL_Color{100, 255, 100, 255} : SDL_Color{255, 100, 100, 255};
-        renderTextCentered(reqText, spellX + spellSize/2, spellY + spellSize + 25, reqColor);
-    }
+            // Requirement text
+            char reqText[32];
+            snprintf(reqText, sizeof(reqText), "Req: +%d", reqLevel);
+            SDL_Color reqColor = unlocked ? SDL_Color{100, 255, 100, 255} : SDL_Color{255, 100, 100, 255};
+            renderTextCentered(reqText, spellX + spellSize/2, spellY + spellSize + 25, reqColor);
+        }
     
-    // Detailed info panel on the right
-    int infoPanelX = bookX + bookWidth - 280;
-    int infoPanelY = contentY;
-    int infoPanelW = 250;
-    int infoPanelH = contentHeight - 20;
-    
-    // Info panel background
-    SDL_Rect infoPanel = {infoPanelX, infoPanelY, infoPanelW, infoPanelH};
-    SDL_SetRenderDrawColor(renderer, 25, 20, 35, 220);
-    SDL_RenderFillRect(renderer, &infoPanel);
-    SDL_SetRenderDrawColor(renderer, 100, 100, 120, 255);
-    SDL_RenderDrawRect(renderer, &infoPanel);
-    
-    // Info panel title
-    renderTextCentered("SPELL DETAILS", infoPanelX + infoPanelW/2, infoPanelY + 15, {255, 215, 0, 255});
-    
-    // Show details for selected spell
-    if (!spells.empty() && selectedSpellIndex >= 0 && selectedSpellIndex < static_cast<int>(spells.size())) {
-        auto [detailSpell, detailReq, detailIcon] = spells[selectedSpellIndex];
-        bool detailUnlocked = currentTab.enchantLevel >= detailReq;
+        // Detailed info panel on the right
+        int infoPanelX = pageX + bookWidth - 280;
+        int infoPanelY = contentY;
+        int infoPanelW = 250;
+        int infoPanelH = contentHeight - 20;
+    
+        // Info panel background
+        SDL_Rect infoPanel = {infoPanelX, infoPanelY, infoPanelW, infoPanelH};
+        renderer->setDrawColor(25, 20, 35, 220);
+        renderer->fillRect(&infoPanel);
+        renderer->setDrawColor(100, 100, 120, 255);
+        renderer->drawRect(&infoPanel);
+    
+        // Info panel title
+        renderTextCentered("SPELL DETAILS", infoPanelX + infoPanelW/2, infoPanelY + 15, {255, 215, 0, 255});
+    
+        // Show details for selected spell
+        if (!spells.empty() && selectedSpellIndex >= 0 && selectedSpellIndex < static_cast<int>(spells.size())) {
+            auto [detailSpell, detailReq, detailIcon] = spells[selectedSpellIndex];
+            bool detailUnlocked = currentTab.enchantLevel >= detailReq;
         
-        int detailY = infoPanelY + 45;
+            int detailY = infoPanelY + 45;
         
-        // Spell name
-        std::string detailName = spellSystem->getSpellName(detailSpell);
-        renderText(detailName, infoPanelX + 10, detailY, currentTab.color);
-        detailY += 25;
+            // Spell name
+            std::string detailName = spellSystem->getSpellName(detailSpell);
+            renderText(detailName, infoPanelX + 10, detailY, currentTab.color);
+            detailY += 25;
         
-        // Description
-        std::string desc = spellSystem->getSpellDescription(detailSpell);
-        // Word wrap description
-        std::vector<std::string> descLines;
-        std::string currentLine;
-        std::istringstream iss(desc);
-        std::string word;
+            // Description
+            std::string desc = spellSystem->getSpellDescription(detailSpell);
+            // Word wrap description
+            std::vector<std::string> descLines;
+            std::string currentLine;
+            std::istringstream iss(desc);
+            std::string word;
         
-        while (iss >> word) {
-            if (currentLine.length() + word.length() + 1 > 25) { // ~25 chars per line
-                if (!currentLine.empty()) {
-                    descLines.push_back(currentLine);
-                    currentLine = word;
+            while (iss >> word) {
+                if (currentLine.length() + word.length() + 1 > 25) { // ~25 chars per line
+                    if (!currentLine.empty()) {
+                        descLines.push_back(currentLine);
+                        currentLine = word;
+                    } else {
+                        descLines.push_back(word);
+                    }
                 } else {
-                    descLines.push_back(word);
+                    if (!currentLine.empty()) currentLine += " ";
+                    currentLine += word;
                 }
-            } else {
-                if (!currentLine.empty()) currentLine += " ";
-                currentLine += word;
             }
-        }
-        if (!currentLine.empty()) descLines.push_back(currentLine);
+            if (!currentLine.empty()) descLines.push_back(currentLine);
         
-        for (const auto& line : descLines) {
-            renderText(line, infoPanelX + 10, detailY, {200, 200, 200, 255});
-            detailY += 18;
-        }
+            for (const auto& line : descLines) {
+                renderText(line, infoPanelX + 10, detailY, {200, 200, 200, 255});
+                detailY += 18;
+            }
         
-        detailY += 10;
+            detailY += 10;
         
-        if (detailUnlocked) {
-            // Check if this is a passive ability
-            bool isPassive = (detailSpell == SpellType::FIRE_MASTERY || 
-                             detailSpell == SpellType::BURNING_AURA || 
-                             detailSpell == SpellType::INFERNO_LORD);
+            if (detailUnlocked) {
+                // Check if this is a passive ability
+                bool isPassive = (detailSpell == SpellType::FIRE_MASTERY || 
+                                 detailSpell == SpellType::BURNING_AURA || 
+                                 detailSpell == SpellType::INFERNO_LORD);
             
-            if (isPassive) {
-                // Passive ability stats
-                renderText("PASSIVE BONUSES:", infoPanelX + 10, detailY, {255, 200, 100, 255});
-                detailY += 20;
+                if (isPassive) {
+                    // Passive ability stats
+                    renderText("PASSIVE BONUSES:", infoPanelX + 10, detailY, {255, 200, 100, 255});
+                    detailY += 20;
                 
-                // Specific bonuses based on passive type
-                if (detailSpell == SpellType::FIRE_MASTERY) {
-                    renderText("• +10% Fire Damage", infoPanelX + 10, detailY, {255, 150, 150, 255});
-                    detailY += 15;
-                    renderText("• +5 Mana Regen/sec", infoPanelX + 10, detailY, {150, 200, 255, 255});
-                    detailY += 15;
-                } else if (detailSpell == SpellType::BURNING_AURA) {
-                    renderText("• Aura Damage: 5/sec", infoPanelX + 10, detailY, {255, 150, 150, 255});
-                    detailY += 15;
-                    renderText("• Aura Radius: 100px", infoPanelX + 10, detailY, {150, 255, 150, 255});
-                    detailY += 15;
-                } else if (detailSpell == SpellType::INFERNO_LORD) {
-                    renderText("• +25% Fire Damage", infoPanelX + 10, detailY, {255, 150, 150, 255});
-                    detailY += 15;
-                    renderText("• +10% Critical Hit", infoPanelX + 10, detailY, {255, 200, 100, 255});
-                    detailY += 15;
-                    renderText("• Fire Immunity", infoPanelX + 10, detailY, {255, 100, 100, 255});
-                    detailY += 15;
-                }
+                    // Specific bonuses based on passive type
+                    if (detailSpell == SpellType::FIRE_MASTERY) {
+                        renderText("• +10% Fire Damage", infoPanelX + 10, detailY, {255, 150, 150, 255});
+                        detailY += 15;
+                        renderText("• +5 Mana Regen/sec", infoPanelX + 10, detailY, {150, 200, 255, 255});
+                        detailY += 15;
+                    } else if (detailSpell == SpellType::BURNING_AURA) {
+                        renderText("• Aura Damage: 5/sec", infoPanelX + 10, detailY, {255, 150, 150, 255});
+                        detailY += 15;
+                        renderText("• Aura Radius: 100px", infoPanelX + 10, detailY, {150, 255, 150, 255});
+                        detailY += 15;
+                    } else if (detailSpell == SpellType::INFERNO_LORD) {
+                        renderText("• +25% Fire Damage", infoPanelX + 10, detailY, {255, 150, 150, 255});
+                        detailY += 15;
+                        renderText("• +10% Critical Hit", infoPanelX + 10, detailY, {255, 200, 100, 255});
+                        detailY += 15;
+                        renderText("• Fire Immunity", infoPanelX + 10, detailY, {255, 100, 100, 255});
+                        detailY += 15;
+                    }
                 
-                renderText("Type: Always Active", infoPanelX + 10, detailY, {180, 180, 180, 255});
-                detailY += 15;
-            } else {
-                // Active spell stats
-                renderText("COMBAT STATS:", infoPanelX + 10, detailY, {255, 200, 100, 255});
-                detailY += 20;
+                    renderText("Type: Always Active", infoPanelX + 10, detailY, {180, 180, 180, 255});
+                    detailY += 15;
+                } else {
+                    // Active spell stats
+                    renderText("COMBAT STATS:", infoPanelX + 10, detailY, {255, 200, 100, 255});
+                    detailY += 20;
                 
-                // Calculate damage based on enchantment level
-                int baseDamage = 10; // Base damage for spells
-                int enchantBonus = currentTab.enchantLevel * 2; // +2 damage per enchant level
-                int totalDamage = baseDamage + enchantBonus;
+                    // Calculate damage based on enchantment level
+                    int baseDamage = 10; // Base damage for spells
+                    int enchantBonus = currentTab.enchantLevel * 2; // +2 damage per enchant level
+                    int totalDamage = baseDamage + enchantBonus;
                 
-                char damageText[64];
-                snprintf(damageText, sizeof(damageText), "Damage: %d (%d + %d)", totalDamage, baseDamage, enchantBonus);
-                renderText(damageText, infoPanelX + 10, detailY, {255, 150, 150, 255});
-                detailY += 18;
+                    char damageText[64];
+                    snprintf(damageText, sizeof(damageText), "Damage: %d (%d + %d)", totalDamage, baseDamage, enchantBonus);
+                    renderText(damageText, infoPanelX + 10, detailY, {255, 150, 150, 255});
+                    detailY += 18;
                 
-                // Mana cost
-                int manaCost = spellSystem->getSpellManaCost(detailSpell);
-                char manaText[32];
-                snprintf(manaText, sizeof(manaText), "Mana Cost: %d", manaCost);
-                renderText(manaText, infoPanelX + 10, detailY, {150, 200, 255, 255});
-                detailY += 18;
+                    // Mana cost
+                    int manaCost = spellSystem->getSpellManaCost(detailSpell);
+                    char manaText[32];
+                    snprintf(manaText, sizeof(manaText), "Mana Cost: %d", manaCost);
+                    renderText(manaText, infoPanelX + 10, detailY, {150, 200, 255, 255});
+                    detailY += 18;
                 
-                // Cooldown
-                char cooldownText[32];
-                snprintf(cooldownText, sizeof(cooldownText), "Cooldown: %.1fs", spellSystem->getCooldownRemaining(detailSpell));
-                renderText(cooldownText, infoPanelX + 10, detailY, {200, 200, 150, 255});
-                detailY += 18;
+                    // Cooldown
+                    char cooldownText[32];
+                    snprintf(cooldownText, sizeof(cooldownText), "Cooldown: %.1fs", spellSystem->getCooldownRemaining(detailSpell));
+                    renderText(cooldownText, infoPanelX + 10, detailY, {200, 200, 150, 255});
+                    detailY += 18;
                 
-                // Range/Area
-                renderText("Range: Medium", infoPanelX + 10, detailY, {150, 255, 150, 255});
-                detailY += 18;
+                    // Range/Area
+                    renderText("Range: Medium", infoPanelX + 10, detailY, {150, 255, 150, 255});
+                    detailY += 18;
                 
-                renderText("Type: Castable", infoPanelX + 10, detailY, {180, 180, 180, 255});
-                detailY += 15;
-            }
-        } else {
-            renderText("LOCKED", infoPanelX + 10, detailY, {255, 100, 100, 255});
-            detailY += 20;
+                    renderText("Type: Castable", infoPanelX + 10, detailY, {180, 180, 180, 255});
+                    detailY += 15;
+                }
+            } else {
+                renderText("LOCKED", infoPanelX + 10, detailY, {255, 100, 100, 255});
+                detailY += 20;
             
-            char unlockText[64];
-            snprintf(unlockText, sizeof(unlockText), "Requires %s +%d enchantment", currentTab.name, detailReq);
+                char unlockText[64];
+                snprintf(unlockText, sizeof(unlockText), "Requires %s +%d enchantment", currentTab.name, detailReq);
             
-            // Word wrap unlock text
-            std::vector<std::string> unlockLines;
-            std::string currentUnlockLine;
-            std::istringstream unlockIss(unlockText);
-            std::string unlockWord;
+                // Word wrap unlock text
+                std::vector<std::string> unlockLines;
+                std::string currentUnlockLine;
+                std::istringstream unlockIss(unlockText);
+                std::string unlockWord;
             
-            while (unlockIss >> unlockWord) {
-                if (currentUnlockLine.length() + unlockWord.length() + 1 > 25) {
-                    if (!currentUnlockLine.empty()) {
-                        unlockLines.push_back(currentUnlockLine);
-                        currentUnlockLine = unlockWord;
+                while (unlockIss >> unlockWord) {
+                    if (currentUnlockLine.length() + unlockWord.length() + 1 > 25) {
+                        if (!currentUnlockLine.empty()) {
+                            unlockLines.push_back(currentUnlockLine);
+                            currentUnlockLine = unlockWord;
+                        } else {
+                            unlockLines.push_back(unlockWord);
+                        }
                     } else {
-                        unlockLines.push_back(unlockWord);
+                        if (!currentUnlockLine.empty()) currentUnlockLine += " ";
+                        currentUnlockLine += unlockWord;
                     }
-                } else {
-                    if (!currentUnlockLine.empty()) currentUnlockLine += " ";
-                    currentUnlockLine += unlockWord;
                 }
-            }
-            if (!currentUnlockLine.empty()) unlockLines.push_back(currentUnlockLine);
+                if (!currentUnlockLine.empty()) unlockLines.push_back(currentUnlockLine);
             
-            for (const auto& line : unlockLines) {
-                renderText(line, infoPanelX + 10, detailY, {200, 150, 150, 255});
-                detailY += 15;
+                for (const auto& line : unlockLines) {
+                    renderText(line, infoPanelX + 10, detailY, {200, 150, 150, 255});
+                    detailY += 15;
+                }
             }
         }
-    }
     
-    // Controls hint at bottom
-    renderTextCentered("Press B to close", bookX + bookWidth/2, bookY + bookHeight - 20, {180, 180, 180, 255});
+        // Controls hint at bottom
+        renderTextCentered("Press B to close", pageX + bookWidth/2, pageY + bookHeight - 20, {180, 180, 180, 255});
+    }
+    renderer->endPanel(SPELL_BOOK_PANEL, bookX - margin, bookY - margin);
 }
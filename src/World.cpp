@@ -6,21 +6,33 @@
 #include "Enemy.h"
 #include "Boss.h"
 #include <iostream>
-#include <random>
 #include <cmath> // Required for sin and cos
 #include <algorithm> // Required for std::max
 #include <cstdio>
 #include <cstdlib> // Required for std::abs
-#include <set> // Required for std::set
-
-World::World() : width(1000), height(1000), tileSize(32), tilesetTexture(nullptr), assetManager(nullptr), rng(std::random_device{}()), visibilityRadius(30), fogOfWarEnabled(true) {
+#include <filesystem>
+
+static const float ENEMY_TERRAIN_HALF_SIZE = 8.0f; // enemy terrain box around the body centre
+
+// Enemy simulation level of detail. The full-rate area is a fixed view (a 4K screen at the
+// default zoom) rather than the real viewport, so the simulation and replays do not depend on
+// the display.
+static const float LOD_VIEW_HALF_WIDTH = 1080.0f;
+static const float LOD_VIEW_HALF_HEIGHT = 610.0f;
+static const float LOD_VIEW_MARGIN = 256.0f;
+static const unsigned LOD_REDUCED_INTERVAL = 4;   // ticks between coarse updates off screen
+static const float LOD_WAKE_RADIUS = 1600.0f;     // reaches the full-rate area's corners and any aggro radius
+static const float LOD_NEIGHBOUR_SLACK = 64.0f;
+static const size_t LOD_MAX_NEW_SLEEPERS = 64;    // sleeperGrid is rebuilt once this many are checked one by one
+
+World::World() : width(1000), height(1000), tileSize(32), tilesetTexture(nullptr), assetManager(nullptr), rng(Random::stream(RngSystem::WorldGen)), visibilityRadius(30), fogOfWarEnabled(true) {
     // Initialize default tile generation config
     tileGenConfig.worldWidth = width;
     tileGenConfig.worldHeight = height;
     initializeDefaultWorld();
 }
 
-World::World(AssetManager* assetManager) : width(1000), height(1000), tileSize(32), tilesetTexture(nullptr), assetManager(assetManager), rng(std::random_device{}()), visibilityRadius(30), fogOfWarEnabled(true) {
+World::World(AssetManager* assetManager) : width(1000), height(1000), tileSize(32), tilesetTexture(nullptr), assetManager(assetManager), rng(Random::stream(RngSystem::WorldGen)), visibilityRadius(30), fogOfWarEnabled(true) {
     // Initialize default tile generation config
     tileGenConfig.worldWidth = width;
     tileGenConfig.worldHeight = height;
@@ -64,10 +76,148 @@ void World::update(float deltaTime) {
     }
 }
 
-void World::updateEnemies(float deltaTime, float playerX, float playerY) {
+World::EnemyLod World::classifyEnemy(const Enemy& enemy, float playerX, float playerY) const {
+    const float dx = enemy.getX() - playerX;
+    const float dy = enemy.getY() - playerY;
+    if (std::fabs(dx) <= LOD_VIEW_HALF_WIDTH + LOD_VIEW_MARGIN && std::fabs(dy) <= LOD_VIEW_HALF_HEIGHT + LOD_VIEW_MARGIN) {
+        return EnemyLod::FULL;
+    }
+    if (enemy.isDead()) return EnemyLod::HIDDEN;
+    const float aggro = enemy.getAggroRadius();
+    if (!enemy.getIsAggroed() && dx * dx + dy * dy > aggro * aggro && enemy.getProjectiles().empty()) return EnemyLod::DORMANT;
+    return EnemyLod::REDUCED;
+}
+
+void World::wakeEnemies(float playerX, float playerY) {
+    auto tryWake = [&](int id) {
+        Enemy* enemy = enemies[id].get();
+        if (!enemy || !enemy->getSimLod().asleep) return;
+        if (classifyEnemy(*enemy, playerX, playerY) == EnemyLod::DORMANT) return;
+        enemy->getSimLod().asleep = false;
+        awakeEnemyIds.push_back(id);
+    };
+    lodQueryIds.clear();
+    sleeperGrid.queryRadius(playerX, playerY, LOD_WAKE_RADIUS, lodQueryIds);
+    for (int id : lodQueryIds) tryWake(id);
+    for (int id : newSleeperIds) tryWake(id);
+}
+
+void World::rebuildSleeperGrid() {
+    std::sort(sleeperIds.begin(), sleeperIds.end());
+    sleeperIds.erase(std::unique(sleeperIds.begin(), sleeperIds.end()), sleeperIds.end());
+    sleeperIds.erase(std::remove_if(sleeperIds.begin(), sleeperIds.end(), [&](int id) {
+        return !enemies[id] || !enemies[id]->getSimLod().asleep;
+    }), sleeperIds.end());
+    sleeperGrid.clear();
+    for (int id : sleeperIds) {
+        const Enemy* enemy = enemies[id].get();
+        sleeperGrid.insert(id, enemy->getX() + enemy->getWidth() * 0.5f, enemy->getY() + enemy->getHeight() * 0.5f);
+    }
+    sleeperGrid.build();
+    newSleeperIds.clear();
+}
+
+void World::rebuildEnemyGrid() {
+    enemyGrid.clear();
+    for (int id : awakeEnemyIds) {
+        const Enemy* enemy = enemies[id].get();
+        if (!enemy || enemy->isDead()) continue;
+        enemyGrid.insert(id, enemy->getX() + enemy->getWidth() * 0.5f, enemy->getY() + enemy->getHeight() * 0.5f);
+    }
+    enemyGrid.build();
+}
+
+void World::rebuildEnemyLod() {
+    awakeEnemyIds.clear();
+    sleeperIds.clear();
+    for (int i = 0; i < static_cast<int>(enemies.size()); ++i) {
+        if (!enemies[i]) continue;
+        if (enemies[i]->getSimLod().asleep) sleeperIds.push_back(i);
+        else awakeEnemyIds.push_back(i);
+    }
+    rebuildSleeperGrid();
+    rebuildEnemyGrid();
+}
+
+void World::compactEnemies() {
+    enemies.erase(std::remove_if(enemies.begin(), enemies.end(), [](const std::unique_ptr<Enemy>& e){ return !e; }), enemies.end());
+    rebuildEnemyLod();
+}
+
+void World::resetEnemiesToSpawn() {
     for (auto& enemy : enemies) {
-        if (enemy) enemy->update(deltaTime, playerX, playerY, enemies);
+        if (!enemy) continue;
+        enemy->resetToSpawn();
+        enemy->getSimLod() = Enemy::SimLod();
+    }
+    rebuildEnemyLod();
+}
+
+void World::updateEnemies(float deltaTime, float playerX, float playerY) {
+    // Only awake enemies are visited; sleepers are found through their own grid when the player
+    // comes near
+    wakeEnemies(playerX, playerY);
+
+    ++lodTick;
+    nextAwakeEnemyIds.clear();
+    for (int i : awakeEnemyIds) {
+        Enemy* enemy = enemies[i].get();
+        if (!enemy) continue;
+        Enemy::SimLod& lod = enemy->getSimLod();
+
+        const float oldX = enemy->getX(), oldY = enemy->getY();
+        switch (classifyEnemy(*enemy, playerX, playerY)) {
+            case EnemyLod::FULL:
+                // Neighbours from last tick's grid; the slack covers a tick of movement and the
+                // grid holding centres while separation measures between corners
+                lodNeighbours.clear();
+                if (enemy->getIsAggroed()) {
+                    lodQueryIds.clear();
+                    enemyGrid.queryRadius(oldX + enemy->getWidth() * 0.5f, oldY + enemy->getHeight() * 0.5f,
+                                          Enemy::SEPARATION_RADIUS + LOD_NEIGHBOUR_SLACK, lodQueryIds);
+                    for (int id : lodQueryIds) {
+                        if (enemies[id]) lodNeighbours.push_back(enemies[id].get());
+                    }
+                }
+                enemy->update(deltaTime + lod.deferredTime, playerX, playerY, lodNeighbours);
+                lod.deferredTime = 0.0f;
+                break;
+            case EnemyLod::REDUCED:
+                // Every LOD_REDUCED_INTERVAL ticks with the time saved up, staggered across enemies
+                if (!enemy->getProjectiles().empty()) enemy->updateProjectiles(deltaTime);
+                lod.deferredTime += deltaTime;
+                if ((lodTick + static_cast<unsigned>(i)) % LOD_REDUCED_INTERVAL == 0) {
+                    enemy->updateCoarse(lod.deferredTime, playerX, playerY);
+                    lod.deferredTime = 0.0f;
+                }
+                break;
+            case EnemyLod::DORMANT:
+                lod.asleep = true;
+                lod.deferredTime = 0.0f;
+                sleeperIds.push_back(i);
+                newSleeperIds.push_back(i);
+                continue;
+            case EnemyLod::HIDDEN:
+                nextAwakeEnemyIds.push_back(i);
+                continue;
+        }
+        nextAwakeEnemyIds.push_back(i);
+        if (enemy->isDead() || (enemy->getX() == oldX && enemy->getY() == oldY)) continue;
+
+        // Enemies fly over liquids but not through walls or off the map
+        const SDL_Rect body = enemy->getCollisionRect();
+        const float cx = body.x + body.w * 0.5f - (enemy->getX() - oldX);
+        const float cy = body.y + body.h * 0.5f - (enemy->getY() - oldY);
+        const TileBox box{cx - ENEMY_TERRAIN_HALF_SIZE, cy - ENEMY_TERRAIN_HALF_SIZE,
+                          cx + ENEMY_TERRAIN_HALF_SIZE, cy + ENEMY_TERRAIN_HALF_SIZE};
+        const TileSweepResult step = collision.sweep(box, enemy->getX() - oldX, enemy->getY() - oldY, TileCollision::FLYER);
+        if (step.blockedX || step.blockedY) enemy->setPosition(oldX + step.dx, oldY + step.dy);
     }
+    awakeEnemyIds.swap(nextAwakeEnemyIds);
+    if (newSleeperIds.size() >= LOD_MAX_NEW_SLEEPERS) rebuildSleeperGrid();
+
+    rebuildEnemyGrid();
+    statusEffects.update(deltaTime, enemyGrid, enemies);
     
     // Update boss
     if (currentBoss && !currentBoss->isDead()) {
@@ -83,7 +233,17 @@ void World::updateEnemies(float deltaTime, float playerX, float playerY) {
     checkBossSpawn(playerX, playerY);
 }
 
-void World::render(Renderer* renderer) {
+void World::captureSnapshot(RenderSnapshot& snapshot) const {
+    snapshot.enemies.reserve(enemies.size());
+    for (const auto& enemy : enemies) {
+        if (enemy) snapshot.enemies.push_back(enemy->getTransform());
+    }
+    if (currentBoss && !currentBoss->isDead()) {
+        snapshot.boss = currentBoss->getTransform();
+    }
+}
+
+void World::render(Renderer* renderer, const RenderSnapshot& snapshot) {
     if (!renderer) {
         return;
     }
@@ -103,7 +263,7 @@ void World::render(Renderer* renderer) {
     int visibleTilesCount = 0;
     
     // TMX render path when a fixed map is loaded
-    if (usePrebakedChunks && !tmxLayers.empty() && tmxWidth>0 && tmxHeight>0) {
+    if (usePrebakedChunks && tilemap.isOpen() && tmxWidth>0 && tmxHeight>0) {
         int cameraX, cameraY; renderer->getCamera(cameraX, cameraY);
         float z = renderer->getZoom();
         auto toScreen = [cameraX, cameraY, z](int wx, int wy) -> SDL_Rect {
@@ -115,23 +275,28 @@ void World::render(Renderer* renderer) {
                              std::max(1, static_cast<int>(std::floor(x2)-std::floor(x1))),
                              std::max(1, static_cast<int>(std::floor(y2)-std::floor(y1))) };
         };
+        // Only the tiles under the camera are read, so large maps page in just what is on screen
+        int outW = 0, outH = 0;
+        renderer->getOutputSize(&outW, &outH);
+        const float viewW = outW / std::max(0.01f, z), viewH = outH / std::max(0.01f, z);
+        const int firstX = std::max(0, static_cast<int>(std::floor(cameraX / static_cast<float>(tileSize))));
+        const int firstY = std::max(0, static_cast<int>(std::floor(cameraY / static_cast<float>(tileSize))));
+        const int lastX = std::min(tmxWidth - 1, static_cast<int>(std::floor((cameraX + viewW) / tileSize)));
+        const int lastY = std::min(tmxHeight - 1, static_cast<int>(std::floor((cameraY + viewH) / tileSize)));
         // Draw layers in order
-        for (const auto& layer : tmxLayers) {
-            for (int y=0; y<tmxHeight; ++y) {
-                for (int x=0; x<tmxWidth; ++x) {
-                    int gid = layer[y*tmxWidth + x]; if (gid<=0) continue;
-                    // Find tileset
-                    const TmxTilesetInfo* used = nullptr; const TmxTilesetInfo* best=nullptr;
-                    for (const auto& ts : tmxTilesets) {
-                        if (gid >= ts.firstGid) { if (!best || ts.firstGid > best->firstGid) best = &ts; }
-                    }
-                    used = best; if (!used || !used->texture || used->columns<=0) continue;
-                    int localId = gid - used->firstGid; if (localId < 0) continue;
+        for (size_t layer = 0; layer < tilemap.getLayerCount(); ++layer) {
+            for (int y=firstY; y<=lastY; ++y) {
+                for (int x=firstX; x<=lastX; ++x) {
+                    if (!tilemap.hasBlock(layer, x, y)) { x |= MAP_BLOCK_SIZE - 1; continue; } // skip the rest of an empty block row
+                    uint32_t gid = tilemap.getGid(layer, x, y); if (gid==0) continue;
+                    const TmxTilesetInfo* used = findTmxTileset(gid);
+                    if (!used || !used->texture || used->columns<=0) continue;
+                    int localId = static_cast<int>(gid - static_cast<uint32_t>(used->firstGid));
                     int sx = (localId % used->columns) * used->tileWidth;
                     int sy = (localId / used->columns) * used->tileHeight;
                     SDL_Rect src{ sx, sy, used->tileWidth, used->tileHeight };
                     SDL_Rect dst = toScreen(x*tileSize, y*tileSize);
-                    SDL_RenderCopy(renderer->getSDLRenderer(), used->texture->getTexture(), &src, &dst);
+                    renderer->copy(used->texture->getTexture(), &src, &dst);
                 }
             }
         }
@@ -214,7 +379,7 @@ void World::render(Renderer* renderer) {
                         int frame = static_cast<int>((ticks / 150) % total); // global sync
                         SDL_Rect src = deepWaterSpriteSheet->getFrameRect(frame);
                         SDL_Texture* sdlTex = deepWaterSpriteSheet->getTexture()->getTexture();
-                        SDL_RenderCopy(renderer->getSDLRenderer(), sdlTex, &src, &destRect);
+                        renderer->copy(sdlTex, &src, &destRect);
                         continue;
                     }
                     if (tileId == TILE_LAVA && lavaSpriteSheet && lavaSpriteSheet->getTexture()) {
@@ -223,7 +388,7 @@ void World::render(Renderer* renderer) {
                         int frame = static_cast<int>((ticks / 120) % total); // global sync
                         SDL_Rect src = lavaSpriteSheet->getFrameRect(frame);
                         SDL_Texture* sdlTex = lavaSpriteSheet->getTexture()->getTexture();
-                        SDL_RenderCopy(renderer->getSDLRenderer(), sdlTex, &src, &destRect);
+                        renderer->copy(sdlTex, &src, &destRect);
                         continue;
                     }
 
@@ -249,7 +414,7 @@ void World::render(Renderer* renderer) {
                         src.x = (idx % std::max(1, underworldAtlasCols)) * 32;
                         src.y = ((idx / std::max(1, underworldAtlasCols)) % std::max(1, underworldAtlasRows)) * 32;
                         sdlTex = atlasTex ? atlasTex->getTexture() : nullptr;
-                        if (sdlTex) { SDL_RenderCopy(renderer->getSDLRenderer(), sdlTex, &src, &destRect); continue; }
+                        if (sdlTex) { renderer->copy(sdlTex, &src, &destRect); continue; }
                     } else {
                     if (tileId >= 0 && tileId < static_cast<int>(tileVariantTextures.size()) && !tileVariantTextures[tileId].empty()) {
                         size_t idx = static_cast<size_t>(getPreferredVariantIndex(tileId, worldX, worldY));
@@ -261,15 +426,15 @@ void World::render(Renderer* renderer) {
                         sdlTex = chosen ? chosen->getTexture() : nullptr;
                     }
                     if (sdlTex) {
-                        SDL_SetTextureBlendMode(sdlTex, SDL_BLENDMODE_BLEND);
+                        renderer->setTextureBlendMode(sdlTex, SDL_BLENDMODE_BLEND);
                         if (fogOfWarEnabled && isExplored && !isVisible) {
-                            SDL_SetTextureColorMod(sdlTex, 100, 100, 100);
+                            renderer->setTextureColorMod(sdlTex, 100, 100, 100);
                         } else if (fogOfWarEnabled && !isExplored) {
-                            SDL_SetTextureColorMod(sdlTex, 50, 50, 50);
+                            renderer->setTextureColorMod(sdlTex, 50, 50, 50);
                         } else {
-                            SDL_SetTextureColorMod(sdlTex, 255, 255, 255);
+                            renderer->setTextureColorMod(sdlTex, 255, 255, 255);
                         }
-                        SDL_RenderCopy(renderer->getSDLRenderer(), sdlTex, nullptr, &destRect);
+                        renderer->copy(sdlTex, nullptr, &destRect);
                     }
                     }
                 }
@@ -308,35 +473,54 @@ void World::render(Renderer* renderer) {
                     // We do not have direct player pointer here; use last known camera center as a proxy for nearby pull
                 }
             }
-            object->render(renderer->getSDLRenderer(), cameraX, cameraY, tileSize, renderer->getZoom());
+            object->render(renderer, cameraX, cameraY, tileSize, renderer->getZoom());
         }
     }
 
-    // Render enemies (screen-space culling)
+    // Render enemies (screen-space culling). Snapshot entries are in the same relative order as enemies.
+    size_t snapshotCursor = 0;
     for (auto& enemy : enemies) {
         if (!enemy) continue;
+        EntityTransform transform;
+        int anchor = DrawList::ANCHOR_WORLD;
+        size_t probe = snapshotCursor;
+        while (probe < snapshot.enemies.size() && snapshot.enemies[probe].entity != enemy.get()) probe++;
+        if (probe < snapshot.enemies.size()) {
+            transform = snapshot.enemies[probe];
+            anchor = static_cast<int>(probe);
+            snapshotCursor = probe + 1;
+        } else {
+            transform = enemy->getTransform(); // spawned since the last tick
+        }
         float z = renderer->getZoom();
-        int screenX = static_cast<int>((static_cast<int>(enemy->getX()) - cameraX) * z);
-        int screenY = static_cast<int>((static_cast<int>(enemy->getY()) - cameraY) * z);
+        int screenX = static_cast<int>((static_cast<int>(transform.x) - cameraX) * z);
+        int screenY = static_cast<int>((static_cast<int>(transform.y) - cameraY) * z);
         int cullW = static_cast<int>(512 * z);
         int cullH = static_cast<int>(512 * z);
         if (screenX + cullW > -200 && screenX < 1920 + 200 &&
             screenY + cullH > -200 && screenY < 1080 + 200) {
-            enemy->render(renderer);
+            // The sprite moves with its own interpolated transform between ticks; its shots with the world
+            renderer->setAnchor(anchor);
+            enemy->render(renderer, transform);
+            renderer->setAnchor(DrawList::ANCHOR_WORLD);
             enemy->renderProjectiles(renderer);
         }
     }
     
     // Render boss (screen-space culling)
     if (currentBoss && !currentBoss->isDead()) {
+        const bool inSnapshot = snapshot.boss.entity == static_cast<const Enemy*>(currentBoss.get());
+        EntityTransform transform = inSnapshot ? snapshot.boss : currentBoss->getTransform();
         float z = renderer->getZoom();
-        int screenX = static_cast<int>((static_cast<int>(currentBoss->getX()) - cameraX) * z);
-        int screenY = static_cast<int>((static_cast<int>(currentBoss->getY()) - cameraY) * z);
+        int screenX = static_cast<int>((static_cast<int>(transform.x) - cameraX) * z);
+        int screenY = static_cast<int>((static_cast<int>(transform.y) - cameraY) * z);
         int cullW = static_cast<int>(512 * z);
         int cullH = static_cast<int>(512 * z);
         if (screenX + cullW > -200 && screenX < 1920 + 200 &&
             screenY + cullH > -200 && screenY < 1080 + 200) {
-            currentBoss->render(renderer);
+            renderer->setAnchor(inSnapshot ? DrawList::ANCHOR_BOSS : DrawList::ANCHOR_WORLD);
+            currentBoss->render(renderer, transform);
+            renderer->setAnchor(DrawList::ANCHOR_WORLD);
             currentBoss->renderProjectiles(renderer);
         }
     }
@@ -344,10 +528,8 @@ void World::render(Renderer* renderer) {
 
 void World::renderMinimap(Renderer* renderer, int x, int y, int panelWidth, int panelHeight, float playerX, float playerY) const {
     if (!renderer || panelWidth <= 0 || panelHeight <= 0) return;
-    SDL_Renderer* sdl = renderer->getSDLRenderer();
-    if (!sdl) return;
 
-    SDL_SetRenderDrawBlendMode(sdl, SDL_BLENDMODE_BLEND);
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
     // No external border; minimap will be embedded within HUD frame
     // Inner drawing area (fit inside border)
     const int margin = 8;
@@ -355,8 +537,8 @@ void World::renderMinimap(Renderer* renderer, int x, int y, int panelWidth, int
     int iw = std::max(1, panelWidth - margin * 2);
     int ih = std::max(1, panelHeight - margin * 2);
     SDL_Rect inner{ ix, iy, iw, ih };
-    SDL_SetRenderDrawColor(sdl, 0, 0, 0, 200);
-    SDL_RenderFillRect(sdl, &inner);
+    renderer->setDrawColor(0, 0, 0, 200);
+    renderer->fillRect(&inner);
 
     // Center the view around the player
     int centerTileX = static_cast<int>(playerX / tileSize);
@@ -381,21 +563,21 @@ void World::renderMinimap(Renderer* renderer, int x, int y, int panelWidth, int
             // Undiscovered tiles: black
             bool explored = (ty >= 0 && ty < static_cast<int>(exploredTiles.size()) && tx >= 0 && tx < static_cast<int>(exploredTiles[ty].size())) ? exploredTiles[ty][tx] : false;
             if (!explored) {
-                SDL_SetRenderDrawColor(sdl, 0, 0, 0, 255);
+                renderer->setDrawColor(0, 0, 0, 255);
             } else {
                 int id = tiles[ty][tx].id;
                 World::TileColor c = getMinimapColor(id);
-                SDL_SetRenderDrawColor(sdl, c.r, c.g, c.b, c.a);
+                renderer->setDrawColor(c.r, c.g, c.b, c.a);
             }
-            SDL_RenderDrawPoint(sdl, ix + px, iy + py);
+            renderer->drawPoint(ix + px, iy + py);
         }
     }
     
     // Draw player dot at center
-    SDL_SetRenderDrawColor(sdl, 255, 0, 0, 255);
+    renderer->setDrawColor(255, 0, 0, 255);
     int cx = ix + iw / 2;
     int cy = iy + ih / 2;
-    SDL_RenderDrawPoint(sdl, cx, cy);
+    renderer->drawPoint(cx, cy);
 
     // Border removed: HUD art provides enclosing frame
 }
@@ -493,350 +675,75 @@ void World::loadTileTextures() {
 // (legacy getEdgeTextureForMask removed)
 
 void World::loadTilemap(const std::string& filename) {
-    // Lightweight TMX CSV loader: reads layers named "plat", "plat2" as solid ground
-    // and any layer with name starting with "lava" as TILE_LAVA (non-walkable).
-    // Other layers are ignored for collision but render via our normal materials.
-    std::cout << "Loading TMX tilemap: " << filename << std::endl;
-
-    // Read file into memory
-    FILE* f = fopen(filename.c_str(), "rb");
-    if (!f) { std::cerr << "Failed to open TMX: " << filename << std::endl; return; }
-    fseek(f, 0, SEEK_END); long len = ftell(f); fseek(f, 0, SEEK_SET);
-    std::string xml; xml.resize(static_cast<size_t>(len));
-    size_t rd = fread(xml.data(), 1, static_cast<size_t>(len), f); (void)rd; fclose(f);
-
-    // Crude parsing: extract width/height and tilesets/layers
-    auto findAttr = [](const std::string& s, const std::string& key, size_t pos)->int{
-        size_t k = s.find(key + "=\"", pos); if (k==std::string::npos) return -1; k += key.size()+2; size_t e = s.find('"', k); if (e==std::string::npos) return -1; return std::atoi(s.substr(k, e-k).c_str()); };
-
-    // Initialize baseline grid from first matching layer dimensions
-    int mapW = 0, mapH = 0;
-    // Parse tilesets (supports external TSX)
-    tmxTilesets.clear(); tmxLayers.clear(); tmxWidth = tmxHeight = 0;
-    auto getAttr = [&](const std::string& h, const std::string& key)->std::string{
-        size_t k = h.find(key+"=\""); if (k==std::string::npos) return std::string(); k += key.size()+2; size_t e = h.find('"', k); if (e==std::string::npos) return std::string(); return h.substr(k, e-k);
-    };
-    auto readWholeFile = [&](const std::string& path) -> std::string {
-        FILE* tf = fopen(path.c_str(), "rb"); if (!tf) return std::string();
-        fseek(tf, 0, SEEK_END); long L = ftell(tf); fseek(tf, 0, SEEK_SET);
-        std::string out; out.resize(static_cast<size_t>(std::max<long>(L,0)));
-        size_t n = fread(out.data(), 1, static_cast<size_t>(std::max<long>(L,0)), tf); (void)n; fclose(tf);
-        return out;
-    };
-    auto joinPath = [](const std::string& base, const std::string& rel) -> std::string {
-        if (rel.empty()) return rel;
-        if (rel.find(":") != std::string::npos) return rel; // absolute (Windows)
-        if (!rel.empty() && (rel[0]=='/' || rel[0]=='\\')) return rel;
-        if (base.empty()) return rel;
-        size_t slash = base.find_last_of("/\\");
-        std::string dir = (slash==std::string::npos) ? std::string() : base.substr(0, slash+1);
-        return dir + rel;
-    };
-    size_t tsPos = 0;
-    while (true) {
-        size_t tsi = xml.find("<tileset", tsPos); if (tsi==std::string::npos) break;
-        size_t tsiEnd = xml.find('>', tsi); if (tsiEnd==std::string::npos) break;
-        std::string tsHeader = xml.substr(tsi, tsiEnd - tsi + 1);
-        int firstGid = std::max(0, std::atoi(getAttr(tsHeader, "firstgid").c_str()));
-        std::string sourceTsx = getAttr(tsHeader, "source");
-        if (!sourceTsx.empty()) {
-            std::string tsxPath = joinPath(filename, sourceTsx);
-            std::string tsx = readWholeFile(tsxPath);
-            if (!tsx.empty()) {
-                // Parse TSX header for tile size, columns, image source
-                size_t hdrStart = tsx.find("<tileset"); size_t hdrEnd = tsx.find('>', hdrStart);
-                std::string h = (hdrStart!=std::string::npos && hdrEnd!=std::string::npos) ? tsx.substr(hdrStart, hdrEnd-hdrStart+1) : std::string();
-                int tw = std::max(1, std::atoi(getAttr(h, "tilewidth").c_str()));
-                int th = std::max(1, std::atoi(getAttr(h, "tileheight").c_str()));
-                int cols = std::max(0, std::atoi(getAttr(h, "columns").c_str()));
-                std::string name = getAttr(h, "name");
-                size_t imgS = tsx.find("<image"); size_t imgE = tsx.find('>', imgS);
-                std::string ih = (imgS!=std::string::npos && imgE!=std::string::npos) ? tsx.substr(imgS, imgE-imgS+1) : std::string();
-                std::string imgRel = getAttr(ih, "source");
-                std::string imgPath = joinPath(tsxPath, imgRel);
-                Texture* tex = nullptr;
-                if (assetManager) {
-                    tex = assetManager->getTexture(imgPath);
-                    if (!tex) tex = assetManager->getTexture(imgRel);
-                }
-                TmxTilesetInfo info; info.firstGid = firstGid; info.texture = tex; info.tileWidth = tw; info.tileHeight = th; info.name = name; info.imagePath = imgRel;
-                if (tex) {
-                    info.columns = (cols>0? cols : std::max(1, tex->getWidth() / std::max(1, tw)));
-                } else {
-                    info.columns = (cols>0? cols : 0);
-                }
-                tmxTilesets.push_back(info);
-            }
-        } else {
-            // Inline tileset with <image>
-            size_t imgTagStart = xml.find("<image", tsiEnd);
-            size_t nextTileOrTs = std::min(xml.find("<tileset", tsiEnd), xml.find("<layer", tsiEnd));
-            if (imgTagStart!=std::string::npos && (nextTileOrTs==std::string::npos || imgTagStart < nextTileOrTs)) {
-                size_t imgEnd = xml.find('>', imgTagStart);
-                if (imgEnd!=std::string::npos) {
-                    std::string imgHeader = xml.substr(imgTagStart, imgEnd - imgTagStart + 1);
-                    std::string src = getAttr(imgHeader, "source");
-                    TmxTilesetInfo info; info.firstGid = firstGid; info.imagePath = src; info.tileWidth = 32; info.tileHeight = 32; info.columns = 0;
-                    if (assetManager) {
-                        std::string fullRel = joinPath(filename, src);
-                        Texture* tex = assetManager->getTexture(fullRel);
-                        if (!tex) tex = assetManager->getTexture(src);
-                        info.texture = tex; if (tex) info.columns = std::max(1, tex->getWidth() / info.tileWidth);
-                    }
-                    tmxTilesets.push_back(info);
-                }
-            }
+    // Prefer the compiled map next to the TMX (see tools/MapCompiler.cpp): it is memory-mapped and
+    // needs no parsing. Without an up-to-date one the TMX is compiled in memory, so both paths load
+    // exactly the same data.
+    std::cout << "Loading tilemap: " << filename << std::endl;
+    std::string error;
+    const std::string compiledPath = compiledMapPathFor(filename);
+    bool compiledIsFresh = true;
+    if (compiledPath != filename) {
+        std::error_code ec;
+        auto tmxTime = std::filesystem::last_write_time(filename, ec);
+        if (!ec) {
+            auto compiledTime = std::filesystem::last_write_time(compiledPath, ec);
+            compiledIsFresh = !ec && compiledTime >= tmxTime;
         }
-        tsPos = tsiEnd + 1;
     }
-
-    // Basic CSV gather per layer (all, to honor map order)
-    struct LayerData { std::string name; std::vector<int> gids; int w=0; int h=0; };
-    std::vector<LayerData> layers;
-
-    size_t pos = 0;
-    while (true) {
-        size_t li = xml.find("<layer", pos); if (li == std::string::npos) break;
-        size_t liEnd = xml.find('>', li); if (liEnd == std::string::npos) break;
-        std::string header = xml.substr(li, liEnd - li + 1);
-        // name
-        size_t nk = header.find("name=\""); if (nk == std::string::npos) { pos = liEnd + 1; continue; }
-        nk += 6; size_t nkE = header.find('"', nk); if (nkE == std::string::npos) { pos = liEnd + 1; continue; }
-        std::string lname = header.substr(nk, nkE - nk);
-        int lw = findAttr(header, "width", 0);
-        int lh = findAttr(header, "height", 0);
-        size_t dataStart = xml.find("<data", liEnd); if (dataStart == std::string::npos) { pos = liEnd + 1; continue; }
-        size_t dataTagEnd = xml.find('>', dataStart); if (dataTagEnd == std::string::npos) { pos = liEnd + 1; continue; }
-        size_t dataClose = xml.find("</data>", dataTagEnd); if (dataClose == std::string::npos) { pos = liEnd + 1; continue; }
-        std::string csv = xml.substr(dataTagEnd + 1, dataClose - dataTagEnd - 1);
-        // Sanitize
-        for (char& c : csv) { if (c=='\n' || c=='\r' || c=='\t') c = ' '; }
-        // Parse CSV ints
-        std::vector<int> gids; gids.reserve(std::max(0, lw*lh));
-        int val = 0; bool inNum = false; bool neg = false; 
-        auto flush = [&](){ if (inNum){ gids.push_back(neg?-val:val); val=0; neg=false; inNum=false; } };
-        for (size_t i = 0; i < csv.size(); ++i) {
-            char ch = csv[i];
-            if ((ch >= '0' && ch <= '9')) { inNum = true; val = val*10 + (ch - '0'); }
-            else if (ch == '-') { inNum = true; neg = true; }
-            else if (ch == ',' || ch == ' ') { flush(); }
+    if (compiledIsFresh && tilemap.open(compiledPath, &error)) {
+        std::cout << "Using compiled map: " << compiledPath << std::endl;
+    } else {
+        if (!error.empty()) std::cout << "Compiled map not used (" << error << "); compiling TMX in memory" << std::endl;
+        TmxMap tmx;
+        if (!loadTmxMap(filename, tmx, &error)) { std::cerr << "TMX parse failed: " << error << std::endl; return; }
+        std::vector<uint8_t> bytes;
+        compileMap(tmx, bytes);
+        if (!tilemap.adopt(std::move(bytes), &error)) { std::cerr << "TMX compile failed: " << error << std::endl; return; }
+    }
+
+    // Switch world to prebaked grid sized to the map; dense, which MAP_MAX_CELLS bounds
+    width = tilemap.getWidth(); height = tilemap.getHeight(); tileSize = 32; // TMX is 32px tiles in our assets
+    const MapBitmask blocked = tilemap.getMask(MAP_MASK_BLOCKED);
+    const MapBitmask hazard = tilemap.getMask(MAP_MASK_HAZARD);
+    tiles.assign(height, std::vector<Tile>(width));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            tiles[y][x] = Tile(hazard.test(x, y) ? TILE_LAVA : TILE_STONE, !blocked.test(x, y), true);
         }
-        flush();
-
-        LayerData ld; ld.name = lname; ld.gids = std::move(gids); ld.w = lw; ld.h = lh;
-        layers.push_back(std::move(ld));
-        if (mapW == 0 && lw > 0) { mapW = lw; mapH = lh; }
-        pos = dataClose + 7;
     }
-
-    if (mapW <= 0 || mapH <= 0) { std::cerr << "TMX parse failed: width/height not found" << std::endl; return; }
-
-    // Switch world to prebaked grid sized to TMX
-    width = mapW; height = mapH; tileSize = 32; // TMX is 32px tiles in our assets
-    tiles.assign(height, std::vector<Tile>(width, Tile(TILE_STONE, true, true)));
     visibleTiles.assign(height, std::vector<bool>(width, true));
     exploredTiles.assign(height, std::vector<bool>(width, true));
     usePrebakedChunks = true; visibleChunks.clear(); chunks.clear();
     mapChunkCols = (width + tileGenConfig.chunkSize - 1) / tileGenConfig.chunkSize;
     mapChunkRows = (height + tileGenConfig.chunkSize - 1) / tileGenConfig.chunkSize;
 
-    auto applyLayer = [&](const LayerData& L){
-        auto lower = L.name; for (auto& c: lower) c = static_cast<char>(::tolower(c));
-        bool isLava = (lower == "lava" || lower == "lava river"); // Only actual lava, not "lava passage" which might be decorative
-        bool isGround = (lower == "plat" || lower == "plat2" || lower.find("ground") != std::string::npos);
-        bool isStairs = (lower.find("stairs") != std::string::npos);
-        bool isPlatform = (lower == "plat" || lower == "plat2" || lower == "platform1" || lower == "platform2");
-        
-        // Process all relevant layers
-        if (!isLava && !isGround && !isStairs && !isPlatform) return;
-        if (static_cast<int>(L.gids.size()) != L.w * L.h) return;
-        
-        for (int y = 0; y < L.h; ++y) {
-            for (int x = 0; x < L.w; ++x) {
-                int gid = L.gids[y * L.w + x];
-                if (gid == 0) continue; // empty cell
-                if (isLava) {
-                    tiles[y][x] = Tile(TILE_LAVA, false, true);
-                } else if (isGround || isStairs || isPlatform) {
-                    // Default underworld ground: stone (walkable)
-                    tiles[y][x] = Tile(TILE_STONE, true, true);
-                }
-            }
-        }
-    };
-    for (const auto& L : layers) applyLayer(L);
-
-    // Store TMX layers and size for exact draw
     tmxWidth = width; tmxHeight = height;
-    tmxLayers.clear();
-    for (const auto& L : layers) {
-        tmxLayers.push_back(L.gids);
-    }
-    // Build platform/stairs masks
-    platformMask.assign(height, std::vector<bool>(width,false));
-    platform1Mask.assign(height, std::vector<bool>(width,false));
-    platform2Mask.assign(height, std::vector<bool>(width,false));
-    stairsMask.assign(height, std::vector<bool>(width,false));
-    edgeMask.assign(height, std::vector<bool>(width,false));
-    lavaMask.assign(height, std::vector<bool>(width,false));
-    for (const auto& L : layers) {
-        auto lower = L.name; for (auto& c: lower) c = static_cast<char>(::tolower(c));
-        std::cout << "Processing layer: " << L.name << " (lowercase: " << lower << ")" << std::endl;
-        bool isPlat1 = (lower == "plat" || lower == "platform1");
-        bool isPlat2 = (lower == "plat2" || lower == "platform2");
-        bool isPlat = isPlat1 || isPlat2;
-        bool isStairs = (lower.find("stairs") != std::string::npos);
-        bool isEdge = (lower.find("floating land") != std::string::npos || lower.find("floating_land") != std::string::npos || lower.find("floating") != std::string::npos);
-        bool isLava = (lower == "lava" || lower == "lava river"); // Be specific about lava layers
-        if (isStairs) std::cout << "  -> Identified as stairs layer!" << std::endl;
-        if (!(isPlat || isStairs || isEdge || isLava)) continue;
-        if (static_cast<int>(L.gids.size()) != L.w*L.h) continue;
-        for (int y=0; y<L.h; ++y) {
-            for (int x=0; x<L.w; ++x) {
-                int gid = L.gids[y*L.w + x];
-                if (gid == 0) continue;
-                if (isPlat) platformMask[y][x] = true;
-                if (isPlat1) platform1Mask[y][x] = true;
-                if (isPlat2) platform2Mask[y][x] = true;
-                if (isStairs) stairsMask[y][x] = true;
-                if (isEdge) edgeMask[y][x] = true;
-                if (isLava) lavaMask[y][x] = true;
-            }
-        }
-    }
-    // First, set walkability based on tile type
-    // IMPORTANT: We need to distinguish between actual lava tiles and other tiles
-    // The lava layer should only mark real lava, not platforms or other tiles
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            // Only mark as lava if it's in the lava layer AND not a platform/stairs tile
-            if (lavaMask[y][x] && !platformMask[y][x] && !stairsMask[y][x]) {
-                // This is actual lava - mark as hazard
-                tiles[y][x].walkable = false;
-                tiles[y][x].id = TILE_LAVA;
-            } else {
-                // All other tiles are walkable by default (will be modified by edge detection)
-                tiles[y][x].walkable = true;
-                // Keep the original tile type, don't override it
-            }
-        }
-    }
-
-    // Now block specific edge tiles that are visual ledge faces
-    // Keep this list minimal to avoid invisible walls. Only include the
-    // obvious rocky faces that are never part of flat walkable top surfaces.
-    std::set<int> edgeTileGids = {
-        32, 36,  // vertical faces (left/right)
-        48, 52,  // vertical faces (inner variants / with shadows)
-        65, 67   // a couple of bottom-row rocky face variants
-    };
-    
-    // Block tiles that are specifically marked as edges or visual ledge faces
-    // Only check platform layers for edge tiles
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            // Skip if already non-walkable (like lava)
-            if (!tiles[y][x].walkable) continue;
-            
-            // Only check platform tiles for edges
-            if (!platformMask[y][x]) continue;
-            
-            // Heuristic 1: adjacency-based south cliff face detection.
-            // If this platform tile has platform directly above but NOT below,
-            // it visually represents a vertical face we should not stand on.
-            // We detect this separately for platform1 and platform2 so each
-            // level's ledges are blocked correctly.
-            // IMPORTANT: never block tiles that are part of or immediately adjacent
-            // to a staircase. Those tiles must remain walkable so players can
-            // step on/off the stairs cleanly at the top and bottom.
-            bool nearStairs = stairsMask[y][x]
-                || (y > 0 && stairsMask[y - 1][x])
-                || (y + 1 < height && stairsMask[y + 1][x])
-                || (x > 0 && stairsMask[y][x - 1])
-                || (x + 1 < width && stairsMask[y][x + 1]);
-            bool hasAbove = (y > 0) && platformMask[y - 1][x];
-            bool hasBelow = (y + 1 < height) && platformMask[y + 1][x];
-            bool hasLeft  = (x > 0) && platformMask[y][x - 1];
-            bool hasRight = (x + 1 < width) && platformMask[y][x + 1];
-            bool hasAboveP1 = (y > 0) && platform1Mask[y - 1][x];
-            bool hasBelowP1 = (y + 1 < height) && platform1Mask[y + 1][x];
-            bool hasLeftP1  = (x > 0) && platform1Mask[y][x - 1];
-            bool hasRightP1 = (x + 1 < width) && platform1Mask[y][x + 1];
-            bool hasAboveP2 = (y > 0) && platform2Mask[y - 1][x];
-            bool hasBelowP2 = (y + 1 < height) && platform2Mask[y + 1][x];
-            bool hasLeftP2  = (x > 0) && platform2Mask[y][x - 1];
-            bool hasRightP2 = (x + 1 < width) && platform2Mask[y][x + 1];
-			// Heuristic 1a: south cliff face via adjacency.
-			// If there is platform directly above but NOT below, this tile visually
-			// represents the front face of a ledge. Block it (except near stairs).
-			if (!nearStairs && ((hasAbove && !hasBelow) || (hasAboveP1 && !hasBelowP1) || (hasAboveP2 && !hasBelowP2))) {
-				tiles[y][x].walkable = false;
-				edgeMask[y][x] = true;
-				continue; // already blocked by adjacency rule
-			}
-
-            // Heuristic 1b: left/right vertical face detection.
-            // A tile that has platform above, and platform on one horizontal side but not the other,
-            // is part of a vertical cliff face. Do not allow standing on these.
-            if (!nearStairs) {
-                bool sideFaceAny = (hasAbove && ((hasRight && !hasLeft) || (hasLeft && !hasRight)));
-                bool sideFaceP1  = (hasAboveP1 && ((hasRightP1 && !hasLeftP1) || (hasLeftP1 && !hasRightP1)));
-                bool sideFaceP2  = (hasAboveP2 && ((hasRightP2 && !hasLeftP2) || (hasLeftP2 && !hasRightP2)));
-                if (sideFaceAny || sideFaceP1 || sideFaceP2) {
-                    tiles[y][x].walkable = false;
-                    edgeMask[y][x] = true;
-                    continue;
-                }
-            }
-
-            // Heuristic 2: explicit GID-based detection for special side pieces.
-            // Get the GID for this position from platform layers only
-            int layerIndex = 0;
-            for (const auto& L : layers) {
-                auto lower = L.name; 
-                for (auto& c: lower) c = static_cast<char>(::tolower(c));
-                bool isPlatformLayer = (lower == "plat" || lower == "plat2" || 
-                                      lower == "platform" || lower == "platform1" || 
-                                      lower == "platform2");
-                
-                if (isPlatformLayer && layerIndex < tmxLayers.size()) {
-                    int gid = tmxLayers[layerIndex][y * tmxWidth + x];
-                    if (gid > 0) {
-                        // Map GID -> local tileset ID using the tileset with the
-                        // largest firstGid that is <= gid. This avoids accidental
-                        // matches from earlier tilesets and makes localGid stable.
-                        int localGid = -1;
-                        int chosenFirst = -1;
-                        for (const auto& ts : tmxTilesets) {
-                            if (gid >= ts.firstGid && ts.firstGid > chosenFirst) {
-                                chosenFirst = ts.firstGid;
-                            }
-                        }
-                        if (chosenFirst >= 0) {
-                            localGid = gid - chosenFirst;
-                        }
-                        
-                        if (localGid >= 0 && edgeTileGids.count(localGid)) {
-                            // Only treat as a true edge when adjacency also suggests
-                            // a vertical face and it's not near stairs. Avoid marking
-                            // flat top surfaces as edges.
-                            bool adjacencyLooksLikeFace = (hasAbove && !hasBelow)
-                                || (hasAbove && ((hasRight && !hasLeft) || (hasLeft && !hasRight)))
-                                || (hasAboveP1 && ((hasRightP1 && !hasLeftP1) || (hasLeftP1 && !hasRightP1)))
-                                || (hasAboveP2 && ((hasRightP2 && !hasLeftP2) || (hasLeftP2 && !hasRightP2)));
-                            if (!nearStairs && adjacencyLooksLikeFace) {
-                                tiles[y][x].walkable = false;
-                                edgeMask[y][x] = true;
-                            }
-                        }
-                    }
-                }
-                layerIndex++;
-            }
+    platformMask = tilemap.getMask(MAP_MASK_PLATFORM);
+    platform1Mask = tilemap.getMask(MAP_MASK_PLATFORM1);
+    platform2Mask = tilemap.getMask(MAP_MASK_PLATFORM2);
+    stairsMask = tilemap.getMask(MAP_MASK_STAIRS);
+    edgeMask = tilemap.getMask(MAP_MASK_EDGE);
+    lavaMask = tilemap.getMask(MAP_MASK_LAVA);
+    rebuildCollision();
+
+    // Tileset textures (the table is already sorted by firstGid)
+    tmxTilesets.clear();
+    for (size_t i = 0; i < tilemap.getTilesetCount(); ++i) {
+        const MapFileTileset& ts = tilemap.getTileset(i);
+        TmxTilesetInfo info;
+        info.firstGid = static_cast<int>(ts.firstGid);
+        info.tileWidth = static_cast<int>(ts.tileWidth);
+        info.tileHeight = static_cast<int>(ts.tileHeight);
+        info.name = tilemap.getString(ts.nameOffset);
+        info.imagePath = tilemap.getString(ts.imageSourceOffset);
+        if (assetManager) {
+            info.texture = assetManager->getTexture(resolveMapPath(filename, tilemap.getString(ts.imagePathOffset)));
+            if (!info.texture) info.texture = assetManager->getTexture(info.imagePath);
         }
+        info.columns = ts.columns > 0 ? static_cast<int>(ts.columns)
+                                      : (info.texture ? std::max(1, info.texture->getWidth() / std::max(1, info.tileWidth)) : 0);
+        tmxTilesets.push_back(info);
     }
-    
-    // Note: We're not blocking tiles adjacent to lava anymore - let players get close to danger!
 
     // Debug: count walkable tiles and show breakdown
     int walkableCount = 0;
@@ -845,41 +752,21 @@ void World::loadTilemap(const std::string& filename) {
     int floatingLandCount = 0;
     int platformCount = 0;
     int stairsCount = 0;
-    int emptyCount = 0;
     for (int y = 0; y < height; ++y) {
         for (int x = 0; x < width; ++x) {
-            if (platformMask[y][x]) platformCount++;
-            if (stairsMask[y][x]) stairsCount++;
-            
-            if (tiles[y][x].walkable) {
-                walkableCount++;
-            } else {
-                if (tiles[y][x].id == TILE_LAVA) lavaCount++;
-                else if (edgeMask[y][x]) floatingLandCount++;
-                // Count other non-walkable tiles
-                else edgeBlockedCount++;
-            }
+            if (platformMask.test(x, y)) platformCount++;
+            if (stairsMask.test(x, y)) stairsCount++;
+            if (tiles[y][x].walkable) walkableCount++;
+            else if (tiles[y][x].id == TILE_LAVA) lavaCount++;
+            else if (edgeMask.test(x, y)) floatingLandCount++;
+            else edgeBlockedCount++;
         }
     }
-    std::cout << "Underworld walkability: " << walkableCount << " walkable, " 
-              << lavaCount << " lava, " << edgeBlockedCount << " edge-blocked, " 
-              << floatingLandCount << " floating-land, " << emptyCount << " empty out of " << (width * height) << " total" << std::endl;
-    std::cout << "Platform tiles: " << platformCount << ", Stairs tiles: " << stairsCount << std::endl;
-    
-    // Debug: print first few stairs locations
-    if (stairsCount > 0) {
-        std::cout << "First few stairs locations: ";
-        int printCount = 0;
-        for (int y = 0; y < height && printCount < 10; ++y) {
-            for (int x = 0; x < width && printCount < 10; ++x) {
-                if (stairsMask[y][x]) {
-                    std::cout << "(" << x << "," << y << ") ";
-                    printCount++;
-                }
-            }
-        }
-        std::cout << std::endl;
-    }
+    std::cout << "Underworld walkability: " << walkableCount << " walkable, "
+              << lavaCount << " lava, " << edgeBlockedCount << " edge-blocked, "
+              << floatingLandCount << " floating-land out of " << (width * height) << " total" << std::endl;
+    std::cout << "Platform tiles: " << platformCount << ", Stairs tiles: " << stairsCount
+              << ", Map regions: " << tilemap.getRegionCount() << std::endl;
 
     // Switch to underworld visual set using atlas
     underworldVisuals = true;
@@ -896,7 +783,14 @@ void World::loadTilemap(const std::string& filename) {
         // Swap lava sheet to the underworld version if available
         lavaSpriteSheet = assetManager->loadSpriteSheet("assets/Underworld Tilemap/Tilesets/lava-16frames.png", 32, 32, 16, 16);
     }
-    std::cout << "TMX loaded: " << width << "x" << height << " tiles. Lava tiles and ground applied (Underworld visuals)." << std::endl;
+    std::cout << "Tilemap loaded: " << width << "x" << height << " tiles. Lava tiles and ground applied (Underworld visuals)." << std::endl;
+}
+
+const World::TmxTilesetInfo* World::findTmxTileset(uint32_t gid) const {
+    // Last tileset whose firstGid is <= gid
+    auto it = std::upper_bound(tmxTilesets.begin(), tmxTilesets.end(), gid,
+                               [](uint32_t g, const TmxTilesetInfo& ts) { return static_cast<int64_t>(g) < ts.firstGid; });
+    return it == tmxTilesets.begin() ? nullptr : &*(it - 1);
 }
 
 void World::setTile(int x, int y, int tileId) {
@@ -907,6 +801,7 @@ void World::setTile(int x, int y, int tileId) {
             tileId = TILE_GRASS;
         }
         tiles[y][x].id = tileId;
+        if (!collision.empty()) collision.updateFlags(x, y, collisionFlagsAt(x, y));
     }
 }
 
@@ -935,126 +830,37 @@ bool World::isSafeTile(int tileX, int tileY) const {
 }
 
 bool World::isLedgeBlockedVertical(int fromTileX, int fromTileY, int toTileX, int toTileY) const {
-    // Only for TMX underworld with platform/stairs masks
-    if (!usePrebakedChunks || platformMask.empty()) return false;
-    // Vertical move only
-    if (fromTileX != toTileX || std::abs(toTileY - fromTileY) != 1) return false;
-    // If either origin or destination is out of bounds, do not restrict
-    if (fromTileY < 0 || fromTileY >= static_cast<int>(platformMask.size()) || fromTileX < 0 || fromTileX >= static_cast<int>(platformMask[0].size())) return false;
-    if (toTileY < 0 || toTileY >= static_cast<int>(platformMask.size()) || toTileX < 0 || toTileX >= static_cast<int>(platformMask[0].size())) return false;
-    
-    bool fromPlat = platformMask[fromTileY][fromTileX];
-    bool toPlat = platformMask[toTileY][toTileX];
-    
-    // Check if this is a ledge crossing that should be blocked
-    // A ledge crossing happens when moving between different platform heights
-    
-    // First, always block movement into non-walkable tiles
-    if (!tiles[toTileY][toTileX].walkable) {
-        return true;
-    }
-    
-    // Check if either position has stairs - if so, always allow movement
-    bool stairAtOrigin = stairsMask[fromTileY][fromTileX];
-    bool stairAtDest = stairsMask[toTileY][toTileX];
-    if (stairAtOrigin || stairAtDest) {
-        return false; // Always allow movement on/to/from stairs
-    }
-    
-    // Only block actual elevation changes (non-platform -> platform when going up,
-    // platform -> non-platform when going down). Allow movement within the same
-    // platform area so players can move freely on flat surfaces.
-    // Additionally, if trying to step onto a tile we have marked as an edge face
-    // by adjacency or GID analysis, block it.
-    
-    // Moving up (negative Y direction)
-    if (toTileY < fromTileY) {
-        if (!fromPlat && toPlat) {
-            return true; // climbing up a ledge without stairs
-        }
-    }
-    
-    // Moving down (positive Y direction)
-    if (toTileY > fromTileY) {
-        if (fromPlat && !toPlat) {
-            return true; // dropping down a ledge without stairs
-        }
-    }
-
-    // Final guard: if destination tile is explicitly flagged as an edge, block.
-    if (edgeMask[toTileY][toTileX]) return true;
-
-    // Note: Do NOT hard-block vertical transitions between platform1 and platform2
-    // here. Treat platform1/2 differences as cosmetic within the top surface.
-    // True elevation changes are already caught above (non-platform <-> platform)
-    // and by ledge-crossing logic which consults edge markers and stairs.
-    
-    return false; // Allow horizontal movements on same level
+    return collision.isLedgeBlockedVertical(fromTileX, fromTileY, toTileX, toTileY);
 }
 
 bool World::isLedgeCrossingBlocked(int fromTileX, int fromTileY, int toTileX, int toTileY) const {
-    if (!usePrebakedChunks || platformMask.empty()) return false;
-    // Any move that changes platformMask state must go through a stairs cell
-    auto inb = [&](int x, int y){ return x>=0 && x<width && y>=0 && y<height; };
-    if (!inb(fromTileX,fromTileY) || !inb(toTileX,toTileY)) return false;
-    if (fromTileX == toTileX && fromTileY == toTileY) return false;
-    bool fromPlat = platformMask[fromTileY][fromTileX];
-    bool toPlat = platformMask[toTileY][toTileX];
-    bool stairHere = stairsMask[fromTileY][fromTileX] || stairsMask[toTileY][toTileX];
-
-    // Helper: when making a HORIZONTAL step at the top or bottom of a staircase,
-    // allow the transition if the destination or origin has a staircase directly
-    // above or below it. This lets you step off/on the staircase onto the platform.
-    bool isHorizontal = (fromTileY == toTileY) && (std::abs(toTileX - fromTileX) == 1);
-    bool isVertical   = (fromTileX == toTileX) && (std::abs(toTileY - fromTileY) == 1);
-    bool stairAdjFrom = false, stairAdjTo = false;
-    if (isHorizontal) {
-        if (inb(fromTileX, fromTileY - 1)) stairAdjFrom |= stairsMask[fromTileY - 1][fromTileX];
-        if (inb(fromTileX, fromTileY + 1)) stairAdjFrom |= stairsMask[fromTileY + 1][fromTileX];
-        if (inb(toTileX, toTileY - 1))     stairAdjTo   |= stairsMask[toTileY - 1][toTileX];
-        if (inb(toTileX, toTileY + 1))     stairAdjTo   |= stairsMask[toTileY + 1][toTileX];
-    }
-    // Do not relax vertical ledge transitions via side-adjacent stairs here.
-    // Vertical movement is handled by isLedgeBlockedVertical (with edge guard).
-
-    // Case 1: Crossing between non-platform and platform (any direction)
-    auto nearStairsAt = [&](int tx, int ty){
-        if (!inb(tx,ty)) return false;
-        if (stairsMask[ty][tx]) return true;
-        if (inb(tx,ty-1) && stairsMask[ty-1][tx]) return true;
-        if (inb(tx,ty+1) && stairsMask[ty+1][tx]) return true;
-        if (inb(tx-1,ty) && stairsMask[ty][tx-1]) return true;
-        if (inb(tx+1,ty) && stairsMask[ty][tx+1]) return true;
-        return false;
-    };
-    bool edgeFrom = edgeMask[fromTileY][fromTileX] && !nearStairsAt(fromTileX, fromTileY);
-    bool edgeTo   = edgeMask[toTileY][toTileX]     && !nearStairsAt(toTileX, toTileY);
-    bool edgeHere = edgeFrom || edgeTo;
-    if (fromPlat != toPlat) {
-        if (stairHere) return false;
-        if ((isHorizontal || isVertical) && (stairAdjFrom || stairAdjTo)) return false;
-        if (!edgeHere) return false;
-        return true;
-    }
+    return collision.isLedgeCrossingBlocked(fromTileX, fromTileY, toTileX, toTileY);
+}
 
-    // Case 2: Crossing between different platform levels (platform1 <-> platform2)
-    // Even though both are platform, treat them as different elevations that require stairs
-    bool fromP1 = platform1Mask[fromTileY][fromTileX];
-    bool toP1   = platform1Mask[toTileY][toTileX];
-    bool fromP2 = platform2Mask[fromTileY][fromTileX];
-    bool toP2   = platform2Mask[toTileY][toTileX];
-    bool crossingBetweenLevels = (fromP1 && toP2) || (fromP2 && toP1);
-    if (crossingBetweenLevels) {
-        if (stairHere) return false;
-        if ((isHorizontal || isVertical) && (stairAdjFrom || stairAdjTo)) return false;
-        if (!edgeHere) return false;
-        return true;
+uint8_t World::collisionFlagsAt(int x, int y) const {
+    const Tile& t = tiles[y][x];
+    uint8_t flags = 0;
+    // Underworld ledge faces are drops, not walls: nothing walks onto them, but shots and flyers pass
+    const bool ledgeFace = usePrebakedChunks && edgeMask.test(x, y);
+    if (!t.walkable) flags |= (isHazardTileId(t.id) || ledgeFace) ? TileCollision::LIQUID : TileCollision::SOLID;
+    if (t.id == TILE_LAVA) flags |= TileCollision::LAVA;
+    if (usePrebakedChunks) {
+        if (platformMask.test(x, y)) flags |= TileCollision::PLATFORM;
+        if (platform1Mask.test(x, y)) flags |= TileCollision::PLATFORM1;
+        if (platform2Mask.test(x, y)) flags |= TileCollision::PLATFORM2;
+        if (stairsMask.test(x, y)) flags |= TileCollision::STAIRS;
+        if (edgeMask.test(x, y)) flags |= TileCollision::EDGE;
     }
-
-    return false;
+    return flags;
 }
 
-
+void World::rebuildCollision() {
+    collision.reset(width, height, tileSize, usePrebakedChunks && !platformMask.empty());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) collision.setFlags(x, y, collisionFlagsAt(x, y));
+    }
+    collision.finalize();
+}
 
 void World::addObject(std::unique_ptr<Object> object) {
     if (object) {
@@ -1068,6 +874,8 @@ void World::clearObjects() {
 
 void World::addEnemy(std::unique_ptr<Enemy> enemy) {
     if (enemy) {
+        enemy->setWorld(this);
+        awakeEnemyIds.push_back(static_cast<int>(enemies.size()));
         enemies.push_back(std::move(enemy));
     }
 }
@@ -1096,8 +904,7 @@ int World::getPrioritizedTileType(int x, int y) {
     // Simple fallback: Stone, Grass, then Dirt
     float noise = (sin(x * 0.1f) + cos(y * 0.1f) + sin((x + y) * 0.05f)) / 3.0f;
     noise = (noise + 1.0f) / 2.0f; // 0..1
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    float randomValue = dist(rng);
+    float randomValue = rng.nextFloat();
     float v = (noise * 0.3f + randomValue * 0.7f);
     if (v < 0.4f) return TILE_STONE;
     if (v < 0.6f) return TILE_GRASS;
@@ -1204,7 +1011,8 @@ void World::generateTilemap(const TileGenerationConfig& config) {
     } else {
         std::cout << "All tile IDs are valid." << std::endl;
     }
-    
+
+    rebuildCollision();
     std::cout << "Tilemap generation complete!" << std::endl;
 }
 
@@ -1223,13 +1031,13 @@ void World::regenerateTilemap(const TileGenerationConfig& config) {
 
 void World::initializeRNG() {
     if (tileGenConfig.useFixedSeed) {
-        rng.seed(tileGenConfig.fixedSeed);
+        // A fixed world seed also fixes every stream derived afterwards (chunks, enemies, loot)
+        Random::setSeed(tileGenConfig.fixedSeed);
         std::cout << "Using fixed seed: " << tileGenConfig.fixedSeed << std::endl;
     } else {
-        std::random_device rd;
-        rng.seed(rd());
-        std::cout << "Using random seed" << std::endl;
+        std::cout << "Using random seed: " << Random::getSeed() << std::endl;
     }
+    rng = Random::stream(RngSystem::WorldGen);
 }
 
 // (legacy generateWeightedTileType removed)
@@ -1303,8 +1111,7 @@ void World::applyStoneClustering() {
                 // If there are enough stone tiles nearby, increase the chance of stone in surrounding areas
                 float stoneRatio = static_cast<float>(stoneCount) / totalCount;
                 if (stoneRatio > 0.3f) { // If more than 30% of nearby tiles are stone
-                    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-                    float randomValue = dist(rng);
+                    float randomValue = rng.nextFloat();
                     
                     // Increase stone probability in surrounding areas
                     if (randomValue < tileGenConfig.stoneClusterChance) {
@@ -1317,7 +1124,7 @@ void World::applyStoneClustering() {
                                 if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
                                     if (tempTiles[ny][nx].id == TILE_GRASS) {
                                         // 50% chance to convert to stone, 50% to stone grass
-                                        if (dist(rng) < 0.5f) {
+                                        if (rng.nextFloat() < 0.5f) {
                                             tiles[ny][nx].id = TILE_STONE;
                                         } else {
                                             tiles[ny][nx].id = TILE_DIRT;
@@ -1534,6 +1341,14 @@ std::string World::getChunkKey(int chunkX, int chunkY) const {
     return std::to_string(chunkX) + "," + std::to_string(chunkY);
 }
 
+bool World::isInLoadedChunks(float px, float py) const {
+    if (!hasLoadedChunks) return true;
+    const int tileX = static_cast<int>(std::floor(px / static_cast<float>(tileSize)));
+    const int tileY = static_cast<int>(std::floor(py / static_cast<float>(tileSize)));
+    auto [chunkX, chunkY] = worldToChunkCoords(tileX, tileY);
+    return chunkX >= loadedChunkMinX && chunkX <= loadedChunkMaxX && chunkY >= loadedChunkMinY && chunkY <= loadedChunkMaxY;
+}
+
 std::pair<int, int> World::worldToChunkCoords(int worldX, int worldY) const {
     const int s = tileGenConfig.chunkSize;
     auto floorDiv = [s](int v) -> int {
@@ -1723,12 +1538,17 @@ void World::smoothRegions(Chunk* chunk) {
     }
 }
 
+RandomStream World::chunkRandom(const Chunk* chunk, uint64_t pass) const {
+    uint64_t chunkKey = (static_cast<uint64_t>(static_cast<uint32_t>(chunk->chunkX)) << 32) |
+                        static_cast<uint32_t>(chunk->chunkY);
+    return Random::stream(RngSystem::Chunks, chunkKey, pass);
+}
+
 void World::addAccents(Chunk* chunk) {
     if (!chunk) return;
     const int s = tileGenConfig.chunkSize;
     // Deterministic PRNG per chunk for stable accents
-    std::mt19937 prng(static_cast<unsigned int>((chunk->chunkX * 2654435761u) ^ (chunk->chunkY * 97531u)));
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    RandomStream prng = chunkRandom(chunk, 0);
 
     auto groupAccent = [&](int groupId, int baseMat) -> int {
         // Map group to a rare accent within same color family
@@ -1747,7 +1567,7 @@ void World::addAccents(Chunk* chunk) {
             int id = chunk->tiles[y][x].id;
             if (id == TILE_WATER_SHALLOW || id == TILE_WATER_DEEP || id == TILE_LAVA) continue;
             int g = getMaterialGroupId(id);
-            float r = dist(prng);
+            float r = prng.nextFloat();
             if (r < tileGenConfig.accentChance) {
                 int accent = groupAccent(g, id);
                 // Respect color compatibility strictly
@@ -1806,7 +1626,7 @@ void World::carveRivers(Chunk* chunk) {
     }
 
     // Deterministic PRNG per chunk to pick a couple of seeds
-    std::mt19937 prng(static_cast<unsigned int>((chunk->chunkX * 2654435761u) ^ (chunk->chunkY * 97531u)));
+    RandomStream prng = chunkRandom(chunk, 1);
     std::shuffle(seeds.begin(), seeds.end(), prng);
     int numRivers = std::min(3, static_cast<int>(seeds.size()));
 
@@ -1991,15 +1811,11 @@ void World::placeWaterLakes(Chunk* chunk) {
     // Extremely rare oasis in arid chunks
     int centerBiome = getBiomeType(worldStartX + s / 2, worldStartY + s / 2);
     // PRNG per chunk
-    std::mt19937 prng(static_cast<unsigned int>((chunk->chunkX * 2654435761u) ^ (chunk->chunkY * 97531u)));
+    RandomStream prng = chunkRandom(chunk, 2);
 
     if (centerBiome == 3) {
-        std::uniform_real_distribution<float> r01(0.0f, 1.0f);
-        if (r01(prng) < 0.005f) { // 0.5% per arid chunk
-            std::uniform_int_distribution<int> rx(4, s - 5);
-            std::uniform_int_distribution<int> ry(4, s - 5);
-            std::uniform_int_distribution<int> rr(2, 4);
-            int cx = rx(prng), cy = ry(prng), rad = rr(prng);
+        if (prng.nextFloat() < 0.005f) { // 0.5% per arid chunk
+            int cx = prng.nextInt(4, s - 5), cy = prng.nextInt(4, s - 5), rad = prng.nextInt(2, 4);
             for (int dy = -rad; dy <= rad; ++dy) {
                 for (int dx = -rad; dx <= rad; ++dx) {
                     int nx = cx + dx, ny = cy + dy;
@@ -2017,12 +1833,8 @@ void World::placeWaterLakes(Chunk* chunk) {
     if (shallowCount < s) {
         int cb = getBiomeType(worldStartX + s / 2, worldStartY + s / 2);
         if (cb == 0 || cb == 1 || cb == 2) {
-            std::uniform_real_distribution<float> r01(0.0f, 1.0f);
-            if (r01(prng) < 0.06f) { // ~6% per eligible chunk
-                std::uniform_int_distribution<int> rx(6, s - 7);
-                std::uniform_int_distribution<int> ry(6, s - 7);
-                std::uniform_int_distribution<int> rr(3, 6);
-                int cx = rx(prng), cy = ry(prng), rad = rr(prng);
+            if (prng.nextFloat() < 0.06f) { // ~6% per eligible chunk
+                int cx = prng.nextInt(6, s - 7), cy = prng.nextInt(6, s - 7), rad = prng.nextInt(3, 6);
                 for (int dy = -rad; dy <= rad; ++dy) {
                     for (int dx = -rad; dx <= rad; ++dx) {
                         int nx = cx + dx, ny = cy + dy;
@@ -2048,6 +1860,9 @@ void World::updateVisibleChunks(float playerX, float playerY) {
     
     // Generate and mark chunks within render distance as visible (smooth roaming)
     int renderDistance = tileGenConfig.renderDistance;
+    hasLoadedChunks = true;
+    loadedChunkMinX = playerChunkX - renderDistance; loadedChunkMaxX = playerChunkX + renderDistance;
+    loadedChunkMinY = playerChunkY - renderDistance; loadedChunkMaxY = playerChunkY + renderDistance;
     if (usePrebakedChunks) {
         // For prebaked maps, synthesize flat chunks that simply reference the global tiles
         visibleChunks.clear();
@@ -2111,6 +1926,7 @@ void World::spawnBoss(BossType bossType, float x, float y) {
     }
     
     currentBoss = std::make_unique<Boss>(x, y, assetManager, bossType);
+    currentBoss->setWorld(this);
     bossSpawned = true;
     
     std::cout << "Boss spawned: " << currentBoss->getBossName() << " at (" << x << ", " << y << ")" << std::endl;
@@ -2126,15 +1942,15 @@ void World::checkBossSpawn(float playerX, float playerY) {
     
     // Example: Spawn boss when player reaches coordinates (30, 30) or similar trigger
     if ((playerTileX > 25 && playerTileX < 35 && playerTileY > 25 && playerTileY < 35) ||
-        (enemies.empty() && rand() % 1000 < 2)) { // 0.2% chance per frame when no enemies
+        (enemies.empty() && rng.chance(0.002f))) { // 0.2% chance per frame when no enemies
         
         // Choose random boss type
         BossType bossTypes[] = {BossType::DEMON_LORD, BossType::ANCIENT_WIZARD, BossType::GOBLIN_KING};
-        BossType chosenType = bossTypes[rand() % 3];
+        BossType chosenType = bossTypes[rng.nextInt(0, 2)];
         
         // Spawn boss at a safe distance from player
-        float bossX = playerX + ((rand() % 2 == 0) ? 400 : -400);
-        float bossY = playerY + ((rand() % 2 == 0) ? 400 : -400);
+        float bossX = playerX + (rng.nextInt(0, 1) == 0 ? 400 : -400);
+        float bossY = playerY + (rng.nextInt(0, 1) == 0 ? 400 : -400);
         
         // Ensure boss spawns on walkable terrain
         int bossTileX = static_cast<int>(bossX / tileSize);
@@ -3,9 +3,27 @@
 #include <SDL_ttf.h>
 #include <iostream>
 #include <memory>
+#include <string>
 #include "Game.h"
 
-int main(int /*argc*/, char* /*argv*/[]) {
+int main(int argc, char* argv[]) {
+    // Input record/replay for deterministic performance runs:
+    //   --record <file> | --replay <file> [--unthrottled] [--frame-log <file>]
+    GameLaunchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--record" && hasValue) options.recordPath = argv[++i];
+        else if (arg == "--replay" && hasValue) options.replayPath = argv[++i];
+        else if (arg == "--frame-log" && hasValue) options.frameLogPath = argv[++i];
+        else if (arg == "--unthrottled") options.unthrottled = true;
+        else std::cerr << "Ignoring unknown argument: " << arg << std::endl;
+    }
+    if (!options.recordPath.empty() && !options.replayPath.empty()) {
+        std::cerr << "--record and --replay are exclusive; replaying only" << std::endl;
+        options.recordPath.clear();
+    }
+
     // Initialize SDL2
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
         std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
@@ -27,7 +45,7 @@ int main(int /*argc*/, char* /*argv*/[]) {
 
     // Create and run the game
     try {
-        Game game;
+        Game game(options);
         game.run();
     } catch (const std::exception& e) {
         std::cerr << "Game error: " << e.what() << std::endl;
@@ -0,0 +1,159 @@
+// PixDatabaseBench: times DatabaseSQLite account lookups against a synthetic user base, then
+// save/load throughput for one account.
+//
+//   PixDatabaseBench [--accounts N] [--lookups N] [--saves N] [--dir path]
+//
+// Builds with the same optional SQLite backend as the game. The JSON store gets a synthesized
+// users/index.txt (the per-user folders are never opened by lookups); SQLite accounts are
+// registered through the public API. The data directory is wiped before and after the run.
+
+#include "DatabaseSQLite.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::string accountName(int id) {
+    return "bench_user_" + std::to_string(id);
+}
+
+// The game logs every register and save; keep the timings readable
+struct QuietCout {
+    std::ostringstream sink;
+    std::streambuf* saved = std::cout.rdbuf(sink.rdbuf());
+    ~QuietCout() { std::cout.rdbuf(saved); }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int accounts = 100000;
+    int lookups = 1000000;
+    int saves = 2000;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "pixlegends_dbbench";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--accounts" && i + 1 < argc) accounts = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--lookups" && i + 1 < argc) lookups = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--saves" && i + 1 < argc) saves = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--dir" && i + 1 < argc) dir = argv[++i];
+        else {
+            std::cerr << "usage: PixDatabaseBench [--accounts N] [--lookups N] [--saves N] [--dir path]" << std::endl;
+            return 2;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    const std::string dbPath = (dir / "pixlegends.db").string();
+
+    bool sqlite = false;
+    double registerSeconds = 0.0;
+    {
+        QuietCout quiet;
+        DatabaseSQLite probe;
+        probe.initialize(dbPath);
+        sqlite = probe.isUsingSQLite();
+        if (sqlite) {
+            const auto start = Clock::now();
+            for (int id = 1; id <= accounts; ++id) probe.registerUser(accountName(id), "password");
+            registerSeconds = secondsSince(start);
+        }
+    }
+    if (!sqlite) {
+        std::ofstream index(dir / "users" / "index.txt", std::ios::trunc);
+        for (int id = 1; id <= accounts; ++id) index << id << "\tPLAYER\t" << accountName(id) << '\n';
+    }
+
+    DatabaseSQLite db;
+    double openSeconds = 0.0;
+    {
+        QuietCout quiet;
+        const auto start = Clock::now();
+        db.initialize(dbPath);
+        openSeconds = secondsSince(start);
+    }
+
+    // Same pseudo-random order for both lookups, so every run probes the same accounts
+    std::vector<int> order(static_cast<size_t>(lookups));
+    uint32_t state = 2463534242u;
+    for (int& id : order) {
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        id = static_cast<int>(state % static_cast<uint32_t>(accounts)) + 1;
+    }
+    std::vector<std::string> names;
+    names.reserve(order.size());
+    for (int id : order) names.push_back(accountName(id));
+
+    int misses = 0;
+    auto start = Clock::now();
+    for (const std::string& name : names) {
+        if (!db.getUserByName(name)) ++misses;
+    }
+    const double byName = secondsSince(start);
+    start = Clock::now();
+    for (int id : order) {
+        if (!db.getUserById(id)) ++misses;
+    }
+    const double byId = secondsSince(start);
+    
+    // Every save differs (as gameplay autosaves do), so each one also records a history checkpoint
+    PlayerSave save;
+    save.equipNames[0] = "Bench Ring";
+    for (int slot = 0; slot < 9; ++slot) {
+        save.invKey[0][slot] = "bench_item_" + std::to_string(slot);
+        save.invCnt[0][slot] = slot + 1;
+    }
+    int failedSaves = 0;
+    double saveSeconds = 0.0;
+    {
+        QuietCout quiet;
+        start = Clock::now();
+        for (int i = 0; i < saves; ++i) {
+            save.gold = i;
+            save.x = static_cast<float>(i);
+            if (!db.savePlayerState(1, save)) ++failedSaves;
+        }
+        saveSeconds = secondsSince(start);
+    }
+    double loadSeconds = 0.0;
+    {
+        QuietCout quiet;
+        start = Clock::now();
+        for (int i = 0; i < saves; ++i) {
+            auto loaded = db.loadPlayerState(1);
+            if (!loaded || loaded->gold != saves - 1) ++failedSaves;
+        }
+        loadSeconds = secondsSince(start);
+    }
+
+    std::cout << "[dbbench] backend " << (sqlite ? "SQLite" : "JSON index") << ", " << accounts << " accounts" << std::endl;
+    if (sqlite) std::cout << "[dbbench] registerUser: " << registerSeconds * 1e6 / accounts << " us/account" << std::endl;
+    std::cout << "[dbbench] initialize: " << openSeconds * 1000.0 << " ms" << std::endl;
+    std::cout << "[dbbench] getUserByName: " << byName * 1e9 / lookups << " ns/lookup" << std::endl;
+    std::cout << "[dbbench] getUserById: " << byId * 1e9 / lookups << " ns/lookup" << std::endl;
+    std::cout << "[dbbench] savePlayerState: " << saves / saveSeconds << " saves/s" << std::endl;
+    std::cout << "[dbbench] loadPlayerState: " << saves / loadSeconds << " loads/s" << std::endl;
+    std::filesystem::remove_all(dir, ec);
+    if (misses) {
+        std::cerr << "[dbbench] " << misses << " lookups missed" << std::endl;
+        return 1;
+    }
+    if (failedSaves) {
+        std::cerr << "[dbbench] " << failedSaves << " saves/loads failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+// PixMixBench: checks the AudioBus mixing kernels against scalar references, then times a mixer
+// block the way the audio callback runs it.
+//
+//   PixMixBench [--voices 64] [--blocks N] [--verify]
+//
+// Every kernel is compared with a plain loop over odd sizes and misaligned pointers, so the SIMD
+// body, its scalar tail and the hand-off between them are all covered; a whole 64-voice graph
+// block is compared too. The timing mixes stereo voices round-robin over the Sfx, Monster and
+// Player buses at the device block size (2048 frames) and reports samples mixed per second next
+// to the same block through the reference loops (which the compiler is free to vectorize itself).
+// --verify stops after the checks (ctest runs it that way). Exits 1 on any mismatch.
+
+#include "AudioBus.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+constexpr size_t BLOCK_FRAMES = 2048; // Mix_OpenAudio's chunk size in AudioManager
+constexpr size_t BLOCK_SAMPLES = BLOCK_FRAMES * 2;
+
+// The kernels' contract, one sample at a time
+void refMixS16(float* dst, const int16_t* src, size_t count, float gain) {
+    for (size_t i = 0; i < count; ++i) dst[i] += static_cast<float>(src[i]) * gain;
+}
+
+void refMixS16Stereo(float* dst, const int16_t* src, size_t frames, float leftGain, float rightGain) {
+    for (size_t i = 0; i < frames * 2; i += 2) {
+        dst[i] += static_cast<float>(src[i]) * leftGain;
+        dst[i + 1] += static_cast<float>(src[i + 1]) * rightGain;
+    }
+}
+
+void refMixF32(float* dst, const float* src, size_t count, float gain) {
+    for (size_t i = 0; i < count; ++i) dst[i] += src[i] * gain;
+}
+
+float refApplyGainPeak(float* samples, size_t count, float gain) {
+    float peak = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] *= gain;
+        peak = std::max(peak, std::fabs(samples[i]));
+    }
+    return peak;
+}
+
+float refPeakS16(const int16_t* samples, size_t count) {
+    int peak = 0;
+    for (size_t i = 0; i < count; ++i) peak = std::max(peak, std::abs(static_cast<int>(samples[i])));
+    return static_cast<float>(peak) / 32768.0f;
+}
+
+void refConvertF32ToS16(int16_t* dst, const float* src, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<int16_t>(std::nearbyint(std::max(-32768.0f, std::min(32767.0f, src[i]))));
+    }
+}
+
+// AudioBusGraph::begin/mix/finish for one block with unit bus gains, through the references
+void refGraphBlock(const std::vector<std::vector<int16_t>>& voices, const std::vector<float>& leftGains,
+                   const std::vector<float>& rightGains, int16_t* out) {
+    std::vector<float> buses[static_cast<int>(AudioBus::COUNT)];
+    for (std::vector<float>& bus : buses) bus.assign(BLOCK_SAMPLES, 0.0f);
+    static const AudioBus voiceBuses[] = { AudioBus::Sfx, AudioBus::Monster, AudioBus::Player };
+    for (size_t v = 0; v < voices.size(); ++v) {
+        refMixS16Stereo(buses[static_cast<int>(voiceBuses[v % 3])].data(), voices[v].data(), BLOCK_FRAMES, leftGains[v], rightGains[v]);
+    }
+    static const AudioBus order[] = { AudioBus::Monster, AudioBus::Player, AudioBus::Music, AudioBus::Sfx };
+    for (AudioBus bus : order) {
+        refApplyGainPeak(buses[static_cast<int>(bus)].data(), BLOCK_SAMPLES, 1.0f);
+        refMixF32(buses[static_cast<int>(AudioBusGraph::getParent(bus))].data(), buses[static_cast<int>(bus)].data(), BLOCK_SAMPLES, 1.0f);
+    }
+    float* master = buses[static_cast<int>(AudioBus::Master)].data();
+    refApplyGainPeak(master, BLOCK_SAMPLES, 1.0f);
+    refConvertF32ToS16(out, master, BLOCK_SAMPLES);
+}
+
+void graphBlock(AudioBusGraph& graph, const std::vector<std::vector<int16_t>>& voices, const std::vector<float>& leftGains,
+                const std::vector<float>& rightGains, int16_t* out) {
+    static const AudioBus voiceBuses[] = { AudioBus::Sfx, AudioBus::Monster, AudioBus::Player };
+    graph.begin(BLOCK_SAMPLES);
+    for (size_t v = 0; v < voices.size(); ++v) {
+        graph.mixStereo(voiceBuses[v % 3], voices[v].data(), BLOCK_SAMPLES, leftGains[v], rightGains[v]);
+    }
+    graph.finish(out);
+}
+
+struct Rng {
+    uint32_t state = 2463534242u;
+    uint32_t next() { state ^= state << 13; state ^= state >> 17; state ^= state << 5; return state; }
+    int16_t sample() { return static_cast<int16_t>(next() & 0xFFFF); }
+    float unit() { return static_cast<float>(next() >> 8) / 16777216.0f; }
+};
+
+// Mixes sum in the same order in both paths; only a compiler contracting the reference into FMA
+// could move a result, and then by an ulp
+bool close(float a, float b) {
+    return std::fabs(a - b) <= 1e-6f * std::max(1.0f, std::fabs(b));
+}
+
+int failures = 0;
+
+void expect(bool ok, const std::string& what, size_t count) {
+    if (ok) return;
+    if (failures < 10) std::cerr << "[mixbench] mismatch: " << what << " at count " << count << std::endl;
+    ++failures;
+}
+
+void verifyKernels() {
+    Rng rng;
+    std::vector<int16_t> s16(BLOCK_SAMPLES + 16);
+    std::vector<float> f32(BLOCK_SAMPLES + 16);
+    for (int16_t& s : s16) s = rng.sample();
+    for (float& f : f32) f = (rng.unit() - 0.5f) * 200000.0f; // past S16 range, to exercise saturation
+    s16[3] = -32768; s16[4] = 32767;                          // extremes inside the SIMD body
+
+    std::vector<size_t> counts;
+    for (size_t n = 0; n <= 67; ++n) counts.push_back(n);
+    counts.push_back(BLOCK_SAMPLES);
+    for (size_t count : counts) {
+        for (size_t offset = 0; offset < 2; ++offset) { // offset 1 misaligns every pointer
+            const int16_t* src = s16.data() + offset;
+            const float* fsrc = f32.data() + offset;
+            const float gain = 0.37f + 0.01f * static_cast<float>(count % 7);
+
+            std::vector<float> got(count + 1, 1.5f), want(count + 1, 1.5f);
+            mixS16(got.data() + offset % 2, src, count, gain);
+            refMixS16(want.data() + offset % 2, src, count, gain);
+            bool ok = true;
+            for (size_t i = 0; i < got.size(); ++i) ok = ok && close(got[i], want[i]);
+            expect(ok, "mixS16", count);
+
+            const size_t frames = count / 2;
+            got.assign(count + 1, -2.0f); want.assign(count + 1, -2.0f);
+            mixS16Stereo(got.data() + offset % 2, src, frames, gain, 1.0f - gain);
+            refMixS16Stereo(want.data() + offset % 2, src, frames, gain, 1.0f - gain);
+            ok = true;
+            for (size_t i = 0; i < got.size(); ++i) ok = ok && close(got[i], want[i]);
+            expect(ok, "mixS16Stereo", count);
+
+            got.assign(count + 1, 3.0f); want.assign(count + 1, 3.0f);
+            mixF32(got.data() + offset % 2, fsrc, count, gain);
+            refMixF32(want.data() + offset % 2, fsrc, count, gain);
+            ok = true;
+            for (size_t i = 0; i < got.size(); ++i) ok = ok && close(got[i], want[i]);
+            expect(ok, "mixF32", count);
+
+            got.assign(fsrc, fsrc + count); want.assign(fsrc, fsrc + count);
+            const float gotPeak = applyGainPeak(got.data(), count, gain);
+            const float wantPeak = refApplyGainPeak(want.data(), count, gain);
+            ok = close(gotPeak, wantPeak);
+            for (size_t i = 0; i < count; ++i) ok = ok && close(got[i], want[i]);
+            expect(ok, "applyGainPeak", count);
+
+            expect(peakS16(src, count) == refPeakS16(src, count), "peakS16", count);
+
+            std::vector<int16_t> gotS16(count), wantS16(count);
+            convertF32ToS16(gotS16.data(), fsrc, count);
+            refConvertF32ToS16(wantS16.data(), fsrc, count);
+            expect(gotS16 == wantS16, "convertF32ToS16", count);
+        }
+    }
+}
+
+void verifyGraph(const std::vector<std::vector<int16_t>>& voices, const std::vector<float>& leftGains,
+                 const std::vector<float>& rightGains) {
+    AudioBusGraph graph;
+    graph.allocate(BLOCK_SAMPLES);
+    std::vector<int16_t> got(BLOCK_SAMPLES), want(BLOCK_SAMPLES);
+    graphBlock(graph, voices, leftGains, rightGains, got.data());
+    refGraphBlock(voices, leftGains, rightGains, want.data());
+    bool ok = true;
+    for (size_t i = 0; i < BLOCK_SAMPLES; ++i) ok = ok && std::abs(got[i] - want[i]) <= 1; // an ulp can cross a rounding edge
+    expect(ok, "AudioBusGraph block of " + std::to_string(voices.size()) + " voices", BLOCK_SAMPLES);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int voiceCount = 64;
+    int blocks = 2000;
+    bool verifyOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--voices" && i + 1 < argc) voiceCount = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--blocks" && i + 1 < argc) blocks = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--verify") verifyOnly = true;
+        else {
+            std::cerr << "usage: PixMixBench [--voices N] [--blocks N] [--verify]" << std::endl;
+            return 2;
+        }
+    }
+
+    // Quiet-ish voices so 64 of them sum without clipping everything
+    Rng rng;
+    std::vector<std::vector<int16_t>> voices(static_cast<size_t>(voiceCount), std::vector<int16_t>(BLOCK_SAMPLES));
+    std::vector<float> leftGains, rightGains;
+    for (std::vector<int16_t>& voice : voices) {
+        for (int16_t& s : voice) s = static_cast<int16_t>(rng.sample() / 64);
+        const float pan = rng.unit();
+        leftGains.push_back(1.0f - pan);
+        rightGains.push_back(pan);
+    }
+
+    verifyKernels();
+    verifyGraph(voices, leftGains, rightGains);
+    if (failures) std::cerr << "[mixbench] " << failures << " mismatches" << std::endl;
+    std::cout << "[mixbench] kernels vs scalar reference: " << (failures ? "MISMATCH" : "match") << std::endl;
+    if (failures) return 1;
+    if (verifyOnly) return 0;
+
+    AudioBusGraph graph;
+    graph.allocate(BLOCK_SAMPLES);
+    std::vector<int16_t> out(BLOCK_SAMPLES);
+    long long checksum = 0;
+    auto start = Clock::now();
+    for (int b = 0; b < blocks; ++b) {
+        graphBlock(graph, voices, leftGains, rightGains, out.data());
+        checksum += out[static_cast<size_t>(b) % BLOCK_SAMPLES];
+    }
+    const double kernelSeconds = secondsSince(start);
+    start = Clock::now();
+    for (int b = 0; b < blocks; ++b) {
+        refGraphBlock(voices, leftGains, rightGains, out.data());
+        checksum += out[static_cast<size_t>(b) % BLOCK_SAMPLES];
+    }
+    const double referenceSeconds = secondsSince(start);
+
+    // Voice samples summed into a bus, the figure that scales with the number of voices playing
+    const double mixed = static_cast<double>(blocks) * voiceCount * BLOCK_SAMPLES;
+    const double realtime = static_cast<double>(BLOCK_FRAMES) / 44100.0;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    const char* kernels = "SSE2";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    const char* kernels = "NEON";
+#else
+    const char* kernels = "scalar";
+#endif
+    std::cout << "[mixbench] " << voiceCount << " voices, " << BLOCK_FRAMES << "-frame stereo blocks, " << kernels << " kernels" << std::endl;
+    std::cout << "[mixbench] kernels: " << mixed / kernelSeconds / 1e6 << " M samples/s, "
+              << kernelSeconds * 1e6 / blocks << " us/block (" << 100.0 * kernelSeconds / blocks / realtime << "% of real time)" << std::endl;
+    std::cout << "[mixbench] reference loops: " << mixed / referenceSeconds / 1e6 << " M samples/s, "
+              << referenceSeconds * 1e6 / blocks << " us/block" << std::endl;
+    std::cout << "[mixbench] speedup " << referenceSeconds / kernelSeconds << "x (checksum " << checksum << ")" << std::endl;
+    return 0;
+}